@@ -0,0 +1,171 @@
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "asset/cook/BatchCook.hpp"
+
+namespace {
+
+void PrintUsage() {
+  std::cerr << "usage: vv_cook [options] <file|directory|manifest>...\n"
+               "  -o, --output <dir>    output directory (default: cooked)\n"
+               "  -j, --jobs <n>        files cooked concurrently (default: hardware threads)\n"
+               "  --force               cook even when outputs are up to date\n"
+               "  --in-process          cook on threads instead of one child process per file\n"
+               "  --timeout <seconds>   kill isolated files that take longer\n"
+               "  --asset-root <dir>    share one texture directory index below <dir>\n"
+               "  --quantize            also build packed vertex streams\n"
+               "  --compress            BC-compress textures\n"
+               "  --no-clusters         skip meshlet clusters\n"
+               "  --no-mips             skip mip chains\n"
+               "  --lods <n>            simplified LOD levels per mesh (default: 3)\n"
+               "  --memory-budget <MiB> bounded-memory import; embedded textures go to <output>/textures\n"
+               "  --native-fbx          read binary FBX natively, falling back to Assimp per file\n"
+               "  --prune               drop bones, nodes and tracks that move nothing drawn\n"
+               "  --pack-materials      pack occlusion, roughness and metallic maps into one texture\n"
+               "  --ktx2                write each external image's cooked texture to a .ktx2 beside it\n"
+               "  --ktx2-zlib           same, with zlib-supercompressed levels\n"
+               "  -q, --quiet           print failures and the summary only\n";
+}
+
+bool ParseCount(const char* text, uint32_t& out) {
+  char* end = nullptr;
+  const unsigned long value = std::strtoul(text, &end, 10);
+  if (end == text || *end != '\0' || value > UINT32_MAX) {
+    return false;
+  }
+  out = static_cast<uint32_t>(value);
+  return true;
+}
+
+const char* StatusLabel(vv::CookStatus status) {
+  switch (status) {
+    case vv::CookStatus::kCooked:
+      return "cooked";
+    case vv::CookStatus::kUpToDate:
+      return "up-to-date";
+    case vv::CookStatus::kFailed:
+    default:
+      return "FAILED";
+  }
+}
+
+}  // namespace
+
+// Headless batch importer: never creates a window or touches Vulkan. Exit codes: 0 all files
+// cooked or up to date, 1 some files failed, 2 usage or input errors.
+int main(int argc, char** argv) {
+  std::cout << std::fixed << std::setprecision(1);
+  vv::CookSettings settings;
+  std::vector<std::string> inputs;
+  bool quiet = false;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const auto value = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+    const char* param = nullptr;
+    if (arg == "-o" || arg == "--output") {
+      if ((param = value()) == nullptr) {
+        PrintUsage();
+        return 2;
+      }
+      settings.outputDir = param;
+    } else if (arg == "-j" || arg == "--jobs" || arg == "--timeout" || arg == "--lods" ||
+               arg == "--memory-budget") {
+      uint32_t count = 0;
+      if ((param = value()) == nullptr || !ParseCount(param, count)) {
+        PrintUsage();
+        return 2;
+      }
+      if (arg == "--timeout") {
+        settings.timeoutSec = count;
+      } else if (arg == "--lods") {
+        settings.import.lodCount = count;
+      } else if (arg == "--memory-budget") {
+        settings.import.memoryBudgetBytes = static_cast<uint64_t>(count) << 20U;
+      } else {
+        settings.jobs = count;
+      }
+    } else if (arg == "--asset-root") {
+      if ((param = value()) == nullptr) {
+        PrintUsage();
+        return 2;
+      }
+      settings.import.assetRoot = param;
+    } else if (arg == "--force") {
+      settings.force = true;
+    } else if (arg == "--in-process") {
+      settings.isolate = false;
+    } else if (arg == "--quantize") {
+      settings.import.quantizeVertices = true;
+    } else if (arg == "--compress") {
+      settings.import.compressTextures = true;
+    } else if (arg == "--no-clusters") {
+      settings.import.buildClusters = false;
+    } else if (arg == "--no-mips") {
+      settings.import.generateMips = false;
+    } else if (arg == "--native-fbx") {
+      settings.import.nativeFbx = true;
+    } else if (arg == "--prune") {
+      settings.import.pruneScene = true;
+    } else if (arg == "--pack-materials") {
+      settings.import.packMaterialTextures = true;
+    } else if (arg == "--ktx2" || arg == "--ktx2-zlib") {
+      settings.writeKtx2 = true;
+      settings.ktx2Supercompression =
+          arg == "--ktx2" ? vv::Ktx2Supercompression::kNone : vv::Ktx2Supercompression::kZlib;
+    } else if (arg == "-q" || arg == "--quiet") {
+      quiet = true;
+    } else if (arg == "-h" || arg == "--help") {
+      PrintUsage();
+      return 0;
+    } else if (!arg.empty() && arg[0] == '-') {
+      std::cerr << "vv_cook: unknown option " << arg << "\n";
+      PrintUsage();
+      return 2;
+    } else {
+      inputs.push_back(arg);
+    }
+  }
+  if (inputs.empty()) {
+    PrintUsage();
+    return 2;
+  }
+
+  try {
+    const vv::LoadResult<std::vector<vv::CookJob>> jobs = vv::CollectCookJobs(inputs, settings.outputDir);
+    if (!jobs.Ok()) {
+      std::cerr << "vv_cook: " << jobs.error << "\n";
+      return 2;
+    }
+
+    const vv::CookSummary summary = vv::RunCook(*jobs.value, settings, [&](const vv::CookFileResult& result) {
+      if (result.status == vv::CookStatus::kFailed) {
+        std::cerr << "[FAILED] " << result.source.string() << ": " << result.error << "\n";
+      } else if (!quiet) {
+        std::cout << "[" << StatusLabel(result.status) << "] " << result.source.string() << " (" << result.wallMs
+                  << " ms)\n";
+      }
+    });
+
+    std::cout << "vv_cook: " << summary.cooked << " cooked, " << summary.upToDate << " up to date, " << summary.failed
+              << " failed in " << summary.wallMs / 1000.0 << " s\n";
+    if (summary.failed > 0) {
+      std::cerr << "vv_cook: failed files:\n";
+      for (const vv::CookFileResult& result : summary.files) {
+        if (result.status == vv::CookStatus::kFailed) {
+          std::cerr << "  " << result.source.string() << ": " << result.error << "\n";
+        }
+      }
+      return 1;
+    }
+    return 0;
+  } catch (const std::exception& e) {
+    std::cerr << "vv_cook: fatal error: " << e.what() << std::endl;
+    return 2;
+  }
+}
@@ -5,19 +5,31 @@
 #include <chrono>
 #include <cfloat>
 #include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <optional>
+#include <string>
 #include <utility>
 #include <vector>
 
 #include <glm/ext/scalar_constants.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
-#include "asset/import/AssimpFbxImporter.hpp"
+#include "asset/cook/CookedScene.hpp"
+#include "asset/import/AsyncImport.hpp"
+#include "asset/import/ImportOptions.hpp"
+#include "asset/registry/AssetRegistry.hpp"
+#include "asset/residency/CpuResidency.hpp"
+#include "asset/texture/TextureRegistry.hpp"
 #include "core/log/Log.hpp"
+#include "core/memory/ProcessMemory.hpp"
 #include "platform/common/InputCodes.hpp"
 #include "platform/macos/MacWindowGLFW.hpp"
 #include "render/animation/Animator.hpp"
+#include "render/animation/MorphBlender.hpp"
 #include "render/scene/RenderScene.hpp"
 #include "render/scene/SceneTypes.hpp"
 #include "rhi/vulkan/VulkanRenderer.hpp"
@@ -146,6 +158,53 @@ void AppendDemoGridGround(Scene& scene) {
   scene.roots.push_back(floorNodeId);
 }
 
+void WriteImportReport(const std::shared_ptr<spdlog::logger>& logger, const ImportReport& report) {
+  if (const char* reportPath = std::getenv("VV_IMPORT_REPORT"); reportPath != nullptr) {
+    std::ofstream(reportPath) << ImportReportToJson(report);
+    logger->info("Import report written to {}", reportPath);
+  }
+  for (const ImportStageReport& stage : report.stages) {
+    logger->info("Import stage {}{}{}: {:.1f} ms wall, {:.1f} ms CPU, heap {:+.1f} KiB, {} items",
+                 stage.parent,
+                 stage.parent.empty() ? "" : "/",
+                 stage.name,
+                 stage.wallMs,
+                 stage.cpuMs,
+                 static_cast<double>(stage.heapDeltaBytes) / 1024.0,
+                 stage.items);
+  }
+  logger->info("Import heap peak: {:.1f} MiB (budget {})",
+               static_cast<double>(report.peakHeapBytes) / (1024.0 * 1024.0),
+               report.memoryBudgetBytes > 0 ? std::to_string(report.memoryBudgetBytes >> 20U) + " MiB" : "none");
+}
+
+// VV_CPU_RESIDENCY=keep|release|reload (default reload): what happens to the scene's vertex, index
+// and pixel arrays once they are on the GPU.
+CpuResidency DemoCpuResidency() {
+  const char* value = std::getenv("VV_CPU_RESIDENCY");
+  const std::string policy = value != nullptr ? value : "";
+  if (policy == "keep") {
+    return CpuResidency::kKeep;
+  }
+  if (policy == "release") {
+    return CpuResidency::kReleaseAfterUpload;
+  }
+  return CpuResidency::kReloadFromCooked;
+}
+
+// Cooked copy of the demo scene that released arrays are read back from, under $VV_RESIDENCY_DIR
+// (default <tmp>/vividvision-residency).
+std::filesystem::path ResidencyCookPath(const std::string& modelPath) {
+  std::filesystem::path dir;
+  if (const char* configured = std::getenv("VV_RESIDENCY_DIR"); configured != nullptr) {
+    dir = configured;
+  } else {
+    std::error_code ec;
+    dir = std::filesystem::temp_directory_path(ec) / "vividvision-residency";
+  }
+  return dir / (std::filesystem::path(modelPath).stem().string() + kCookedSceneExtension);
+}
+
 }  // namespace
 
 int DemoApp::Run(const std::string& fbxPath) {
@@ -168,32 +227,57 @@ int DemoApp::Run(const std::string& fbxPath) {
 
   Scene scene;
   std::vector<Animator> animators;
-  std::vector<uint32_t> skeletonPaletteOffsets;
+  std::vector<uint32_t> skinPaletteOffsets;
   std::vector<Mat4> combinedPalette;
   ClipId activeClip = 0;
+  // One blender per mesh with morph targets, weighted by the first node drawing it.
+  struct MorphInstance {
+    MeshId mesh = 0;
+    NodeId node = kInvalidNodeId;
+    MorphBlender blender;
+  };
+  std::vector<MorphInstance> morphInstances;
+  std::vector<MorphedMesh> morphedMeshes;
+  std::vector<float> morphWeights;
+  float morphClock = 0.0F;  // clip time when no skeleton drives the clip
   constexpr uint32_t kBonePaletteCapacity = 1024;
   Vec3 orbitTarget(0.0F, 1.0F, 0.0F);
   float orbitDistance = 3.5F;
   float orbitYaw = glm::pi<float>();
   float orbitPitch = 0.22F;
 
+  const CpuResidency residency = DemoCpuResidency();
+  bool residencyApplied = false;
+  std::unique_ptr<AsyncImport> asyncImport;
+  const auto importStart = std::chrono::steady_clock::now();
   if (!fbxPath.empty()) {
-    const auto t0 = std::chrono::steady_clock::now();
-    AssimpFbxImporter importer;
+    // Geometry, skeletons and clips are drawn as soon as they exist; textures stream in while the
+    // loop runs (see the update after RenderFrame).
     ImportOptions options;
-    const auto loaded = importer.Import(fbxPath, options);
+    options.quantizeVertices = true;
+    options.lazyTextureDecode = true;
+    asyncImport = AsyncImport::Start(fbxPath, options, [logger](const AsyncImportProgress& progress) {
+      if (progress.phase == AsyncImportPhase::kImporting) {
+        logger->debug("Import stage {} done", progress.stage);
+      } else if (progress.phase == AsyncImportPhase::kStreamingTextures && progress.texturesReady > 0) {
+        logger->debug("Textures streamed: {}/{}", progress.texturesReady, progress.texturesTotal);
+      }
+    });
+    auto loaded = asyncImport->TakeScene();
     const auto t1 = std::chrono::steady_clock::now();
 
     if (!loaded.Ok()) {
-      logger->error("FBX import failed: {}", loaded.error);
+      WriteImportReport(logger, asyncImport->Report());
+      logger->error("Scene import failed: {}", loaded.error);
       return 1;
     }
 
     scene = std::move(*loaded.value);
     const SceneStats stats = ComputeSceneStats(scene);
-    const double loadMs = static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count());
+    const double loadMs =
+        static_cast<double>(std::chrono::duration_cast<std::chrono::milliseconds>(t1 - importStart).count());
 
-    logger->info("FBX loaded: {} ms", loadMs);
+    logger->info("Scene ready: {} ms ({} textures streaming)", loadMs, asyncImport->Progress().texturesTotal);
     logger->info("Meshes: {}, Materials: {}, Textures: {}", stats.meshCount, stats.materialCount, stats.textureCount);
     logger->info("Triangles: {}, Skeletons: {}, Bones: {}, Clips: {}, Lights: {}",
                  stats.triangleCount,
@@ -201,6 +285,35 @@ int DemoApp::Run(const std::string& fbxPath) {
                  stats.boneCount,
                  stats.clipCount,
                  stats.lightCount);
+    const double savedPct = stats.sourceGeometryBytes > 0
+                                ? 100.0 * (1.0 - static_cast<double>(stats.gpuGeometryBytes) /
+                                                     static_cast<double>(stats.sourceGeometryBytes))
+                                : 0.0;
+    logger->info("Geometry: {:.1f} KiB -> {:.1f} KiB GPU ({:.1f}% saved by packed vertices/16-bit indices)",
+                 static_cast<double>(stats.sourceGeometryBytes) / 1024.0,
+                 static_cast<double>(stats.gpuGeometryBytes) / 1024.0,
+                 savedPct);
+    const TextureDedupStats dedup = TextureRegistry::Global().Stats();
+    logger->info("Textures: {} source images, {} decoded, {} duplicates folded ({:.1f} KiB), {} decodes reused ({:.1f} KiB)",
+                 dedup.sourceImages,
+                 dedup.decodedImages,
+                 dedup.sceneDuplicates,
+                 static_cast<double>(dedup.sceneDuplicateBytes) / 1024.0,
+                 dedup.registryHits,
+                 static_cast<double>(dedup.registryHitBytes) / 1024.0);
+    const ProcessMemoryStats importMemory = QueryProcessMemory();
+    logger->info("Memory after import: RSS {:.1f} MiB, peak {:.1f} MiB",
+                 static_cast<double>(importMemory.residentBytes) / (1024.0 * 1024.0),
+                 static_cast<double>(importMemory.peakResidentBytes) / (1024.0 * 1024.0));
+    for (const Mesh& mesh : scene.meshes) {
+      for (size_t lod = 0; lod < mesh.lods.size(); ++lod) {
+        uint32_t indexCount = 0;
+        for (const auto& submesh : mesh.lods[lod].submeshes) {
+          indexCount += submesh.indexCount;
+        }
+        logger->info("Mesh '{}' LOD{}: {} triangles, error {:.4f}", mesh.name, lod + 1, indexCount / 3, mesh.lods[lod].error);
+      }
+    }
     for (size_t i = 0; i < scene.materials.size(); ++i) {
       const auto& mat = scene.materials[i];
       logger->info("Material[{}]: specGloss={}, separateMR={}, flipNormalY={}, roughness={:.3f}, metallic={:.3f}, ao={:.2f}, normalScale={:.2f}, baseTex={}, mrTex={}, mTex={}, rTex={}, aoTex={}, normalTex={}, specTex={}",
@@ -226,9 +339,22 @@ int DemoApp::Run(const std::string& fbxPath) {
     AppendDemoGridGround(scene);
     logger->info("Demo ground: enabled (grid floor mesh appended)");
 
+    if (residency == CpuResidency::kReloadFromCooked) {
+      // Written once the scene is complete, so every mesh (and texture decoded at import) can be
+      // read back after its arrays are dropped; textures still streaming reload from their source.
+      const std::string cookPath = ResidencyCookPath(fbxPath).string();
+      std::string cookError;
+      if (WriteCookedScene(cookPath, scene, {}, cookError)) {
+        SetCookedLocations(scene, cookPath);
+        logger->info("CPU residency: reload from {}", cookPath);
+      } else {
+        logger->warn("CPU residency: cannot write {} ({}); keeping arrays without a source resident", cookPath, cookError);
+      }
+    }
+
     if (!scene.skeletons.empty()) {
       animators.resize(scene.skeletons.size());
-      skeletonPaletteOffsets.resize(scene.skeletons.size(), 0);
+      skinPaletteOffsets.resize(scene.skins.size(), 0);
       for (SkeletonId sid = 0; sid < animators.size(); ++sid) {
         animators[sid].Bind(&scene, sid);
       }
@@ -238,10 +364,28 @@ int DemoApp::Run(const std::string& fbxPath) {
       for (auto& animator : animators) {
         animator.SetClip(activeClip, true);
       }
-      logger->info("Default clip: {} (duration {:.3f}s)", scene.clips[activeClip].name, scene.clips[activeClip].durationSec);
+      logger->info("Default clip: {} (duration {:.3f}s)", scene.clips[activeClip]->name, scene.clips[activeClip]->durationSec);
+    }
+    for (MeshId meshId = 0; meshId < scene.meshes.size(); ++meshId) {
+      if (!scene.meshes[meshId]->morphTargets.empty()) {
+        morphInstances.push_back(MorphInstance{.mesh = meshId});
+      }
+    }
+    for (NodeId nodeId = 0; nodeId < scene.nodes.size(); ++nodeId) {
+      for (MorphInstance& instance : morphInstances) {
+        if (instance.node == kInvalidNodeId && scene.nodes[nodeId].mesh == instance.mesh) {
+          instance.node = nodeId;
+        }
+      }
+    }
+    for (MorphInstance& instance : morphInstances) {
+      instance.blender.Bind(&*scene.meshes[instance.mesh]);
+    }
+    if (!morphInstances.empty()) {
+      logger->info("Morphing meshes: {}", morphInstances.size());
     }
   } else {
-    logger->warn("No FBX path provided. Running renderer with empty scene.");
+    logger->warn("No model path provided (.fbx, .gltf or .glb). Running renderer with empty scene.");
   }
 
   bool prevPause = false;
@@ -256,6 +400,7 @@ int DemoApp::Run(const std::string& fbxPath) {
   double lastCursorY = 0.0;
   float perfAccumSec = 0.0F;
   uint32_t perfFrameCount = 0;
+  bool memoryLogged = false;
 
   auto lastTick = std::chrono::steady_clock::now();
   while (window.PollEvents()) {
@@ -297,7 +442,7 @@ int DemoApp::Run(const std::string& fbxPath) {
       for (auto& animator : animators) {
         animator.SetClip(activeClip, true);
       }
-      logger->info("Switched clip to [{}] {}", activeClip, scene.clips[activeClip].name);
+      logger->info("Switched clip to [{}] {}", activeClip, scene.clips[activeClip]->name);
     }
     if (prevClip && !prevPrev && !scene.clips.empty() && !animators.empty()) {
       const ClipId count = static_cast<ClipId>(scene.clips.size());
@@ -305,7 +450,7 @@ int DemoApp::Run(const std::string& fbxPath) {
       for (auto& animator : animators) {
         animator.SetClip(activeClip, true);
       }
-      logger->info("Switched clip to [{}] {}", activeClip, scene.clips[activeClip].name);
+      logger->info("Switched clip to [{}] {}", activeClip, scene.clips[activeClip]->name);
     }
     if (toggleNormal && !prevToggleNormal) {
       enableNormalMap = !enableNormalMap;
@@ -357,26 +502,59 @@ int DemoApp::Run(const std::string& fbxPath) {
       }
     }
 
+    // Morph weights follow the active clip; meshes without a track keep their rest weights.
+    morphedMeshes.clear();
+    if (!morphInstances.empty()) {
+      const AnimationClip* clip = activeClip < scene.clips.size() ? &*scene.clips[activeClip] : nullptr;
+      float clipTime = 0.0F;
+      if (!animators.empty()) {
+        clipTime = animators[0].ClipTime();
+      } else if (clip != nullptr) {
+        morphClock += dt;
+        clipTime = clip->durationSec > 0.0F ? std::fmod(morphClock, clip->durationSec) : 0.0F;
+      }
+      for (MorphInstance& instance : morphInstances) {
+        const MorphWeightTrack* track = clip != nullptr ? FindMorphTrack(*clip, instance.node) : nullptr;
+        if (track != nullptr) {
+          SampleMorphWeights(*track, clipTime, morphWeights);
+        } else {
+          morphWeights = scene.meshes[instance.mesh]->morphWeights;
+        }
+        instance.blender.Apply(morphWeights);
+        morphedMeshes.push_back(MorphedMesh{.mesh = instance.mesh,
+                                            .vertices = &instance.blender.Vertices(),
+                                            .moved = &instance.blender.Moved()});
+      }
+    }
+
+    // One compact palette per skin, holding only the bones its mesh references; the last slot
+    // of the bone buffer stays the identity for unskinned draws.
     combinedPalette.clear();
     if (!animators.empty()) {
-      if (skeletonPaletteOffsets.size() != scene.skeletons.size()) {
-        skeletonPaletteOffsets.resize(scene.skeletons.size(), 0);
+      if (skinPaletteOffsets.size() != scene.skins.size()) {
+        skinPaletteOffsets.resize(scene.skins.size(), 0);
       }
-      for (SkeletonId sid = 0; sid < animators.size(); ++sid) {
-        const auto& palette = animators[sid].Palette();
-        if (combinedPalette.size() + palette.size() > kBonePaletteCapacity) {
-          skeletonPaletteOffsets[sid] = 0;
+      for (SkinId skinId = 0; skinId < scene.skins.size(); ++skinId) {
+        const Skin& skin = scene.skins[skinId];
+        const size_t start = combinedPalette.size();
+        skinPaletteOffsets[skinId] = 0;
+        if (skin.skeleton >= animators.size()) {
           continue;
         }
-        skeletonPaletteOffsets[sid] = static_cast<uint32_t>(combinedPalette.size());
-        combinedPalette.insert(combinedPalette.end(), palette.begin(), palette.end());
+        animators[skin.skeleton].AppendSkinPalette(skin, combinedPalette);
+        if (combinedPalette.size() > kBonePaletteCapacity - 1) {
+          combinedPalette.resize(start);
+          continue;
+        }
+        skinPaletteOffsets[skinId] = static_cast<uint32_t>(start);
       }
     }
 
     RenderScene renderScene;
     renderScene.scene = &scene;
     renderScene.skinPalette = &combinedPalette;
-    renderScene.skeletonPaletteOffsets = &skeletonPaletteOffsets;
+    renderScene.skinPaletteOffsets = &skinPaletteOffsets;
+    renderScene.morphedMeshes = &morphedMeshes;
 
     FrameContext frame;
     frame.deltaSec = dt;
@@ -394,6 +572,57 @@ int DemoApp::Run(const std::string& fbxPath) {
     frame.proj[1][1] *= -1.0F;
 
     renderer.RenderFrame(renderScene, frame);
+    if (!residencyApplied && renderer.SceneUploaded(scene)) {
+      // From here on the GPU copies are what gets drawn.
+      const ProcessMemoryStats before = QueryProcessMemory();
+      const CpuResidencyStats released = ApplyCpuResidency(scene, residency);
+      ReturnFreeHeapMemory();
+      const ProcessMemoryStats after = QueryProcessMemory();
+      logger->info("CPU residency {}: released {} meshes, {} textures ({:.1f} MiB), {} kept resident; RSS {:.1f} -> {:.1f} MiB",
+                   CpuResidencyName(residency),
+                   released.meshesReleased,
+                   released.texturesReleased,
+                   static_cast<double>(released.releasedBytes) / (1024.0 * 1024.0),
+                   released.kept,
+                   static_cast<double>(before.residentBytes) / (1024.0 * 1024.0),
+                   static_cast<double>(after.residentBytes) / (1024.0 * 1024.0));
+      residencyApplied = true;
+    }
+    if (asyncImport != nullptr) {
+      // Done is read first so textures finishing in between are still applied this frame.
+      const bool importDone = asyncImport->Done();
+      const std::vector<TextureId> streamed = asyncImport->ApplyTextureUpdates(scene);
+      if (!streamed.empty()) {
+        renderer.UpdateTextures(scene, streamed);
+        if (residency != CpuResidency::kKeep) {
+          for (const TextureId id : streamed) {
+            // GPU copies only, as with lazy decoding; the registry must not hand out the released one.
+            AssetRegistry::Global().Forget(*scene.textures[id]);
+            ReleaseDecodedPixels(scene.textures[id].Edit());
+          }
+        }
+      }
+      if (importDone) {
+        const AsyncImportProgress progress = asyncImport->Progress();
+        logger->info("Textures streamed: {} in {:.1f} ms, {} failed",
+                     progress.texturesReady,
+                     std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - importStart).count(),
+                     progress.texturesFailed);
+        WriteImportReport(logger, asyncImport->Report());
+        asyncImport.reset();
+      }
+    }
+    if (!memoryLogged && asyncImport == nullptr) {
+      // Textures are uploaded by now; decoded pixels left are only what the registry keeps.
+      const ProcessMemoryStats memory = QueryProcessMemory();
+      const TextureDedupStats cache = TextureRegistry::Global().Stats();
+      logger->info("Memory steady state: RSS {:.1f} MiB, peak {:.1f} MiB, decoded cache {:.1f} MiB, {} evictions",
+                   static_cast<double>(memory.residentBytes) / (1024.0 * 1024.0),
+                   static_cast<double>(memory.peakResidentBytes) / (1024.0 * 1024.0),
+                   static_cast<double>(cache.cachedBytes) / (1024.0 * 1024.0),
+                   cache.evictions);
+      memoryLogged = true;
+    }
   }
 
   renderer.Shutdown();
@@ -0,0 +1,166 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "asset/import/AssimpFbxImporter.hpp"
+#include "asset/import/FbxImporter.hpp"
+#include "asset/import/GltfImporter.hpp"
+#include "asset/import/SceneImporter.hpp"
+
+namespace {
+
+void PrintUsage() {
+  std::cerr << "usage: vv_import_bench [options] <file.gltf|file.glb|file.fbx>...\n"
+               "  -n, --runs <n>        imports per importer and file; the median is reported (default: 5)\n"
+               "  --lazy                keep textures undecoded (isolates geometry, skins and clips)\n"
+               "  --no-post             skip clusters, LODs and mips\n"
+               "  --nested-heap         also sample the heap around per-mesh and per-texture stages\n"
+               "  --tangent-space       also run Assimp with its GenNormals/CalcTangentSpace steps\n";
+}
+
+struct BenchResult {
+  bool ok = false;
+  std::string error;
+  double medianMs = 0.0;
+  double tangentMs = 0.0;  // median of mesh_tangents, pp_gen_normals and pp_calc_tangent_space
+  uint64_t peakHeapBytes = 0;
+  uint64_t vertices = 0;
+  uint64_t triangles = 0;
+  uint64_t bones = 0;
+  uint64_t keys = 0;
+};
+
+template <typename Importer>
+BenchResult Run(const Importer& importer, const std::string& path, const vv::ImportOptions& options, uint32_t runs, bool nestedHeap) {
+  BenchResult result;
+  std::vector<double> wallMs;
+  std::vector<double> tangentMs;
+  for (uint32_t i = 0; i < runs; ++i) {
+    vv::ImportReport report;
+    report.nestedHeapSamples = nestedHeap;
+    const vv::LoadResult<vv::Scene> scene = importer.Import(path, options, &report);
+    if (!scene.Ok()) {
+      result.error = scene.error;
+      return result;
+    }
+    wallMs.push_back(report.wallMs);
+    double tangents = 0.0;
+    for (const char* stage : {"mesh_tangents", "pp_gen_normals", "pp_calc_tangent_space"}) {
+      const vv::ImportStageReport* found = report.FindStage(stage);
+      tangents += found != nullptr ? found->wallMs : 0.0;
+    }
+    tangentMs.push_back(tangents);
+    result.peakHeapBytes = std::max(result.peakHeapBytes, report.peakHeapBytes);
+    result.vertices = report.counts.vertices;
+    result.triangles = report.counts.triangles;
+    result.bones = report.counts.bones;
+    result.keys = report.counts.keys;
+  }
+  std::sort(wallMs.begin(), wallMs.end());
+  std::sort(tangentMs.begin(), tangentMs.end());
+  result.ok = true;
+  result.medianMs = wallMs[wallMs.size() / 2];
+  result.tangentMs = tangentMs[tangentMs.size() / 2];
+  return result;
+}
+
+void Print(const char* label, const BenchResult& result) {
+  std::cout << "  " << std::left << std::setw(10) << label << std::right;
+  if (!result.ok) {
+    std::cout << "FAILED: " << result.error << "\n";
+    return;
+  }
+  std::cout << std::setw(10) << result.medianMs << " ms  peak heap " << std::setw(8)
+            << static_cast<double>(result.peakHeapBytes) / (1024.0 * 1024.0) << " MiB  tangent space "
+            << std::setprecision(2) << result.tangentMs << std::setprecision(1) << " ms  " << result.vertices
+            << " vertices, " << result.triangles << " triangles, " << result.bones << " bones, " << result.keys
+            << " keys\n";
+}
+
+}  // namespace
+
+// Imports each file with its native reader (GltfImporter, or FbxImporter for binary FBX) and with
+// Assimp (through AssimpFbxImporter, unit conversion off, since glTF is already in meters) and
+// prints median wall time, heap peak and the time spent generating normals and tangents. With
+// --tangent-space, an "assimp-ts" row runs Assimp's own tangent steps for comparison.
+// Decoded images are not shared between runs. Exit codes: 0 every import succeeded, 1 some
+// failed, 2 usage errors.
+int main(int argc, char** argv) {
+  std::cout << std::fixed << std::setprecision(1);
+  uint32_t runs = 5;
+  bool nestedHeap = false;
+  bool tangentSpace = false;
+  vv::ImportOptions options;
+  options.convertToMeters = false;
+  options.shareDecodedTextures = false;
+  std::vector<std::string> inputs;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    if (arg == "-n" || arg == "--runs") {
+      char* end = nullptr;
+      const unsigned long value = i + 1 < argc ? std::strtoul(argv[++i], &end, 10) : 0;
+      if (end == nullptr || *end != '\0' || value == 0 || value > 1000) {
+        PrintUsage();
+        return 2;
+      }
+      runs = static_cast<uint32_t>(value);
+    } else if (arg == "--lazy") {
+      options.lazyTextureDecode = true;
+    } else if (arg == "--no-post") {
+      options.buildClusters = false;
+      options.lodCount = 0;
+      options.generateMips = false;
+    } else if (arg == "--nested-heap") {
+      nestedHeap = true;
+    } else if (arg == "--tangent-space") {
+      tangentSpace = true;
+    } else if (arg == "-h" || arg == "--help") {
+      PrintUsage();
+      return 0;
+    } else if (!arg.empty() && arg[0] == '-') {
+      std::cerr << "vv_import_bench: unknown option " << arg << "\n";
+      PrintUsage();
+      return 2;
+    } else {
+      inputs.push_back(arg);
+    }
+  }
+  if (inputs.empty()) {
+    PrintUsage();
+    return 2;
+  }
+
+  try {
+    bool failed = false;
+    for (const std::string& path : inputs) {
+      std::cout << path << " (" << runs << " runs)\n";
+      const BenchResult native = vv::IsGltfPath(path) ? Run(vv::GltfImporter(), path, options, runs, nestedHeap)
+                                                      : Run(vv::FbxImporter(), path, options, runs, nestedHeap);
+      const BenchResult assimp = Run(vv::AssimpFbxImporter(), path, options, runs, nestedHeap);
+      Print("native", native);
+      Print("assimp", assimp);
+      if (tangentSpace) {
+        vv::ImportOptions assimpSteps = options;
+        assimpSteps.assimpTangentSpace = true;
+        const BenchResult steps = Run(vv::AssimpFbxImporter(), path, assimpSteps, runs, nestedHeap);
+        Print("assimp-ts", steps);
+        failed = failed || !steps.ok;
+      }
+      if (native.ok && assimp.ok && native.medianMs > 0.0) {
+        std::cout << "  speedup " << std::setprecision(2) << assimp.medianMs / native.medianMs << "x\n"
+                  << std::setprecision(1);
+      }
+      failed = failed || !native.ok || !assimp.ok;
+    }
+    return failed ? 1 : 0;
+  } catch (const std::exception& e) {
+    std::cerr << "vv_import_bench: fatal error: " << e.what() << std::endl;
+    return 2;
+  }
+}
@@ -0,0 +1,530 @@
+#include "asset/cook/BatchCook.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "asset/cook/CookedScene.hpp"
+#include "asset/import/ImportReport.hpp"
+#include "asset/import/SceneImporter.hpp"
+#include "asset/texture/TextureRegistry.hpp"
+#include "core/thread/ParallelFor.hpp"
+
+namespace vv {
+namespace {
+
+// Bump whenever importer changes alter cooked output for unchanged sources and options.
+constexpr uint32_t kCookVersion = 2;
+constexpr size_t kMaxChildErrorBytes = 4096;
+
+std::string ToLowerAscii(std::string value) {
+  std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+  return value;
+}
+
+bool IsManifest(const std::filesystem::path& path) {
+  const std::string ext = ToLowerAscii(path.extension().string());
+  return ext == ".txt" || ext == ".manifest";
+}
+
+bool IsCookable(const std::filesystem::path& path) {
+  const std::string ext = ToLowerAscii(path.extension().string());
+  return ext == ".fbx" || ext == ".gltf" || ext == ".glb";
+}
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::optional<std::vector<uint8_t>> ReadBytes(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    return std::nullopt;
+  }
+  const std::streamsize size = file.tellg();
+  if (size < 0) {
+    return std::nullopt;
+  }
+  std::vector<uint8_t> bytes(static_cast<size_t>(size));
+  file.seekg(0);
+  if (size > 0 && !file.read(reinterpret_cast<char*>(bytes.data()), size)) {
+    return std::nullopt;
+  }
+  return bytes;
+}
+
+// Every option that changes the cooked scene; keep in sync with ImportOptions.
+std::string ImportOptionsSignature(const ImportOptions& o) {
+  std::ostringstream out;
+  out << std::hexfloat << o.convertToMeters << ' ' << o.forceRightHanded << ' ' << o.assimpTangentSpace << ' ' << o.normalCreaseAngle << ' '
+      << o.assimpJoinVertices << ' ' << o.maxBoneInfluence << ' ' << o.vertexWeld.positionEpsilon << ' '
+      << o.vertexWeld.normalEpsilon << ' ' << o.vertexWeld.tangentEpsilon << ' ' << o.vertexWeld.uvEpsilon << ' '
+      << o.vertexWeld.weightEpsilon << ' ' << o.quantizeVertices << ' ' << o.buildClusters << ' ' << o.lodCount << ' '
+      << o.generateMips << ' ' << o.compressTextures << ' ' << static_cast<int>(o.textureCompression.quality) << ' '
+      << o.textureCompression.allowBc7 << ' ' << o.assetRoot << ' ' << (o.memoryBudgetBytes > 0) << ' ' << o.nativeFbx << ' ' << o.pruneScene
+      << ' ' << o.packMaterialTextures;
+  return out.str();
+}
+
+class JobCollector {
+ public:
+  explicit JobCollector(std::filesystem::path outputDir) : outputDir_(std::move(outputDir)) {}
+
+  bool AddDirectory(const std::filesystem::path& directory, const std::filesystem::path& base) {
+    std::error_code ec;
+    std::vector<std::filesystem::path> files;
+    for (std::filesystem::recursive_directory_iterator it(directory, ec), end; !ec && it != end; it.increment(ec)) {
+      if (it->is_regular_file(ec) && IsCookable(it->path())) {
+        files.push_back(it->path());
+      }
+    }
+    if (ec) {
+      error_ = "cannot list " + directory.string() + ": " + ec.message();
+      return false;
+    }
+    std::sort(files.begin(), files.end());  // directory order is unspecified
+    for (const std::filesystem::path& file : files) {
+      if (!AddFile(file, file.lexically_relative(base))) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool AddManifest(const std::filesystem::path& manifest) {
+    std::ifstream in(manifest);
+    if (!in) {
+      error_ = "cannot read manifest " + manifest.string();
+      return false;
+    }
+    const std::filesystem::path base = manifest.parent_path();
+    std::string line;
+    while (std::getline(in, line)) {
+      line = line.substr(0, line.find('#'));
+      const size_t first = line.find_first_not_of(" \t\r");
+      if (first == std::string::npos) {
+        continue;
+      }
+      const size_t last = line.find_last_not_of(" \t\r");
+      std::filesystem::path entry(line.substr(first, last - first + 1));
+      if (entry.is_relative()) {
+        entry = base / entry;
+      }
+      std::error_code ec;
+      if (std::filesystem::is_directory(entry, ec)) {
+        if (!AddDirectory(entry, base)) {
+          return false;
+        }
+      } else if (std::filesystem::is_regular_file(entry, ec)) {
+        if (!AddFile(entry, entry.lexically_relative(base))) {
+          return false;
+        }
+      } else {
+        error_ = manifest.string() + ": no such input " + entry.string();
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // `relative` decides the output path; outside the base it falls back to the file name.
+  bool AddFile(const std::filesystem::path& source, std::filesystem::path relative) {
+    if (relative.empty() || *relative.begin() == "..") {
+      relative = source.filename();
+    }
+    CookJob job;
+    job.source = source;
+    job.output = outputDir_ / relative;
+    job.output.replace_extension(kCookedSceneExtension);
+    job.report = outputDir_ / relative;
+    job.report.replace_extension(".report.json");
+
+    std::error_code ec;
+    const std::filesystem::path canonical = std::filesystem::weakly_canonical(source, ec);
+    if (!sources_.insert(canonical.generic_string()).second) {
+      return true;  // listed twice, e.g. by a directory and a manifest; the first listing wins
+    }
+    const std::string key = job.output.lexically_normal().generic_string();
+    const auto [it, inserted] = outputs_.emplace(key, canonical);
+    if (!inserted) {
+      error_ = source.string() + " and " + it->second.string() + " both cook to " + key;
+      return false;
+    }
+    jobs_.push_back(std::move(job));
+    return true;
+  }
+
+  std::vector<CookJob>& Jobs() { return jobs_; }
+  const std::string& Error() const { return error_; }
+
+ private:
+  std::filesystem::path outputDir_;
+  std::vector<CookJob> jobs_;
+  std::map<std::string, std::filesystem::path> outputs_;
+  std::set<std::string> sources_;
+  std::string error_;
+};
+
+// External files the import read besides the source, so edits to them invalidate the output.
+std::vector<CookedDependency> CollectDependencies(const Scene& scene,
+                                                  const ImportReport& report,
+                                                  const std::filesystem::path& source) {
+  std::vector<std::string> paths = report.externalFiles;
+  for (const Texture& texture : scene.textures) {
+    paths.push_back(texture.source.path.empty() ? texture.uri : texture.source.path);
+  }
+  std::vector<CookedDependency> dependencies;
+  for (const std::string& path : paths) {
+    std::error_code ec;
+    if (path.empty() || !std::filesystem::is_regular_file(path, ec) || std::filesystem::equivalent(path, source, ec)) {
+      continue;
+    }
+    const std::string absolute = std::filesystem::absolute(path, ec).lexically_normal().string();
+    const bool seen = std::any_of(dependencies.begin(), dependencies.end(), [&](const CookedDependency& d) {
+      return d.path == absolute;
+    });
+    const std::optional<std::vector<uint8_t>> bytes = seen ? std::nullopt : ReadBytes(absolute);
+    if (bytes.has_value()) {
+      dependencies.push_back({absolute, bytes->size(), HashBytes(bytes->data(), bytes->size())});
+    }
+  }
+  return dependencies;
+}
+
+CookFileResult Finish(CookFileResult result, CookStatus status, std::string error,
+                      std::chrono::steady_clock::time_point start) {
+  result.status = status;
+  result.error = std::move(error);
+  result.wallMs = MillisecondsSince(start);
+  return result;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+struct ChildProcess {
+  pid_t pid = -1;
+  int errorFd = -1;
+  size_t job = 0;
+  std::chrono::steady_clock::time_point start;
+  std::string error;
+  bool timedOut = false;
+};
+
+void DrainChildError(ChildProcess& child) {
+  char buffer[512];
+  while (true) {
+    const ssize_t count = read(child.errorFd, buffer, sizeof(buffer));
+    if (count <= 0) {
+      return;
+    }
+    child.error.append(buffer, static_cast<size_t>(count));
+  }
+}
+
+// The parent stays single-threaded while children exist, so forking is safe; each child runs one
+// CookFile (which may start its own worker threads) and reports a failure message over a pipe.
+void RunIsolated(const std::vector<CookJob>& jobs,
+                 const std::vector<size_t>& pending,
+                 const CookSettings& settings,
+                 size_t slots,
+                 const std::function<void(size_t, CookFileResult)>& record) {
+  std::vector<ChildProcess> running;
+  size_t next = 0;
+  while (next < pending.size() || !running.empty()) {
+    while (running.size() < slots && next < pending.size()) {
+      const size_t job = pending[next++];
+      ChildProcess child;
+      child.job = job;
+      child.start = std::chrono::steady_clock::now();
+      CookFileResult failed;
+      failed.source = jobs[job].source;
+      int fds[2];
+      if (pipe(fds) != 0) {
+        record(job, Finish(failed, CookStatus::kFailed, std::string("pipe: ") + std::strerror(errno), child.start));
+        continue;
+      }
+      std::fflush(nullptr);
+      child.pid = fork();
+      if (child.pid == 0) {
+        close(fds[0]);
+        const CookFileResult result = CookFile(jobs[job], settings);
+        if (result.status == CookStatus::kFailed) {
+          const size_t size = std::min(result.error.size(), kMaxChildErrorBytes);
+          [[maybe_unused]] const ssize_t written = write(fds[1], result.error.data(), size);
+        }
+        _exit(result.status == CookStatus::kCooked ? 0 : 1);
+      }
+      close(fds[1]);
+      if (child.pid < 0) {
+        close(fds[0]);
+        record(job, Finish(failed, CookStatus::kFailed, std::string("fork: ") + std::strerror(errno), child.start));
+        continue;
+      }
+      child.errorFd = fds[0];
+      fcntl(child.errorFd, F_SETFL, fcntl(child.errorFd, F_GETFL) | O_NONBLOCK);
+      running.push_back(std::move(child));
+    }
+
+    bool finished = false;
+    for (auto it = running.begin(); it != running.end();) {
+      ChildProcess& child = *it;
+      DrainChildError(child);
+      int status = 0;
+      if (waitpid(child.pid, &status, WNOHANG) != child.pid) {
+        if (settings.timeoutSec > 0 && !child.timedOut &&
+            MillisecondsSince(child.start) > 1000.0 * static_cast<double>(settings.timeoutSec)) {
+          kill(child.pid, SIGKILL);
+          child.timedOut = true;
+        }
+        ++it;
+        continue;
+      }
+      DrainChildError(child);
+      close(child.errorFd);
+
+      CookFileResult result;
+      result.source = jobs[child.job].source;
+      if (WIFEXITED(status) && WEXITSTATUS(status) == 0) {
+        result = Finish(result, CookStatus::kCooked, {}, child.start);
+      } else if (child.timedOut) {
+        result = Finish(result, CookStatus::kFailed, "timed out after " + std::to_string(settings.timeoutSec) + " s",
+                        child.start);
+      } else if (WIFSIGNALED(status)) {
+        result = Finish(result, CookStatus::kFailed,
+                        std::string("worker killed by signal ") + std::to_string(WTERMSIG(status)) + " (" +
+                            strsignal(WTERMSIG(status)) + ")",
+                        child.start);
+      } else {
+        std::string error = child.error.empty() ? "worker exited with status " + std::to_string(WEXITSTATUS(status))
+                                                : child.error;
+        result = Finish(result, CookStatus::kFailed, std::move(error), child.start);
+      }
+      record(child.job, std::move(result));
+      it = running.erase(it);
+      finished = true;
+    }
+    if (!finished && !running.empty()) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+  }
+}
+#endif
+
+void RunThreaded(const std::vector<CookJob>& jobs,
+                 const std::vector<size_t>& pending,
+                 const CookSettings& settings,
+                 size_t slots,
+                 const std::function<void(size_t, CookFileResult)>& record) {
+  std::atomic<size_t> next{0};
+  const auto worker = [&] {
+    for (size_t i = next++; i < pending.size(); i = next++) {
+      record(pending[i], CookFile(jobs[pending[i]], settings));
+    }
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < std::min(slots, pending.size()); ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+}  // namespace
+
+LoadResult<std::vector<CookJob>> CollectCookJobs(const std::vector<std::string>& inputs,
+                                                 const std::filesystem::path& outputDir) {
+  JobCollector collector(outputDir);
+  for (const std::string& input : inputs) {
+    const std::filesystem::path path(input);
+    std::error_code ec;
+    bool ok = true;
+    if (std::filesystem::is_directory(path, ec)) {
+      ok = collector.AddDirectory(path, path);
+    } else if (std::filesystem::is_regular_file(path, ec)) {
+      ok = IsManifest(path) ? collector.AddManifest(path) : collector.AddFile(path, path.filename());
+    } else {
+      return {.value = std::nullopt, .error = "no such input: " + input};
+    }
+    if (!ok) {
+      return {.value = std::nullopt, .error = collector.Error()};
+    }
+  }
+  return {.value = std::move(collector.Jobs()), .error = {}};
+}
+
+uint64_t ComputeCookKey(const std::vector<uint8_t>& sourceBytes, const ImportOptions& options) {
+  const std::string signature = std::to_string(kCookVersion) + ' ' + ImportOptionsSignature(options);
+  const uint64_t optionsHash = HashBytes(reinterpret_cast<const uint8_t*>(signature.data()), signature.size());
+  const uint64_t sourceHash = HashBytes(sourceBytes.data(), sourceBytes.size());
+  return optionsHash ^ (sourceHash + 0x9E3779B97F4A7C15ULL + (optionsHash << 6U) + (optionsHash >> 2U));
+}
+
+bool IsCookUpToDate(const CookJob& job, uint64_t key) {
+  std::error_code ec;
+  if (!std::filesystem::is_regular_file(job.report, ec)) {
+    return false;
+  }
+  const LoadResult<CookedSceneHeader> header = ReadCookedSceneHeader(job.output.string());
+  if (!header.Ok() || header.value->key != key) {
+    return false;
+  }
+  for (const CookedDependency& dependency : header.value->dependencies) {
+    if (std::filesystem::file_size(dependency.path, ec) != dependency.size || ec) {
+      return false;
+    }
+    const std::optional<std::vector<uint8_t>> bytes = ReadBytes(dependency.path);
+    if (!bytes.has_value() || HashBytes(bytes->data(), bytes->size()) != dependency.hash) {
+      return false;
+    }
+  }
+  return true;
+}
+
+LoadResult<uint32_t> WriteKtx2Siblings(const Scene& scene, Ktx2Supercompression supercompression) {
+  std::set<std::string> done;  // an image used both as color and as data is written once
+  uint32_t written = 0;
+  for (const Texture& texture : scene.textures) {
+    std::filesystem::path image(texture.uri);
+    std::string extension = image.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+    std::error_code ec;
+    if (texture.pixels.empty() || extension == kKtx2Extension || !std::filesystem::is_regular_file(image, ec) ||
+        !done.insert(texture.uri).second) {
+      continue;
+    }
+    std::string error;
+    if (!WriteKtx2(image.replace_extension(kKtx2Extension).string(), texture, supercompression, error)) {
+      return {.value = std::nullopt, .error = std::move(error)};
+    }
+    ++written;
+  }
+  return {.value = written, .error = {}};
+}
+
+CookFileResult CookFile(const CookJob& job, const CookSettings& settings) {
+  const auto start = std::chrono::steady_clock::now();
+  CookFileResult result;
+  result.source = job.source;
+
+  const std::optional<std::vector<uint8_t>> sourceBytes = ReadBytes(job.source);
+  if (!sourceBytes.has_value()) {
+    return Finish(result, CookStatus::kFailed, "cannot read " + job.source.string(), start);
+  }
+
+  ImportOptions options = settings.import;
+  options.lazyTextureDecode = false;
+  // Bounded cooks keep embedded images as files next to the cooked scenes, which reference them.
+  if (options.memoryBudgetBytes > 0 && options.textureSpillDir.empty()) {
+    std::error_code spillEc;
+    options.textureSpillDir = (std::filesystem::absolute(settings.outputDir, spillEc) / "textures").string();
+  }
+  ImportReport report;
+  const LoadResult<Scene> scene = ImportSceneFile(job.source.string(), options, &report);
+
+  std::error_code ec;
+  std::filesystem::create_directories(job.report.parent_path(), ec);
+  std::ofstream reportFile(job.report, std::ios::trunc);
+  reportFile << ImportReportToJson(report);
+  if (!reportFile) {
+    return Finish(result, CookStatus::kFailed, "cannot write " + job.report.string(), start);
+  }
+  if (!scene.Ok()) {
+    return Finish(result, CookStatus::kFailed, scene.error.empty() ? "import failed" : scene.error, start);
+  }
+
+  CookedSceneHeader header;
+  header.key = ComputeCookKey(*sourceBytes, settings.import);
+  header.dependencies = CollectDependencies(*scene.value, report, job.source);
+  std::string error;
+  if (!WriteCookedScene(job.output.string(), *scene.value, header, error)) {
+    return Finish(result, CookStatus::kFailed, std::move(error), start);
+  }
+  if (settings.writeKtx2) {
+    const LoadResult<uint32_t> siblings = WriteKtx2Siblings(*scene.value, settings.ktx2Supercompression);
+    if (!siblings.Ok()) {
+      return Finish(result, CookStatus::kFailed, siblings.error, start);
+    }
+  }
+  return Finish(result, CookStatus::kCooked, {}, start);
+}
+
+CookSummary RunCook(const std::vector<CookJob>& jobs,
+                    const CookSettings& settings,
+                    const std::function<void(const CookFileResult&)>& onResult) {
+  const auto start = std::chrono::steady_clock::now();
+  CookSummary summary;
+  summary.files.resize(jobs.size());
+  std::mutex mutex;
+  const auto record = [&](size_t job, CookFileResult result) {
+    std::lock_guard<std::mutex> lock(mutex);
+    summary.files[job] = std::move(result);
+    if (onResult) {
+      onResult(summary.files[job]);
+    }
+  };
+
+  // Hashing sources and dependencies dominates no-op runs, so the checks run in parallel; they
+  // finish (and their threads exit) before any worker process is forked.
+  std::vector<uint8_t> upToDate(jobs.size(), 0);
+  if (!settings.force) {
+    ParallelFor(jobs.size(), 1, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        const std::optional<std::vector<uint8_t>> bytes = ReadBytes(jobs[i].source);
+        upToDate[i] = bytes.has_value() && IsCookUpToDate(jobs[i], ComputeCookKey(*bytes, settings.import)) ? 1 : 0;
+      }
+    });
+  }
+  std::vector<size_t> pending;
+  for (size_t i = 0; i < jobs.size(); ++i) {
+    if (upToDate[i] != 0) {
+      CookFileResult result;
+      result.source = jobs[i].source;
+      result.status = CookStatus::kUpToDate;
+      record(i, std::move(result));
+    } else {
+      pending.push_back(i);
+    }
+  }
+
+  const size_t slots = std::max<size_t>(1, settings.jobs > 0 ? settings.jobs : WorkerThreadCount());
+#if defined(__unix__) || defined(__APPLE__)
+  if (settings.isolate) {
+    RunIsolated(jobs, pending, settings, slots, record);
+  } else {
+    RunThreaded(jobs, pending, settings, slots, record);
+  }
+#else
+  RunThreaded(jobs, pending, settings, slots, record);
+#endif
+
+  for (const CookFileResult& file : summary.files) {
+    summary.cooked += file.status == CookStatus::kCooked ? 1 : 0;
+    summary.upToDate += file.status == CookStatus::kUpToDate ? 1 : 0;
+    summary.failed += file.status == CookStatus::kFailed ? 1 : 0;
+  }
+  summary.wallMs = MillisecondsSince(start);
+  return summary;
+}
+
+}  // namespace vv
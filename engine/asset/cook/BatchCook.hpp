@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "asset/import/ImportOptions.hpp"
+#include "asset/texture/Ktx2.hpp"
+#include "core/types/CommonTypes.hpp"
+
+namespace vv {
+
+struct CookJob {
+  std::filesystem::path source;
+  std::filesystem::path output;  // <outputDir>/<path relative to its input>.vvscene
+  std::filesystem::path report;  // same with .report.json: the file's ImportReport
+};
+
+struct CookSettings {
+  ImportOptions import;  // lazyTextureDecode is ignored: cooked scenes carry decoded pixels
+  std::filesystem::path outputDir = "cooked";
+  uint32_t jobs = 0;        // files in flight; 0 = WorkerThreadCount()
+  bool isolate = true;      // one child process per file (POSIX); otherwise in-process threads
+  bool force = false;       // cook even when the output is up to date
+  uint32_t timeoutSec = 0;  // isolated files running longer are killed; 0 = no limit
+  // Also write each external image's texture as imported (mips, BC blocks) to a .ktx2 next to the
+  // image, which later imports load instead of decoding the image.
+  bool writeKtx2 = false;
+  Ktx2Supercompression ktx2Supercompression = Ktx2Supercompression::kNone;
+};
+
+enum class CookStatus {
+  kCooked,
+  kUpToDate,
+  kFailed,
+};
+
+struct CookFileResult {
+  std::filesystem::path source;
+  CookStatus status = CookStatus::kFailed;
+  std::string error;
+  double wallMs = 0.0;
+};
+
+struct CookSummary {
+  uint32_t cooked = 0;
+  uint32_t upToDate = 0;
+  uint32_t failed = 0;
+  double wallMs = 0.0;
+  std::vector<CookFileResult> files;  // in job order
+};
+
+// Inputs are model files, directories (searched recursively for .fbx, .gltf and .glb) or
+// manifests (.txt or .manifest: one file or directory per line, relative to the manifest; '#'
+// starts a comment).
+// Outputs mirror each file's path below its directory or manifest; a file given directly keeps
+// just its name. Fails on missing inputs and on two sources mapping to the same output.
+LoadResult<std::vector<CookJob>> CollectCookJobs(const std::vector<std::string>& inputs,
+                                                 const std::filesystem::path& outputDir);
+
+// Identifies one cook: format version, import options and the source bytes.
+uint64_t ComputeCookKey(const std::vector<uint8_t>& sourceBytes, const ImportOptions& options);
+
+// True when `job.output` was cooked from the same key and its dependencies are unchanged.
+bool IsCookUpToDate(const CookJob& job, uint64_t key);
+
+// Writes the .ktx2 siblings CookSettings::writeKtx2 asks for: one per external image file with
+// resident pixels, skipping images that already are KTX2. Returns the number written.
+LoadResult<uint32_t> WriteKtx2Siblings(const Scene& scene, Ktx2Supercompression supercompression);
+
+// Imports and writes one file in the calling process (no up-to-date check).
+CookFileResult CookFile(const CookJob& job, const CookSettings& settings);
+
+// Skips up-to-date jobs, then cooks the rest `settings.jobs` at a time. A crash, abort or timeout in
+// an isolated file fails only that file. `onResult` (optional) sees each file as it finishes; calls
+// never overlap.
+CookSummary RunCook(const std::vector<CookJob>& jobs,
+                    const CookSettings& settings,
+                    const std::function<void(const CookFileResult&)>& onResult = {});
+
+}  // namespace vv
@@ -0,0 +1,566 @@
+#include "asset/cook/CookedScene.hpp"
+
+#include <algorithm>
+#include <array>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+namespace vv {
+namespace {
+
+constexpr std::array<char, 8> kMagic = {'V', 'V', 'S', 'C', 'E', 'N', 'E', '\0'};
+constexpr uint32_t kFormatVersion = 3;
+
+// Structs written as raw bytes; any size change invalidates existing files.
+constexpr std::array<uint32_t, 10> kLayoutSizes = {
+    sizeof(VertexSkinned), sizeof(Submesh), sizeof(AABB),    sizeof(MeshCluster), sizeof(ClusterBoneBounds),
+    sizeof(KeyVec3),       sizeof(KeyQuat), sizeof(Mat4),    sizeof(Transform),   sizeof(Light),
+};
+
+class Writer {
+ public:
+  explicit Writer(std::ostream& out) : out_(out) {}
+
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  void Field(const T& value) {
+    Bytes(&value, sizeof(T));
+  }
+  void Field(const std::string& value) {
+    Count(value.size());
+    Bytes(value.data(), value.size());
+  }
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  void Field(const std::vector<T>& values) {
+    Count(values.size());
+    Bytes(values.data(), values.size() * sizeof(T));
+  }
+  void Field(const PixelBuffer& pixels) {
+    Count(pixels.size());
+    Bytes(pixels.data(), pixels.size());
+  }
+  void Field(const std::optional<uint32_t>& value) {
+    Field(static_cast<uint8_t>(value.has_value() ? 1 : 0));
+    Field(value.value_or(0));
+  }
+  void Field(const std::shared_ptr<const std::vector<uint8_t>>& bytes) {
+    Field(static_cast<uint8_t>(bytes != nullptr ? 1 : 0));
+    if (bytes != nullptr) {
+      Field(*bytes);
+    }
+  }
+  template <typename T, typename Fn>
+  void Array(const std::vector<T>& values, Fn&& fn) {
+    Count(values.size());
+    for (const T& value : values) {
+      fn(value);
+    }
+  }
+
+  bool Ok() const { return static_cast<bool>(out_); }
+
+ private:
+  void Count(size_t count) { Field(static_cast<uint64_t>(count)); }
+  void Bytes(const void* data, size_t size) {
+    if (size > 0) {
+      out_.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    }
+  }
+
+  std::ostream& out_;
+};
+
+// Mirrors Writer. Counts are checked against the bytes left before anything is allocated, so a
+// truncated or corrupt file fails instead of requesting huge buffers. While skipping, strings and
+// arrays are stepped over without being allocated (reading one asset of a file).
+class Reader {
+ public:
+  Reader(std::istream& in, uint64_t size) : in_(in), remaining_(size) {}
+
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  void Field(T& value) {
+    Bytes(&value, sizeof(T));
+  }
+  void Field(std::string& value) {
+    const uint64_t count = Count(1);
+    if (skipping_) {
+      Skip(count);
+      return;
+    }
+    value.resize(count);
+    Bytes(value.data(), count);
+  }
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  void Field(std::vector<T>& values) {
+    const uint64_t count = Count(sizeof(T));
+    if (skipping_) {
+      Skip(count * sizeof(T));
+      return;
+    }
+    values.resize(count);
+    Bytes(values.data(), count * sizeof(T));
+  }
+  void Field(PixelBuffer& pixels) {
+    const uint64_t count = Count(1);
+    if (skipping_) {
+      Skip(count);
+      return;
+    }
+    pixels.resize(count);
+    Bytes(pixels.data(), count);
+  }
+  void Field(std::optional<uint32_t>& value) {
+    uint8_t has = 0;
+    uint32_t stored = 0;
+    Field(has);
+    Field(stored);
+    value = has != 0 ? std::optional<uint32_t>(stored) : std::nullopt;
+  }
+  void Field(std::shared_ptr<const std::vector<uint8_t>>& bytes) {
+    uint8_t has = 0;
+    Field(has);
+    bytes.reset();
+    if (has != 0 && skipping_) {
+      std::vector<uint8_t> skipped;
+      Field(skipped);
+    } else if (has != 0) {
+      auto stored = std::make_shared<std::vector<uint8_t>>();
+      Field(*stored);
+      bytes = std::move(stored);
+    }
+  }
+  template <typename T, typename Fn>
+  void Array(std::vector<T>& values, Fn&& fn) {
+    const uint64_t count = Count(1);
+    values.resize(count);
+    for (T& value : values) {
+      fn(value);
+    }
+  }
+
+  uint64_t ArrayCount() { return Count(1); }
+  void SetSkipping(bool skipping) { skipping_ = skipping; }
+  bool Ok() const { return ok_; }
+
+ private:
+  uint64_t Count(size_t elementSize) {
+    uint64_t count = 0;
+    Field(count);
+    if (!ok_ || count > remaining_ / elementSize) {
+      ok_ = false;
+      return 0;
+    }
+    return count;
+  }
+  void Bytes(void* data, uint64_t size) {
+    if (!ok_ || size > remaining_) {
+      ok_ = false;
+      return;
+    }
+    if (size > 0 && !in_.read(static_cast<char*>(data), static_cast<std::streamsize>(size))) {
+      ok_ = false;
+      return;
+    }
+    remaining_ -= size;
+  }
+  void Skip(uint64_t size) {
+    if (!ok_ || size > remaining_) {
+      ok_ = false;
+      return;
+    }
+    if (size > 0 && !in_.seekg(static_cast<std::streamoff>(size), std::ios::cur)) {
+      ok_ = false;
+      return;
+    }
+    remaining_ -= size;
+  }
+
+  std::istream& in_;
+  uint64_t remaining_ = 0;
+  bool ok_ = true;
+  bool skipping_ = false;
+};
+
+template <typename Archive, typename MaterialT>
+void TransferMaterial(Archive& ar, MaterialT& m) {
+  ar.Field(m.name);
+  ar.Field(m.baseColorFactor);
+  ar.Field(m.metallicFactor);
+  ar.Field(m.roughnessFactor);
+  ar.Field(m.emissiveFactor);
+  ar.Field(m.emissiveStrength);
+  ar.Field(m.normalScale);
+  ar.Field(m.occlusionStrength);
+  ar.Field(m.baseColorTex);
+  ar.Field(m.metallicRoughnessTex);
+  ar.Field(m.metallicTex);
+  ar.Field(m.roughnessTex);
+  ar.Field(m.normalTex);
+  ar.Field(m.occlusionTex);
+  ar.Field(m.emissiveTex);
+  ar.Field(m.specularTex);
+  ar.Field(m.useSeparateMetalRoughness);
+  ar.Field(m.useSpecularGlossiness);
+  ar.Field(m.normalGreenInverted);
+  ar.Field(m.gridOverlay);
+  ar.Field(m.legacyShininess);
+  ar.Field(m.alphaMask);
+  ar.Field(m.alphaCutoff);
+}
+
+// Shared assets are written from the asset and read into the scene's own fresh copy.
+template <typename T>
+const T& AssetFields(const SharedAsset<T>& asset) {
+  return *asset;
+}
+
+template <typename T>
+T& AssetFields(SharedAsset<T>& asset) {
+  return asset.Edit();
+}
+
+template <typename Archive, typename NodeT>
+void TransferNode(Archive& ar, NodeT& node) {
+  ar.Field(node.name);
+  ar.Field(node.parent);
+  ar.Field(node.children);
+  ar.Field(node.localBind);
+  ar.Field(node.localCurrent);
+  ar.Field(node.worldCurrent);
+  ar.Field(node.mesh);
+  ar.Field(node.skin);
+  ar.Field(node.light);
+}
+
+template <typename Archive, typename MeshT>
+void TransferMesh(Archive& ar, MeshT& mesh) {
+  ar.Field(mesh.name);
+  ar.Field(mesh.vertices);
+  ar.Field(mesh.indices);
+  ar.Field(mesh.submeshes);
+  ar.Field(mesh.localBounds);
+  ar.Field(mesh.vertexLayout);
+  ar.Field(mesh.packedVertices);
+  ar.Field(mesh.clusters);
+  ar.Field(mesh.clusterBones);
+  ar.Array(mesh.lods, [&](auto& lod) {
+    ar.Field(lod.submeshes);
+    ar.Field(lod.error);
+  });
+  ar.Array(mesh.morphTargets, [&](auto& target) {
+    ar.Field(target.name);
+    ar.Field(target.vertices);
+    for (size_t c = 0; c < 3; ++c) {
+      ar.Field(target.positionDeltas[c]);
+      ar.Field(target.normalDeltas[c]);
+    }
+    ar.Field(target.positionScale);
+    ar.Field(target.normalScale);
+  });
+  ar.Field(mesh.morphWeights);
+}
+
+template <typename Archive, typename SkeletonT>
+void TransferSkeleton(Archive& ar, SkeletonT& skeleton) {
+  ar.Field(skeleton.name);
+  ar.Field(skeleton.rootNode);
+  ar.Array(skeleton.bones, [&](auto& bone) {
+    ar.Field(bone.name);
+    ar.Field(bone.node);
+    ar.Field(bone.parentBone);
+    ar.Field(bone.inverseBind);
+    ar.Field(bone.globalBind);
+  });
+}
+
+template <typename Archive, typename SkinT>
+void TransferSkin(Archive& ar, SkinT& skin) {
+  ar.Field(skin.skeleton);
+  ar.Field(skin.mesh);
+  ar.Field(skin.joints);
+  ar.Field(skin.palette);
+}
+
+template <typename Archive, typename ClipT>
+void TransferClip(Archive& ar, ClipT& clip) {
+  ar.Field(clip.name);
+  ar.Field(clip.durationSec);
+  ar.Field(clip.ticksPerSec);
+  ar.Array(clip.tracks, [&](auto& track) {
+    ar.Field(track.node);
+    ar.Field(track.posKeys);
+    ar.Field(track.rotKeys);
+    ar.Field(track.sclKeys);
+  });
+  ar.Array(clip.morphTracks, [&](auto& track) {
+    ar.Field(track.node);
+    ar.Field(track.targets);
+    ar.Field(track.times);
+    ar.Field(track.weights);
+  });
+}
+
+template <typename Archive, typename TextureT>
+void TransferTexture(Archive& ar, TextureT& texture) {
+  ar.Field(texture.uri);
+  ar.Field(texture.width);
+  ar.Field(texture.height);
+  ar.Field(texture.format);
+  ar.Field(texture.srgb);
+  ar.Field(texture.normalMap);
+  ar.Field(texture.mipLevels);
+  ar.Field(texture.contentHash);
+  ar.Field(texture.pixels);
+  ar.Field(texture.source.path);
+  ar.Field(texture.source.bytes);
+  ar.Field(texture.source.rawWidth);
+  ar.Field(texture.source.rawHeight);
+  ar.Field(texture.source.sizeBytes);
+}
+
+// One field list serves both directions; SceneT is `const Scene` when writing. The per-asset
+// transfers above are also used on their own to read a single mesh or texture.
+template <typename Archive, typename SceneT>
+void TransferScene(Archive& ar, SceneT& scene) {
+  ar.Field(scene.roots);
+  ar.Array(scene.nodes, [&](auto& node) { TransferNode(ar, node); });
+  ar.Array(scene.meshes, [&](auto& asset) { TransferMesh(ar, AssetFields(asset)); });
+  ar.Array(scene.skeletons, [&](auto& asset) { TransferSkeleton(ar, AssetFields(asset)); });
+  ar.Array(scene.skins, [&](auto& skin) { TransferSkin(ar, skin); });
+  ar.Array(scene.clips, [&](auto& asset) { TransferClip(ar, AssetFields(asset)); });
+  ar.Array(scene.materials, [&](auto& material) { TransferMaterial(ar, material); });
+  ar.Array(scene.textures, [&](auto& asset) { TransferTexture(ar, AssetFields(asset)); });
+  ar.Field(scene.lights);
+}
+
+// Steps over one array section of the scene without allocating its elements' arrays.
+template <typename T, typename Fn>
+void SkipArray(Reader& reader, Fn&& transfer) {
+  const uint64_t count = reader.ArrayCount();
+  T scratch{};
+  for (uint64_t i = 0; i < count && reader.Ok(); ++i) {
+    transfer(scratch);
+  }
+}
+
+// Reads element `index` of the array section at the reader's position; the ones before it are
+// skipped. The reader must be skipping on entry.
+template <typename T, typename Fn>
+bool ReadArrayElement(Reader& reader, uint64_t index, T& out, Fn&& transfer) {
+  const uint64_t count = reader.ArrayCount();
+  if (!reader.Ok() || index >= count) {
+    return false;
+  }
+  T scratch{};
+  for (uint64_t i = 0; i < index && reader.Ok(); ++i) {
+    transfer(scratch);
+  }
+  reader.SetSkipping(false);
+  transfer(out);
+  return reader.Ok();
+}
+
+void WriteHeader(Writer& writer, const CookedSceneHeader& header) {
+  writer.Field(kMagic);
+  writer.Field(kFormatVersion);
+  writer.Field(kLayoutSizes);
+  writer.Field(header.key);
+  writer.Array(header.dependencies, [&](const CookedDependency& dependency) {
+    writer.Field(dependency.path);
+    writer.Field(dependency.size);
+    writer.Field(dependency.hash);
+  });
+}
+
+std::string ReadHeader(Reader& reader, CookedSceneHeader& header) {
+  std::array<char, 8> magic{};
+  uint32_t version = 0;
+  std::array<uint32_t, kLayoutSizes.size()> layout{};
+  reader.Field(magic);
+  if (!reader.Ok() || magic != kMagic) {
+    return "not a cooked scene";
+  }
+  reader.Field(version);
+  if (version != kFormatVersion) {
+    return "unsupported cooked scene version " + std::to_string(version);
+  }
+  reader.Field(layout);
+  if (layout != kLayoutSizes) {
+    return "cooked scene was written with a different struct layout";
+  }
+  reader.Field(header.key);
+  reader.Array(header.dependencies, [&](CookedDependency& dependency) {
+    reader.Field(dependency.path);
+    reader.Field(dependency.size);
+    reader.Field(dependency.hash);
+  });
+  return reader.Ok() ? std::string{} : "truncated cooked scene header";
+}
+
+std::optional<uint64_t> FileSize(const std::string& path) {
+  std::error_code ec;
+  const uint64_t size = std::filesystem::file_size(path, ec);
+  if (ec) {
+    return std::nullopt;
+  }
+  return size;
+}
+
+// Opens a cooked scene, checks its header and reads one asset through `read`, which finds it from
+// the start of the scene with the reader skipping.
+template <typename T, typename Fn>
+LoadResult<T> ReadCookedAsset(const std::string& path, Fn&& read) {
+  const std::optional<uint64_t> size = FileSize(path);
+  std::ifstream in(path, std::ios::binary);
+  if (!size.has_value() || !in) {
+    return {.value = std::nullopt, .error = "cannot open " + path};
+  }
+  Reader reader(in, *size);
+  CookedSceneHeader header;
+  const std::string error = ReadHeader(reader, header);
+  if (!error.empty()) {
+    return {.value = std::nullopt, .error = path + ": " + error};
+  }
+  reader.SetSkipping(true);
+  T asset;
+  if (!read(reader, asset)) {
+    return {.value = std::nullopt, .error = path + ": asset not found, or truncated or corrupt cooked scene"};
+  }
+  return {.value = std::move(asset), .error = {}};
+}
+
+}  // namespace
+
+bool WriteCookedScene(const std::string& path, const Scene& scene, const CookedSceneHeader& header, std::string& error) {
+  // Released arrays would be written as empty ones; the scene has to be rehydrated first.
+  if (std::any_of(scene.meshes.begin(), scene.meshes.end(), [](const SharedAsset<Mesh>& mesh) { return mesh->arraysReleased; }) ||
+      std::any_of(scene.textures.begin(), scene.textures.end(), [](const SharedAsset<Texture>& texture) { return texture->pixelsReleased; })) {
+    error = "scene has released CPU arrays (RehydrateScene)";
+    return false;
+  }
+  const std::filesystem::path target(path);
+  std::error_code ec;
+  if (target.has_parent_path()) {
+    std::filesystem::create_directories(target.parent_path(), ec);
+  }
+  // Written next to the target and renamed, so readers never see a partial file.
+  const std::filesystem::path temp = target.string() + ".tmp";
+  {
+    std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+    if (!out) {
+      error = "cannot open " + temp.string() + " for writing";
+      return false;
+    }
+    Writer writer(out);
+    WriteHeader(writer, header);
+    TransferScene(writer, scene);
+    out.flush();
+    if (!writer.Ok()) {
+      error = "failed writing " + temp.string();
+      out.close();
+      std::filesystem::remove(temp, ec);
+      return false;
+    }
+  }
+  std::filesystem::rename(temp, target, ec);
+  if (ec) {
+    error = "cannot rename " + temp.string() + ": " + ec.message();
+    std::filesystem::remove(temp, ec);
+    return false;
+  }
+  return true;
+}
+
+LoadResult<CookedSceneHeader> ReadCookedSceneHeader(const std::string& path) {
+  const std::optional<uint64_t> size = FileSize(path);
+  std::ifstream in(path, std::ios::binary);
+  if (!size.has_value() || !in) {
+    return {.value = std::nullopt, .error = "cannot open " + path};
+  }
+  Reader reader(in, *size);
+  CookedSceneHeader header;
+  const std::string error = ReadHeader(reader, header);
+  if (!error.empty()) {
+    return {.value = std::nullopt, .error = path + ": " + error};
+  }
+  return {.value = std::move(header), .error = {}};
+}
+
+LoadResult<Scene> ReadCookedScene(const std::string& path) {
+  const std::optional<uint64_t> size = FileSize(path);
+  std::ifstream in(path, std::ios::binary);
+  if (!size.has_value() || !in) {
+    return {.value = std::nullopt, .error = "cannot open " + path};
+  }
+  Reader reader(in, *size);
+  CookedSceneHeader header;
+  const std::string error = ReadHeader(reader, header);
+  if (!error.empty()) {
+    return {.value = std::nullopt, .error = path + ": " + error};
+  }
+
+  Scene scene;
+  TransferScene(reader, scene);
+  if (!reader.Ok()) {
+    return {.value = std::nullopt, .error = path + ": truncated or corrupt cooked scene"};
+  }
+  for (SharedAsset<Skeleton>& asset : scene.skeletons) {
+    Skeleton& skeleton = asset.Edit();
+    for (uint32_t i = 0; i < skeleton.bones.size(); ++i) {
+      skeleton.boneMap[skeleton.bones[i].name] = i;
+    }
+  }
+  SetCookedLocations(scene, path);
+  return {.value = std::move(scene), .error = {}};
+}
+
+LoadResult<Mesh> ReadCookedMesh(const std::string& path, MeshId mesh) {
+  LoadResult<Mesh> loaded = ReadCookedAsset<Mesh>(path, [&](Reader& reader, Mesh& out) {
+    std::vector<NodeId> roots;
+    reader.Field(roots);
+    SkipArray<Node>(reader, [&](Node& node) { TransferNode(reader, node); });
+    return ReadArrayElement(reader, mesh, out, [&](Mesh& m) { TransferMesh(reader, m); });
+  });
+  if (loaded.Ok()) {
+    loaded.value->cooked = {.path = path, .index = mesh};
+  }
+  return loaded;
+}
+
+LoadResult<Texture> ReadCookedTexture(const std::string& path, TextureId texture) {
+  LoadResult<Texture> loaded = ReadCookedAsset<Texture>(path, [&](Reader& reader, Texture& out) {
+    std::vector<NodeId> roots;
+    reader.Field(roots);
+    SkipArray<Node>(reader, [&](Node& node) { TransferNode(reader, node); });
+    SkipArray<Mesh>(reader, [&](Mesh& m) { TransferMesh(reader, m); });
+    SkipArray<Skeleton>(reader, [&](Skeleton& skeleton) { TransferSkeleton(reader, skeleton); });
+    SkipArray<Skin>(reader, [&](Skin& skin) { TransferSkin(reader, skin); });
+    SkipArray<AnimationClip>(reader, [&](AnimationClip& clip) { TransferClip(reader, clip); });
+    SkipArray<Material>(reader, [&](Material& material) { TransferMaterial(reader, material); });
+    return ReadArrayElement(reader, texture, out, [&](Texture& t) { TransferTexture(reader, t); });
+  });
+  if (loaded.Ok()) {
+    loaded.value->cooked = {.path = path, .index = texture};
+  }
+  return loaded;
+}
+
+void SetCookedLocations(Scene& scene, const std::string& path) {
+  for (uint32_t i = 0; i < scene.meshes.size(); ++i) {
+    scene.meshes[i].Edit().cooked = {.path = path, .index = i};
+  }
+  // Lazy and streaming textures are stored without pixels; they keep decoding from their source.
+  for (uint32_t i = 0; i < scene.textures.size(); ++i) {
+    if (!scene.textures[i]->pixels.empty()) {
+      scene.textures[i].Edit().cooked = {.path = path, .index = i};
+    }
+  }
+}
+
+}  // namespace vv
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "core/types/CommonTypes.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+constexpr const char* kCookedSceneExtension = ".vvscene";
+
+struct CookedDependency {
+  std::string path;   // file read by the import besides the source (external textures)
+  uint64_t size = 0;
+  uint64_t hash = 0;  // HashBytes of the contents
+};
+
+struct CookedSceneHeader {
+  uint64_t key = 0;  // what the scene was cooked from: source bytes, import options (see ComputeCookKey)
+  std::vector<CookedDependency> dependencies;
+};
+
+// Binary snapshot of an imported Scene, loadable without Assimp. Plain structs (vertices, clusters,
+// keys, matrices) are stored as raw bytes, so a file is only valid for the struct layout that wrote
+// it; the header carries a layout signature and readers reject files from another layout.
+// Lazy textures keep their TextureSource; decoded pixels are stored as they are (mips, BC blocks).
+// Fails for scenes with released arrays (see RehydrateScene).
+bool WriteCookedScene(const std::string& path, const Scene& scene, const CookedSceneHeader& header, std::string& error);
+
+// Reads only the header, for up-to-date checks.
+LoadResult<CookedSceneHeader> ReadCookedSceneHeader(const std::string& path);
+// Meshes and textures of the scene remember the file and their index in it (Mesh/Texture::cooked).
+LoadResult<Scene> ReadCookedScene(const std::string& path);
+
+// Read one mesh or texture of a cooked scene; the assets before it are stepped over, not loaded.
+LoadResult<Mesh> ReadCookedMesh(const std::string& path, MeshId mesh);
+LoadResult<Texture> ReadCookedTexture(const std::string& path, TextureId texture);
+
+// Records `path`, a cooked file holding `scene` as it is now, as where its meshes and decoded
+// textures are read back from after ApplyCpuResidency releases their arrays.
+void SetCookedLocations(Scene& scene, const std::string& path);
+
+}  // namespace vv
@@ -6,9 +6,11 @@
 #include <cmath>
 #include <cstdint>
 #include <filesystem>
-#include <functional>
+#include <fstream>
 #include <initializer_list>
+#include <memory>
 #include <optional>
+#include <string>
 #include <unordered_map>
 #include <utility>
 
@@ -20,23 +22,28 @@
 #include <assimp/scene.h>
 #include <glm/gtc/quaternion.hpp>
 
+#include "asset/import/ConversionKernels.hpp"
+#include "asset/import/ImportCommon.hpp"
+#include "asset/import/ImportReport.hpp"
+#include "asset/import/MaterialPacking.hpp"
+#include "asset/import/ScenePruning.hpp"
+#include "asset/index/AssetDirectoryIndex.hpp"
+#include "asset/mesh/MorphTargets.hpp"
 #include "asset/mesh/SkinWeight.hpp"
 #include "asset/texture/ImageLoader.hpp"
+#include "asset/texture/Ktx2.hpp"
+#include "asset/texture/MipGenerator.hpp"
+#include "asset/texture/TextureRegistry.hpp"
 
 namespace vv {
 namespace {
 
-constexpr TextureId kDefaultWhiteSrgb = 0;
-constexpr TextureId kDefaultBlackLinear = 1;
-constexpr TextureId kDefaultNormal = 2;
-constexpr TextureId kDefaultSpecular = 3;
-constexpr TextureId kDefaultWhiteLinear = 4;
-
 struct SceneConversion {
   Mat4 c{1.0F};
   Mat4 cInv{1.0F};
   glm::mat3 r{1.0F};
   glm::mat3 rInv{1.0F};
+  RotationBasisChange rotation;  // r * q * rInv in quaternion form
   float unitScale = 1.0F;
 };
 
@@ -65,47 +72,6 @@ Vec3 ToVec3(const aiVector3D& v) {
   return Vec3(v.x, v.y, v.z);
 }
 
-Quat ToQuat(const aiQuaternion& q) {
-  return Quat(q.w, q.x, q.y, q.z);
-}
-
-Transform DecomposeTransform(const Mat4& m) {
-  Transform t;
-  t.translation = Vec3(m[3]);
-
-  Vec3 basisX = Vec3(m[0]);
-  Vec3 basisY = Vec3(m[1]);
-  Vec3 basisZ = Vec3(m[2]);
-
-  t.scale.x = glm::length(basisX);
-  t.scale.y = glm::length(basisY);
-  t.scale.z = glm::length(basisZ);
-
-  constexpr float kEps = 1e-8F;
-  if (t.scale.x <= kEps || t.scale.y <= kEps || t.scale.z <= kEps) {
-    t.rotation = Quat(1.0F, 0.0F, 0.0F, 0.0F);
-    t.scale = Vec3(1.0F);
-    return t;
-  }
-
-  basisX /= t.scale.x;
-  basisY /= t.scale.y;
-  basisZ /= t.scale.z;
-
-  glm::mat3 rot(1.0F);
-  rot[0] = basisX;
-  rot[1] = basisY;
-  rot[2] = basisZ;
-
-  if (glm::determinant(rot) < 0.0F) {
-    t.scale.x = -t.scale.x;
-    rot[0] = -rot[0];
-  }
-
-  t.rotation = glm::normalize(glm::quat_cast(rot));
-  return t;
-}
-
 int GetMetaInt(const aiScene* scene, const char* key, int fallback) {
   if (scene->mMetaData == nullptr) {
     return fallback;
@@ -158,6 +124,7 @@ SceneConversion BuildConversion(const aiScene* srcScene, const ImportOptions& op
   conv.rInv = glm::inverse(rot);
   conv.c = glm::scale(Mat4(1.0F), Vec3(unitScale)) * Mat4(rot);
   conv.cInv = glm::inverse(conv.c);
+  conv.rotation = MakeRotationBasisChange(rot);
   return conv;
 }
 
@@ -173,19 +140,18 @@ Vec3 ConvertDirection(const SceneConversion& conv, const Vec3& v) {
   return NormalizeSafe(conv.r * v);
 }
 
-Vec3 ConvertPosition(const SceneConversion& conv, const Vec3& v) {
-  const Vec4 p = conv.c * Vec4(v, 1.0F);
-  return Vec3(p);
-}
-
-Quat ConvertRotation(const SceneConversion& conv, const Quat& q) {
-  const Mat4 m = glm::mat4_cast(q);
-  const Mat4 m2 = Mat4(conv.r) * m * Mat4(conv.rInv);
-  return glm::normalize(glm::quat_cast(m2));
+void GatherVectors(const aiVector3D* src, unsigned count, Vec3Soa& out) {
+  out.Resize(count);
+  for (unsigned i = 0; i < count; ++i) {
+    out.x[i] = src[i].x;
+    out.y[i] = src[i].y;
+    out.z[i] = src[i].z;
+  }
 }
 
 struct ImportContext {
   const aiScene* src = nullptr;
+  aiScene* owned = nullptr;  // bounded-memory imports: same scene, parts freed once converted
   SceneConversion conv;
   Scene dst;
   std::filesystem::path sourceDir;
@@ -194,67 +160,15 @@ struct ImportContext {
   std::unordered_map<std::string, NodeId> nodeByName;
   std::unordered_map<uint32_t, NodeId> meshNode;
   std::unordered_map<std::string, TextureId> textureMap;
-  std::unordered_map<std::string, std::filesystem::path> textureFileIndex;
-  bool textureFileIndexBuilt = false;
+  std::unordered_map<uint64_t, TextureId> textureByContent;  // content hash + sRGB bit
+  bool shareDecodedTextures = true;
+  bool cacheDecodedImages = false;  // the registry holds decodes itself (compressed imports)
+  bool reserveMipChains = true;  // allocate decoded pixels with room for the full mip chain
+  bool lazyTextures = false;     // keep TextureSource handles instead of decoded pixels
+  std::filesystem::path spillDir;  // non-empty: embedded lazy images go to files here, not memory
+  ImportReport* report = nullptr;
 };
 
-TextureId AddDefaultTexture(ImportContext& ctx, const std::string& name) {
-  Texture tex;
-  tex.uri = name;
-  tex.format = PixelFormat::kR8G8B8A8;
-  tex.width = 1;
-  tex.height = 1;
-  tex.srgb = true;
-  tex.pixels = {255, 255, 255, 255};
-  if (name.find("black") != std::string::npos) {
-    tex.srgb = false;
-    tex.pixels = {0, 0, 0, 255};
-  }
-  if (name.find("linear_white") != std::string::npos) {
-    tex.srgb = false;
-    tex.pixels = {255, 255, 255, 255};
-  }
-  if (name.find("normal") != std::string::npos) {
-    tex.srgb = false;
-    tex.pixels = {128, 128, 255, 255};
-  }
-  if (name.find("spec") != std::string::npos) {
-    tex.srgb = true;
-    tex.pixels = {56, 56, 56, 255};  // ~0.04 linear reflectance in sRGB
-  }
-  ctx.dst.textures.push_back(std::move(tex));
-  return static_cast<TextureId>(ctx.dst.textures.size() - 1);
-}
-
-std::string NormalizeTextureUri(const std::string& uri) {
-  std::string normalized = uri;
-  std::replace(normalized.begin(), normalized.end(), '\\', '/');
-  while (!normalized.empty() &&
-         (normalized.front() == ' ' || normalized.front() == '\t' || normalized.front() == '\n' ||
-          normalized.front() == '\r' || normalized.front() == '"' || normalized.front() == '\'')) {
-    normalized.erase(normalized.begin());
-  }
-  while (!normalized.empty() &&
-         (normalized.back() == ' ' || normalized.back() == '\t' || normalized.back() == '\n' ||
-          normalized.back() == '\r' || normalized.back() == '"' || normalized.back() == '\'')) {
-    normalized.pop_back();
-  }
-
-  std::string lowered = normalized;
-  std::transform(lowered.begin(), lowered.end(), lowered.begin(), [](unsigned char c) {
-    return static_cast<char>(std::tolower(c));
-  });
-  constexpr const char* kFilePrefix = "file://";
-  if (lowered.rfind(kFilePrefix, 0) == 0) {
-    normalized = normalized.substr(7);
-    if (normalized.size() >= 3 && normalized[0] == '/' &&
-        std::isalpha(static_cast<unsigned char>(normalized[1])) && normalized[2] == ':') {
-      normalized.erase(normalized.begin());
-    }
-  }
-  return normalized;
-}
-
 std::string MakeTextureCacheKey(const std::string& normalizedUri, bool srgb) {
   std::string key = normalizedUri;
   key += srgb ? "|srgb" : "|linear";
@@ -268,77 +182,194 @@ std::string ToLowerAscii(std::string value) {
   return value;
 }
 
-void BuildTextureFileIndex(ImportContext& ctx) {
-  if (ctx.textureFileIndexBuilt) {
-    return;
+TextureId AppendDecodedTexture(ImportContext& ctx,
+                               const std::string& textureKey,
+                               const std::string& textureUri,
+                               ImageRgba8 decoded,
+                               bool srgb,
+                               uint64_t contentHash,
+                               size_t sourceBytes) {
+  Texture tex;
+  tex.uri = textureUri;
+  tex.width = decoded.width;
+  tex.height = decoded.height;
+  tex.pixels = std::move(decoded.pixels);
+  if (ctx.reserveMipChains) {
+    tex.pixels.reserve(MipLevelOffset(tex.width, tex.height, FullMipLevelCount(tex.width, tex.height)));
   }
-  ctx.textureFileIndexBuilt = true;
+  tex.srgb = srgb;
+  tex.format = srgb ? PixelFormat::kR8G8B8A8_SRGB : PixelFormat::kR8G8B8A8;
+  tex.contentHash = contentHash;
+  tex.source.sizeBytes = sourceBytes;
+  ctx.dst.textures.push_back(std::move(tex));
+  const TextureId id = static_cast<TextureId>(ctx.dst.textures.size() - 1);
+  ctx.textureMap[textureKey] = id;
+  ctx.textureByContent[(contentHash << 1U) | (srgb ? 1U : 0U)] = id;
+  return id;
+}
 
-  std::error_code ec;
-  std::filesystem::recursive_directory_iterator it(ctx.sourceDir, std::filesystem::directory_options::skip_permission_denied, ec);
-  if (ec) {
-    return;
+// Lazily imported textures keep only their size and a TextureSource; pixels are decoded when the
+// renderer first uploads them (TextureRegistry::AcquirePixels).
+TextureId AppendLazyTexture(ImportContext& ctx,
+                            const std::string& textureKey,
+                            const std::string& textureUri,
+                            const ImageInfo& info,
+                            TextureSource source,
+                            bool srgb,
+                            uint64_t contentHash) {
+  Texture tex;
+  tex.uri = textureUri;
+  tex.width = info.width;
+  tex.height = info.height;
+  tex.srgb = srgb;
+  tex.format = srgb ? PixelFormat::kR8G8B8A8_SRGB : PixelFormat::kR8G8B8A8;
+  tex.contentHash = contentHash;
+  tex.source = std::move(source);
+  ctx.dst.textures.push_back(std::move(tex));
+  const TextureId id = static_cast<TextureId>(ctx.dst.textures.size() - 1);
+  ctx.textureMap[textureKey] = id;
+  ctx.textureByContent[(contentHash << 1U) | (srgb ? 1U : 0U)] = id;
+  return id;
+}
+
+// KTX2 levels are already in their GPU format: nothing is decoded or shared through the registry.
+// The chain is copied as stored, or, for lazy imports, left in the file for the upload to read.
+std::optional<TextureId> AppendKtx2Texture(ImportContext& ctx,
+                                           const std::string& textureKey,
+                                           const std::string& textureUri,
+                                           const uint8_t* bytes,
+                                           size_t sizeBytes,
+                                           bool srgb,
+                                           const std::string& path,
+                                           uint64_t contentHash) {
+  const std::optional<Ktx2Info> info = ReadKtx2Info(bytes, sizeBytes);
+  if (!info.has_value()) {
+    return std::nullopt;
   }
-  for (const auto& entry : it) {
-    if (!entry.is_regular_file()) {
-      continue;
+  Texture tex = MakeKtx2Texture(*info, srgb);
+  tex.uri = textureUri;
+  tex.contentHash = contentHash;
+  if (ctx.lazyTextures) {
+    tex.source.path = path;
+    if (path.empty()) {
+      tex.source.bytes = std::make_shared<const std::vector<uint8_t>>(bytes, bytes + sizeBytes);
+    }
+    tex.source.sizeBytes = sizeBytes;
+  } else {
+    tex.pixels = PixelBuffer(Ktx2ChainBytes(*info));
+    if (!ReadKtx2Levels(bytes, sizeBytes, *info, tex.pixels.data())) {
+      return std::nullopt;
     }
-    const std::string lowerName = ToLowerAscii(entry.path().filename().string());
-    ctx.textureFileIndex.try_emplace(lowerName, entry.path());
   }
+  TextureRegistry::Global().RecordSourceImage(false);
+  ctx.dst.textures.push_back(std::move(tex));
+  const TextureId id = static_cast<TextureId>(ctx.dst.textures.size() - 1);
+  ctx.textureMap[textureKey] = id;
+  ctx.textureByContent[(contentHash << 1U) | (srgb ? 1U : 0U)] = id;
+  return id;
 }
 
-std::optional<std::filesystem::path> ResolveTexturePath(ImportContext& ctx, const std::string& normalizedUri) {
-  if (normalizedUri.empty()) {
-    return std::nullopt;
+// Dedups by a hash of the source bytes before decoding: first against textures already in this
+// scene (different relative paths, copies in other folders), then against the process-wide
+// registry filled by earlier imports. Only content seen for the first time is decoded, and in
+// lazy mode nothing is decoded here at all. A fresh decode moves into the scene, which publishes it
+// to the registry once imported; only a registry hit costs one memcpy, made straight into a buffer
+// sized for the mip chain. Compressed imports keep no RGBA8 pixels, so there the registry holds the
+// decode itself and the scene gets the copy.
+// `path` is the file the bytes came from (empty for embedded data); rawWidth > 0 marks BGRA8
+// texels instead of an encoded image.
+std::optional<TextureId> AppendSourceTexture(ImportContext& ctx,
+                                             const std::string& cacheKey,
+                                             const std::string& textureUri,
+                                             const uint8_t* bytes,
+                                             size_t sizeBytes,
+                                             bool srgb,
+                                             const std::string& path,
+                                             uint32_t rawWidth,
+                                             uint32_t rawHeight) {
+  TextureRegistry& registry = TextureRegistry::Global();
+  const uint64_t hash = HashBytes(bytes, sizeBytes);
+
+  const auto local = ctx.textureByContent.find((hash << 1U) | (srgb ? 1U : 0U));
+  if (local != ctx.textureByContent.end()) {
+    const Texture& existing = ctx.dst.textures[local->second];
+    registry.RecordSourceImage(false);
+    registry.RecordSceneDuplicate(static_cast<uint64_t>(existing.width) * existing.height * 4);
+    ctx.textureMap[cacheKey] = local->second;
+    return local->second;
   }
-
-  std::error_code ec;
-  const std::filesystem::path inputPath(normalizedUri);
-  if (inputPath.is_absolute() && std::filesystem::exists(inputPath, ec) && !ec) {
-    return inputPath;
+  if (rawWidth == 0 && IsKtx2(bytes, sizeBytes)) {
+    return AppendKtx2Texture(ctx, cacheKey, textureUri, bytes, sizeBytes, srgb, path, hash);
   }
 
-  const std::filesystem::path localPath = ctx.sourceDir / inputPath;
-  ec.clear();
-  if (std::filesystem::exists(localPath, ec) && !ec) {
-    return localPath;
+  if (ctx.lazyTextures) {
+    const std::optional<ImageInfo> info =
+        rawWidth > 0 ? std::optional<ImageInfo>(ImageInfo{rawWidth, rawHeight}) : ReadImageInfoFromMemory(bytes, sizeBytes);
+    if (!info.has_value()) {
+      return std::nullopt;
+    }
+    TextureSource source;
+    source.path = path;
+    if (path.empty() && !ctx.spillDir.empty()) {
+      source.path = SpillEmbeddedImage(ctx.spillDir, bytes, sizeBytes, hash, rawWidth > 0);
+    }
+    if (path.empty()) {
+      source.rawWidth = rawWidth;
+      source.rawHeight = rawHeight;
+    }
+    if (source.path.empty()) {
+      source.bytes = std::make_shared<const std::vector<uint8_t>>(bytes, bytes + sizeBytes);
+    }
+    source.sizeBytes = sizeBytes;
+    registry.RecordSourceImage(false);
+    return AppendLazyTexture(ctx, cacheKey, textureUri, *info, std::move(source), srgb, hash);
   }
 
-  const std::filesystem::path filename = inputPath.filename();
-  if (!filename.empty()) {
-    const std::filesystem::path siblingPath = ctx.sourceDir / filename;
-    ec.clear();
-    if (std::filesystem::exists(siblingPath, ec) && !ec) {
-      return siblingPath;
+  TextureRegistry::CachedImage cached;
+  if (ctx.shareDecodedTextures) {
+    cached = registry.FindDecoded(hash, sizeBytes);
+  }
+  if (cached) {
+    registry.RecordSourceImage(false);
+    registry.RecordRegistryHit(sizeBytes);
+  } else {
+    auto decoded = rawWidth > 0 ? std::optional<ImageRgba8>(ConvertBgra8(bytes, rawWidth, rawHeight))
+                                : LoadImageRgba8FromMemory(bytes, sizeBytes);
+    if (!decoded.has_value()) {
+      return std::nullopt;
     }
-
-    BuildTextureFileIndex(ctx);
-    const auto indexed = ctx.textureFileIndex.find(ToLowerAscii(filename.string()));
-    if (indexed != ctx.textureFileIndex.end()) {
-      return indexed->second;
+    registry.RecordSourceImage(true);
+    if (!ctx.cacheDecodedImages) {
+      return AppendDecodedTexture(ctx, cacheKey, textureUri, std::move(*decoded), srgb, hash, sizeBytes);
     }
+    const std::shared_ptr<const ImageRgba8> image = registry.Insert(hash, sizeBytes, std::move(*decoded));
+    cached = {image, image->pixels.data(), image->width, image->height};
   }
 
-  return std::nullopt;
+  ImageRgba8 copy;
+  copy.width = cached.width;
+  copy.height = cached.height;
+  const size_t chainBytes =
+      ctx.reserveMipChains ? MipLevelOffset(copy.width, copy.height, FullMipLevelCount(copy.width, copy.height)) : 0;
+  copy.pixels = PixelBuffer::Copy(cached.pixels, cached.SizeBytes(), chainBytes);
+  return AppendDecodedTexture(ctx, cacheKey, textureUri, std::move(copy), srgb, hash, sizeBytes);
 }
 
-TextureId AppendDecodedTexture(ImportContext& ctx,
-                               const std::string& textureKey,
-                               const std::string& textureUri,
-                               const ImageRgba8& decoded,
-                               bool srgb) {
-  Texture tex;
-  tex.uri = textureUri;
-  tex.width = decoded.width;
-  tex.height = decoded.height;
-  tex.pixels = decoded.pixels;
-  tex.srgb = srgb;
-  tex.format = srgb ? PixelFormat::kR8G8B8A8_SRGB : PixelFormat::kR8G8B8A8;
-  ctx.dst.textures.push_back(std::move(tex));
-  const TextureId id = static_cast<TextureId>(ctx.dst.textures.size() - 1);
-  ctx.textureMap[textureKey] = id;
-  return id;
+std::optional<std::vector<uint8_t>> ReadFileBytes(const std::filesystem::path& path) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    return std::nullopt;
+  }
+  const std::streamsize size = file.tellg();
+  if (size <= 0) {
+    return std::nullopt;
+  }
+  std::vector<uint8_t> bytes(static_cast<size_t>(size));
+  file.seekg(0);
+  if (!file.read(reinterpret_cast<char*>(bytes.data()), size)) {
+    return std::nullopt;
+  }
+  return bytes;
 }
 
 std::optional<TextureId> TryLoadEmbeddedTexture(ImportContext& ctx,
@@ -356,37 +387,18 @@ std::optional<TextureId> TryLoadEmbeddedTexture(ImportContext& ctx,
 
   if (embedded->mHeight == 0) {
     const uint8_t* bytes = reinterpret_cast<const uint8_t*>(embedded->pcData);
-    const auto decoded = LoadImageRgba8FromMemory(bytes, static_cast<size_t>(embedded->mWidth));
-    if (!decoded.has_value()) {
-      return std::nullopt;
-    }
-    return AppendDecodedTexture(ctx, cacheKey, textureKey, *decoded, srgb);
+    return AppendSourceTexture(ctx, cacheKey, textureKey, bytes, static_cast<size_t>(embedded->mWidth), srgb, {}, 0, 0);
   }
 
   if (embedded->mWidth == 0 || embedded->mHeight == 0) {
     return std::nullopt;
   }
 
-  Texture tex;
-  tex.uri = textureKey;
-  tex.width = embedded->mWidth;
-  tex.height = embedded->mHeight;
-  tex.srgb = srgb;
-  tex.format = srgb ? PixelFormat::kR8G8B8A8_SRGB : PixelFormat::kR8G8B8A8;
-  const size_t pixelCount = static_cast<size_t>(tex.width) * static_cast<size_t>(tex.height);
-  tex.pixels.resize(pixelCount * 4);
-  for (size_t i = 0; i < pixelCount; ++i) {
-    const aiTexel& src = embedded->pcData[i];
-    tex.pixels[i * 4 + 0] = src.r;
-    tex.pixels[i * 4 + 1] = src.g;
-    tex.pixels[i * 4 + 2] = src.b;
-    tex.pixels[i * 4 + 3] = src.a;
-  }
-
-  ctx.dst.textures.push_back(std::move(tex));
-  const TextureId id = static_cast<TextureId>(ctx.dst.textures.size() - 1);
-  ctx.textureMap[cacheKey] = id;
-  return id;
+  static_assert(sizeof(aiTexel) == 4, "aiTexel is expected to be packed BGRA8");
+  const size_t pixelCount = static_cast<size_t>(embedded->mWidth) * static_cast<size_t>(embedded->mHeight);
+  const auto* texels = reinterpret_cast<const uint8_t*>(embedded->pcData);
+  return AppendSourceTexture(
+      ctx, cacheKey, textureKey, texels, pixelCount * sizeof(aiTexel), srgb, {}, embedded->mWidth, embedded->mHeight);
 }
 
 TextureId GetOrCreateTexture(ImportContext& ctx, const std::string& uri, bool srgb, TextureId fallback) {
@@ -405,23 +417,45 @@ TextureId GetOrCreateTexture(ImportContext& ctx, const std::string& uri, bool sr
     return found->second;
   }
 
-  if (const auto embeddedId = TryLoadEmbeddedTexture(ctx, normalizedUri, cacheKey, srgb); embeddedId.has_value()) {
-    return *embeddedId;
+  {
+    ScopedImportStage stage(ctx.src->mNumTextures > 0 ? ctx.report : nullptr, "texture_decode", "materials");
+    if (const auto embeddedId = TryLoadEmbeddedTexture(ctx, normalizedUri, cacheKey, srgb); embeddedId.has_value()) {
+      stage.AddItems(1);
+      return *embeddedId;
+    }
   }
 
-  const auto texturePath = ResolveTexturePath(ctx, normalizedUri);
+  std::optional<std::filesystem::path> texturePath;
+  {
+    ScopedImportStage stage(ctx.report, "texture_resolve", "materials");
+    texturePath = ResolveTexturePath(ctx.sourceDir, normalizedUri);
+    stage.AddItems(texturePath.has_value() ? 1 : 0);
+  }
   if (!texturePath.has_value()) {
     ctx.textureMap[cacheKey] = fallback;
     return fallback;
   }
 
-  const auto decoded = LoadImageRgba8(texturePath->string());
-  if (!decoded.has_value()) {
+  std::optional<std::vector<uint8_t>> bytes;
+  {
+    ScopedImportStage stage(ctx.report, "texture_read", "materials");
+    bytes = ReadFileBytes(*texturePath);
+    stage.AddItems(bytes.has_value() ? bytes->size() : 0);  // bytes read
+  }
+  if (!bytes.has_value()) {
     ctx.textureMap[cacheKey] = fallback;
     return fallback;
   }
 
-  return AppendDecodedTexture(ctx, cacheKey, texturePath->string(), *decoded, srgb);
+  const std::string pathString = texturePath->string();
+  ScopedImportStage decodeStage(ctx.report, "texture_decode", "materials");
+  const auto id = AppendSourceTexture(ctx, cacheKey, pathString, bytes->data(), bytes->size(), srgb, pathString, 0, 0);
+  decodeStage.AddItems(id.has_value() ? 1 : 0);
+  if (!id.has_value()) {
+    ctx.textureMap[cacheKey] = fallback;
+    return fallback;
+  }
+  return *id;
 }
 
 std::string GetFirstTexturePath(const aiMaterial* mat, std::initializer_list<aiTextureType> types) {
@@ -472,17 +506,7 @@ NodeId BuildNodesRecursive(ImportContext& ctx, const aiNode* srcNode, NodeId par
 
 void ImportMaterials(ImportContext& ctx) {
   if (ctx.src->mNumMaterials == 0) {
-    Material fallback;
-    fallback.name = "DefaultMaterial";
-    fallback.baseColorTex = kDefaultWhiteSrgb;
-    fallback.metallicRoughnessTex = kDefaultWhiteLinear;
-    fallback.metallicTex = kDefaultBlackLinear;
-    fallback.roughnessTex = kDefaultWhiteLinear;
-    fallback.normalTex = kDefaultNormal;
-    fallback.occlusionTex = kDefaultWhiteLinear;
-    fallback.emissiveTex = kDefaultBlackLinear;
-    fallback.specularTex = kDefaultSpecular;
-    ctx.dst.materials.push_back(std::move(fallback));
+    ctx.dst.materials.push_back(MakeDefaultMaterial("DefaultMaterial"));
     return;
   }
 
@@ -623,28 +647,76 @@ void ImportMaterials(ImportContext& ctx) {
   }
 }
 
-void FinalizeWorldTransforms(Scene& scene) {
-  std::function<void(NodeId, const Mat4&)> recurse = [&](NodeId nodeId, const Mat4& parentWorld) {
-    Node& node = scene.nodes[nodeId];
-    node.worldCurrent = parentWorld * node.localCurrent.ToMat4();
-    for (const NodeId child : node.children) {
-      recurse(child, node.worldCurrent);
+// Finite and not zero length; authored tangent frames failing this are regenerated.
+bool UsableVectors(const aiVector3D* vectors, unsigned count) {
+  for (unsigned i = 0; i < count; ++i) {
+    const aiVector3D& v = vectors[i];
+    const float lengthSq = v.x * v.x + v.y * v.y + v.z * v.z;
+    if (!std::isfinite(lengthSq) || lengthSq < 1e-12F) {
+      return false;
     }
-  };
+  }
+  return true;
+}
 
-  for (const NodeId root : scene.roots) {
-    recurse(root, Mat4(1.0F));
+// Assimp keeps target attributes as absolute values in source space; the engine keeps deltas
+// against the converted base attributes. `normals` is empty when the base has no usable normals.
+void ImportMorphTargets(const aiMesh& srcMesh,
+                        const SceneConversion& conv,
+                        const glm::mat3& normalXform,
+                        const Vec3Soa& positions,
+                        const Vec3Soa& normals,
+                        Mesh& dstMesh) {
+  Vec3Soa sourceVectors;
+  Vec3Soa converted;
+  std::vector<Vec3> positionDeltas;
+  std::vector<Vec3> normalDeltas;
+  for (unsigned a = 0; a < srcMesh.mNumAnimMeshes; ++a) {
+    const aiAnimMesh* animMesh = srcMesh.mAnimMeshes[a];
+    const unsigned count = srcMesh.mNumVertices;
+    positionDeltas.assign(count, Vec3(0.0F));
+    normalDeltas.clear();
+    if (animMesh->mVertices != nullptr && animMesh->mNumVertices == count) {
+      GatherVectors(animMesh->mVertices, count, sourceVectors);
+      TransformPoints(conv.c, sourceVectors, converted);
+      for (unsigned v = 0; v < count; ++v) {
+        positionDeltas[v] = converted.Get(v) - positions.Get(v);
+      }
+    }
+    if (animMesh->mNormals != nullptr && animMesh->mNumVertices == count && normals.Size() == count) {
+      GatherVectors(animMesh->mNormals, count, sourceVectors);
+      TransformDirections(normalXform, sourceVectors, Vec3(0.0F, 1.0F, 0.0F), converted);
+      normalDeltas.resize(count);
+      for (unsigned v = 0; v < count; ++v) {
+        normalDeltas[v] = converted.Get(v) - normals.Get(v);
+      }
+    }
+    std::string name = animMesh->mName.C_Str();
+    if (name.empty()) {
+      name = "Target_" + std::to_string(a);
+    }
+    // Every anim mesh becomes a target, even an empty one, so channel values index targets directly.
+    dstMesh.morphTargets.push_back(BuildMorphTarget(std::move(name), positionDeltas, normalDeltas));
+    dstMesh.morphWeights.push_back(animMesh->mWeight);
   }
 }
 
-void ImportMeshesAndSkeletons(ImportContext& ctx, uint32_t maxBoneInfluence) {
+void ImportMeshesAndSkeletons(ImportContext& ctx, const ImportOptions& opt) {
   Skeleton skeleton;
   skeleton.name = "FBXSkeleton";
   std::vector<SkinId> createdSkinIds;
   createdSkinIds.reserve(ctx.src->mNumMeshes);
 
   const glm::mat3 normalXform = glm::transpose(glm::inverse(glm::mat3(ctx.conv.c)));
-
+  Vec3Soa sourceVectors;
+  Vec3Soa positions;
+  Vec3Soa normals;
+  Vec3Soa tangents;
+  Vec3Soa bitangents;
+
+  std::optional<ScopedImportStage> meshStage;
+  meshStage.emplace(ctx.report, "meshes");
+  meshStage->AddItems(ctx.src->mNumMeshes);
   for (unsigned meshIndex = 0; meshIndex < ctx.src->mNumMeshes; ++meshIndex) {
     const aiMesh* srcMesh = ctx.src->mMeshes[meshIndex];
 
@@ -654,16 +726,34 @@ void ImportMeshesAndSkeletons(ImportContext& ctx, uint32_t maxBoneInfluence) {
 
     std::vector<std::vector<std::pair<uint32_t, float>>> influences(srcMesh->mNumVertices);
 
+    // Authored frames are kept; anything missing or broken is generated natively below.
+    const bool authoredNormals = srcMesh->HasNormals() && UsableVectors(srcMesh->mNormals, srcMesh->mNumVertices);
+    const bool authoredTangents = authoredNormals && srcMesh->HasTangentsAndBitangents() &&
+                                  UsableVectors(srcMesh->mTangents, srcMesh->mNumVertices) &&
+                                  UsableVectors(srcMesh->mBitangents, srcMesh->mNumVertices);
+    // Basis changes run batched over each attribute stream; the loop below only interleaves.
+    GatherVectors(srcMesh->mVertices, srcMesh->mNumVertices, sourceVectors);
+    TransformPoints(ctx.conv.c, sourceVectors, positions);
+    if (authoredNormals) {
+      GatherVectors(srcMesh->mNormals, srcMesh->mNumVertices, sourceVectors);
+      TransformDirections(normalXform, sourceVectors, Vec3(0.0F, 1.0F, 0.0F), normals);
+    }
+    if (authoredTangents) {
+      GatherVectors(srcMesh->mTangents, srcMesh->mNumVertices, sourceVectors);
+      TransformDirections(normalXform, sourceVectors, Vec3(1.0F, 0.0F, 0.0F), tangents);
+      GatherVectors(srcMesh->mBitangents, srcMesh->mNumVertices, sourceVectors);
+      TransformDirections(normalXform, sourceVectors, Vec3(0.0F, 0.0F, 1.0F), bitangents);
+    }
     for (unsigned v = 0; v < srcMesh->mNumVertices; ++v) {
       VertexSkinned vvtx;
-      vvtx.position = ConvertPosition(ctx.conv, ToVec3(srcMesh->mVertices[v]));
+      vvtx.position = positions.Get(v);
 
-      if (srcMesh->HasNormals()) {
-        vvtx.normal = NormalizeSafe(normalXform * ToVec3(srcMesh->mNormals[v]));
+      if (authoredNormals) {
+        vvtx.normal = normals.Get(v);
       }
-      if (srcMesh->HasTangentsAndBitangents()) {
-        const Vec3 t = NormalizeSafe(normalXform * ToVec3(srcMesh->mTangents[v]), Vec3(1.0F, 0.0F, 0.0F));
-        const Vec3 b = NormalizeSafe(normalXform * ToVec3(srcMesh->mBitangents[v]), Vec3(0.0F, 0.0F, 1.0F));
+      if (authoredTangents) {
+        const Vec3 t = tangents.Get(v);
+        const Vec3 b = bitangents.Get(v);
         const Vec3 n = NormalizeSafe(vvtx.normal, Vec3(0.0F, 1.0F, 0.0F));
         const float handedness = glm::dot(glm::cross(n, t), b) < 0.0F ? -1.0F : 1.0F;
         vvtx.tangent = Vec4(t, handedness);
@@ -737,22 +827,46 @@ void ImportMeshesAndSkeletons(ImportContext& ctx, uint32_t maxBoneInfluence) {
         continue;
       }
 
-      if (inf.size() > maxBoneInfluence) {
-        inf.resize(maxBoneInfluence);
+      if (inf.size() > opt.maxBoneInfluence) {
+        inf.resize(opt.maxBoneInfluence);
       }
       const PackedInfluence4 packed = NormalizeInfluences4(inf);
       dstMesh.vertices[v].joints = packed.joints;
       dstMesh.vertices[v].weights = packed.weights;
     }
 
+    if (srcMesh->mNumAnimMeshes > 0) {
+      if (!authoredNormals) {
+        normals.Resize(0);
+      }
+      ImportMorphTargets(*srcMesh, ctx.conv, normalXform, positions, normals, dstMesh);
+    }
+
+    // Everything below works on dstMesh alone; a bounded import drops the Assimp mesh before the
+    // weld, tangent and LOD passes allocate their own buffers.
+    const uint32_t materialIndex = srcMesh->mMaterialIndex;
+    const bool skinned = srcMesh->mNumBones > 0;
+    // Joints become local to this mesh's skin before anything derives data from them (clusters,
+    // packed streams), so its palette holds only the bones it uses.
+    std::vector<uint32_t> skinJoints;
+    if (skinned) {
+      skinJoints = CompactJoints(dstMesh.vertices);
+    }
+    if (ctx.owned != nullptr) {
+      delete ctx.owned->mMeshes[meshIndex];
+      ctx.owned->mMeshes[meshIndex] = nullptr;
+      srcMesh = nullptr;
+    }
+
     Submesh submesh;
     submesh.firstIndex = 0;
     submesh.indexCount = static_cast<uint32_t>(dstMesh.indices.size());
     if (ctx.src->mNumMaterials > 0) {
-      submesh.material = std::min(static_cast<MaterialId>(srcMesh->mMaterialIndex),
+      submesh.material = std::min(static_cast<MaterialId>(materialIndex),
                                   static_cast<MaterialId>(ctx.dst.materials.size() - 1));
     }
     dstMesh.submeshes.push_back(submesh);
+    FinishImportedMesh(dstMesh, opt, authoredNormals, authoredTangents, ctx.report);
 
     const MeshId dstMeshId = static_cast<MeshId>(ctx.dst.meshes.size());
     ctx.dst.meshes.push_back(std::move(dstMesh));
@@ -780,9 +894,10 @@ void ImportMeshesAndSkeletons(ImportContext& ctx, uint32_t maxBoneInfluence) {
       }
     }
 
-    if (srcMesh->mNumBones > 0) {
+    if (skinned) {
       Skin skin;
       skin.mesh = dstMeshId;
+      skin.joints = std::move(skinJoints);
       const SkinId skinId = static_cast<SkinId>(ctx.dst.skins.size());
       ctx.dst.skins.push_back(std::move(skin));
       createdSkinIds.push_back(skinId);
@@ -792,6 +907,9 @@ void ImportMeshesAndSkeletons(ImportContext& ctx, uint32_t maxBoneInfluence) {
     }
   }
 
+  meshStage.reset();
+  ScopedImportStage skeletonStage(ctx.report, "skeleton");
+  skeletonStage.AddItems(skeleton.bones.size());
   if (!skeleton.bones.empty()) {
     for (size_t i = 0; i < skeleton.bones.size(); ++i) {
       const NodeId nodeId = skeleton.bones[i].node;
@@ -820,19 +938,65 @@ void ImportMeshesAndSkeletons(ImportContext& ctx, uint32_t maxBoneInfluence) {
 
     const SkeletonId skeletonId = static_cast<SkeletonId>(ctx.dst.skeletons.size());
     ctx.dst.skeletons.push_back(std::move(skeleton));
-    const size_t paletteSize = ctx.dst.skeletons[skeletonId].bones.size();
     for (const SkinId skinId : createdSkinIds) {
       if (skinId >= ctx.dst.skins.size()) {
         continue;
       }
       Skin& skin = ctx.dst.skins[skinId];
       skin.skeleton = skeletonId;
-      skin.palette.resize(paletteSize, Mat4(1.0F));
+      skin.palette.resize(skin.joints.size(), Mat4(1.0F));
     }
   }
 }
 
+// The nodes drawing the meshes a morph channel drives: the named node and the extra nodes that
+// carry its further meshes, when they have targets. Assimp may suffix the name with "*<mesh>".
+std::vector<NodeId> MorphChannelNodes(const ImportContext& ctx, std::string name) {
+  name = name.substr(0, name.find('*'));
+  std::vector<NodeId> out;
+  const auto nodeIt = ctx.nodeByName.find(name);
+  if (nodeIt == ctx.nodeByName.end()) {
+    return out;
+  }
+  const auto hasTargets = [&](NodeId id) {
+    const std::optional<MeshId>& mesh = ctx.dst.nodes[id].mesh;
+    return mesh.has_value() && *mesh < ctx.dst.meshes.size() && !ctx.dst.meshes[*mesh]->morphTargets.empty();
+  };
+  if (hasTargets(nodeIt->second)) {
+    out.push_back(nodeIt->second);
+  }
+  const std::string extraPrefix = name + "_mesh_";
+  for (const NodeId child : ctx.dst.nodes[nodeIt->second].children) {
+    if (ctx.dst.nodes[child].name.starts_with(extraPrefix) && hasTargets(child)) {
+      out.push_back(child);
+    }
+  }
+  return out;
+}
+
+void ImportMorphChannel(const ImportContext& ctx, const aiMeshMorphAnim& channel, float ticksPerSec, AnimationClip& clip) {
+  for (const NodeId node : MorphChannelNodes(ctx, channel.mName.C_Str())) {
+    MorphWeightTrack track;
+    track.node = node;
+    track.targets = static_cast<uint32_t>(ctx.dst.meshes[*ctx.dst.nodes[node].mesh]->morphTargets.size());
+    track.times.reserve(channel.mNumKeys);
+    track.weights.assign(static_cast<size_t>(channel.mNumKeys) * track.targets, 0.0F);
+    for (unsigned k = 0; k < channel.mNumKeys; ++k) {
+      const aiMeshMorphKey& key = channel.mKeys[k];
+      track.times.push_back(static_cast<float>(key.mTime / ticksPerSec));
+      for (unsigned i = 0; i < key.mNumValuesAndWeights; ++i) {
+        if (key.mValues[i] < track.targets) {
+          track.weights[k * track.targets + key.mValues[i]] = static_cast<float>(key.mWeights[i]);
+        }
+      }
+    }
+    clip.morphTracks.push_back(std::move(track));
+  }
+}
+
 void ImportAnimations(ImportContext& ctx) {
+  Vec3Soa positions;
+  QuatSoa rotations;
   for (unsigned i = 0; i < ctx.src->mNumAnimations; ++i) {
     const aiAnimation* srcAnim = ctx.src->mAnimations[i];
 
@@ -856,19 +1020,36 @@ void ImportAnimations(ImportContext& ctx) {
       NodeTrack track;
       track.node = nodeIt->second;
 
+      positions.Resize(channel->mNumPositionKeys);
+      for (unsigned k = 0; k < channel->mNumPositionKeys; ++k) {
+        const aiVector3D& value = channel->mPositionKeys[k].mValue;
+        positions.x[k] = value.x;
+        positions.y[k] = value.y;
+        positions.z[k] = value.z;
+      }
+      TransformPoints(ctx.conv.c, positions, positions);
       track.posKeys.reserve(channel->mNumPositionKeys);
       for (unsigned k = 0; k < channel->mNumPositionKeys; ++k) {
         KeyVec3 key;
         key.time = static_cast<float>(channel->mPositionKeys[k].mTime / ticksPerSec);
-        key.value = ConvertPosition(ctx.conv, ToVec3(channel->mPositionKeys[k].mValue));
+        key.value = positions.Get(k);
         track.posKeys.push_back(key);
       }
 
+      rotations.Resize(channel->mNumRotationKeys);
+      for (unsigned k = 0; k < channel->mNumRotationKeys; ++k) {
+        const aiQuaternion& value = channel->mRotationKeys[k].mValue;
+        rotations.x[k] = value.x;
+        rotations.y[k] = value.y;
+        rotations.z[k] = value.z;
+        rotations.w[k] = value.w;
+      }
+      ConvertRotations(ctx.conv.rotation, rotations, rotations);
       track.rotKeys.reserve(channel->mNumRotationKeys);
       for (unsigned k = 0; k < channel->mNumRotationKeys; ++k) {
         KeyQuat key;
         key.time = static_cast<float>(channel->mRotationKeys[k].mTime / ticksPerSec);
-        key.value = ConvertRotation(ctx.conv, ToQuat(channel->mRotationKeys[k].mValue));
+        key.value = rotations.Get(k);
         track.rotKeys.push_back(key);
       }
 
@@ -882,8 +1063,15 @@ void ImportAnimations(ImportContext& ctx) {
 
       clip.tracks.push_back(std::move(track));
     }
+    for (unsigned c = 0; c < srcAnim->mNumMorphMeshChannels; ++c) {
+      ImportMorphChannel(ctx, *srcAnim->mMorphMeshChannels[c], ticksPerSec, clip);
+    }
 
     ctx.dst.clips.push_back(std::move(clip));
+    if (ctx.owned != nullptr) {
+      delete ctx.owned->mAnimations[i];
+      ctx.owned->mAnimations[i] = nullptr;
+    }
   }
 }
 
@@ -919,44 +1107,166 @@ void ImportLights(ImportContext& ctx) {
   }
 }
 
+// Materials are converted in one pass and embedded textures are only looked up from them, so
+// both can go as soon as ImportMaterials returns.
+void ReleaseMaterialSources(ImportContext& ctx) {
+  if (ctx.owned == nullptr) {
+    return;
+  }
+  for (unsigned i = 0; i < ctx.owned->mNumMaterials; ++i) {
+    delete ctx.owned->mMaterials[i];
+    ctx.owned->mMaterials[i] = nullptr;
+  }
+  for (unsigned i = 0; i < ctx.owned->mNumTextures; ++i) {
+    delete ctx.owned->mTextures[i];
+    ctx.owned->mTextures[i] = nullptr;
+  }
+}
+
+struct PostProcessStep {
+  aiPostProcessSteps flag;
+  const char* stage;
+};
+
+// In the order Assimp's post-step registry runs them. Normals and tangents are generated natively
+// (GenerateTangentSpace) unless ImportOptions::assimpTangentSpace asks for Assimp's steps; likewise
+// vertices are welded and cache-ordered natively (WeldVertices, OptimizeVertexCache) unless
+// ImportOptions::assimpJoinVertices asks for Assimp's join and cache-locality steps.
+constexpr std::array<PostProcessStep, 7> kPostProcessSteps = {{
+    {aiProcess_FlipUVs, "pp_flip_uvs"},
+    {aiProcess_Triangulate, "pp_triangulate"},
+    {aiProcess_GenNormals, "pp_gen_normals"},
+    {aiProcess_CalcTangentSpace, "pp_calc_tangent_space"},
+    {aiProcess_JoinIdenticalVertices, "pp_join_identical_vertices"},
+    {aiProcess_LimitBoneWeights, "pp_limit_bone_weights"},
+    {aiProcess_ImproveCacheLocality, "pp_improve_cache_locality"},
+}};
+
 }  // namespace
 
-LoadResult<Scene> AssimpFbxImporter::Import(const std::string& path, const ImportOptions& opt) const {
+LoadResult<Scene> AssimpFbxImporter::Import(const std::string& path, const ImportOptions& opt, ImportReport* report) const {
+  ImportReportTotals totals(report, opt);
+
   Assimp::Importer importer;
   importer.SetPropertyBool(AI_CONFIG_IMPORT_FBX_PRESERVE_PIVOTS, false);
   importer.SetPropertyInteger(AI_CONFIG_PP_LBW_MAX_WEIGHTS, static_cast<int>(opt.maxBoneInfluence));
 
-  const uint32_t flags = aiProcess_Triangulate |
-                         aiProcess_JoinIdenticalVertices |
-                         aiProcess_ImproveCacheLocality |
-                         aiProcess_GenNormals |
-                         aiProcess_CalcTangentSpace |
-                         aiProcess_FlipUVs |
-                         aiProcess_LimitBoneWeights;
-
-  const aiScene* srcScene = importer.ReadFile(path, flags);
+  // Post-processing runs one step at a time so each gets its own timing; kPostProcessSteps keeps
+  // Assimp's internal order, so the result matches a single ReadFile with all flags.
+  const aiScene* srcScene = nullptr;
+  const bool bounded = opt.memoryBudgetBytes > 0;
+  {
+    ScopedImportStage stage(report, "read_file");
+    srcScene = importer.ReadFile(path, 0);
+  }
+  for (const PostProcessStep& step : kPostProcessSteps) {
+    if (srcScene == nullptr) {
+      break;
+    }
+    if (!opt.assimpTangentSpace && (step.flag == aiProcess_GenNormals || step.flag == aiProcess_CalcTangentSpace)) {
+      continue;
+    }
+    if (!opt.assimpJoinVertices &&
+        (step.flag == aiProcess_JoinIdenticalVertices || step.flag == aiProcess_ImproveCacheLocality)) {
+      continue;
+    }
+    ScopedImportStage stage(report, step.stage);
+    srcScene = importer.ApplyPostProcessing(step.flag);
+  }
   if (srcScene == nullptr || srcScene->mRootNode == nullptr) {
-    return LoadResult<Scene>{.value = std::nullopt, .error = importer.GetErrorString()};
+    const std::string error = importer.GetErrorString();
+    totals.Finish(path, nullptr, error);
+    return LoadResult<Scene>{.value = std::nullopt, .error = error};
+  }
+
+  // A bounded import owns the scene so it can free each part once converted; the importer would
+  // otherwise keep all of it alive until it goes out of scope.
+  std::unique_ptr<aiScene> ownedScene(bounded ? importer.GetOrphanedScene() : nullptr);
+  if (ownedScene != nullptr) {
+    srcScene = ownedScene.get();
   }
 
   ImportContext ctx;
   ctx.src = srcScene;
+  ctx.owned = ownedScene.get();
   ctx.conv = BuildConversion(srcScene, opt);
   ctx.sourceDir = std::filesystem::absolute(std::filesystem::path(path)).parent_path();
+  ctx.shareDecodedTextures = opt.shareDecodedTextures;
+  ctx.cacheDecodedImages = opt.shareDecodedTextures && opt.compressTextures;
+  ctx.reserveMipChains = opt.generateMips;
+  ctx.lazyTextures = bounded || (opt.lazyTextureDecode && !opt.compressTextures);
+  if (bounded) {
+    ctx.spillDir = TextureSpillDirectory(opt);
+  }
+  ctx.report = report;
+  if (!opt.assetRoot.empty()) {
+    ScopedImportStage stage(report, "asset_index");
+    AssetDirectoryIndex::Global().AddRoot(opt.assetRoot);
+  }
 
-  AddDefaultTexture(ctx, "__default_white__");
-  AddDefaultTexture(ctx, "__default_black__");
-  AddDefaultTexture(ctx, "__default_normal__");
-  AddDefaultTexture(ctx, "__default_specular__");
-  AddDefaultTexture(ctx, "__default_linear_white__");
+  AddDefaultTextures(ctx.dst);
 
-  BuildNodesRecursive(ctx, srcScene->mRootNode, kInvalidNodeId);
-  ImportMaterials(ctx);
-  ImportMeshesAndSkeletons(ctx, opt.maxBoneInfluence);
-  ImportAnimations(ctx);
-  ImportLights(ctx);
-  FinalizeWorldTransforms(ctx.dst);
+  {
+    ScopedImportStage stage(report, "nodes");
+    BuildNodesRecursive(ctx, srcScene->mRootNode, kInvalidNodeId);
+    stage.AddItems(ctx.dst.nodes.size());
+  }
+  {
+    ScopedImportStage stage(report, "materials");
+    ImportMaterials(ctx);
+    MarkNormalMaps(ctx.dst);
+    ReleaseMaterialSources(ctx);
+    stage.AddItems(ctx.dst.materials.size());
+  }
+  if (opt.packMaterialTextures) {
+    ScopedImportStage stage(report, "texture_pack");
+    const ImportPackStats packed = PackMaterialTextures(ctx.dst);
+    if (report != nullptr) {
+      report->packed = packed;
+    }
+    stage.AddItems(packed.materials);
+  }
+  if (opt.generateMips) {
+    ScopedImportStage stage(report, "texture_mips");
+    BuildTextureMips(ctx.dst);
+    stage.AddItems(ctx.dst.textures.size());
+  }
+  if (opt.compressTextures) {
+    ScopedImportStage stage(report, "texture_compress");
+    CompressTextures(ctx.dst, opt.textureCompression);
+    stage.AddItems(ctx.dst.textures.size());
+  }
+  if (opt.shareDecodedTextures) {
+    TextureRegistry::Global().Publish(ctx.dst.textures);
+  }
+  ImportMeshesAndSkeletons(ctx, opt);
+  {
+    ScopedImportStage stage(report, "animations");
+    ImportAnimations(ctx);
+    stage.AddItems(ctx.dst.clips.size());
+  }
+  {
+    ScopedImportStage stage(report, "lights");
+    ImportLights(ctx);
+    stage.AddItems(ctx.dst.lights.size());
+  }
+  ownedScene.reset();
+  ctx.src = nullptr;
+  ctx.owned = nullptr;
+  if (opt.pruneScene) {
+    ScopedImportStage stage(report, "prune");
+    const ImportPruneStats pruned = PruneScene(ctx.dst);
+    if (report != nullptr) {
+      report->pruned = pruned;
+    }
+    stage.AddItems(pruned.bones + pruned.nodes + pruned.tracks);
+  }
+  {
+    ScopedImportStage stage(report, "world_transforms");
+    FinalizeWorldTransforms(ctx.dst);
+  }
 
+  totals.Finish(path, &ctx.dst, {});
   return LoadResult<Scene>{.value = std::move(ctx.dst), .error = {}};
 }
 
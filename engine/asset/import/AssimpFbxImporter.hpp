@@ -2,24 +2,17 @@
 
 #include <string>
 
+#include "asset/import/ImportOptions.hpp"
+#include "asset/import/ImportReport.hpp"
 #include "core/types/CommonTypes.hpp"
 #include "render/scene/SceneTypes.hpp"
 
 namespace vv {
 
-struct ImportOptions {
-  bool convertToMeters = true;
-  bool forceRightHanded = true;
-  uint32_t maxBoneInfluence = 4;
-};
-
-struct ImportError {
-  std::string message;
-};
-
 class AssimpFbxImporter {
  public:
-  LoadResult<Scene> Import(const std::string& path, const ImportOptions& opt) const;
+  // `report`, when given, receives per-stage timings, heap deltas and counts (see ImportReport).
+  LoadResult<Scene> Import(const std::string& path, const ImportOptions& opt, ImportReport* report = nullptr) const;
 };
 
 }  // namespace vv
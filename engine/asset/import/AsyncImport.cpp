@@ -0,0 +1,308 @@
+#include "asset/import/AsyncImport.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include "asset/import/SceneImporter.hpp"
+#include "asset/registry/AssetRegistry.hpp"
+#include "asset/texture/BlockCompression.hpp"
+#include "asset/texture/Ktx2.hpp"
+#include "asset/texture/MipGenerator.hpp"
+#include "asset/texture/TextureRegistry.hpp"
+#include "core/thread/ParallelFor.hpp"
+
+namespace vv {
+namespace {
+
+// Lazy textures in the order they should appear: what a material shows as its color first, then
+// normal maps, then masks and everything else.
+std::vector<TextureId> StreamOrder(const Scene& scene) {
+  std::vector<uint8_t> rank(scene.textures.size(), 2);
+  for (const Material& material : scene.materials) {
+    if (material.normalTex < rank.size()) {
+      rank[material.normalTex] = std::min<uint8_t>(rank[material.normalTex], 1);
+    }
+    if (material.baseColorTex < rank.size()) {
+      rank[material.baseColorTex] = 0;
+    }
+  }
+  std::vector<TextureId> order;
+  for (TextureId id = 0; id < scene.textures.size(); ++id) {
+    if (HasLazySource(scene.textures[id])) {
+      order.push_back(id);
+    }
+  }
+  std::stable_sort(order.begin(), order.end(), [&](TextureId a, TextureId b) { return rank[a] < rank[b]; });
+  return order;
+}
+
+// Decodes through the registry like a lazy upload would (when decodes are shared), then builds
+// what a synchronous import stores: mip chain and BC blocks as the options ask. The source is kept
+// so the texture can be cooked or decoded again. On failure `out` has neither pixels nor source, which the renderer
+// replaces with white, as it does for a lazy texture that fails at upload.
+bool DecodeStreamedTexture(const Texture& lazy, const ImportOptions& opt, Texture& out) {
+  out = Texture{};
+  out.uri = lazy.uri;
+  out.width = lazy.width;
+  out.height = lazy.height;
+  out.format = lazy.format;
+  out.srgb = lazy.srgb;
+  out.normalMap = lazy.normalMap;
+  out.contentHash = lazy.contentHash;
+
+  if (IsKtx2Source(lazy.source)) {
+    // Already mipped and in its GPU format: the levels are copied out of the file as they are.
+    Ktx2Source source;
+    if (!source.Open(lazy.source) || source.Info().width != lazy.width || source.Info().height != lazy.height ||
+        source.Info().levels.size() != lazy.mipLevels) {
+      return false;
+    }
+    out.mipLevels = lazy.mipLevels;
+    out.pixels = PixelBuffer(Ktx2ChainBytes(source.Info()));
+    if (!source.ReadLevels(out.pixels.data())) {
+      out.pixels.clear();
+      return false;
+    }
+    out.source = lazy.source;
+    return true;
+  }
+
+  if (opt.shareDecodedTextures) {
+    const std::shared_ptr<const ImageRgba8> image = TextureRegistry::Global().AcquirePixels(lazy);
+    if (image == nullptr || image->width != lazy.width || image->height != lazy.height) {
+      return false;
+    }
+    const size_t chainBytes =
+        opt.generateMips ? MipLevelOffset(lazy.width, lazy.height, FullMipLevelCount(lazy.width, lazy.height)) : 0;
+    out.pixels = PixelBuffer::Copy(image->pixels.data(), image->pixels.size(), chainBytes);
+  } else {
+    // Not shared: the decode goes straight into the texture instead of leaving a cached copy of
+    // level 0 behind in the registry.
+    std::optional<ImageRgba8> image = DecodeTextureSource(lazy.source);
+    if (!image.has_value() || image->width != lazy.width || image->height != lazy.height) {
+      return false;
+    }
+    out.pixels = std::move(image->pixels);
+  }
+  out.source = lazy.source;
+  if (opt.generateMips) {
+    GenerateMipChain(out);
+  }
+  if (opt.compressTextures) {
+    CompressTexture(out, opt.textureCompression);
+  }
+  return true;
+}
+
+}  // namespace
+
+std::unique_ptr<AsyncImport> AsyncImport::Start(const std::string& path,
+                                                const ImportOptions& opt,
+                                                ProgressCallback onProgress) {
+  std::unique_ptr<AsyncImport> import(new AsyncImport(path, opt, std::move(onProgress)));
+  import->worker_ = std::thread([raw = import.get()] { raw->Run(); });
+  return import;
+}
+
+AsyncImport::AsyncImport(std::string path, const ImportOptions& opt, ProgressCallback onProgress)
+    : path_(std::move(path)), options_(opt), onProgress_(std::move(onProgress)) {}
+
+AsyncImport::~AsyncImport() {
+  Cancel();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+AsyncImportProgress AsyncImport::Progress() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return progress_;
+}
+
+bool AsyncImport::SceneReady() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return scene_.has_value();
+}
+
+bool AsyncImport::Done() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return progress_.phase == AsyncImportPhase::kDone || progress_.phase == AsyncImportPhase::kFailed;
+}
+
+LoadResult<Scene> AsyncImport::TakeScene() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  changed_.wait(lock, [&] { return scene_.has_value(); });
+  if (sceneTaken_) {
+    return LoadResult<Scene>{.value = std::nullopt, .error = "AsyncImport: scene already taken"};
+  }
+  sceneTaken_ = true;
+  return std::move(*scene_);
+}
+
+std::vector<TextureId> AsyncImport::ApplyTextureUpdates(Scene& scene) {
+  std::vector<TextureUpdate> updates;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    updates.swap(updates_);
+  }
+  std::vector<TextureId> ids;
+  ids.reserve(updates.size());
+  for (TextureUpdate& update : updates) {
+    if (update.id < scene.textures.size()) {
+      scene.textures[update.id] = std::move(update.texture);
+      ids.push_back(update.id);
+    }
+  }
+  return ids;
+}
+
+void AsyncImport::Wait() const {
+  std::unique_lock<std::mutex> lock(mutex_);
+  changed_.wait(lock, [&] {
+    return progress_.phase == AsyncImportPhase::kDone || progress_.phase == AsyncImportPhase::kFailed;
+  });
+}
+
+void AsyncImport::Cancel() {
+  cancel_ = true;
+}
+
+ImportReport AsyncImport::Report() const {
+  Wait();
+  std::lock_guard<std::mutex> lock(mutex_);
+  return report_;
+}
+
+void AsyncImport::NotifyProgress() {
+  if (!onProgress_) {
+    return;
+  }
+  // The snapshot is taken under the callback lock, so callbacks see counts only grow.
+  std::lock_guard<std::mutex> callbackLock(callbackMutex_);
+  onProgress_(Progress());
+}
+
+void AsyncImport::Run() {
+  // Compression would force eager decoding in the importer; it runs per texture while streaming.
+  ImportOptions importOptions = options_;
+  importOptions.lazyTextureDecode = true;
+  importOptions.compressTextures = false;
+  // Interned below, once the streamed textures are marked: a registered asset is never edited.
+  importOptions.shareAssets = false;
+
+  ImportReport report;
+  report.onStageEnd = [this](const ImportStageReport& stage) {
+    if (!stage.parent.empty()) {
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      progress_.stage = stage.name;
+    }
+    NotifyProgress();
+  };
+
+  LoadResult<Scene> loaded;
+  try {
+    loaded = ImportSceneFile(path_, importOptions, &report);
+  } catch (const std::exception& e) {
+    loaded = LoadResult<Scene>{.value = std::nullopt, .error = e.what()};
+  }
+  report.onStageEnd = nullptr;
+
+  std::vector<TextureId> order;
+  std::vector<Texture> pending;
+  if (loaded.Ok()) {
+    Scene& scene = *loaded.value;
+    order = StreamOrder(scene);
+    pending.resize(scene.textures.size());
+    for (const TextureId id : order) {
+      pending[id] = scene.textures[id];  // header and source; there are no pixels yet
+      scene.textures[id].Edit().streaming = true;
+    }
+    if (options_.shareAssets) {
+      AssetRegistry::Global().Intern(scene);
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    progress_.texturesTotal = static_cast<uint32_t>(order.size());
+    if (!loaded.Ok()) {
+      progress_.phase = AsyncImportPhase::kFailed;
+    } else if (!order.empty()) {
+      progress_.phase = AsyncImportPhase::kStreamingTextures;
+    } else {
+      progress_.phase = AsyncImportPhase::kDone;
+    }
+    scene_ = std::move(loaded);
+    if (order.empty()) {
+      report_ = std::move(report);
+    }
+  }
+  changed_.notify_all();
+  NotifyProgress();
+  if (order.empty()) {
+    return;
+  }
+
+  StreamTextures(order, pending, report);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    progress_.phase = AsyncImportPhase::kDone;
+    report_ = std::move(report);
+  }
+  changed_.notify_all();
+  NotifyProgress();
+}
+
+void AsyncImport::StreamTextures(const std::vector<TextureId>& order,
+                                 const std::vector<Texture>& pending,
+                                 ImportReport& report) {
+  ScopedImportStage stage(&report, "texture_stream");
+  const uint64_t decodedStart = TextureRegistry::Global().Stats().decodedImages;
+
+  // Workers pull the next texture in stream order rather than taking fixed ranges, so the
+  // important textures land first. One hardware thread is left for the caller's render loop.
+  const size_t workers = std::min(order.size(), std::max<size_t>(WorkerThreadCount(), 2) - 1);
+  std::atomic<size_t> next{0};
+  ParallelFor(workers, 1, [&](size_t, size_t) {
+    for (size_t i = next++; i < order.size() && !cancel_; i = next++) {
+      TextureUpdate update;
+      update.id = order[i];
+      Texture texture;
+      const bool decoded = DecodeStreamedTexture(pending[update.id], options_, texture);
+      update.texture = std::move(texture);
+      if (decoded && options_.shareAssets) {
+        // Hashed here rather than in ApplyTextureUpdates, which runs on the owner's frame.
+        update.texture = AssetRegistry::Global().Intern(update.texture);
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        updates_.push_back(std::move(update));
+        ++progress_.texturesReady;
+        progress_.texturesFailed += decoded ? 0 : 1;
+      }
+      NotifyProgress();
+    }
+  });
+
+  stage.AddItems(Progress().texturesReady);
+  report.counts.texturesDecoded += TextureRegistry::Global().Stats().decodedImages - decodedStart;
+}
+
+void ReleaseDecodedPixels(Texture& texture) {
+  if (texture.pixels.empty() || (texture.source.path.empty() && texture.source.bytes == nullptr)) {
+    return;
+  }
+  texture.pixels = PixelBuffer{};
+  if (IsKtx2Source(texture.source)) {
+    return;  // format and mip count still describe the file
+  }
+  texture.format = texture.srgb ? PixelFormat::kR8G8B8A8_SRGB : PixelFormat::kR8G8B8A8;
+  texture.mipLevels = 1;
+}
+
+}  // namespace vv
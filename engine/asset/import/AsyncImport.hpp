@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "asset/import/ImportOptions.hpp"
+#include "asset/import/ImportReport.hpp"
+#include "core/types/CommonTypes.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+enum class AsyncImportPhase {
+  kImporting,  // file read, geometry, skeletons, clips
+  kStreamingTextures,
+  kDone,
+  kFailed,
+};
+
+struct AsyncImportProgress {
+  AsyncImportPhase phase = AsyncImportPhase::kImporting;
+  std::string stage;            // last import stage that finished
+  uint32_t texturesTotal = 0;   // textures streamed after the scene is published
+  uint32_t texturesReady = 0;   // decoded and queued, failures included
+  uint32_t texturesFailed = 0;  // could not be decoded; left to the renderer's fallback
+};
+
+// Imports on a background thread and publishes the scene as soon as geometry, skeletons and clips
+// exist. Textures are not decoded by then: they are marked `Texture::streaming`, so materials draw
+// with the default textures, and decode afterwards (base color first, then normals, then the rest)
+// on worker threads into a queue the owner drains with ApplyTextureUpdates. Streamed textures come
+// out the way a synchronous import builds them (mips, BC compression).
+class AsyncImport {
+ public:
+  // Called on worker threads as stages finish and textures arrive; calls never overlap.
+  using ProgressCallback = std::function<void(const AsyncImportProgress&)>;
+
+  static std::unique_ptr<AsyncImport> Start(const std::string& path,
+                                            const ImportOptions& opt,
+                                            ProgressCallback onProgress = {});
+
+  // Stops decoding textures not started yet and joins; an Assimp read in progress runs to its end.
+  ~AsyncImport();
+  AsyncImport(const AsyncImport&) = delete;
+  AsyncImport& operator=(const AsyncImport&) = delete;
+
+  AsyncImportProgress Progress() const;
+  bool SceneReady() const;  // published or failed: TakeScene will not block
+  bool Done() const;        // every texture decoded (updates may still be queued), cancelled or failed
+
+  // Blocks until the scene is published and moves it out; only the first call gets the scene.
+  LoadResult<Scene> TakeScene();
+
+  // Moves the textures decoded since the last call into `scene` (the one TakeScene returned) and
+  // returns their ids, for VulkanRenderer::UpdateTextures. With ImportOptions::shareAssets they come
+  // through the AssetRegistry, so they are shared with other scenes like a synchronous import's.
+  std::vector<TextureId> ApplyTextureUpdates(Scene& scene);
+
+  void Wait() const;
+  void Cancel();
+
+  // Stage timings of the import plus "texture_stream"; complete once Done().
+  ImportReport Report() const;
+
+ private:
+  struct TextureUpdate {
+    TextureId id = 0;
+    SharedAsset<Texture> texture;
+  };
+
+  AsyncImport(std::string path, const ImportOptions& opt, ProgressCallback onProgress);
+
+  void Run();
+  void StreamTextures(const std::vector<TextureId>& order, const std::vector<Texture>& pending, ImportReport& report);
+  void NotifyProgress();
+
+  std::string path_;
+  ImportOptions options_;
+  ProgressCallback onProgress_;
+  std::mutex callbackMutex_;
+
+  mutable std::mutex mutex_;
+  mutable std::condition_variable changed_;
+  AsyncImportProgress progress_;
+  std::optional<LoadResult<Scene>> scene_;
+  bool sceneTaken_ = false;
+  std::vector<TextureUpdate> updates_;
+  ImportReport report_;
+  std::atomic<bool> cancel_{false};
+
+  std::thread worker_;
+};
+
+// Drops the pixels of a texture that can be decoded again from its source, back to the lazy form
+// the importer produced; for owners that keep streamed textures only on the GPU.
+void ReleaseDecodedPixels(Texture& texture);
+
+}  // namespace vv
@@ -0,0 +1,209 @@
+#include "asset/import/ConversionKernels.hpp"
+
+#include <cmath>
+
+#include <glm/matrix.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VV_KERNELS_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define VV_KERNELS_NEON 1
+#endif
+
+namespace vv {
+namespace {
+
+// Four float lanes. Only what the kernels need: each operation maps to one instruction on SSE2
+// and NEON, and the scalar fallback rounds the same way, so every build gives identical results.
+#if defined(VV_KERNELS_SSE2)
+using F4 = __m128;
+using M4 = __m128;
+
+inline F4 Load(const float* p) { return _mm_loadu_ps(p); }
+inline void Store(float* p, F4 v) { _mm_storeu_ps(p, v); }
+inline F4 Splat(float s) { return _mm_set1_ps(s); }
+inline F4 Add(F4 a, F4 b) { return _mm_add_ps(a, b); }
+inline F4 Mul(F4 a, F4 b) { return _mm_mul_ps(a, b); }
+inline F4 Div(F4 a, F4 b) { return _mm_div_ps(a, b); }
+inline F4 Sqrt(F4 a) { return _mm_sqrt_ps(a); }
+inline M4 LessEqual(F4 a, F4 b) { return _mm_cmple_ps(a, b); }
+inline F4 Select(M4 mask, F4 whenTrue, F4 whenFalse) {
+  return _mm_or_ps(_mm_and_ps(mask, whenTrue), _mm_andnot_ps(mask, whenFalse));
+}
+#elif defined(VV_KERNELS_NEON)
+using F4 = float32x4_t;
+using M4 = uint32x4_t;
+
+inline F4 Load(const float* p) { return vld1q_f32(p); }
+inline void Store(float* p, F4 v) { vst1q_f32(p, v); }
+inline F4 Splat(float s) { return vdupq_n_f32(s); }
+inline F4 Add(F4 a, F4 b) { return vaddq_f32(a, b); }
+inline F4 Mul(F4 a, F4 b) { return vmulq_f32(a, b); }
+inline F4 Div(F4 a, F4 b) { return vdivq_f32(a, b); }
+inline F4 Sqrt(F4 a) { return vsqrtq_f32(a); }
+inline M4 LessEqual(F4 a, F4 b) { return vcleq_f32(a, b); }
+inline F4 Select(M4 mask, F4 whenTrue, F4 whenFalse) { return vbslq_f32(mask, whenTrue, whenFalse); }
+#else
+struct F4 {
+  float v[4];
+};
+struct M4 {
+  bool v[4];
+};
+
+inline F4 Load(const float* p) { return F4{{p[0], p[1], p[2], p[3]}}; }
+inline void Store(float* p, F4 a) {
+  for (int i = 0; i < 4; ++i) {
+    p[i] = a.v[i];
+  }
+}
+inline F4 Splat(float s) { return F4{{s, s, s, s}}; }
+inline F4 Add(F4 a, F4 b) { return F4{{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+inline F4 Mul(F4 a, F4 b) { return F4{{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+inline F4 Div(F4 a, F4 b) { return F4{{a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3]}}; }
+inline F4 Sqrt(F4 a) { return F4{{std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3])}}; }
+inline M4 LessEqual(F4 a, F4 b) {
+  return M4{{a.v[0] <= b.v[0], a.v[1] <= b.v[1], a.v[2] <= b.v[2], a.v[3] <= b.v[3]}};
+}
+inline F4 Select(M4 mask, F4 whenTrue, F4 whenFalse) {
+  F4 out;
+  for (int i = 0; i < 4; ++i) {
+    out.v[i] = mask.v[i] ? whenTrue.v[i] : whenFalse.v[i];
+  }
+  return out;
+}
+#endif
+
+constexpr float kMinLengthSq = 1e-12F;  // NormalizeSafe's threshold in the importer
+
+// Tails shorter than four lanes go through a zero-padded block, so they use the same code.
+template <size_t kArrays, typename Fn>
+void ForEachBlock(size_t count, const float* const (&in)[kArrays], float* const (&out)[kArrays], Fn&& fn) {
+  size_t i = 0;
+  for (; i + 4 <= count; i += 4) {
+    F4 lanes[kArrays];
+    for (size_t a = 0; a < kArrays; ++a) {
+      lanes[a] = Load(in[a] + i);
+    }
+    fn(lanes);
+    for (size_t a = 0; a < kArrays; ++a) {
+      Store(out[a] + i, lanes[a]);
+    }
+  }
+  if (i == count) {
+    return;
+  }
+  float tail[kArrays][4] = {};
+  for (size_t a = 0; a < kArrays; ++a) {
+    for (size_t j = i; j < count; ++j) {
+      tail[a][j - i] = in[a][j];
+    }
+  }
+  F4 lanes[kArrays];
+  for (size_t a = 0; a < kArrays; ++a) {
+    lanes[a] = Load(tail[a]);
+  }
+  fn(lanes);
+  for (size_t a = 0; a < kArrays; ++a) {
+    Store(tail[a], lanes[a]);
+    for (size_t j = i; j < count; ++j) {
+      out[a][j] = tail[a][j - i];
+    }
+  }
+}
+
+}  // namespace
+
+void Vec3Soa::Resize(size_t count) {
+  x.resize(count);
+  y.resize(count);
+  z.resize(count);
+}
+
+void QuatSoa::Resize(size_t count) {
+  x.resize(count);
+  y.resize(count);
+  z.resize(count);
+  w.resize(count);
+}
+
+void TransformPoints(const Mat4& m, const Vec3Soa& in, Vec3Soa& out) {
+  out.Resize(in.Size());
+  const F4 c0[3] = {Splat(m[0][0]), Splat(m[0][1]), Splat(m[0][2])};
+  const F4 c1[3] = {Splat(m[1][0]), Splat(m[1][1]), Splat(m[1][2])};
+  const F4 c2[3] = {Splat(m[2][0]), Splat(m[2][1]), Splat(m[2][2])};
+  const F4 c3[3] = {Splat(m[3][0]), Splat(m[3][1]), Splat(m[3][2])};
+  ForEachBlock<3>(in.Size(), {in.x.data(), in.y.data(), in.z.data()}, {out.x.data(), out.y.data(), out.z.data()},
+                  [&](F4 (&v)[3]) {
+                    // glm's mat4 * vec4 order: (c0 * x + c1 * y) + (c2 * z + c3 * 1).
+                    F4 r[3];
+                    for (int row = 0; row < 3; ++row) {
+                      r[row] = Add(Add(Mul(c0[row], v[0]), Mul(c1[row], v[1])), Add(Mul(c2[row], v[2]), c3[row]));
+                    }
+                    v[0] = r[0];
+                    v[1] = r[1];
+                    v[2] = r[2];
+                  });
+}
+
+void TransformDirections(const glm::mat3& m, const Vec3Soa& in, const Vec3& fallback, Vec3Soa& out) {
+  out.Resize(in.Size());
+  const F4 c0[3] = {Splat(m[0][0]), Splat(m[0][1]), Splat(m[0][2])};
+  const F4 c1[3] = {Splat(m[1][0]), Splat(m[1][1]), Splat(m[1][2])};
+  const F4 c2[3] = {Splat(m[2][0]), Splat(m[2][1]), Splat(m[2][2])};
+  const F4 fb[3] = {Splat(fallback.x), Splat(fallback.y), Splat(fallback.z)};
+  const F4 minLengthSq = Splat(kMinLengthSq);
+  const F4 one = Splat(1.0F);
+  ForEachBlock<3>(in.Size(), {in.x.data(), in.y.data(), in.z.data()}, {out.x.data(), out.y.data(), out.z.data()},
+                  [&](F4 (&v)[3]) {
+                    F4 r[3];
+                    for (int row = 0; row < 3; ++row) {
+                      r[row] = Add(Add(Mul(c0[row], v[0]), Mul(c1[row], v[1])), Mul(c2[row], v[2]));
+                    }
+                    const F4 lengthSq = Add(Add(Mul(r[0], r[0]), Mul(r[1], r[1])), Mul(r[2], r[2]));
+                    const M4 degenerate = LessEqual(lengthSq, minLengthSq);
+                    const F4 inverseLength = Div(one, Sqrt(lengthSq));
+                    for (int row = 0; row < 3; ++row) {
+                      v[row] = Select(degenerate, fb[row], Mul(r[row], inverseLength));
+                    }
+                  });
+}
+
+RotationBasisChange MakeRotationBasisChange(const glm::mat3& r) {
+  RotationBasisChange change;
+  const float sign = glm::determinant(r) < 0.0F ? -1.0F : 1.0F;
+  for (int c = 0; c < 3; ++c) {
+    change.vectorPart[c] = r[c] * sign;
+  }
+  return change;
+}
+
+void ConvertRotations(const RotationBasisChange& change, const QuatSoa& in, QuatSoa& out) {
+  out.Resize(in.Size());
+  const glm::mat3& m = change.vectorPart;
+  const F4 c0[3] = {Splat(m[0][0]), Splat(m[0][1]), Splat(m[0][2])};
+  const F4 c1[3] = {Splat(m[1][0]), Splat(m[1][1]), Splat(m[1][2])};
+  const F4 c2[3] = {Splat(m[2][0]), Splat(m[2][1]), Splat(m[2][2])};
+  const F4 zero = Splat(0.0F);
+  const F4 one = Splat(1.0F);
+  ForEachBlock<4>(in.Size(),
+                  {in.x.data(), in.y.data(), in.z.data(), in.w.data()},
+                  {out.x.data(), out.y.data(), out.z.data(), out.w.data()},
+                  [&](F4 (&q)[4]) {
+                    F4 v[3];
+                    for (int row = 0; row < 3; ++row) {
+                      v[row] = Add(Add(Mul(c0[row], q[0]), Mul(c1[row], q[1])), Mul(c2[row], q[2]));
+                    }
+                    const F4 lengthSq = Add(Add(Mul(v[0], v[0]), Mul(v[1], v[1])), Add(Mul(v[2], v[2]), Mul(q[3], q[3])));
+                    const M4 degenerate = LessEqual(lengthSq, zero);
+                    const F4 inverseLength = Div(one, Sqrt(lengthSq));
+                    for (int row = 0; row < 3; ++row) {
+                      q[row] = Select(degenerate, zero, Mul(v[row], inverseLength));
+                    }
+                    q[3] = Select(degenerate, one, Mul(q[3], inverseLength));
+                  });
+}
+
+}  // namespace vv
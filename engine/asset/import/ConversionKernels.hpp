@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <glm/mat3x3.hpp>
+
+#include "core/math/MathTypes.hpp"
+
+namespace vv {
+
+// Structure-of-arrays batches for the conversion kernels below; every kernel accepts `out` equal to
+// `in`. The kernels run four lanes at a time with SSE2 or NEON and in scalar code elsewhere, using
+// the same operation order as the glm expressions they replace.
+struct Vec3Soa {
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<float> z;
+
+  void Resize(size_t count);
+  [[nodiscard]] size_t Size() const { return x.size(); }
+  [[nodiscard]] Vec3 Get(size_t i) const { return Vec3(x[i], y[i], z[i]); }
+};
+
+struct QuatSoa {
+  std::vector<float> x;
+  std::vector<float> y;
+  std::vector<float> z;
+  std::vector<float> w;
+
+  void Resize(size_t count);
+  [[nodiscard]] size_t Size() const { return x.size(); }
+  [[nodiscard]] Quat Get(size_t i) const { return Quat(w[i], x[i], y[i], z[i]); }
+};
+
+// out = vec3(m * vec4(p, 1)).
+void TransformPoints(const Mat4& m, const Vec3Soa& in, Vec3Soa& out);
+
+// out = normalize(m * v), or `fallback` where m * v has (near) zero length.
+void TransformDirections(const glm::mat3& m, const Vec3Soa& in, const Vec3& fallback, Vec3Soa& out);
+
+// Re-expresses rotations in another basis: the quaternion of R * mat(q) * R^-1 for an orthogonal R,
+// reflections included, without going through matrices. Conjugating by R maps the rotation axis
+// to R * axis and keeps the angle, and a reflection also reverses the angle, so the vector part
+// becomes det(R) * R * v and w is unchanged.
+struct RotationBasisChange {
+  glm::mat3 vectorPart{1.0F};  // det(R) * R
+};
+
+RotationBasisChange MakeRotationBasisChange(const glm::mat3& r);
+
+// out = normalize(change applied to q); zero-length quaternions become identity.
+void ConvertRotations(const RotationBasisChange& change, const QuatSoa& in, QuatSoa& out);
+
+}  // namespace vv
@@ -0,0 +1,333 @@
+#include "asset/import/FbxBinary.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+#include "core/io/Inflate.hpp"
+#include "core/thread/ParallelFor.hpp"
+
+namespace vv {
+
+namespace {
+
+constexpr char kMagic[] = "Kaydara FBX Binary  ";  // followed by 0x00 0x1A 0x00 and the version
+constexpr size_t kHeaderSize = 27;
+constexpr int kMaxDepth = 64;
+constexpr uint64_t kMaxInflateRatio = 1032;  // deflate's best case; larger counts are corrupt
+
+template <typename T>
+T Load(const uint8_t* p) {
+  T value;
+  std::memcpy(&value, p, sizeof(T));
+  return value;
+}
+
+size_t ElementSize(char type) {
+  switch (type) {
+    case 'd':
+    case 'l':
+      return 8;
+    case 'f':
+    case 'i':
+      return 4;
+    case 'b':
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+// Bytes after the type code that precede any variable-length payload; 0 for unknown types.
+size_t FixedSize(char type) {
+  switch (type) {
+    case 'C':
+      return 1;
+    case 'Y':
+      return 2;
+    case 'I':
+    case 'F':
+    case 'S':
+    case 'R':
+      return 4;
+    case 'L':
+    case 'D':
+      return 8;
+    case 'f':
+    case 'd':
+    case 'i':
+    case 'l':
+    case 'b':
+      return 12;
+    default:
+      return 0;
+  }
+}
+
+class RecordReader {
+ public:
+  RecordReader(const uint8_t* data, bool wideHeaders)
+      : data_(data), wide_(wideHeaders) {}
+
+  // Records from `pos` up to the null record that closes the list (or `end` for the top level).
+  bool ReadList(size_t& pos, size_t end, int depth, std::vector<FbxNode>& out, std::string& error) {
+    if (depth > kMaxDepth) {
+      error = "FBX records nested too deeply";
+      return false;
+    }
+    const size_t headerSize = wide_ ? 25 : 13;
+    while (pos + headerSize <= end) {
+      uint64_t endOffset = 0;
+      uint64_t propCount = 0;
+      uint64_t propBytes = 0;
+      if (wide_) {
+        endOffset = Load<uint64_t>(data_ + pos);
+        propCount = Load<uint64_t>(data_ + pos + 8);
+        propBytes = Load<uint64_t>(data_ + pos + 16);
+      } else {
+        endOffset = Load<uint32_t>(data_ + pos);
+        propCount = Load<uint32_t>(data_ + pos + 4);
+        propBytes = Load<uint32_t>(data_ + pos + 8);
+      }
+      const uint8_t nameLength = data_[pos + headerSize - 1];
+      if (endOffset == 0) {
+        pos += headerSize;  // null record: end of this list
+        return true;
+      }
+      const size_t propStart = pos + headerSize + nameLength;
+      if (endOffset > end || propStart > end || propBytes > end - propStart || propStart + propBytes > endOffset ||
+          propCount > propBytes) {
+        error = "FBX record overruns its parent at byte " + std::to_string(pos);
+        return false;
+      }
+      FbxNode& node = out.emplace_back();
+      node.name = std::string_view(reinterpret_cast<const char*>(data_ + pos + headerSize), nameLength);
+      node.props.reserve(propCount);
+      size_t p = propStart;
+      const size_t propEnd = propStart + propBytes;
+      for (uint64_t i = 0; i < propCount; ++i) {
+        if (!ReadProperty(p, propEnd, node.props.emplace_back(), error)) {
+          return false;
+        }
+      }
+      if (p != propEnd) {
+        error = "FBX property list length mismatch in " + std::string(node.name);
+        return false;
+      }
+      if (p < endOffset && !ReadList(p, endOffset, depth + 1, node.children, error)) {
+        return false;
+      }
+      pos = endOffset;
+    }
+    return true;
+  }
+
+ private:
+  bool ReadProperty(size_t& p, size_t end, FbxProperty& prop, std::string& error) {
+    if (p >= end) {
+      error = "FBX property list truncated";
+      return false;
+    }
+    prop.type = static_cast<char>(data_[p++]);
+    const size_t fixed = FixedSize(prop.type);
+    if (fixed == 0) {
+      error = std::string("FBX property of unknown type '") + prop.type + "'";
+      return false;
+    }
+    if (fixed > end - p) {
+      error = "FBX property truncated";
+      return false;
+    }
+    const uint8_t* at = data_ + p;
+    p += fixed;
+    switch (prop.type) {
+      case 'Y':
+        prop.i = Load<int16_t>(at);
+        return true;
+      case 'C':
+        prop.i = at[0] != 0 ? 1 : 0;
+        return true;
+      case 'I':
+        prop.i = Load<int32_t>(at);
+        return true;
+      case 'L':
+        prop.i = Load<int64_t>(at);
+        return true;
+      case 'F':
+        prop.d = Load<float>(at);
+        return true;
+      case 'D':
+        prop.d = Load<double>(at);
+        return true;
+      default:
+        break;
+    }
+    // S/R: length + bytes; arrays: count, encoding, length + bytes.
+    const uint32_t length = Load<uint32_t>(at + fixed - 4);
+    if (length > end - p) {
+      error = "FBX property truncated";
+      return false;
+    }
+    if (prop.IsArray()) {
+      prop.count = Load<uint32_t>(at);
+      prop.encoding = Load<uint32_t>(at + 4);
+      const uint64_t rawLength = uint64_t{prop.count} * ElementSize(prop.type);
+      if (prop.encoding > 1 || (prop.encoding == 0 && length != rawLength) ||
+          (prop.encoding == 1 && rawLength > uint64_t{length} * kMaxInflateRatio)) {
+        error = "FBX array with unsupported encoding or bad length";
+        return false;
+      }
+    }
+    prop.bytes = std::string_view(reinterpret_cast<const char*>(data_ + p), length);
+    p += length;
+    return true;
+  }
+
+  const uint8_t* data_;
+  bool wide_;
+};
+
+void CollectCompressed(std::vector<FbxNode>& nodes, std::vector<FbxProperty*>& out) {
+  for (FbxNode& node : nodes) {
+    for (FbxProperty& prop : node.props) {
+      if (prop.IsArray() && prop.encoding == 1) {
+        out.push_back(&prop);
+      }
+    }
+    CollectCompressed(node.children, out);
+  }
+}
+
+template <typename Out>
+bool ConvertArray(const FbxProperty& prop, std::vector<Out>& out) {
+  if (!prop.IsArray() || prop.encoding != 0) {
+    return false;
+  }
+  out.resize(prop.count);
+  const auto* src = reinterpret_cast<const uint8_t*>(prop.bytes.data());
+  const auto convert = [&]<typename In>(In) {
+    if constexpr (std::is_same_v<In, Out>) {
+      std::memcpy(out.data(), src, prop.count * sizeof(In));
+    } else {
+      for (uint32_t i = 0; i < prop.count; ++i) {
+        out[i] = static_cast<Out>(Load<In>(src + i * sizeof(In)));
+      }
+    }
+  };
+  switch (prop.type) {
+    case 'f':
+      convert(float{});
+      return true;
+    case 'd':
+      convert(double{});
+      return true;
+    case 'i':
+      convert(int32_t{});
+      return true;
+    case 'l':
+      convert(int64_t{});
+      return true;
+    case 'b':
+      convert(uint8_t{});
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+std::string_view FbxProperty::ObjectName() const {
+  const size_t separator = bytes.find(std::string_view("\x00\x01", 2));
+  return separator == std::string_view::npos ? bytes : bytes.substr(0, separator);
+}
+
+const FbxNode* FbxNode::Child(std::string_view childName) const {
+  for (const FbxNode& child : children) {
+    if (child.name == childName) {
+      return &child;
+    }
+  }
+  return nullptr;
+}
+
+bool FbxNode::ReadArray(size_t index, std::vector<double>& out) const {
+  return index < props.size() && ConvertArray(props[index], out);
+}
+
+bool FbxNode::ReadArray(size_t index, std::vector<float>& out) const {
+  return index < props.size() && ConvertArray(props[index], out);
+}
+
+bool FbxNode::ReadArray(size_t index, std::vector<int32_t>& out) const {
+  return index < props.size() && ConvertArray(props[index], out);
+}
+
+bool FbxNode::ReadArray(size_t index, std::vector<int64_t>& out) const {
+  return index < props.size() && ConvertArray(props[index], out);
+}
+
+bool FbxDocument::IsBinaryFbx(const uint8_t* data, size_t size) {
+  return size >= kHeaderSize && std::memcmp(data, kMagic, sizeof(kMagic) - 1) == 0;
+}
+
+bool FbxDocument::Parse(const uint8_t* data, size_t size, std::string& error) {
+  roots_.clear();
+  decoded_.clear();
+  if (!IsBinaryFbx(data, size)) {
+    error = "not a binary FBX file";
+    return false;
+  }
+  version_ = Load<uint32_t>(data + 23);
+  if (version_ < 7000 || version_ >= 8000) {
+    error = "unsupported FBX version " + std::to_string(version_);
+    return false;
+  }
+  RecordReader reader(data, version_ >= 7500);
+  size_t pos = kHeaderSize;
+  return reader.ReadList(pos, size, 0, roots_, error);
+}
+
+bool FbxDocument::DecodeArrays(std::string& error, uint64_t* decodedBytes) {
+  std::vector<FbxProperty*> compressed;
+  CollectCompressed(roots_, compressed);
+  const size_t first = decoded_.size();
+  uint64_t total = 0;
+  decoded_.resize(first + compressed.size());
+  for (size_t i = 0; i < compressed.size(); ++i) {
+    decoded_[first + i].resize(size_t{compressed[i]->count} * ElementSize(compressed[i]->type));
+    total += decoded_[first + i].size();
+  }
+  std::atomic<bool> failed{false};
+  ParallelFor(compressed.size(), 1, [&](size_t begin, size_t end) {
+    for (size_t i = begin; i < end && !failed.load(std::memory_order_relaxed); ++i) {
+      FbxProperty& prop = *compressed[i];
+      std::vector<uint8_t>& out = decoded_[first + i];
+      if (!InflateZlib(reinterpret_cast<const uint8_t*>(prop.bytes.data()), prop.bytes.size(), out.data(), out.size())) {
+        failed = true;
+        return;
+      }
+      prop.bytes = std::string_view(reinterpret_cast<const char*>(out.data()), out.size());
+      prop.encoding = 0;
+    }
+  });
+  if (failed) {
+    error = "corrupt zlib array in FBX file";
+    return false;
+  }
+  if (decodedBytes != nullptr) {
+    *decodedBytes = total;
+  }
+  return true;
+}
+
+const FbxNode* FbxDocument::Root(std::string_view name) const {
+  for (const FbxNode& node : roots_) {
+    if (node.name == name) {
+      return &node;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace vv
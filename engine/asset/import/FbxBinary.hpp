@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vv {
+
+// One property of a binary FBX node record. Scalars are widened (`i` for Y/C/I/L, `d` for F/D);
+// S and R point into the file; arrays point at their payload in the file until
+// FbxDocument::DecodeArrays inflates it, then at the decoded elements.
+struct FbxProperty {
+  char type = 0;  // record type code: Y C I L F D S R, or f d i l b for arrays
+  int64_t i = 0;
+  double d = 0.0;
+  std::string_view bytes;  // S/R payload; for arrays the elements (or the zlib stream before decoding)
+  uint32_t count = 0;      // arrays: element count
+  uint32_t encoding = 0;   // arrays: 0 = raw, 1 = zlib (0 once decoded)
+
+  [[nodiscard]] bool IsArray() const { return type == 'f' || type == 'd' || type == 'i' || type == 'l' || type == 'b'; }
+  [[nodiscard]] double Number() const { return type == 'F' || type == 'D' ? d : static_cast<double>(i); }
+  // Object names are stored as "Name\x00\x01Class"; this is the "Name" part.
+  [[nodiscard]] std::string_view ObjectName() const;
+};
+
+struct FbxNode {
+  std::string_view name;
+  std::vector<FbxProperty> props;
+  std::vector<FbxNode> children;
+
+  // First child called `name`, or nullptr.
+  [[nodiscard]] const FbxNode* Child(std::string_view childName) const;
+  // Reads property `index` as a typed array, converting the element type (f/d, i/l/b) as needed.
+  // False when it is not an array or not decoded yet.
+  bool ReadArray(size_t index, std::vector<double>& out) const;
+  bool ReadArray(size_t index, std::vector<float>& out) const;
+  bool ReadArray(size_t index, std::vector<int32_t>& out) const;
+  bool ReadArray(size_t index, std::vector<int64_t>& out) const;
+};
+
+// The record tree of a binary FBX file (7.x, 32- and 64-bit record headers). Names, strings and
+// raw arrays point into the caller's bytes, which must outlive the document.
+class FbxDocument {
+ public:
+  static bool IsBinaryFbx(const uint8_t* data, size_t size);
+
+  bool Parse(const uint8_t* data, size_t size, std::string& error);
+  // Inflates every zlib-compressed array, spread over the worker threads. Returns the number of
+  // decoded bytes through `decodedBytes`.
+  bool DecodeArrays(std::string& error, uint64_t* decodedBytes = nullptr);
+
+  [[nodiscard]] uint32_t Version() const { return version_; }
+  [[nodiscard]] const std::vector<FbxNode>& Roots() const { return roots_; }
+  [[nodiscard]] const FbxNode* Root(std::string_view name) const;
+
+ private:
+  uint32_t version_ = 0;
+  std::vector<FbxNode> roots_;
+  std::vector<std::vector<uint8_t>> decoded_;
+};
+
+}  // namespace vv
@@ -0,0 +1,2054 @@
+#include "asset/import/FbxImporter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <initializer_list>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/matrix.hpp>
+
+#include "asset/import/ConversionKernels.hpp"
+#include "asset/import/FbxBinary.hpp"
+#include "asset/import/ImportCommon.hpp"
+#include "asset/import/MaterialPacking.hpp"
+#include "asset/import/ScenePruning.hpp"
+#include "asset/index/AssetDirectoryIndex.hpp"
+#include "asset/mesh/SkinWeight.hpp"
+#include "core/io/MappedFile.hpp"
+#include "core/thread/ParallelFor.hpp"
+
+namespace vv {
+namespace {
+
+// The conversions below follow Assimp's FBX converter and post-processing steps operation for
+// operation (same float/double mix, same epsilons), so a native import matches an Assimp one of
+// the same file. Wherever Assimp would do something this reader does not reproduce, the reader
+// gives up with a message and the caller falls back to Assimp.
+
+constexpr double kFbxTicksPerSecond = 46186158000.0;  // KTime units
+constexpr int64_t kKeyWindowSlack = 10000;             // Assimp widens the key window by this much
+constexpr float kZeroEpsilon = std::numeric_limits<float>::epsilon();
+constexpr float kDegToRad = 0.0174532925F;
+constexpr float kTriangulatePi = 3.1415926538F;
+constexpr int64_t kDefaultMaterialSource = 0;  // object 0 is the scene root, never a material
+
+// Typed reads accept the P record types Assimp parses into that type.
+constexpr std::string_view kFloatTypes[] = {"double", "Number", "float", "Float", "FieldOfView", "UnitScaleFactor"};
+constexpr std::string_view kIntTypes[] = {"int", "Int", "enum", "Enum", "Integer"};
+constexpr std::string_view kVectorTypes[] = {"Vector3D", "ColorRGB", "Vector", "Color",
+                                             "Lcl Translation", "Lcl Rotation", "Lcl Scaling"};
+
+template <size_t N>
+bool IsOneOf(std::string_view value, const std::string_view (&set)[N]) {
+  return std::find(std::begin(set), std::end(set), value) != std::end(set);
+}
+
+// A Properties70 block over its template. The first of duplicate names wins, as in Assimp.
+class PropertyTable {
+ public:
+  PropertyTable() = default;
+  PropertyTable(const FbxNode* record, const PropertyTable* base) : base_(base) {
+    const FbxNode* block = record != nullptr ? record->Child("Properties70") : nullptr;
+    if (block == nullptr) {
+      return;
+    }
+    for (const FbxNode& p : block->children) {
+      if (p.name == "P" && p.props.size() >= 2 && p.props[0].type == 'S' && p.props[1].type == 'S') {
+        props_.try_emplace(p.props[0].bytes, &p);
+      }
+    }
+  }
+
+  [[nodiscard]] const FbxNode* Find(std::string_view name) const {
+    const auto it = props_.find(name);
+    if (it != props_.end()) {
+      return it->second;
+    }
+    return base_ != nullptr ? base_->Find(name) : nullptr;
+  }
+
+  [[nodiscard]] std::optional<float> Float(std::string_view name) const {
+    const FbxNode* p = Find(name);
+    if (p == nullptr || p->props.size() < 5 || !IsOneOf(p->props[1].bytes, kFloatTypes)) {
+      return std::nullopt;
+    }
+    return static_cast<float>(p->props[4].Number());
+  }
+
+  [[nodiscard]] std::optional<int64_t> Int(std::string_view name) const {
+    const FbxNode* p = Find(name);
+    if (p == nullptr || p->props.size() < 5 || !IsOneOf(p->props[1].bytes, kIntTypes)) {
+      return std::nullopt;
+    }
+    return static_cast<int64_t>(p->props[4].Number());
+  }
+
+  [[nodiscard]] std::optional<int64_t> Time(std::string_view name) const {
+    const FbxNode* p = Find(name);
+    if (p == nullptr || p->props.size() < 5 || p->props[1].bytes != "KTime") {
+      return std::nullopt;
+    }
+    return p->props[4].i;
+  }
+
+  [[nodiscard]] std::optional<Vec3> Vector(std::string_view name) const {
+    const FbxNode* p = Find(name);
+    if (p == nullptr || p->props.size() < 7 || !IsOneOf(p->props[1].bytes, kVectorTypes)) {
+      return std::nullopt;
+    }
+    return Vec3(static_cast<float>(p->props[4].Number()),
+                static_cast<float>(p->props[5].Number()),
+                static_cast<float>(p->props[6].Number()));
+  }
+
+  // Own properties only; templates never carry vendor extensions.
+  [[nodiscard]] bool HasPrefix(std::string_view prefix) const {
+    return std::any_of(props_.begin(), props_.end(), [&](const auto& p) { return p.first.starts_with(prefix); });
+  }
+
+ private:
+  std::unordered_map<std::string_view, const FbxNode*> props_;
+  const PropertyTable* base_ = nullptr;
+};
+
+struct FbxObject {
+  const FbxNode* record = nullptr;  // record name is the object class: Model, Geometry, ...
+  std::string_view name;
+  std::string_view subclass;
+};
+
+struct FbxLink {
+  int64_t object = 0;         // the source for links into an object, the destination for links out
+  std::string_view property;  // empty for object-object links
+};
+
+const std::vector<FbxLink> kNoLinks;
+
+// Objects, connections and property templates of a parsed document.
+class FbxIndex {
+ public:
+  bool Build(const FbxDocument& doc, std::string& error) {
+    const FbxNode* objects = doc.Root("Objects");
+    if (objects == nullptr) {
+      error = "FBX file has no Objects section";
+      return false;
+    }
+    for (const FbxNode& record : objects->children) {
+      if (record.props.size() < 3 || record.props[0].type != 'L' || record.props[1].type != 'S') {
+        continue;
+      }
+      const int64_t id = record.props[0].i;
+      FbxObject object{.record = &record, .name = record.props[1].ObjectName(), .subclass = record.props[2].bytes};
+      if (!objects_.try_emplace(id, object).second) {
+        error = "duplicate FBX object id " + std::to_string(id);
+        return false;
+      }
+      fileOrder_.push_back(id);
+    }
+    if (const FbxNode* connections = doc.Root("Connections")) {
+      for (const FbxNode& c : connections->children) {
+        if (c.name != "C" || c.props.size() < 3 || c.props[0].type != 'S') {
+          continue;
+        }
+        const std::string_view kind = c.props[0].bytes;
+        const bool propertyLink = kind == "OP";
+        if ((kind != "OO" && !propertyLink) || (propertyLink && c.props.size() < 4)) {
+          continue;  // property-property links carry nothing the converter reads
+        }
+        const int64_t src = c.props[1].i;
+        const int64_t dst = c.props[2].i;
+        if (Find(src) == nullptr || (dst != 0 && Find(dst) == nullptr)) {
+          continue;
+        }
+        const std::string_view property = propertyLink ? c.props[3].bytes : std::string_view();
+        linksTo_[dst].push_back({.object = src, .property = property});
+        linksFrom_[src].push_back({.object = dst, .property = property});
+      }
+    }
+    if (const FbxNode* definitions = doc.Root("Definitions")) {
+      for (const FbxNode& type : definitions->children) {
+        if (type.name != "ObjectType" || type.props.empty()) {
+          continue;
+        }
+        for (const FbxNode& tmpl : type.children) {
+          if (tmpl.name == "PropertyTemplate" && !tmpl.props.empty()) {
+            const std::string key = std::string(type.props[0].bytes) + "." + std::string(tmpl.props[0].bytes);
+            templates_.try_emplace(key, &tmpl, nullptr);
+          }
+        }
+      }
+    }
+    return true;
+  }
+
+  [[nodiscard]] const FbxObject* Find(int64_t id) const {
+    const auto it = objects_.find(id);
+    return it != objects_.end() ? &it->second : nullptr;
+  }
+  [[nodiscard]] bool Is(int64_t id, std::string_view cls) const {
+    const FbxObject* object = Find(id);
+    return object != nullptr && object->record->name == cls;
+  }
+  [[nodiscard]] const PropertyTable* Template(const std::string& key) const {
+    const auto it = templates_.find(key);
+    return it != templates_.end() ? &it->second : nullptr;
+  }
+  [[nodiscard]] const std::vector<FbxLink>& LinksTo(int64_t id) const {
+    const auto it = linksTo_.find(id);
+    return it != linksTo_.end() ? it->second : kNoLinks;
+  }
+  [[nodiscard]] const std::vector<FbxLink>& LinksFrom(int64_t id) const {
+    const auto it = linksFrom_.find(id);
+    return it != linksFrom_.end() ? it->second : kNoLinks;
+  }
+  // Objects of class `cls` linked into `id` by object links, in file order.
+  [[nodiscard]] std::vector<int64_t> Sources(int64_t id, std::string_view cls) const {
+    std::vector<int64_t> out;
+    for (const FbxLink& link : LinksTo(id)) {
+      if (link.property.empty() && Is(link.object, cls)) {
+        out.push_back(link.object);
+      }
+    }
+    return out;
+  }
+  [[nodiscard]] const std::vector<int64_t>& FileOrder() const { return fileOrder_; }
+
+ private:
+  std::unordered_map<int64_t, FbxObject> objects_;
+  std::vector<int64_t> fileOrder_;
+  std::unordered_map<int64_t, std::vector<FbxLink>> linksTo_;
+  std::unordered_map<int64_t, std::vector<FbxLink>> linksFrom_;
+  std::unordered_map<std::string, PropertyTable> templates_;
+};
+
+// Assimp's rotation order table: the three axis rotations multiplied left to right, skipping
+// components within epsilon of zero. Order 6 (spheric XYZ) is rejected before this is called.
+Mat4 RotationMatrix(int64_t order, const Vec3& degrees) {
+  constexpr int kOrders[6][3] = {{2, 1, 0}, {1, 2, 0}, {0, 2, 1}, {2, 0, 1}, {1, 0, 2}, {0, 1, 2}};
+  const Vec3 rad = degrees * kDegToRad;
+  Mat4 axis[3] = {Mat4(1.0F), Mat4(1.0F), Mat4(1.0F)};
+  bool used[3] = {false, false, false};
+  if (std::fabs(rad.z) > kZeroEpsilon) {
+    const float c = std::cos(rad.z);
+    const float s = std::sin(rad.z);
+    axis[2][0][0] = c;
+    axis[2][1][1] = c;
+    axis[2][0][1] = s;
+    axis[2][1][0] = -s;
+    used[2] = true;
+  }
+  if (std::fabs(rad.y) > kZeroEpsilon) {
+    const float c = std::cos(rad.y);
+    const float s = std::sin(rad.y);
+    axis[1][0][0] = c;
+    axis[1][2][2] = c;
+    axis[1][2][0] = s;
+    axis[1][0][2] = -s;
+    used[1] = true;
+  }
+  if (std::fabs(rad.x) > kZeroEpsilon) {
+    const float c = std::cos(rad.x);
+    const float s = std::sin(rad.x);
+    axis[0][1][1] = c;
+    axis[0][2][2] = c;
+    axis[0][1][2] = s;
+    axis[0][2][1] = -s;
+    used[0] = true;
+  }
+  Mat4 out(1.0F);
+  for (const int a : kOrders[order]) {
+    if (used[a]) {
+      out = out * axis[a];
+    }
+  }
+  return out;
+}
+
+// aiQuaternion(const aiMatrix3x3&), which picks the branch by trace and largest diagonal.
+Quat QuatFromBasis(const glm::mat3& m) {
+  const float a1 = m[0][0];
+  const float a2 = m[1][0];
+  const float a3 = m[2][0];
+  const float b1 = m[0][1];
+  const float b2 = m[1][1];
+  const float b3 = m[2][1];
+  const float c1 = m[0][2];
+  const float c2 = m[1][2];
+  const float c3 = m[2][2];
+  const float t = a1 + b2 + c3;
+  Quat q;
+  if (t > 0.0F) {
+    const float s = std::sqrt(1.0F + t) * 2.0F;
+    q = Quat(0.25F * s, (c2 - b3) / s, (a3 - c1) / s, (b1 - a2) / s);
+  } else if (a1 > b2 && a1 > c3) {
+    const float s = std::sqrt(1.0F + a1 - b2 - c3) * 2.0F;
+    q = Quat((c2 - b3) / s, 0.25F * s, (b1 + a2) / s, (a3 + c1) / s);
+  } else if (b2 > c3) {
+    const float s = std::sqrt(1.0F + b2 - a1 - c3) * 2.0F;
+    q = Quat((a3 - c1) / s, (b1 + a2) / s, 0.25F * s, (c2 + b3) / s);
+  } else {
+    const float s = std::sqrt(1.0F + c3 - a1 - b2) * 2.0F;
+    q = Quat((b1 - a2) / s, (a3 + c1) / s, (c2 + b3) / s, 0.25F * s);
+  }
+  return q;
+}
+
+Quat EulerToQuat(int64_t order, const Vec3& degrees) {
+  return QuatFromBasis(glm::mat3(RotationMatrix(order, degrees)));
+}
+
+struct SceneConversion {
+  Mat4 c{1.0F};
+  Mat4 cInv{1.0F};
+  glm::mat3 r{1.0F};
+  glm::mat3 normalXform{1.0F};
+  RotationBasisChange rotation;
+};
+
+struct FbxCluster {
+  std::string bone;  // name of the target model
+  Mat4 transformLink{1.0F};
+  std::vector<int32_t> indices;  // control points
+  std::vector<float> weights;
+};
+
+// Per polygon vertex, as Assimp's MeshGeometry lays it out; faces are 3 or 4 corners.
+struct FbxGeometry {
+  std::string name;
+  std::vector<Vec3> vertices;
+  std::vector<uint32_t> faceSizes;
+  std::vector<uint32_t> faceOfVertex;
+  std::vector<uint32_t> mappingOffsets;  // control point -> range of `mappings`
+  std::vector<uint32_t> mappingCounts;
+  std::vector<uint32_t> mappings;        // polygon vertices of each control point
+  std::vector<Vec3> normals;             // empty when absent
+  std::vector<Vec2> uvs;                 // channel 0; empty when absent
+  std::vector<int32_t> materials;        // per face; one entry when every face shares it
+  std::vector<FbxCluster> clusters;      // of the skin, if any
+  std::string error;
+};
+
+// One aiMesh of Assimp's conversion: a geometry, or the faces of one material of it.
+struct MeshPart {
+  size_t geometry = 0;    // into FbxContext::geometries
+  int32_t materialIndex = -1;  // layer material of the faces taken; all faces when `allFaces`
+  bool allFaces = true;
+  NodeId node = kInvalidNodeId;
+  int64_t model = 0;
+  int64_t materialSource = kDefaultMaterialSource;
+};
+
+struct FbxContext {
+  const FbxIndex* index = nullptr;
+  const ImportOptions* opt = nullptr;
+  SceneConversion conv;
+  Scene dst;
+  ImportReport* report = nullptr;
+  std::filesystem::path sourceDir;
+  std::string error;  // set once: why the file needs Assimp
+
+  PropertyTable modelTemplate;
+  std::unordered_map<int64_t, NodeId> nodeOfModel;
+  std::unordered_map<int64_t, Mat4> modelGlobal;   // FBX-space world matrix of each hierarchy model
+  std::unordered_map<std::string, NodeId> nodeByName;
+  std::vector<std::pair<int64_t, int64_t>> meshModels;  // (geometry, model) in conversion order
+  std::vector<std::pair<int64_t, NodeId>> lightModels;  // (light attribute, node), Assimp's post-order
+  std::vector<FbxGeometry> geometries;                  // parallel to meshModels
+  std::vector<MeshPart> parts;
+  std::vector<int64_t> materialSources;                 // conversion order; kDefaultMaterialSource = default
+  std::unordered_map<int64_t, MaterialId> materialIds;
+
+  bool Fail(std::string message) {
+    if (error.empty()) {
+      error = std::move(message);
+    }
+    return false;
+  }
+};
+
+SceneConversion BuildConversion(const FbxDocument& doc, const ImportOptions& opt, std::string& error) {
+  const FbxNode* settings = doc.Root("GlobalSettings");
+  const PropertyTable props(settings, nullptr);
+  const auto axis = [&](const char* name, int64_t fallback) { return props.Int(name).value_or(fallback); };
+  const int64_t rightAxis = axis("CoordAxis", 0);
+  const int64_t upAxis = axis("UpAxis", 1);
+  const int64_t frontAxis = axis("FrontAxis", 2);
+  SceneConversion conv;
+  if (rightAxis < 0 || rightAxis > 2 || upAxis < 0 || upAxis > 2 || frontAxis < 0 || frontAxis > 2) {
+    error = "FBX axis settings out of range";
+    return conv;
+  }
+  // Assimp's root transform for other units has not been matched yet.
+  if (props.Float("UnitScaleFactor").value_or(1.0F) != 1.0F) {
+    error = "FBX unit scale other than centimeters";
+    return conv;
+  }
+  glm::mat3 rot(0.0F);
+  rot[rightAxis][0] = static_cast<float>(axis("CoordAxisSign", 1));
+  rot[upAxis][1] = static_cast<float>(axis("UpAxisSign", 1));
+  rot[frontAxis][2] = static_cast<float>(-axis("FrontAxisSign", 1));  // target uses +Z back
+  if (!opt.forceRightHanded) {
+    rot = glm::mat3(1.0F);
+  }
+  const float unitScale = opt.convertToMeters ? 0.01F : 1.0F;
+  conv.r = rot;
+  conv.c = glm::scale(Mat4(1.0F), Vec3(unitScale)) * Mat4(rot);
+  conv.cInv = glm::inverse(conv.c);
+  conv.rotation = MakeRotationBasisChange(rot);
+  conv.normalXform = glm::transpose(glm::inverse(glm::mat3(conv.c)));
+  return conv;
+}
+
+bool NearZero(const std::optional<Vec3>& v) {
+  return !v.has_value() || glm::dot(*v, *v) <= kZeroEpsilon;
+}
+
+bool NearOne(const std::optional<Vec3>& v) {
+  return !v.has_value() || glm::dot(*v - Vec3(1.0F), *v - Vec3(1.0F)) <= kZeroEpsilon;
+}
+
+// Models below `parent` in link order, depth first: each node is created, then its meshes are
+// queued, then its children follow and finally its lights, which is the order Assimp converts
+// them in. Every node holds one matrix (pivots are not preserved), T * Rpre * R * S.
+bool ConvertNodes(FbxContext& ctx, int64_t parent, NodeId parentNode, const Mat4& parentGlobal) {
+  const FbxIndex& index = *ctx.index;
+  for (const int64_t id : index.Sources(parent, "Model")) {
+    const FbxObject& model = *index.Find(id);
+    if (model.subclass == "IKEffector" || model.subclass == "FKEffector") {
+      continue;  // Assimp does not read effectors at all
+    }
+    if (ctx.nodeOfModel.contains(id)) {
+      return ctx.Fail("FBX model '" + std::string(model.name) + "' has several parents");
+    }
+    const PropertyTable props(model.record, &ctx.modelTemplate);
+    for (const char* pivot : {"RotationOffset", "RotationPivot", "ScalingOffset", "ScalingPivot", "PostRotation",
+                              "GeometricTranslation", "GeometricRotation"}) {
+      if (!NearZero(props.Vector(pivot))) {
+        return ctx.Fail("FBX model '" + std::string(model.name) + "' uses " + pivot);
+      }
+    }
+    if (!NearOne(props.Vector("GeometricScaling"))) {
+      return ctx.Fail("FBX model '" + std::string(model.name) + "' uses GeometricScaling");
+    }
+    const int64_t rotationOrder = props.Int("RotationOrder").value_or(0);
+    if (rotationOrder < 0 || rotationOrder > 5) {
+      return ctx.Fail("FBX model '" + std::string(model.name) + "' has an unsupported rotation order");
+    }
+
+    Mat4 local(1.0F);
+    if (const std::optional<Vec3> t = props.Vector("Lcl Translation"); !NearZero(t)) {
+      local = local * glm::translate(Mat4(1.0F), *t);
+    }
+    if (const std::optional<Vec3> pre = props.Vector("PreRotation"); !NearZero(pre)) {
+      local = local * RotationMatrix(0, *pre);
+    }
+    if (const std::optional<Vec3> r = props.Vector("Lcl Rotation"); !NearZero(r)) {
+      local = local * RotationMatrix(rotationOrder, *r);
+    }
+    if (const std::optional<Vec3> s = props.Vector("Lcl Scaling"); !NearOne(s)) {
+      local = local * glm::scale(Mat4(1.0F), *s);
+    }
+    const Mat4 global = parentGlobal * local;
+
+    Node node;
+    node.name = std::string(model.name);
+    node.parent = parentNode;
+    node.localBind = DecomposeTransform(ctx.conv.c * local * ctx.conv.cInv);
+    node.localCurrent = node.localBind;
+    const NodeId nodeId = static_cast<NodeId>(ctx.dst.nodes.size());
+    ctx.dst.nodes.push_back(std::move(node));
+    ctx.dst.nodes[parentNode].children.push_back(nodeId);
+    ctx.nodeOfModel[id] = nodeId;
+    ctx.modelGlobal[id] = global;
+    ctx.nodeByName[ctx.dst.nodes[nodeId].name] = nodeId;
+
+    for (const FbxLink& link : index.LinksTo(id)) {
+      if (!link.property.empty() || !index.Is(link.object, "Geometry")) {
+        continue;
+      }
+      if (index.Find(link.object)->subclass != "Mesh") {
+        return ctx.Fail("FBX geometry of type '" + std::string(index.Find(link.object)->subclass) + "'");
+      }
+      ctx.meshModels.emplace_back(link.object, id);
+    }
+    if (!ConvertNodes(ctx, id, nodeId, global)) {
+      return false;
+    }
+    size_t lights = 0;
+    for (const int64_t attribute : index.Sources(id, "NodeAttribute")) {
+      if (index.Find(attribute)->subclass == "Light") {
+        ctx.lightModels.emplace_back(attribute, nodeId);
+        ++lights;
+      }
+    }
+    if (lights > 1) {
+      return ctx.Fail("FBX model '" + std::string(model.name) + "' has several lights");
+    }
+  }
+  return true;
+}
+
+bool BuildNodes(FbxContext& ctx) {
+  // Assimp renames clashing nodes; names here must already be unique to match it.
+  std::unordered_set<std::string_view> names = {"RootNode"};
+  for (const int64_t id : ctx.index->FileOrder()) {
+    const FbxObject& object = *ctx.index->Find(id);
+    if (object.record->name == "Model" && object.subclass != "IKEffector" && object.subclass != "FKEffector" &&
+        (object.name.empty() || !names.insert(object.name).second)) {
+      return ctx.Fail("FBX model name '" + std::string(object.name) + "' is empty or not unique");
+    }
+  }
+  Node root;
+  root.name = "RootNode";
+  ctx.dst.nodes.push_back(std::move(root));
+  ctx.dst.roots.push_back(0);
+  ctx.nodeByName["RootNode"] = 0;
+  if (!ConvertNodes(ctx, 0, 0, Mat4(1.0F))) {
+    return false;
+  }
+  std::unordered_set<int64_t> geometries;
+  for (const auto& [geometry, model] : ctx.meshModels) {
+    if (!geometries.insert(geometry).second) {
+      return ctx.Fail("FBX geometry shared by several models");
+    }
+  }
+  return true;
+}
+
+bool ReadVectors(const FbxNode* record, std::vector<Vec3>& out) {
+  std::vector<double> values;
+  if (record == nullptr || !record->ReadArray(0, values) || values.size() % 3 != 0) {
+    return false;
+  }
+  out.resize(values.size() / 3);
+  for (size_t i = 0; i < out.size(); ++i) {
+    out[i] = Vec3(static_cast<float>(values[i * 3]), static_cast<float>(values[i * 3 + 1]),
+                  static_cast<float>(values[i * 3 + 2]));
+  }
+  return true;
+}
+
+bool ReadVectors(const FbxNode* record, std::vector<Vec2>& out) {
+  std::vector<double> values;
+  if (record == nullptr || !record->ReadArray(0, values) || values.size() % 2 != 0) {
+    return false;
+  }
+  out.resize(values.size() / 2);
+  for (size_t i = 0; i < out.size(); ++i) {
+    out[i] = Vec2(static_cast<float>(values[i * 2]), static_cast<float>(values[i * 2 + 1]));
+  }
+  return true;
+}
+
+std::string_view ChildString(const FbxNode& record, std::string_view name) {
+  const FbxNode* child = record.Child(name);
+  return child != nullptr && !child->props.empty() && child->props[0].type == 'S' ? child->props[0].bytes
+                                                                                  : std::string_view();
+}
+
+// Assimp's ResolveVertexDataArray: one value per polygon vertex, or nothing when the layer does
+// not fit the geometry. False for layouts Assimp either rejects or mis-reads.
+template <typename T>
+bool ResolveLayer(const FbxNode& layer, const char* dataName, const char* indexName, FbxGeometry& geo, std::vector<T>& out) {
+  const std::string_view mapping = ChildString(layer, "MappingInformationType");
+  std::string_view reference = ChildString(layer, "ReferenceInformationType");
+  if (mapping.empty() || reference.empty()) {
+    geo.error = "FBX layer without mapping information";
+    return false;
+  }
+  if (reference == "IndexToDirect" && layer.Child(indexName) == nullptr) {
+    reference = "Direct";
+  }
+  const size_t vertexCount = geo.faceOfVertex.size();
+  std::vector<T> data;
+  if (mapping == "ByVertice" && reference == "Direct") {
+    if (layer.Child(dataName) == nullptr) {
+      return true;
+    }
+    if (!ReadVectors(layer.Child(dataName), data)) {
+      geo.error = "FBX layer data unreadable";
+      return false;
+    }
+    if (data.size() != geo.mappingOffsets.size()) {
+      return true;
+    }
+    out.assign(vertexCount, T(0.0F));
+    for (size_t i = 0; i < data.size(); ++i) {
+      for (uint32_t j = geo.mappingOffsets[i]; j < geo.mappingOffsets[i] + geo.mappingCounts[i]; ++j) {
+        out[geo.mappings[j]] = data[i];
+      }
+    }
+    return true;
+  }
+  if (mapping != "ByPolygonVertex" || (reference != "Direct" && reference != "IndexToDirect")) {
+    geo.error = "FBX layer mapping " + std::string(mapping) + "/" + std::string(reference);
+    return false;
+  }
+  if (!ReadVectors(layer.Child(dataName), data)) {
+    geo.error = "FBX layer data unreadable";
+    return false;
+  }
+  if (reference == "Direct") {
+    if (data.size() == vertexCount) {
+      out = std::move(data);
+    }
+    return true;
+  }
+  std::vector<int32_t> indices;
+  if (!layer.Child(indexName)->ReadArray(0, indices)) {
+    geo.error = "FBX layer index unreadable";
+    return false;
+  }
+  if (indices.size() > vertexCount) {
+    indices.resize(vertexCount);
+  }
+  if (indices.size() != vertexCount) {
+    return true;
+  }
+  out.assign(vertexCount, T(0.0F));
+  for (size_t i = 0; i < vertexCount; ++i) {
+    if (indices[i] == -1) {
+      continue;
+    }
+    if (indices[i] < 0 || static_cast<size_t>(indices[i]) >= data.size()) {
+      geo.error = "FBX layer index out of range";
+      return false;
+    }
+    out[i] = data[indices[i]];
+  }
+  return true;
+}
+
+bool ReadMaterialLayer(const FbxNode& layer, FbxGeometry& geo) {
+  std::vector<int32_t> materials;
+  const FbxNode* data = layer.Child("Materials");
+  if (data == nullptr || !data->ReadArray(0, materials)) {
+    geo.error = "FBX material layer unreadable";
+    return false;
+  }
+  const std::string_view mapping = ChildString(layer, "MappingInformationType");
+  if (mapping == "AllSame") {
+    if (materials.size() > 1) {
+      materials.assign(1, 0);  // Assimp keeps a value-initialized entry
+    }
+  } else if (mapping == "ByPolygon" && ChildString(layer, "ReferenceInformationType") == "IndexToDirect") {
+    materials.resize(geo.faceSizes.size(), 0);
+  } else {
+    geo.error = "FBX material mapping " + std::string(mapping);
+    return false;
+  }
+  // An empty or all-negative layer is dropped: those faces take the default material.
+  if (std::all_of(materials.begin(), materials.end(), [](int32_t m) { return m < 0; })) {
+    return true;
+  }
+  geo.materials = std::move(materials);
+  return true;
+}
+
+bool ReadMatrix(const FbxNode* record, Mat4& out) {
+  std::vector<double> values;
+  if (record == nullptr || !record->ReadArray(0, values) || values.size() != 16) {
+    return false;
+  }
+  for (int i = 0; i < 16; ++i) {
+    out[i / 4][i % 4] = static_cast<float>(values[i]);
+  }
+  return true;
+}
+
+bool ParseCluster(const FbxIndex& index, int64_t id, FbxGeometry& geo) {
+  const FbxNode& record = *index.Find(id)->record;
+  FbxCluster& cluster = geo.clusters.emplace_back();
+  Mat4 transform(1.0F);
+  const std::vector<int64_t> targets = index.Sources(id, "Model");
+  if (!ReadMatrix(record.Child("Transform"), transform) || !ReadMatrix(record.Child("TransformLink"), cluster.transformLink) ||
+      targets.empty()) {
+    geo.error = "FBX cluster without bind matrices or target";
+    return false;
+  }
+  cluster.bone = std::string(index.Find(targets.front())->name);
+  const FbxNode* indexes = record.Child("Indexes");
+  const FbxNode* weights = record.Child("Weights");
+  if ((indexes != nullptr) != (weights != nullptr) ||
+      (indexes != nullptr && (!indexes->ReadArray(0, cluster.indices) || !weights->ReadArray(0, cluster.weights))) ||
+      cluster.indices.size() != cluster.weights.size()) {
+    geo.error = "FBX cluster weights unreadable";
+    return false;
+  }
+  for (const int32_t point : cluster.indices) {
+    if (point < 0 || static_cast<size_t>(point) >= geo.mappingOffsets.size()) {
+      geo.error = "FBX cluster weights a missing vertex";
+      return false;
+    }
+  }
+  for (size_t i = 0; i + 1 < geo.clusters.size(); ++i) {
+    if (geo.clusters[i].bone == cluster.bone) {
+      geo.error = "FBX skin binds '" + cluster.bone + "' twice";
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ParseGeometry(const FbxIndex& index, int64_t id, FbxGeometry& geo) {
+  const FbxObject& object = *index.Find(id);
+  const FbxNode& record = *object.record;
+  geo.name = std::string(object.name);
+
+  std::vector<Vec3> points;
+  std::vector<int32_t> polygonVertices;
+  if (!ReadVectors(record.Child("Vertices"), points) || record.Child("PolygonVertexIndex") == nullptr ||
+      !record.Child("PolygonVertexIndex")->ReadArray(0, polygonVertices)) {
+    geo.error = "FBX mesh '" + geo.name + "' has no readable vertices";
+    return false;
+  }
+  geo.vertices.reserve(polygonVertices.size());
+  geo.faceOfVertex.reserve(polygonVertices.size());
+  geo.mappingCounts.assign(points.size(), 0);
+  uint32_t corners = 0;
+  for (const int32_t i : polygonVertices) {
+    const uint32_t point = i < 0 ? static_cast<uint32_t>(-(i + 1)) : static_cast<uint32_t>(i);
+    if (point >= points.size()) {
+      geo.error = "FBX mesh '" + geo.name + "' indexes past its vertices";
+      return false;
+    }
+    geo.vertices.push_back(points[point]);
+    geo.faceOfVertex.push_back(static_cast<uint32_t>(geo.faceSizes.size()));
+    ++geo.mappingCounts[point];
+    ++corners;
+    if (i < 0) {
+      if (corners != 3 && corners != 4) {
+        geo.error = "FBX mesh '" + geo.name + "' has polygons with " + std::to_string(corners) + " corners";
+        return false;
+      }
+      geo.faceSizes.push_back(corners);
+      corners = 0;
+    }
+  }
+  if (corners != 0) {
+    geo.error = "FBX mesh '" + geo.name + "' ends in an open polygon";
+    return false;
+  }
+  geo.mappingOffsets.resize(points.size());
+  uint32_t cursor = 0;
+  for (size_t i = 0; i < points.size(); ++i) {
+    geo.mappingOffsets[i] = cursor;
+    cursor += geo.mappingCounts[i];
+    geo.mappingCounts[i] = 0;
+  }
+  geo.mappings.resize(polygonVertices.size());
+  for (size_t v = 0; v < polygonVertices.size(); ++v) {
+    const int32_t i = polygonVertices[v];
+    const uint32_t point = i < 0 ? static_cast<uint32_t>(-(i + 1)) : static_cast<uint32_t>(i);
+    geo.mappings[geo.mappingOffsets[point] + geo.mappingCounts[point]++] = static_cast<uint32_t>(v);
+  }
+
+  for (const FbxNode& layer : record.children) {
+    if (layer.name != "Layer") {
+      continue;
+    }
+    for (const FbxNode& element : layer.children) {
+      if (element.name != "LayerElement") {
+        continue;
+      }
+      const std::string_view type = ChildString(element, "Type");
+      const FbxNode* typedIndex = element.Child("TypedIndex");
+      if (type.empty() || typedIndex == nullptr || typedIndex->props.empty()) {
+        geo.error = "FBX layer element without type";
+        return false;
+      }
+      const FbxNode* source = nullptr;
+      for (const FbxNode& child : record.children) {
+        if (child.name == type && !child.props.empty() && child.props[0].i == typedIndex->props[0].i) {
+          source = &child;
+          break;
+        }
+      }
+      if (source == nullptr) {
+        continue;
+      }
+      bool ok = true;
+      if (type == "LayerElementNormal") {
+        ok = !geo.normals.empty() || ResolveLayer(*source, "Normals", "NormalsIndex", geo, geo.normals);
+      } else if (type == "LayerElementUV") {
+        ok = source->props[0].i != 0 || ResolveLayer(*source, "UV", "UVIndex", geo, geo.uvs);
+      } else if (type == "LayerElementMaterial") {
+        ok = !geo.materials.empty() || geo.faceSizes.empty() || ReadMaterialLayer(*source, geo);
+      } else if (type == "LayerElementTangent" || type == "LayerElementBinormal") {
+        geo.error = "FBX mesh '" + geo.name + "' has authored tangents";
+        ok = false;
+      }
+      if (!ok) {
+        return false;
+      }
+    }
+  }
+
+  int64_t skin = 0;
+  for (const int64_t deformer : index.Sources(id, "Deformer")) {
+    const std::string_view subclass = index.Find(deformer)->subclass;
+    if (subclass == "Skin") {
+      skin = deformer;
+    } else if (subclass == "BlendShape") {
+      geo.error = "FBX mesh '" + geo.name + "' has blend shapes";
+      return false;
+    }
+  }
+  if (skin != 0) {
+    for (const int64_t cluster : index.Sources(skin, "Deformer")) {
+      if (index.Find(cluster)->subclass == "Cluster" && !ParseCluster(index, cluster, geo)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Meshes in Assimp's order: one per geometry, or one per distinct layer material (in order of
+// first use) when its faces use several. Materials are queued the first time a mesh uses them.
+void PlanMeshes(FbxContext& ctx) {
+  for (size_t g = 0; g < ctx.geometries.size(); ++g) {
+    const FbxGeometry& geo = ctx.geometries[g];
+    if (geo.vertices.empty() || geo.faceSizes.empty()) {
+      continue;
+    }
+    const int64_t model = ctx.meshModels[g].second;
+    const std::vector<int64_t> slots = ctx.index->Sources(model, "Material");
+    const auto addPart = [&](int32_t materialIndex, bool allFaces) {
+      MeshPart part;
+      part.geometry = g;
+      part.materialIndex = materialIndex;
+      part.allFaces = allFaces;
+      part.node = ctx.nodeOfModel.at(model);
+      part.model = model;
+      if (materialIndex >= 0 && static_cast<size_t>(materialIndex) < slots.size()) {
+        part.materialSource = slots[materialIndex];
+      }
+      if (std::find(ctx.materialSources.begin(), ctx.materialSources.end(), part.materialSource) ==
+          ctx.materialSources.end()) {
+        ctx.materialSources.push_back(part.materialSource);
+      }
+      ctx.parts.push_back(part);
+    };
+    const std::vector<int32_t>& materials = geo.materials;
+    if (materials.empty() || std::all_of(materials.begin(), materials.end(), [&](int32_t m) { return m == materials[0]; })) {
+      addPart(materials.empty() ? -1 : materials[0], true);
+      continue;
+    }
+    std::unordered_set<int32_t> seen;
+    for (const int32_t m : materials) {
+      if (seen.insert(m).second) {
+        addPart(m, false);
+      }
+    }
+  }
+}
+
+// Texture slots the engine reads from a legacy material, in the order Assimp's path requests them.
+enum FbxTextureSlot : uint32_t { kSlotBaseColor, kSlotNormal, kSlotEmissive, kSlotSpecular, kSlotCount };
+constexpr bool kSlotSrgb[kSlotCount] = {true, false, true, true};
+constexpr TextureId kSlotFallback[kSlotCount] = {kDefaultWhiteSrgb, kDefaultNormal, kDefaultBlackLinear, kDefaultSpecular};
+
+using SlotPaths = std::array<std::string, kSlotCount>;
+
+// Property-linked textures of a material, last link per property winning.
+bool MaterialTextures(FbxContext& ctx, int64_t material, std::map<std::string_view, int64_t>& out) {
+  for (const FbxLink& link : ctx.index->LinksTo(material)) {
+    if (link.property.empty()) {
+      continue;
+    }
+    if (ctx.index->Is(link.object, "LayeredTexture")) {
+      return ctx.Fail("FBX layered texture on " + std::string(link.property));
+    }
+    if (link.property.starts_with("Maya|") || link.property.starts_with("3dsMax|")) {
+      return ctx.Fail("FBX vendor texture property " + std::string(link.property));
+    }
+    if (ctx.index->Is(link.object, "Texture")) {
+      out[link.property] = link.object;
+    }
+  }
+  return true;
+}
+
+std::string TextureFile(const FbxContext& ctx, int64_t texture) {
+  return std::string(ChildString(*ctx.index->Find(texture)->record, "RelativeFilename"));
+}
+
+// The Video a texture embeds (the last one linked), or 0.
+int64_t TextureMedia(const FbxContext& ctx, int64_t texture) {
+  int64_t media = 0;
+  for (const FbxLink& link : ctx.index->LinksTo(texture)) {
+    if (ctx.index->Is(link.object, "Video")) {
+      media = link.object;
+    }
+  }
+  return media;
+}
+
+std::string_view MediaContent(const FbxContext& ctx, int64_t media) {
+  const FbxNode* content = ctx.index->Find(media)->record->Child("Content");
+  return content != nullptr && !content->props.empty() && content->props[0].type == 'R' ? content->props[0].bytes
+                                                                                         : std::string_view();
+}
+
+std::string_view ShortFileName(std::string_view path) {
+  size_t slash = path.rfind('/');
+  if (slash == std::string_view::npos) {
+    slash = path.rfind('\\');
+  }
+  return slash == std::string_view::npos ? path : path.substr(slash + 1);
+}
+
+bool ConvertMaterial(FbxContext& ctx, int64_t source, size_t index, Material& out, SlotPaths& paths) {
+  if (source == kDefaultMaterialSource) {
+    out = MakeDefaultMaterial("DefaultMaterial");
+    out.baseColorFactor = Vec4(0.8F, 0.8F, 0.8F, 1.0F);
+    return true;
+  }
+  const FbxObject& object = *ctx.index->Find(source);
+  std::string shading(ChildString(*object.record, "ShadingModel"));
+  std::transform(shading.begin(), shading.end(), shading.begin(), [](unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+  const PropertyTable* base = nullptr;
+  if (shading.empty() || shading == "phong") {
+    base = ctx.index->Template("Material.FbxSurfacePhong");
+  } else if (shading == "lambert") {
+    base = ctx.index->Template("Material.FbxSurfaceLambert");
+  }
+  const PropertyTable props(object.record, base);
+  if (props.HasPrefix("Maya|") || props.HasPrefix("3dsMax|")) {
+    return ctx.Fail("FBX material '" + std::string(object.name) + "' has vendor PBR properties");
+  }
+  std::map<std::string_view, int64_t> textures;
+  if (!MaterialTextures(ctx, source, textures)) {
+    return false;
+  }
+
+  out = Material{};
+  out.name = object.name.empty() ? "Material_" + std::to_string(index) : std::string(object.name);
+  if (const std::optional<Vec3> diffuse = props.Vector("DiffuseColor")) {
+    out.baseColorFactor = Vec4(*diffuse * props.Float("DiffuseFactor").value_or(1.0F), 1.0F);
+  }
+  if (const std::optional<float> exponent = props.Float("ShininessExponent")) {
+    out.roughnessFactor = 1.0F - (std::sqrt(*exponent) / 10.0F);
+    out.legacyShininess = std::max(0.0F, *exponent);
+  }
+  if (const std::optional<Vec3> emissive = props.Vector("EmissiveColor")) {
+    out.emissiveFactor = *emissive * props.Float("EmissiveFactor").value_or(1.0F);
+  }
+  float opacity = 1.0F;
+  if (const std::optional<float> authored = props.Float("Opacity")) {
+    opacity = *authored;
+  } else if (const std::optional<Vec3> transparent = props.Vector("TransparentColor")) {
+    const Vec3 t = *transparent * props.Float("TransparencyFactor").value_or(1.0F);
+    opacity = 1.0F - ((t.x + t.y + t.z) / 3.0F);
+  }
+  out.baseColorFactor.a *= opacity;
+
+  // Properties feeding one Assimp texture type, highest priority first (Assimp keeps the last it assigns).
+  const auto path = [&](std::initializer_list<std::string_view> names) -> std::string {
+    for (const std::string_view name : names) {
+      const auto it = textures.find(name);
+      if (it != textures.end()) {
+        return TextureFile(ctx, it->second);
+      }
+    }
+    return {};
+  };
+  paths[kSlotBaseColor] = path({"DiffuseColor"});
+  const std::string normalMap = path({"NormalMap"});
+  paths[kSlotNormal] = !normalMap.empty() ? normalMap : path({"Bump"});
+  paths[kSlotEmissive] = path({"EmissiveFactor", "EmissiveColor"});
+  const std::string specular = path({"SpecularFactor", "SpecularColor"});
+  paths[kSlotSpecular] = !specular.empty() ? specular : path({"ShininessExponent"});
+
+  out.occlusionTex = kDefaultWhiteLinear;
+  out.metallicRoughnessTex = kDefaultWhiteLinear;
+  out.metallicTex = kDefaultBlackLinear;
+  out.roughnessTex = kDefaultWhiteLinear;
+  if (!paths[kSlotSpecular].empty()) {
+    // Same Blinn-Phong conversion as the Assimp path.
+    out.useSpecularGlossiness = true;
+    out.roughnessFactor =
+        out.legacyShininess > 0.0F ? glm::clamp(std::sqrt(2.0F / (out.legacyShininess + 2.0F)), 0.04F, 1.0F) : 0.7F;
+    out.metallicFactor = 0.0F;
+    out.normalGreenInverted = true;
+  }
+  return true;
+}
+
+// Embedded images in the order Assimp extracts them: each converted material's linked textures by
+// property name, then textures nothing links to, by id. Lookups match the first with the same
+// file name.
+std::vector<int64_t> EmbeddedMedia(FbxContext& ctx) {
+  std::vector<int64_t> media;
+  std::unordered_set<int64_t> seen;
+  for (const int64_t material : ctx.materialSources) {
+    std::map<std::string_view, int64_t> textures;
+    if (material == kDefaultMaterialSource || !MaterialTextures(ctx, material, textures)) {
+      continue;
+    }
+    for (const auto& [property, texture] : textures) {
+      const int64_t video = TextureMedia(ctx, texture);
+      if (video != 0 && !MediaContent(ctx, video).empty() && seen.insert(video).second) {
+        media.push_back(video);
+      }
+    }
+  }
+  std::vector<int64_t> orphans;
+  for (const int64_t id : ctx.index->FileOrder()) {
+    if (ctx.index->Is(id, "Texture") && ctx.index->LinksFrom(id).empty()) {
+      orphans.push_back(id);
+    }
+  }
+  std::sort(orphans.begin(), orphans.end(), [](int64_t a, int64_t b) {
+    return static_cast<uint64_t>(a) < static_cast<uint64_t>(b);
+  });
+  for (const int64_t texture : orphans) {
+    const int64_t video = TextureMedia(ctx, texture);
+    if (video != 0 && !MediaContent(ctx, video).empty()) {
+      media.push_back(video);
+    }
+  }
+  return media;
+}
+
+std::string MediaFileName(const FbxContext& ctx, int64_t media) {
+  const FbxNode& record = *ctx.index->Find(media)->record;
+  std::string_view name = ChildString(record, "RelativeFilename");
+  if (name.empty()) {
+    name = ChildString(record, "FileName");
+  }
+  if (name.empty()) {
+    name = ChildString(record, "Filename");
+  }
+  return std::string(name);
+}
+
+// Each distinct (file, color space) the materials name becomes one request, embedded bytes first
+// and files on disk otherwise, exactly as the Assimp path looks them up; AppendSourceImages then
+// hashes, decodes and appends them in request order.
+std::vector<std::array<TextureId, kSlotCount>> ImportTextures(FbxContext& ctx, const std::vector<SlotPaths>& paths) {
+  std::vector<int64_t> media;
+  std::vector<SourceImage> images;
+  std::unordered_map<std::string, size_t> imageByUri;
+  std::vector<SourceImageRequest> requests;
+  std::unordered_map<std::string, size_t> requestByKey;
+  std::vector<std::array<size_t, kSlotCount>> requestOf(paths.size());
+  bool mediaListed = false;
+  {
+    ScopedImportStage stage(ctx.report, "texture_resolve", "materials");
+    for (size_t m = 0; m < paths.size(); ++m) {
+      for (uint32_t slot = 0; slot < kSlotCount; ++slot) {
+        requestOf[m][slot] = SIZE_MAX;
+        const std::string uri = paths[m][slot].empty() ? std::string() : NormalizeTextureUri(paths[m][slot]);
+        if (uri.empty()) {
+          continue;
+        }
+        const std::string key = uri + (kSlotSrgb[slot] ? "|srgb" : "|linear");
+        if (const auto found = requestByKey.find(key); found != requestByKey.end()) {
+          requestOf[m][slot] = found->second;
+          continue;
+        }
+        auto image = imageByUri.find(uri);
+        if (image == imageByUri.end()) {
+          if (!mediaListed) {
+            media = EmbeddedMedia(ctx);
+            mediaListed = true;
+          }
+          SourceImage source;
+          source.uri = uri;
+          for (const int64_t video : media) {
+            if (ShortFileName(MediaFileName(ctx, video)) == ShortFileName(uri)) {
+              const std::string_view content = MediaContent(ctx, video);
+              source.data = reinterpret_cast<const uint8_t*>(content.data());
+              source.size = content.size();
+              break;
+            }
+          }
+          if (source.data == nullptr) {
+            if (const std::optional<std::filesystem::path> file = ResolveTexturePath(ctx.sourceDir, uri)) {
+              source.path = file->string();
+              source.uri = source.path;
+              stage.AddItems(1);
+            }
+          }
+          image = imageByUri.emplace(uri, images.size()).first;
+          images.push_back(std::move(source));
+        }
+        requestOf[m][slot] = requests.size();
+        requestByKey.emplace(key, requests.size());
+        requests.push_back({.image = image->second, .srgb = kSlotSrgb[slot]});
+      }
+    }
+  }
+  {
+    ScopedImportStage stage(ctx.report, "texture_read", "materials");
+    for (SourceImage& image : images) {
+      if (!image.path.empty() && image.file.Open(image.path)) {
+        image.data = image.file.Data();
+        image.size = image.file.Size();
+        stage.AddItems(image.size);
+      }
+    }
+  }
+
+  const std::vector<std::optional<TextureId>> textures = AppendSourceImages(ctx.dst, images, requests, *ctx.opt, ctx.report);
+  std::vector<std::array<TextureId, kSlotCount>> ids(paths.size());
+  for (size_t m = 0; m < paths.size(); ++m) {
+    for (uint32_t slot = 0; slot < kSlotCount; ++slot) {
+      const size_t request = requestOf[m][slot];
+      ids[m][slot] = request != SIZE_MAX && textures[request].has_value() ? *textures[request] : kSlotFallback[slot];
+    }
+  }
+  return ids;
+}
+
+bool ImportMaterials(FbxContext& ctx) {
+  if (ctx.materialSources.empty()) {
+    ctx.dst.materials.push_back(MakeDefaultMaterial("DefaultMaterial"));
+    return true;
+  }
+  std::vector<SlotPaths> paths(ctx.materialSources.size());
+  for (size_t i = 0; i < ctx.materialSources.size(); ++i) {
+    Material material;
+    if (!ConvertMaterial(ctx, ctx.materialSources[i], i, material, paths[i])) {
+      return false;
+    }
+    ctx.materialIds[ctx.materialSources[i]] = static_cast<MaterialId>(ctx.dst.materials.size());
+    ctx.dst.materials.push_back(std::move(material));
+  }
+  const std::vector<std::array<TextureId, kSlotCount>> ids = ImportTextures(ctx, paths);
+  for (size_t i = 0; i < ids.size(); ++i) {
+    Material& material = ctx.dst.materials[i];
+    material.baseColorTex = ids[i][kSlotBaseColor];
+    material.normalTex = ids[i][kSlotNormal];
+    material.emissiveTex = ids[i][kSlotEmissive];
+    material.specularTex = ids[i][kSlotSpecular];
+  }
+  return true;
+}
+
+Vec3 NormalizeSafe(const Vec3& v) {
+  return glm::dot(v, v) <= 1e-12F ? Vec3(0.0F, 1.0F, 0.0F) : glm::normalize(v);
+}
+
+bool ImportLights(FbxContext& ctx) {
+  const PropertyTable* base = ctx.index->Template("NodeAttribute.FbxLight");
+  for (const auto& [attribute, node] : ctx.lightModels) {
+    const PropertyTable props(ctx.index->Find(attribute)->record, base);
+    // Out-of-range enums read as their defaults, as in Assimp.
+    int64_t type = props.Int("LightType").value_or(0);
+    type = type < 0 || type > 4 ? 0 : type;
+    int64_t decay = props.Int("DecayType").value_or(2);
+    decay = decay < 0 || decay > 3 ? 2 : decay;
+    if (type > 2) {
+      continue;  // area and volume lights have no equivalent
+    }
+    Light light;
+    light.type = type == 0 ? LightType::kPoint : type == 1 ? LightType::kDirectional : LightType::kSpot;
+    light.color = props.Vector("Color").value_or(Vec3(1.0F)) * (props.Float("Intensity").value_or(100.0F) / 100.0F);
+    light.intensity = 1.0F;
+    float linear = 1.0F;
+    if (decay == 0 || decay == 2) {
+      linear = 0.0F;
+    } else if (decay == 1) {
+      linear = 2.0F / props.Float("DecayStart").value_or(1.0F);
+    }
+    light.range = linear > 0.0F ? (1.0F / linear) : 50.0F;
+    light.direction = NormalizeSafe(ctx.conv.r * Vec3(0.0F, -1.0F, 0.0F));
+    light.innerCone = 6.28318530718F;
+    light.outerCone = 6.28318530718F;
+    if (light.type == LightType::kSpot) {
+      light.innerCone = props.Float("InnerAngle").value_or(0.0F) * kDegToRad;
+      light.outerCone = props.Float("OuterAngle").value_or(45.0F) * kDegToRad;
+    }
+    ctx.dst.nodes[node].light = static_cast<LightId>(ctx.dst.lights.size());
+    ctx.dst.lights.push_back(light);
+  }
+  return true;
+}
+
+Vec3 NormalizeOrKeep(const Vec3& v) {
+  const float length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+  return length == 0.0F ? v : v * (1.0F / length);
+}
+
+// Assimp's quad split: fan from the concave corner, if there is one.
+uint32_t QuadStart(const Vec3* p) {
+  for (uint32_t i = 0; i < 4; ++i) {
+    const Vec3 left = NormalizeOrKeep(p[(i + 3) % 4] - p[i]);
+    const Vec3 diag = NormalizeOrKeep(p[(i + 2) % 4] - p[i]);
+    const Vec3 right = NormalizeOrKeep(p[(i + 1) % 4] - p[i]);
+    const float angle = std::acos(left.x * diag.x + left.y * diag.y + left.z * diag.z) +
+                        std::acos(right.x * diag.x + right.y * diag.y + right.z * diag.z);
+    if (angle > kTriangulatePi) {
+      return i;
+    }
+  }
+  return 0;
+}
+
+struct BoneWeights {
+  std::string name;
+  Mat4 offset{1.0F};  // FBX space
+  std::vector<std::pair<uint32_t, float>> weights;  // (mesh vertex, weight)
+};
+
+// aiProcess_LimitBoneWeights: only vertices over the limit are trimmed and renormalized, and then
+// every bone's list is rebuilt in vertex order and bones left without weights are dropped.
+void LimitBoneWeights(std::vector<BoneWeights>& bones, size_t vertexCount, uint32_t maxWeights) {
+  std::vector<std::vector<std::pair<uint32_t, float>>> perVertex(vertexCount);  // (bone, weight)
+  size_t most = 0;
+  for (uint32_t b = 0; b < bones.size(); ++b) {
+    for (const auto& [vertex, weight] : bones[b].weights) {
+      perVertex[vertex].emplace_back(b, weight);
+      most = std::max(most, perVertex[vertex].size());
+    }
+  }
+  if (most <= maxWeights) {
+    return;
+  }
+  for (auto& weights : perVertex) {
+    if (weights.size() <= maxWeights) {
+      continue;
+    }
+    std::stable_sort(weights.begin(), weights.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+    weights.resize(maxWeights);
+    float sum = 0.0F;
+    for (const auto& w : weights) {
+      sum += w.second;
+    }
+    if (sum != 0.0F) {
+      const float invSum = 1.0F / sum;
+      for (auto& w : weights) {
+        w.second *= invSum;
+      }
+    }
+  }
+  for (BoneWeights& bone : bones) {
+    bone.weights.clear();
+  }
+  for (uint32_t v = 0; v < perVertex.size(); ++v) {
+    for (const auto& [bone, weight] : perVertex[v]) {
+      bones[bone].weights.emplace_back(v, weight);
+    }
+  }
+  std::erase_if(bones, [](const BoneWeights& bone) { return bone.weights.empty(); });
+}
+
+struct SkeletonBuild {
+  Skeleton skeleton;
+  std::vector<SkinId> skins;
+};
+
+bool ImportMesh(FbxContext& ctx, const MeshPart& part, SkeletonBuild& build, Vec3Soa& soa) {
+  const FbxGeometry& geo = ctx.geometries[part.geometry];
+  const ImportOptions& opt = *ctx.opt;
+
+  // Polygon vertices of the faces taken, in face order.
+  std::vector<uint32_t> source;
+  std::vector<uint32_t> faceStart;
+  std::vector<uint32_t> faceSize;
+  std::vector<uint32_t> outOf;  // polygon vertex -> mesh vertex, UINT32_MAX when not taken
+  if (!part.allFaces) {
+    outOf.assign(geo.vertices.size(), UINT32_MAX);
+  }
+  uint32_t cursor = 0;
+  for (size_t f = 0; f < geo.faceSizes.size(); ++f) {
+    const uint32_t size = geo.faceSizes[f];
+    if (part.allFaces || geo.materials[f] == part.materialIndex) {
+      faceStart.push_back(static_cast<uint32_t>(source.size()));
+      faceSize.push_back(size);
+      for (uint32_t k = 0; k < size; ++k) {
+        if (!part.allFaces) {
+          outOf[cursor + k] = static_cast<uint32_t>(source.size());
+        }
+        source.push_back(cursor + k);
+      }
+    }
+    cursor += size;
+  }
+
+  Mesh mesh;
+  mesh.name = !geo.name.empty() ? geo.name : ctx.dst.nodes[part.node].name;
+  mesh.vertices.resize(source.size());
+  const size_t count = source.size();
+
+  bool authoredNormals = !geo.normals.empty();
+  for (size_t v = 0; authoredNormals && v < count; ++v) {
+    const Vec3& n = geo.normals[source[v]];
+    const float lengthSq = n.x * n.x + n.y * n.y + n.z * n.z;
+    authoredNormals = std::isfinite(lengthSq) && lengthSq >= 1e-12F;
+  }
+  soa.Resize(count);
+  for (size_t v = 0; v < count; ++v) {
+    const Vec3& p = geo.vertices[source[v]];
+    soa.x[v] = p.x;
+    soa.y[v] = p.y;
+    soa.z[v] = p.z;
+  }
+  TransformPoints(ctx.conv.c, soa, soa);
+  for (size_t v = 0; v < count; ++v) {
+    mesh.vertices[v].position = soa.Get(v);
+  }
+  if (authoredNormals) {
+    for (size_t v = 0; v < count; ++v) {
+      const Vec3& n = geo.normals[source[v]];
+      soa.x[v] = n.x;
+      soa.y[v] = n.y;
+      soa.z[v] = n.z;
+    }
+    TransformDirections(ctx.conv.normalXform, soa, Vec3(0.0F, 1.0F, 0.0F), soa);
+    for (size_t v = 0; v < count; ++v) {
+      mesh.vertices[v].normal = soa.Get(v);
+    }
+  }
+  if (!geo.uvs.empty()) {
+    for (size_t v = 0; v < count; ++v) {
+      const Vec2& uv = geo.uvs[source[v]];
+      mesh.vertices[v].uv0 = Vec2(uv.x, 1.0F - uv.y);
+    }
+  }
+
+  mesh.indices.reserve(count * 3 / 2);
+  for (size_t f = 0; f < faceStart.size(); ++f) {
+    const uint32_t first = faceStart[f];
+    if (faceSize[f] == 3) {
+      mesh.indices.insert(mesh.indices.end(), {first, first + 1, first + 2});
+      continue;
+    }
+    const Vec3 corners[4] = {geo.vertices[source[first]], geo.vertices[source[first + 1]],
+                             geo.vertices[source[first + 2]], geo.vertices[source[first + 3]]};
+    const uint32_t s = QuadStart(corners);
+    const auto at = [&](uint32_t k) { return first + (s + k) % 4; };
+    mesh.indices.insert(mesh.indices.end(), {at(0), at(1), at(2), at(0), at(2), at(3)});
+  }
+  if (!mesh.vertices.empty()) {
+    Vec3 minP = mesh.vertices[0].position;
+    Vec3 maxP = mesh.vertices[0].position;
+    for (const VertexSkinned& v : mesh.vertices) {
+      minP = glm::min(minP, v.position);
+      maxP = glm::max(maxP, v.position);
+    }
+    mesh.localBounds = {minP, maxP};
+  }
+
+  // One bone per cluster, weighting every taken polygon vertex of each control point it lists.
+  std::vector<BoneWeights> bones;
+  if (!geo.clusters.empty()) {
+    const Mat4& meshGlobal = ctx.modelGlobal.at(part.model);
+    for (const FbxCluster& cluster : geo.clusters) {
+      BoneWeights& bone = bones.emplace_back();
+      bone.name = cluster.bone;
+      bone.offset = glm::inverse(cluster.transformLink) * meshGlobal;
+      for (size_t i = 0; i < cluster.indices.size(); ++i) {
+        const uint32_t point = static_cast<uint32_t>(cluster.indices[i]);
+        for (uint32_t j = geo.mappingOffsets[point]; j < geo.mappingOffsets[point] + geo.mappingCounts[point]; ++j) {
+          const uint32_t out = part.allFaces ? geo.mappings[j] : outOf[geo.mappings[j]];
+          if (out != UINT32_MAX) {
+            bone.weights.emplace_back(out, cluster.weights[i]);
+          }
+        }
+      }
+    }
+    LimitBoneWeights(bones, count, opt.maxBoneInfluence);
+  }
+
+  Skeleton& skeleton = build.skeleton;
+  std::vector<std::vector<std::pair<uint32_t, float>>> influences(count);
+  for (const BoneWeights& srcBone : bones) {
+    uint32_t boneIndex = 0;
+    const auto it = skeleton.boneMap.find(srcBone.name);
+    if (it == skeleton.boneMap.end()) {
+      Bone bone;
+      bone.name = srcBone.name;
+      const auto nodeIt = ctx.nodeByName.find(srcBone.name);
+      bone.node = nodeIt != ctx.nodeByName.end() ? nodeIt->second : kInvalidNodeId;
+      bone.inverseBind = ctx.conv.c * srcBone.offset * ctx.conv.cInv;
+      bone.globalBind = glm::inverse(bone.inverseBind);
+      boneIndex = static_cast<uint32_t>(skeleton.bones.size());
+      skeleton.boneMap[srcBone.name] = boneIndex;
+      skeleton.bones.push_back(std::move(bone));
+    } else {
+      boneIndex = it->second;
+    }
+    for (const auto& [vertex, weight] : srcBone.weights) {
+      influences[vertex].push_back({boneIndex, weight});
+    }
+  }
+  for (size_t v = 0; v < count; ++v) {
+    auto& inf = influences[v];
+    if (inf.empty()) {
+      mesh.vertices[v].joints = {0, 0, 0, 0};
+      mesh.vertices[v].weights = {1.0F, 0.0F, 0.0F, 0.0F};
+      continue;
+    }
+    if (inf.size() > opt.maxBoneInfluence) {
+      inf.resize(opt.maxBoneInfluence);
+    }
+    const PackedInfluence4 packed = NormalizeInfluences4(inf);
+    mesh.vertices[v].joints = packed.joints;
+    mesh.vertices[v].weights = packed.weights;
+  }
+  const bool skinned = !bones.empty();
+  std::vector<uint32_t> skinJoints;
+  if (skinned) {
+    skinJoints = CompactJoints(mesh.vertices);
+  }
+
+  Submesh submesh;
+  submesh.indexCount = static_cast<uint32_t>(mesh.indices.size());
+  submesh.material = std::min(ctx.materialIds.at(part.materialSource), static_cast<MaterialId>(ctx.dst.materials.size() - 1));
+  mesh.submeshes.push_back(submesh);
+  FinishImportedMesh(mesh, opt, authoredNormals, false, ctx.report);
+
+  const MeshId meshId = static_cast<MeshId>(ctx.dst.meshes.size());
+  ctx.dst.meshes.push_back(std::move(mesh));
+  NodeId node = part.node;
+  if (!ctx.dst.nodes[node].mesh.has_value()) {
+    ctx.dst.nodes[node].mesh = meshId;
+  } else {
+    Node extra;
+    extra.name = ctx.dst.nodes[node].name + "_mesh_" + std::to_string(meshId);
+    extra.parent = node;
+    extra.localCurrent = extra.localBind;
+    extra.worldCurrent = ctx.dst.nodes[node].worldCurrent;
+    extra.mesh = meshId;
+    const NodeId extraId = static_cast<NodeId>(ctx.dst.nodes.size());
+    ctx.dst.nodes.push_back(std::move(extra));
+    ctx.dst.nodes[node].children.push_back(extraId);
+    node = extraId;
+  }
+  if (skinned) {
+    Skin skin;
+    skin.mesh = meshId;
+    skin.joints = std::move(skinJoints);
+    const SkinId skinId = static_cast<SkinId>(ctx.dst.skins.size());
+    ctx.dst.skins.push_back(std::move(skin));
+    build.skins.push_back(skinId);
+    ctx.dst.nodes[node].skin = skinId;
+  }
+  return true;
+}
+
+// Parents follow the node hierarchy; the first bone without a bone ancestor roots the skeleton.
+void BuildSkeleton(FbxContext& ctx, SkeletonBuild& build) {
+  Skeleton& skeleton = build.skeleton;
+  if (skeleton.bones.empty()) {
+    return;
+  }
+  skeleton.name = "FBXSkeleton";
+  for (size_t i = 0; i < skeleton.bones.size(); ++i) {
+    const NodeId nodeId = skeleton.bones[i].node;
+    int32_t parentBone = -1;
+    NodeId walk = nodeId;
+    while (walk != kInvalidNodeId && parentBone < 0) {
+      walk = ctx.dst.nodes[walk].parent;
+      for (size_t b = 0; walk != kInvalidNodeId && b < skeleton.bones.size(); ++b) {
+        if (skeleton.bones[b].node == walk) {
+          parentBone = static_cast<int32_t>(b);
+          break;
+        }
+      }
+    }
+    skeleton.bones[i].parentBone = parentBone;
+    if (parentBone < 0 && skeleton.rootNode == kInvalidNodeId) {
+      skeleton.rootNode = nodeId;
+    }
+  }
+  const SkeletonId skeletonId = static_cast<SkeletonId>(ctx.dst.skeletons.size());
+  ctx.dst.skeletons.push_back(std::move(skeleton));
+  for (const SkinId skinId : build.skins) {
+    Skin& skin = ctx.dst.skins[skinId];
+    skin.skeleton = skeletonId;
+    skin.palette.resize(skin.joints.size(), Mat4(1.0F));
+  }
+}
+
+double FrameRate(const FbxDocument& doc) {
+  const PropertyTable settings(doc.Root("GlobalSettings"), nullptr);
+  constexpr double kRates[] = {1.0, 120.0, 100.0, 60.0, 50.0, 48.0, 30.0, 30.0, 29.9700262, 29.9700262, 25.0, 24.0, 1000.0, 23.976};
+  int64_t mode = settings.Int("TimeMode").value_or(0);
+  mode = mode < 0 || mode > 14 ? 0 : mode;  // out-of-range enums read as the default
+  if (mode == 14) {
+    return settings.Float("CustomFrameRate").value_or(-1.0F);
+  }
+  return kRates[mode];
+}
+
+struct KeyframeList {
+  std::vector<int64_t> times;
+  std::vector<float> values;
+  uint32_t component = 0;
+};
+
+struct ChannelKeys {
+  std::string name;
+  std::vector<double> times;  // frames
+  std::vector<Vec3> positions;
+  std::vector<Quat> rotations;
+  std::vector<Vec3> scales;
+};
+
+// Curves of a curve node by channel ("d|X", ...), the last link per channel winning.
+std::map<std::string_view, int64_t> CurvesOf(const FbxIndex& index, int64_t curveNode) {
+  std::map<std::string_view, int64_t> curves;
+  for (const FbxLink& link : index.LinksTo(curveNode)) {
+    if (!link.property.empty() && index.Is(link.object, "AnimationCurve")) {
+      curves[link.property] = link.object;
+    }
+  }
+  return curves;
+}
+
+bool ReadCurve(FbxContext& ctx, int64_t curve, std::vector<int64_t>& times, std::vector<float>& values) {
+  const FbxNode& record = *ctx.index->Find(curve)->record;
+  const FbxNode* keyTime = record.Child("KeyTime");
+  const FbxNode* keyValue = record.Child("KeyValueFloat");
+  if (keyTime == nullptr || keyValue == nullptr || !keyTime->ReadArray(0, times) || !keyValue->ReadArray(0, values) ||
+      times.empty() || times.size() != values.size()) {
+    return ctx.Fail("FBX animation curve unreadable");
+  }
+  for (size_t i = 1; i < times.size(); ++i) {
+    if (times[i] <= times[i - 1]) {
+      return ctx.Fail("FBX animation curve keys out of order");
+    }
+  }
+  return true;
+}
+
+int ComponentOf(std::string_view channel) {
+  return channel == "d|X" ? 0 : channel == "d|Y" ? 1 : channel == "d|Z" ? 2 : -1;
+}
+
+// Keys inside the stack's window, widened by Assimp's slack. Rotation curves also get keys
+// inserted wherever consecutive values are 180 degrees or more apart, so the later per-key quaternions
+// keep the direction of travel.
+bool KeyframeLists(FbxContext& ctx, const std::vector<int64_t>& curveNodes, int64_t start, int64_t stop, bool rotation,
+                   std::vector<KeyframeList>& out) {
+  const int64_t first = start - kKeyWindowSlack;
+  const int64_t last = stop + kKeyWindowSlack;
+  const auto inside = [&](int64_t t) { return t >= first && t <= last; };
+  std::vector<int64_t> times;
+  std::vector<float> values;
+  for (const int64_t curveNode : curveNodes) {
+    for (const auto& [channel, curve] : CurvesOf(*ctx.index, curveNode)) {
+      const int component = ComponentOf(channel);
+      if (component < 0) {
+        continue;
+      }
+      if (!ReadCurve(ctx, curve, times, values)) {
+        return false;
+      }
+      KeyframeList& list = out.emplace_back();
+      list.component = static_cast<uint32_t>(component);
+      if (!rotation) {
+        for (size_t n = 0; n < times.size(); ++n) {
+          if (inside(times[n])) {
+            list.times.push_back(times[n]);
+            list.values.push_back(values[n]);
+          }
+        }
+        continue;
+      }
+      int64_t tp = times[0];
+      float vp = values[0];
+      list.times.push_back(tp);
+      list.values.push_back(vp);
+      if (times.size() < 2) {
+        continue;
+      }
+      int64_t tc = times[1];
+      float vc = values[1];
+      for (size_t n = 1; n < times.size(); ++n) {
+        while (std::abs(vc - vp) >= 180.0F) {
+          const double step = std::floor(static_cast<double>(tc - tp) / std::abs(vc - vp) * 179.0F);
+          const int64_t tnew = tp + static_cast<int64_t>(step);
+          const float vnew = vp + (vc - vp) * static_cast<float>(step / static_cast<double>(tc - tp));
+          if (step <= 0.0 || !inside(tnew)) {
+            break;
+          }
+          list.times.push_back(tnew);
+          list.values.push_back(vnew);
+          tp = tnew;
+          vp = vnew;
+        }
+        if (inside(tc)) {
+          list.times.push_back(tc);
+          list.values.push_back(vc);
+        }
+        if (n + 1 < times.size()) {
+          tp = tc;
+          vp = vc;
+          tc = times[n + 1];
+          vc = values[n + 1];
+        }
+      }
+    }
+  }
+  return true;
+}
+
+// Linear interpolation of every list at every key time; components without a list keep `fallback`.
+std::vector<Vec3> InterpolateKeys(const std::vector<int64_t>& keyTimes, const std::vector<KeyframeList>& inputs,
+                                  const Vec3& fallback, double fps, std::vector<double>& frames, double& minTime,
+                                  double& maxTime) {
+  std::vector<Vec3> out(keyTimes.size());
+  std::vector<size_t> next(inputs.size(), 0);
+  frames.resize(keyTimes.size());
+  for (size_t k = 0; k < keyTimes.size(); ++k) {
+    const int64_t time = keyTimes[k];
+    Vec3 result = fallback;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      const KeyframeList& list = inputs[i];
+      const size_t size = list.times.size();
+      if (size == 0) {
+        continue;
+      }
+      if (next[i] < size && list.times[next[i]] == time) {
+        ++next[i];
+      }
+      const size_t id0 = next[i] > 0 ? next[i] - 1 : 0;
+      const size_t id1 = next[i] == size ? size - 1 : next[i];
+      const int64_t timeA = list.times[id0];
+      const int64_t timeB = list.times[id1];
+      const float factor =
+          timeB == timeA ? 0.0F : static_cast<float>(time - timeA) / static_cast<float>(timeB - timeA);
+      result[list.component] = list.values[id0] + (list.values[id1] - list.values[id0]) * factor;
+    }
+    frames[k] = static_cast<double>(time) / kFbxTicksPerSecond * fps;
+    minTime = std::min(minTime, frames[k]);
+    maxTime = std::max(maxTime, frames[k]);
+    out[k] = result;
+  }
+  return out;
+}
+
+// A single-key curve node repeating the bind value adds nothing; Assimp ignores it when deciding
+// whether a model is animated at all.
+bool IsRedundant(FbxContext& ctx, const std::vector<int64_t>& curveNodes, const Vec3& bindValue) {
+  if (curveNodes.size() > 1) {
+    return false;
+  }
+  const std::map<std::string_view, int64_t> curves = CurvesOf(*ctx.index, curveNodes.front());
+  Vec3 value(0.0F);
+  for (int c = 0; c < 3; ++c) {
+    const auto it = curves.find(c == 0 ? "d|X" : c == 1 ? "d|Y" : "d|Z");
+    std::vector<int64_t> times;
+    std::vector<float> values;
+    if (it == curves.end() || !ReadCurve(ctx, it->second, times, values) || values.size() != 1) {
+      return false;
+    }
+    value[c] = values[0];
+  }
+  const Vec3 d = value - bindValue;
+  return d.x * d.x + d.y * d.y + d.z * d.z < std::numeric_limits<float>::epsilon();
+}
+
+// Assimp's GenerateSimpleNodeAnim for one model: every channel sampled at the union of key times,
+// rotations built per key from Euler angles, then T * R * S decomposed back into keys.
+bool GenerateChannel(FbxContext& ctx, const std::string& name, int64_t model,
+                     const std::vector<std::pair<int64_t, std::string_view>>& curveNodes, int64_t start, int64_t stop,
+                     double fps, double& minTime, double& maxTime, std::vector<ChannelKeys>& channels) {
+  std::map<std::string_view, std::vector<int64_t>> byProperty;
+  for (const auto& [curveNode, property] : curveNodes) {
+    if (!CurvesOf(*ctx.index, curveNode).empty()) {
+      byProperty[property].push_back(curveNode);
+    }
+  }
+  const PropertyTable props(ctx.index->Find(model)->record, &ctx.modelTemplate);
+  const Vec3 bindTranslation = props.Vector("Lcl Translation").value_or(Vec3(0.0F));
+  const Vec3 bindRotation = props.Vector("Lcl Rotation").value_or(Vec3(0.0F));
+  const Vec3 bindScaling = props.Vector("Lcl Scaling").value_or(Vec3(1.0F));
+  const int64_t order = props.Int("RotationOrder").value_or(0);
+  if (order < 0 || order > 5) {
+    return ctx.Fail("FBX model '" + name + "' has an unsupported rotation order");
+  }
+
+  constexpr const char* kComponents[3] = {"Lcl Translation", "Lcl Rotation", "Lcl Scaling"};
+  const Vec3 bind[3] = {bindTranslation, bindRotation, bindScaling};
+  std::vector<KeyframeList> lists[3];
+  bool hasAny = false;
+  std::vector<int64_t> keyTimes;
+  for (int c = 0; c < 3; ++c) {
+    const auto it = byProperty.find(kComponents[c]);
+    if (it == byProperty.end()) {
+      continue;
+    }
+    hasAny = hasAny || !IsRedundant(ctx, it->second, bind[c]);
+    if (!KeyframeLists(ctx, it->second, start, stop, c == 1, lists[c])) {
+      return false;
+    }
+    for (const KeyframeList& list : lists[c]) {
+      keyTimes.insert(keyTimes.end(), list.times.begin(), list.times.end());
+    }
+    std::sort(keyTimes.begin(), keyTimes.end());
+    keyTimes.erase(std::unique(keyTimes.begin(), keyTimes.end()), keyTimes.end());
+  }
+  if (!ctx.error.empty()) {
+    return false;  // a curve IsRedundant read was malformed
+  }
+  if (!hasAny || keyTimes.empty()) {
+    return true;
+  }
+
+  const size_t keyCount = keyTimes.size();
+  std::vector<double> frames(keyCount);
+  for (size_t k = 0; k < keyCount; ++k) {
+    frames[k] = static_cast<double>(keyTimes[k]) / kFbxTicksPerSecond * fps;
+  }
+  std::vector<Vec3> translations(keyCount, bindTranslation);
+  std::vector<Quat> rotations(keyCount, EulerToQuat(order, bindRotation));
+  std::vector<Vec3> scales(keyCount, bindScaling);
+  if (!lists[0].empty()) {
+    translations = InterpolateKeys(keyTimes, lists[0], bindTranslation, fps, frames, minTime, maxTime);
+  }
+  if (!lists[1].empty()) {
+    const std::vector<Vec3> euler = InterpolateKeys(keyTimes, lists[1], bindRotation, fps, frames, minTime, maxTime);
+    Quat last(1.0F, 0.0F, 0.0F, 0.0F);
+    for (size_t k = 0; k < keyCount; ++k) {
+      Quat q = EulerToQuat(order, euler[k]);
+      if (q.x * last.x + q.y * last.y + q.z * last.z + q.w * last.w < 0.0F) {
+        q = Quat(-q.w, -q.x, -q.y, -q.z);
+      }
+      last = q;
+      rotations[k] = q;
+    }
+  }
+  if (!lists[2].empty()) {
+    scales = InterpolateKeys(keyTimes, lists[2], bindScaling, fps, frames, minTime, maxTime);
+  }
+  if (const std::optional<Vec3> pre = props.Vector("PreRotation"); !NearZero(pre)) {
+    const Quat preQuat = EulerToQuat(0, *pre);
+    for (Quat& q : rotations) {
+      q = preQuat * q;
+    }
+  }
+
+  ChannelKeys& channel = channels.emplace_back();
+  channel.name = name;
+  channel.times = std::move(frames);
+  channel.positions.resize(keyCount);
+  channel.rotations.resize(keyCount);
+  channel.scales.resize(keyCount);
+  for (size_t k = 0; k < keyCount; ++k) {
+    const Mat4 m =
+        glm::translate(Mat4(1.0F), translations[k]) * Mat4(glm::mat3_cast(rotations[k])) * glm::scale(Mat4(1.0F), scales[k]);
+    glm::vec3 cols[3] = {Vec3(m[0]), Vec3(m[1]), Vec3(m[2])};
+    Vec3 s(0.0F);
+    for (int c = 0; c < 3; ++c) {
+      s[c] = std::sqrt(cols[c].x * cols[c].x + cols[c].y * cols[c].y + cols[c].z * cols[c].z);
+    }
+    if (glm::determinant(glm::mat3(m)) < 0.0F) {
+      s = -s;
+    }
+    for (int c = 0; c < 3; ++c) {
+      if (s[c] != 0.0F) {
+        cols[c] *= 1.0F / s[c];
+      }
+    }
+    channel.positions[k] = Vec3(m[3]);
+    channel.rotations[k] = QuatFromBasis(glm::mat3(cols[0], cols[1], cols[2]));
+    channel.scales[k] = s;
+  }
+  return true;
+}
+
+// The target of a curve node: its first property link to a model, node attribute or deformer.
+std::optional<FbxLink> CurveNodeTarget(const FbxIndex& index, int64_t curveNode) {
+  for (const FbxLink& link : index.LinksFrom(curveNode)) {
+    if (!link.property.empty() &&
+        (index.Is(link.object, "Model") || index.Is(link.object, "NodeAttribute") || index.Is(link.object, "Deformer"))) {
+      return link;
+    }
+  }
+  return std::nullopt;
+}
+
+bool ImportAnimations(FbxContext& ctx, double fps) {
+  const FbxIndex& index = *ctx.index;
+  const PropertyTable* stackTemplate = index.Template("AnimationStack.FbxAnimStack");
+  Vec3Soa positions;
+  QuatSoa rotations;
+  for (const int64_t stack : index.FileOrder()) {
+    if (!index.Is(stack, "AnimationStack")) {
+      continue;
+    }
+    const std::vector<int64_t> layers = index.Sources(stack, "AnimationLayer");
+    if (layers.empty()) {
+      continue;
+    }
+    // Curve nodes per animated model, by name: channels come out sorted by node name.
+    std::map<std::string, std::pair<int64_t, std::vector<std::pair<int64_t, std::string_view>>>> byModel;
+    for (const int64_t layer : layers) {
+      for (const int64_t curveNode : index.Sources(layer, "AnimationCurveNode")) {
+        const std::optional<FbxLink> target = CurveNodeTarget(index, curveNode);
+        if (!target.has_value()) {
+          continue;
+        }
+        const std::string_view property = target->property;
+        if (!property.starts_with("Lcl Translation") && !property.starts_with("Lcl Rotation") &&
+            !property.starts_with("Lcl Scaling") && !property.starts_with("DeformPercent")) {
+          continue;
+        }
+        if (index.Is(target->object, "Deformer")) {
+          return ctx.Fail("FBX morph animation");
+        }
+        if (!index.Is(target->object, "Model")) {
+          continue;  // camera and light animation is not imported
+        }
+        auto& entry = byModel[std::string(index.Find(target->object)->name)];
+        entry.first = target->object;
+        entry.second.emplace_back(curveNode, property);
+      }
+    }
+
+    const PropertyTable props(index.Find(stack)->record, stackTemplate);
+    int64_t start = props.Time("LocalStart").value_or(0);
+    int64_t stop = props.Time("LocalStop").value_or(0);
+    const bool hasLocalRange = start != 0 || stop != 0;
+    if (!hasLocalRange) {
+      start = std::numeric_limits<int64_t>::min() + 1 + 2 * kKeyWindowSlack;
+      stop = std::numeric_limits<int64_t>::max() - 2 * kKeyWindowSlack;
+    }
+    double minTime = 1e10;
+    double maxTime = -1e10;
+    std::vector<ChannelKeys> channels;
+    for (const auto& [name, entry] : byModel) {
+      if (!GenerateChannel(ctx, name, entry.first, entry.second, start, stop, fps, minTime, maxTime, channels)) {
+        return false;
+      }
+    }
+    if (channels.empty()) {
+      continue;
+    }
+    const double startFrame = hasLocalRange ? static_cast<double>(start) / kFbxTicksPerSecond * fps : minTime;
+    const double stopFrame = hasLocalRange ? static_cast<double>(stop) / kFbxTicksPerSecond * fps : maxTime;
+    const double duration = stopFrame - startFrame;
+
+    AnimationClip clip;
+    clip.name = std::string(index.Find(stack)->name);
+    if (clip.name.empty()) {
+      clip.name = "Clip_" + std::to_string(ctx.dst.clips.size());
+    }
+    const float ticksPerSec = fps > 0.0 ? static_cast<float>(fps) : 30.0F;
+    clip.ticksPerSec = ticksPerSec;
+    clip.durationSec = duration > 0.0 ? static_cast<float>(duration / ticksPerSec) : 0.0F;
+    for (const ChannelKeys& channel : channels) {
+      const auto nodeIt = ctx.nodeByName.find(channel.name);
+      if (nodeIt == ctx.nodeByName.end()) {
+        continue;
+      }
+      const size_t keyCount = channel.times.size();
+      positions.Resize(keyCount);
+      rotations.Resize(keyCount);
+      for (size_t k = 0; k < keyCount; ++k) {
+        positions.x[k] = channel.positions[k].x;
+        positions.y[k] = channel.positions[k].y;
+        positions.z[k] = channel.positions[k].z;
+        rotations.x[k] = channel.rotations[k].x;
+        rotations.y[k] = channel.rotations[k].y;
+        rotations.z[k] = channel.rotations[k].z;
+        rotations.w[k] = channel.rotations[k].w;
+      }
+      TransformPoints(ctx.conv.c, positions, positions);
+      ConvertRotations(ctx.conv.rotation, rotations, rotations);
+
+      NodeTrack track;
+      track.node = nodeIt->second;
+      track.posKeys.resize(keyCount);
+      track.rotKeys.resize(keyCount);
+      track.sclKeys.resize(keyCount);
+      for (size_t k = 0; k < keyCount; ++k) {
+        const float time = static_cast<float>((channel.times[k] - startFrame) / ticksPerSec);
+        track.posKeys[k] = {.time = time, .value = positions.Get(k)};
+        track.rotKeys[k] = {.time = time, .value = rotations.Get(k)};
+        track.sclKeys[k] = {.time = time, .value = channel.scales[k]};
+      }
+      clip.tracks.push_back(std::move(track));
+    }
+    ctx.dst.clips.push_back(std::move(clip));
+  }
+  return true;
+}
+
+}  // namespace
+
+LoadResult<Scene> FbxImporter::Import(const std::string& path, const ImportOptions& opt, ImportReport* report) const {
+  ImportReportTotals totals(report, opt);
+  const auto fail = [&](const std::string& error) {
+    totals.Finish(path, nullptr, error);
+    return LoadResult<Scene>{.value = std::nullopt, .error = error};
+  };
+
+  MappedFile file;
+  {
+    ScopedImportStage stage(report, "read_file");
+    if (!file.Open(path)) {
+      return fail("failed to read " + path);
+    }
+    stage.AddItems(file.Size());
+  }
+  FbxDocument doc;
+  std::string error;
+  {
+    ScopedImportStage stage(report, "parse");
+    if (!doc.Parse(file.Data(), file.Size(), error)) {
+      return fail(error);
+    }
+  }
+  {
+    ScopedImportStage stage(report, "inflate_arrays");
+    uint64_t decodedBytes = 0;
+    const bool ok = doc.DecodeArrays(error, &decodedBytes);
+    stage.AddItems(decodedBytes);
+    if (!ok) {
+      return fail(error);
+    }
+  }
+  FbxIndex index;
+  if (!index.Build(doc, error)) {
+    return fail(error);
+  }
+
+  FbxContext ctx;
+  ctx.index = &index;
+  ctx.opt = &opt;
+  ctx.report = report;
+  ctx.conv = BuildConversion(doc, opt, error);
+  if (!error.empty()) {
+    return fail(error);
+  }
+  if (const PropertyTable* modelTemplate = index.Template("Model.FbxNode")) {
+    ctx.modelTemplate = *modelTemplate;
+  }
+  ctx.sourceDir = std::filesystem::absolute(std::filesystem::path(path)).parent_path();
+  if (!opt.assetRoot.empty()) {
+    ScopedImportStage stage(report, "asset_index");
+    AssetDirectoryIndex::Global().AddRoot(opt.assetRoot);
+  }
+
+  AddDefaultTextures(ctx.dst);
+  {
+    ScopedImportStage stage(report, "nodes");
+    const bool ok = BuildNodes(ctx);
+    stage.AddItems(ctx.dst.nodes.size());
+    if (!ok) {
+      return fail(ctx.error);
+    }
+  }
+  {
+    ScopedImportStage stage(report, "geometry");
+    ctx.geometries.resize(ctx.meshModels.size());
+    ParallelFor(ctx.geometries.size(), 1, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        ParseGeometry(index, ctx.meshModels[i].first, ctx.geometries[i]);
+      }
+    });
+    stage.AddItems(ctx.geometries.size());
+    for (const FbxGeometry& geo : ctx.geometries) {
+      if (!geo.error.empty()) {
+        return fail(geo.error);
+      }
+    }
+  }
+  PlanMeshes(ctx);
+  {
+    ScopedImportStage stage(report, "materials");
+    const bool ok = ImportMaterials(ctx);
+    MarkNormalMaps(ctx.dst);
+    stage.AddItems(ctx.dst.materials.size());
+    if (!ok) {
+      return fail(ctx.error);
+    }
+  }
+  if (opt.packMaterialTextures) {
+    ScopedImportStage stage(report, "texture_pack");
+    const ImportPackStats packed = PackMaterialTextures(ctx.dst);
+    if (report != nullptr) {
+      report->packed = packed;
+    }
+    stage.AddItems(packed.materials);
+  }
+  if (opt.generateMips) {
+    ScopedImportStage stage(report, "texture_mips");
+    BuildTextureMips(ctx.dst);
+    stage.AddItems(ctx.dst.textures.size());
+  }
+  if (opt.compressTextures) {
+    ScopedImportStage stage(report, "texture_compress");
+    CompressTextures(ctx.dst, opt.textureCompression);
+    stage.AddItems(ctx.dst.textures.size());
+  }
+  if (opt.shareDecodedTextures) {
+    TextureRegistry::Global().Publish(ctx.dst.textures);
+  }
+  SkeletonBuild build;
+  {
+    ScopedImportStage stage(report, "meshes");
+    Vec3Soa soa;
+    for (const MeshPart& part : ctx.parts) {
+      if (!ImportMesh(ctx, part, build, soa)) {
+        return fail(ctx.error);
+      }
+    }
+    stage.AddItems(ctx.dst.meshes.size());
+  }
+  {
+    ScopedImportStage stage(report, "skeleton");
+    BuildSkeleton(ctx, build);
+    for (const Skeleton& skeleton : ctx.dst.skeletons) {
+      stage.AddItems(skeleton.bones.size());
+    }
+  }
+  {
+    ScopedImportStage stage(report, "animations");
+    const bool ok = ImportAnimations(ctx, FrameRate(doc));
+    stage.AddItems(ctx.dst.clips.size());
+    if (!ok) {
+      return fail(ctx.error);
+    }
+  }
+  {
+    ScopedImportStage stage(report, "lights");
+    const bool ok = ImportLights(ctx);
+    stage.AddItems(ctx.dst.lights.size());
+    if (!ok) {
+      return fail(ctx.error);
+    }
+  }
+  if (opt.pruneScene) {
+    ScopedImportStage stage(report, "prune");
+    const ImportPruneStats pruned = PruneScene(ctx.dst);
+    if (report != nullptr) {
+      report->pruned = pruned;
+    }
+    stage.AddItems(pruned.bones + pruned.nodes + pruned.tracks);
+  }
+  {
+    ScopedImportStage stage(report, "world_transforms");
+    FinalizeWorldTransforms(ctx.dst);
+  }
+
+  totals.Finish(path, &ctx.dst, {});
+  return LoadResult<Scene>{.value = std::move(ctx.dst), .error = {}};
+}
+
+}  // namespace vv
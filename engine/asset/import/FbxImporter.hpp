@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+#include "asset/import/ImportOptions.hpp"
+#include "asset/import/ImportReport.hpp"
+#include "core/types/CommonTypes.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+// Native reader for binary FBX 7.x covering the common skinned-character subset: mesh geometry
+// (triangles and quads, per-polygon-vertex or per-control-point normals and UVs, per-polygon
+// materials), one skin per mesh, the model hierarchy, Phong/Lambert materials with file or
+// embedded textures, lights and animation stacks. It reads the file through a mapping, inflates
+// the zlib arrays in parallel and writes straight into the Scene, reproducing what
+// AssimpFbxImporter builds from the same file: the same node, mesh, bone and material order, and
+// the same post-processing (UV flip, quad triangulation, bone weight limit).
+//
+// Anything outside that subset (ASCII files, pivots and geometric transforms, polygons with more
+// than four corners, blend shapes, layered textures, vendor PBR properties, non-centimeter units)
+// makes Import return an error naming it; ImportSceneFile then imports the file through Assimp.
+class FbxImporter {
+ public:
+  // `report`, when given, receives per-stage timings, heap deltas and counts (see ImportReport).
+  LoadResult<Scene> Import(const std::string& path, const ImportOptions& opt, ImportReport* report = nullptr) const;
+};
+
+}  // namespace vv
@@ -0,0 +1,1415 @@
+#include "asset/import/GltfImporter.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <glm/gtc/quaternion.hpp>
+#include <glm/matrix.hpp>
+
+#include "asset/import/ImportCommon.hpp"
+#include "asset/import/MaterialPacking.hpp"
+#include "asset/import/ScenePruning.hpp"
+#include "asset/index/AssetDirectoryIndex.hpp"
+#include "asset/mesh/MorphTargets.hpp"
+#include "asset/mesh/SkinWeight.hpp"
+#include "core/io/Json.hpp"
+#include "core/io/MappedFile.hpp"
+
+namespace vv {
+namespace {
+
+constexpr uint32_t kGlbMagic = 0x46546C67U;      // "glTF"
+constexpr uint32_t kGlbChunkJson = 0x4E4F534AU;  // "JSON"
+constexpr uint32_t kGlbChunkBin = 0x004E4942U;   // "BIN\0"
+
+constexpr uint64_t kComponentByte = 5120;
+constexpr uint64_t kComponentUnsignedByte = 5121;
+constexpr uint64_t kComponentShort = 5122;
+constexpr uint64_t kComponentUnsignedShort = 5123;
+constexpr uint64_t kComponentUnsignedInt = 5125;
+constexpr uint64_t kComponentFloat = 5126;
+
+constexpr uint64_t kModeTriangles = 4;
+constexpr uint64_t kModeTriangleStrip = 5;
+constexpr uint64_t kModeTriangleFan = 6;
+
+constexpr uint64_t kNone = UINT64_MAX;  // JsonValue::Index fallback for missing references
+
+// Required extensions the reader honors; files requiring anything else (Draco, meshopt, Basis
+// textures, texture transforms) would be misread, so they are rejected.
+constexpr std::string_view kSupportedRequiredExtensions[] = {
+    "KHR_lights_punctual",
+    "KHR_materials_emissive_strength",
+    "KHR_mesh_quantization",
+};
+
+struct ByteSpan {
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+};
+
+struct GltfDocument {
+  JsonValue json;
+  std::filesystem::path sourceDir;
+  MappedFile file;                                    // the .glb; a .gltf is closed once parsed
+  ByteSpan glbBinary;                                 // BIN chunk
+  std::vector<MappedFile> bufferFiles;                // external .bin buffers
+  std::vector<std::string> bufferPaths;               // and where they came from
+  std::vector<std::vector<uint8_t>> dataUriBuffers;   // base64 data: buffers
+  std::vector<ByteSpan> buffers;                      // by glTF buffer index
+};
+
+uint32_t ReadU32(const uint8_t* p) {
+  uint32_t value = 0;
+  std::memcpy(&value, p, sizeof(value));  // glTF is little-endian, like every supported target
+  return value;
+}
+
+std::optional<std::vector<uint8_t>> DecodeBase64(std::string_view text) {
+  std::vector<uint8_t> out;
+  out.reserve(text.size() / 4 * 3);
+  uint32_t accumulator = 0;
+  int bits = 0;
+  for (const char c : text) {
+    uint32_t value = 0;
+    if (c >= 'A' && c <= 'Z') {
+      value = static_cast<uint32_t>(c - 'A');
+    } else if (c >= 'a' && c <= 'z') {
+      value = static_cast<uint32_t>(c - 'a' + 26);
+    } else if (c >= '0' && c <= '9') {
+      value = static_cast<uint32_t>(c - '0' + 52);
+    } else if (c == '+' || c == '-') {
+      value = 62;
+    } else if (c == '/' || c == '_') {
+      value = 63;
+    } else if (c == '=') {
+      break;
+    } else {
+      return std::nullopt;
+    }
+    accumulator = (accumulator << 6U) | value;
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      out.push_back(static_cast<uint8_t>((accumulator >> static_cast<uint32_t>(bits)) & 0xFFU));
+    }
+  }
+  return out;
+}
+
+// Only base64 data URIs are valid in glTF.
+std::optional<std::vector<uint8_t>> DecodeDataUri(const std::string& uri) {
+  const size_t marker = uri.find(";base64,");
+  if (uri.rfind("data:", 0) != 0 || marker == std::string::npos) {
+    return std::nullopt;
+  }
+  return DecodeBase64(std::string_view(uri).substr(marker + 8));
+}
+
+// Relative URIs are percent-encoded ("my%20texture.png").
+std::string DecodeUriPath(const std::string& uri) {
+  std::string out;
+  out.reserve(uri.size());
+  for (size_t i = 0; i < uri.size(); ++i) {
+    if (uri[i] == '%' && i + 2 < uri.size() && std::isxdigit(static_cast<unsigned char>(uri[i + 1])) &&
+        std::isxdigit(static_cast<unsigned char>(uri[i + 2]))) {
+      out += static_cast<char>(std::stoi(uri.substr(i + 1, 2), nullptr, 16));
+      i += 2;
+    } else {
+      out += uri[i];
+    }
+  }
+  return out;
+}
+
+std::string OpenDocument(const std::string& path, GltfDocument& doc) {
+  if (!doc.file.Open(path)) {
+    return "cannot read " + path;
+  }
+  const uint8_t* data = doc.file.Data();
+  const size_t size = doc.file.Size();
+
+  std::string_view jsonText;
+  const bool glb = size >= 12 && ReadU32(data) == kGlbMagic;
+  if (glb) {
+    if (ReadU32(data + 4) != 2) {
+      return "unsupported GLB container version " + std::to_string(ReadU32(data + 4));
+    }
+    const size_t length = ReadU32(data + 8);
+    if (length > size) {
+      return "truncated GLB file";
+    }
+    size_t offset = 12;
+    while (offset + 8 <= length) {
+      const size_t chunkLength = ReadU32(data + offset);
+      const uint32_t chunkType = ReadU32(data + offset + 4);
+      offset += 8;
+      if (chunkLength > length - offset) {
+        return "truncated GLB chunk";
+      }
+      if (chunkType == kGlbChunkJson && jsonText.empty()) {
+        jsonText = std::string_view(reinterpret_cast<const char*>(data + offset), chunkLength);
+      } else if (chunkType == kGlbChunkBin && doc.glbBinary.data == nullptr) {
+        doc.glbBinary = {data + offset, chunkLength};
+      }
+      offset += (chunkLength + 3) & ~size_t{3};
+    }
+    if (jsonText.empty()) {
+      return "GLB file has no JSON chunk";
+    }
+  } else {
+    jsonText = std::string_view(reinterpret_cast<const char*>(data), size);
+    if (jsonText.substr(0, 3) == "\xEF\xBB\xBF") {
+      jsonText.remove_prefix(3);
+    }
+  }
+
+  LoadResult<JsonValue> parsed = ParseJson(jsonText);
+  if (!glb) {
+    doc.file.Close();
+  }
+  if (!parsed.Ok()) {
+    return parsed.error;
+  }
+  doc.json = std::move(*parsed.value);
+
+  const std::string& version = doc.json["asset"]["version"].String();
+  if (version.empty() || version[0] != '2') {
+    return "unsupported glTF version '" + version + "'";
+  }
+  for (const JsonValue& extension : doc.json["extensionsRequired"].items) {
+    const std::string& name = extension.String();
+    if (std::find(std::begin(kSupportedRequiredExtensions), std::end(kSupportedRequiredExtensions), name) ==
+        std::end(kSupportedRequiredExtensions)) {
+      return "unsupported required extension " + name;
+    }
+  }
+  return {};
+}
+
+std::string MapBuffers(GltfDocument& doc) {
+  const JsonValue& buffers = doc.json["buffers"];
+  for (size_t i = 0; i < buffers.Size(); ++i) {
+    const JsonValue& buffer = buffers[i];
+    const uint64_t byteLength = buffer["byteLength"].Index(0);
+    const std::string& uri = buffer["uri"].String();
+    ByteSpan span;
+    if (uri.empty()) {
+      if (i != 0 || doc.glbBinary.data == nullptr) {
+        return "buffer " + std::to_string(i) + " has no data";
+      }
+      span = doc.glbBinary;
+    } else if (uri.rfind("data:", 0) == 0) {
+      std::optional<std::vector<uint8_t>> bytes = DecodeDataUri(uri);
+      if (!bytes.has_value()) {
+        return "buffer " + std::to_string(i) + " has an unsupported data URI";
+      }
+      doc.dataUriBuffers.push_back(std::move(*bytes));
+      span = {doc.dataUriBuffers.back().data(), doc.dataUriBuffers.back().size()};
+    } else {
+      const std::filesystem::path bufferPath = doc.sourceDir / DecodeUriPath(uri);
+      MappedFile file;
+      if (!file.Open(bufferPath.string())) {
+        return "cannot read buffer " + bufferPath.string();
+      }
+      span = {file.Data(), file.Size()};
+      doc.bufferFiles.push_back(std::move(file));
+      doc.bufferPaths.push_back(bufferPath.lexically_normal().string());
+    }
+    if (span.size < byteLength) {
+      return "buffer " + std::to_string(i) + " is shorter than its byteLength";
+    }
+    span.size = byteLength;
+    doc.buffers.push_back(span);
+  }
+  return {};
+}
+
+std::optional<ByteSpan> ResolveBufferView(const GltfDocument& doc, uint64_t index, size_t* stride = nullptr) {
+  const JsonValue& view = doc.json["bufferViews"][index];
+  const uint64_t buffer = view["buffer"].Index(kNone);
+  if (buffer >= doc.buffers.size()) {
+    return std::nullopt;
+  }
+  const uint64_t offset = view["byteOffset"].Index(0);
+  const uint64_t length = view["byteLength"].Index(0);
+  const ByteSpan& bytes = doc.buffers[buffer];
+  if (offset > bytes.size || length > bytes.size - offset) {
+    return std::nullopt;
+  }
+  if (stride != nullptr) {
+    *stride = view["byteStride"].Index(0);
+  }
+  return ByteSpan{bytes.data + offset, length};
+}
+
+size_t ComponentSize(uint64_t componentType) {
+  switch (componentType) {
+    case kComponentByte:
+    case kComponentUnsignedByte:
+      return 1;
+    case kComponentShort:
+    case kComponentUnsignedShort:
+      return 2;
+    case kComponentUnsignedInt:
+    case kComponentFloat:
+      return 4;
+    default:
+      return 0;
+  }
+}
+
+uint32_t ComponentCount(const std::string& type) {
+  if (type == "SCALAR") {
+    return 1;
+  }
+  if (type == "VEC2") {
+    return 2;
+  }
+  if (type == "VEC3") {
+    return 3;
+  }
+  if (type == "VEC4" || type == "MAT2") {
+    return 4;
+  }
+  if (type == "MAT3") {
+    return 9;
+  }
+  return type == "MAT4" ? 16 : 0;
+}
+
+// A bounds-checked accessor over the mapped buffers. Elements are read in place; sparse
+// substitutions are applied after the dense pass.
+struct Accessor {
+  const uint8_t* data = nullptr;  // null: every element is zero before sparse substitution
+  size_t count = 0;
+  size_t stride = 0;
+  uint64_t componentType = kComponentFloat;
+  uint32_t components = 1;
+  bool normalized = false;
+  size_t sparseCount = 0;
+  const uint8_t* sparseIndices = nullptr;
+  uint64_t sparseIndexType = kComponentUnsignedInt;
+  const uint8_t* sparseValues = nullptr;  // tightly packed elements
+};
+
+std::optional<Accessor> ResolveAccessor(const GltfDocument& doc, uint64_t index) {
+  const JsonValue& json = doc.json["accessors"][index];
+  if (!json.IsObject()) {
+    return std::nullopt;
+  }
+  Accessor a;
+  a.count = json["count"].Index(0);
+  a.componentType = json["componentType"].Index(0);
+  a.components = ComponentCount(json["type"].String());
+  a.normalized = json["normalized"].Bool(false);
+  const size_t componentSize = ComponentSize(a.componentType);
+  if (componentSize == 0 || a.components == 0) {
+    return std::nullopt;
+  }
+  const size_t elementSize = componentSize * a.components;
+  a.stride = elementSize;
+
+  if (json.Has("bufferView")) {
+    size_t viewStride = 0;
+    const std::optional<ByteSpan> view = ResolveBufferView(doc, json["bufferView"].Index(kNone), &viewStride);
+    const uint64_t offset = json["byteOffset"].Index(0);
+    if (!view.has_value() || offset > view->size) {
+      return std::nullopt;
+    }
+    a.stride = viewStride != 0 ? viewStride : elementSize;
+    const size_t available = view->size - offset;
+    if (a.count > 0 && (a.count > available || (a.count - 1) * a.stride + elementSize > available)) {
+      return std::nullopt;
+    }
+    a.data = view->data + offset;
+  }
+
+  const JsonValue& sparse = json["sparse"];
+  if (sparse.IsObject()) {
+    a.sparseCount = sparse["count"].Index(0);
+    a.sparseIndexType = sparse["indices"]["componentType"].Index(0);
+    const size_t indexSize = ComponentSize(a.sparseIndexType);
+    const std::optional<ByteSpan> indices = ResolveBufferView(doc, sparse["indices"]["bufferView"].Index(kNone));
+    const std::optional<ByteSpan> values = ResolveBufferView(doc, sparse["values"]["bufferView"].Index(kNone));
+    const uint64_t indicesOffset = sparse["indices"]["byteOffset"].Index(0);
+    const uint64_t valuesOffset = sparse["values"]["byteOffset"].Index(0);
+    if (indexSize == 0 || a.sparseIndexType == kComponentFloat || a.sparseIndexType == kComponentByte ||
+        a.sparseIndexType == kComponentShort || !indices.has_value() || !values.has_value() ||
+        indicesOffset > indices->size || valuesOffset > values->size ||
+        a.sparseCount > (indices->size - indicesOffset) / indexSize ||
+        a.sparseCount > (values->size - valuesOffset) / elementSize) {
+      return std::nullopt;
+    }
+    a.sparseIndices = indices->data + indicesOffset;
+    a.sparseValues = values->data + valuesOffset;
+  }
+  return a;
+}
+
+std::optional<Accessor> ResolveAttribute(const GltfDocument& doc,
+                                         const JsonValue& attributes,
+                                         const char* name,
+                                         size_t expectedCount) {
+  if (!attributes.Has(name)) {
+    return std::nullopt;
+  }
+  std::optional<Accessor> accessor = ResolveAccessor(doc, attributes[name].Index(kNone));
+  if (accessor.has_value() && accessor->count != expectedCount) {
+    return std::nullopt;
+  }
+  return accessor;
+}
+
+uint32_t ReadUnsigned(const uint8_t* p, uint64_t componentType) {
+  switch (componentType) {
+    case kComponentUnsignedByte:
+      return p[0];
+    case kComponentUnsignedShort: {
+      uint16_t value = 0;
+      std::memcpy(&value, p, sizeof(value));
+      return value;
+    }
+    case kComponentUnsignedInt:
+      return ReadU32(p);
+    default:
+      return 0;
+  }
+}
+
+template <typename T>
+float ReadComponent(const uint8_t* p, bool normalized) {
+  T value;
+  std::memcpy(&value, p, sizeof(T));
+  if constexpr (std::is_floating_point_v<T>) {
+    return value;
+  } else {
+    if (!normalized) {
+      return static_cast<float>(value);
+    }
+    const float scaled = static_cast<float>(value) / static_cast<float>(std::numeric_limits<T>::max());
+    return std::is_signed_v<T> ? std::max(scaled, -1.0F) : scaled;
+  }
+}
+
+template <typename T, typename Fn>
+void ReadFloatElements(const Accessor& a, uint32_t components, Fn& store) {
+  float values[16] = {};
+  const uint32_t n = std::min(components, a.components);
+  if (a.data != nullptr) {
+    for (size_t i = 0; i < a.count; ++i) {
+      const uint8_t* element = a.data + i * a.stride;
+      for (uint32_t c = 0; c < n; ++c) {
+        values[c] = ReadComponent<T>(element + c * sizeof(T), a.normalized);
+      }
+      store(i, static_cast<const float*>(values));
+    }
+  } else {
+    for (size_t i = 0; i < a.count; ++i) {
+      store(i, static_cast<const float*>(values));
+    }
+  }
+  const size_t elementSize = sizeof(T) * a.components;
+  const size_t indexSize = ComponentSize(a.sparseIndexType);
+  for (size_t s = 0; s < a.sparseCount; ++s) {
+    const size_t index = ReadUnsigned(a.sparseIndices + s * indexSize, a.sparseIndexType);
+    if (index >= a.count) {
+      continue;
+    }
+    const uint8_t* element = a.sparseValues + s * elementSize;
+    for (uint32_t c = 0; c < n; ++c) {
+      values[c] = ReadComponent<T>(element + c * sizeof(T), a.normalized);
+    }
+    store(index, static_cast<const float*>(values));
+  }
+}
+
+// Calls store(i, const float* values) for every element, `components` values each (missing
+// components read as zero), converting integer storage (normalized or not) to float. `store` may
+// see an index twice when a sparse substitution overrides it.
+template <typename Fn>
+void ForEachFloat(const Accessor& a, uint32_t components, Fn&& store) {
+  switch (a.componentType) {
+    case kComponentFloat:
+      ReadFloatElements<float>(a, components, store);
+      break;
+    case kComponentByte:
+      ReadFloatElements<int8_t>(a, components, store);
+      break;
+    case kComponentUnsignedByte:
+      ReadFloatElements<uint8_t>(a, components, store);
+      break;
+    case kComponentShort:
+      ReadFloatElements<int16_t>(a, components, store);
+      break;
+    case kComponentUnsignedShort:
+      ReadFloatElements<uint16_t>(a, components, store);
+      break;
+    case kComponentUnsignedInt:
+      ReadFloatElements<uint32_t>(a, components, store);
+      break;
+    default:
+      break;
+  }
+}
+
+bool IsUnsignedInteger(const Accessor& a) {
+  return a.componentType == kComponentUnsignedByte || a.componentType == kComponentUnsignedShort ||
+         a.componentType == kComponentUnsignedInt;
+}
+
+// The unsigned-integer counterpart of ForEachFloat (indices, joints).
+template <typename Fn>
+void ForEachUnsigned(const Accessor& a, uint32_t components, Fn&& store) {
+  uint32_t values[4] = {};
+  const uint32_t n = std::min({components, a.components, 4U});
+  const size_t componentSize = ComponentSize(a.componentType);
+  for (size_t i = 0; i < a.count; ++i) {
+    if (a.data != nullptr) {
+      const uint8_t* element = a.data + i * a.stride;
+      for (uint32_t c = 0; c < n; ++c) {
+        values[c] = ReadUnsigned(element + c * componentSize, a.componentType);
+      }
+    }
+    store(i, static_cast<const uint32_t*>(values));
+  }
+  const size_t indexSize = ComponentSize(a.sparseIndexType);
+  for (size_t s = 0; s < a.sparseCount; ++s) {
+    const size_t index = ReadUnsigned(a.sparseIndices + s * indexSize, a.sparseIndexType);
+    if (index >= a.count) {
+      continue;
+    }
+    const uint8_t* element = a.sparseValues + s * componentSize * a.components;
+    for (uint32_t c = 0; c < n; ++c) {
+      values[c] = ReadUnsigned(element + c * componentSize, a.componentType);
+    }
+    store(index, static_cast<const uint32_t*>(values));
+  }
+}
+
+Mat4 ToMat4(const float* columnMajor) {
+  Mat4 m(1.0F);
+  for (int c = 0; c < 4; ++c) {
+    for (int r = 0; r < 4; ++r) {
+      m[c][r] = columnMajor[c * 4 + r];
+    }
+  }
+  return m;
+}
+
+Vec3 ReadVec3(const JsonValue& json, const Vec3& fallback) {
+  if (json.Size() != 3) {
+    return fallback;
+  }
+  return Vec3(json[0].Float(fallback.x), json[1].Float(fallback.y), json[2].Float(fallback.z));
+}
+
+Quat NormalizeRotation(const Quat& q) {
+  const float lengthSq = glm::dot(q, q);
+  return lengthSq > 0.0F && std::isfinite(lengthSq) ? q * (1.0F / std::sqrt(lengthSq)) : Quat(1.0F, 0.0F, 0.0F, 0.0F);
+}
+
+// Finite and not zero length; authored frames failing this are regenerated.
+bool UsableVector(const Vec3& v) {
+  const float lengthSq = glm::dot(v, v);
+  return std::isfinite(lengthSq) && lengthSq >= 1e-12F;
+}
+
+enum TextureSlot : uint32_t {
+  kSlotBaseColor,
+  kSlotMetallicRoughness,
+  kSlotNormal,
+  kSlotOcclusion,
+  kSlotEmissive,
+  kSlotCount,
+};
+
+constexpr bool kSlotSrgb[kSlotCount] = {true, false, false, false, true};
+
+const JsonValue& SlotTextureInfo(const JsonValue& material, TextureSlot slot) {
+  switch (slot) {
+    case kSlotBaseColor:
+      return material["pbrMetallicRoughness"]["baseColorTexture"];
+    case kSlotMetallicRoughness:
+      return material["pbrMetallicRoughness"]["metallicRoughnessTexture"];
+    case kSlotNormal:
+      return material["normalTexture"];
+    case kSlotOcclusion:
+      return material["occlusionTexture"];
+    case kSlotEmissive:
+    default:
+      return material["emissiveTexture"];
+  }
+}
+
+uint64_t ImageKey(uint64_t image, bool srgb) {
+  return (image << 1U) | (srgb ? 1U : 0U);
+}
+
+struct ImportedPrimitive {
+  MeshId mesh = 0;
+  bool skinned = false;
+  std::vector<uint32_t> joints;  // glTF skin joint index of each compacted vertex joint
+};
+
+struct GltfContext {
+  const GltfDocument* doc = nullptr;
+  const ImportOptions* opt = nullptr;
+  Scene dst;
+  ImportReport* report = nullptr;
+  std::string error;
+
+  std::vector<NodeId> nodeMap;                              // glTF node -> NodeId (invalid outside the scene)
+  std::vector<std::vector<ImportedPrimitive>> meshes;       // glTF mesh -> one Mesh per primitive
+  std::unordered_map<uint64_t, TextureId> textureByImage;   // ImageKey
+  MaterialId defaultMaterial = 0;
+  std::vector<SkeletonId> skinSkeleton;                     // glTF skin -> skeleton
+  std::vector<std::vector<uint32_t>> skinBones;             // glTF skin joint -> skeleton bone
+};
+
+NodeId AddNode(GltfContext& ctx, uint64_t index, NodeId parent) {
+  if (index >= ctx.nodeMap.size() || ctx.nodeMap[index] != kInvalidNodeId) {
+    return kInvalidNodeId;  // out of range, or reached twice (invalid in glTF; the first parent wins)
+  }
+  const JsonValue& src = ctx.doc->json["nodes"][index];
+  Node node;
+  node.name = src["name"].String();
+  if (node.name.empty()) {
+    node.name = "Node_" + std::to_string(index);
+  }
+  node.parent = parent;
+  if (src["matrix"].Size() == 16) {
+    float values[16];
+    for (size_t i = 0; i < 16; ++i) {
+      values[i] = src["matrix"][i].Float(i % 5 == 0 ? 1.0F : 0.0F);
+    }
+    node.localBind = DecomposeTransform(ToMat4(values));
+  } else {
+    node.localBind.translation = ReadVec3(src["translation"], Vec3(0.0F));
+    const JsonValue& r = src["rotation"];
+    if (r.Size() == 4) {
+      node.localBind.rotation = NormalizeRotation(Quat(r[3].Float(1.0F), r[0].Float(0.0F), r[1].Float(0.0F), r[2].Float(0.0F)));
+    }
+    node.localBind.scale = ReadVec3(src["scale"], Vec3(1.0F));
+  }
+  node.localCurrent = node.localBind;
+
+  const NodeId id = static_cast<NodeId>(ctx.dst.nodes.size());
+  ctx.dst.nodes.push_back(std::move(node));
+  ctx.nodeMap[index] = id;
+  if (parent == kInvalidNodeId) {
+    ctx.dst.roots.push_back(id);
+  } else {
+    ctx.dst.nodes[parent].children.push_back(id);
+  }
+  for (const JsonValue& child : src["children"].items) {
+    AddNode(ctx, child.Index(kNone), id);
+  }
+  return id;
+}
+
+void BuildNodes(GltfContext& ctx) {
+  const JsonValue& json = ctx.doc->json;
+  const size_t nodeCount = json["nodes"].Size();
+  ctx.nodeMap.assign(nodeCount, kInvalidNodeId);
+
+  const JsonValue& scene = json["scenes"][json["scene"].Index(0)];
+  if (scene.IsObject()) {
+    for (const JsonValue& root : scene["nodes"].items) {
+      AddNode(ctx, root.Index(kNone), kInvalidNodeId);
+    }
+    return;
+  }
+  // No scene: every node that is nobody's child is a root.
+  std::vector<uint8_t> isChild(nodeCount, 0);
+  for (const JsonValue& node : json["nodes"].items) {
+    for (const JsonValue& child : node["children"].items) {
+      if (child.Index(kNone) < nodeCount) {
+        isChild[child.Index(kNone)] = 1;
+      }
+    }
+  }
+  for (size_t i = 0; i < nodeCount; ++i) {
+    if (isChild[i] == 0) {
+      AddNode(ctx, i, kInvalidNodeId);
+    }
+  }
+}
+
+// Maps an image's bytes in place: a buffer view of the GLB, a decoded data URI, or the file.
+bool ReadImageSource(GltfContext& ctx, uint64_t index, SourceImage& image) {
+  const JsonValue& json = ctx.doc->json["images"][index];
+  if (json.Has("bufferView")) {
+    const std::optional<ByteSpan> view = ResolveBufferView(*ctx.doc, json["bufferView"].Index(kNone));
+    if (!view.has_value()) {
+      return false;
+    }
+    image.data = view->data;
+    image.size = view->size;
+    image.uri = "*" + std::to_string(index);
+    return true;
+  }
+  const std::string& uri = json["uri"].String();
+  if (uri.rfind("data:", 0) == 0) {
+    std::optional<std::vector<uint8_t>> bytes = DecodeDataUri(uri);
+    if (!bytes.has_value()) {
+      return false;
+    }
+    image.ownedBytes = std::move(*bytes);
+    image.data = image.ownedBytes.data();
+    image.size = image.ownedBytes.size();
+    image.uri = "*" + std::to_string(index);
+    return true;
+  }
+  const std::optional<std::filesystem::path> path = ResolveTexturePath(ctx.doc->sourceDir, DecodeUriPath(uri));
+  if (!path.has_value() || !image.file.Open(path->string())) {
+    return false;
+  }
+  image.data = image.file.Data();
+  image.size = image.file.Size();
+  image.path = path->string();
+  image.uri = image.path;
+  return true;
+}
+
+// Every image the materials reference is mapped, then hashed and decoded by AppendSourceImages;
+// textures come out in first-reference order, one per image and color space.
+void ImportTextures(GltfContext& ctx) {
+  const JsonValue& json = ctx.doc->json;
+  std::vector<SourceImageRequest> requests;  // first-reference order
+  std::vector<SourceImage> images(json["images"].Size());
+  std::vector<uint8_t> needed(images.size(), 0);
+  for (const JsonValue& material : json["materials"].items) {
+    for (uint32_t slot = 0; slot < kSlotCount; ++slot) {
+      const JsonValue& info = SlotTextureInfo(material, static_cast<TextureSlot>(slot));
+      if (!info.IsObject()) {
+        continue;
+      }
+      const uint64_t image = json["textures"][info["index"].Index(kNone)]["source"].Index(kNone);
+      const bool srgb = kSlotSrgb[slot];
+      const auto same = [&](const SourceImageRequest& r) { return r.image == image && r.srgb == srgb; };
+      if (image < images.size() && std::none_of(requests.begin(), requests.end(), same)) {
+        requests.push_back({.image = static_cast<size_t>(image), .srgb = srgb});
+        needed[image] = 1;
+      }
+    }
+  }
+
+  {
+    ScopedImportStage stage(ctx.report, "texture_read", "materials");
+    for (size_t i = 0; i < images.size(); ++i) {
+      if (needed[i] != 0 && ReadImageSource(ctx, i, images[i])) {
+        stage.AddItems(images[i].size);
+      }
+    }
+  }
+
+  const std::vector<std::optional<TextureId>> textures = AppendSourceImages(ctx.dst, images, requests, *ctx.opt, ctx.report);
+  for (size_t r = 0; r < requests.size(); ++r) {
+    if (textures[r].has_value()) {
+      ctx.textureByImage[ImageKey(requests[r].image, requests[r].srgb)] = *textures[r];
+    }
+  }
+}
+
+TextureId SlotTexture(const GltfContext& ctx, const JsonValue& material, TextureSlot slot, TextureId fallback) {
+  const JsonValue& info = SlotTextureInfo(material, slot);
+  if (!info.IsObject()) {
+    return fallback;
+  }
+  const uint64_t image = ctx.doc->json["textures"][info["index"].Index(kNone)]["source"].Index(kNone);
+  const auto it = ctx.textureByImage.find(ImageKey(image, kSlotSrgb[slot]));
+  return it != ctx.textureByImage.end() ? it->second : fallback;
+}
+
+void ImportMaterials(GltfContext& ctx) {
+  const JsonValue& json = ctx.doc->json;
+  ImportTextures(ctx);
+
+  const JsonValue& materials = json["materials"];
+  for (size_t i = 0; i < materials.Size(); ++i) {
+    const JsonValue& src = materials[i];
+    const JsonValue& pbr = src["pbrMetallicRoughness"];
+    Material out = MakeDefaultMaterial(src["name"].String());
+    if (out.name.empty()) {
+      out.name = "Material_" + std::to_string(i);
+    }
+    const JsonValue& baseColor = pbr["baseColorFactor"];
+    if (baseColor.Size() == 4) {
+      out.baseColorFactor =
+          Vec4(baseColor[0].Float(1.0F), baseColor[1].Float(1.0F), baseColor[2].Float(1.0F), baseColor[3].Float(1.0F));
+    }
+    out.metallicFactor = pbr["metallicFactor"].Float(1.0F);  // glTF defaults to fully metallic
+    out.roughnessFactor = pbr["roughnessFactor"].Float(1.0F);
+    out.emissiveFactor = ReadVec3(src["emissiveFactor"], Vec3(0.0F));
+    out.emissiveStrength = src["extensions"]["KHR_materials_emissive_strength"]["emissiveStrength"].Float(1.0F);
+    out.normalScale = src["normalTexture"]["scale"].Float(1.0F);
+    out.occlusionStrength = src["occlusionTexture"]["strength"].Float(1.0F);
+    out.alphaMask = src["alphaMode"].String() == "MASK";
+    out.alphaCutoff = src["alphaCutoff"].Float(0.5F);
+
+    out.baseColorTex = SlotTexture(ctx, src, kSlotBaseColor, kDefaultWhiteSrgb);
+    out.metallicRoughnessTex = SlotTexture(ctx, src, kSlotMetallicRoughness, kDefaultWhiteLinear);
+    out.normalTex = SlotTexture(ctx, src, kSlotNormal, kDefaultNormal);
+    out.occlusionTex = SlotTexture(ctx, src, kSlotOcclusion, kDefaultWhiteLinear);
+    out.emissiveTex = SlotTexture(ctx, src, kSlotEmissive, kDefaultBlackLinear);
+    ctx.dst.materials.push_back(std::move(out));
+  }
+
+  // Primitives without a material (or files without any) use a default one after the rest.
+  bool needsDefault = materials.Size() == 0;
+  for (const JsonValue& mesh : json["meshes"].items) {
+    for (const JsonValue& primitive : mesh["primitives"].items) {
+      needsDefault = needsDefault || primitive["material"].Index(kNone) >= materials.Size();
+    }
+  }
+  if (needsDefault) {
+    ctx.defaultMaterial = static_cast<MaterialId>(ctx.dst.materials.size());
+    ctx.dst.materials.push_back(MakeDefaultMaterial("DefaultMaterial"));
+  }
+}
+
+// Triangle list indices for the primitive's topology; false for points and lines.
+bool Triangulate(uint64_t mode, std::vector<uint32_t>& indices) {
+  if (mode == kModeTriangles) {
+    indices.resize(indices.size() / 3 * 3);
+    return true;
+  }
+  if (mode != kModeTriangleStrip && mode != kModeTriangleFan) {
+    return false;
+  }
+  std::vector<uint32_t> list;
+  if (indices.size() >= 3) {
+    list.reserve((indices.size() - 2) * 3);
+    for (size_t i = 0; i + 2 < indices.size(); ++i) {
+      if (mode == kModeTriangleStrip) {
+        list.push_back(indices[i]);
+        list.push_back(indices[i + 1 + i % 2]);
+        list.push_back(indices[i + 2 - i % 2]);
+      } else {
+        list.push_back(indices[i + 1]);
+        list.push_back(indices[i + 2]);
+        list.push_back(indices[0]);
+      }
+    }
+  }
+  indices = std::move(list);
+  return true;
+}
+
+// glTF targets already hold deltas. Names come from the common extras.targetNames convention;
+// normal deltas count only against authored normals.
+void ImportMorphTargets(const GltfDocument& doc, const JsonValue& primitive, const JsonValue& srcMesh,
+                        bool authoredNormals, Mesh& mesh) {
+  const JsonValue& targets = primitive["targets"];
+  const size_t vertexCount = mesh.vertices.size();
+  std::vector<Vec3> positionDeltas;
+  std::vector<Vec3> normalDeltas;
+  for (size_t t = 0; t < targets.Size(); ++t) {
+    positionDeltas.assign(vertexCount, Vec3(0.0F));
+    normalDeltas.clear();
+    if (const std::optional<Accessor> positions = ResolveAttribute(doc, targets[t], "POSITION", vertexCount);
+        positions.has_value() && positions->components == 3) {
+      ForEachFloat(*positions, 3, [&](size_t i, const float* v) { positionDeltas[i] = Vec3(v[0], v[1], v[2]); });
+    }
+    if (const std::optional<Accessor> normals = ResolveAttribute(doc, targets[t], "NORMAL", vertexCount);
+        authoredNormals && normals.has_value() && normals->components == 3) {
+      normalDeltas.assign(vertexCount, Vec3(0.0F));
+      ForEachFloat(*normals, 3, [&](size_t i, const float* v) { normalDeltas[i] = Vec3(v[0], v[1], v[2]); });
+    }
+    std::string name = srcMesh["extras"]["targetNames"][t].String();
+    if (name.empty()) {
+      name = "Target_" + std::to_string(t);
+    }
+    mesh.morphTargets.push_back(BuildMorphTarget(std::move(name), positionDeltas, normalDeltas));
+    mesh.morphWeights.push_back(srcMesh["weights"][t].Float(0.0F));
+  }
+}
+
+std::optional<ImportedPrimitive> ImportPrimitive(GltfContext& ctx,
+                                                 const JsonValue& srcMesh,
+                                                 const JsonValue& primitive,
+                                                 const std::string& name) {
+  const GltfDocument& doc = *ctx.doc;
+  const ImportOptions& opt = *ctx.opt;
+  const JsonValue& attributes = primitive["attributes"];
+  const auto fail = [&](const std::string& what) -> std::optional<ImportedPrimitive> {
+    ctx.error = "mesh '" + name + "': " + what;
+    return std::nullopt;
+  };
+
+  const std::optional<Accessor> positions = ResolveAccessor(doc, attributes["POSITION"].Index(kNone));
+  if (!positions.has_value() || positions->components != 3) {
+    return fail("missing or invalid POSITION");
+  }
+  const size_t vertexCount = positions->count;
+  Mesh mesh;
+  mesh.name = name;
+  mesh.vertices.resize(vertexCount);
+  ForEachFloat(*positions, 3, [&](size_t i, const float* v) { mesh.vertices[i].position = Vec3(v[0], v[1], v[2]); });
+
+  // Authored frames are kept; anything missing or broken is generated natively.
+  bool authoredNormals = false;
+  if (const std::optional<Accessor> normals = ResolveAttribute(doc, attributes, "NORMAL", vertexCount)) {
+    authoredNormals = true;
+    ForEachFloat(*normals, 3, [&](size_t i, const float* v) {
+      const Vec3 n(v[0], v[1], v[2]);
+      authoredNormals = authoredNormals && UsableVector(n);
+      mesh.vertices[i].normal = UsableVector(n) ? glm::normalize(n) : Vec3(0.0F, 1.0F, 0.0F);
+    });
+  }
+  bool authoredTangents = false;
+  if (const std::optional<Accessor> tangents = ResolveAttribute(doc, attributes, "TANGENT", vertexCount);
+      authoredNormals && tangents.has_value() && tangents->components == 4) {
+    authoredTangents = true;
+    ForEachFloat(*tangents, 4, [&](size_t i, const float* v) {
+      const Vec3 t(v[0], v[1], v[2]);
+      authoredTangents = authoredTangents && UsableVector(t);
+      mesh.vertices[i].tangent = Vec4(UsableVector(t) ? glm::normalize(t) : Vec3(1.0F, 0.0F, 0.0F), v[3] < 0.0F ? -1.0F : 1.0F);
+    });
+  }
+  if (const std::optional<Accessor> uvs = ResolveAttribute(doc, attributes, "TEXCOORD_0", vertexCount)) {
+    ForEachFloat(*uvs, 2, [&](size_t i, const float* v) { mesh.vertices[i].uv0 = Vec2(v[0], v[1]); });
+  }
+
+  ImportedPrimitive out;
+  const std::optional<Accessor> joints = ResolveAttribute(doc, attributes, "JOINTS_0", vertexCount);
+  const std::optional<Accessor> weights = ResolveAttribute(doc, attributes, "WEIGHTS_0", vertexCount);
+  out.skinned = joints.has_value() && weights.has_value() && IsUnsignedInteger(*joints);
+  if (out.skinned) {
+    ForEachUnsigned(*joints, 4, [&](size_t i, const uint32_t* j) {
+      for (size_t k = 0; k < kMaxBoneInfluence; ++k) {
+        mesh.vertices[i].joints[k] = static_cast<uint16_t>(std::min<uint32_t>(j[k], UINT16_MAX));
+      }
+    });
+    ForEachFloat(*weights, 4, [&](size_t i, const float* w) {
+      for (size_t k = 0; k < kMaxBoneInfluence; ++k) {
+        mesh.vertices[i].weights[k] = w[k];
+      }
+    });
+    std::vector<std::pair<uint32_t, float>> influences;
+    for (VertexSkinned& v : mesh.vertices) {
+      influences.clear();
+      for (size_t k = 0; k < kMaxBoneInfluence; ++k) {
+        if (v.weights[k] > 0.0F) {
+          influences.emplace_back(v.joints[k], v.weights[k]);
+        }
+      }
+      if (influences.size() > opt.maxBoneInfluence) {
+        std::sort(influences.begin(), influences.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+        influences.resize(opt.maxBoneInfluence);
+      }
+      const PackedInfluence4 packed = NormalizeInfluences4(influences);
+      v.joints = packed.joints;
+      v.weights = packed.weights;
+    }
+  } else {
+    for (VertexSkinned& v : mesh.vertices) {
+      v.joints = {0, 0, 0, 0};
+      v.weights = {1.0F, 0.0F, 0.0F, 0.0F};
+    }
+  }
+
+  if (primitive.Has("indices")) {
+    const std::optional<Accessor> indices = ResolveAccessor(doc, primitive["indices"].Index(kNone));
+    if (!indices.has_value() || indices->components != 1 || !IsUnsignedInteger(*indices)) {
+      return fail("invalid indices");
+    }
+    mesh.indices.resize(indices->count);
+    ForEachUnsigned(*indices, 1, [&](size_t i, const uint32_t* value) { mesh.indices[i] = value[0]; });
+    for (const uint32_t index : mesh.indices) {
+      if (index >= vertexCount) {
+        return fail("index out of range");
+      }
+    }
+  } else {
+    mesh.indices.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i) {
+      mesh.indices[i] = static_cast<uint32_t>(i);
+    }
+  }
+  if (!Triangulate(primitive["mode"].Index(kModeTriangles), mesh.indices)) {
+    return std::nullopt;  // points and lines are not rendered; not an error
+  }
+
+  if (!mesh.vertices.empty()) {
+    Vec3 minP = mesh.vertices[0].position;
+    Vec3 maxP = mesh.vertices[0].position;
+    for (const auto& v : mesh.vertices) {
+      minP = glm::min(minP, v.position);
+      maxP = glm::max(maxP, v.position);
+    }
+    mesh.localBounds = {minP, maxP};
+  }
+
+  ImportMorphTargets(doc, primitive, srcMesh, authoredNormals, mesh);
+
+  // Joints become local to this mesh's skin before anything derives data from them.
+  if (out.skinned) {
+    out.joints = CompactJoints(mesh.vertices);
+  }
+
+  Submesh submesh;
+  submesh.indexCount = static_cast<uint32_t>(mesh.indices.size());
+  const uint64_t material = primitive["material"].Index(kNone);
+  submesh.material = material < doc.json["materials"].Size() ? static_cast<MaterialId>(material) : ctx.defaultMaterial;
+  mesh.submeshes.push_back(submesh);
+  FinishImportedMesh(mesh, opt, authoredNormals, authoredTangents, ctx.report);
+
+  out.mesh = static_cast<MeshId>(ctx.dst.meshes.size());
+  ctx.dst.meshes.push_back(std::move(mesh));
+  return out;
+}
+
+bool ImportMeshes(GltfContext& ctx) {
+  const JsonValue& meshes = ctx.doc->json["meshes"];
+  ctx.meshes.resize(meshes.Size());
+  for (size_t m = 0; m < meshes.Size(); ++m) {
+    std::string name = meshes[m]["name"].String();
+    if (name.empty()) {
+      name = "Mesh_" + std::to_string(m);
+    }
+    const JsonValue& primitives = meshes[m]["primitives"];
+    for (size_t p = 0; p < primitives.Size(); ++p) {
+      std::optional<ImportedPrimitive> primitive =
+          ImportPrimitive(ctx, meshes[m], primitives[p], p == 0 ? name : name + "_" + std::to_string(p));
+      if (!ctx.error.empty()) {
+        return false;
+      }
+      if (primitive.has_value()) {
+        ctx.meshes[m].push_back(std::move(*primitive));
+      }
+    }
+  }
+  return true;
+}
+
+// One skeleton per glTF skin. Bones are ordered by node (nodes are numbered depth first), so
+// parents come before children, and vertex joints map to bones through `skinBones`.
+void ImportSkeletons(GltfContext& ctx) {
+  const JsonValue& skins = ctx.doc->json["skins"];
+  ctx.skinSkeleton.resize(skins.Size());
+  ctx.skinBones.resize(skins.Size());
+  for (size_t s = 0; s < skins.Size(); ++s) {
+    const JsonValue& src = skins[s];
+    const size_t jointCount = src["joints"].Size();
+    std::vector<NodeId> jointNodes(jointCount, kInvalidNodeId);
+    for (size_t j = 0; j < jointCount; ++j) {
+      const uint64_t node = src["joints"][j].Index(kNone);
+      jointNodes[j] = node < ctx.nodeMap.size() ? ctx.nodeMap[node] : kInvalidNodeId;
+    }
+    std::vector<Mat4> inverseBinds(jointCount, Mat4(1.0F));
+    if (const std::optional<Accessor> matrices = ResolveAccessor(*ctx.doc, src["inverseBindMatrices"].Index(kNone));
+        matrices.has_value() && matrices->components == 16) {
+      ForEachFloat(*matrices, 16, [&](size_t i, const float* v) {
+        if (i < jointCount) {
+          inverseBinds[i] = ToMat4(v);
+        }
+      });
+    }
+
+    std::vector<uint32_t> order(jointCount);
+    for (uint32_t j = 0; j < jointCount; ++j) {
+      order[j] = j;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return jointNodes[a] < jointNodes[b]; });
+
+    Skeleton skeleton;
+    skeleton.name = src["name"].String();
+    if (skeleton.name.empty()) {
+      skeleton.name = "Skin_" + std::to_string(s);
+    }
+    std::unordered_map<NodeId, uint32_t> boneOfNode;
+    ctx.skinBones[s].resize(jointCount);
+    for (uint32_t b = 0; b < jointCount; ++b) {
+      const uint32_t joint = order[b];
+      Bone bone;
+      bone.node = jointNodes[joint];
+      bone.name = bone.node != kInvalidNodeId ? ctx.dst.nodes[bone.node].name : "Joint_" + std::to_string(joint);
+      bone.inverseBind = inverseBinds[joint];
+      bone.globalBind = glm::inverse(bone.inverseBind);
+      ctx.skinBones[s][joint] = b;
+      skeleton.boneMap.try_emplace(bone.name, b);
+      if (bone.node != kInvalidNodeId) {
+        boneOfNode.try_emplace(bone.node, b);
+      }
+      skeleton.bones.push_back(std::move(bone));
+    }
+    for (Bone& bone : skeleton.bones) {
+      NodeId walk = bone.node != kInvalidNodeId ? ctx.dst.nodes[bone.node].parent : kInvalidNodeId;
+      while (walk != kInvalidNodeId && bone.parentBone < 0) {
+        const auto it = boneOfNode.find(walk);
+        if (it != boneOfNode.end()) {
+          bone.parentBone = static_cast<int32_t>(it->second);
+        }
+        walk = ctx.dst.nodes[walk].parent;
+      }
+      if (bone.parentBone < 0 && skeleton.rootNode == kInvalidNodeId) {
+        skeleton.rootNode = bone.node;
+      }
+    }
+    ctx.skinSkeleton[s] = static_cast<SkeletonId>(ctx.dst.skeletons.size());
+    ctx.dst.skeletons.push_back(std::move(skeleton));
+  }
+}
+
+// Every node instancing a mesh gets its first primitive; further primitives hang off child
+// nodes, as on the Assimp path. Skinned instances get their own Skin and palette.
+void AttachMeshes(GltfContext& ctx) {
+  const JsonValue& nodes = ctx.doc->json["nodes"];
+  for (size_t i = 0; i < ctx.nodeMap.size(); ++i) {
+    const NodeId nodeId = ctx.nodeMap[i];
+    const uint64_t meshIndex = nodes[i]["mesh"].Index(kNone);
+    if (nodeId == kInvalidNodeId || meshIndex >= ctx.meshes.size()) {
+      continue;
+    }
+    const uint64_t skinIndex = nodes[i]["skin"].Index(kNone);
+    for (const ImportedPrimitive& primitive : ctx.meshes[meshIndex]) {
+      NodeId target = nodeId;
+      if (ctx.dst.nodes[nodeId].mesh.has_value()) {
+        Node extraNode;
+        extraNode.name = ctx.dst.nodes[nodeId].name + "_mesh_" + std::to_string(primitive.mesh);
+        extraNode.parent = nodeId;
+        target = static_cast<NodeId>(ctx.dst.nodes.size());
+        ctx.dst.nodes.push_back(std::move(extraNode));
+        ctx.dst.nodes[nodeId].children.push_back(target);
+      }
+      ctx.dst.nodes[target].mesh = primitive.mesh;
+      if (!primitive.skinned || skinIndex >= ctx.skinBones.size()) {
+        continue;
+      }
+      const std::vector<uint32_t>& bones = ctx.skinBones[skinIndex];
+      Skin skin;
+      skin.skeleton = ctx.skinSkeleton[skinIndex];
+      skin.mesh = primitive.mesh;
+      skin.joints.reserve(primitive.joints.size());
+      for (const uint32_t joint : primitive.joints) {
+        skin.joints.push_back(joint < bones.size() ? bones[joint] : 0);
+      }
+      skin.palette.resize(skin.joints.size(), Mat4(1.0F));
+      ctx.dst.nodes[target].skin = static_cast<SkinId>(ctx.dst.skins.size());
+      ctx.dst.skins.push_back(std::move(skin));
+    }
+  }
+}
+
+// STEP samplers hold each key until the next; the animator interpolates linearly, so a copy of
+// the held value goes just before every following key.
+template <typename Key, typename Value>
+void AppendKeys(std::vector<Key>& keys, const std::vector<float>& times, const std::vector<Value>& values, bool step) {
+  keys.reserve(keys.size() + times.size() * (step ? 2 : 1));
+  for (size_t k = 0; k < times.size(); ++k) {
+    Key key;
+    key.time = times[k];
+    key.value = values[k];
+    keys.push_back(key);
+    if (step && k + 1 < times.size()) {
+      key.time = std::nextafter(times[k + 1], times[k]);
+      if (key.time > times[k]) {
+        keys.push_back(key);
+      }
+    }
+  }
+}
+
+// A weights channel drives every scene node drawing a primitive of the target node's mesh: the
+// node itself and the extra nodes AttachMeshes hung off it. Keys are target-major per time;
+// cubic spline tangents are dropped and STEP keys are held like AppendKeys does.
+void ImportMorphWeights(GltfContext& ctx, uint64_t node, const std::vector<float>& times, const Accessor& output,
+                        bool cubic, bool step, AnimationClip& clip) {
+  const uint64_t meshIndex = ctx.doc->json["nodes"][node]["mesh"].Index(kNone);
+  if (meshIndex >= ctx.meshes.size() || times.empty()) {
+    return;
+  }
+  const NodeId nodeId = ctx.nodeMap[node];
+  std::vector<NodeId> drawn;
+  for (const ImportedPrimitive& primitive : ctx.meshes[meshIndex]) {
+    const auto draws = [&](NodeId n) { return ctx.dst.nodes[n].mesh == primitive.mesh; };
+    if (draws(nodeId)) {
+      drawn.push_back(nodeId);
+    }
+    for (const NodeId child : ctx.dst.nodes[nodeId].children) {
+      if (draws(child)) {
+        drawn.push_back(child);
+      }
+    }
+  }
+  const size_t targets = ctx.doc->json["meshes"][meshIndex]["primitives"][0]["targets"].Size();
+  if (drawn.empty() || targets == 0 || output.components != 1 || output.count < times.size() * targets * (cubic ? 3 : 1)) {
+    return;
+  }
+
+  std::vector<float> values(times.size() * targets, 0.0F);
+  const size_t perKey = targets * (cubic ? 3 : 1);
+  ForEachFloat(output, 1, [&](size_t i, const float* v) {
+    const size_t key = i / perKey;
+    const size_t slot = i % perKey;
+    if (key < times.size() && (!cubic || slot / targets == 1)) {
+      values[key * targets + slot % targets] = v[0];
+    }
+  });
+
+  MorphWeightTrack track;
+  track.targets = static_cast<uint32_t>(targets);
+  for (size_t k = 0; k < times.size(); ++k) {
+    const auto key = values.begin() + static_cast<std::ptrdiff_t>(k * targets);
+    track.times.push_back(times[k]);
+    track.weights.insert(track.weights.end(), key, key + static_cast<std::ptrdiff_t>(targets));
+    if (step && k + 1 < times.size()) {
+      const float held = std::nextafter(times[k + 1], times[k]);
+      if (held > times[k]) {
+        track.times.push_back(held);
+        track.weights.insert(track.weights.end(), key, key + static_cast<std::ptrdiff_t>(targets));
+      }
+    }
+  }
+  for (const NodeId n : drawn) {
+    track.node = n;
+    clip.morphTracks.push_back(track);
+  }
+}
+
+void ImportAnimations(GltfContext& ctx) {
+  const JsonValue& animations = ctx.doc->json["animations"];
+  std::vector<float> times;
+  std::vector<Vec3> vectors;
+  std::vector<Quat> rotations;
+  for (size_t a = 0; a < animations.Size(); ++a) {
+    const JsonValue& src = animations[a];
+    AnimationClip clip;
+    clip.name = src["name"].String();
+    if (clip.name.empty()) {
+      clip.name = "Clip_" + std::to_string(a);
+    }
+    clip.ticksPerSec = 1.0F;  // glTF keys are in seconds
+
+    std::unordered_map<NodeId, size_t> trackOfNode;
+    for (const JsonValue& channel : src["channels"].items) {
+      const uint64_t node = channel["target"]["node"].Index(kNone);
+      const std::string& path = channel["target"]["path"].String();
+      const JsonValue& sampler = src["samplers"][channel["sampler"].Index(kNone)];
+      const bool weights = path == "weights";
+      if (node >= ctx.nodeMap.size() || ctx.nodeMap[node] == kInvalidNodeId ||
+          (path != "translation" && path != "rotation" && path != "scale" && !weights)) {
+        continue;
+      }
+      const std::optional<Accessor> input = ResolveAccessor(*ctx.doc, sampler["input"].Index(kNone));
+      const std::optional<Accessor> output = ResolveAccessor(*ctx.doc, sampler["output"].Index(kNone));
+      const std::string& interpolation = sampler["interpolation"].String();
+      const bool cubic = interpolation == "CUBICSPLINE";
+      const bool step = interpolation == "STEP";
+      if (!input.has_value() || !output.has_value() || input->components != 1) {
+        continue;
+      }
+      times.assign(input->count, 0.0F);
+      ForEachFloat(*input, 1, [&](size_t i, const float* v) { times[i] = v[0]; });
+      if (weights) {
+        ImportMorphWeights(ctx, node, times, *output, cubic, step, clip);
+        if (!times.empty()) {
+          clip.durationSec = std::max(clip.durationSec, times.back());
+        }
+        continue;
+      }
+      const uint32_t components = path == "rotation" ? 4 : 3;
+      if (output->components != components || output->count < input->count * (cubic ? 3 : 1)) {
+        continue;
+      }
+      // Cubic spline outputs are (in-tangent, value, out-tangent) triples; only values are kept.
+      const size_t stride = cubic ? 3 : 1;
+      const size_t offset = cubic ? 1 : 0;
+
+      const auto [it, inserted] = trackOfNode.try_emplace(ctx.nodeMap[node], clip.tracks.size());
+      if (inserted) {
+        clip.tracks.emplace_back();
+        clip.tracks.back().node = ctx.nodeMap[node];
+      }
+      NodeTrack& track = clip.tracks[it->second];
+      if (components == 4) {
+        rotations.assign(times.size(), Quat(1.0F, 0.0F, 0.0F, 0.0F));
+        ForEachFloat(*output, 4, [&](size_t i, const float* v) {
+          if (i % stride == offset && i / stride < rotations.size()) {
+            rotations[i / stride] = NormalizeRotation(Quat(v[3], v[0], v[1], v[2]));
+          }
+        });
+        AppendKeys(track.rotKeys, times, rotations, step);
+      } else {
+        vectors.assign(times.size(), Vec3(0.0F));
+        ForEachFloat(*output, 3, [&](size_t i, const float* v) {
+          if (i % stride == offset && i / stride < vectors.size()) {
+            vectors[i / stride] = Vec3(v[0], v[1], v[2]);
+          }
+        });
+        AppendKeys(path == "translation" ? track.posKeys : track.sclKeys, times, vectors, step);
+      }
+      if (!times.empty()) {
+        clip.durationSec = std::max(clip.durationSec, times.back());
+      }
+    }
+    ctx.dst.clips.push_back(std::move(clip));
+  }
+}
+
+void ImportLights(GltfContext& ctx) {
+  const JsonValue& json = ctx.doc->json;
+  const JsonValue& lights = json["extensions"]["KHR_lights_punctual"]["lights"];
+  std::vector<std::optional<LightId>> lightIds(lights.Size());
+  for (size_t i = 0; i < lights.Size(); ++i) {
+    const JsonValue& src = lights[i];
+    const std::string& type = src["type"].String();
+    Light light;
+    if (type == "directional") {
+      light.type = LightType::kDirectional;
+    } else if (type == "point") {
+      light.type = LightType::kPoint;
+    } else if (type == "spot") {
+      light.type = LightType::kSpot;
+    } else {
+      continue;
+    }
+    light.color = ReadVec3(src["color"], Vec3(1.0F));
+    light.intensity = src["intensity"].Float(1.0F);
+    light.range = src["range"].Float(light.range);
+    light.direction = Vec3(0.0F, 0.0F, -1.0F);  // punctual lights shine down their node's -Z
+    light.innerCone = src["spot"]["innerConeAngle"].Float(0.0F);
+    light.outerCone = src["spot"]["outerConeAngle"].Float(0.785398F);
+    lightIds[i] = static_cast<LightId>(ctx.dst.lights.size());
+    ctx.dst.lights.push_back(light);
+  }
+  const JsonValue& nodes = json["nodes"];
+  for (size_t i = 0; i < ctx.nodeMap.size(); ++i) {
+    const uint64_t light = nodes[i]["extensions"]["KHR_lights_punctual"]["light"].Index(kNone);
+    if (ctx.nodeMap[i] != kInvalidNodeId && light < lightIds.size() && lightIds[light].has_value()) {
+      ctx.dst.nodes[ctx.nodeMap[i]].light = *lightIds[light];
+    }
+  }
+}
+
+}  // namespace
+
+LoadResult<Scene> GltfImporter::Import(const std::string& path, const ImportOptions& opt, ImportReport* report) const {
+  ImportReportTotals totals(report, opt);
+  const auto fail = [&](const std::string& error) {
+    totals.Finish(path, nullptr, error);
+    return LoadResult<Scene>{.value = std::nullopt, .error = error};
+  };
+
+  GltfDocument doc;
+  doc.sourceDir = std::filesystem::absolute(std::filesystem::path(path)).parent_path();
+  std::string error;
+  {
+    ScopedImportStage stage(report, "read_file");
+    error = OpenDocument(path, doc);
+  }
+  if (!error.empty()) {
+    return fail(error);
+  }
+  {
+    ScopedImportStage stage(report, "buffers");
+    error = MapBuffers(doc);
+    stage.AddItems(doc.buffers.size());
+  }
+  if (report != nullptr) {
+    report->externalFiles = doc.bufferPaths;
+  }
+  if (!error.empty()) {
+    return fail(error);
+  }
+
+  GltfContext ctx;
+  ctx.doc = &doc;
+  ctx.opt = &opt;
+  ctx.report = report;
+  if (!opt.assetRoot.empty()) {
+    ScopedImportStage stage(report, "asset_index");
+    AssetDirectoryIndex::Global().AddRoot(opt.assetRoot);
+  }
+
+  AddDefaultTextures(ctx.dst);
+  {
+    ScopedImportStage stage(report, "nodes");
+    BuildNodes(ctx);
+    stage.AddItems(ctx.dst.nodes.size());
+  }
+  {
+    ScopedImportStage stage(report, "materials");
+    ImportMaterials(ctx);
+    MarkNormalMaps(ctx.dst);
+    stage.AddItems(ctx.dst.materials.size());
+  }
+  if (opt.packMaterialTextures) {
+    ScopedImportStage stage(report, "texture_pack");
+    const ImportPackStats packed = PackMaterialTextures(ctx.dst);
+    if (report != nullptr) {
+      report->packed = packed;
+    }
+    stage.AddItems(packed.materials);
+  }
+  if (opt.generateMips) {
+    ScopedImportStage stage(report, "texture_mips");
+    BuildTextureMips(ctx.dst);
+    stage.AddItems(ctx.dst.textures.size());
+  }
+  if (opt.compressTextures) {
+    ScopedImportStage stage(report, "texture_compress");
+    CompressTextures(ctx.dst, opt.textureCompression);
+    stage.AddItems(ctx.dst.textures.size());
+  }
+  if (opt.shareDecodedTextures) {
+    TextureRegistry::Global().Publish(ctx.dst.textures);
+  }
+  {
+    ScopedImportStage stage(report, "meshes");
+    const bool ok = ImportMeshes(ctx);
+    stage.AddItems(ctx.dst.meshes.size());
+    if (!ok) {
+      return fail(ctx.error);
+    }
+  }
+  {
+    ScopedImportStage stage(report, "skeleton");
+    ImportSkeletons(ctx);
+    AttachMeshes(ctx);
+    for (const Skeleton& skeleton : ctx.dst.skeletons) {
+      stage.AddItems(skeleton.bones.size());
+    }
+  }
+  {
+    ScopedImportStage stage(report, "animations");
+    ImportAnimations(ctx);
+    stage.AddItems(ctx.dst.clips.size());
+  }
+  {
+    ScopedImportStage stage(report, "lights");
+    ImportLights(ctx);
+    stage.AddItems(ctx.dst.lights.size());
+  }
+  if (opt.pruneScene) {
+    ScopedImportStage stage(report, "prune");
+    const ImportPruneStats pruned = PruneScene(ctx.dst);
+    if (report != nullptr) {
+      report->pruned = pruned;
+    }
+    stage.AddItems(pruned.bones + pruned.nodes + pruned.tracks);
+  }
+  {
+    ScopedImportStage stage(report, "world_transforms");
+    FinalizeWorldTransforms(ctx.dst);
+  }
+
+  totals.Finish(path, &ctx.dst, {});
+  return LoadResult<Scene>{.value = std::move(ctx.dst), .error = {}};
+}
+
+}  // namespace vv
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <string>
+
+#include "asset/import/ImportOptions.hpp"
+#include "asset/import/ImportReport.hpp"
+#include "core/types/CommonTypes.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+// Native glTF 2.0 reader for .gltf (external or data: buffers) and .glb, building the same Scene
+// as AssimpFbxImporter without an intermediate aiScene. The file and its external buffers are
+// memory-mapped and accessors are read straight out of the mapping into the scene's vertex,
+// index, skin and key arrays. Skins and animation channels name their nodes by index, so there
+// are no name lookups, and images are decoded in parallel. glTF is already +Y up, right-handed
+// and in meters, so convertToMeters and forceRightHanded do not apply; neither do the
+// Assimp-only options. Morph targets, cameras and extra UV sets are ignored.
+class GltfImporter {
+ public:
+  // `report`, when given, receives per-stage timings, heap deltas and counts (see ImportReport).
+  LoadResult<Scene> Import(const std::string& path, const ImportOptions& opt, ImportReport* report = nullptr) const;
+};
+
+}  // namespace vv
@@ -0,0 +1,537 @@
+#include "asset/import/ImportCommon.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include "asset/index/AssetDirectoryIndex.hpp"
+#include "asset/mesh/MeshSimplifier.hpp"
+#include "asset/mesh/MeshletBuilder.hpp"
+#include "asset/mesh/MorphTargets.hpp"
+#include "asset/mesh/TangentSpace.hpp"
+#include "asset/mesh/VertexCache.hpp"
+#include "asset/mesh/VertexQuantization.hpp"
+#include "asset/mesh/VertexWeld.hpp"
+#include "asset/texture/BlockCompression.hpp"
+#include "asset/texture/Ktx2.hpp"
+#include "asset/texture/MipGenerator.hpp"
+#include "asset/texture/TextureRegistry.hpp"
+#include "core/memory/ProcessMemory.hpp"
+#include "core/thread/ParallelFor.hpp"
+
+namespace vv {
+namespace {
+
+Texture MakeDefaultTexture(const std::string& name, bool srgb, PixelBuffer pixels) {
+  Texture tex;
+  tex.uri = name;
+  tex.format = PixelFormat::kR8G8B8A8;
+  tex.width = 1;
+  tex.height = 1;
+  tex.srgb = srgb;
+  tex.pixels = std::move(pixels);
+  tex.contentHash = HashBytes(tex.pixels.data(), tex.pixels.size());
+  return tex;
+}
+
+TextureId AppendSourceTexture(Scene& scene, SourceImage& image, bool srgb, bool lazy, const std::filesystem::path& spillDir, bool reserveMipChains) {
+  TextureRegistry& registry = TextureRegistry::Global();
+  // KTX2 levels are already in their GPU format: they are copied as stored, or left in the file.
+  const bool ktx2 = image.ktx2.has_value();
+  Texture tex = ktx2 ? MakeKtx2Texture(*image.ktx2, srgb) : Texture{};
+  tex.uri = image.uri;
+  tex.srgb = srgb;
+  if (!ktx2) {
+    tex.format = srgb ? PixelFormat::kR8G8B8A8_SRGB : PixelFormat::kR8G8B8A8;
+  }
+  tex.contentHash = image.hash;
+  if (lazy) {
+    if (!ktx2) {
+      tex.width = image.info->width;
+      tex.height = image.info->height;
+    }
+    tex.source.path = image.path;
+    if (image.path.empty() && !spillDir.empty() && !ktx2) {
+      tex.source.path = SpillEmbeddedImage(spillDir, image.data, image.size, image.hash, false);
+    }
+    if (tex.source.path.empty()) {
+      tex.source.bytes = std::make_shared<const std::vector<uint8_t>>(image.data, image.data + image.size);
+    }
+    tex.source.sizeBytes = image.size;
+  } else if (ktx2) {
+    tex.pixels = PixelBuffer(Ktx2ChainBytes(*image.ktx2));
+    if (!ReadKtx2Levels(image.data, image.size, *image.ktx2, tex.pixels.data())) {
+      tex.pixels.clear();  // sampled as white, like a lazy texture that fails at upload
+    }
+  } else {
+    tex.width = image.owned.has_value() ? image.owned->width : image.shared.width;
+    tex.height = image.owned.has_value() ? image.owned->height : image.shared.height;
+    tex.source.sizeBytes = image.size;
+    const size_t chainBytes =
+        reserveMipChains ? MipLevelOffset(tex.width, tex.height, FullMipLevelCount(tex.width, tex.height)) : 0;
+    if (image.owned.has_value() && image.uses == 1) {
+      tex.pixels = std::move(image.owned->pixels);
+      if (chainBytes > 0) {
+        tex.pixels.reserve(chainBytes);
+      }
+      image.owned.reset();
+    } else if (image.owned.has_value()) {
+      tex.pixels = PixelBuffer::Copy(image.owned->pixels.data(), image.owned->pixels.size(), chainBytes);
+    } else {
+      tex.pixels = PixelBuffer::Copy(image.shared.pixels, image.shared.SizeBytes(), chainBytes);
+    }
+  }
+  --image.uses;
+  // Counted as on the Assimp path: one decode per image decoded here, registry hits per texture.
+  registry.RecordSourceImage(image.decodedHere);
+  image.decodedHere = false;
+  if (image.registryHit) {
+    registry.RecordRegistryHit(image.size);
+  }
+  scene.textures.push_back(std::move(tex));
+  return static_cast<TextureId>(scene.textures.size() - 1);
+}
+
+}  // namespace
+
+void AddDefaultTextures(Scene& scene) {
+  scene.textures.push_back(MakeDefaultTexture("__default_white__", true, {255, 255, 255, 255}));
+  scene.textures.push_back(MakeDefaultTexture("__default_black__", false, {0, 0, 0, 255}));
+  scene.textures.push_back(MakeDefaultTexture("__default_normal__", false, {128, 128, 255, 255}));
+  // ~0.04 linear reflectance in sRGB.
+  scene.textures.push_back(MakeDefaultTexture("__default_specular__", true, {56, 56, 56, 255}));
+  scene.textures.push_back(MakeDefaultTexture("__default_linear_white__", false, {255, 255, 255, 255}));
+}
+
+Transform DecomposeTransform(const Mat4& m) {
+  Transform t;
+  t.translation = Vec3(m[3]);
+
+  Vec3 basisX = Vec3(m[0]);
+  Vec3 basisY = Vec3(m[1]);
+  Vec3 basisZ = Vec3(m[2]);
+
+  t.scale.x = glm::length(basisX);
+  t.scale.y = glm::length(basisY);
+  t.scale.z = glm::length(basisZ);
+
+  constexpr float kEps = 1e-8F;
+  if (t.scale.x <= kEps || t.scale.y <= kEps || t.scale.z <= kEps) {
+    t.rotation = Quat(1.0F, 0.0F, 0.0F, 0.0F);
+    t.scale = Vec3(1.0F);
+    return t;
+  }
+
+  basisX /= t.scale.x;
+  basisY /= t.scale.y;
+  basisZ /= t.scale.z;
+
+  glm::mat3 rot(1.0F);
+  rot[0] = basisX;
+  rot[1] = basisY;
+  rot[2] = basisZ;
+
+  if (glm::determinant(rot) < 0.0F) {
+    t.scale.x = -t.scale.x;
+    rot[0] = -rot[0];
+  }
+
+  t.rotation = glm::normalize(glm::quat_cast(rot));
+  return t;
+}
+
+Material MakeDefaultMaterial(const std::string& name) {
+  Material material;
+  material.name = name;
+  material.baseColorTex = kDefaultWhiteSrgb;
+  material.metallicRoughnessTex = kDefaultWhiteLinear;
+  material.metallicTex = kDefaultBlackLinear;
+  material.roughnessTex = kDefaultWhiteLinear;
+  material.normalTex = kDefaultNormal;
+  material.occlusionTex = kDefaultWhiteLinear;
+  material.emissiveTex = kDefaultBlackLinear;
+  material.specularTex = kDefaultSpecular;
+  return material;
+}
+
+void MarkNormalMaps(Scene& scene) {
+  for (const Material& material : scene.materials) {
+    if (material.normalTex < scene.textures.size()) {
+      scene.textures[material.normalTex].Edit().normalMap = true;
+    }
+  }
+}
+
+void BuildTextureMips(Scene& scene) {
+  for (SharedAsset<Texture>& texture : scene.textures) {
+    GenerateMipChain(texture.Edit());
+  }
+}
+
+void CompressTextures(Scene& scene, const TextureCompressionOptions& options) {
+  for (SharedAsset<Texture>& texture : scene.textures) {
+    CompressTexture(texture.Edit(), options);
+  }
+}
+
+void FinalizeWorldTransforms(Scene& scene) {
+  std::function<void(NodeId, const Mat4&)> recurse = [&](NodeId nodeId, const Mat4& parentWorld) {
+    Node& node = scene.nodes[nodeId];
+    node.worldCurrent = parentWorld * node.localCurrent.ToMat4();
+    for (const NodeId child : node.children) {
+      recurse(child, node.worldCurrent);
+    }
+  };
+
+  for (const NodeId root : scene.roots) {
+    recurse(root, Mat4(1.0F));
+  }
+}
+
+void FinishImportedMesh(Mesh& mesh,
+                        const ImportOptions& opt,
+                        bool authoredNormals,
+                        bool authoredTangents,
+                        ImportReport* report) {
+  ExpandBoundsForMorphTargets(mesh);
+
+  // Welds after conversion and influence packing, so skinned vertices that only differed before
+  // LimitBoneWeights/normalization merge too; runs before tangent generation so it can smooth.
+  if (!opt.assimpJoinVertices) {
+    ScopedImportStage stage(report, "mesh_weld", "meshes");
+    const VertexWeldResult weld = WeldVertices(mesh, opt.vertexWeld);
+    stage.AddItems(weld.inputVertices - weld.outputVertices);
+  }
+
+  if (!authoredNormals || !authoredTangents) {
+    ScopedImportStage stage(report, "mesh_tangents", "meshes");
+    TangentSpaceOptions tangentOptions;
+    tangentOptions.generateNormals = !authoredNormals;
+    tangentOptions.creaseAngleDegrees = opt.normalCreaseAngle;
+    tangentOptions.generateTangents = !authoredTangents;
+    GenerateTangentSpace(mesh, tangentOptions);
+    stage.AddItems(mesh.vertices.size());
+  }
+
+  if (opt.buildClusters) {
+    ScopedImportStage stage(report, "mesh_clusters", "meshes");
+    BuildMeshClusters(mesh);
+    stage.AddItems(mesh.clusters.size());
+  }
+  {
+    ScopedImportStage stage(report, "mesh_lods", "meshes");
+    BuildMeshLods(mesh, opt.lodCount);
+    stage.AddItems(mesh.lods.size());
+  }
+
+  // Last to touch the index order: clusters regroup triangles and LODs append new ranges, and the
+  // reorder keeps every range it finds. Stands in for Assimp's ImproveCacheLocality.
+  if (!opt.assimpJoinVertices) {
+    ScopedImportStage stage(report, "mesh_cache_order", "meshes");
+    const VertexCacheResult order = OptimizeVertexCache(mesh);
+    stage.AddItems(order.triangles);
+  }
+
+  // Packs the final vertex order.
+  if (opt.quantizeVertices) {
+    ScopedImportStage stage(report, "mesh_quantize", "meshes");
+    PackMeshVertices(mesh);
+    stage.AddItems(mesh.vertices.size());
+  }
+}
+
+std::string NormalizeTextureUri(const std::string& uri) {
+  std::string normalized = uri;
+  std::replace(normalized.begin(), normalized.end(), '\\', '/');
+  while (!normalized.empty() &&
+         (normalized.front() == ' ' || normalized.front() == '\t' || normalized.front() == '\n' ||
+          normalized.front() == '\r' || normalized.front() == '"' || normalized.front() == '\'')) {
+    normalized.erase(normalized.begin());
+  }
+  while (!normalized.empty() &&
+         (normalized.back() == ' ' || normalized.back() == '\t' || normalized.back() == '\n' ||
+          normalized.back() == '\r' || normalized.back() == '"' || normalized.back() == '\'')) {
+    normalized.pop_back();
+  }
+
+  std::string lowered = normalized;
+  std::transform(lowered.begin(), lowered.end(), lowered.begin(), [](unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+  constexpr const char* kFilePrefix = "file://";
+  if (lowered.rfind(kFilePrefix, 0) == 0) {
+    normalized = normalized.substr(7);
+    if (normalized.size() >= 3 && normalized[0] == '/' &&
+        std::isalpha(static_cast<unsigned char>(normalized[1])) && normalized[2] == ':') {
+      normalized.erase(normalized.begin());
+    }
+  }
+  return normalized;
+}
+
+namespace {
+
+std::optional<std::filesystem::path> FindTextureFile(const std::filesystem::path& sourceDir, const std::string& normalizedUri) {
+  if (normalizedUri.empty()) {
+    return std::nullopt;
+  }
+
+  std::error_code ec;
+  const std::filesystem::path inputPath(normalizedUri);
+  if (inputPath.is_absolute() && std::filesystem::exists(inputPath, ec) && !ec) {
+    return inputPath;
+  }
+
+  const std::filesystem::path localPath = sourceDir / inputPath;
+  ec.clear();
+  if (std::filesystem::exists(localPath, ec) && !ec) {
+    return localPath;
+  }
+
+  const std::filesystem::path filename = inputPath.filename();
+  if (!filename.empty()) {
+    const std::filesystem::path siblingPath = sourceDir / filename;
+    ec.clear();
+    if (std::filesystem::exists(siblingPath, ec) && !ec) {
+      return siblingPath;
+    }
+
+    // Anywhere below the source directory, through the shared persistent index (no tree walk).
+    if (auto indexed = AssetDirectoryIndex::Global().Find(sourceDir, filename.string()); indexed.has_value()) {
+      return indexed;
+    }
+  }
+
+  return std::nullopt;
+}
+
+}  // namespace
+
+std::optional<std::filesystem::path> ResolveTexturePath(const std::filesystem::path& sourceDir, const std::string& normalizedUri) {
+  std::optional<std::filesystem::path> resolved = FindTextureFile(sourceDir, normalizedUri);
+  if (resolved.has_value()) {
+    std::filesystem::path cooked = *resolved;
+    cooked.replace_extension(kKtx2Extension);
+    std::error_code ec;
+    std::error_code sourceEc;
+    // A sibling older than its image is stale until the next cook rewrites it.
+    if (cooked != *resolved && std::filesystem::is_regular_file(cooked, ec) &&
+        std::filesystem::last_write_time(cooked, ec) >= std::filesystem::last_write_time(*resolved, sourceEc) && !ec &&
+        !sourceEc) {
+      return cooked;
+    }
+  }
+  return resolved;
+}
+
+std::filesystem::path TextureSpillDirectory(const ImportOptions& opt) {
+  return !opt.textureSpillDir.empty() ? std::filesystem::path(opt.textureSpillDir)
+                                      : std::filesystem::temp_directory_path() / "vividvision-textures";
+}
+
+std::string SpillEmbeddedImage(const std::filesystem::path& dir, const uint8_t* bytes, size_t size, uint64_t hash, bool raw) {
+  char name[48];
+  std::snprintf(name, sizeof(name), "%016llx-%zu%s", static_cast<unsigned long long>(hash), size, raw ? ".bgra" : ".img");
+  const std::filesystem::path path = dir / name;
+  std::error_code ec;
+  if (std::filesystem::file_size(path, ec) == size && !ec) {
+    return path.string();
+  }
+  static std::atomic<uint64_t> spillCounter{0};
+  std::filesystem::create_directories(dir, ec);
+  const std::filesystem::path temp =
+      dir / (std::string(name) + ".tmp" +
+             std::to_string(std::chrono::steady_clock::now().time_since_epoch().count() + spillCounter++));
+  {
+    std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+    if (!out.write(reinterpret_cast<const char*>(bytes), static_cast<std::streamsize>(size))) {
+      out.close();
+      std::filesystem::remove(temp, ec);
+      return {};
+    }
+  }
+  std::filesystem::rename(temp, path, ec);
+  if (ec) {
+    std::filesystem::remove(temp, ec);
+    return {};
+  }
+  return path.string();
+}
+
+std::vector<std::optional<TextureId>> AppendSourceImages(Scene& scene,
+                                                         std::vector<SourceImage>& images,
+                                                         const std::vector<SourceImageRequest>& requests,
+                                                         const ImportOptions& opt,
+                                                         ImportReport* report) {
+  const bool bounded = opt.memoryBudgetBytes > 0;
+  const bool lazy = bounded || (opt.lazyTextureDecode && !opt.compressTextures);
+  const std::filesystem::path spillDir = bounded ? TextureSpillDirectory(opt) : std::filesystem::path();
+  std::vector<std::optional<TextureId>> result(requests.size());
+
+  ScopedImportStage stage(report, "texture_decode", "materials");
+  std::vector<size_t> present;
+  for (const SourceImageRequest& request : requests) {
+    if (request.image < images.size() && images[request.image].data != nullptr &&
+        std::find(present.begin(), present.end(), request.image) == present.end()) {
+      present.push_back(request.image);
+    }
+  }
+  ParallelFor(present.size(), 1, [&](size_t begin, size_t end) {
+    for (size_t n = begin; n < end; ++n) {
+      SourceImage& image = images[present[n]];
+      image.hash = HashBytes(image.data, image.size);
+    }
+  });
+  std::vector<size_t> unique;
+  for (const size_t i : present) {
+    for (const size_t u : unique) {
+      if (images[u].hash == images[i].hash && images[u].size == images[i].size) {
+        images[i].aliasOf = u;
+        break;
+      }
+    }
+    if (images[i].aliasOf == SIZE_MAX) {
+      unique.push_back(i);
+    }
+  }
+  for (const SourceImageRequest& request : requests) {
+    if (request.image < images.size() && images[request.image].data != nullptr) {
+      const size_t alias = images[request.image].aliasOf;
+      ++images[alias != SIZE_MAX ? alias : request.image].uses;
+    }
+  }
+
+  TextureRegistry& registry = TextureRegistry::Global();
+  ParallelFor(unique.size(), 1, [&](size_t begin, size_t end) {
+    for (size_t n = begin; n < end; ++n) {
+      SourceImage& image = images[unique[n]];
+      if (IsKtx2(image.data, image.size)) {
+        image.ktx2 = ReadKtx2Info(image.data, image.size);
+        continue;
+      }
+      if (lazy) {
+        image.info = ReadImageInfoFromMemory(image.data, image.size);
+        continue;
+      }
+      if (opt.shareDecodedTextures) {
+        image.shared = registry.FindDecoded(image.hash, image.size);
+        image.registryHit = static_cast<bool>(image.shared);
+      }
+      if (image.shared) {
+        continue;
+      }
+      std::optional<ImageRgba8> decoded = LoadImageRgba8FromMemory(image.data, image.size);
+      if (!decoded.has_value()) {
+        continue;
+      }
+      image.decodedHere = true;
+      // The scene's pixels are published after import; compressed imports keep none, so there the
+      // registry holds the decode and the scene copies it.
+      if (opt.shareDecodedTextures && opt.compressTextures) {
+        const std::shared_ptr<const ImageRgba8> shared = registry.Insert(image.hash, image.size, std::move(*decoded));
+        image.shared = {shared, shared->pixels.data(), shared->width, shared->height};
+      } else {
+        image.owned = std::move(*decoded);
+      }
+    }
+  });
+
+  std::unordered_map<uint64_t, TextureId> textureByContent;  // content hash + sRGB bit
+  for (size_t r = 0; r < requests.size(); ++r) {
+    const SourceImageRequest& request = requests[r];
+    if (request.image >= images.size() || images[request.image].data == nullptr) {
+      continue;
+    }
+    const size_t alias = images[request.image].aliasOf;
+    SourceImage& image = images[alias != SIZE_MAX ? alias : request.image];
+    const auto local = textureByContent.find((image.hash << 1U) | (request.srgb ? 1U : 0U));
+    if (local != textureByContent.end()) {
+      const Texture& existing = scene.textures[local->second];
+      registry.RecordSourceImage(false);
+      registry.RecordSceneDuplicate(static_cast<uint64_t>(existing.width) * existing.height * 4);
+      result[r] = local->second;
+      --image.uses;
+      continue;
+    }
+    const bool ready =
+        image.ktx2.has_value() || (lazy ? image.info.has_value() : (image.owned.has_value() || static_cast<bool>(image.shared)));
+    if (!ready) {
+      --image.uses;
+      continue;
+    }
+    result[r] = AppendSourceTexture(scene, image, request.srgb, lazy, spillDir, opt.generateMips);
+    textureByContent[(image.hash << 1U) | (request.srgb ? 1U : 0U)] = *result[r];
+    stage.AddItems(1);
+  }
+  return result;
+}
+
+ImportCounts CountImported(const Scene& scene) {
+  ImportCounts counts;
+  counts.nodes = scene.nodes.size();
+  counts.meshes = scene.meshes.size();
+  counts.materials = scene.materials.size();
+  counts.textures = scene.textures.size();
+  counts.skins = scene.skins.size();
+  counts.skeletons = scene.skeletons.size();
+  counts.clips = scene.clips.size();
+  counts.lights = scene.lights.size();
+  for (const Mesh& mesh : scene.meshes) {
+    counts.vertices += mesh.vertices.size();
+    counts.triangles += mesh.indices.size() / 3;
+    counts.morphTargets += mesh.morphTargets.size();
+    for (const MorphTarget& target : mesh.morphTargets) {
+      counts.morphVertices += target.vertices.size();
+    }
+  }
+  for (const Skeleton& skeleton : scene.skeletons) {
+    counts.bones += skeleton.bones.size();
+  }
+  for (const AnimationClip& clip : scene.clips) {
+    counts.tracks += clip.tracks.size();
+    for (const NodeTrack& track : clip.tracks) {
+      counts.keys += track.posKeys.size() + track.rotKeys.size() + track.sclKeys.size();
+    }
+    counts.morphTracks += clip.morphTracks.size();
+  }
+  return counts;
+}
+
+ImportReportTotals::ImportReportTotals(ImportReport* report, const ImportOptions& opt)
+    : report_(report),
+      wallStart_(std::chrono::steady_clock::now()),
+      cpuStart_(std::clock()),
+      heapStart_(report != nullptr ? QueryHeapInUseBytes() : 0),
+      decodedStart_(TextureRegistry::Global().Stats().decodedImages) {
+  if (report_ != nullptr) {
+    report_->memoryBudgetBytes = opt.memoryBudgetBytes;
+  }
+}
+
+void ImportReportTotals::Finish(const std::string& source, const Scene* scene, const std::string& error) {
+  if (report_ == nullptr) {
+    return;
+  }
+  report_->source = source;
+  report_->ok = scene != nullptr;
+  report_->error = error;
+  report_->wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart_).count();
+  report_->cpuMs = 1000.0 * static_cast<double>(std::clock() - cpuStart_) / static_cast<double>(CLOCKS_PER_SEC);
+  const uint64_t heapEnd = QueryHeapInUseBytes();
+  report_->heapDeltaBytes = static_cast<int64_t>(heapEnd) - static_cast<int64_t>(heapStart_);
+  report_->peakResidentBytes = QueryProcessMemory().peakResidentBytes;
+  report_->peakHeapBytes = std::max({report_->peakHeapBytes, heapStart_, heapEnd});
+  if (scene != nullptr) {
+    report_->counts = CountImported(*scene);
+    report_->counts.texturesDecoded = TextureRegistry::Global().Stats().decodedImages - decodedStart_;
+  }
+}
+
+}  // namespace vv
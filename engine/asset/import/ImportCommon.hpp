@@ -0,0 +1,129 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "asset/import/ImportOptions.hpp"
+#include "asset/import/ImportReport.hpp"
+#include "asset/texture/ImageLoader.hpp"
+#include "asset/texture/Ktx2.hpp"
+#include "asset/texture/TextureRegistry.hpp"
+#include "core/io/MappedFile.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+// Pieces every importer shares, so Assimp and native imports of the same content agree.
+
+// Every imported scene starts with these five 1x1 textures (AddDefaultTextures); materials
+// reference them wherever a map is missing.
+constexpr TextureId kDefaultWhiteSrgb = 0;
+constexpr TextureId kDefaultBlackLinear = 1;
+constexpr TextureId kDefaultNormal = 2;
+constexpr TextureId kDefaultSpecular = 3;
+constexpr TextureId kDefaultWhiteLinear = 4;
+
+void AddDefaultTextures(Scene& scene);
+
+// Translation, rotation and scale of an affine matrix; a mirrored basis becomes a negative x scale.
+Transform DecomposeTransform(const Mat4& m);
+
+// A material with every map on its default; for sources without materials.
+Material MakeDefaultMaterial(const std::string& name);
+
+void MarkNormalMaps(Scene& scene);
+void BuildTextureMips(Scene& scene);
+void CompressTextures(Scene& scene, const TextureCompressionOptions& options);
+void FinalizeWorldTransforms(Scene& scene);
+
+// The native passes after a mesh is converted: weld, tangent space for whatever was not authored,
+// clusters, LODs, vertex cache order and packed stream, each timed as a sub-stage of "meshes". `mesh.submeshes` must
+// already cover its indices; morph targets, if any, must already be attached (bounds grow to hold
+// them).
+void FinishImportedMesh(Mesh& mesh,
+                        const ImportOptions& opt,
+                        bool authoredNormals,
+                        bool authoredTangents,
+                        ImportReport* report);
+
+// Backslashes to slashes, surrounding blanks and quotes trimmed, any file:// prefix dropped.
+std::string NormalizeTextureUri(const std::string& uri);
+
+// A texture file named by a model: as given, next to the model, or anywhere below the model's
+// directory through the shared AssetDirectoryIndex (no tree walk). A .ktx2 file next to the one
+// found, with the same stem and not older than it, is taken instead: it holds the cooked mip chain.
+std::optional<std::filesystem::path> ResolveTexturePath(const std::filesystem::path& sourceDir,
+                                                        const std::string& normalizedUri);
+
+// Where a bounded import spills embedded images.
+std::filesystem::path TextureSpillDirectory(const ImportOptions& opt);
+
+// Writes an embedded image to `<dir>/<content hash>-<size>` (.bgra for raw texels) unless an
+// earlier import already did; the temporary-then-rename write keeps concurrent importers from
+// seeing partial files. Empty when the file cannot be written.
+std::string SpillEmbeddedImage(const std::filesystem::path& dir, const uint8_t* bytes, size_t size, uint64_t hash, bool raw);
+
+// One encoded image a native importer's materials reference. The importer fills `uri`, `path` and
+// `data`/`size` (a mapped file, bytes inside the model, or `ownedBytes`); AppendSourceImages fills
+// the rest.
+struct SourceImage {
+  std::string uri;   // Texture::uri: the resolved file, or a source-specific name for embedded images
+  std::string path;  // file the bytes come from; empty for embedded images
+  MappedFile file;
+  std::vector<uint8_t> ownedBytes;
+  const uint8_t* data = nullptr;  // null: not available, requests for it get no texture
+  size_t size = 0;
+
+  uint64_t hash = 0;
+  size_t aliasOf = SIZE_MAX;  // an earlier image with the same bytes, decoded instead of this one
+  uint32_t uses = 0;          // texture requests still to be served (unshared decodes move on the last)
+  std::optional<ImageInfo> info;
+  std::optional<Ktx2Info> ktx2;  // KTX2 bytes: levels are copied, never decoded
+  TextureRegistry::CachedImage shared;  // registry hit, or the registry's decode (compressed imports)
+  std::optional<ImageRgba8> owned;
+  bool decodedHere = false;
+  bool registryHit = false;
+};
+
+struct SourceImageRequest {
+  size_t image = 0;
+  bool srgb = false;
+};
+
+// Hashes the requested images and decodes each distinct content once, in parallel, sharing decodes
+// through TextureRegistry::Global as the Assimp path does (lazy and bounded imports only read the
+// image headers). Then appends one texture per distinct content and color space to `scene`, in
+// request order. Requests must be distinct; each gets its texture, or nullopt when the image has no
+// bytes or does not decode. Timed as "texture_decode" under "materials".
+std::vector<std::optional<TextureId>> AppendSourceImages(Scene& scene,
+                                                         std::vector<SourceImage>& images,
+                                                         const std::vector<SourceImageRequest>& requests,
+                                                         const ImportOptions& opt,
+                                                         ImportReport* report);
+
+ImportCounts CountImported(const Scene& scene);
+
+// Totals of one whole import: construct before the first stage, Finish once on every return.
+// A no-op when `report` is null.
+class ImportReportTotals {
+ public:
+  ImportReportTotals(ImportReport* report, const ImportOptions& opt);
+
+  void Finish(const std::string& source, const Scene* scene, const std::string& error);
+
+ private:
+  ImportReport* report_ = nullptr;
+  std::chrono::steady_clock::time_point wallStart_;
+  std::clock_t cpuStart_ = 0;
+  uint64_t heapStart_ = 0;
+  uint64_t decodedStart_ = 0;
+};
+
+}  // namespace vv
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "asset/mesh/VertexWeld.hpp"
+#include "asset/texture/BlockCompression.hpp"
+
+namespace vv {
+
+// Options shared by every importer (AssimpFbxImporter, FbxImporter, GltfImporter); the Assimp-specific ones
+// are ignored by the native paths.
+struct ImportOptions {
+  bool convertToMeters = true;
+  bool forceRightHanded = true;
+  bool assimpTangentSpace = false;  // Assimp GenNormals/CalcTangentSpace instead of GenerateTangentSpace
+  float normalCreaseAngle = 60.0F;  // degrees; generated normals stay split across sharper edges
+  bool assimpJoinVertices = false;  // Assimp JoinIdenticalVertices/ImproveCacheLocality instead of WeldVertices/OptimizeVertexCache
+  bool nativeFbx = false;           // binary FBX through FbxImporter; Assimp only for what it cannot read
+  uint32_t maxBoneInfluence = 4;
+  bool pruneScene = false;  // drop bones, nodes and tracks that move nothing drawn (see PruneScene)
+  bool packMaterialTextures = false;  // occlusion/roughness/metallic into one texture (see PackMaterialTextures)
+  VertexWeldOptions vertexWeld;
+  bool quantizeVertices = false;  // also build the packed GPU vertex stream (see VertexLayout)
+  bool buildClusters = true;      // meshlets with bounds/normal cones (see MeshCluster)
+  uint32_t lodCount = 3;          // simplified index ranges appended per mesh (see MeshLod)
+  bool generateMips = true;       // full CPU mip chains in Texture::pixels
+  bool compressTextures = false;  // BC-encode every texture after mips (see BlockCompression)
+  TextureCompressionOptions textureCompression;
+  bool shareDecodedTextures = true;  // reuse decoded images across imports (TextureRegistry::Global)
+  bool lazyTextureDecode = false;    // keep only TextureSource handles; decode at upload (not with compression)
+  bool shareAssets = true;  // meshes, skeletons, clips and textures equal to a loaded scene's are shared (AssetRegistry::Global)
+  std::string assetRoot;  // share one directory index for every import below it (see AssetDirectoryIndex)
+  // > 0: bounded-memory import. Each source mesh, material, embedded texture and animation is freed
+  // once converted, and textures stay lazy with embedded images spilled to `textureSpillDir`, so
+  // nothing decoded is held (mips and compression are left to whoever decodes them). The report
+  // records the budget next to the measured heap peak.
+  uint64_t memoryBudgetBytes = 0;
+  std::string textureSpillDir;  // one file per image content; empty = <temp>/vividvision-textures
+};
+
+struct ImportError {
+  std::string message;
+};
+
+}  // namespace vv
@@ -0,0 +1,161 @@
+#include "asset/import/ImportReport.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+#include "core/memory/PixelBuffer.hpp"
+#include "core/memory/ProcessMemory.hpp"
+
+namespace vv {
+namespace {
+
+void AppendJsonString(std::ostringstream& out, const std::string& value) {
+  out << '"';
+  for (const char c : value) {
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      case '\r':
+        out << "\\r";
+        break;
+      case '\t':
+        out << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          char escaped[8];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+          out << escaped;
+        } else {
+          out << c;
+        }
+    }
+  }
+  out << '"';
+}
+
+void NotePeakHeap(ImportReport& report, uint64_t heapBytes) {
+  report.peakHeapBytes = std::max(report.peakHeapBytes, heapBytes);
+}
+
+double CpuMsSince(std::clock_t start) {
+  return 1000.0 * static_cast<double>(std::clock() - start) / static_cast<double>(CLOCKS_PER_SEC);
+}
+
+}  // namespace
+
+ImportStageReport& ImportReport::Stage(const std::string& name, const std::string& parent) {
+  for (ImportStageReport& stage : stages) {
+    if (stage.name == name) {
+      return stage;
+    }
+  }
+  ImportStageReport& stage = stages.emplace_back();
+  stage.name = name;
+  stage.parent = parent;
+  return stage;
+}
+
+const ImportStageReport* ImportReport::FindStage(const std::string& name) const {
+  for (const ImportStageReport& stage : stages) {
+    if (stage.name == name) {
+      return &stage;
+    }
+  }
+  return nullptr;
+}
+
+std::string ImportReportToJson(const ImportReport& report) {
+  std::ostringstream out;
+  out.setf(std::ios::fixed);
+  out.precision(3);
+  out << "{\n  \"source\": ";
+  AppendJsonString(out, report.source);
+  out << ",\n  \"ok\": " << (report.ok ? "true" : "false") << ",\n  \"error\": ";
+  AppendJsonString(out, report.error);
+  if (!report.fallback.empty()) {
+    out << ",\n  \"fallback\": ";
+    AppendJsonString(out, report.fallback);
+  }
+  out << ",\n  \"wallMs\": " << report.wallMs << ",\n  \"cpuMs\": " << report.cpuMs
+      << ",\n  \"heapDeltaBytes\": " << report.heapDeltaBytes << ",\n  \"peakResidentBytes\": " << report.peakResidentBytes
+      << ",\n  \"peakHeapBytes\": " << report.peakHeapBytes << ",\n  \"memoryBudgetBytes\": " << report.memoryBudgetBytes;
+
+  const ImportCounts& c = report.counts;
+  out << ",\n  \"counts\": {\"nodes\": " << c.nodes << ", \"meshes\": " << c.meshes << ", \"vertices\": " << c.vertices
+      << ", \"triangles\": " << c.triangles << ", \"materials\": " << c.materials << ", \"textures\": " << c.textures
+      << ", \"texturesDecoded\": " << c.texturesDecoded << ", \"skins\": " << c.skins << ", \"skeletons\": " << c.skeletons
+      << ", \"bones\": " << c.bones << ", \"clips\": " << c.clips << ", \"tracks\": " << c.tracks << ", \"keys\": " << c.keys
+      << ", \"lights\": " << c.lights << ", \"morphTargets\": " << c.morphTargets
+      << ", \"morphVertices\": " << c.morphVertices << ", \"morphTracks\": " << c.morphTracks << "}";
+
+  const ImportPruneStats& p = report.pruned;
+  out << ",\n  \"pruned\": {\"bones\": " << p.bones << ", \"nodes\": " << p.nodes << ", \"tracks\": " << p.tracks
+      << ", \"channels\": " << p.channels << ", \"keys\": " << p.keys << ", \"bytes\": " << p.bytes << "}";
+
+  const ImportPackStats& k = report.packed;
+  out << ",\n  \"packed\": {\"materials\": " << k.materials << ", \"textures\": " << k.textures << ", \"built\": " << k.built
+      << ", \"bytes\": " << k.bytes << ", \"builtBytes\": " << k.builtBytes << "}";
+
+  out << ",\n  \"stages\": [";
+  for (size_t i = 0; i < report.stages.size(); ++i) {
+    const ImportStageReport& stage = report.stages[i];
+    out << (i == 0 ? "\n" : ",\n") << "    {\"name\": ";
+    AppendJsonString(out, stage.name);
+    if (!stage.parent.empty()) {
+      out << ", \"parent\": ";
+      AppendJsonString(out, stage.parent);
+    }
+    out << ", \"wallMs\": " << stage.wallMs << ", \"cpuMs\": " << stage.cpuMs << ", \"heapDeltaBytes\": " << stage.heapDeltaBytes
+        << ", \"pixelBytes\": " << stage.pixelBytes << ", \"calls\": " << stage.calls << ", \"items\": " << stage.items << "}";
+  }
+  out << (report.stages.empty() ? "]\n}\n" : "\n  ]\n}\n");
+  return out.str();
+}
+
+ScopedImportStage::ScopedImportStage(ImportReport* report, const char* name, const char* parent)
+    : report_(report), name_(name), parent_(parent) {
+  if (report_ == nullptr) {
+    return;
+  }
+  sampleHeap_ = parent_[0] == '\0' || report_->nestedHeapSamples;
+  if (sampleHeap_) {
+    heapStart_ = QueryHeapInUseBytes();
+    NotePeakHeap(*report_, heapStart_);
+  }
+  pixelStart_ = GetPixelBufferCounters().allocatedBytes;
+  cpuStart_ = std::clock();
+  wallStart_ = std::chrono::steady_clock::now();
+}
+
+ScopedImportStage::~ScopedImportStage() {
+  if (report_ == nullptr) {
+    return;
+  }
+  const double wallMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart_).count();
+  const double cpuMs = CpuMsSince(cpuStart_);
+  ImportStageReport& stage = report_->Stage(name_, parent_);
+  if (sampleHeap_) {
+    const uint64_t heapEnd = QueryHeapInUseBytes();
+    NotePeakHeap(*report_, heapEnd);
+    stage.heapDeltaBytes += static_cast<int64_t>(heapEnd) - static_cast<int64_t>(heapStart_);
+  }
+  stage.wallMs += wallMs;
+  stage.cpuMs += cpuMs;
+  stage.pixelBytes += GetPixelBufferCounters().allocatedBytes - pixelStart_;
+  stage.calls += 1;
+  stage.items += items_;
+  if (report_->onStageEnd) {
+    report_->onStageEnd(stage);
+  }
+}
+
+}  // namespace vv
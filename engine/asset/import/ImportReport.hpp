@@ -0,0 +1,113 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace vv {
+
+struct ImportStageReport {
+  std::string name;
+  std::string parent;          // enclosing stage; empty for top-level stages
+  double wallMs = 0.0;
+  double cpuMs = 0.0;          // process CPU time, worker threads included
+  int64_t heapDeltaBytes = 0;  // net change of heap bytes in use across the stage (see nestedHeapSamples)
+  uint64_t pixelBytes = 0;     // allocated by PixelBuffer growth/copies (adopted decoder output excluded)
+  uint64_t calls = 0;          // nested stages accumulate over every call
+  uint64_t items = 0;          // stage-specific unit: nodes, materials, textures, meshes, ...
+};
+
+struct ImportCounts {
+  uint64_t nodes = 0;
+  uint64_t meshes = 0;
+  uint64_t vertices = 0;
+  uint64_t triangles = 0;
+  uint64_t materials = 0;
+  uint64_t textures = 0;
+  uint64_t texturesDecoded = 0;  // decoded during this import (not lazy, not reused)
+  uint64_t skins = 0;
+  uint64_t skeletons = 0;
+  uint64_t bones = 0;
+  uint64_t clips = 0;
+  uint64_t tracks = 0;
+  uint64_t keys = 0;
+  uint64_t lights = 0;
+  uint64_t morphTargets = 0;
+  uint64_t morphVertices = 0;  // sparse entries over all targets
+  uint64_t morphTracks = 0;
+};
+
+// What ImportOptions::pruneScene removed (see PruneScene).
+struct ImportPruneStats {
+  uint64_t bones = 0;     // skeleton bones no skin weights, directly or through a descendant
+  uint64_t nodes = 0;     // nodes dropped, or folded into a static child
+  uint64_t tracks = 0;    // whole tracks dropped
+  uint64_t channels = 0;  // constant channels dropped or cut to one key
+  uint64_t keys = 0;
+  uint64_t bytes = 0;     // bone, node and key storage released
+};
+
+// What ImportOptions::packMaterialTextures changed (see PackMaterialTextures).
+struct ImportPackStats {
+  uint64_t materials = 0;   // materials now sampling occlusion, roughness and metallic from one texture
+  uint64_t textures = 0;    // source textures no material samples any more, dropped
+  uint64_t built = 0;       // packed textures added
+  uint64_t bytes = 0;       // resident texels of the dropped textures
+  uint64_t builtBytes = 0;  // resident texels of the packed ones
+};
+
+// Where an import spends time and memory; filled by the importers' Import when requested.
+// Top-level stages run back to back, so their wall times add up to roughly `wallMs`.
+struct ImportReport {
+  std::string source;
+  std::vector<std::string> externalFiles;  // read besides `source` and its textures (glTF buffers)
+  bool ok = false;
+  std::string error;
+  std::string fallback;  // why the native FBX reader handed the file to Assimp; empty otherwise
+  double wallMs = 0.0;
+  double cpuMs = 0.0;
+  int64_t heapDeltaBytes = 0;      // heap still held after the import (scene included)
+  uint64_t peakResidentBytes = 0;  // process high-water mark at the end of the import
+  uint64_t peakHeapBytes = 0;      // most heap in use seen at any sampled stage boundary
+  uint64_t memoryBudgetBytes = 0;  // ImportOptions::memoryBudgetBytes; 0 = unbounded
+  ImportCounts counts;
+  ImportPruneStats pruned;
+  ImportPackStats packed;
+  std::vector<ImportStageReport> stages;
+  std::function<void(const ImportStageReport&)> onStageEnd;  // optional; sees each stage as it closes
+  // Heap use is sampled at top-level stage boundaries only: a sample walks every malloc arena, and
+  // nested stages run once per mesh or texture. Set before the import to sample those too.
+  bool nestedHeapSamples = false;
+
+  ImportStageReport& Stage(const std::string& name, const std::string& parent = {});
+  const ImportStageReport* FindStage(const std::string& name) const;
+};
+
+std::string ImportReportToJson(const ImportReport& report);
+
+// Times one stage into `report`; a no-op when `report` is null. Repeated stages accumulate.
+class ScopedImportStage {
+ public:
+  ScopedImportStage(ImportReport* report, const char* name, const char* parent = "");
+  ~ScopedImportStage();
+  ScopedImportStage(const ScopedImportStage&) = delete;
+  ScopedImportStage& operator=(const ScopedImportStage&) = delete;
+
+  void AddItems(uint64_t count) { items_ += count; }
+
+ private:
+  ImportReport* report_ = nullptr;
+  const char* name_ = "";
+  const char* parent_ = "";
+  std::chrono::steady_clock::time_point wallStart_;
+  std::clock_t cpuStart_ = 0;
+  bool sampleHeap_ = false;
+  uint64_t heapStart_ = 0;
+  uint64_t pixelStart_ = 0;
+  uint64_t items_ = 0;
+};
+
+}  // namespace vv
@@ -0,0 +1,239 @@
+#include "asset/import/MaterialPacking.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "asset/import/ImportCommon.hpp"
+#include "asset/texture/BlockCompression.hpp"
+#include "asset/texture/ImageLoader.hpp"
+#include "asset/texture/Ktx2.hpp"
+#include "asset/texture/TextureRegistry.hpp"
+
+namespace vv {
+namespace {
+
+struct ChannelSource {
+  TextureId texture = 0;
+  uint32_t channel = 0;
+
+  auto operator<=>(const ChannelSource&) const = default;
+};
+
+// Occlusion, roughness and metallic: the packed texture's R, G and B.
+using OrmSources = std::array<ChannelSource, 3>;
+
+OrmSources SourcesOf(const Material& m) {
+  if (m.useSeparateMetalRoughness) {
+    return {{{m.occlusionTex, 0}, {m.roughnessTex, 0}, {m.metallicTex, 0}}};
+  }
+  return {{{m.occlusionTex, 0}, {m.metallicRoughnessTex, 1}, {m.metallicRoughnessTex, 2}}};
+}
+
+template <typename MaterialT, typename Fn>
+void ForEachTextureSlot(MaterialT& m, Fn&& fn) {
+  fn(m.baseColorTex);
+  fn(m.metallicRoughnessTex);
+  fn(m.metallicTex);
+  fn(m.roughnessTex);
+  fn(m.normalTex);
+  fn(m.occlusionTex);
+  fn(m.emissiveTex);
+  fn(m.specularTex);
+}
+
+std::vector<uint8_t> ReferencedTextures(const Scene& scene) {
+  std::vector<uint8_t> used(scene.textures.size(), 0);
+  for (const Material& material : scene.materials) {
+    ForEachTextureSlot(material, [&](TextureId id) {
+      if (id < used.size()) {
+        used[id] = 1;
+      }
+    });
+  }
+  return used;
+}
+
+// Level 0 as RGBA8, whether the texture holds it, a lazy source names it or it is block compressed.
+std::optional<ImageRgba8> DecodeLevel0(const Texture& texture) {
+  Texture resident;
+  const Texture* held = &texture;
+  if (texture.pixels.empty()) {
+    if (!HasLazySource(texture)) {
+      return std::nullopt;
+    }
+    if (!IsKtx2Source(texture.source)) {
+      return DecodeTextureSource(texture.source);
+    }
+    Ktx2Source ktx2;
+    if (!ktx2.Open(texture.source)) {
+      return std::nullopt;
+    }
+    resident = MakeKtx2Texture(ktx2.Info(), texture.srgb);
+    resident.pixels = PixelBuffer(Ktx2ChainBytes(ktx2.Info()));
+    if (!ktx2.ReadLevels(resident.pixels.data())) {
+      return std::nullopt;
+    }
+    held = &resident;
+  }
+  Texture decompressed;
+  if (IsBlockCompressed(held->format)) {
+    if (!DecompressTexture(*held, decompressed)) {
+      return std::nullopt;
+    }
+    held = &decompressed;
+  }
+  const size_t bytes = static_cast<size_t>(held->width) * held->height * 4;
+  if (bytes == 0 || held->pixels.size() < bytes) {
+    return std::nullopt;
+  }
+  return ImageRgba8{.width = held->width, .height = held->height, .pixels = PixelBuffer::Copy(held->pixels.data(), bytes)};
+}
+
+// Bilinear with texel centers aligned and edges clamped, so a source at the packed size is copied
+// exactly and a 1x1 default reads as its constant.
+uint8_t SampleChannel(const ImageRgba8& image, uint32_t channel, float u, float v) {
+  const float x = std::clamp(u * static_cast<float>(image.width) - 0.5F, 0.0F, static_cast<float>(image.width - 1));
+  const float y = std::clamp(v * static_cast<float>(image.height) - 0.5F, 0.0F, static_cast<float>(image.height - 1));
+  const auto x0 = static_cast<uint32_t>(x);
+  const auto y0 = static_cast<uint32_t>(y);
+  const uint32_t x1 = std::min(x0 + 1, image.width - 1);
+  const uint32_t y1 = std::min(y0 + 1, image.height - 1);
+  const float fx = x - static_cast<float>(x0);
+  const float fy = y - static_cast<float>(y0);
+  const auto at = [&](uint32_t px, uint32_t py) {
+    return static_cast<float>(image.pixels[(static_cast<size_t>(py) * image.width + px) * 4 + channel]);
+  };
+  const float top = at(x0, y0) + (at(x1, y0) - at(x0, y0)) * fx;
+  const float bottom = at(x0, y1) + (at(x1, y1) - at(x0, y1)) * fx;
+  return static_cast<uint8_t>(std::lround(top + (bottom - top) * fy));
+}
+
+Texture BakeOrm(const Scene& scene, const OrmSources& sources, const std::array<const ImageRgba8*, 3>& images) {
+  Texture orm;
+  orm.uri = "orm:";
+  for (size_t c = 0; c < sources.size(); ++c) {
+    orm.uri += (c == 0 ? "" : "|") + scene.textures[sources[c].texture]->uri;
+    orm.width = std::max(orm.width, images[c]->width);
+    orm.height = std::max(orm.height, images[c]->height);
+  }
+  orm.format = PixelFormat::kR8G8B8A8;
+  orm.pixels = PixelBuffer(static_cast<size_t>(orm.width) * orm.height * 4);
+  for (uint32_t y = 0; y < orm.height; ++y) {
+    const float v = (static_cast<float>(y) + 0.5F) / static_cast<float>(orm.height);
+    for (uint32_t x = 0; x < orm.width; ++x) {
+      const float u = (static_cast<float>(x) + 0.5F) / static_cast<float>(orm.width);
+      uint8_t* texel = orm.pixels.data() + (static_cast<size_t>(y) * orm.width + x) * 4;
+      for (size_t c = 0; c < sources.size(); ++c) {
+        texel[c] = SampleChannel(*images[c], sources[c].channel, u, v);
+      }
+      texel[3] = 255;
+    }
+  }
+  orm.contentHash = HashBytes(orm.pixels.data(), orm.pixels.size());
+  return orm;
+}
+
+bool IsWhiteTexel(const Texture& texture) {
+  return texture.width == 1 && texture.height == 1 &&
+         std::all_of(texture.pixels.begin(), texture.pixels.end(), [](uint8_t value) { return value == 255; });
+}
+
+// Removes textures packing left unsampled (never the defaults) and renumbers the rest.
+void DropOrphanedTextures(Scene& scene, const std::vector<uint8_t>& usedBefore, ImportPackStats& stats) {
+  const std::vector<uint8_t> usedAfter = ReferencedTextures(scene);
+  std::vector<TextureId> remap(scene.textures.size());
+  size_t kept = 0;
+  for (size_t id = 0; id < scene.textures.size(); ++id) {
+    const bool orphaned = id > kDefaultWhiteLinear && id < usedBefore.size() && usedBefore[id] != 0 && usedAfter[id] == 0;
+    if (orphaned) {
+      ++stats.textures;
+      stats.bytes += scene.textures[id]->pixels.size();
+      continue;
+    }
+    remap[id] = static_cast<TextureId>(kept);
+    if (kept != id) {
+      scene.textures[kept] = std::move(scene.textures[id]);
+    }
+    ++kept;
+  }
+  if (kept == scene.textures.size()) {
+    return;
+  }
+  scene.textures.resize(kept);
+  for (Material& material : scene.materials) {
+    ForEachTextureSlot(material, [&](TextureId& id) {
+      if (id < remap.size()) {
+        id = remap[id];
+      }
+    });
+  }
+}
+
+}  // namespace
+
+bool UsesPackedOrm(const Material& material) {
+  return !material.useSeparateMetalRoughness && material.occlusionTex == material.metallicRoughnessTex;
+}
+
+ImportPackStats PackMaterialTextures(Scene& scene) {
+  ImportPackStats stats;
+  const size_t sourceCount = scene.textures.size();
+  const std::vector<uint8_t> usedBefore = ReferencedTextures(scene);
+  std::unordered_map<TextureId, std::optional<ImageRgba8>> decoded;
+  const auto level0 = [&](TextureId id) -> const ImageRgba8* {
+    if (id >= sourceCount) {
+      return nullptr;
+    }
+    auto [it, inserted] = decoded.try_emplace(id);
+    if (inserted) {
+      it->second = DecodeLevel0(scene.textures[id]);
+    }
+    return it->second.has_value() ? &*it->second : nullptr;
+  };
+
+  std::map<OrmSources, TextureId> baked;
+  for (Material& material : scene.materials) {
+    if (UsesPackedOrm(material)) {
+      continue;
+    }
+    const OrmSources sources = SourcesOf(material);
+    auto packed = baked.find(sources);
+    if (packed == baked.end()) {
+      std::array<const ImageRgba8*, 3> images{};
+      for (size_t c = 0; c < sources.size(); ++c) {
+        images[c] = level0(sources[c].texture);
+      }
+      if (std::find(images.begin(), images.end(), nullptr) != images.end()) {
+        continue;
+      }
+      Texture orm = BakeOrm(scene, sources, images);
+      TextureId id = kDefaultWhiteLinear;
+      if (!IsWhiteTexel(orm) || scene.textures.size() <= kDefaultWhiteLinear) {
+        id = static_cast<TextureId>(scene.textures.size());
+        ++stats.built;
+        stats.builtBytes += orm.pixels.size();
+        scene.textures.push_back(std::move(orm));
+      }
+      packed = baked.emplace(sources, id).first;
+    }
+    material.metallicRoughnessTex = packed->second;
+    material.occlusionTex = packed->second;
+    material.metallicTex = kDefaultBlackLinear;
+    material.roughnessTex = kDefaultWhiteLinear;
+    material.useSeparateMetalRoughness = false;
+    ++stats.materials;
+  }
+
+  DropOrphanedTextures(scene, usedBefore, stats);
+  return stats;
+}
+
+}  // namespace vv
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "asset/import/ImportReport.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+// True when one texture carries the material's occlusion (R), roughness (G) and metallic (B): the
+// glTF metallicRoughness layout with occlusion in red. Such materials are drawn with the shader
+// variant that fetches that texture once instead of four maps.
+bool UsesPackedOrm(const Material& material);
+
+// Gives every material that does not already use one a packed ORM texture (ImportOptions::
+// packMaterialTextures). Each distinct combination of occlusion, roughness and metallic sources is
+// baked once into a linear RGBA8 texture at the size of its largest source; materials point their
+// metallicRoughness and occlusion slots at it and drop the separate maps. Specular-glossiness
+// materials get their occlusion packed; their specular color stays its own sRGB texture. Textures no
+// material samples any more are removed and the remaining ones renumbered. Runs before mips and
+// compression, so the packed textures get both; sources that are lazy, KTX2 or block compressed
+// are decoded to read their channels.
+ImportPackStats PackMaterialTextures(Scene& scene);
+
+}  // namespace vv
@@ -0,0 +1,53 @@
+#include "asset/import/SceneImporter.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <utility>
+
+#include "asset/import/AssimpFbxImporter.hpp"
+#include "asset/import/FbxImporter.hpp"
+#include "asset/import/GltfImporter.hpp"
+#include "asset/registry/AssetRegistry.hpp"
+
+namespace vv {
+
+bool IsGltfPath(const std::string& path) {
+  std::string ext = std::filesystem::path(path).extension().string();
+  std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+  return ext == ".gltf" || ext == ".glb";
+}
+
+namespace {
+
+LoadResult<Scene> ImportWithImporter(const std::string& path, const ImportOptions& opt, ImportReport* report) {
+  if (IsGltfPath(path)) {
+    return GltfImporter().Import(path, opt, report);
+  }
+  if (opt.nativeFbx) {
+    LoadResult<Scene> native = FbxImporter().Import(path, opt, report);
+    if (native.Ok()) {
+      return native;
+    }
+    // The report describes the import that produced the scene; only the reason survives.
+    if (report != nullptr) {
+      ImportReport fresh;
+      fresh.onStageEnd = std::move(report->onStageEnd);
+      fresh.fallback = native.error;
+      *report = std::move(fresh);
+    }
+  }
+  return AssimpFbxImporter().Import(path, opt, report);
+}
+
+}  // namespace
+
+LoadResult<Scene> ImportSceneFile(const std::string& path, const ImportOptions& opt, ImportReport* report) {
+  LoadResult<Scene> loaded = ImportWithImporter(path, opt, report);
+  if (loaded.Ok() && opt.shareAssets) {
+    AssetRegistry::Global().Intern(*loaded.value);
+  }
+  return loaded;
+}
+
+}  // namespace vv
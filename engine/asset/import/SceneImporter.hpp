@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+
+#include "asset/import/ImportOptions.hpp"
+#include "asset/import/ImportReport.hpp"
+#include "core/types/CommonTypes.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+// .gltf and .glb (case-insensitive).
+bool IsGltfPath(const std::string& path);
+
+// Picks the importer by extension: GltfImporter for glTF, AssimpFbxImporter for everything else.
+// With ImportOptions::nativeFbx, FbxImporter is tried first and Assimp only gets the files it
+// declines; the reason lands in ImportReport::fallback.
+// With ImportOptions::shareAssets the result shares every asset equal to one a loaded scene holds.
+LoadResult<Scene> ImportSceneFile(const std::string& path, const ImportOptions& opt, ImportReport* report = nullptr);
+
+}  // namespace vv
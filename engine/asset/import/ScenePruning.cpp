@@ -0,0 +1,302 @@
+#include "asset/import/ScenePruning.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "asset/import/ImportCommon.hpp"
+
+namespace vv {
+namespace {
+
+constexpr float kConstantTolerance = 1e-5F;  // relative to the larger of 1 and the value
+
+bool NearlyEqual(const Vec3& a, const Vec3& b) {
+  const float scale = std::max({1.0F, std::fabs(a.x), std::fabs(a.y), std::fabs(a.z)});
+  const Vec3 d = glm::abs(a - b);
+  return std::max({d.x, d.y, d.z}) <= kConstantTolerance * scale;
+}
+
+// q and -q are the same rotation.
+bool NearlyEqual(const Quat& a, const Quat& b) {
+  const Quat na = glm::normalize(a);
+  Quat nb = glm::normalize(b);
+  if (glm::dot(na, nb) < 0.0F) {
+    nb = -nb;
+  }
+  return std::max({std::fabs(na.x - nb.x), std::fabs(na.y - nb.y), std::fabs(na.z - nb.z), std::fabs(na.w - nb.w)}) <=
+         kConstantTolerance;
+}
+
+bool NearlyEqual(const Mat4& a, const Mat4& b) {
+  float scale = 1.0F;
+  float diff = 0.0F;
+  for (int c = 0; c < 4; ++c) {
+    for (int r = 0; r < 4; ++r) {
+      scale = std::max(scale, std::fabs(a[c][r]));
+      diff = std::max(diff, std::fabs(a[c][r] - b[c][r]));
+    }
+  }
+  return diff <= 1e-4F * scale;
+}
+
+template <typename Key, typename Value>
+void PruneChannel(std::vector<Key>& keys, const Value& bind, ImportPruneStats& stats) {
+  if (keys.empty()) {
+    return;
+  }
+  for (const Key& key : keys) {
+    if (!NearlyEqual(key.value, keys.front().value)) {
+      return;
+    }
+  }
+  const size_t keep = NearlyEqual(keys.front().value, bind) ? 0 : 1;
+  if (keys.size() == keep) {
+    return;
+  }
+  ++stats.channels;
+  stats.keys += keys.size() - keep;
+  stats.bytes += (keys.size() - keep) * sizeof(Key);
+  keys.resize(keep);
+  keys.shrink_to_fit();
+}
+
+size_t KeyCount(const NodeTrack& track) {
+  return track.posKeys.size() + track.rotKeys.size() + track.sclKeys.size();
+}
+
+uint64_t TrackBytes(const NodeTrack& track) {
+  return sizeof(NodeTrack) + (track.posKeys.size() + track.sclKeys.size()) * sizeof(KeyVec3) +
+         track.rotKeys.size() * sizeof(KeyQuat);
+}
+
+// Bones some skin weights, plus their bone ancestors, per skeleton.
+std::vector<std::vector<uint8_t>> KeptBones(const Scene& scene) {
+  std::vector<std::vector<uint8_t>> kept(scene.skeletons.size());
+  for (size_t s = 0; s < scene.skeletons.size(); ++s) {
+    const std::vector<Bone>& bones = scene.skeletons[s]->bones;
+    std::vector<uint8_t>& keep = kept[s];
+    keep.assign(bones.size(), 0);
+    bool anySkin = false;
+    bool identity = false;
+    for (const Skin& skin : scene.skins) {
+      if (skin.skeleton != s) {
+        continue;
+      }
+      anySkin = true;
+      identity = identity || skin.joints.empty();
+      for (const uint32_t bone : skin.joints) {
+        if (bone < bones.size()) {
+          keep[bone] = 1;
+        }
+      }
+    }
+    if (!anySkin || identity) {
+      std::fill(keep.begin(), keep.end(), 1);
+      continue;
+    }
+    for (size_t b = 0; b < bones.size(); ++b) {
+      if (keep[b] == 0) {
+        continue;
+      }
+      for (int32_t p = bones[b].parentBone; p >= 0 && static_cast<size_t>(p) < bones.size() && keep[p] == 0;
+           p = bones[p].parentBone) {
+        keep[p] = 1;
+      }
+    }
+  }
+  return kept;
+}
+
+}  // namespace
+
+ImportPruneStats PruneScene(Scene& scene) {
+  ImportPruneStats stats;
+  const size_t nodeCount = scene.nodes.size();
+
+  for (SharedAsset<AnimationClip>& asset : scene.clips) {
+    for (NodeTrack& track : asset.Edit().tracks) {
+      if (track.node < nodeCount) {
+        const Transform& bind = scene.nodes[track.node].localBind;
+        PruneChannel(track.posKeys, bind.translation, stats);
+        PruneChannel(track.rotKeys, bind.rotation, stats);
+        PruneChannel(track.sclKeys, bind.scale, stats);
+      }
+    }
+  }
+
+  // Nodes something depends on: kept bones, nodes with a mesh, skin or light, and their ancestors.
+  const std::vector<std::vector<uint8_t>> keptBones = KeptBones(scene);
+  std::vector<uint8_t> needed(nodeCount, 0);
+  std::vector<uint8_t> boneNode(nodeCount, 0);
+  const auto markNeeded = [&](NodeId node) {
+    while (node < nodeCount && needed[node] == 0) {
+      needed[node] = 1;
+      node = scene.nodes[node].parent;
+    }
+  };
+  for (size_t n = 0; n < nodeCount; ++n) {
+    const Node& node = scene.nodes[n];
+    if (node.mesh.has_value() || node.skin.has_value() || node.light.has_value()) {
+      markNeeded(static_cast<NodeId>(n));
+    }
+  }
+  for (size_t s = 0; s < scene.skeletons.size(); ++s) {
+    for (size_t b = 0; b < scene.skeletons[s]->bones.size(); ++b) {
+      const NodeId node = scene.skeletons[s]->bones[b].node;
+      if (keptBones[s][b] != 0 && node < nodeCount) {
+        boneNode[node] = 1;
+        markNeeded(node);
+      }
+    }
+  }
+
+  std::vector<uint8_t> animated(nodeCount, 0);
+  for (SharedAsset<AnimationClip>& asset : scene.clips) {
+    AnimationClip& clip = asset.Edit();
+    const auto dropped = std::remove_if(clip.tracks.begin(), clip.tracks.end(), [&](const NodeTrack& track) {
+      return track.node >= nodeCount || needed[track.node] == 0 || KeyCount(track) == 0;
+    });
+    for (auto it = dropped; it != clip.tracks.end(); ++it) {
+      ++stats.tracks;
+      stats.keys += KeyCount(*it);
+      stats.bytes += TrackBytes(*it);
+    }
+    clip.tracks.erase(dropped, clip.tracks.end());
+    for (const NodeTrack& track : clip.tracks) {
+      animated[track.node] = 1;
+    }
+  }
+
+  // Fold static helpers into their only needed child, top-down, so a chain ends up as its lowest
+  // node. Combinations a Transform cannot hold (shear from non-uniform scale) are left alone.
+  std::vector<NodeId> parentOf(nodeCount, kInvalidNodeId);
+  std::vector<uint32_t> neededChildren(nodeCount, 0);
+  for (size_t n = 0; n < nodeCount; ++n) {
+    parentOf[n] = scene.nodes[n].parent;
+    if (needed[n] != 0 && parentOf[n] < nodeCount) {
+      ++neededChildren[parentOf[n]];
+    }
+  }
+  const auto isStaticHelper = [&](NodeId n) {
+    const Node& node = scene.nodes[n];
+    return needed[n] != 0 && boneNode[n] == 0 && animated[n] == 0 && !node.mesh.has_value() &&
+           !node.skin.has_value() && !node.light.has_value();
+  };
+  std::vector<uint8_t> removed(nodeCount, 0);
+  for (size_t n = 0; n < nodeCount; ++n) {
+    removed[n] = needed[n] == 0 ? 1 : 0;
+  }
+  std::vector<NodeId> stack(scene.roots.rbegin(), scene.roots.rend());
+  while (!stack.empty()) {
+    const NodeId child = stack.back();
+    stack.pop_back();
+    if (child >= nodeCount || needed[child] == 0) {
+      continue;
+    }
+    const NodeId parent = parentOf[child];
+    if (parent < nodeCount && isStaticHelper(parent) && isStaticHelper(child) && neededChildren[parent] == 1) {
+      const Mat4 combined = scene.nodes[parent].localBind.ToMat4() * scene.nodes[child].localBind.ToMat4();
+      const Transform folded = DecomposeTransform(combined);
+      if (NearlyEqual(folded.ToMat4(), combined)) {
+        scene.nodes[child].localBind = folded;
+        scene.nodes[child].localCurrent = folded;
+        parentOf[child] = parentOf[parent];
+        removed[parent] = 1;
+      }
+    }
+    const std::vector<NodeId>& children = scene.nodes[child].children;
+    stack.insert(stack.end(), children.rbegin(), children.rend());
+  }
+
+  std::vector<NodeId> newId(nodeCount, kInvalidNodeId);
+  NodeId next = 0;
+  for (size_t n = 0; n < nodeCount; ++n) {
+    if (removed[n] != 0) {
+      ++stats.nodes;
+      stats.bytes += sizeof(Node) + scene.nodes[n].name.size();
+    } else {
+      newId[n] = next++;
+    }
+  }
+  if (stats.nodes > 0) {
+    std::vector<Node> nodes;
+    nodes.reserve(next);
+    scene.roots.clear();
+    for (size_t n = 0; n < nodeCount; ++n) {
+      if (removed[n] != 0) {
+        continue;
+      }
+      Node& node = nodes.emplace_back(std::move(scene.nodes[n]));
+      node.parent = parentOf[n] < nodeCount ? newId[parentOf[n]] : kInvalidNodeId;
+      node.children.clear();
+      if (node.parent == kInvalidNodeId) {
+        scene.roots.push_back(newId[n]);
+      } else {
+        nodes[node.parent].children.push_back(newId[n]);
+      }
+    }
+    scene.nodes = std::move(nodes);
+    for (SharedAsset<AnimationClip>& asset : scene.clips) {
+      AnimationClip& clip = asset.Edit();
+      for (NodeTrack& track : clip.tracks) {
+        track.node = newId[track.node];
+      }
+      std::erase_if(clip.morphTracks, [&](const MorphWeightTrack& track) {
+        return track.node >= nodeCount || newId[track.node] == kInvalidNodeId;
+      });
+      for (MorphWeightTrack& track : clip.morphTracks) {
+        track.node = newId[track.node];
+      }
+    }
+  }
+  const auto remapNode = [&](NodeId node) { return node < nodeCount ? newId[node] : node; };
+
+  for (size_t s = 0; s < scene.skeletons.size(); ++s) {
+    Skeleton& skeleton = scene.skeletons[s].Edit();
+    const std::vector<uint8_t>& keep = keptBones[s];
+    std::vector<int32_t> newBone(skeleton.bones.size(), -1);
+    std::vector<Bone> bones;
+    for (size_t b = 0; b < skeleton.bones.size(); ++b) {
+      if (keep[b] == 0) {
+        ++stats.bones;
+        stats.bytes += sizeof(Bone) + skeleton.bones[b].name.size();
+        continue;
+      }
+      newBone[b] = static_cast<int32_t>(bones.size());
+      bones.push_back(std::move(skeleton.bones[b]));
+    }
+    for (Bone& bone : bones) {
+      bone.node = remapNode(bone.node);
+      bone.parentBone = bone.parentBone >= 0 ? newBone[bone.parentBone] : -1;
+    }
+    const NodeId oldRoot = skeleton.rootNode;
+    skeleton.rootNode = oldRoot < nodeCount && removed[oldRoot] == 0 ? newId[oldRoot] : kInvalidNodeId;
+    if (oldRoot != kInvalidNodeId && skeleton.rootNode == kInvalidNodeId) {
+      const auto root = std::find_if(bones.begin(), bones.end(), [](const Bone& bone) { return bone.parentBone < 0; });
+      skeleton.rootNode = root != bones.end() ? root->node : kInvalidNodeId;
+    }
+    std::unordered_map<std::string, uint32_t> boneMap;
+    for (const auto& [name, index] : skeleton.boneMap) {
+      if (index < newBone.size() && newBone[index] >= 0) {
+        boneMap.emplace(name, static_cast<uint32_t>(newBone[index]));
+      }
+    }
+    skeleton.bones = std::move(bones);
+    skeleton.boneMap = std::move(boneMap);
+    for (Skin& skin : scene.skins) {
+      if (skin.skeleton != s) {
+        continue;
+      }
+      for (uint32_t& joint : skin.joints) {
+        joint = joint < newBone.size() && newBone[joint] >= 0 ? static_cast<uint32_t>(newBone[joint]) : 0;
+      }
+    }
+  }
+  return stats;
+}
+
+}  // namespace vv
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "asset/import/ImportReport.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+// Removes what cannot move a skinned vertex, a drawn node or a light (ImportOptions::pruneScene):
+// - channels whose keys never change are cut to one key, or dropped when it is the bind value;
+//   tracks left without keys, and tracks on nodes nothing depends on, are dropped;
+// - bones no skin weights, directly or through a descendant bone, leave their skeleton (a skin
+//   with the identity joint map, or a skeleton without skins, keeps every bone);
+// - nodes that are no kept bone, carry no mesh, skin or light and have none of those below them
+//   are removed, and chains of static helper nodes are folded into their lowest node, which then
+//   carries the combined transform.
+// Nodes and bones keep their relative order; every index into them is renumbered.
+ImportPruneStats PruneScene(Scene& scene);
+
+}  // namespace vv
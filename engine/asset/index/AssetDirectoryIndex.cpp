@@ -0,0 +1,560 @@
+#include "asset/index/AssetDirectoryIndex.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <utility>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace vv {
+namespace {
+
+constexpr const char* kCacheHeader = "vvassetindex 1";
+// Directories modified this recently may still change within the same mtime tick; they are stored
+// with an mtime that never matches so the next sweep lists them again.
+constexpr auto kMtimeSettle = std::chrono::seconds(2);
+constexpr int64_t kUnsettledMtime = std::numeric_limits<int64_t>::min();
+
+std::string ToLowerAscii(std::string value) {
+  std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) {
+    return static_cast<char>(std::tolower(c));
+  });
+  return value;
+}
+
+std::string JoinRel(const std::string& rel, const std::string& name) {
+  return rel.empty() ? name : rel + "/" + name;
+}
+
+size_t Depth(const std::string& rel) {
+  return static_cast<size_t>(std::count(rel.begin(), rel.end(), '/'));
+}
+
+bool IsUnder(const std::string& key, const std::string& rootKey) {
+  if (key.size() < rootKey.size() || key.compare(0, rootKey.size(), rootKey) != 0) {
+    return false;
+  }
+  return key.size() == rootKey.size() || rootKey.back() == '/' || key[rootKey.size()] == '/';
+}
+
+std::string RelativeKey(const std::string& key, const std::string& rootKey) {
+  if (key.size() == rootKey.size()) {
+    return {};
+  }
+  return key.substr(rootKey.size() + (rootKey.back() == '/' ? 0 : 1));
+}
+
+std::string CanonicalKey(const std::filesystem::path& directory, std::filesystem::path* canonical) {
+  std::error_code ec;
+  std::filesystem::path path = std::filesystem::weakly_canonical(std::filesystem::absolute(directory, ec), ec);
+  if (ec) {
+    path = std::filesystem::absolute(directory, ec).lexically_normal();
+  }
+  std::string key = path.generic_string();
+  while (key.size() > 1 && key.back() == '/') {
+    key.pop_back();
+  }
+  *canonical = std::filesystem::path(key);
+  return key;
+}
+
+int64_t SettledMtime(std::filesystem::file_time_type mtime) {
+  if (std::filesystem::file_time_type::clock::now() - mtime < kMtimeSettle) {
+    return kUnsettledMtime;
+  }
+  return static_cast<int64_t>(mtime.time_since_epoch().count());
+}
+
+std::string CacheFileName(const std::string& key) {
+  uint64_t h = 1469598103934665603ULL;  // FNV-1a: stable across runs and compilers
+  for (const char c : key) {
+    h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ULL;
+  }
+  constexpr std::array<char, 16> kHex = {'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'};
+  std::string name(16, '0');
+  for (size_t i = 0; i < 16; ++i) {
+    name[15 - i] = kHex[(h >> (i * 4)) & 0xFU];
+  }
+  return name + ".idx";
+}
+
+}  // namespace
+
+AssetDirectoryIndex& AssetDirectoryIndex::Global() {
+  static AssetDirectoryIndex index;
+  return index;
+}
+
+AssetDirectoryIndex::AssetDirectoryIndex() {
+  if (const char* dir = std::getenv("VV_ASSET_INDEX_DIR"); dir != nullptr) {
+    cacheDirectory_ = dir;
+    return;
+  }
+  std::error_code ec;
+  const std::filesystem::path temp = std::filesystem::temp_directory_path(ec);
+  if (!ec) {
+    cacheDirectory_ = temp / "vividvision-asset-index";
+  }
+}
+
+AssetDirectoryIndex::~AssetDirectoryIndex() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& root : roots_) {
+    SaveLocked(*root);
+  }
+#if defined(__linux__)
+  if (watchFd_ >= 0) {
+    close(watchFd_);
+  }
+#endif
+}
+
+void AssetDirectoryIndex::SetCacheDirectory(std::filesystem::path directory) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  cacheDirectory_ = std::move(directory);
+}
+
+void AssetDirectoryIndex::SetRevalidateInterval(std::chrono::milliseconds interval) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  revalidateInterval_ = interval;
+}
+
+bool AssetDirectoryIndex::SetWatching(bool enabled) {
+  std::lock_guard<std::mutex> lock(mutex_);
+#if defined(__linux__)
+  if (!enabled) {
+    if (watchFd_ >= 0) {
+      close(watchFd_);  // drops every watch
+      watchFd_ = -1;
+    }
+    watches_.clear();
+    watchComplete_ = false;
+    for (const auto& root : roots_) {
+      for (auto& [rel, directory] : root->directories) {
+        directory.watch = -1;
+      }
+    }
+    return true;
+  }
+  if (watchFd_ >= 0) {
+    return true;
+  }
+  watchFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (watchFd_ < 0) {
+    return false;
+  }
+  watchComplete_ = true;
+  for (const auto& root : roots_) {
+    for (auto& [rel, directory] : root->directories) {
+      AddWatchLocked(*root, rel, directory);
+    }
+  }
+  return true;
+#else
+  return !enabled;
+#endif
+}
+
+void AssetDirectoryIndex::AddRoot(const std::filesystem::path& root) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::filesystem::path canonical;
+  CanonicalKey(root, &canonical);
+  Root& acquired = AcquireRootLocked(canonical);
+  SaveLocked(acquired);
+}
+
+std::optional<std::filesystem::path> AssetDirectoryIndex::Find(const std::filesystem::path& searchDir, const std::string& fileName) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++stats_.lookups;
+  DrainWatchLocked();
+
+  std::filesystem::path canonical;
+  const std::string key = CanonicalKey(searchDir, &canonical);
+  Root& root = AcquireRootLocked(canonical);
+  const std::string searchRel = RelativeKey(key, root.key);
+  const std::string lowerName = ToLowerAscii(fileName);
+
+  std::optional<std::filesystem::path> found = LookupLocked(root, searchRel, lowerName);
+  std::error_code ec;
+  const bool stale = found.has_value() && !std::filesystem::exists(*found, ec);
+  const bool trustMiss = watchFd_ >= 0 && watchComplete_;
+  if ((stale || (!found.has_value() && !trustMiss)) &&
+      std::chrono::steady_clock::now() - root.validatedAt >= revalidateInterval_) {
+    ValidateLocked(root);
+    found = LookupLocked(root, searchRel, lowerName);
+  }
+  if (found.has_value() && !std::filesystem::exists(*found, ec)) {
+    found.reset();
+  }
+  SaveLocked(root);
+  if (found.has_value()) {
+    ++stats_.hits;
+  }
+  return found;
+}
+
+void AssetDirectoryIndex::Refresh() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  DrainWatchLocked();
+  for (const auto& root : roots_) {
+    ValidateLocked(*root);
+    SaveLocked(*root);
+  }
+}
+
+AssetIndexStats AssetDirectoryIndex::Stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  AssetIndexStats stats = stats_;
+  stats.roots = roots_.size();
+  for (const auto& root : roots_) {
+    stats.directories += root->directories.size();
+    for (const auto& [rel, directory] : root->directories) {
+      stats.files += directory.files.size();
+    }
+  }
+  return stats;
+}
+
+void AssetDirectoryIndex::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+#if defined(__linux__)
+  for (const auto& [wd, owner] : watches_) {
+    inotify_rm_watch(watchFd_, wd);
+  }
+#endif
+  watches_.clear();
+  watchComplete_ = watchFd_ >= 0;
+  roots_.clear();
+  stats_ = {};
+}
+
+AssetDirectoryIndex::Root& AssetDirectoryIndex::AcquireRootLocked(const std::filesystem::path& directory) {
+  const std::string key = directory.generic_string();
+  for (const auto& root : roots_) {
+    if (IsUnder(key, root->key)) {
+      return *root;
+    }
+  }
+
+  roots_.push_back(std::make_unique<Root>());
+  Root& root = *roots_.back();
+  root.path = directory;
+  root.key = key;
+  if (LoadLocked(root)) {
+    ++stats_.cacheLoads;
+    ValidateLocked(root);
+#if defined(__linux__)
+    if (watchFd_ >= 0) {
+      for (auto& [rel, entry] : root.directories) {
+        if (entry.watch < 0) {
+          AddWatchLocked(root, rel, entry);
+        }
+      }
+    }
+#endif
+  } else {
+    ScanDirectoryLocked(root, "");
+    root.validatedAt = std::chrono::steady_clock::now();
+  }
+  return root;
+}
+
+void AssetDirectoryIndex::ScanDirectoryLocked(Root& root, const std::string& rel) {
+  ++stats_.directoryScans;
+  root.namesStale = true;
+  root.modified = true;
+
+  const std::filesystem::path full = rel.empty() ? root.path : root.path / rel;
+  std::error_code ec;
+  const auto mtime = std::filesystem::last_write_time(full, ec);
+  std::error_code listEc;
+  std::filesystem::directory_iterator it(full, std::filesystem::directory_options::skip_permission_denied, listEc);
+  if (ec || listEc) {
+    RemoveSubtreeLocked(root, rel);
+    return;
+  }
+
+  std::vector<std::string> files;
+  std::vector<std::string> subdirs;
+  for (; it != std::filesystem::directory_iterator(); it.increment(ec)) {
+    if (ec) {
+      break;
+    }
+    std::error_code entryEc;
+    const std::string name = it->path().filename().string();
+    if (it->is_directory(entryEc)) {
+      // Like recursive_directory_iterator's default, symlinked directories are not followed.
+      if (!it->is_symlink(entryEc)) {
+        subdirs.push_back(name);
+      }
+    } else if (it->is_regular_file(entryEc)) {
+      files.push_back(name);
+    }
+  }
+  std::sort(files.begin(), files.end());
+  std::sort(subdirs.begin(), subdirs.end());
+
+  Directory& directory = root.directories[rel];
+  const std::vector<std::string> previous = std::move(directory.subdirs);
+  directory.mtime = SettledMtime(mtime);
+  directory.files = std::move(files);
+  directory.subdirs = std::move(subdirs);
+  if (watchFd_ >= 0 && directory.watch < 0) {
+    AddWatchLocked(root, rel, directory);
+  }
+
+  const std::vector<std::string> current = directory.subdirs;
+  for (const std::string& name : previous) {
+    if (!std::binary_search(current.begin(), current.end(), name)) {
+      RemoveSubtreeLocked(root, JoinRel(rel, name));
+    }
+  }
+  for (const std::string& name : current) {
+    const std::string child = JoinRel(rel, name);
+    if (root.directories.find(child) == root.directories.end()) {
+      ScanDirectoryLocked(root, child);
+    }
+  }
+}
+
+void AssetDirectoryIndex::RemoveSubtreeLocked(Root& root, const std::string& rel) {
+  root.namesStale = true;
+  root.modified = true;
+  auto first = root.directories.begin();
+  auto last = root.directories.end();
+  if (!rel.empty()) {
+    first = root.directories.lower_bound(rel);
+    last = root.directories.lower_bound(rel + "0");  // '0' sorts right after '/'
+  }
+  for (auto it = first; it != last;) {
+    if (!it->first.empty() && it->first != rel && !IsUnder(it->first, rel)) {
+      ++it;  // sibling such as "a.b" between "a" and "a0"
+      continue;
+    }
+    if (it->second.watch >= 0) {
+#if defined(__linux__)
+      inotify_rm_watch(watchFd_, it->second.watch);
+#endif
+      watches_.erase(it->second.watch);
+    }
+    it = root.directories.erase(it);
+  }
+}
+
+void AssetDirectoryIndex::ValidateLocked(Root& root) {
+  ++stats_.validations;
+  root.validatedAt = std::chrono::steady_clock::now();
+  if (root.directories.empty()) {
+    ScanDirectoryLocked(root, "");
+    return;
+  }
+  std::vector<std::string> keys;
+  keys.reserve(root.directories.size());
+  for (const auto& [rel, directory] : root.directories) {
+    keys.push_back(rel);
+  }
+  for (const std::string& rel : keys) {
+    const auto it = root.directories.find(rel);
+    if (it == root.directories.end()) {
+      continue;  // dropped with a parent
+    }
+    std::error_code ec;
+    const auto mtime = std::filesystem::last_write_time(rel.empty() ? root.path : root.path / rel, ec);
+    if (ec) {
+      RemoveSubtreeLocked(root, rel);
+    } else if (it->second.mtime == kUnsettledMtime || static_cast<int64_t>(mtime.time_since_epoch().count()) != it->second.mtime) {
+      ScanDirectoryLocked(root, rel);
+    }
+  }
+}
+
+void AssetDirectoryIndex::RebuildNamesLocked(Root& root) {
+  root.byName.clear();
+  for (const auto& [rel, directory] : root.directories) {
+    for (const std::string& file : directory.files) {
+      root.byName[ToLowerAscii(file)].push_back(JoinRel(rel, file));
+    }
+  }
+  for (auto& [name, paths] : root.byName) {
+    std::sort(paths.begin(), paths.end(), [](const std::string& a, const std::string& b) {
+      const size_t da = Depth(a);
+      const size_t db = Depth(b);
+      return da != db ? da < db : a < b;
+    });
+  }
+  root.namesStale = false;
+}
+
+std::optional<std::filesystem::path> AssetDirectoryIndex::LookupLocked(Root& root,
+                                                                        const std::string& searchRel,
+                                                                        const std::string& lowerName) {
+  if (root.namesStale) {
+    RebuildNamesLocked(root);
+  }
+  const auto it = root.byName.find(lowerName);
+  if (it == root.byName.end()) {
+    return std::nullopt;
+  }
+  for (const std::string& rel : it->second) {
+    if (searchRel.empty() || (rel.size() > searchRel.size() && IsUnder(rel, searchRel))) {
+      return root.path / rel;
+    }
+  }
+  return std::nullopt;
+}
+
+bool AssetDirectoryIndex::LoadLocked(Root& root) {
+  if (cacheDirectory_.empty()) {
+    return false;
+  }
+  std::ifstream file(cacheDirectory_ / CacheFileName(root.key));
+  std::string line;
+  if (!file || !std::getline(file, line) || line != kCacheHeader || !std::getline(file, line) || line != root.key) {
+    return false;
+  }
+  Directory* current = nullptr;
+  while (std::getline(file, line)) {
+    if (line.size() < 2 || line[1] != ' ') {
+      root.directories.clear();
+      return false;
+    }
+    const std::string rest = line.substr(2);
+    if (line[0] == 'd') {
+      const size_t space = rest.find(' ');
+      if (space == std::string::npos) {
+        root.directories.clear();
+        return false;
+      }
+      Directory& directory = root.directories[rest.substr(space + 1)];
+      directory.mtime = std::strtoll(rest.c_str(), nullptr, 10);
+      current = &directory;
+    } else if (current != nullptr && line[0] == 'f') {
+      current->files.push_back(rest);
+    } else if (current != nullptr && line[0] == 's') {
+      current->subdirs.push_back(rest);
+    } else {
+      root.directories.clear();
+      return false;
+    }
+  }
+  root.namesStale = true;
+  root.modified = false;
+  return !root.directories.empty();
+}
+
+void AssetDirectoryIndex::SaveLocked(Root& root) {
+  if (!root.modified || cacheDirectory_.empty()) {
+    return;
+  }
+  std::error_code ec;
+  std::filesystem::create_directories(cacheDirectory_, ec);
+  const std::filesystem::path target = cacheDirectory_ / CacheFileName(root.key);
+  std::filesystem::path temp = target;
+  temp += ".tmp";
+  {
+    std::ofstream file(temp, std::ios::trunc);
+    if (!file) {
+      return;
+    }
+    file << kCacheHeader << '\n' << root.key << '\n';
+    for (const auto& [rel, directory] : root.directories) {
+      file << "d " << directory.mtime << ' ' << rel << '\n';
+      for (const std::string& name : directory.files) {
+        file << "f " << name << '\n';
+      }
+      for (const std::string& name : directory.subdirs) {
+        file << "s " << name << '\n';
+      }
+    }
+    if (!file) {
+      return;
+    }
+  }
+  std::filesystem::rename(temp, target, ec);  // atomic replace, so concurrent readers never see half a file
+  if (!ec) {
+    ++stats_.cacheSaves;
+    root.modified = false;
+  }
+}
+
+void AssetDirectoryIndex::AddWatchLocked(Root& root, const std::string& rel, Directory& directory) {
+#if defined(__linux__)
+  const std::filesystem::path full = rel.empty() ? root.path : root.path / rel;
+  const int wd = inotify_add_watch(watchFd_,
+                                   full.c_str(),
+                                   IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF |
+                                       IN_MOVE_SELF | IN_ONLYDIR);
+  const auto existing = watches_.find(wd);
+  if (wd < 0 || (existing != watches_.end() && (existing->second.first != &root || existing->second.second != rel))) {
+    watchComplete_ = false;  // out of watches, or a directory shared by two roots: sweeps cover it
+    return;
+  }
+  directory.watch = wd;
+  watches_[wd] = {&root, rel};
+#else
+  (void)root;
+  (void)rel;
+  (void)directory;
+#endif
+}
+
+void AssetDirectoryIndex::DrainWatchLocked() {
+#if defined(__linux__)
+  if (watchFd_ < 0) {
+    return;
+  }
+  std::vector<std::pair<Root*, std::string>> dirty;
+  bool overflow = false;
+  alignas(inotify_event) std::array<char, 4096> buffer{};
+  for (;;) {
+    const ssize_t length = read(watchFd_, buffer.data(), buffer.size());
+    if (length <= 0) {
+      break;
+    }
+    for (ssize_t offset = 0; offset < length;) {
+      const auto* event = reinterpret_cast<const inotify_event*>(buffer.data() + offset);
+      offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+      ++stats_.watchEvents;
+      if ((event->mask & IN_Q_OVERFLOW) != 0) {
+        overflow = true;
+        continue;
+      }
+      const auto owner = watches_.find(event->wd);
+      if (owner == watches_.end()) {
+        continue;
+      }
+      dirty.push_back(owner->second);
+      if ((event->mask & IN_IGNORED) != 0) {
+        // The kernel dropped the watch; a rescan either removes the directory or watches it again.
+        const auto directory = owner->second.first->directories.find(owner->second.second);
+        if (directory != owner->second.first->directories.end()) {
+          directory->second.watch = -1;
+        }
+        watches_.erase(owner);
+      }
+    }
+  }
+  if (overflow) {
+    for (const auto& root : roots_) {
+      ValidateLocked(*root);
+    }
+    return;
+  }
+  std::sort(dirty.begin(), dirty.end());
+  dirty.erase(std::unique(dirty.begin(), dirty.end()), dirty.end());
+  for (const auto& [root, rel] : dirty) {
+    if (root->directories.find(rel) != root->directories.end()) {
+      ScanDirectoryLocked(*root, rel);
+    }
+  }
+#endif
+}
+
+}  // namespace vv
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vv {
+
+struct AssetIndexStats {
+  uint64_t roots = 0;
+  uint64_t directories = 0;
+  uint64_t files = 0;
+  uint64_t directoryScans = 0;  // single-directory listings (full builds count every directory)
+  uint64_t cacheLoads = 0;      // roots restored from their on-disk index
+  uint64_t cacheSaves = 0;
+  uint64_t validations = 0;     // mtime sweeps over a root's directories
+  uint64_t lookups = 0;
+  uint64_t hits = 0;
+  uint64_t watchEvents = 0;     // inotify events consumed
+};
+
+// Case-insensitive filename -> path index over asset roots, shared by every import of the process.
+// A root is listed once, persisted to `<cacheDir>/<hash>.idx` and afterwards kept current
+// incrementally: only directories whose mtime changed are listed again (a directory's mtime moves
+// whenever an entry is added, removed or renamed in it). Lookups that hit never touch the
+// filesystem beyond one existence check; misses and stale hits trigger an mtime sweep at most once
+// per revalidation interval. With watching enabled (inotify, Linux only) changed directories are
+// rescanned from events instead, and misses trust the index.
+class AssetDirectoryIndex {
+ public:
+  static constexpr std::chrono::milliseconds kDefaultRevalidateInterval{1000};
+
+  static AssetDirectoryIndex& Global();
+
+  AssetDirectoryIndex();  // cache directory from VV_ASSET_INDEX_DIR, else <tmp>/vividvision-asset-index
+  ~AssetDirectoryIndex();
+  AssetDirectoryIndex(const AssetDirectoryIndex&) = delete;
+  AssetDirectoryIndex& operator=(const AssetDirectoryIndex&) = delete;
+
+  // Empty disables persistence. Applies to roots loaded afterwards.
+  void SetCacheDirectory(std::filesystem::path directory);
+  void SetRevalidateInterval(std::chrono::milliseconds interval);
+  // Returns false when inotify is unavailable; the index then relies on mtime sweeps.
+  bool SetWatching(bool enabled);
+
+  // Indexes `root` (loading or building it) so imports anywhere below share one index.
+  void AddRoot(const std::filesystem::path& root);
+
+  // First file named `fileName` (ASCII case-insensitive) below `searchDir`, shallowest path first.
+  // `searchDir` becomes a root of its own unless an existing root contains it.
+  std::optional<std::filesystem::path> Find(const std::filesystem::path& searchDir, const std::string& fileName);
+
+  void Refresh();  // sweeps every root now
+  AssetIndexStats Stats() const;
+  void Clear();  // forgets in-memory roots; cache files stay
+
+ private:
+  struct Directory {
+    int64_t mtime = 0;
+    std::vector<std::string> files;
+    std::vector<std::string> subdirs;
+    int watch = -1;
+  };
+
+  struct Root {
+    std::filesystem::path path;
+    std::string key;                             // canonical generic path
+    std::map<std::string, Directory> directories;  // relative generic path, "" for the root itself
+    std::unordered_map<std::string, std::vector<std::string>> byName;  // lowercase name -> relative paths
+    std::chrono::steady_clock::time_point validatedAt;
+    bool namesStale = true;
+    bool modified = false;  // differs from the cache file
+  };
+
+  Root& AcquireRootLocked(const std::filesystem::path& directory);
+  void ScanDirectoryLocked(Root& root, const std::string& rel);
+  void RemoveSubtreeLocked(Root& root, const std::string& rel);
+  void ValidateLocked(Root& root);
+  void RebuildNamesLocked(Root& root);
+  bool LoadLocked(Root& root);
+  void SaveLocked(Root& root);
+  void AddWatchLocked(Root& root, const std::string& rel, Directory& directory);
+  void DrainWatchLocked();
+  std::optional<std::filesystem::path> LookupLocked(Root& root, const std::string& searchRel, const std::string& lowerName);
+
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<Root>> roots_;
+  std::filesystem::path cacheDirectory_;
+  std::chrono::milliseconds revalidateInterval_ = kDefaultRevalidateInterval;
+  int watchFd_ = -1;
+  bool watchComplete_ = false;  // every directory has a watch
+  std::unordered_map<int, std::pair<Root*, std::string>> watches_;
+  AssetIndexStats stats_;
+};
+
+}  // namespace vv
@@ -0,0 +1,515 @@
+#include "asset/mesh/MeshSimplifier.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <utility>
+
+#include <glm/geometric.hpp>
+
+namespace vv {
+namespace {
+
+constexpr float kMinLodReduction = 0.85F;  // a level must keep at most this fraction of its parent
+constexpr float kMaxLodError = 0.1F;
+constexpr float kMaxNormalTurnCos = 0.5F;  // per collapse; small limits keep slivers from folding over passes
+
+enum class VertexKind : uint8_t {
+  kManifold,
+  kSeam,
+  kLocked,
+};
+
+// Area-weighted plane quadric; Eval returns the weighted mean squared plane distance.
+struct Quadric {
+  double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+  double b0 = 0.0, b1 = 0.0, b2 = 0.0, c = 0.0;
+  double weight = 0.0;
+
+  void AddPlane(const Vec3& normal, double d, double w) {
+    const double nx = normal.x;
+    const double ny = normal.y;
+    const double nz = normal.z;
+    a00 += w * nx * nx;
+    a01 += w * nx * ny;
+    a02 += w * nx * nz;
+    a11 += w * ny * ny;
+    a12 += w * ny * nz;
+    a22 += w * nz * nz;
+    b0 += w * nx * d;
+    b1 += w * ny * d;
+    b2 += w * nz * d;
+    c += w * d * d;
+    weight += w;
+  }
+
+  void Add(const Quadric& o) {
+    a00 += o.a00;
+    a01 += o.a01;
+    a02 += o.a02;
+    a11 += o.a11;
+    a12 += o.a12;
+    a22 += o.a22;
+    b0 += o.b0;
+    b1 += o.b1;
+    b2 += o.b2;
+    c += o.c;
+    weight += o.weight;
+  }
+
+  double Eval(const Vec3& p) const {
+    if (weight <= 0.0) {
+      return 0.0;
+    }
+    const double x = p.x;
+    const double y = p.y;
+    const double z = p.z;
+    const double e = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                     2.0 * (b0 * x + b1 * y + b2 * z) + c;
+    return std::max(e, 0.0) / weight;
+  }
+};
+
+struct Collapse {
+  uint32_t from = 0;
+  uint32_t to = 0;
+  double cost = 0.0;
+};
+
+struct Adjacency {
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> triangles;
+};
+
+Adjacency BuildAdjacency(size_t vertexCount, const std::vector<uint32_t>& indices) {
+  Adjacency adj;
+  adj.offsets.assign(vertexCount + 1, 0);
+  for (const uint32_t v : indices) {
+    adj.offsets[v + 1] += 1;
+  }
+  for (size_t v = 1; v < adj.offsets.size(); ++v) {
+    adj.offsets[v] += adj.offsets[v - 1];
+  }
+  adj.triangles.resize(indices.size());
+  std::vector<uint32_t> cursor(adj.offsets.begin(), adj.offsets.end() - 1);
+  for (size_t i = 0; i < indices.size(); ++i) {
+    adj.triangles[cursor[indices[i]]++] = static_cast<uint32_t>(i / 3);
+  }
+  return adj;
+}
+
+using JointWeights = std::array<std::pair<uint16_t, float>, kMaxBoneInfluence>;
+
+// Normalized weights merged per joint; unused slots keep weight 0.
+JointWeights MergedInfluences(const VertexSkinned& v) {
+  JointWeights out{};
+  float sum = 0.0F;
+  for (size_t k = 0; k < kMaxBoneInfluence; ++k) {
+    const float w = std::max(v.weights[k], 0.0F);
+    sum += w;
+    for (auto& slot : out) {
+      if (slot.second == 0.0F || slot.first == v.joints[k]) {
+        slot.first = v.joints[k];
+        slot.second += w;
+        break;
+      }
+    }
+  }
+  if (sum > 0.0F) {
+    for (auto& slot : out) {
+      slot.second /= sum;
+    }
+  }
+  return out;
+}
+
+// L1 distance between two influence sets, 0 (identical) to 2 (disjoint).
+float SkinDistance(const VertexSkinned& a, const VertexSkinned& b) {
+  const JointWeights wa = MergedInfluences(a);
+  const JointWeights wb = MergedInfluences(b);
+  float distance = 0.0F;
+  for (const auto& [joint, weight] : wa) {
+    if (weight <= 0.0F) {
+      continue;
+    }
+    float other = 0.0F;
+    for (const auto& [jointB, weightB] : wb) {
+      other += jointB == joint ? weightB : 0.0F;
+    }
+    distance += std::fabs(weight - other);
+  }
+  for (const auto& [jointB, weightB] : wb) {
+    if (weightB <= 0.0F) {
+      continue;
+    }
+    bool shared = false;
+    for (const auto& [joint, weight] : wa) {
+      shared = shared || (joint == jointB && weight > 0.0F);
+    }
+    distance += shared ? 0.0F : weightB;
+  }
+  return distance;
+}
+
+class Simplifier {
+ public:
+  Simplifier(const Mesh& mesh, const std::vector<uint32_t>& indices, const std::vector<uint32_t>& tags)
+      : mesh_(mesh), indices_(indices), tags_(tags) {
+    const Vec3 center = 0.5F * (mesh.localBounds.min + mesh.localBounds.max);
+    const float radius = std::max(0.5F * glm::length(mesh.localBounds.max - mesh.localBounds.min), 1e-6F);
+    positions_.resize(mesh.vertices.size());
+    for (size_t v = 0; v < mesh.vertices.size(); ++v) {
+      positions_[v] = (mesh.vertices[v].position - center) / radius;
+    }
+    BuildWedges();
+    ClassifyVertices();
+    BuildQuadrics();
+  }
+
+  SimplifyResult Run(const SimplifyOptions& options) {
+    const size_t targetTriangles = std::max<size_t>(1, static_cast<size_t>(static_cast<double>(indices_.size() / 3) *
+                                                                          std::clamp(options.targetRatio, 0.0F, 1.0F)));
+    const double maxCost = static_cast<double>(options.maxError) * static_cast<double>(options.maxError);
+    double worstCost = 0.0;
+
+    while (indices_.size() / 3 > targetTriangles) {
+      adjacency_ = BuildAdjacency(mesh_.vertices.size(), indices_);
+      std::vector<Collapse> candidates = GatherCollapses(options);
+      std::sort(candidates.begin(), candidates.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+      std::vector<uint32_t> remap(mesh_.vertices.size());
+      std::iota(remap.begin(), remap.end(), 0U);
+      std::vector<uint8_t> locked(groupCount_, 0);
+      size_t triangleCount = indices_.size() / 3;
+      size_t collapses = 0;
+
+      for (const Collapse& collapse : candidates) {
+        if (collapse.cost > maxCost || triangleCount <= targetTriangles) {
+          break;
+        }
+        const uint32_t pu = group_[collapse.from];
+        const uint32_t pv = group_[collapse.to];
+        if (locked[pu] != 0 || locked[pv] != 0 || !KeepsOrientation(pu, pv, collapse.to) ||
+            !MapWedges(collapse.from, collapse.to, remap)) {
+          continue;
+        }
+
+        quadrics_[pv].Add(quadrics_[pu]);
+        worstCost = std::max(worstCost, collapse.cost);
+        ++collapses;
+        ForEachGroupTriangle(pu, [&](uint32_t t) {
+          bool touchesV = false;
+          for (uint32_t k = 0; k < 3; ++k) {
+            const uint32_t p = group_[indices_[t * 3 + k]];
+            touchesV = touchesV || p == pv;
+            locked[p] = 1;
+          }
+          if (touchesV) {
+            --triangleCount;
+          }
+        });
+      }
+
+      if (collapses == 0) {
+        break;
+      }
+      Compact(remap);
+    }
+
+    SimplifyResult result;
+    result.indices = std::move(indices_);
+    result.triangleSubmesh = std::move(tags_);
+    result.error = static_cast<float>(std::sqrt(worstCost));
+    return result;
+  }
+
+ private:
+  void BuildWedges() {
+    const size_t count = mesh_.vertices.size();
+    std::vector<uint32_t> order(count);
+    std::iota(order.begin(), order.end(), 0U);
+    const auto less = [&](uint32_t a, uint32_t b) {
+      const Vec3& pa = mesh_.vertices[a].position;
+      const Vec3& pb = mesh_.vertices[b].position;
+      if (pa.x != pb.x) {
+        return pa.x < pb.x;
+      }
+      if (pa.y != pb.y) {
+        return pa.y < pb.y;
+      }
+      return pa.z < pb.z;
+    };
+    std::sort(order.begin(), order.end(), less);
+
+    group_.assign(count, 0);
+    wedgeNext_.assign(count, 0);
+    groupCount_ = 0;
+    for (size_t i = 0; i < count;) {
+      size_t end = i + 1;
+      while (end < count && mesh_.vertices[order[end]].position == mesh_.vertices[order[i]].position) {
+        ++end;
+      }
+      for (size_t k = i; k < end; ++k) {
+        group_[order[k]] = groupCount_;
+        wedgeNext_[order[k]] = order[k + 1 < end ? k + 1 : i];
+      }
+      groupLeader_.push_back(order[i]);
+      groupSize_.push_back(static_cast<uint32_t>(end - i));
+      ++groupCount_;
+      i = end;
+    }
+  }
+
+  void ClassifyVertices() {
+    kinds_.assign(groupCount_, VertexKind::kManifold);
+    std::vector<uint32_t> firstTag(groupCount_, UINT32_MAX);
+    std::vector<uint64_t> edges;
+    edges.reserve(indices_.size());
+
+    for (size_t t = 0; t < indices_.size() / 3; ++t) {
+      for (uint32_t k = 0; k < 3; ++k) {
+        const uint32_t a = group_[indices_[t * 3 + k]];
+        const uint32_t b = group_[indices_[t * 3 + (k + 1) % 3]];
+        if (firstTag[a] == UINT32_MAX) {
+          firstTag[a] = tags_[t];
+        } else if (firstTag[a] != tags_[t]) {
+          kinds_[a] = VertexKind::kLocked;
+        }
+        if (a != b) {
+          edges.push_back((static_cast<uint64_t>(std::min(a, b)) << 32U) | std::max(a, b));
+        }
+      }
+    }
+
+    // Open borders and non-manifold edges are never moved.
+    std::sort(edges.begin(), edges.end());
+    for (size_t i = 0; i < edges.size();) {
+      size_t end = i + 1;
+      while (end < edges.size() && edges[end] == edges[i]) {
+        ++end;
+      }
+      if (end - i != 2) {
+        kinds_[static_cast<uint32_t>(edges[i] >> 32U)] = VertexKind::kLocked;
+        kinds_[static_cast<uint32_t>(edges[i] & 0xFFFFFFFFU)] = VertexKind::kLocked;
+      }
+      i = end;
+    }
+
+    for (uint32_t p = 0; p < groupCount_; ++p) {
+      if (kinds_[p] != VertexKind::kLocked && groupSize_[p] > 1) {
+        kinds_[p] = VertexKind::kSeam;
+      }
+    }
+  }
+
+  void BuildQuadrics() {
+    quadrics_.assign(groupCount_, Quadric{});
+    for (size_t t = 0; t < indices_.size() / 3; ++t) {
+      const Vec3& p0 = positions_[indices_[t * 3 + 0]];
+      const Vec3& p1 = positions_[indices_[t * 3 + 1]];
+      const Vec3& p2 = positions_[indices_[t * 3 + 2]];
+      const Vec3 cross = glm::cross(p1 - p0, p2 - p0);
+      const float doubleArea = glm::length(cross);
+      if (doubleArea <= 1e-12F) {
+        continue;
+      }
+      const Vec3 n = cross / doubleArea;
+      const double d = -static_cast<double>(glm::dot(n, p0));
+      for (uint32_t k = 0; k < 3; ++k) {
+        quadrics_[group_[indices_[t * 3 + k]]].AddPlane(n, d, 0.5 * static_cast<double>(doubleArea));
+      }
+    }
+  }
+
+  std::vector<Collapse> GatherCollapses(const SimplifyOptions& options) const {
+    std::vector<Collapse> out;
+    out.reserve(indices_.size() * 2);
+    for (size_t t = 0; t < indices_.size() / 3; ++t) {
+      for (uint32_t k = 0; k < 3; ++k) {
+        const uint32_t a = indices_[t * 3 + k];
+        const uint32_t b = indices_[t * 3 + (k + 1) % 3];
+        for (const auto& [u, v] : {std::pair{a, b}, std::pair{b, a}}) {
+          const VertexKind ku = kinds_[group_[u]];
+          if (group_[u] == group_[v] || ku == VertexKind::kLocked ||
+              (ku == VertexKind::kSeam && kinds_[group_[v]] == VertexKind::kManifold)) {
+            continue;
+          }
+          if (SkinDistance(mesh_.vertices[u], mesh_.vertices[v]) > options.maxSkinDistance) {
+            continue;
+          }
+          out.push_back(Collapse{u, v, quadrics_[group_[u]].Eval(positions_[v])});
+        }
+      }
+    }
+    return out;
+  }
+
+  template <typename Fn>
+  void ForEachGroupTriangle(uint32_t groupId, Fn&& fn) const {
+    const uint32_t leader = groupLeader_[groupId];
+    uint32_t w = leader;
+    do {
+      for (uint32_t i = adjacency_.offsets[w]; i < adjacency_.offsets[w + 1]; ++i) {
+        fn(adjacency_.triangles[i]);
+      }
+      w = wedgeNext_[w];
+    } while (w != leader);
+  }
+
+  bool KeepsOrientation(uint32_t pu, uint32_t pv, uint32_t target) const {
+    bool ok = true;
+    ForEachGroupTriangle(pu, [&](uint32_t t) {
+      std::array<Vec3, 3> before{};
+      std::array<Vec3, 3> after{};
+      bool collapses = false;
+      for (uint32_t k = 0; k < 3; ++k) {
+        const uint32_t v = indices_[t * 3 + k];
+        collapses = collapses || group_[v] == pv;
+        before[k] = positions_[v];
+        after[k] = group_[v] == pu ? positions_[target] : positions_[v];
+      }
+      if (collapses) {
+        return;
+      }
+      const Vec3 n0 = glm::cross(before[1] - before[0], before[2] - before[0]);
+      const Vec3 n1 = glm::cross(after[1] - after[0], after[2] - after[0]);
+      if (glm::dot(n0, n1) <= kMaxNormalTurnCos * glm::length(n0) * glm::length(n1)) {
+        ok = false;
+      }
+    });
+    return ok;
+  }
+
+  // Every wedge of the moving vertex must land on a wedge of the target it shares an edge with,
+  // otherwise the collapse would drag attributes across a seam.
+  bool MapWedges(uint32_t from, uint32_t to, std::vector<uint32_t>& remap) const {
+    const uint32_t pv = group_[to];
+    if (groupSize_[group_[from]] == 1) {
+      remap[from] = to;
+      return true;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> mapping;
+    uint32_t w = from;
+    do {
+      uint32_t match = UINT32_MAX;
+      for (uint32_t i = adjacency_.offsets[w]; i < adjacency_.offsets[w + 1] && match == UINT32_MAX; ++i) {
+        const uint32_t t = adjacency_.triangles[i];
+        for (uint32_t k = 0; k < 3; ++k) {
+          if (group_[indices_[t * 3 + k]] == pv) {
+            match = indices_[t * 3 + k];
+            break;
+          }
+        }
+      }
+      if (match == UINT32_MAX) {
+        return false;
+      }
+      mapping.emplace_back(w, match);
+      w = wedgeNext_[w];
+    } while (w != from);
+
+    for (const auto& [wedge, target] : mapping) {
+      remap[wedge] = target;
+    }
+    return true;
+  }
+
+  void Compact(const std::vector<uint32_t>& remap) {
+    size_t write = 0;
+    for (size_t t = 0; t < indices_.size() / 3; ++t) {
+      const uint32_t a = remap[indices_[t * 3 + 0]];
+      const uint32_t b = remap[indices_[t * 3 + 1]];
+      const uint32_t c = remap[indices_[t * 3 + 2]];
+      if (group_[a] == group_[b] || group_[b] == group_[c] || group_[a] == group_[c]) {
+        continue;
+      }
+      indices_[write * 3 + 0] = a;
+      indices_[write * 3 + 1] = b;
+      indices_[write * 3 + 2] = c;
+      tags_[write] = tags_[t];
+      ++write;
+    }
+    indices_.resize(write * 3);
+    tags_.resize(write);
+  }
+
+  const Mesh& mesh_;
+  std::vector<uint32_t> indices_;
+  std::vector<uint32_t> tags_;
+  std::vector<Vec3> positions_;  // normalized to the bounding sphere
+  std::vector<uint32_t> group_;
+  std::vector<uint32_t> wedgeNext_;
+  std::vector<uint32_t> groupLeader_;
+  std::vector<uint32_t> groupSize_;
+  uint32_t groupCount_ = 0;
+  std::vector<VertexKind> kinds_;
+  std::vector<Quadric> quadrics_;
+  Adjacency adjacency_;
+};
+
+}  // namespace
+
+SimplifyResult SimplifyMeshIndices(const Mesh& mesh,
+                                   const std::vector<uint32_t>& indices,
+                                   const std::vector<uint32_t>& triangleSubmesh,
+                                   const SimplifyOptions& options) {
+  if (mesh.vertices.empty() || indices.size() < 3 || triangleSubmesh.size() * 3 < indices.size()) {
+    return SimplifyResult{indices, triangleSubmesh, 0.0F};
+  }
+  std::vector<uint32_t> trimmed(indices.begin(), indices.begin() + static_cast<std::ptrdiff_t>(indices.size() / 3 * 3));
+  std::vector<uint32_t> tags(triangleSubmesh.begin(), triangleSubmesh.begin() + static_cast<std::ptrdiff_t>(trimmed.size() / 3));
+  Simplifier simplifier(mesh, trimmed, tags);
+  return simplifier.Run(options);
+}
+
+void BuildMeshLods(Mesh& mesh, uint32_t lodCount) {
+  mesh.lods.clear();
+  if (lodCount == 0 || mesh.submeshes.empty()) {
+    return;
+  }
+
+  std::vector<uint32_t> indices;
+  std::vector<uint32_t> tags;
+  for (uint32_t s = 0; s < mesh.submeshes.size(); ++s) {
+    const Submesh& submesh = mesh.submeshes[s];
+    const uint32_t count = submesh.indexCount / 3 * 3;
+    indices.insert(indices.end(), mesh.indices.begin() + submesh.firstIndex, mesh.indices.begin() + submesh.firstIndex + count);
+    tags.insert(tags.end(), count / 3, s);
+  }
+
+  float accumulatedError = 0.0F;
+  for (uint32_t level = 0; level < lodCount; ++level) {
+    SimplifyOptions options;
+    options.targetRatio = 0.5F;
+    options.maxError = kMaxLodError - accumulatedError;
+    SimplifyResult result = SimplifyMeshIndices(mesh, indices, tags, options);
+    if (result.indices.empty() ||
+        static_cast<float>(result.indices.size()) > kMinLodReduction * static_cast<float>(indices.size())) {
+      break;
+    }
+
+    // Errors of chained levels are measured against their parent, so they add up.
+    accumulatedError += result.error;
+    MeshLod lod;
+    lod.error = accumulatedError;
+    for (uint32_t s = 0; s < mesh.submeshes.size(); ++s) {
+      Submesh range = mesh.submeshes[s];
+      range.firstIndex = static_cast<uint32_t>(mesh.indices.size());
+      for (size_t t = 0; t < result.triangleSubmesh.size(); ++t) {
+        if (result.triangleSubmesh[t] == s) {
+          mesh.indices.insert(mesh.indices.end(), result.indices.begin() + static_cast<std::ptrdiff_t>(t * 3),
+                              result.indices.begin() + static_cast<std::ptrdiff_t>(t * 3 + 3));
+        }
+      }
+      range.indexCount = static_cast<uint32_t>(mesh.indices.size()) - range.firstIndex;
+      lod.submeshes.push_back(range);
+    }
+    mesh.lods.push_back(std::move(lod));
+    indices = std::move(result.indices);
+    tags = std::move(result.triangleSubmesh);
+  }
+}
+
+}  // namespace vv
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+struct SimplifyOptions {
+  float targetRatio = 0.5F;      // fraction of triangles to keep
+  float maxError = 0.05F;        // relative to the mesh bounding radius
+  float maxSkinDistance = 0.5F;  // L1 distance between joint weight sets (0..2) allowed to collapse
+};
+
+struct SimplifyResult {
+  std::vector<uint32_t> indices;
+  std::vector<uint32_t> triangleSubmesh;  // source submesh of each output triangle
+  float error = 0.0F;                     // relative to the mesh bounding radius
+};
+
+// Quadric edge-collapse simplification onto existing vertices, so the result reuses the mesh's
+// vertex buffer. Open borders and vertices shared by several submeshes stay locked; vertices
+// split for UV/normal seams only collapse along the seam; collapses between vertices with
+// dissimilar skin weights are rejected. `triangleSubmesh` tags the input triangles.
+SimplifyResult SimplifyMeshIndices(const Mesh& mesh,
+                                   const std::vector<uint32_t>& indices,
+                                   const std::vector<uint32_t>& triangleSubmesh,
+                                   const SimplifyOptions& options);
+
+// Appends up to `lodCount` progressively coarser index ranges (Mesh::lods). Stops early when a
+// level no longer reduces the triangle count meaningfully or exceeds the error budget.
+void BuildMeshLods(Mesh& mesh, uint32_t lodCount);
+
+}  // namespace vv
@@ -0,0 +1,297 @@
+#include "asset/mesh/MeshletBuilder.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+
+#include "asset/mesh/MorphTargets.hpp"
+
+namespace vv {
+namespace {
+
+constexpr uint32_t kUnstamped = UINT32_MAX;
+constexpr float kPi = 3.14159265359F;
+
+struct TriangleAdjacency {
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> triangles;
+};
+
+TriangleAdjacency BuildAdjacency(const Mesh& mesh, const Submesh& submesh) {
+  TriangleAdjacency adj;
+  adj.offsets.assign(mesh.vertices.size() + 1, 0);
+  const uint32_t triCount = submesh.indexCount / 3;
+  for (uint32_t i = 0; i < triCount * 3; ++i) {
+    adj.offsets[mesh.indices[submesh.firstIndex + i] + 1] += 1;
+  }
+  for (size_t v = 1; v < adj.offsets.size(); ++v) {
+    adj.offsets[v] += adj.offsets[v - 1];
+  }
+  adj.triangles.resize(adj.offsets.back());
+  std::vector<uint32_t> cursor(adj.offsets.begin(), adj.offsets.end() - 1);
+  for (uint32_t t = 0; t < triCount; ++t) {
+    for (uint32_t k = 0; k < 3; ++k) {
+      const uint32_t v = mesh.indices[submesh.firstIndex + t * 3 + k];
+      adj.triangles[cursor[v]++] = t;
+    }
+  }
+  return adj;
+}
+
+void ComputeClusterBounds(const Mesh& mesh,
+                          const std::vector<uint32_t>& clusterIndices,
+                          const std::vector<uint32_t>& clusterVertices,
+                          MeshCluster& cluster,
+                          std::vector<ClusterBoneBounds>& bones) {
+  Vec3 minP(FLT_MAX);
+  Vec3 maxP(-FLT_MAX);
+  for (const uint32_t v : clusterVertices) {
+    minP = glm::min(minP, mesh.vertices[v].position);
+    maxP = glm::max(maxP, mesh.vertices[v].position);
+  }
+  cluster.center = 0.5F * (minP + maxP);
+  cluster.radius = 0.0F;
+  for (const uint32_t v : clusterVertices) {
+    cluster.radius = std::max(cluster.radius, glm::length(mesh.vertices[v].position - cluster.center));
+  }
+
+  std::vector<Vec3> normals;
+  normals.reserve(clusterIndices.size() / 3);
+  Vec3 axisSum(0.0F);
+  for (size_t i = 0; i + 2 < clusterIndices.size(); i += 3) {
+    const Vec3& a = mesh.vertices[clusterIndices[i]].position;
+    const Vec3& b = mesh.vertices[clusterIndices[i + 1]].position;
+    const Vec3& c = mesh.vertices[clusterIndices[i + 2]].position;
+    const Vec3 n = glm::cross(b - a, c - a);
+    const float len = glm::length(n);
+    if (len <= 1e-20F) {
+      continue;
+    }
+    normals.push_back(n / len);
+    axisSum += normals.back();
+  }
+  const float axisLen = glm::length(axisSum);
+  if (normals.empty() || axisLen <= 1e-6F) {
+    cluster.coneAxis = Vec3(0.0F, 0.0F, 1.0F);
+    cluster.coneSpread = kPi;
+  } else {
+    cluster.coneAxis = axisSum / axisLen;
+    float minDot = 1.0F;
+    for (const Vec3& n : normals) {
+      minDot = std::min(minDot, glm::dot(n, cluster.coneAxis));
+    }
+    cluster.coneSpread = std::acos(std::clamp(minDot, -1.0F, 1.0F));
+  }
+
+  struct JointExtent {
+    uint32_t joint = 0;
+    Vec3 minP{FLT_MAX};
+    Vec3 maxP{-FLT_MAX};
+  };
+  std::vector<JointExtent> extents;
+  const auto findJoint = [&extents](uint32_t joint) -> JointExtent& {
+    for (JointExtent& e : extents) {
+      if (e.joint == joint) {
+        return e;
+      }
+    }
+    extents.push_back(JointExtent{joint});
+    return extents.back();
+  };
+  for (const uint32_t v : clusterVertices) {
+    const VertexSkinned& vtx = mesh.vertices[v];
+    for (size_t k = 0; k < kMaxBoneInfluence; ++k) {
+      if (vtx.weights[k] <= 0.0F) {
+        continue;
+      }
+      JointExtent& e = findJoint(vtx.joints[k]);
+      e.minP = glm::min(e.minP, vtx.position);
+      e.maxP = glm::max(e.maxP, vtx.position);
+    }
+  }
+
+  cluster.firstBone = static_cast<uint32_t>(bones.size());
+  cluster.boneCount = static_cast<uint32_t>(extents.size());
+  for (const JointExtent& e : extents) {
+    ClusterBoneBounds bone;
+    bone.joint = e.joint;
+    bone.center = 0.5F * (e.minP + e.maxP);
+    bones.push_back(bone);
+  }
+  for (const uint32_t v : clusterVertices) {
+    const VertexSkinned& vtx = mesh.vertices[v];
+    for (size_t k = 0; k < kMaxBoneInfluence; ++k) {
+      if (vtx.weights[k] <= 0.0F) {
+        continue;
+      }
+      for (uint32_t b = cluster.firstBone; b < cluster.firstBone + cluster.boneCount; ++b) {
+        if (bones[b].joint == vtx.joints[k]) {
+          bones[b].radius = std::max(bones[b].radius, glm::length(vtx.position - bones[b].center));
+          break;
+        }
+      }
+    }
+  }
+}
+
+void BuildSubmeshClusters(Mesh& mesh, uint32_t submeshIndex, std::vector<uint32_t>& vertexStamp) {
+  const Submesh& submesh = mesh.submeshes[submeshIndex];
+  const uint32_t triCount = submesh.indexCount / 3;
+  if (triCount == 0) {
+    return;
+  }
+
+  const TriangleAdjacency adj = BuildAdjacency(mesh, submesh);
+  const auto triVertex = [&](uint32_t t, uint32_t k) {
+    return mesh.indices[submesh.firstIndex + t * 3 + k];
+  };
+  const auto triCentroid = [&](uint32_t t) {
+    return (mesh.vertices[triVertex(t, 0)].position + mesh.vertices[triVertex(t, 1)].position +
+            mesh.vertices[triVertex(t, 2)].position) / 3.0F;
+  };
+
+  std::vector<uint8_t> used(triCount, 0);
+  std::vector<uint32_t> reordered;
+  reordered.reserve(static_cast<size_t>(triCount) * 3);
+
+  std::vector<uint32_t> candidates;
+  std::vector<uint32_t> clusterVertices;
+  std::vector<uint32_t> clusterIndices;
+  uint32_t nextSeed = 0;
+  uint32_t emitted = 0;
+
+  while (emitted < triCount) {
+    const uint32_t stamp = static_cast<uint32_t>(mesh.clusters.size());
+    candidates.clear();
+    clusterVertices.clear();
+    clusterIndices.clear();
+    Vec3 centroidSum(0.0F);
+
+    const auto newVertexCount = [&](uint32_t t) {
+      uint32_t count = 0;
+      for (uint32_t k = 0; k < 3; ++k) {
+        count += vertexStamp[triVertex(t, k)] != stamp ? 1U : 0U;
+      }
+      return count;
+    };
+    const auto addTriangle = [&](uint32_t t) {
+      used[t] = 1;
+      ++emitted;
+      for (uint32_t k = 0; k < 3; ++k) {
+        const uint32_t v = triVertex(t, k);
+        clusterIndices.push_back(v);
+        if (vertexStamp[v] != stamp) {
+          vertexStamp[v] = stamp;
+          clusterVertices.push_back(v);
+          for (uint32_t a = adj.offsets[v]; a < adj.offsets[v + 1]; ++a) {
+            if (used[adj.triangles[a]] == 0) {
+              candidates.push_back(adj.triangles[a]);
+            }
+          }
+        }
+      }
+      centroidSum += triCentroid(t);
+    };
+
+    while (used[nextSeed] != 0) {
+      ++nextSeed;
+    }
+    addTriangle(nextSeed);
+
+    while (clusterIndices.size() / 3 < kMaxClusterTriangles) {
+      const Vec3 centroid = centroidSum / static_cast<float>(clusterIndices.size() / 3);
+      uint32_t best = kUnstamped;
+      uint32_t bestNew = 4;
+      float bestDist = FLT_MAX;
+
+      size_t keep = 0;
+      for (size_t c = 0; c < candidates.size(); ++c) {
+        const uint32_t t = candidates[c];
+        if (used[t] != 0) {
+          continue;
+        }
+        candidates[keep++] = t;
+        const uint32_t added = newVertexCount(t);
+        if (clusterVertices.size() + added > kMaxClusterVertices || added > bestNew) {
+          continue;
+        }
+        const Vec3 d = triCentroid(t) - centroid;
+        const float dist = glm::dot(d, d);
+        if (added < bestNew || dist < bestDist) {
+          best = t;
+          bestNew = added;
+          bestDist = dist;
+        }
+      }
+      candidates.resize(keep);
+
+      if (best == kUnstamped) {
+        // Disconnected pieces: keep filling with the next unused triangle in index order.
+        while (nextSeed < triCount && used[nextSeed] != 0) {
+          ++nextSeed;
+        }
+        if (nextSeed >= triCount || clusterVertices.size() + newVertexCount(nextSeed) > kMaxClusterVertices) {
+          break;
+        }
+        best = nextSeed;
+      }
+      addTriangle(best);
+    }
+
+    MeshCluster cluster;
+    cluster.firstIndex = submesh.firstIndex + static_cast<uint32_t>(reordered.size());
+    cluster.indexCount = static_cast<uint32_t>(clusterIndices.size());
+    cluster.vertexCount = static_cast<uint32_t>(clusterVertices.size());
+    cluster.submesh = submeshIndex;
+    ComputeClusterBounds(mesh, clusterIndices, clusterVertices, cluster, mesh.clusterBones);
+    mesh.clusters.push_back(cluster);
+    reordered.insert(reordered.end(), clusterIndices.begin(), clusterIndices.end());
+
+    while (nextSeed < triCount && used[nextSeed] != 0) {
+      ++nextSeed;
+    }
+  }
+
+  std::copy(reordered.begin(), reordered.end(), mesh.indices.begin() + submesh.firstIndex);
+}
+
+}  // namespace
+
+void BuildMeshClusters(Mesh& mesh) {
+  mesh.clusters.clear();
+  mesh.clusterBones.clear();
+  if (mesh.vertices.empty() || mesh.indices.empty()) {
+    return;
+  }
+
+  std::vector<uint32_t> vertexStamp(mesh.vertices.size(), kUnstamped);
+  for (uint32_t s = 0; s < mesh.submeshes.size(); ++s) {
+    BuildSubmeshClusters(mesh, s, vertexStamp);
+  }
+
+  // Blend shapes move vertices by up to their reach in any direction and turn their normals.
+  if (!mesh.morphTargets.empty()) {
+    const std::vector<float> reach = MorphReach(mesh);
+    for (MeshCluster& cluster : mesh.clusters) {
+      float clusterReach = 0.0F;
+      for (uint32_t i = cluster.firstIndex; i < cluster.firstIndex + cluster.indexCount; ++i) {
+        clusterReach = std::max(clusterReach, reach[mesh.indices[i]]);
+      }
+      if (clusterReach <= 0.0F) {
+        continue;
+      }
+      cluster.radius += clusterReach;
+      cluster.coneSpread = kPi;
+      for (uint32_t b = cluster.firstBone; b < cluster.firstBone + cluster.boneCount; ++b) {
+        mesh.clusterBones[b].radius += clusterReach;
+      }
+    }
+  }
+}
+
+}  // namespace vv
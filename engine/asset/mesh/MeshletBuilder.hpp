@@ -0,0 +1,14 @@
+#pragma once
+
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+// Splits every submesh into clusters of at most kMaxClusterVertices vertices and
+// kMaxClusterTriangles triangles. Triangles inside each submesh range of Mesh::indices are
+// reordered so each cluster is one contiguous index range; submesh ranges are unchanged.
+// Bounds are bind pose grown by how far morph targets reach; per-joint spheres let the renderer
+// expand them for the current pose.
+void BuildMeshClusters(Mesh& mesh);
+
+}  // namespace vv
@@ -0,0 +1,227 @@
+#include "asset/mesh/MorphTargets.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <glm/geometric.hpp>
+
+namespace vv {
+namespace {
+
+constexpr float kSnorm16Max = 32767.0F;
+constexpr uint32_t kDropped = UINT32_MAX;
+
+float MaxComponent(const Vec3& v) {
+  return std::max({std::fabs(v.x), std::fabs(v.y), std::fabs(v.z)});
+}
+
+int16_t Quantize(float value, float scale) {
+  if (scale <= 0.0F) {
+    return 0;
+  }
+  return static_cast<int16_t>(std::lround(std::clamp(value / scale, -1.0F, 1.0F) * kSnorm16Max));
+}
+
+Vec3 Dequantize(const std::array<std::vector<int16_t>, 3>& deltas, const Vec3& scale, size_t entry) {
+  return Vec3(static_cast<float>(deltas[0][entry]), static_cast<float>(deltas[1][entry]),
+              static_cast<float>(deltas[2][entry])) *
+         (scale / kSnorm16Max);
+}
+
+uint64_t Mix(uint64_t h, uint64_t value) {
+  h ^= value + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+  h *= 0xFF51AFD7ED558CCDULL;
+  return h ^ (h >> 32);
+}
+
+// Rebuilds the entries of `target` from (vertex, old entry) pairs sorted by vertex.
+void SelectEntries(MorphTarget& target, const std::vector<std::pair<uint32_t, uint32_t>>& entries) {
+  MorphTarget out;
+  out.vertices.reserve(entries.size());
+  const bool normals = !target.normalDeltas[0].empty();
+  for (int c = 0; c < 3; ++c) {
+    out.positionDeltas[c].reserve(entries.size());
+    if (normals) {
+      out.normalDeltas[c].reserve(entries.size());
+    }
+  }
+  for (const auto& [vertex, entry] : entries) {
+    out.vertices.push_back(vertex);
+    for (int c = 0; c < 3; ++c) {
+      out.positionDeltas[c].push_back(target.positionDeltas[c][entry]);
+      if (normals) {
+        out.normalDeltas[c].push_back(target.normalDeltas[c][entry]);
+      }
+    }
+  }
+  target.vertices = std::move(out.vertices);
+  target.positionDeltas = std::move(out.positionDeltas);
+  target.normalDeltas = std::move(out.normalDeltas);
+}
+
+}  // namespace
+
+MorphTarget BuildMorphTarget(std::string name,
+                             const std::vector<Vec3>& positionDeltas,
+                             const std::vector<Vec3>& normalDeltas,
+                             float positionEpsilon,
+                             float normalEpsilon) {
+  MorphTarget target;
+  target.name = std::move(name);
+  const bool withNormals = normalDeltas.size() == positionDeltas.size();
+  bool normalsMove = false;
+  for (size_t v = 0; v < positionDeltas.size(); ++v) {
+    const bool moves = MaxComponent(positionDeltas[v]) > positionEpsilon;
+    const bool turns = withNormals && MaxComponent(normalDeltas[v]) > normalEpsilon;
+    if (!moves && !turns) {
+      continue;
+    }
+    target.vertices.push_back(static_cast<uint32_t>(v));
+    target.positionScale = glm::max(target.positionScale, glm::abs(positionDeltas[v]));
+    if (withNormals) {
+      target.normalScale = glm::max(target.normalScale, glm::abs(normalDeltas[v]));
+      normalsMove = normalsMove || turns;
+    }
+  }
+  if (!normalsMove) {
+    target.normalScale = Vec3(0.0F);
+  }
+  for (int c = 0; c < 3; ++c) {
+    target.positionDeltas[c].reserve(target.vertices.size());
+    for (const uint32_t v : target.vertices) {
+      target.positionDeltas[c].push_back(Quantize(positionDeltas[v][c], target.positionScale[c]));
+    }
+    if (normalsMove) {
+      target.normalDeltas[c].reserve(target.vertices.size());
+      for (const uint32_t v : target.vertices) {
+        target.normalDeltas[c].push_back(Quantize(normalDeltas[v][c], target.normalScale[c]));
+      }
+    }
+  }
+  return target;
+}
+
+Vec3 MorphPositionDelta(const MorphTarget& target, size_t entry) {
+  return Dequantize(target.positionDeltas, target.positionScale, entry);
+}
+
+Vec3 MorphNormalDelta(const MorphTarget& target, size_t entry) {
+  if (target.normalDeltas[0].empty()) {
+    return Vec3(0.0F);
+  }
+  return Dequantize(target.normalDeltas, target.normalScale, entry);
+}
+
+uint64_t MorphTargetBytes(const Mesh& mesh) {
+  uint64_t bytes = 0;
+  for (const MorphTarget& target : mesh.morphTargets) {
+    bytes += target.vertices.size() * sizeof(uint32_t);
+    for (int c = 0; c < 3; ++c) {
+      bytes += (target.positionDeltas[c].size() + target.normalDeltas[c].size()) * sizeof(int16_t);
+    }
+  }
+  return bytes;
+}
+
+uint64_t DenseMorphTargetBytes(const Mesh& mesh) {
+  uint64_t bytes = 0;
+  for (const MorphTarget& target : mesh.morphTargets) {
+    bytes += mesh.vertices.size() * sizeof(Vec3) * (target.normalDeltas[0].empty() ? 1 : 2);
+  }
+  return bytes;
+}
+
+std::vector<float> MorphReach(const Mesh& mesh) {
+  std::vector<float> reach(mesh.vertices.size(), 0.0F);
+  for (const MorphTarget& target : mesh.morphTargets) {
+    for (size_t e = 0; e < target.vertices.size(); ++e) {
+      if (target.vertices[e] < reach.size()) {
+        reach[target.vertices[e]] += glm::length(MorphPositionDelta(target, e));
+      }
+    }
+  }
+  return reach;
+}
+
+void ExpandBoundsForMorphTargets(Mesh& mesh) {
+  if (mesh.morphTargets.empty() || mesh.vertices.empty()) {
+    return;
+  }
+  std::vector<Vec3> lowest(mesh.vertices.size(), Vec3(0.0F));
+  std::vector<Vec3> highest(mesh.vertices.size(), Vec3(0.0F));
+  for (const MorphTarget& target : mesh.morphTargets) {
+    for (size_t e = 0; e < target.vertices.size(); ++e) {
+      const uint32_t v = target.vertices[e];
+      if (v < mesh.vertices.size()) {
+        const Vec3 delta = MorphPositionDelta(target, e);
+        lowest[v] += glm::min(delta, Vec3(0.0F));
+        highest[v] += glm::max(delta, Vec3(0.0F));
+      }
+    }
+  }
+  for (size_t v = 0; v < mesh.vertices.size(); ++v) {
+    mesh.localBounds.min = glm::min(mesh.localBounds.min, mesh.vertices[v].position + lowest[v]);
+    mesh.localBounds.max = glm::max(mesh.localBounds.max, mesh.vertices[v].position + highest[v]);
+  }
+}
+
+std::vector<uint64_t> MorphSignatures(const Mesh& mesh) {
+  std::vector<uint64_t> signatures(mesh.vertices.size(), 0);
+  for (size_t t = 0; t < mesh.morphTargets.size(); ++t) {
+    const MorphTarget& target = mesh.morphTargets[t];
+    const bool normals = !target.normalDeltas[0].empty();
+    for (size_t e = 0; e < target.vertices.size(); ++e) {
+      const uint32_t v = target.vertices[e];
+      if (v >= signatures.size()) {
+        continue;
+      }
+      uint64_t h = Mix(signatures[v], t + 1);
+      for (int c = 0; c < 3; ++c) {
+        h = Mix(h, static_cast<uint16_t>(target.positionDeltas[c][e]));
+        h = Mix(h, normals ? static_cast<uint16_t>(target.normalDeltas[c][e]) : 0U);
+      }
+      signatures[v] = h == 0 ? 1 : h;
+    }
+  }
+  return signatures;
+}
+
+void RemapMorphTargets(Mesh& mesh, const std::vector<uint32_t>& newIndex) {
+  std::vector<std::pair<uint32_t, uint32_t>> entries;
+  for (MorphTarget& target : mesh.morphTargets) {
+    entries.clear();
+    for (size_t e = 0; e < target.vertices.size(); ++e) {
+      const uint32_t v = target.vertices[e];
+      if (v < newIndex.size() && newIndex[v] != kDropped) {
+        entries.emplace_back(newIndex[v], static_cast<uint32_t>(e));
+      }
+    }
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const auto& a, const auto& b) { return a.first == b.first; }),
+                  entries.end());
+    SelectEntries(target, entries);
+  }
+}
+
+void CopyMorphVertices(Mesh& mesh, const std::vector<uint32_t>& sourceOf, uint32_t firstCopy) {
+  std::vector<std::pair<uint32_t, uint32_t>> entries;
+  for (MorphTarget& target : mesh.morphTargets) {
+    entries.clear();
+    for (size_t e = 0; e < target.vertices.size(); ++e) {
+      entries.emplace_back(target.vertices[e], static_cast<uint32_t>(e));
+    }
+    const size_t original = entries.size();
+    for (size_t k = 0; k < sourceOf.size(); ++k) {
+      const auto it = std::lower_bound(target.vertices.begin(), target.vertices.end(), sourceOf[k]);
+      if (it != target.vertices.end() && *it == sourceOf[k]) {
+        entries.emplace_back(firstCopy + static_cast<uint32_t>(k), static_cast<uint32_t>(it - target.vertices.begin()));
+      }
+    }
+    if (entries.size() != original) {
+      SelectEntries(target, entries);
+    }
+  }
+}
+
+}  // namespace vv
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+// Vertices whose position delta has no component above `positionEpsilon` (and whose normal delta,
+// when given, none above `normalEpsilon`) are left out. `normalDeltas` is empty or parallel to
+// `positionDeltas`.
+MorphTarget BuildMorphTarget(std::string name,
+                             const std::vector<Vec3>& positionDeltas,
+                             const std::vector<Vec3>& normalDeltas,
+                             float positionEpsilon = 1e-6F,
+                             float normalEpsilon = 1e-4F);
+
+Vec3 MorphPositionDelta(const MorphTarget& target, size_t entry);
+Vec3 MorphNormalDelta(const MorphTarget& target, size_t entry);
+
+// Bytes the sparse targets of `mesh` hold, and what dense float position (and normal) deltas for
+// every vertex would take.
+uint64_t MorphTargetBytes(const Mesh& mesh);
+uint64_t DenseMorphTargetBytes(const Mesh& mesh);
+
+// Per vertex, the farthest any combination of weights in [0, 1] moves it.
+std::vector<float> MorphReach(const Mesh& mesh);
+
+// Grows Mesh::localBounds to hold every vertex under any combination of weights in [0, 1], so
+// packed positions of morphed vertices stay inside the quantization range.
+void ExpandBoundsForMorphTargets(Mesh& mesh);
+
+// A hash of the deltas every target gives each vertex; 0 for vertices no target moves. Vertices
+// with different signatures must not be welded.
+std::vector<uint64_t> MorphSignatures(const Mesh& mesh);
+
+// Vertex v becomes newIndex[v], or is dropped for UINT32_MAX. Vertices merged onto one index must
+// carry the same deltas (equal MorphSignatures); one entry is kept.
+void RemapMorphTargets(Mesh& mesh, const std::vector<uint32_t>& newIndex);
+
+// Vertex `firstCopy + k` was duplicated from vertex sourceOf[k] and moves with it.
+void CopyMorphVertices(Mesh& mesh, const std::vector<uint32_t>& sourceOf, uint32_t firstCopy);
+
+}  // namespace vv
@@ -35,4 +35,28 @@ PackedInfluence4 NormalizeInfluences4(std::vector<std::pair<uint32_t, float>> in
   return packed;
 }
 
+std::vector<uint32_t> CompactJoints(std::vector<VertexSkinned>& vertices) {
+  std::vector<uint32_t> joints;
+  for (const VertexSkinned& v : vertices) {
+    for (size_t k = 0; k < kMaxBoneInfluence; ++k) {
+      if (v.weights[k] > 0.0F) {
+        joints.push_back(v.joints[k]);
+      }
+    }
+  }
+  std::sort(joints.begin(), joints.end());
+  joints.erase(std::unique(joints.begin(), joints.end()), joints.end());
+
+  std::vector<uint16_t> local(joints.empty() ? 0 : joints.back() + 1, 0);
+  for (size_t i = 0; i < joints.size(); ++i) {
+    local[joints[i]] = static_cast<uint16_t>(i);
+  }
+  for (VertexSkinned& v : vertices) {
+    for (size_t k = 0; k < kMaxBoneInfluence; ++k) {
+      v.joints[k] = v.weights[k] > 0.0F ? local[v.joints[k]] : 0;
+    }
+  }
+  return joints;
+}
+
 }  // namespace vv
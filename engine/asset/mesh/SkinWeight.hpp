@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "core/types/CommonTypes.hpp"
+#include "render/scene/SceneTypes.hpp"
 
 namespace vv {
 
@@ -16,4 +17,8 @@ struct PackedInfluence4 {
 
 PackedInfluence4 NormalizeInfluences4(std::vector<std::pair<uint32_t, float>> influences);
 
+// Renumbers the joints that `vertices` reference with a non-zero weight to 0..n-1, keeping their
+// order, and returns the original index of each (Skin::joints). Zero-weight slots become joint 0.
+std::vector<uint32_t> CompactJoints(std::vector<VertexSkinned>& vertices);
+
 }  // namespace vv
@@ -0,0 +1,413 @@
+#include "asset/mesh/TangentSpace.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/geometric.hpp>
+
+#include "asset/mesh/MeshletBuilder.hpp"
+#include "asset/mesh/MorphTargets.hpp"
+#include "asset/mesh/VertexQuantization.hpp"
+#include "core/thread/ParallelFor.hpp"
+
+namespace vv {
+namespace {
+
+constexpr size_t kTrianglesPerChunk = 1024;
+constexpr size_t kVerticesPerChunk = 2048;
+constexpr uint32_t kNoVertex = UINT32_MAX;
+
+// Lists of corners (3 * triangle + k) grouped by a per-corner key, built in corner order so every
+// consumer sums in the same order whatever the thread count.
+struct CornerLists {
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> corners;
+};
+
+CornerLists GroupCorners(const std::vector<uint32_t>& cornerKeys, size_t keyCount) {
+  CornerLists lists;
+  lists.offsets.assign(keyCount + 1, 0);
+  for (const uint32_t key : cornerKeys) {
+    ++lists.offsets[key + 1];
+  }
+  for (size_t i = 0; i < keyCount; ++i) {
+    lists.offsets[i + 1] += lists.offsets[i];
+  }
+  lists.corners.resize(cornerKeys.size());
+  std::vector<uint32_t> cursor(lists.offsets.begin(), lists.offsets.end() - 1);
+  for (uint32_t corner = 0; corner < cornerKeys.size(); ++corner) {
+    lists.corners[cursor[cornerKeys[corner]]++] = corner;
+  }
+  return lists;
+}
+
+Vec3 ProjectOnPlane(const Vec3& v, const Vec3& n) {
+  return v - n * glm::dot(n, v);
+}
+
+Vec3 NormalizeOrZero(const Vec3& v) {
+  const float len = glm::length(v);
+  return len > FLT_MIN ? v / len : Vec3(0.0F);
+}
+
+float AngleBetween(const Vec3& a, const Vec3& b) {
+  const Vec3 na = NormalizeOrZero(a);
+  const Vec3 nb = NormalizeOrZero(b);
+  if (na == Vec3(0.0F) || nb == Vec3(0.0F)) {
+    return 0.0F;
+  }
+  return std::acos(std::clamp(glm::dot(na, nb), -1.0F, 1.0F));
+}
+
+Vec3 AnyPerpendicular(const Vec3& n) {
+  const Vec3 axis = std::fabs(n.x) < 0.9F ? Vec3(1.0F, 0.0F, 0.0F) : Vec3(0.0F, 1.0F, 0.0F);
+  return NormalizeOrZero(axis - n * glm::dot(n, axis));
+}
+
+struct TriangleGradients {
+  Vec3 tangent{0.0F};    // direction of increasing u
+  Vec3 bitangent{0.0F};  // direction of increasing v
+};
+
+// False when the triangle has no usable UV or position gradient.
+bool ComputeGradients(const VertexSkinned& a, const VertexSkinned& b, const VertexSkinned& c, TriangleGradients& out) {
+  const Vec3 e1 = b.position - a.position;
+  const Vec3 e2 = c.position - a.position;
+  const Vec2 d1 = b.uv0 - a.uv0;
+  const Vec2 d2 = c.uv0 - a.uv0;
+  const float area = d1.x * d2.y - d2.x * d1.y;  // twice the signed UV area
+  if (std::fabs(area) <= FLT_MIN) {
+    return false;
+  }
+  const float sign = area > 0.0F ? 1.0F : -1.0F;
+  out.tangent = NormalizeOrZero((e1 * d2.y - e2 * d1.y) * sign);
+  out.bitangent = NormalizeOrZero((e2 * d1.x - e1 * d2.x) * sign);
+  return out.tangent != Vec3(0.0F);
+}
+
+// MikkTSpace derives the sign from the UV winding alone, which assumes counter-clockwise triangles
+// around their normals; taking it from the UV bitangent gives the same answer on such meshes and
+// stays right when an import conversion mirrored the winding.
+uint8_t CornerSide(const TriangleGradients& g, const Vec3& n) {
+  return glm::dot(glm::cross(n, g.tangent), g.bitangent) >= 0.0F ? 1 : 0;
+}
+
+// Triangle starts (offsets into Mesh::indices) of the LOD0 surface.
+std::vector<uint32_t> SurfaceTriangles(const Mesh& mesh) {
+  std::vector<uint32_t> starts;
+  if (mesh.submeshes.empty()) {
+    for (uint32_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+      starts.push_back(i);
+    }
+    return starts;
+  }
+  for (const Submesh& submesh : mesh.submeshes) {
+    const uint32_t end = std::min<uint32_t>(submesh.firstIndex + submesh.indexCount, static_cast<uint32_t>(mesh.indices.size()));
+    for (uint32_t i = submesh.firstIndex; i + 2 < end; i += 3) {
+      starts.push_back(i);
+    }
+  }
+  return starts;
+}
+
+// Returns how many vertices were split along creases.
+uint32_t GenerateNormals(Mesh& mesh, const std::vector<uint32_t>& triangles, float creaseAngleDegrees) {
+  // Vertices split for UV seams share a position; smoothing across them avoids shading seams.
+  std::vector<uint32_t> positionIds(mesh.vertices.size());
+  std::unordered_map<uint64_t, std::vector<std::pair<Vec3, uint32_t>>> buckets;
+  uint32_t positionCount = 0;
+  for (size_t v = 0; v < mesh.vertices.size(); ++v) {
+    const Vec3& p = mesh.vertices[v].position;
+    uint32_t bits[3];
+    std::memcpy(bits, &p.x, sizeof(float));
+    std::memcpy(bits + 1, &p.y, sizeof(float));
+    std::memcpy(bits + 2, &p.z, sizeof(float));
+    const uint64_t key = (static_cast<uint64_t>(bits[0]) * 73856093ULL) ^ (static_cast<uint64_t>(bits[1]) * 19349663ULL) ^
+                         (static_cast<uint64_t>(bits[2]) * 83492791ULL);
+    auto& bucket = buckets[key];
+    const auto same = std::find_if(bucket.begin(), bucket.end(), [&](const auto& entry) { return entry.first == p; });
+    if (same != bucket.end()) {
+      positionIds[v] = same->second;
+    } else {
+      bucket.emplace_back(p, positionCount);
+      positionIds[v] = positionCount++;
+    }
+  }
+
+  std::vector<Vec3> faceNormals(triangles.size());
+  std::vector<Vec3> cornerNormals(triangles.size() * 3);
+  std::vector<uint32_t> cornerKeys(triangles.size() * 3);
+  std::vector<uint32_t> cornerVertices(triangles.size() * 3);
+  ParallelFor(triangles.size(), kTrianglesPerChunk, [&](size_t begin, size_t end) {
+    for (size_t t = begin; t < end; ++t) {
+      const uint32_t* tri = &mesh.indices[triangles[t]];
+      const Vec3 p[3] = {mesh.vertices[tri[0]].position, mesh.vertices[tri[1]].position, mesh.vertices[tri[2]].position};
+      faceNormals[t] = NormalizeOrZero(glm::cross(p[1] - p[0], p[2] - p[0]));
+      for (size_t k = 0; k < 3; ++k) {
+        const float angle = AngleBetween(p[(k + 1) % 3] - p[k], p[(k + 2) % 3] - p[k]);
+        cornerNormals[t * 3 + k] = faceNormals[t] * angle;
+        cornerKeys[t * 3 + k] = positionIds[tri[k]];
+        cornerVertices[t * 3 + k] = tri[k];
+      }
+    }
+  });
+
+  // Per corner: the corners at its position whose faces meet its own within the crease angle. On a
+  // smooth patch every corner at a position sums the same set, in the same order, so they agree
+  // bit for bit; across a crease they differ and the vertex splits below. Vertices no surface
+  // corner uses take every corner at their position.
+  const float creaseCos = std::cos(std::clamp(creaseAngleDegrees, 0.0F, 180.0F) * (3.14159265F / 180.0F));
+  const CornerLists byPosition = GroupCorners(cornerKeys, positionCount);
+  std::vector<Vec3> smoothedCorners(cornerNormals.size());
+  std::vector<Vec3> positionNormals(positionCount);
+  ParallelFor(positionCount, kVerticesPerChunk, [&](size_t begin, size_t end) {
+    for (size_t id = begin; id < end; ++id) {
+      Vec3 all(0.0F);
+      for (uint32_t i = byPosition.offsets[id]; i < byPosition.offsets[id + 1]; ++i) {
+        const uint32_t corner = byPosition.corners[i];
+        all += cornerNormals[corner];
+        const Vec3& face = faceNormals[corner / 3];
+        Vec3 sum(0.0F);
+        for (uint32_t j = byPosition.offsets[id]; j < byPosition.offsets[id + 1]; ++j) {
+          const uint32_t other = byPosition.corners[j];
+          if (other == corner || glm::dot(face, faceNormals[other / 3]) >= creaseCos) {
+            sum += cornerNormals[other];
+          }
+        }
+        smoothedCorners[corner] = NormalizeOrZero(sum);
+      }
+      positionNormals[id] = NormalizeOrZero(all);
+    }
+  });
+
+  // The vertex's first corner keeps it; corners with another normal share one copy per normal.
+  const CornerLists byVertex = GroupCorners(cornerVertices, mesh.vertices.size());
+  const size_t originalCount = mesh.vertices.size();
+  std::vector<uint32_t> nextCopy(originalCount, kNoVertex);  // chains each vertex through its copies
+  std::vector<uint32_t> copiedFrom;
+  std::vector<uint32_t> cornerTarget(cornerVertices);
+  const auto fallback = [](const Vec3& n) { return n == Vec3(0.0F) ? Vec3(0.0F, 1.0F, 0.0F) : n; };
+  for (uint32_t v = 0; v < originalCount; ++v) {
+    if (byVertex.offsets[v] == byVertex.offsets[v + 1]) {
+      mesh.vertices[v].normal = fallback(positionNormals[positionIds[v]]);
+      continue;
+    }
+    mesh.vertices[v].normal = fallback(smoothedCorners[byVertex.corners[byVertex.offsets[v]]]);
+    for (uint32_t i = byVertex.offsets[v] + 1; i < byVertex.offsets[v + 1]; ++i) {
+      const uint32_t corner = byVertex.corners[i];
+      const Vec3 n = fallback(smoothedCorners[corner]);
+      uint32_t target = v;
+      uint32_t last = v;
+      for (uint32_t c = v; c != kNoVertex; c = nextCopy[c]) {
+        last = c;
+        if (glm::dot(mesh.vertices[c].normal, n) >= 0.99999F) {
+          break;
+        }
+        target = nextCopy[c];
+      }
+      if (target == kNoVertex) {
+        VertexSkinned copy = mesh.vertices[v];
+        copy.normal = n;
+        target = static_cast<uint32_t>(mesh.vertices.size());
+        mesh.vertices.push_back(copy);
+        nextCopy[last] = target;
+        nextCopy.push_back(kNoVertex);
+        copiedFrom.push_back(v);
+      }
+      cornerTarget[corner] = target;
+    }
+  }
+  const uint32_t splits = static_cast<uint32_t>(copiedFrom.size());
+  if (splits == 0) {
+    return 0;
+  }
+  if (!mesh.morphTargets.empty()) {
+    CopyMorphVertices(mesh, copiedFrom, static_cast<uint32_t>(originalCount));
+  }
+
+  // LOD0 corners take their own copy; corners of coarser LODs the copy facing their triangle most.
+  std::vector<uint8_t> isSurface(mesh.indices.size() / 3, 0);
+  for (size_t t = 0; t < triangles.size(); ++t) {
+    isSurface[triangles[t] / 3] = 1;
+    for (size_t k = 0; k < 3; ++k) {
+      mesh.indices[triangles[t] + k] = cornerTarget[t * 3 + k];
+    }
+  }
+  ParallelFor(isSurface.size(), kTrianglesPerChunk, [&](size_t begin, size_t end) {
+    for (size_t t = begin; t < end; ++t) {
+      if (isSurface[t] != 0) {
+        continue;
+      }
+      uint32_t* tri = &mesh.indices[t * 3];
+      if (tri[0] >= originalCount || tri[1] >= originalCount || tri[2] >= originalCount) {
+        continue;
+      }
+      const Vec3 face = NormalizeOrZero(glm::cross(mesh.vertices[tri[1]].position - mesh.vertices[tri[0]].position,
+                                                   mesh.vertices[tri[2]].position - mesh.vertices[tri[0]].position));
+      for (size_t k = 0; k < 3; ++k) {
+        uint32_t best = tri[k];
+        float bestDot = glm::dot(mesh.vertices[best].normal, face);
+        for (uint32_t c = nextCopy[tri[k]]; c != kNoVertex; c = nextCopy[c]) {
+          const float d = glm::dot(mesh.vertices[c].normal, face);
+          if (d > bestDot) {
+            best = c;
+            bestDot = d;
+          }
+        }
+        tri[k] = best;
+      }
+    }
+  });
+  return splits;
+}
+
+}  // namespace
+
+TangentSpaceResult GenerateTangentSpace(Mesh& mesh, const TangentSpaceOptions& options) {
+  TangentSpaceResult result;
+  if (mesh.vertices.empty() || mesh.indices.size() < 3) {
+    return result;
+  }
+  const std::vector<uint32_t> triangles = SurfaceTriangles(mesh);
+  if (options.generateNormals) {
+    result.creaseSplitVertices = GenerateNormals(mesh, triangles, options.creaseAngleDegrees);
+  }
+  if (!options.generateTangents) {
+    if (result.creaseSplitVertices > 0 && !mesh.clusters.empty()) {
+      BuildMeshClusters(mesh);
+    }
+    if (mesh.vertexLayout != VertexLayout::kFull) {
+      PackMeshVertices(mesh);
+    }
+    return result;
+  }
+
+  // Per corner: the triangle's UV gradient projected onto the corner normal, weighted by the corner
+  // angle measured in that plane; plus the side (bitangent sign) it belongs to.
+  const size_t cornerCount = triangles.size() * 3;
+  std::vector<Vec3> cornerTangents(cornerCount, Vec3(0.0F));
+  std::vector<uint8_t> cornerSides(cornerCount, 0);
+  std::vector<uint8_t> degenerate(triangles.size(), 0);
+  std::vector<uint32_t> cornerVertices(cornerCount);
+  ParallelFor(triangles.size(), kTrianglesPerChunk, [&](size_t begin, size_t end) {
+    for (size_t t = begin; t < end; ++t) {
+      const uint32_t* tri = &mesh.indices[triangles[t]];
+      const VertexSkinned* v[3] = {&mesh.vertices[tri[0]], &mesh.vertices[tri[1]], &mesh.vertices[tri[2]]};
+      for (size_t k = 0; k < 3; ++k) {
+        cornerVertices[t * 3 + k] = tri[k];
+      }
+      TriangleGradients gradients;
+      if (!ComputeGradients(*v[0], *v[1], *v[2], gradients)) {
+        degenerate[t] = 1;
+        continue;
+      }
+      for (size_t k = 0; k < 3; ++k) {
+        const Vec3& n = v[k]->normal;
+        cornerSides[t * 3 + k] = CornerSide(gradients, n);
+        const Vec3 projected = NormalizeOrZero(ProjectOnPlane(gradients.tangent, n));
+        const float angle =
+            AngleBetween(ProjectOnPlane(v[(k + 1) % 3]->position - v[k]->position, n),
+                         ProjectOnPlane(v[(k + 2) % 3]->position - v[k]->position, n));
+        cornerTangents[t * 3 + k] = projected * angle;
+      }
+    }
+  });
+
+  // Per vertex: one frame per side. The side of the vertex's first usable corner keeps the vertex;
+  // the other, if present, moves to a copy.
+  const CornerLists byVertex = GroupCorners(cornerVertices, mesh.vertices.size());
+  std::vector<Vec4> keptTangent(mesh.vertices.size());
+  std::vector<Vec4> otherTangent(mesh.vertices.size());
+  std::vector<uint8_t> keptSide(mesh.vertices.size(), 1);
+  std::vector<uint8_t> needsSplit(mesh.vertices.size(), 0);
+  ParallelFor(mesh.vertices.size(), kVerticesPerChunk, [&](size_t begin, size_t end) {
+    for (size_t v = begin; v < end; ++v) {
+      Vec3 sums[2] = {Vec3(0.0F), Vec3(0.0F)};
+      bool used[2] = {false, false};
+      int first = -1;
+      for (uint32_t i = byVertex.offsets[v]; i < byVertex.offsets[v + 1]; ++i) {
+        const uint32_t corner = byVertex.corners[i];
+        if (degenerate[corner / 3] != 0) {
+          continue;
+        }
+        const int side = cornerSides[corner];
+        sums[side] += cornerTangents[corner];
+        used[side] = true;
+        if (first < 0) {
+          first = side;
+        }
+      }
+      const Vec3& n = mesh.vertices[v].normal;
+      const auto frame = [&](int side) {
+        const Vec3 t = NormalizeOrZero(sums[side]);
+        return Vec4(t == Vec3(0.0F) ? AnyPerpendicular(n) : t, side == 1 ? 1.0F : -1.0F);
+      };
+      if (first < 0) {
+        keptTangent[v] = Vec4(AnyPerpendicular(n), 1.0F);
+        continue;
+      }
+      keptSide[v] = static_cast<uint8_t>(first);
+      keptTangent[v] = frame(first);
+      if (used[1 - first]) {
+        otherTangent[v] = frame(1 - first);
+        needsSplit[v] = 1;
+      }
+    }
+  });
+
+  const size_t originalCount = mesh.vertices.size();
+  std::vector<uint32_t> splitOf(originalCount, kNoVertex);
+  std::vector<uint32_t> copiedFrom;
+  for (size_t v = 0; v < originalCount; ++v) {
+    mesh.vertices[v].tangent = keptTangent[v];
+    if (needsSplit[v] != 0) {
+      VertexSkinned copy = mesh.vertices[v];
+      copy.tangent = otherTangent[v];
+      splitOf[v] = static_cast<uint32_t>(mesh.vertices.size());
+      mesh.vertices.push_back(copy);
+      copiedFrom.push_back(static_cast<uint32_t>(v));
+    }
+  }
+  result.splitVertices = static_cast<uint32_t>(mesh.vertices.size() - originalCount);
+  if (!mesh.morphTargets.empty() && !copiedFrom.empty()) {
+    CopyMorphVertices(mesh, copiedFrom, static_cast<uint32_t>(originalCount));
+  }
+  for (size_t t = 0; t < triangles.size(); ++t) {
+    result.degenerateCorners += degenerate[t] != 0 ? 3U : 0U;
+  }
+
+  if (result.splitVertices > 0) {
+    // Every corner of every LOD picks the copy matching its side.
+    ParallelFor(mesh.indices.size() / 3, kTrianglesPerChunk, [&](size_t begin, size_t end) {
+      for (size_t t = begin; t < end; ++t) {
+        uint32_t* tri = &mesh.indices[t * 3];
+        if (tri[0] >= originalCount || tri[1] >= originalCount || tri[2] >= originalCount) {
+          continue;
+        }
+        TriangleGradients gradients;
+        if (!ComputeGradients(mesh.vertices[tri[0]], mesh.vertices[tri[1]], mesh.vertices[tri[2]], gradients)) {
+          continue;
+        }
+        for (size_t k = 0; k < 3; ++k) {
+          const uint32_t v = tri[k];
+          if (splitOf[v] != kNoVertex && keptSide[v] != CornerSide(gradients, mesh.vertices[v].normal)) {
+            tri[k] = splitOf[v];
+          }
+        }
+      }
+    });
+  }
+  if ((result.splitVertices > 0 || result.creaseSplitVertices > 0) && !mesh.clusters.empty()) {
+    BuildMeshClusters(mesh);
+  }
+  if (mesh.vertexLayout != VertexLayout::kFull) {
+    PackMeshVertices(mesh);
+  }
+  return result;
+}
+
+}  // namespace vv
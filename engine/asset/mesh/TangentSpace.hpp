@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+struct TangentSpaceOptions {
+  bool generateNormals = false;  // angle-weighted, smoothed across vertices sharing a position
+  // Generated normals only smooth across faces meeting within this angle; sharper edges keep one
+  // normal per side (the vertex splits). 180 smooths everything.
+  float creaseAngleDegrees = 60.0F;
+  bool generateTangents = true;
+};
+
+struct TangentSpaceResult {
+  uint32_t splitVertices = 0;        // vertices duplicated where mirrored UV islands meet
+  uint32_t creaseSplitVertices = 0;  // vertices duplicated where generated normals meet at a crease
+  uint32_t degenerateCorners = 0;    // corners of triangles with no usable UV gradient
+};
+
+// MikkTSpace-compatible tangent frames: per-triangle UV gradients are projected onto each corner's
+// normal plane and summed with corner-angle weights, separately for each bitangent sign, so that
+// B = w * cross(N, T) as MikkTSpace bakers expect. Vertices shared by corners of opposite sign
+// (mirrored UV islands) are split. Triangles run in parallel, then vertices.
+//
+// Works on imported or cooked meshes: LOD0 submesh ranges define the surface, coarser LOD ranges
+// are remapped onto split vertices, clusters are rebuilt after splits and packed vertex streams
+// are repacked.
+TangentSpaceResult GenerateTangentSpace(Mesh& mesh, const TangentSpaceOptions& options = {});
+
+}  // namespace vv
@@ -0,0 +1,291 @@
+#include "asset/mesh/VertexCache.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "asset/mesh/MorphTargets.hpp"
+#include "asset/mesh/VertexQuantization.hpp"
+
+namespace vv {
+namespace {
+
+constexpr uint32_t kCacheSize = 32;
+constexpr float kCacheDecayPower = 1.5F;
+constexpr float kLastTriangleScore = 0.75F;
+constexpr float kValenceBoostScale = 2.0F;
+constexpr float kValenceBoostPower = 0.5F;
+constexpr uint32_t kNone = UINT32_MAX;
+
+struct IndexRange {
+  uint32_t firstIndex = 0;
+  uint32_t indexCount = 0;
+};
+
+constexpr uint32_t kValenceTableSize = 32;
+
+struct ScoreTables {
+  float cache[kCacheSize];
+  float valence[kValenceTableSize];
+};
+
+// Cached vertices score by recency (the three of the last triangle a flat 0.75, since reusing them
+// right away saves little), and vertices with few triangles left get a boost so they are finished
+// off instead of left stranded. Tabulated: scores are recomputed for ~35 vertices per triangle.
+const ScoreTables& Scores() {
+  static const ScoreTables tables = [] {
+    ScoreTables t{};
+    const float scaler = 1.0F / static_cast<float>(kCacheSize - 3);
+    for (uint32_t i = 0; i < kCacheSize; ++i) {
+      t.cache[i] = i < 3 ? kLastTriangleScore : std::pow(1.0F - static_cast<float>(i - 3) * scaler, kCacheDecayPower);
+    }
+    for (uint32_t i = 1; i < kValenceTableSize; ++i) {
+      t.valence[i] = kValenceBoostScale * std::pow(static_cast<float>(i), -kValenceBoostPower);
+    }
+    return t;
+  }();
+  return tables;
+}
+
+float VertexScore(uint32_t cachePosition, uint32_t remainingTriangles) {
+  if (remainingTriangles == 0) {
+    return -1.0F;
+  }
+  const ScoreTables& tables = Scores();
+  const float score = cachePosition != kNone ? tables.cache[cachePosition] : 0.0F;
+  return score + (remainingTriangles < kValenceTableSize
+                      ? tables.valence[remainingTriangles]
+                      : kValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -kValenceBoostPower));
+}
+
+// Scratch shared by every range of a mesh; per-vertex entries are reset after each range.
+struct ForsythState {
+  std::vector<uint32_t> remaining;      // triangles of the range not emitted yet, per vertex
+  std::vector<uint32_t> cachePosition;  // kNone when outside the modelled cache
+  std::vector<float> vertexScore;
+  std::vector<uint32_t> adjacencyOffset;
+  std::vector<uint32_t> adjacency;  // live triangles of each vertex first, emitted ones swapped out
+  std::vector<uint32_t> touched;
+};
+
+void OptimizeRange(std::vector<uint32_t>& indices, IndexRange range, ForsythState& s) {
+  const uint32_t triangleCount = range.indexCount / 3;
+  if (triangleCount < 2) {
+    return;
+  }
+  const uint32_t* tri = indices.data() + range.firstIndex;
+
+  s.touched.clear();
+  for (uint32_t i = 0; i < triangleCount * 3; ++i) {
+    const uint32_t v = tri[i];
+    if (s.remaining[v]++ == 0) {
+      s.touched.push_back(v);
+    }
+  }
+  uint32_t offset = 0;
+  for (const uint32_t v : s.touched) {
+    s.adjacencyOffset[v] = offset;
+    offset += s.remaining[v];
+  }
+  s.adjacency.resize(offset);
+  for (const uint32_t v : s.touched) {
+    s.remaining[v] = 0;  // refilled below as the fill cursor
+  }
+  for (uint32_t t = 0; t < triangleCount; ++t) {
+    for (uint32_t k = 0; k < 3; ++k) {
+      const uint32_t v = tri[t * 3 + k];
+      s.adjacency[s.adjacencyOffset[v] + s.remaining[v]++] = t;
+    }
+  }
+  for (const uint32_t v : s.touched) {
+    s.vertexScore[v] = VertexScore(kNone, s.remaining[v]);
+  }
+
+  std::vector<float> triangleScore(triangleCount);
+  std::vector<uint8_t> emitted(triangleCount, 0);
+  uint32_t best = 0;
+  for (uint32_t t = 0; t < triangleCount; ++t) {
+    triangleScore[t] = s.vertexScore[tri[t * 3]] + s.vertexScore[tri[t * 3 + 1]] + s.vertexScore[tri[t * 3 + 2]];
+    if (triangleScore[t] > triangleScore[best]) {
+      best = t;
+    }
+  }
+
+  std::vector<uint32_t> output;
+  output.reserve(triangleCount * 3);
+  std::vector<uint32_t> cache;
+  std::vector<uint32_t> nextCache;
+  cache.reserve(kCacheSize + 3);
+  nextCache.reserve(kCacheSize + 3);
+  uint32_t inputCursor = 0;
+  while (output.size() < static_cast<size_t>(triangleCount) * 3) {
+    if (best == kNone) {
+      // Nothing in the cache has triangles left: continue with the next one in input order.
+      while (emitted[inputCursor] != 0) {
+        ++inputCursor;
+      }
+      best = inputCursor;
+    }
+    emitted[best] = 1;
+    nextCache.clear();
+    for (uint32_t k = 0; k < 3; ++k) {
+      const uint32_t v = tri[best * 3 + k];
+      output.push_back(v);
+      nextCache.push_back(v);
+      uint32_t* live = s.adjacency.data() + s.adjacencyOffset[v];
+      const uint32_t count = s.remaining[v]--;
+      *std::find(live, live + count, best) = live[count - 1];
+    }
+    for (const uint32_t v : cache) {
+      if (v != nextCache[0] && v != nextCache[1] && v != nextCache[2]) {
+        nextCache.push_back(v);
+      }
+    }
+    for (const uint32_t v : cache) {
+      s.cachePosition[v] = kNone;
+    }
+    for (uint32_t i = 0; i < nextCache.size(); ++i) {
+      const uint32_t v = nextCache[i];
+      s.cachePosition[v] = i < kCacheSize ? i : kNone;
+    }
+
+    // Only vertices that moved in, through or out of the cache change score, and only their live
+    // triangles can become the next best one.
+    best = kNone;
+    float bestScore = -1.0F;
+    for (const uint32_t v : nextCache) {
+      const float score = VertexScore(s.cachePosition[v], s.remaining[v]);
+      const float delta = score - s.vertexScore[v];
+      s.vertexScore[v] = score;
+      const uint32_t* live = s.adjacency.data() + s.adjacencyOffset[v];
+      for (uint32_t i = 0; i < s.remaining[v]; ++i) {
+        triangleScore[live[i]] += delta;
+      }
+    }
+    for (const uint32_t v : nextCache) {
+      if (s.cachePosition[v] == kNone) {
+        continue;
+      }
+      const uint32_t* live = s.adjacency.data() + s.adjacencyOffset[v];
+      for (uint32_t i = 0; i < s.remaining[v]; ++i) {
+        if (triangleScore[live[i]] > bestScore) {
+          bestScore = triangleScore[live[i]];
+          best = live[i];
+        }
+      }
+    }
+    nextCache.resize(std::min<size_t>(nextCache.size(), kCacheSize));
+    std::swap(cache, nextCache);
+  }
+
+  std::copy(output.begin(), output.end(), indices.begin() + range.firstIndex);
+  for (const uint32_t v : s.touched) {
+    s.remaining[v] = 0;
+    s.cachePosition[v] = kNone;
+  }
+}
+
+uint32_t CacheMisses(const std::vector<uint32_t>& indices, IndexRange range, uint32_t cacheSize, std::vector<uint32_t>& stamps) {
+  // FIFO: a vertex is cached while fewer than cacheSize misses happened since it was loaded.
+  uint32_t misses = 0;
+  const uint32_t end = range.firstIndex + range.indexCount / 3 * 3;
+  for (uint32_t i = range.firstIndex; i < end; ++i) {
+    const uint32_t v = indices[i];
+    if (stamps[v] == 0 || misses - stamps[v] >= cacheSize) {
+      ++misses;
+      stamps[v] = misses;
+    }
+  }
+  for (uint32_t i = range.firstIndex; i < end; ++i) {
+    stamps[indices[i]] = 0;
+  }
+  return misses;
+}
+
+}  // namespace
+
+float AverageCacheMissRatio(const std::vector<uint32_t>& indices, uint32_t firstIndex, uint32_t indexCount, uint32_t cacheSize) {
+  const uint32_t triangles = indexCount / 3;
+  if (triangles == 0) {
+    return 0.0F;
+  }
+  uint32_t maxIndex = 0;
+  for (uint32_t i = firstIndex; i < firstIndex + triangles * 3; ++i) {
+    maxIndex = std::max(maxIndex, indices[i]);
+  }
+  std::vector<uint32_t> stamps(static_cast<size_t>(maxIndex) + 1, 0);
+  return static_cast<float>(CacheMisses(indices, {firstIndex, indexCount}, cacheSize, stamps)) / static_cast<float>(triangles);
+}
+
+VertexCacheResult OptimizeVertexCache(Mesh& mesh) {
+  VertexCacheResult result;
+  const size_t vertexCount = mesh.vertices.size();
+  if (vertexCount == 0 || mesh.indices.size() < 6) {
+    return result;
+  }
+
+  // Clusters are contiguous inside their submesh, so ordering within each keeps them intact.
+  std::vector<IndexRange> ranges;
+  if (!mesh.clusters.empty()) {
+    for (const MeshCluster& cluster : mesh.clusters) {
+      ranges.push_back({cluster.firstIndex, cluster.indexCount});
+    }
+  } else {
+    for (const Submesh& submesh : mesh.submeshes) {
+      ranges.push_back({submesh.firstIndex, submesh.indexCount});
+    }
+  }
+  for (const MeshLod& lod : mesh.lods) {
+    for (const Submesh& submesh : lod.submeshes) {
+      ranges.push_back({submesh.firstIndex, submesh.indexCount});
+    }
+  }
+
+  ForsythState state;
+  state.remaining.assign(vertexCount, 0);
+  state.cachePosition.assign(vertexCount, kNone);
+  state.vertexScore.assign(vertexCount, 0.0F);
+  state.adjacencyOffset.assign(vertexCount, 0);
+  std::vector<uint32_t> stamps(vertexCount, 0);
+  uint32_t missesBefore = 0;
+  uint32_t missesAfter = 0;
+  for (const IndexRange& range : ranges) {
+    result.triangles += range.indexCount / 3;
+    missesBefore += CacheMisses(mesh.indices, range, 16, stamps);
+    OptimizeRange(mesh.indices, range, state);
+    missesAfter += CacheMisses(mesh.indices, range, 16, stamps);
+  }
+  if (result.triangles > 0) {
+    result.acmrBefore = static_cast<float>(missesBefore) / static_cast<float>(result.triangles);
+    result.acmrAfter = static_cast<float>(missesAfter) / static_cast<float>(result.triangles);
+  }
+
+  // Renumber in order of first use so vertex fetches follow the new triangle order; vertices no
+  // range references go last, in their old order.
+  std::vector<uint32_t> remap(vertexCount, kNone);
+  std::vector<VertexSkinned> ordered;
+  ordered.reserve(vertexCount);
+  for (uint32_t& index : mesh.indices) {
+    if (remap[index] == kNone) {
+      remap[index] = static_cast<uint32_t>(ordered.size());
+      ordered.push_back(mesh.vertices[index]);
+    }
+    index = remap[index];
+  }
+  for (uint32_t v = 0; v < vertexCount; ++v) {
+    if (remap[v] == kNone) {
+      remap[v] = static_cast<uint32_t>(ordered.size());
+      ordered.push_back(mesh.vertices[v]);
+    }
+  }
+  mesh.vertices = std::move(ordered);
+  if (!mesh.morphTargets.empty()) {
+    RemapMorphTargets(mesh, remap);
+  }
+  if (mesh.vertexLayout != VertexLayout::kFull) {
+    PackMeshVertices(mesh);
+  }
+  return result;
+}
+
+}  // namespace vv
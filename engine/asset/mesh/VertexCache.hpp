@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+// Average post-transform cache misses per triangle (ACMR) of a triangle list drawn through a FIFO
+// cache of `cacheSize` vertices: 3.0 when no vertex is ever reused, about 0.6-0.7 for a well
+// ordered regular grid.
+float AverageCacheMissRatio(const std::vector<uint32_t>& indices, uint32_t firstIndex, uint32_t indexCount, uint32_t cacheSize = 16);
+
+struct VertexCacheResult {
+  uint32_t triangles = 0;
+  float acmrBefore = 0.0F;  // over every reordered range, FIFO of 16
+  float acmrAfter = 0.0F;
+};
+
+// Reorders triangles for the post-transform vertex cache with Tom Forsyth's greedy linear-speed
+// ordering (a 32-entry LRU model), then renumbers vertices in order of first use so vertex fetches
+// follow. Triangles never leave their range: each cluster when the mesh has clusters, else each
+// submesh, plus every LOD range. Morph targets are remapped and packed vertex streams repacked;
+// unreferenced vertices are kept, after the referenced ones.
+VertexCacheResult OptimizeVertexCache(Mesh& mesh);
+
+}  // namespace vv
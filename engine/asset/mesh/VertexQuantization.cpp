@@ -0,0 +1,223 @@
+#include "asset/mesh/VertexQuantization.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include <glm/geometric.hpp>
+#include <glm/gtc/packing.hpp>
+
+namespace vv {
+namespace {
+
+constexpr float kSnorm16Max = 32767.0F;
+constexpr float kUnorm16Max = 65535.0F;
+
+float SignNotZero(float v) {
+  return v >= 0.0F ? 1.0F : -1.0F;
+}
+
+int16_t ToSnorm16(float v) {
+  return static_cast<int16_t>(std::clamp(v, -kSnorm16Max, kSnorm16Max));
+}
+
+float FromSnorm16(int16_t v) {
+  return std::max(static_cast<float>(v) / kSnorm16Max, -1.0F);
+}
+
+uint16_t QuantizeUnorm16(float value, float minValue, float extent) {
+  if (extent <= 0.0F) {
+    return 0;
+  }
+  const float t = std::clamp((value - minValue) / extent, 0.0F, 1.0F);
+  return static_cast<uint16_t>(std::lround(t * kUnorm16Max));
+}
+
+template <typename JointT>
+void PackVertexAs(const Mesh& mesh, const VertexSkinned& src, uint8_t* out) {
+  using Packed = PackedVertexSkinned<JointT>;
+  const Vec3 minP = mesh.localBounds.min;
+  const Vec3 extent = mesh.localBounds.max - mesh.localBounds.min;
+
+  Packed dst;
+  dst.position = {QuantizeUnorm16(src.position.x, minP.x, extent.x),
+                  QuantizeUnorm16(src.position.y, minP.y, extent.y),
+                  QuantizeUnorm16(src.position.z, minP.z, extent.z),
+                  static_cast<uint16_t>(src.tangent.w < 0.0F ? 0 : 65535)};
+
+  const auto n = OctEncodeSnorm16(src.normal);
+  const auto t = OctEncodeSnorm16(Vec3(src.tangent));
+  dst.normalTangent = {n[0], n[1], t[0], t[1]};
+  dst.uv0 = {static_cast<uint16_t>(glm::packHalf1x16(src.uv0.x)),
+             static_cast<uint16_t>(glm::packHalf1x16(src.uv0.y))};
+  for (size_t k = 0; k < kMaxBoneInfluence; ++k) {
+    dst.joints[k] = static_cast<JointT>(src.joints[k]);
+  }
+  dst.weights = QuantizeWeightsUnorm8(src.weights);
+
+  std::memcpy(out, &dst, sizeof(Packed));
+}
+
+template <typename JointT>
+void PackVertices(const Mesh& mesh, std::vector<uint8_t>& out) {
+  using Packed = PackedVertexSkinned<JointT>;
+  out.resize(mesh.vertices.size() * sizeof(Packed));
+  for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+    PackVertexAs<JointT>(mesh, mesh.vertices[i], out.data() + i * sizeof(Packed));
+  }
+}
+
+template <typename JointT>
+VertexSkinned UnpackVertexAs(const Mesh& mesh, size_t index) {
+  using Packed = PackedVertexSkinned<JointT>;
+  Packed src;
+  std::memcpy(&src, mesh.packedVertices.data() + index * sizeof(Packed), sizeof(Packed));
+
+  const Vec3 minP = mesh.localBounds.min;
+  const Vec3 extent = mesh.localBounds.max - mesh.localBounds.min;
+
+  VertexSkinned v;
+  v.position = minP + extent * Vec3(static_cast<float>(src.position[0]) / kUnorm16Max,
+                                    static_cast<float>(src.position[1]) / kUnorm16Max,
+                                    static_cast<float>(src.position[2]) / kUnorm16Max);
+  v.normal = OctDecodeSnorm16({src.normalTangent[0], src.normalTangent[1]});
+  v.tangent = Vec4(OctDecodeSnorm16({src.normalTangent[2], src.normalTangent[3]}),
+                   src.position[3] >= 32768 ? 1.0F : -1.0F);
+  v.uv0 = Vec2(glm::unpackHalf1x16(src.uv0[0]), glm::unpackHalf1x16(src.uv0[1]));
+  for (size_t k = 0; k < kMaxBoneInfluence; ++k) {
+    v.joints[k] = static_cast<uint16_t>(src.joints[k]);
+    v.weights[k] = static_cast<float>(src.weights[k]) / 255.0F;
+  }
+  return v;
+}
+
+}  // namespace
+
+Vec2 OctEncode(const Vec3& n) {
+  const float l1 = std::fabs(n.x) + std::fabs(n.y) + std::fabs(n.z);
+  if (l1 <= 1e-20F) {
+    return Vec2(0.0F, 0.0F);
+  }
+  Vec2 e(n.x / l1, n.y / l1);
+  if (n.z < 0.0F) {
+    e = Vec2((1.0F - std::fabs(e.y)) * SignNotZero(e.x), (1.0F - std::fabs(e.x)) * SignNotZero(e.y));
+  }
+  return e;
+}
+
+Vec3 OctDecode(const Vec2& e) {
+  Vec3 n(e.x, e.y, 1.0F - std::fabs(e.x) - std::fabs(e.y));
+  const float t = std::max(-n.z, 0.0F);
+  n.x += n.x >= 0.0F ? -t : t;
+  n.y += n.y >= 0.0F ? -t : t;
+  return glm::normalize(n);
+}
+
+std::array<int16_t, 2> OctEncodeSnorm16(const Vec3& n) {
+  const Vec2 e = OctEncode(n);
+  const float bx = std::floor(e.x * kSnorm16Max);
+  const float by = std::floor(e.y * kSnorm16Max);
+
+  std::array<int16_t, 2> best{ToSnorm16(std::round(e.x * kSnorm16Max)), ToSnorm16(std::round(e.y * kSnorm16Max))};
+  float bestDot = -2.0F;
+  for (int dx = 0; dx <= 1; ++dx) {
+    for (int dy = 0; dy <= 1; ++dy) {
+      const std::array<int16_t, 2> candidate{ToSnorm16(bx + static_cast<float>(dx)), ToSnorm16(by + static_cast<float>(dy))};
+      const float d = glm::dot(OctDecodeSnorm16(candidate), n);
+      if (d > bestDot) {
+        bestDot = d;
+        best = candidate;
+      }
+    }
+  }
+  return best;
+}
+
+Vec3 OctDecodeSnorm16(const std::array<int16_t, 2>& e) {
+  return OctDecode(Vec2(FromSnorm16(e[0]), FromSnorm16(e[1])));
+}
+
+std::array<uint8_t, kMaxBoneInfluence> QuantizeWeightsUnorm8(const std::array<float, kMaxBoneInfluence>& weights) {
+  float sum = 0.0F;
+  for (const float w : weights) {
+    sum += std::max(w, 0.0F);
+  }
+  if (sum <= 1e-8F) {
+    return {255, 0, 0, 0};
+  }
+
+  std::array<uint8_t, kMaxBoneInfluence> out{0, 0, 0, 0};
+  std::array<float, kMaxBoneInfluence> remainder{};
+  int assigned = 0;
+  for (size_t i = 0; i < kMaxBoneInfluence; ++i) {
+    const float scaled = std::max(weights[i], 0.0F) / sum * 255.0F;
+    const float base = std::floor(scaled);
+    out[i] = static_cast<uint8_t>(base);
+    remainder[i] = scaled - base;
+    assigned += static_cast<int>(base);
+  }
+
+  // Hand the leftover units to the largest fractional parts; ties favour the earlier (heavier) slot.
+  for (int left = 255 - assigned; left > 0; --left) {
+    size_t pick = 0;
+    for (size_t i = 1; i < kMaxBoneInfluence; ++i) {
+      if (remainder[i] > remainder[pick]) {
+        pick = i;
+      }
+    }
+    out[pick] = static_cast<uint8_t>(out[pick] + 1);
+    remainder[pick] = -1.0F;
+  }
+  return out;
+}
+
+bool PackMeshVertices(Mesh& mesh) {
+  if (mesh.vertices.empty()) {
+    return false;
+  }
+
+  uint16_t maxJoint = 0;
+  for (const VertexSkinned& v : mesh.vertices) {
+    for (const uint16_t j : v.joints) {
+      maxJoint = std::max(maxJoint, j);
+    }
+  }
+
+  if (maxJoint < 256) {
+    mesh.vertexLayout = VertexLayout::kPackedJoints8;
+    PackVertices<uint8_t>(mesh, mesh.packedVertices);
+  } else {
+    mesh.vertexLayout = VertexLayout::kPackedJoints16;
+    PackVertices<uint16_t>(mesh, mesh.packedVertices);
+  }
+  return true;
+}
+
+void PackVertex(const Mesh& mesh, const VertexSkinned& vertex, uint8_t* out) {
+  switch (mesh.vertexLayout) {
+    case VertexLayout::kPackedJoints8:
+      PackVertexAs<uint8_t>(mesh, vertex, out);
+      break;
+    case VertexLayout::kPackedJoints16:
+      PackVertexAs<uint16_t>(mesh, vertex, out);
+      break;
+    case VertexLayout::kFull:
+    default:
+      std::memcpy(out, &vertex, sizeof(VertexSkinned));
+      break;
+  }
+}
+
+VertexSkinned UnpackVertex(const Mesh& mesh, size_t index) {
+  switch (mesh.vertexLayout) {
+    case VertexLayout::kPackedJoints8:
+      return UnpackVertexAs<uint8_t>(mesh, index);
+    case VertexLayout::kPackedJoints16:
+      return UnpackVertexAs<uint16_t>(mesh, index);
+    case VertexLayout::kFull:
+    default:
+      return mesh.vertices[index];
+  }
+}
+
+}  // namespace vv
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "core/math/MathTypes.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+Vec2 OctEncode(const Vec3& n);
+Vec3 OctDecode(const Vec2& e);
+
+// Picks the snorm16 rounding that decodes closest to n instead of plain round-to-nearest.
+std::array<int16_t, 2> OctEncodeSnorm16(const Vec3& n);
+Vec3 OctDecodeSnorm16(const std::array<int16_t, 2>& e);
+
+// Largest-remainder rounding so the four bytes always sum to exactly 255.
+std::array<uint8_t, kMaxBoneInfluence> QuantizeWeightsUnorm8(const std::array<float, kMaxBoneInfluence>& weights);
+
+// Builds Mesh::packedVertices from Mesh::vertices and Mesh::localBounds. Joints are stored as
+// u8 when every referenced bone index fits, otherwise u16. Returns false when nothing was packed.
+bool PackMeshVertices(Mesh& mesh);
+
+// Writes `vertex` in the mesh's layout (VertexStride bytes), quantized like PackMeshVertices.
+void PackVertex(const Mesh& mesh, const VertexSkinned& vertex, uint8_t* out);
+
+VertexSkinned UnpackVertex(const Mesh& mesh, size_t index);
+
+}  // namespace vv
@@ -0,0 +1,179 @@
+#include "asset/mesh/VertexWeld.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "asset/mesh/MeshletBuilder.hpp"
+#include "asset/mesh/MorphTargets.hpp"
+#include "asset/mesh/VertexQuantization.hpp"
+#include "core/thread/ParallelFor.hpp"
+
+namespace vv {
+namespace {
+
+constexpr size_t kVerticesPerChunk = 4096;
+constexpr uint32_t kPartitionBits = 6;  // fixed, so partitions never depend on the thread count
+constexpr uint32_t kPartitionCount = 1U << kPartitionBits;
+constexpr uint32_t kNoVertex = UINT32_MAX;
+
+// position 3, normal 3, tangent 3 + sign, uv 2, weights 4, joints 4 x u16 in 2 words, morph
+// signature in 2 words
+using WeldKey = std::array<uint32_t, 20>;
+
+uint32_t QuantizeComponent(float value, float epsilon) {
+  if (epsilon > 0.0F && std::isfinite(value)) {
+    const double cell = std::floor(static_cast<double>(value) / static_cast<double>(epsilon) + 0.5);
+    return static_cast<uint32_t>(static_cast<int32_t>(std::clamp(cell, -2147483648.0, 2147483647.0)));
+  }
+  const float canonical = value == 0.0F ? 0.0F : value;  // -0 welds with +0
+  uint32_t bits = 0;
+  std::memcpy(&bits, &canonical, sizeof(bits));
+  return bits;
+}
+
+WeldKey MakeKey(const VertexSkinned& v, uint64_t morphSignature, const VertexWeldOptions& options) {
+  WeldKey key{};
+  size_t i = 0;
+  for (int c = 0; c < 3; ++c) {
+    key[i++] = QuantizeComponent(v.position[c], options.positionEpsilon);
+  }
+  for (int c = 0; c < 3; ++c) {
+    key[i++] = QuantizeComponent(v.normal[c], options.normalEpsilon);
+  }
+  for (int c = 0; c < 3; ++c) {
+    key[i++] = QuantizeComponent(v.tangent[c], options.tangentEpsilon);
+  }
+  key[i++] = v.tangent.w < 0.0F ? 1U : 0U;
+  for (int c = 0; c < 2; ++c) {
+    key[i++] = QuantizeComponent(v.uv0[c], options.uvEpsilon);
+  }
+  for (const float weight : v.weights) {
+    key[i++] = QuantizeComponent(weight, options.weightEpsilon);
+  }
+  key[i++] = static_cast<uint32_t>(v.joints[0]) | (static_cast<uint32_t>(v.joints[1]) << 16);
+  key[i++] = static_cast<uint32_t>(v.joints[2]) | (static_cast<uint32_t>(v.joints[3]) << 16);
+  key[i++] = static_cast<uint32_t>(morphSignature);
+  key[i++] = static_cast<uint32_t>(morphSignature >> 32);
+  return key;
+}
+
+uint64_t HashKey(const WeldKey& key) {
+  uint64_t h = 0x9E3779B97F4A7C15ULL;
+  for (const uint32_t word : key) {
+    h ^= word;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 32;
+  }
+  return h;
+}
+
+uint32_t PartitionOf(uint64_t hash) {
+  return static_cast<uint32_t>(hash >> (64 - kPartitionBits));
+}
+
+}  // namespace
+
+VertexWeldResult WeldVertices(Mesh& mesh, const VertexWeldOptions& options) {
+  VertexWeldResult result;
+  const size_t vertexCount = mesh.vertices.size();
+  result.inputVertices = static_cast<uint32_t>(vertexCount);
+  result.outputVertices = result.inputVertices;
+  if (vertexCount == 0 || mesh.indices.empty()) {
+    return result;
+  }
+
+  // Vertices that blend shapes move differently stay apart.
+  const std::vector<uint64_t> morphSignatures = MorphSignatures(mesh);
+  std::vector<WeldKey> keys(vertexCount);
+  std::vector<uint64_t> hashes(vertexCount);
+  ParallelFor(vertexCount, kVerticesPerChunk, [&](size_t begin, size_t end) {
+    for (size_t v = begin; v < end; ++v) {
+      keys[v] = MakeKey(mesh.vertices[v], morphSignatures[v], options);
+      hashes[v] = HashKey(keys[v]);
+    }
+  });
+
+  // Counting sort by partition; each partition lists its vertices in ascending order.
+  std::vector<uint32_t> partitionOffsets(kPartitionCount + 1, 0);
+  for (const uint64_t hash : hashes) {
+    ++partitionOffsets[PartitionOf(hash) + 1];
+  }
+  for (uint32_t p = 0; p < kPartitionCount; ++p) {
+    partitionOffsets[p + 1] += partitionOffsets[p];
+  }
+  std::vector<uint32_t> partitioned(vertexCount);
+  std::vector<uint32_t> cursor(partitionOffsets.begin(), partitionOffsets.end() - 1);
+  for (uint32_t v = 0; v < vertexCount; ++v) {
+    partitioned[cursor[PartitionOf(hashes[v])]++] = v;
+  }
+
+  // Equal keys always share a partition, so partitions dedupe independently. The first (lowest)
+  // vertex of each key represents it.
+  std::vector<uint32_t> representative(vertexCount);
+  ParallelFor(kPartitionCount, 1, [&](size_t begin, size_t end) {
+    std::vector<uint32_t> table;
+    for (size_t p = begin; p < end; ++p) {
+      const uint32_t first = partitionOffsets[p];
+      const uint32_t last = partitionOffsets[p + 1];
+      if (first == last) {
+        continue;
+      }
+      size_t capacity = 16;
+      while (capacity < 2 * static_cast<size_t>(last - first)) {
+        capacity <<= 1;
+      }
+      table.assign(capacity, kNoVertex);
+      for (uint32_t i = first; i < last; ++i) {
+        const uint32_t v = partitioned[i];
+        size_t slot = static_cast<size_t>(hashes[v]) & (capacity - 1);
+        while (true) {
+          const uint32_t other = table[slot];
+          if (other == kNoVertex) {
+            table[slot] = v;
+            representative[v] = v;
+            break;
+          }
+          if (hashes[other] == hashes[v] && keys[other] == keys[v]) {
+            representative[v] = other;
+            break;
+          }
+          slot = (slot + 1) & (capacity - 1);
+        }
+      }
+    }
+  });
+
+  // Renumber in order of first use, which also keeps vertex fetches roughly sequential.
+  std::vector<uint32_t> remap(vertexCount, kNoVertex);
+  std::vector<VertexSkinned> welded;
+  welded.reserve(vertexCount);
+  for (uint32_t& index : mesh.indices) {
+    const uint32_t rep = representative[index];
+    if (remap[rep] == kNoVertex) {
+      remap[rep] = static_cast<uint32_t>(welded.size());
+      welded.push_back(mesh.vertices[rep]);
+    }
+    index = remap[rep];
+  }
+  mesh.vertices = std::move(welded);
+  result.outputVertices = static_cast<uint32_t>(mesh.vertices.size());
+  if (!mesh.morphTargets.empty()) {
+    for (uint32_t v = 0; v < vertexCount; ++v) {
+      remap[v] = remap[representative[v]];
+    }
+    RemapMorphTargets(mesh, remap);
+  }
+
+  if (!mesh.clusters.empty()) {
+    BuildMeshClusters(mesh);
+  }
+  if (mesh.vertexLayout != VertexLayout::kFull) {
+    PackMeshVertices(mesh);
+  }
+  return result;
+}
+
+}  // namespace vv
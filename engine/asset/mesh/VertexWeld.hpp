@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+// Attributes are compared after rounding to multiples of their epsilon; 0 compares exact values.
+// Joint indices and morph target deltas compare exactly. Rounding snaps to a fixed grid, so two
+// values closer than epsilon still stay apart when a rounding boundary ((k + 0.5) * epsilon) lies
+// between them, and values up to almost 2 * epsilon apart weld when it does not. Exact duplicates,
+// what FBX corner splitting produces, always weld.
+struct VertexWeldOptions {
+  float positionEpsilon = 1e-5F;  // mesh units (meters after conversion)
+  float normalEpsilon = 1e-3F;    // per component
+  float tangentEpsilon = 1e-3F;   // per xyz component; the bitangent sign always compares exactly
+  float uvEpsilon = 1e-5F;
+  float weightEpsilon = 1e-3F;    // finer than the unorm8 weights of the packed layout
+};
+
+struct VertexWeldResult {
+  uint32_t inputVertices = 0;
+  uint32_t outputVertices = 0;
+};
+
+// Merges equal vertices of `mesh`. Vertices are hashed in parallel, split into a fixed number of
+// hash partitions and deduplicated per partition in parallel; each group keeps its lowest-index
+// vertex, so the result does not depend on the thread count. Surviving vertices are renumbered in
+// order of first use by Mesh::indices (unreferenced ones are dropped), every index range (LODs
+// included) and morph target is remapped, clusters are rebuilt and packed vertex streams repacked.
+VertexWeldResult WeldVertices(Mesh& mesh, const VertexWeldOptions& options = {});
+
+}  // namespace vv
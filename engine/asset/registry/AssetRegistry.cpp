@@ -0,0 +1,410 @@
+#include "asset/registry/AssetRegistry.hpp"
+
+#include <cstring>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "asset/texture/TextureRegistry.hpp"
+
+namespace vv {
+namespace {
+
+constexpr uint64_t kGolden = 0x9E3779B97F4A7C15ULL;
+
+// Folds fields into one key; arrays go through HashBytes in one piece and count as content bytes.
+class ContentHasher {
+ public:
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  void Add(const T& value) {
+    Bytes(&value, sizeof(T), false);
+  }
+
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  void Add(const std::vector<T>& values) {
+    Add(static_cast<uint64_t>(values.size()));
+    Bytes(values.data(), values.size() * sizeof(T), true);
+  }
+
+  void Add(const std::string& value) {
+    Add(static_cast<uint64_t>(value.size()));
+    Bytes(value.data(), value.size(), false);
+  }
+
+  // Large blobs that are not counted as content (pixels, encoded sources) enter as their hash.
+  void AddBlob(std::span<const uint8_t> blob) { Add(HashBytes(blob.data(), blob.size())); }
+
+  [[nodiscard]] bool Matches() const { return true; }
+  uint64_t Hash() const { return hash_; }
+  uint64_t ContentBytes() const { return bytes_; }
+
+ private:
+  void Bytes(const void* data, size_t size, bool content) {
+    hash_ = (hash_ ^ HashBytes(static_cast<const uint8_t*>(data), size)) * kGolden;
+    hash_ ^= hash_ >> 29U;
+    if (content) {
+      bytes_ += size;
+    }
+  }
+
+  uint64_t hash_ = kGolden;
+  uint64_t bytes_ = 0;
+};
+
+// Walks two assets through the same fields as ContentHasher and compares them byte for byte, so a
+// registry hit is confirmed by content rather than by a 64-bit key.
+class ContentComparer {
+ public:
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  void Add(const T& a, const T& b) {
+    equal_ = equal_ && std::memcmp(&a, &b, sizeof(T)) == 0;
+  }
+
+  template <typename T>
+    requires std::is_trivially_copyable_v<T>
+  void Add(const std::vector<T>& a, const std::vector<T>& b) {
+    equal_ = equal_ && a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(T)) == 0);
+  }
+
+  void Add(const std::string& a, const std::string& b) { equal_ = equal_ && a == b; }
+
+  void AddBlob(std::span<const uint8_t> a, std::span<const uint8_t> b) {
+    equal_ = equal_ && a.size() == b.size() && (a.empty() || a.data() == b.data() || std::memcmp(a.data(), b.data(), a.size()) == 0);
+  }
+
+  [[nodiscard]] bool Matches() const { return equal_; }
+
+ private:
+  bool equal_ = true;
+};
+
+// The Visit* walks take one asset (hashing) or two (comparing). Loops run over the first asset once
+// its count has been added, and stop as soon as the comparer has seen a difference.
+template <typename T, typename... Rest>
+const T& First(const T& first, const Rest&...) {
+  return first;
+}
+
+template <typename Visitor, typename... M>
+void VisitMesh(Visitor& v, const M&... mesh) {
+  v.Add(mesh.name...);
+  v.Add(mesh.vertices...);
+  v.Add(mesh.indices...);
+  v.Add(mesh.submeshes...);
+  v.Add(mesh.localBounds...);
+  v.Add(mesh.vertexLayout...);
+  v.Add(mesh.packedVertices...);
+  v.Add(mesh.clusters...);
+  v.Add(mesh.clusterBones...);
+  v.Add(static_cast<uint64_t>(mesh.lods.size())...);
+  for (size_t i = 0; v.Matches() && i < First(mesh...).lods.size(); ++i) {
+    v.Add(mesh.lods[i].submeshes...);
+    v.Add(mesh.lods[i].error...);
+  }
+  v.Add(static_cast<uint64_t>(mesh.morphTargets.size())...);
+  for (size_t i = 0; v.Matches() && i < First(mesh...).morphTargets.size(); ++i) {
+    v.Add(mesh.morphTargets[i].name...);
+    v.Add(mesh.morphTargets[i].vertices...);
+    for (size_t c = 0; c < 3; ++c) {
+      v.Add(mesh.morphTargets[i].positionDeltas[c]...);
+      v.Add(mesh.morphTargets[i].normalDeltas[c]...);
+    }
+    v.Add(mesh.morphTargets[i].positionScale...);
+    v.Add(mesh.morphTargets[i].normalScale...);
+  }
+  v.Add(mesh.morphWeights...);
+  // `cooked` is left out: where released arrays come back from does not change the mesh.
+  v.Add(mesh.arraysReleased...);
+}
+
+template <typename Visitor, typename... S>
+void VisitSkeleton(Visitor& v, const S&... skeleton) {
+  // boneMap is derived from the bone names.
+  v.Add(skeleton.name...);
+  v.Add(skeleton.rootNode...);
+  v.Add(static_cast<uint64_t>(skeleton.bones.size())...);
+  for (size_t i = 0; v.Matches() && i < First(skeleton...).bones.size(); ++i) {
+    v.Add(skeleton.bones[i].name...);
+    v.Add(skeleton.bones[i].node...);
+    v.Add(skeleton.bones[i].parentBone...);
+    v.Add(skeleton.bones[i].inverseBind...);
+    v.Add(skeleton.bones[i].globalBind...);
+  }
+}
+
+template <typename Visitor, typename... C>
+void VisitClip(Visitor& v, const C&... clip) {
+  v.Add(clip.name...);
+  v.Add(clip.durationSec...);
+  v.Add(clip.ticksPerSec...);
+  v.Add(static_cast<uint64_t>(clip.tracks.size())...);
+  for (size_t i = 0; v.Matches() && i < First(clip...).tracks.size(); ++i) {
+    v.Add(clip.tracks[i].node...);
+    v.Add(clip.tracks[i].posKeys...);
+    v.Add(clip.tracks[i].rotKeys...);
+    v.Add(clip.tracks[i].sclKeys...);
+  }
+  v.Add(static_cast<uint64_t>(clip.morphTracks.size())...);
+  for (size_t i = 0; v.Matches() && i < First(clip...).morphTracks.size(); ++i) {
+    v.Add(clip.morphTracks[i].node...);
+    v.Add(clip.morphTracks[i].targets...);
+    v.Add(clip.morphTracks[i].times...);
+    v.Add(clip.morphTracks[i].weights...);
+  }
+}
+
+std::span<const uint8_t> SourceBlob(const Texture& texture) {
+  return texture.source.bytes != nullptr ? std::span<const uint8_t>(*texture.source.bytes) : std::span<const uint8_t>();
+}
+
+std::span<const uint8_t> PixelBlob(const Texture& texture) {
+  return {texture.pixels.data(), texture.pixels.size()};
+}
+
+template <typename Visitor, typename... T>
+void VisitTexture(Visitor& v, const T&... texture) {
+  v.Add(texture.width...);
+  v.Add(texture.height...);
+  v.Add(texture.format...);
+  v.Add(texture.srgb...);
+  v.Add(texture.normalMap...);
+  v.Add(texture.mipLevels...);
+  v.Add(texture.streaming...);
+  v.Add(texture.pixelsReleased...);
+  v.Add(texture.contentHash...);
+  if (!v.Matches()) {
+    return;
+  }
+  const bool sourceUnknown = First(texture...).contentHash == 0;
+  if (sourceUnknown) {
+    v.Add(texture.source.path...);
+    v.Add(texture.source.rawWidth...);
+    v.Add(texture.source.rawHeight...);
+    v.AddBlob(SourceBlob(texture)...);
+  }
+  // Pixels follow from the source when it is known; they only need hashing when they are all there is.
+  v.Add(static_cast<uint64_t>(texture.pixels.size())...);
+  if (v.Matches() && sourceUnknown && !First(texture...).pixels.empty()) {
+    v.AddBlob(PixelBlob(texture)...);
+  }
+}
+
+ContentHasher HashMesh(const Mesh& mesh) {
+  ContentHasher h;
+  VisitMesh(h, mesh);
+  return h;
+}
+
+ContentHasher HashSkeleton(const Skeleton& skeleton) {
+  ContentHasher h;
+  VisitSkeleton(h, skeleton);
+  return h;
+}
+
+ContentHasher HashClip(const AnimationClip& clip) {
+  ContentHasher h;
+  VisitClip(h, clip);
+  return h;
+}
+
+ContentHasher HashTexture(const Texture& texture) {
+  ContentHasher h;
+  VisitTexture(h, texture);
+  return h;
+}
+
+bool SameContent(const Mesh& a, const Mesh& b) {
+  ContentComparer c;
+  VisitMesh(c, a, b);
+  return c.Matches();
+}
+
+bool SameContent(const Skeleton& a, const Skeleton& b) {
+  ContentComparer c;
+  VisitSkeleton(c, a, b);
+  return c.Matches();
+}
+
+bool SameContent(const AnimationClip& a, const AnimationClip& b) {
+  ContentComparer c;
+  VisitClip(c, a, b);
+  return c.Matches();
+}
+
+bool SameContent(const Texture& a, const Texture& b) {
+  ContentComparer c;
+  VisitTexture(c, a, b);
+  return c.Matches();
+}
+
+uint64_t TextureBytes(const Texture& texture) {
+  return texture.pixels.size() + (texture.source.bytes != nullptr ? texture.source.bytes->size() : 0);
+}
+
+}  // namespace
+
+uint64_t MeshContentHash(const Mesh& mesh) {
+  return HashMesh(mesh).Hash();
+}
+
+uint64_t SkeletonContentHash(const Skeleton& skeleton) {
+  return HashSkeleton(skeleton).Hash();
+}
+
+uint64_t ClipContentHash(const AnimationClip& clip) {
+  return HashClip(clip).Hash();
+}
+
+uint64_t TextureContentHash(const Texture& texture) {
+  return HashTexture(texture).Hash();
+}
+
+AssetRegistry& AssetRegistry::Global() {
+  static AssetRegistry registry;
+  return registry;
+}
+
+template <typename T>
+SharedAsset<T> AssetRegistry::InternLocked(const SharedAsset<T>& asset, uint64_t hash, uint64_t bytes, Table<T>& table) {
+  ++stats_.interned;
+  Entry<T>& entry = table[hash];
+  std::shared_ptr<const T> registered = entry.asset.lock();
+  // The key alone is not trusted: a registered asset may have been edited in place by its last
+  // holder since it was hashed (SharedAsset::Edit), or may merely collide. Either way it is replaced.
+  if (registered != nullptr && entry.bytes == bytes &&
+      (registered == asset.Handle() || SameContent(*registered, *asset))) {
+    if (registered != asset.Handle()) {
+      ++stats_.shared;
+      stats_.sharedBytes += bytes;
+    }
+    return SharedAsset<T>(std::move(registered));
+  }
+  entry.bytes = bytes;
+  entry.asset = asset.Handle();
+  return asset;
+}
+
+template <typename T>
+void AssetRegistry::ForgetLocked(const T& asset, Table<T>& table) {
+  std::erase_if(table, [&](const auto& item) {
+    const std::shared_ptr<const T> registered = item.second.asset.lock();
+    return registered == nullptr || registered.get() == &asset;
+  });
+}
+
+void AssetRegistry::DropExpiredLocked() {
+  const auto drop = [](auto& table) { std::erase_if(table, [](const auto& item) { return item.second.asset.expired(); }); };
+  drop(meshes_);
+  drop(skeletons_);
+  drop(clips_);
+  drop(textures_);
+}
+
+void AssetRegistry::Intern(Scene& scene) {
+  // Hashing runs outside the lock; only the table lookups are serialized.
+  std::vector<ContentHasher> meshKeys;
+  std::vector<ContentHasher> skeletonKeys;
+  std::vector<ContentHasher> clipKeys;
+  std::vector<ContentHasher> textureKeys;
+  for (const Mesh& mesh : scene.meshes) {
+    meshKeys.push_back(HashMesh(mesh));
+  }
+  for (const Skeleton& skeleton : scene.skeletons) {
+    skeletonKeys.push_back(HashSkeleton(skeleton));
+  }
+  for (const AnimationClip& clip : scene.clips) {
+    clipKeys.push_back(HashClip(clip));
+  }
+  for (const Texture& texture : scene.textures) {
+    textureKeys.push_back(HashTexture(texture));
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  DropExpiredLocked();
+  for (size_t i = 0; i < scene.meshes.size(); ++i) {
+    scene.meshes[i] = InternLocked(scene.meshes[i], meshKeys[i].Hash(), meshKeys[i].ContentBytes(), meshes_);
+  }
+  for (size_t i = 0; i < scene.skeletons.size(); ++i) {
+    scene.skeletons[i] =
+        InternLocked(scene.skeletons[i], skeletonKeys[i].Hash(), skeletonKeys[i].ContentBytes(), skeletons_);
+  }
+  for (size_t i = 0; i < scene.clips.size(); ++i) {
+    scene.clips[i] = InternLocked(scene.clips[i], clipKeys[i].Hash(), clipKeys[i].ContentBytes(), clips_);
+  }
+  for (size_t i = 0; i < scene.textures.size(); ++i) {
+    scene.textures[i] = InternLocked(scene.textures[i], textureKeys[i].Hash(), TextureBytes(*scene.textures[i]), textures_);
+  }
+}
+
+SharedAsset<Mesh> AssetRegistry::Intern(const SharedAsset<Mesh>& mesh) {
+  const ContentHasher key = HashMesh(mesh);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return InternLocked(mesh, key.Hash(), key.ContentBytes(), meshes_);
+}
+
+SharedAsset<Skeleton> AssetRegistry::Intern(const SharedAsset<Skeleton>& skeleton) {
+  const ContentHasher key = HashSkeleton(skeleton);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return InternLocked(skeleton, key.Hash(), key.ContentBytes(), skeletons_);
+}
+
+SharedAsset<AnimationClip> AssetRegistry::Intern(const SharedAsset<AnimationClip>& clip) {
+  const ContentHasher key = HashClip(clip);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return InternLocked(clip, key.Hash(), key.ContentBytes(), clips_);
+}
+
+SharedAsset<Texture> AssetRegistry::Intern(const SharedAsset<Texture>& texture) {
+  const ContentHasher key = HashTexture(texture);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return InternLocked(texture, key.Hash(), TextureBytes(*texture), textures_);
+}
+
+void AssetRegistry::Forget(const Mesh& mesh) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ForgetLocked(mesh, meshes_);
+}
+
+void AssetRegistry::Forget(const Skeleton& skeleton) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ForgetLocked(skeleton, skeletons_);
+}
+
+void AssetRegistry::Forget(const AnimationClip& clip) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ForgetLocked(clip, clips_);
+}
+
+void AssetRegistry::Forget(const Texture& texture) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ForgetLocked(texture, textures_);
+}
+
+AssetRegistryStats AssetRegistry::Stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  AssetRegistryStats stats = stats_;
+  const auto live = [](const auto& table) {
+    uint64_t count = 0;
+    for (const auto& item : table) {
+      count += item.second.asset.expired() ? 0 : 1;
+    }
+    return count;
+  };
+  stats.live = live(meshes_) + live(skeletons_) + live(clips_) + live(textures_);
+  return stats;
+}
+
+void AssetRegistry::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  meshes_.clear();
+  skeletons_.clear();
+  clips_.clear();
+  textures_.clear();
+  stats_ = {};
+}
+
+}  // namespace vv
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+// Content keys of shared assets. Names take part for meshes, skeletons and clips; textures follow
+// TextureGpuKey and ignore their uri, so the same image reached through different paths is one asset.
+uint64_t MeshContentHash(const Mesh& mesh);
+uint64_t SkeletonContentHash(const Skeleton& skeleton);
+uint64_t ClipContentHash(const AnimationClip& clip);
+uint64_t TextureContentHash(const Texture& texture);
+
+struct AssetRegistryStats {
+  uint64_t interned = 0;     // assets passed through Intern
+  uint64_t shared = 0;       // replaced by an equal asset some scene already held
+  uint64_t sharedBytes = 0;  // vertex, index, key and pixel bytes not held twice thanks to that
+  uint64_t live = 0;         // registered assets still held by some scene
+};
+
+// Process-wide table of the meshes, skeletons, clips and textures scenes hold, keyed by content, so
+// loading the same character twice ends up with one copy of each asset that both scenes (and the
+// renderer's uploads, keyed by asset identity) share. Entries are weak: an asset lives exactly as
+// long as some scene holds it, and a later import of the same content registers it again. A key hit
+// is only taken after comparing content, so an asset its last holder edited in place, or one that
+// merely collides, is never handed out.
+class AssetRegistry {
+ public:
+  static AssetRegistry& Global();
+
+  // Replaces every asset of `scene` equal to a registered one by the registered one and registers
+  // the rest. Equal assets within the scene are folded onto one as well.
+  void Intern(Scene& scene);
+
+  SharedAsset<Mesh> Intern(const SharedAsset<Mesh>& mesh);
+  SharedAsset<Skeleton> Intern(const SharedAsset<Skeleton>& skeleton);
+  SharedAsset<AnimationClip> Intern(const SharedAsset<AnimationClip>& clip);
+  SharedAsset<Texture> Intern(const SharedAsset<Texture>& texture);
+
+  // Drops the entry of this very asset, if any, so its holder may change it in place (see
+  // ApplyCpuResidency) without later imports of the original content being offered it.
+  void Forget(const Mesh& mesh);
+  void Forget(const Skeleton& skeleton);
+  void Forget(const AnimationClip& clip);
+  void Forget(const Texture& texture);
+
+  AssetRegistryStats Stats() const;
+  void Clear();
+
+ private:
+  template <typename T>
+  struct Entry {
+    uint64_t bytes = 0;
+    std::weak_ptr<const T> asset;
+  };
+
+  template <typename T>
+  using Table = std::unordered_map<uint64_t, Entry<T>>;
+
+  template <typename T>
+  SharedAsset<T> InternLocked(const SharedAsset<T>& asset, uint64_t hash, uint64_t bytes, Table<T>& table);
+  template <typename T>
+  void ForgetLocked(const T& asset, Table<T>& table);
+  void DropExpiredLocked();
+
+  mutable std::mutex mutex_;
+  Table<Mesh> meshes_;
+  Table<Skeleton> skeletons_;
+  Table<AnimationClip> clips_;
+  Table<Texture> textures_;
+  AssetRegistryStats stats_;
+};
+
+}  // namespace vv
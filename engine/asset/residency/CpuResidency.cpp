@@ -0,0 +1,199 @@
+#include "asset/residency/CpuResidency.hpp"
+
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "asset/cook/CookedScene.hpp"
+#include "asset/import/AsyncImport.hpp"
+#include "asset/registry/AssetRegistry.hpp"
+
+namespace vv {
+namespace {
+
+uint64_t MeshArrayBytes(const Mesh& mesh) {
+  return mesh.vertices.size() * sizeof(VertexSkinned) + mesh.indices.size() * sizeof(uint32_t) + mesh.packedVertices.size();
+}
+
+// Calls `release` once for every asset of `assets` that only this scene holds, with slots sharing
+// it still sharing it afterwards. The other slots are cleared first so Edit() changes the asset in
+// place: the renderer keys its GPU copies by asset identity and keeps them. `release` takes the
+// asset out of the AssetRegistry before changing it, or the next import of the same file would
+// be handed the released asset.
+template <typename T, typename Fn>
+void ReleaseSoleAssets(std::vector<SharedAsset<T>>& assets, uint32_t& kept, Fn&& release) {
+  std::unordered_map<const T*, std::vector<size_t>> slots;
+  std::vector<const T*> order;
+  for (size_t i = 0; i < assets.size(); ++i) {
+    std::vector<size_t>& list = slots[assets[i].Handle().get()];
+    if (list.empty()) {
+      order.push_back(assets[i].Handle().get());
+    }
+    list.push_back(i);
+  }
+  for (const T* asset : order) {
+    const std::vector<size_t>& list = slots[asset];
+    if (static_cast<size_t>(assets[list[0]].Handle().use_count()) != list.size()) {
+      ++kept;
+      continue;
+    }
+    SharedAsset<T> held = assets[list[0]];
+    for (const size_t slot : list) {
+      assets[slot] = SharedAsset<T>(std::shared_ptr<const T>{});
+    }
+    release(held.Edit());
+    for (const size_t slot : list) {
+      assets[slot] = held;
+    }
+  }
+}
+
+}  // namespace
+
+const char* CpuResidencyName(CpuResidency policy) {
+  switch (policy) {
+    case CpuResidency::kKeep:
+      return "keep";
+    case CpuResidency::kReleaseAfterUpload:
+      return "release";
+    case CpuResidency::kReloadFromCooked:
+      return "reload";
+  }
+  return "unknown";
+}
+
+CpuResidencyStats ApplyCpuResidency(Scene& scene, CpuResidency policy) {
+  CpuResidencyStats stats;
+  if (policy == CpuResidency::kKeep) {
+    return stats;
+  }
+  const bool reloadableOnly = policy == CpuResidency::kReloadFromCooked;
+
+  ReleaseSoleAssets(scene.meshes, stats.kept, [&](Mesh& mesh) {
+    if (mesh.arraysReleased || MeshArrayBytes(mesh) == 0) {
+      return;
+    }
+    if (!mesh.morphTargets.empty() || (reloadableOnly && mesh.cooked.path.empty())) {
+      ++stats.kept;
+      return;
+    }
+    AssetRegistry::Global().Forget(mesh);
+    stats.releasedBytes += MeshArrayBytes(mesh);
+    mesh.vertices = std::vector<VertexSkinned>{};
+    mesh.indices = std::vector<uint32_t>{};
+    mesh.packedVertices = std::vector<uint8_t>{};
+    mesh.arraysReleased = true;
+    ++stats.meshesReleased;
+  });
+
+  ReleaseSoleAssets(scene.textures, stats.kept, [&](Texture& texture) {
+    if (texture.pixels.empty() || texture.streaming) {
+      return;
+    }
+    const bool hasSource = !texture.source.path.empty() || texture.source.bytes != nullptr;
+    if (reloadableOnly && !hasSource && texture.cooked.path.empty()) {
+      ++stats.kept;
+      return;
+    }
+    AssetRegistry::Global().Forget(texture);
+    stats.releasedBytes += texture.pixels.size();
+    ++stats.texturesReleased;
+    // The cooked copy keeps mips and block compression; a source only gives back level 0.
+    if (texture.cooked.path.empty() && hasSource) {
+      ReleaseDecodedPixels(texture);
+      return;
+    }
+    texture.pixels = PixelBuffer{};
+    texture.pixelsReleased = true;
+  });
+  return stats;
+}
+
+LoadResult<SharedAsset<Mesh>> AcquireMeshArrays(const SharedAsset<Mesh>& mesh) {
+  if (!mesh->arraysReleased) {
+    return {.value = mesh, .error = {}};
+  }
+  if (mesh->cooked.path.empty()) {
+    return {.value = std::nullopt, .error = "mesh '" + mesh->name + "' was released with no cooked file to read it from"};
+  }
+  LoadResult<Mesh> loaded = ReadCookedMesh(mesh->cooked.path, mesh->cooked.index);
+  if (!loaded.Ok()) {
+    return {.value = std::nullopt, .error = loaded.error};
+  }
+  if (loaded.value->name != mesh->name || loaded.value->submeshes.size() != mesh->submeshes.size()) {
+    return {.value = std::nullopt, .error = mesh->cooked.path + ": mesh " + std::to_string(mesh->cooked.index) + " no longer matches '" + mesh->name + "'"};
+  }
+  return {.value = SharedAsset<Mesh>(std::move(*loaded.value)), .error = {}};
+}
+
+LoadResult<SharedAsset<Texture>> AcquireTexturePixels(const SharedAsset<Texture>& texture) {
+  if (!texture->pixelsReleased) {
+    return {.value = texture, .error = {}};
+  }
+  if (texture->cooked.path.empty()) {
+    return {.value = std::nullopt, .error = "texture '" + texture->uri + "' was released with no cooked file to read it from"};
+  }
+  LoadResult<Texture> loaded = ReadCookedTexture(texture->cooked.path, texture->cooked.index);
+  if (!loaded.Ok()) {
+    return {.value = std::nullopt, .error = loaded.error};
+  }
+  const Texture& read = *loaded.value;
+  if (read.width != texture->width || read.height != texture->height || read.format != texture->format ||
+      read.mipLevels != texture->mipLevels || read.pixels.empty()) {
+    return {.value = std::nullopt, .error = texture->cooked.path + ": texture " + std::to_string(texture->cooked.index) + " no longer matches '" + texture->uri + "'"};
+  }
+  loaded.value->streaming = texture->streaming;
+  return {.value = SharedAsset<Texture>(std::move(*loaded.value)), .error = {}};
+}
+
+bool RehydrateScene(Scene& scene, std::string& error) {
+  // Slots sharing a released asset share the rehydrated one as well.
+  std::unordered_map<const Mesh*, SharedAsset<Mesh>> meshes;
+  for (SharedAsset<Mesh>& mesh : scene.meshes) {
+    if (!mesh->arraysReleased) {
+      continue;
+    }
+    if (const auto done = meshes.find(&*mesh); done != meshes.end()) {
+      mesh = done->second;
+      continue;
+    }
+    LoadResult<SharedAsset<Mesh>> loaded = AcquireMeshArrays(mesh);
+    if (!loaded.Ok()) {
+      error = loaded.error;
+      return false;
+    }
+    const Mesh* released = &*mesh;
+    Mesh& dst = mesh.Edit();
+    Mesh& src = loaded.value->Edit();
+    dst.vertices = std::move(src.vertices);
+    dst.indices = std::move(src.indices);
+    dst.packedVertices = std::move(src.packedVertices);
+    dst.arraysReleased = false;
+    meshes.emplace(released, mesh);
+  }
+  std::unordered_map<const Texture*, SharedAsset<Texture>> textures;
+  for (SharedAsset<Texture>& texture : scene.textures) {
+    if (!texture->pixelsReleased) {
+      continue;
+    }
+    if (const auto done = textures.find(&*texture); done != textures.end()) {
+      texture = done->second;
+      continue;
+    }
+    LoadResult<SharedAsset<Texture>> loaded = AcquireTexturePixels(texture);
+    if (!loaded.Ok()) {
+      error = loaded.error;
+      return false;
+    }
+    const Texture* released = &*texture;
+    Texture& dst = texture.Edit();
+    dst.pixels = std::move(loaded.value->Edit().pixels);
+    dst.pixelsReleased = false;
+    textures.emplace(released, texture);
+  }
+  return true;
+}
+
+}  // namespace vv
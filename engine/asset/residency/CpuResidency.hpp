@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "core/types/CommonTypes.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+// What happens to a scene's vertex, index and pixel arrays once the renderer has its own copies.
+enum class CpuResidency : uint8_t {
+  kKeep,                // everything stays in the scene
+  kReleaseAfterUpload,  // every array is dropped; what has no cooked file or texture source is gone
+  kReloadFromCooked,    // only arrays that can be read back (cooked file, texture source) are dropped
+};
+
+const char* CpuResidencyName(CpuResidency policy);
+
+struct CpuResidencyStats {
+  uint32_t meshesReleased = 0;
+  uint32_t texturesReleased = 0;
+  uint64_t releasedBytes = 0;  // vertex, index and pixel bytes dropped
+  uint32_t kept = 0;           // morphed meshes, assets other scenes hold, or nothing to reload from
+};
+
+// Applies `policy` to `scene` after it was uploaded. Meshes with morph targets stay resident (their
+// vertices are blended on the CPU every frame), as do assets some other scene still holds, since
+// dropping them here would free nothing. Textures with a source fall back to their lazy form;
+// the rest keep format and mip count so the pixels read back are uploaded as they were.
+CpuResidencyStats ApplyCpuResidency(Scene& scene, CpuResidency policy);
+
+// The asset with its arrays: the asset itself while they are resident (or, for textures, while
+// the source can decode them), else a copy read back from its cooked file that is not stored in
+// the scene. CPU consumers of released scenes (bounds, picking, re-uploads after a device loss)
+// go through these.
+LoadResult<SharedAsset<Mesh>> AcquireMeshArrays(const SharedAsset<Mesh>& mesh);
+LoadResult<SharedAsset<Texture>> AcquireTexturePixels(const SharedAsset<Texture>& texture);
+
+// Reads every released array back into the scene so it stays resident again.
+bool RehydrateScene(Scene& scene, std::string& error);
+
+}  // namespace vv
@@ -0,0 +1,799 @@
+#include "asset/texture/BlockCompression.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include "asset/texture/MipGenerator.hpp"
+#include "core/thread/ParallelFor.hpp"
+
+namespace vv {
+namespace {
+
+using BlockTexels = std::array<std::array<uint8_t, 4>, 16>;
+
+constexpr std::array<uint32_t, 16> kBc7Weights4 = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+int RefineIterations(CompressionQuality quality) {
+  switch (quality) {
+    case CompressionQuality::kFast:
+      return 0;
+    case CompressionQuality::kHigh:
+      return 4;
+    case CompressionQuality::kNormal:
+    default:
+      return 1;
+  }
+}
+
+uint32_t BlocksAcross(uint32_t size) {
+  return (size + 3) / 4;
+}
+
+void LoadBlock(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t bx, uint32_t by, BlockTexels& out) {
+  for (uint32_t y = 0; y < 4; ++y) {
+    const uint32_t sy = std::min(by * 4 + y, height - 1);
+    for (uint32_t x = 0; x < 4; ++x) {
+      const uint32_t sx = std::min(bx * 4 + x, width - 1);
+      std::memcpy(out[y * 4 + x].data(), rgba + (static_cast<size_t>(sy) * width + sx) * 4, 4);
+    }
+  }
+}
+
+void StoreBlock(const BlockTexels& block, uint32_t width, uint32_t height, uint32_t bx, uint32_t by, uint8_t* rgba) {
+  for (uint32_t y = 0; y < 4 && by * 4 + y < height; ++y) {
+    for (uint32_t x = 0; x < 4 && bx * 4 + x < width; ++x) {
+      std::memcpy(rgba + (static_cast<size_t>(by * 4 + y) * width + bx * 4 + x) * 4, block[y * 4 + x].data(), 4);
+    }
+  }
+}
+
+// ---- endpoint fitting shared by all encoders ----
+
+template <size_t N>
+using Vec = std::array<float, N>;
+
+template <size_t N>
+struct Endpoints {
+  Vec<N> e0{};
+  Vec<N> e1{};
+};
+
+template <size_t N>
+Endpoints<N> PrincipalEndpoints(const std::array<Vec<N>, 16>& px) {
+  Vec<N> mean{};
+  for (const Vec<N>& p : px) {
+    for (size_t c = 0; c < N; ++c) {
+      mean[c] += p[c] / 16.0F;
+    }
+  }
+
+  std::array<std::array<float, N>, N> cov{};
+  for (const Vec<N>& p : px) {
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < N; ++j) {
+        cov[i][j] += (p[i] - mean[i]) * (p[j] - mean[j]);
+      }
+    }
+  }
+
+  Vec<N> axis{};
+  for (size_t c = 0; c < N; ++c) {
+    axis[c] = 1.0F;
+  }
+  for (int iter = 0; iter < 8; ++iter) {
+    Vec<N> next{};
+    float len = 0.0F;
+    for (size_t i = 0; i < N; ++i) {
+      for (size_t j = 0; j < N; ++j) {
+        next[i] += cov[i][j] * axis[j];
+      }
+      len = std::max(len, std::fabs(next[i]));
+    }
+    if (len <= 1e-6F) {
+      break;
+    }
+    for (size_t i = 0; i < N; ++i) {
+      axis[i] = next[i] / len;
+    }
+  }
+
+  float norm = 0.0F;
+  for (const float a : axis) {
+    norm += a * a;
+  }
+  norm = std::sqrt(norm);
+  Endpoints<N> ep{mean, mean};
+  if (norm <= 1e-6F) {
+    return ep;
+  }
+  float tMin = 0.0F;
+  float tMax = 0.0F;
+  for (const Vec<N>& p : px) {
+    float t = 0.0F;
+    for (size_t c = 0; c < N; ++c) {
+      t += (p[c] - mean[c]) * axis[c] / norm;
+    }
+    tMin = std::min(tMin, t);
+    tMax = std::max(tMax, t);
+  }
+  for (size_t c = 0; c < N; ++c) {
+    ep.e0[c] = std::clamp(mean[c] + axis[c] / norm * tMin, 0.0F, 255.0F);
+    ep.e1[c] = std::clamp(mean[c] + axis[c] / norm * tMax, 0.0F, 255.0F);
+  }
+  return ep;
+}
+
+// Least-squares endpoints for fixed interpolation weights t (0 = e0, 1 = e1).
+template <size_t N>
+bool LeastSquaresEndpoints(const std::array<Vec<N>, 16>& px, const std::array<float, 16>& t, Endpoints<N>& ep) {
+  float a = 0.0F;
+  float b = 0.0F;
+  float c = 0.0F;
+  Vec<N> r0{};
+  Vec<N> r1{};
+  for (size_t i = 0; i < 16; ++i) {
+    const float s = 1.0F - t[i];
+    a += s * s;
+    b += s * t[i];
+    c += t[i] * t[i];
+    for (size_t k = 0; k < N; ++k) {
+      r0[k] += s * px[i][k];
+      r1[k] += t[i] * px[i][k];
+    }
+  }
+  const float det = a * c - b * b;
+  if (std::fabs(det) <= 1e-6F) {
+    return false;
+  }
+  for (size_t k = 0; k < N; ++k) {
+    ep.e0[k] = std::clamp((c * r0[k] - b * r1[k]) / det, 0.0F, 255.0F);
+    ep.e1[k] = std::clamp((a * r1[k] - b * r0[k]) / det, 0.0F, 255.0F);
+  }
+  return true;
+}
+
+template <size_t N>
+float Distance2(const Vec<N>& a, const Vec<N>& b) {
+  float d = 0.0F;
+  for (size_t c = 0; c < N; ++c) {
+    d += (a[c] - b[c]) * (a[c] - b[c]);
+  }
+  return d;
+}
+
+// ---- BC1 color block (4-color mode) ----
+
+uint16_t Pack565(const Vec<3>& c) {
+  const auto r = static_cast<uint16_t>(std::lround(c[0] * 31.0F / 255.0F));
+  const auto g = static_cast<uint16_t>(std::lround(c[1] * 63.0F / 255.0F));
+  const auto b = static_cast<uint16_t>(std::lround(c[2] * 31.0F / 255.0F));
+  return static_cast<uint16_t>((r << 11U) | (g << 5U) | b);
+}
+
+Vec<3> Unpack565(uint16_t v) {
+  const uint32_t r = (v >> 11U) & 31U;
+  const uint32_t g = (v >> 5U) & 63U;
+  const uint32_t b = v & 31U;
+  return {static_cast<float>((r << 3U) | (r >> 2U)), static_cast<float>((g << 2U) | (g >> 4U)),
+          static_cast<float>((b << 3U) | (b >> 2U))};
+}
+
+std::array<Vec<3>, 4> Bc1Palette(uint16_t c0, uint16_t c1, bool fourColor) {
+  const Vec<3> a = Unpack565(c0);
+  const Vec<3> b = Unpack565(c1);
+  std::array<Vec<3>, 4> p{a, b, Vec<3>{}, Vec<3>{}};
+  for (size_t k = 0; k < 3; ++k) {
+    if (fourColor) {
+      p[2][k] = std::floor((2.0F * a[k] + b[k]) / 3.0F);
+      p[3][k] = std::floor((a[k] + 2.0F * b[k]) / 3.0F);
+    } else {
+      p[2][k] = std::floor((a[k] + b[k]) / 2.0F);
+      p[3][k] = 0.0F;
+    }
+  }
+  return p;
+}
+
+void EncodeBc1Color(const BlockTexels& block, CompressionQuality quality, uint8_t* out) {
+  std::array<Vec<3>, 16> px{};
+  for (size_t i = 0; i < 16; ++i) {
+    px[i] = {static_cast<float>(block[i][0]), static_cast<float>(block[i][1]), static_cast<float>(block[i][2])};
+  }
+
+  constexpr std::array<float, 4> kT = {0.0F, 1.0F, 1.0F / 3.0F, 2.0F / 3.0F};
+  Endpoints<3> ep = PrincipalEndpoints(px);
+  float bestError = -1.0F;
+  uint16_t bestC0 = 0;
+  uint16_t bestC1 = 0;
+  uint32_t bestIndices = 0;
+
+  for (int iter = 0; iter <= RefineIterations(quality); ++iter) {
+    uint16_t c0 = Pack565(ep.e1);
+    uint16_t c1 = Pack565(ep.e0);
+    if (c0 < c1) {
+      std::swap(c0, c1);
+    }
+    const auto palette = Bc1Palette(c0, c1, true);
+    uint32_t indices = 0;
+    float error = 0.0F;
+    std::array<float, 16> t{};
+    for (size_t i = 0; i < 16; ++i) {
+      uint32_t best = 0;
+      float bestD = Distance2(px[i], palette[0]);
+      for (uint32_t k = 1; k < 4 && c0 != c1; ++k) {
+        const float d = Distance2(px[i], palette[k]);
+        if (d < bestD) {
+          bestD = d;
+          best = k;
+        }
+      }
+      indices |= best << (2 * i);
+      error += bestD;
+      t[i] = kT[best];
+    }
+    if (bestError < 0.0F || error < bestError) {
+      bestError = error;
+      bestC0 = c0;
+      bestC1 = c1;
+      bestIndices = indices;
+    }
+    // Fit in palette order: index 0 is c0 (t = 0), index 1 is c1 (t = 1).
+    const Vec<3> p0 = Unpack565(c0);
+    const Vec<3> p1 = Unpack565(c1);
+    ep = Endpoints<3>{p1, p0};
+    Endpoints<3> fitted{};
+    if (!LeastSquaresEndpoints(px, t, fitted)) {
+      break;
+    }
+    ep = Endpoints<3>{fitted.e1, fitted.e0};
+  }
+
+  out[0] = static_cast<uint8_t>(bestC0 & 0xFFU);
+  out[1] = static_cast<uint8_t>(bestC0 >> 8U);
+  out[2] = static_cast<uint8_t>(bestC1 & 0xFFU);
+  out[3] = static_cast<uint8_t>(bestC1 >> 8U);
+  for (size_t k = 0; k < 4; ++k) {
+    out[4 + k] = static_cast<uint8_t>((bestIndices >> (8 * k)) & 0xFFU);
+  }
+}
+
+void DecodeBc1Color(const uint8_t* in, bool forceFourColor, BlockTexels& block) {
+  const auto c0 = static_cast<uint16_t>(in[0] | (in[1] << 8U));
+  const auto c1 = static_cast<uint16_t>(in[2] | (in[3] << 8U));
+  const bool fourColor = forceFourColor || c0 > c1;
+  const auto palette = Bc1Palette(c0, c1, fourColor);
+  const uint32_t indices = static_cast<uint32_t>(in[4]) | (static_cast<uint32_t>(in[5]) << 8U) |
+                           (static_cast<uint32_t>(in[6]) << 16U) | (static_cast<uint32_t>(in[7]) << 24U);
+  for (size_t i = 0; i < 16; ++i) {
+    const uint32_t idx = (indices >> (2 * i)) & 3U;
+    for (size_t k = 0; k < 3; ++k) {
+      block[i][k] = static_cast<uint8_t>(palette[idx][k]);
+    }
+    block[i][3] = (!fourColor && idx == 3) ? 0 : 255;
+  }
+}
+
+// ---- BC4 single channel (8-value mode) ----
+
+std::array<float, 8> Bc4Palette(uint8_t e0, uint8_t e1) {
+  std::array<float, 8> p{static_cast<float>(e0), static_cast<float>(e1)};
+  if (e0 > e1) {
+    for (uint32_t k = 2; k < 8; ++k) {
+      p[k] = std::floor((static_cast<float>(8 - k) * e0 + static_cast<float>(k - 1) * e1) / 7.0F);
+    }
+  } else {
+    for (uint32_t k = 2; k < 6; ++k) {
+      p[k] = std::floor((static_cast<float>(6 - k) * e0 + static_cast<float>(k - 1) * e1) / 5.0F);
+    }
+    p[6] = 0.0F;
+    p[7] = 255.0F;
+  }
+  return p;
+}
+
+void EncodeBc4(const std::array<uint8_t, 16>& values, CompressionQuality quality, uint8_t* out) {
+  std::array<Vec<1>, 16> px{};
+  uint8_t lo = 255;
+  uint8_t hi = 0;
+  for (size_t i = 0; i < 16; ++i) {
+    px[i] = {static_cast<float>(values[i])};
+    lo = std::min(lo, values[i]);
+    hi = std::max(hi, values[i]);
+  }
+
+  Endpoints<1> ep{{static_cast<float>(lo)}, {static_cast<float>(hi)}};
+  float bestError = -1.0F;
+  uint8_t bestE0 = hi;
+  uint8_t bestE1 = lo;
+  uint64_t bestIndices = 0;
+
+  for (int iter = 0; iter <= RefineIterations(quality); ++iter) {
+    uint8_t e0 = static_cast<uint8_t>(std::lround(ep.e1[0]));
+    uint8_t e1 = static_cast<uint8_t>(std::lround(ep.e0[0]));
+    if (e0 < e1) {
+      std::swap(e0, e1);
+    }
+    const auto palette = Bc4Palette(e0, e1);
+    const uint32_t paletteSize = e0 > e1 ? 8 : 1;
+    uint64_t indices = 0;
+    float error = 0.0F;
+    std::array<float, 16> t{};
+    for (size_t i = 0; i < 16; ++i) {
+      uint32_t best = 0;
+      float bestD = std::fabs(px[i][0] - palette[0]);
+      for (uint32_t k = 1; k < paletteSize; ++k) {
+        const float d = std::fabs(px[i][0] - palette[k]);
+        if (d < bestD) {
+          bestD = d;
+          best = k;
+        }
+      }
+      indices |= static_cast<uint64_t>(best) << (3 * i);
+      error += bestD * bestD;
+      t[i] = best == 0 ? 0.0F : (best == 1 ? 1.0F : static_cast<float>(best - 1) / 7.0F);
+    }
+    if (bestError < 0.0F || error < bestError) {
+      bestError = error;
+      bestE0 = e0;
+      bestE1 = e1;
+      bestIndices = indices;
+    }
+    Endpoints<1> fitted{};
+    if (e0 == e1 || !LeastSquaresEndpoints(px, t, fitted)) {
+      break;
+    }
+    ep = Endpoints<1>{fitted.e1, fitted.e0};
+  }
+
+  out[0] = bestE0;
+  out[1] = bestE1;
+  for (size_t k = 0; k < 6; ++k) {
+    out[2 + k] = static_cast<uint8_t>((bestIndices >> (8 * k)) & 0xFFU);
+  }
+}
+
+void DecodeBc4(const uint8_t* in, std::array<uint8_t, 16>& values) {
+  const auto palette = Bc4Palette(in[0], in[1]);
+  uint64_t indices = 0;
+  for (size_t k = 0; k < 6; ++k) {
+    indices |= static_cast<uint64_t>(in[2 + k]) << (8 * k);
+  }
+  for (size_t i = 0; i < 16; ++i) {
+    values[i] = static_cast<uint8_t>(palette[(indices >> (3 * i)) & 7U]);
+  }
+}
+
+std::array<uint8_t, 16> Channel(const BlockTexels& block, size_t channel) {
+  std::array<uint8_t, 16> out{};
+  for (size_t i = 0; i < 16; ++i) {
+    out[i] = block[i][channel];
+  }
+  return out;
+}
+
+// ---- BC7 mode 6: one subset, RGBA 7.7.7.7 + unique p-bit, 4-bit indices ----
+
+class BitWriter {
+ public:
+  explicit BitWriter(uint8_t* out) : out_(out) { std::memset(out_, 0, 16); }
+  void Put(uint32_t value, uint32_t bits) {
+    for (uint32_t b = 0; b < bits; ++b, ++pos_) {
+      if ((value >> b) & 1U) {
+        out_[pos_ / 8] = static_cast<uint8_t>(out_[pos_ / 8] | (1U << (pos_ % 8)));
+      }
+    }
+  }
+
+ private:
+  uint8_t* out_;
+  uint32_t pos_ = 0;
+};
+
+class BitReader {
+ public:
+  explicit BitReader(const uint8_t* in) : in_(in) {}
+  uint32_t Get(uint32_t bits) {
+    uint32_t value = 0;
+    for (uint32_t b = 0; b < bits; ++b, ++pos_) {
+      value |= static_cast<uint32_t>((in_[pos_ / 8] >> (pos_ % 8)) & 1U) << b;
+    }
+    return value;
+  }
+
+ private:
+  const uint8_t* in_;
+  uint32_t pos_ = 0;
+};
+
+struct Bc7Endpoint {
+  std::array<uint32_t, 4> c7{};
+  uint32_t p = 0;
+};
+
+Vec<4> Bc7Expand(const Bc7Endpoint& e) {
+  Vec<4> v{};
+  for (size_t c = 0; c < 4; ++c) {
+    v[c] = static_cast<float>((e.c7[c] << 1U) | e.p);
+  }
+  return v;
+}
+
+Bc7Endpoint Bc7Quantize(const Vec<4>& v, uint32_t p) {
+  Bc7Endpoint e;
+  e.p = p;
+  for (size_t c = 0; c < 4; ++c) {
+    e.c7[c] = static_cast<uint32_t>(std::clamp(std::lround((v[c] - static_cast<float>(p)) / 2.0F), 0L, 127L));
+  }
+  return e;
+}
+
+std::array<Vec<4>, 16> Bc7Palette(const Bc7Endpoint& a, const Bc7Endpoint& b) {
+  const Vec<4> e0 = Bc7Expand(a);
+  const Vec<4> e1 = Bc7Expand(b);
+  std::array<Vec<4>, 16> p{};
+  for (size_t k = 0; k < 16; ++k) {
+    for (size_t c = 0; c < 4; ++c) {
+      p[k][c] = static_cast<float>(((64 - kBc7Weights4[k]) * static_cast<uint32_t>(e0[c]) +
+                                    kBc7Weights4[k] * static_cast<uint32_t>(e1[c]) + 32) >> 6U);
+    }
+  }
+  return p;
+}
+
+float Bc7AssignIndices(const std::array<Vec<4>, 16>& px,
+                       const Bc7Endpoint& a,
+                       const Bc7Endpoint& b,
+                       std::array<uint32_t, 16>& indices) {
+  const auto palette = Bc7Palette(a, b);
+  float error = 0.0F;
+  for (size_t i = 0; i < 16; ++i) {
+    uint32_t best = 0;
+    float bestD = Distance2(px[i], palette[0]);
+    for (uint32_t k = 1; k < 16; ++k) {
+      const float d = Distance2(px[i], palette[k]);
+      if (d < bestD) {
+        bestD = d;
+        best = k;
+      }
+    }
+    indices[i] = best;
+    error += bestD;
+  }
+  return error;
+}
+
+void EncodeBc7Mode6(const BlockTexels& block, CompressionQuality quality, uint8_t* out) {
+  std::array<Vec<4>, 16> px{};
+  for (size_t i = 0; i < 16; ++i) {
+    for (size_t c = 0; c < 4; ++c) {
+      px[i][c] = static_cast<float>(block[i][c]);
+    }
+  }
+
+  Endpoints<4> ep = PrincipalEndpoints(px);
+  float bestError = -1.0F;
+  Bc7Endpoint bestA;
+  Bc7Endpoint bestB;
+  std::array<uint32_t, 16> bestIndices{};
+
+  for (int iter = 0; iter <= RefineIterations(quality); ++iter) {
+    // Lower quality levels use p = 0 for the first endpoint and p = 1 for the second.
+    const bool exhaustive = quality == CompressionQuality::kHigh;
+    for (uint32_t pa = 0; pa < 2; ++pa) {
+      for (uint32_t pb = 0; pb < 2; ++pb) {
+        if (!exhaustive && (pa != 0 || pb != 1)) {
+          continue;
+        }
+        const Bc7Endpoint a = Bc7Quantize(ep.e0, pa);
+        const Bc7Endpoint b = Bc7Quantize(ep.e1, pb);
+        std::array<uint32_t, 16> indices{};
+        const float error = Bc7AssignIndices(px, a, b, indices);
+        if (bestError < 0.0F || error < bestError) {
+          bestError = error;
+          bestA = a;
+          bestB = b;
+          bestIndices = indices;
+        }
+      }
+      if (!exhaustive) {
+        break;
+      }
+    }
+
+    std::array<float, 16> t{};
+    for (size_t i = 0; i < 16; ++i) {
+      t[i] = static_cast<float>(kBc7Weights4[bestIndices[i]]) / 64.0F;
+    }
+    if (!LeastSquaresEndpoints(px, t, ep)) {
+      break;
+    }
+  }
+
+  // The anchor (texel 0) index is stored with 3 bits, so its top bit must be clear.
+  if (bestIndices[0] >= 8) {
+    std::swap(bestA, bestB);
+    for (uint32_t& idx : bestIndices) {
+      idx = 15 - idx;
+    }
+  }
+
+  BitWriter bits(out);
+  bits.Put(1U << 6U, 7);
+  for (size_t c = 0; c < 4; ++c) {
+    bits.Put(bestA.c7[c], 7);
+    bits.Put(bestB.c7[c], 7);
+  }
+  bits.Put(bestA.p, 1);
+  bits.Put(bestB.p, 1);
+  bits.Put(bestIndices[0], 3);
+  for (size_t i = 1; i < 16; ++i) {
+    bits.Put(bestIndices[i], 4);
+  }
+}
+
+bool DecodeBc7(const uint8_t* in, BlockTexels& block) {
+  if ((in[0] & 0x7FU) != (1U << 6U)) {
+    return false;
+  }
+  BitReader bits(in);
+  bits.Get(7);
+  Bc7Endpoint a;
+  Bc7Endpoint b;
+  for (size_t c = 0; c < 4; ++c) {
+    a.c7[c] = bits.Get(7);
+    b.c7[c] = bits.Get(7);
+  }
+  a.p = bits.Get(1);
+  b.p = bits.Get(1);
+  const auto palette = Bc7Palette(a, b);
+  for (size_t i = 0; i < 16; ++i) {
+    const uint32_t idx = bits.Get(i == 0 ? 3 : 4);
+    for (size_t c = 0; c < 4; ++c) {
+      block[i][c] = static_cast<uint8_t>(palette[idx][c]);
+    }
+  }
+  return true;
+}
+
+// ---- per-format block dispatch ----
+
+void EncodeBlock(PixelFormat format, const BlockTexels& block, CompressionQuality quality, uint8_t* out) {
+  switch (format) {
+    case PixelFormat::kBC1:
+      EncodeBc1Color(block, quality, out);
+      break;
+    case PixelFormat::kBC3:
+      EncodeBc4(Channel(block, 3), quality, out);
+      EncodeBc1Color(block, quality, out + 8);
+      break;
+    case PixelFormat::kBC4:
+      EncodeBc4(Channel(block, 0), quality, out);
+      break;
+    case PixelFormat::kBC5:
+      EncodeBc4(Channel(block, 0), quality, out);
+      EncodeBc4(Channel(block, 1), quality, out + 8);
+      break;
+    case PixelFormat::kBC7:
+    default:
+      EncodeBc7Mode6(block, quality, out);
+      break;
+  }
+}
+
+bool DecodeBlock(PixelFormat format, const uint8_t* in, BlockTexels& block) {
+  std::array<uint8_t, 16> r{};
+  std::array<uint8_t, 16> g{};
+  switch (format) {
+    case PixelFormat::kBC1:
+      DecodeBc1Color(in, false, block);
+      return true;
+    case PixelFormat::kBC3:
+      DecodeBc1Color(in + 8, true, block);
+      DecodeBc4(in, r);
+      for (size_t i = 0; i < 16; ++i) {
+        block[i][3] = r[i];
+      }
+      return true;
+    case PixelFormat::kBC4:
+      DecodeBc4(in, r);
+      for (size_t i = 0; i < 16; ++i) {
+        block[i] = {r[i], r[i], r[i], 255};
+      }
+      return true;
+    case PixelFormat::kBC5:
+      DecodeBc4(in, r);
+      DecodeBc4(in + 8, g);
+      for (size_t i = 0; i < 16; ++i) {
+        const float x = static_cast<float>(r[i]) / 127.5F - 1.0F;
+        const float y = static_cast<float>(g[i]) / 127.5F - 1.0F;
+        const float z = std::sqrt(std::max(0.0F, 1.0F - x * x - y * y));
+        block[i] = {r[i], g[i], static_cast<uint8_t>(std::lround(z * 127.5F + 127.5F)), 255};
+      }
+      return true;
+    case PixelFormat::kBC7:
+      return DecodeBc7(in, block);
+    default:
+      return false;
+  }
+}
+
+uint32_t ComparedChannels(PixelFormat format) {
+  switch (format) {
+    case PixelFormat::kBC4:
+      return 1;
+    case PixelFormat::kBC5:
+      return 2;
+    case PixelFormat::kBC1:
+      return 3;
+    default:
+      return 4;
+  }
+}
+
+}  // namespace
+
+bool IsBlockCompressed(PixelFormat format) {
+  return BlockBytes(format) != 0;
+}
+
+uint32_t BlockBytes(PixelFormat format) {
+  switch (format) {
+    case PixelFormat::kBC1:
+    case PixelFormat::kBC4:
+      return 8;
+    case PixelFormat::kBC3:
+    case PixelFormat::kBC5:
+    case PixelFormat::kBC7:
+      return 16;
+    default:
+      return 0;
+  }
+}
+
+size_t TextureLevelOffset(PixelFormat format, uint32_t width, uint32_t height, uint32_t level) {
+  const uint32_t blockBytes = BlockBytes(format);
+  if (blockBytes == 0) {
+    return MipLevelOffset(width, height, level);
+  }
+  size_t offset = 0;
+  for (uint32_t l = 0; l < level; ++l) {
+    offset += static_cast<size_t>(BlocksAcross(MipDimension(width, l))) * BlocksAcross(MipDimension(height, l)) * blockBytes;
+  }
+  return offset;
+}
+
+PixelFormat ChooseBlockFormat(const Texture& texture, const TextureCompressionOptions& options) {
+  if (texture.normalMap) {
+    return PixelFormat::kBC5;
+  }
+
+  bool opaque = true;
+  bool gray = true;
+  const size_t texels = static_cast<size_t>(texture.width) * texture.height;
+  for (size_t i = 0; i < texels && (opaque || gray); ++i) {
+    const uint8_t* p = &texture.pixels[i * 4];
+    opaque = opaque && p[3] == 255;
+    gray = gray && p[0] == p[1] && p[1] == p[2];
+  }
+  if (gray && opaque && !texture.srgb) {
+    return PixelFormat::kBC4;
+  }
+  if (options.allowBc7) {
+    return PixelFormat::kBC7;
+  }
+  return opaque ? PixelFormat::kBC1 : PixelFormat::kBC3;
+}
+
+bool CompressTexture(Texture& texture, const TextureCompressionOptions& options, TextureCompressionReport* report) {
+  const uint32_t levels = std::max(texture.mipLevels, 1U);
+  if (IsBlockCompressed(texture.format) || texture.width == 0 || texture.height == 0 ||
+      texture.pixels.size() < MipLevelOffset(texture.width, texture.height, levels)) {
+    return false;
+  }
+
+  const PixelFormat format = ChooseBlockFormat(texture, options);
+  const uint32_t blockBytes = BlockBytes(format);
+  PixelBuffer blocks(TextureLevelOffset(format, texture.width, texture.height, levels));
+
+  for (uint32_t level = 0; level < levels; ++level) {
+    const uint32_t w = MipDimension(texture.width, level);
+    const uint32_t h = MipDimension(texture.height, level);
+    const uint8_t* src = texture.pixels.data() + MipLevelOffset(texture.width, texture.height, level);
+    uint8_t* dst = blocks.data() + TextureLevelOffset(format, texture.width, texture.height, level);
+    const uint32_t bw = BlocksAcross(w);
+    ParallelFor(BlocksAcross(h), 4, [&](size_t begin, size_t end) {
+      BlockTexels block{};
+      for (size_t by = begin; by < end; ++by) {
+        for (uint32_t bx = 0; bx < bw; ++bx) {
+          LoadBlock(src, w, h, bx, static_cast<uint32_t>(by), block);
+          EncodeBlock(format, block, options.quality, dst + (by * bw + bx) * blockBytes);
+        }
+      }
+    });
+  }
+
+  if (report != nullptr) {
+    report->format = format;
+    report->sourceBytes = texture.pixels.size();
+    report->compressedBytes = blocks.size();
+
+    // PSNR of level 0 over the channels the format keeps.
+    const uint32_t channels = ComparedChannels(format);
+    const uint32_t bw = BlocksAcross(texture.width);
+    double squared = 0.0;
+    BlockTexels decoded{};
+    for (uint32_t by = 0; by < BlocksAcross(texture.height); ++by) {
+      for (uint32_t bx = 0; bx < bw; ++bx) {
+        DecodeBlock(format, blocks.data() + (static_cast<size_t>(by) * bw + bx) * blockBytes, decoded);
+        for (uint32_t y = 0; y < 4 && by * 4 + y < texture.height; ++y) {
+          for (uint32_t x = 0; x < 4 && bx * 4 + x < texture.width; ++x) {
+            const uint8_t* ref = &texture.pixels[(static_cast<size_t>(by * 4 + y) * texture.width + bx * 4 + x) * 4];
+            for (uint32_t c = 0; c < channels; ++c) {
+              const double d = static_cast<double>(ref[c]) - static_cast<double>(decoded[y * 4 + x][c]);
+              squared += d * d;
+            }
+          }
+        }
+      }
+    }
+    const double mse = squared / (static_cast<double>(texture.width) * texture.height * channels);
+    report->psnrDb = mse <= 1e-12 ? 99.0F : static_cast<float>(10.0 * std::log10(255.0 * 255.0 / mse));
+  }
+
+  texture.format = format;
+  texture.mipLevels = levels;
+  texture.pixels = std::move(blocks);
+  return true;
+}
+
+bool DecompressTexture(const Texture& source, Texture& out) {
+  if (!IsBlockCompressed(source.format)) {
+    return false;
+  }
+  const uint32_t levels = std::max(source.mipLevels, 1U);
+  const uint32_t blockBytes = BlockBytes(source.format);
+  if (source.pixels.size() < TextureLevelOffset(source.format, source.width, source.height, levels)) {
+    return false;
+  }
+
+  PixelBuffer rgba(MipLevelOffset(source.width, source.height, levels));
+  bool ok = true;
+  for (uint32_t level = 0; level < levels && ok; ++level) {
+    const uint32_t w = MipDimension(source.width, level);
+    const uint32_t h = MipDimension(source.height, level);
+    const uint8_t* src = source.pixels.data() + TextureLevelOffset(source.format, source.width, source.height, level);
+    uint8_t* dst = rgba.data() + MipLevelOffset(source.width, source.height, level);
+    const uint32_t bw = BlocksAcross(w);
+    for (uint32_t by = 0; by < BlocksAcross(h) && ok; ++by) {
+      for (uint32_t bx = 0; bx < bw && ok; ++bx) {
+        BlockTexels block{};
+        ok = DecodeBlock(source.format, src + (static_cast<size_t>(by) * bw + bx) * blockBytes, block);
+        StoreBlock(block, w, h, bx, by, dst);
+      }
+    }
+  }
+  if (!ok) {
+    return false;
+  }
+
+  if (&out != &source) {
+    out.uri = source.uri;
+    out.width = source.width;
+    out.height = source.height;
+    out.srgb = source.srgb;
+    out.normalMap = source.normalMap;
+    out.contentHash = source.contentHash;
+  }
+  out.mipLevels = levels;
+  out.format = source.srgb ? PixelFormat::kR8G8B8A8_SRGB : PixelFormat::kR8G8B8A8;
+  out.pixels = std::move(rgba);
+  return true;
+}
+
+bool DecompressTexture(Texture& texture) {
+  return DecompressTexture(texture, texture);
+}
+
+}  // namespace vv
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+enum class CompressionQuality {
+  kFast,    // principal-axis endpoints only
+  kNormal,  // + one least-squares refinement
+  kHigh,    // + several refinements and exhaustive BC7 p-bit search
+};
+
+struct TextureCompressionOptions {
+  CompressionQuality quality = CompressionQuality::kNormal;
+  bool allowBc7 = true;  // otherwise color uses BC1 (opaque) / BC3 (alpha)
+};
+
+struct TextureCompressionReport {
+  PixelFormat format = PixelFormat::kUnknown;
+  uint64_t sourceBytes = 0;
+  uint64_t compressedBytes = 0;
+  float psnrDb = 0.0F;  // level 0, over the channels the format keeps
+};
+
+bool IsBlockCompressed(PixelFormat format);
+uint32_t BlockBytes(PixelFormat format);  // 8 or 16; 0 for uncompressed formats
+
+// Byte offset of `level` inside a mip chain stored back to back; works for RGBA8 and BC formats.
+size_t TextureLevelOffset(PixelFormat format, uint32_t width, uint32_t height, uint32_t level);
+
+// BC5 for normal maps, BC4 for opaque linear grayscale (AO/roughness/metallic masks),
+// BC7 for everything else (BC1/BC3 when BC7 is not allowed).
+PixelFormat ChooseBlockFormat(const Texture& texture, const TextureCompressionOptions& options);
+
+// Encodes every mip level of an RGBA8 texture in place; block rows run across worker threads.
+bool CompressTexture(Texture& texture, const TextureCompressionOptions& options, TextureCompressionReport* report = nullptr);
+
+// Expands a block-compressed texture back to RGBA8 (BC4 -> RRR1, BC5 -> RG with reconstructed z).
+// Only BC7 mode 6, which the encoder emits, is decoded; other modes fail.
+bool DecompressTexture(Texture& texture);
+// Same, writing into `out` without copying the compressed payload first.
+bool DecompressTexture(const Texture& source, Texture& out);
+
+}  // namespace vv
@@ -1,25 +1,28 @@
 #include "asset/texture/ImageLoader.hpp"
 
+#include <cstdlib>
+
+// PixelBuffer::Adopt frees with std::free, so stb must allocate with the matching functions.
+#define STBI_MALLOC(size) std::malloc(size)
+#define STBI_REALLOC(ptr, size) std::realloc(ptr, size)
+#define STBI_FREE(ptr) std::free(ptr)
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
-#include <cstring>
-
 namespace vv {
 
 namespace {
 
-std::optional<ImageRgba8> CopyDecodedImage(stbi_uc* data, int width, int height) {
+std::optional<ImageRgba8> AdoptDecodedImage(stbi_uc* data, int width, int height) {
   if (data == nullptr || width <= 0 || height <= 0) {
+    stbi_image_free(data);
     return std::nullopt;
   }
 
   ImageRgba8 out;
   out.width = static_cast<uint32_t>(width);
   out.height = static_cast<uint32_t>(height);
-  out.pixels.resize(static_cast<size_t>(width) * static_cast<size_t>(height) * 4);
-  std::memcpy(out.pixels.data(), data, out.pixels.size());
-  stbi_image_free(data);
+  out.pixels = PixelBuffer::Adopt(data, static_cast<size_t>(width) * static_cast<size_t>(height) * 4);
   return out;
 }
 
@@ -31,7 +34,7 @@ std::optional<ImageRgba8> LoadImageRgba8(const std::string& absolutePath) {
   int channels = 0;
 
   stbi_uc* data = stbi_load(absolutePath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
-  return CopyDecodedImage(data, width, height);
+  return AdoptDecodedImage(data, width, height);
 }
 
 std::optional<ImageRgba8> LoadImageRgba8FromMemory(const uint8_t* bytes, size_t sizeBytes) {
@@ -48,7 +51,37 @@ std::optional<ImageRgba8> LoadImageRgba8FromMemory(const uint8_t* bytes, size_t
                                         &height,
                                         &channels,
                                         STBI_rgb_alpha);
-  return CopyDecodedImage(data, width, height);
+  return AdoptDecodedImage(data, width, height);
+}
+
+std::optional<ImageInfo> ReadImageInfoFromMemory(const uint8_t* bytes, size_t sizeBytes) {
+  if (bytes == nullptr || sizeBytes == 0) {
+    return std::nullopt;
+  }
+
+  int width = 0;
+  int height = 0;
+  int channels = 0;
+  if (stbi_info_from_memory(bytes, static_cast<int>(sizeBytes), &width, &height, &channels) == 0 || width <= 0 ||
+      height <= 0) {
+    return std::nullopt;
+  }
+  return ImageInfo{static_cast<uint32_t>(width), static_cast<uint32_t>(height)};
+}
+
+ImageRgba8 ConvertBgra8(const uint8_t* texels, uint32_t width, uint32_t height) {
+  ImageRgba8 out;
+  out.width = width;
+  out.height = height;
+  const size_t pixelCount = static_cast<size_t>(width) * static_cast<size_t>(height);
+  out.pixels.resize(pixelCount * 4);
+  for (size_t i = 0; i < pixelCount; ++i) {
+    out.pixels[i * 4 + 0] = texels[i * 4 + 2];
+    out.pixels[i * 4 + 1] = texels[i * 4 + 1];
+    out.pixels[i * 4 + 2] = texels[i * 4 + 0];
+    out.pixels[i * 4 + 3] = texels[i * 4 + 3];
+  }
+  return out;
 }
 
 }  // namespace vv
@@ -3,17 +3,28 @@
 #include <cstdint>
 #include <optional>
 #include <string>
-#include <vector>
+
+#include "core/memory/PixelBuffer.hpp"
 
 namespace vv {
 
+// `pixels` adopts the decoder's buffer, so a decode costs no copy; move it into Texture::pixels.
 struct ImageRgba8 {
   uint32_t width = 0;
   uint32_t height = 0;
-  std::vector<uint8_t> pixels;
+  PixelBuffer pixels;
+};
+
+struct ImageInfo {
+  uint32_t width = 0;
+  uint32_t height = 0;
 };
 
 std::optional<ImageRgba8> LoadImageRgba8(const std::string& absolutePath);
 std::optional<ImageRgba8> LoadImageRgba8FromMemory(const uint8_t* bytes, size_t sizeBytes);
+std::optional<ImageInfo> ReadImageInfoFromMemory(const uint8_t* bytes, size_t sizeBytes);  // header only
+
+// Expands tightly packed BGRA8 texels (uncompressed embedded textures) to RGBA8.
+ImageRgba8 ConvertBgra8(const uint8_t* texels, uint32_t width, uint32_t height);
 
 }  // namespace vv
@@ -0,0 +1,367 @@
+#include "asset/texture/Ktx2.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+#include "asset/texture/BlockCompression.hpp"
+#include "asset/texture/MipGenerator.hpp"
+#include "core/io/Inflate.hpp"
+
+namespace vv {
+namespace {
+
+constexpr std::array<uint8_t, 12> kIdentifier = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+constexpr size_t kHeaderBytes = 80;  // identifier, nine uint32 fields, then the data format / key-value / global indices
+constexpr size_t kLevelIndexBytes = 24;
+constexpr uint32_t kBlockCompressedDims = 3;  // 4x4 texel blocks, stored as size - 1
+
+uint64_t ProcessId() {
+#if defined(__unix__) || defined(__APPLE__)
+  return static_cast<uint64_t>(getpid());
+#else
+  return 0;
+#endif
+}
+
+struct Sample {
+  uint16_t bitOffset = 0;
+  uint8_t bitLength = 0;
+  uint8_t channel = 0;  // 15 is alpha in every color model used here
+};
+
+// Basic data format descriptor contents for each vkFormat the engine reads and writes, following
+// what the KTX reference tools emit.
+struct FormatEntry {
+  uint32_t vkFormat = 0;
+  PixelFormat format = PixelFormat::kUnknown;
+  bool srgb = false;
+  uint8_t colorModel = 0;
+  uint8_t blockDims = 0;
+  uint8_t bytesPlane0 = 0;
+  std::array<Sample, 4> samples;
+  uint8_t sampleCount = 0;
+};
+
+constexpr std::array<Sample, 4> kRgbaSamples = {{{0, 8, 0}, {8, 8, 1}, {16, 8, 2}, {24, 8, 15}}};
+
+constexpr std::array<FormatEntry, 10> kFormats = {{
+    {37, PixelFormat::kR8G8B8A8, false, 1, 0, 4, kRgbaSamples, 4},
+    {43, PixelFormat::kR8G8B8A8_SRGB, true, 1, 0, 4, kRgbaSamples, 4},
+    {133, PixelFormat::kBC1, false, 128, kBlockCompressedDims, 8, {{{0, 64, 1}}}, 1},
+    {134, PixelFormat::kBC1, true, 128, kBlockCompressedDims, 8, {{{0, 64, 1}}}, 1},
+    {137, PixelFormat::kBC3, false, 130, kBlockCompressedDims, 16, {{{0, 64, 15}, {64, 64, 0}}}, 2},
+    {138, PixelFormat::kBC3, true, 130, kBlockCompressedDims, 16, {{{0, 64, 15}, {64, 64, 0}}}, 2},
+    {139, PixelFormat::kBC4, false, 131, kBlockCompressedDims, 8, {{{0, 64, 0}}}, 1},
+    {141, PixelFormat::kBC5, false, 132, kBlockCompressedDims, 16, {{{0, 64, 0}, {64, 64, 1}}}, 2},
+    {145, PixelFormat::kBC7, false, 134, kBlockCompressedDims, 16, {{{0, 128, 0}}}, 1},
+    {146, PixelFormat::kBC7, true, 134, kBlockCompressedDims, 16, {{{0, 128, 0}}}, 1},
+}};
+
+const FormatEntry* FindVkFormat(uint32_t vkFormat) {
+  for (const FormatEntry& entry : kFormats) {
+    if (entry.vkFormat == vkFormat) {
+      return &entry;
+    }
+  }
+  return nullptr;
+}
+
+// RGBA8 carries sRGB in its format; block formats in Texture::srgb (BC4/BC5 have no sRGB form).
+const FormatEntry* FindTextureFormat(const Texture& texture) {
+  const bool srgb = IsBlockCompressed(texture.format) ? texture.srgb : texture.format == PixelFormat::kR8G8B8A8_SRGB;
+  const FormatEntry* fallback = nullptr;
+  for (const FormatEntry& entry : kFormats) {
+    if (entry.format == texture.format && entry.srgb == srgb) {
+      return &entry;
+    }
+    if (entry.format == texture.format && fallback == nullptr) {
+      fallback = &entry;
+    }
+  }
+  return fallback;
+}
+
+uint32_t Read32(const uint8_t* p) {
+  uint32_t value = 0;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+uint64_t Read64(const uint8_t* p) {
+  uint64_t value = 0;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+void Put32(std::vector<uint8_t>& out, size_t at, uint32_t value) {
+  std::memcpy(out.data() + at, &value, sizeof(value));
+}
+
+void Put64(std::vector<uint8_t>& out, size_t at, uint64_t value) {
+  std::memcpy(out.data() + at, &value, sizeof(value));
+}
+
+void Append32(std::vector<uint8_t>& out, uint32_t value) {
+  out.resize(out.size() + sizeof(value));
+  Put32(out, out.size() - sizeof(value), value);
+}
+
+size_t LevelBytes(PixelFormat format, uint32_t width, uint32_t height, uint32_t level) {
+  return TextureLevelOffset(format, width, height, level + 1) - TextureLevelOffset(format, width, height, level);
+}
+
+std::vector<uint8_t> BuildDataFormatDescriptor(const FormatEntry& entry) {
+  constexpr uint32_t kVersion = 2;
+  constexpr uint32_t kPrimariesBt709 = 1;
+  constexpr uint32_t kTransferLinear = 1;
+  constexpr uint32_t kTransferSrgb = 2;
+  constexpr uint32_t kQualifierLinear = 0x10;  // alpha stays linear in sRGB formats
+  const uint32_t blockSize = 24 + 16 * uint32_t{entry.sampleCount};
+  std::vector<uint8_t> dfd;
+  Append32(dfd, 4 + blockSize);
+  Append32(dfd, 0);  // Khronos vendor, basic descriptor type
+  Append32(dfd, kVersion | (blockSize << 16));
+  Append32(dfd, entry.colorModel | (kPrimariesBt709 << 8) | ((entry.srgb ? kTransferSrgb : kTransferLinear) << 16));
+  Append32(dfd, entry.blockDims | (uint32_t{entry.blockDims} << 8));
+  Append32(dfd, entry.bytesPlane0);
+  Append32(dfd, 0);
+  for (uint8_t s = 0; s < entry.sampleCount; ++s) {
+    const Sample& sample = entry.samples[s];
+    const uint32_t qualifiers = entry.srgb && sample.channel == 15 ? kQualifierLinear : 0;
+    Append32(dfd, sample.bitOffset | (uint32_t{sample.bitLength - 1U} << 16) | ((sample.channel | qualifiers) << 24));
+    Append32(dfd, 0);  // sample position
+    Append32(dfd, 0);  // lower
+    Append32(dfd, sample.bitLength == 8 ? 255U : UINT32_MAX);
+  }
+  return dfd;
+}
+
+std::vector<uint8_t> BuildKeyValueData() {
+  constexpr char kKey[] = "KTXwriter";
+  constexpr char kValue[] = "VividVision vv_cook";
+  std::vector<uint8_t> kvd;
+  Append32(kvd, static_cast<uint32_t>(sizeof(kKey) + sizeof(kValue)));  // both NUL-terminated
+  kvd.insert(kvd.end(), kKey, kKey + sizeof(kKey));
+  kvd.insert(kvd.end(), kValue, kValue + sizeof(kValue));
+  kvd.resize((kvd.size() + 3) & ~size_t{3});
+  return kvd;
+}
+
+}  // namespace
+
+bool IsKtx2(const uint8_t* bytes, size_t size) {
+  return bytes != nullptr && size >= kIdentifier.size() && std::memcmp(bytes, kIdentifier.data(), kIdentifier.size()) == 0;
+}
+
+std::optional<Ktx2Info> ReadKtx2Info(const uint8_t* bytes, size_t size) {
+  if (size < kHeaderBytes || !IsKtx2(bytes, size)) {
+    return std::nullopt;
+  }
+  const FormatEntry* entry = FindVkFormat(Read32(bytes + 12));
+  const uint32_t depth = Read32(bytes + 28);
+  const uint32_t layers = Read32(bytes + 32);
+  const uint32_t faces = Read32(bytes + 36);
+  const uint32_t scheme = Read32(bytes + 44);
+  Ktx2Info info;
+  info.width = Read32(bytes + 20);
+  info.height = Read32(bytes + 24);
+  if (entry == nullptr || info.width == 0 || info.height == 0 || depth != 0 || layers > 1 || faces != 1 ||
+      (scheme != static_cast<uint32_t>(Ktx2Supercompression::kNone) && scheme != static_cast<uint32_t>(Ktx2Supercompression::kZlib))) {
+    return std::nullopt;
+  }
+  info.format = entry->format;
+  info.srgb = entry->srgb;
+  info.supercompression = static_cast<Ktx2Supercompression>(scheme);
+  const uint32_t levelCount = std::max(Read32(bytes + 40), 1U);  // 0 asks the loader to build mips; level 0 is all there is
+  if (levelCount > FullMipLevelCount(info.width, info.height) || kHeaderBytes + levelCount * kLevelIndexBytes > size) {
+    return std::nullopt;
+  }
+  info.levels.resize(levelCount);
+  for (uint32_t l = 0; l < levelCount; ++l) {
+    const uint8_t* index = bytes + kHeaderBytes + l * kLevelIndexBytes;
+    Ktx2Level& level = info.levels[l];
+    level.offset = Read64(index);
+    level.length = Read64(index + 8);
+    level.uncompressedLength = Read64(index + 16);
+    const size_t expected = LevelBytes(info.format, info.width, info.height, l);
+    if (level.uncompressedLength != expected || level.length > size || level.offset > size - level.length ||
+        (info.supercompression == Ktx2Supercompression::kNone && level.length != expected)) {
+      return std::nullopt;
+    }
+  }
+  return info;
+}
+
+size_t Ktx2ChainBytes(const Ktx2Info& info) {
+  return TextureLevelOffset(info.format, info.width, info.height, static_cast<uint32_t>(info.levels.size()));
+}
+
+bool ReadKtx2Levels(const uint8_t* bytes, size_t size, const Ktx2Info& info, uint8_t* dst) {
+  for (uint32_t l = 0; l < info.levels.size(); ++l) {
+    const Ktx2Level& level = info.levels[l];
+    if (level.length > size || level.offset > size - level.length) {
+      return false;
+    }
+    uint8_t* out = dst + TextureLevelOffset(info.format, info.width, info.height, l);
+    if (info.supercompression == Ktx2Supercompression::kNone) {
+      std::memcpy(out, bytes + level.offset, level.length);
+    } else if (!InflateZlib(bytes + level.offset, level.length, out, level.uncompressedLength)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Texture MakeKtx2Texture(const Ktx2Info& info, bool srgb) {
+  Texture texture;
+  texture.width = info.width;
+  texture.height = info.height;
+  texture.srgb = srgb;
+  texture.format = info.format;
+  if (!IsBlockCompressed(info.format)) {
+    texture.format = srgb ? PixelFormat::kR8G8B8A8_SRGB : PixelFormat::kR8G8B8A8;
+  }
+  texture.mipLevels = static_cast<uint32_t>(info.levels.size());
+  return texture;
+}
+
+std::optional<Texture> LoadKtx2Texture(const uint8_t* bytes, size_t size) {
+  const std::optional<Ktx2Info> info = ReadKtx2Info(bytes, size);
+  if (!info.has_value()) {
+    return std::nullopt;
+  }
+  Texture texture = MakeKtx2Texture(*info, info->srgb);
+  texture.pixels = PixelBuffer(Ktx2ChainBytes(*info));
+  if (!ReadKtx2Levels(bytes, size, *info, texture.pixels.data())) {
+    return std::nullopt;
+  }
+  return texture;
+}
+
+bool IsKtx2Source(const TextureSource& source) {
+  if (source.rawWidth > 0) {
+    return false;
+  }
+  if (source.bytes != nullptr) {
+    return IsKtx2(source.bytes->data(), source.bytes->size());
+  }
+  std::string extension = std::filesystem::path(source.path).extension().string();
+  std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+  return extension == kKtx2Extension;
+}
+
+bool Ktx2Source::Open(const TextureSource& source) {
+  if (source.rawWidth > 0) {
+    return false;
+  }
+  if (source.bytes != nullptr) {
+    bytes_ = source.bytes;
+    data_ = bytes_->data();
+    size_ = bytes_->size();
+  } else if (!source.path.empty() && file_.Open(source.path)) {
+    data_ = file_.Data();
+    size_ = file_.Size();
+  } else {
+    return false;
+  }
+  std::optional<Ktx2Info> info = ReadKtx2Info(data_, size_);
+  if (!info.has_value()) {
+    return false;
+  }
+  info_ = std::move(*info);
+  return true;
+}
+
+std::vector<uint8_t> EncodeKtx2(const Texture& texture, Ktx2Supercompression supercompression) {
+  const FormatEntry* entry = FindTextureFormat(texture);
+  const uint32_t levelCount = texture.mipLevels;
+  if (entry == nullptr || texture.width == 0 || texture.height == 0 || levelCount == 0 ||
+      levelCount > FullMipLevelCount(texture.width, texture.height) ||
+      texture.pixels.size() < TextureLevelOffset(texture.format, texture.width, texture.height, levelCount)) {
+    return {};
+  }
+  const std::vector<uint8_t> dfd = BuildDataFormatDescriptor(*entry);
+  const std::vector<uint8_t> kvd = BuildKeyValueData();
+
+  std::vector<uint8_t> out(kHeaderBytes + levelCount * kLevelIndexBytes);
+  std::memcpy(out.data(), kIdentifier.data(), kIdentifier.size());
+  Put32(out, 12, entry->vkFormat);
+  Put32(out, 16, 1);  // typeSize
+  Put32(out, 20, texture.width);
+  Put32(out, 24, texture.height);
+  Put32(out, 28, 0);  // depth
+  Put32(out, 32, 0);  // layers
+  Put32(out, 36, 1);  // faces
+  Put32(out, 40, levelCount);
+  Put32(out, 44, static_cast<uint32_t>(supercompression));
+  Put32(out, 48, static_cast<uint32_t>(out.size()));
+  Put32(out, 52, static_cast<uint32_t>(dfd.size()));
+  Put32(out, 56, static_cast<uint32_t>(out.size() + dfd.size()));
+  Put32(out, 60, static_cast<uint32_t>(kvd.size()));
+  Put64(out, 64, 0);  // no supercompression global data
+  Put64(out, 72, 0);
+  out.insert(out.end(), dfd.begin(), dfd.end());
+  out.insert(out.end(), kvd.begin(), kvd.end());
+
+  // Uncompressed levels start on a multiple of lcm(texel block bytes, 4); deflated ones anywhere.
+  const size_t alignment = supercompression == Ktx2Supercompression::kNone ? std::max<size_t>(entry->bytesPlane0, 4) : 1;
+  for (uint32_t l = levelCount; l-- > 0;) {
+    const uint8_t* level = texture.pixels.data() + TextureLevelOffset(texture.format, texture.width, texture.height, l);
+    const size_t levelBytes = LevelBytes(texture.format, texture.width, texture.height, l);
+    out.resize((out.size() + alignment - 1) / alignment * alignment);
+    const size_t offset = out.size();
+    if (supercompression == Ktx2Supercompression::kZlib) {
+      const std::vector<uint8_t> packed = DeflateZlib(level, levelBytes);
+      out.insert(out.end(), packed.begin(), packed.end());
+    } else {
+      out.insert(out.end(), level, level + levelBytes);
+    }
+    const size_t index = kHeaderBytes + l * kLevelIndexBytes;
+    Put64(out, index, offset);
+    Put64(out, index + 8, out.size() - offset);
+    Put64(out, index + 16, levelBytes);
+  }
+  return out;
+}
+
+bool WriteKtx2(const std::string& path, const Texture& texture, Ktx2Supercompression supercompression, std::string& error) {
+  const std::vector<uint8_t> bytes = EncodeKtx2(texture, supercompression);
+  if (bytes.empty()) {
+    error = "cannot encode " + texture.uri + " as KTX2";
+    return false;
+  }
+  // Written next to the target and renamed, so an importer never picks up a partial file. The temp
+  // name is unique per process and call: batch cooks write siblings from forked children, and two
+  // scenes sharing an image may write the same target at once.
+  static std::atomic<uint64_t> tempCounter{0};
+  const std::filesystem::path temp = path + ".tmp" + std::to_string(ProcessId()) + "_" + std::to_string(tempCounter++);
+  std::error_code ec;
+  {
+    std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+    if (!out || !out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()))) {
+      error = "cannot write " + temp.string();
+      out.close();
+      std::filesystem::remove(temp, ec);
+      return false;
+    }
+  }
+  std::filesystem::rename(temp, path, ec);
+  if (ec) {
+    error = "cannot rename " + temp.string() + ": " + ec.message();
+    std::filesystem::remove(temp, ec);
+    return false;
+  }
+  return true;
+}
+
+}  // namespace vv
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "core/io/MappedFile.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+constexpr const char* kKtx2Extension = ".ktx2";
+
+// Level supercompression. BasisLZ and Zstandard files are rejected: the engine has no decoder
+// for either.
+enum class Ktx2Supercompression : uint32_t {
+  kNone = 0,
+  kZlib = 3,
+};
+
+struct Ktx2Level {
+  uint64_t offset = 0;              // in the file
+  uint64_t length = 0;              // stored bytes
+  uint64_t uncompressedLength = 0;  // bytes once inflated
+};
+
+// What a KTX2 header describes, checked against the file size. Only single-layer 2D textures in
+// the formats Texture can hold are accepted.
+struct Ktx2Info {
+  uint32_t width = 0;
+  uint32_t height = 0;
+  PixelFormat format = PixelFormat::kUnknown;
+  bool srgb = false;
+  Ktx2Supercompression supercompression = Ktx2Supercompression::kNone;
+  std::vector<Ktx2Level> levels;  // level 0 first
+};
+
+bool IsKtx2(const uint8_t* bytes, size_t size);  // identifier only
+std::optional<Ktx2Info> ReadKtx2Info(const uint8_t* bytes, size_t size);
+
+// Bytes of the whole chain back to back, level 0 first (the Texture::pixels layout).
+size_t Ktx2ChainBytes(const Ktx2Info& info);
+// Copies every level into `dst` (Ktx2ChainBytes long), inflating supercompressed ones.
+bool ReadKtx2Levels(const uint8_t* bytes, size_t size, const Ktx2Info& info, uint8_t* dst);
+
+// A texture without pixels shaped like the file: size, format and mip count. `srgb` comes from
+// how the texture is used and overrides the file's transfer function.
+Texture MakeKtx2Texture(const Ktx2Info& info, bool srgb);
+// The whole file as a resident texture, sRGB as the file says.
+std::optional<Texture> LoadKtx2Texture(const uint8_t* bytes, size_t size);
+
+// True when `source` names a KTX2 file or holds KTX2 bytes. Such sources are read with
+// Ktx2Source, never decoded to RGBA8.
+bool IsKtx2Source(const TextureSource& source);
+
+// A KTX2 texture source opened for reading its levels: the file is mapped, so an upload copies
+// them straight from the page cache into staging memory.
+class Ktx2Source {
+ public:
+  bool Open(const TextureSource& source);
+
+  [[nodiscard]] const Ktx2Info& Info() const { return info_; }
+  bool ReadLevels(uint8_t* dst) const { return ReadKtx2Levels(data_, size_, info_, dst); }
+
+ private:
+  MappedFile file_;
+  std::shared_ptr<const std::vector<uint8_t>> bytes_;
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  Ktx2Info info_;
+};
+
+// Every mip level of an RGBA8 or BC texture, in its own format; empty when the texture has no
+// pixels for its declared chain. Levels are stored smallest first, as the specification asks.
+std::vector<uint8_t> EncodeKtx2(const Texture& texture, Ktx2Supercompression supercompression);
+bool WriteKtx2(const std::string& path, const Texture& texture, Ktx2Supercompression supercompression, std::string& error);
+
+}  // namespace vv
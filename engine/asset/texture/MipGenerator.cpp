@@ -0,0 +1,227 @@
+#include "asset/texture/MipGenerator.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "core/thread/ParallelFor.hpp"
+
+namespace vv {
+namespace {
+
+constexpr size_t kLinearToSrgbLutSize = 16384;
+constexpr size_t kRowsPerTask = 16;
+
+enum class MipFilter {
+  kLinear,
+  kSrgb,
+  kNormal,
+};
+
+float SrgbToLinear(float c) {
+  return c <= 0.04045F ? c / 12.92F : std::pow((c + 0.055F) / 1.055F, 2.4F);
+}
+
+float LinearToSrgb(float c) {
+  return c <= 0.0031308F ? c * 12.92F : 1.055F * std::pow(c, 1.0F / 2.4F) - 0.055F;
+}
+
+const std::array<float, 256>& SrgbDecodeLut() {
+  static const std::array<float, 256> lut = [] {
+    std::array<float, 256> out{};
+    for (size_t i = 0; i < out.size(); ++i) {
+      out[i] = SrgbToLinear(static_cast<float>(i) / 255.0F);
+    }
+    return out;
+  }();
+  return lut;
+}
+
+const std::vector<uint8_t>& SrgbEncodeLut() {
+  static const std::vector<uint8_t> lut = [] {
+    std::vector<uint8_t> out(kLinearToSrgbLutSize);
+    for (size_t i = 0; i < out.size(); ++i) {
+      const float linear = static_cast<float>(i) / static_cast<float>(kLinearToSrgbLutSize - 1);
+      out[i] = static_cast<uint8_t>(std::lround(LinearToSrgb(linear) * 255.0F));
+    }
+    return out;
+  }();
+  return lut;
+}
+
+uint8_t ToUnorm8(float v) {
+  return static_cast<uint8_t>(std::lround(std::clamp(v, 0.0F, 1.0F) * 255.0F));
+}
+
+// Source taps of one destination texel along one axis.
+struct Taps {
+  std::array<uint32_t, 3> index{};
+  std::array<float, 3> weight{};
+};
+
+std::vector<Taps> BuildTaps(uint32_t srcSize, uint32_t dstSize) {
+  std::vector<Taps> taps(dstSize);
+  for (uint32_t x = 0; x < dstSize; ++x) {
+    Taps& t = taps[x];
+    if (srcSize == 1) {
+      t.index = {0, 0, 0};
+      t.weight = {1.0F, 0.0F, 0.0F};
+    } else if (srcSize % 2 == 0) {
+      t.index = {2 * x, 2 * x + 1, 2 * x + 1};
+      t.weight = {0.5F, 0.5F, 0.0F};
+    } else {
+      const float norm = 1.0F / static_cast<float>(srcSize);
+      t.index = {2 * x, 2 * x + 1, 2 * x + 2};
+      t.weight = {static_cast<float>(dstSize - x) * norm, static_cast<float>(dstSize) * norm, static_cast<float>(x + 1) * norm};
+    }
+  }
+  return taps;
+}
+
+std::vector<float> DecodeLevel0(const uint8_t* pixels, uint32_t width, uint32_t height, MipFilter filter) {
+  const size_t count = static_cast<size_t>(width) * height * 4;
+  std::vector<float> out(count);
+  const std::array<float, 256>& srgb = SrgbDecodeLut();
+  ParallelFor(height, kRowsPerTask, [&](size_t begin, size_t end) {
+    for (size_t i = begin * width * 4; i < end * width * 4; ++i) {
+      const uint8_t v = pixels[i];
+      const bool alpha = (i & 3U) == 3U;
+      if (filter == MipFilter::kSrgb && !alpha) {
+        out[i] = srgb[v];
+      } else if (filter == MipFilter::kNormal && !alpha) {
+        out[i] = static_cast<float>(v) * (2.0F / 255.0F) - 1.0F;
+      } else {
+        out[i] = static_cast<float>(v) * (1.0F / 255.0F);
+      }
+    }
+  });
+  return out;
+}
+
+void DownsampleLevel(const std::vector<float>& src, uint32_t sw, uint32_t sh, std::vector<float>& dst, uint32_t dw, uint32_t dh) {
+  const std::vector<Taps> xTaps = BuildTaps(sw, dw);
+  const std::vector<Taps> yTaps = BuildTaps(sh, dh);
+  dst.assign(static_cast<size_t>(dw) * dh * 4, 0.0F);
+
+  ParallelFor(dh, kRowsPerTask, [&](size_t begin, size_t end) {
+    std::vector<float> row(static_cast<size_t>(sw) * 4);
+    for (size_t y = begin; y < end; ++y) {
+      // Vertical pass into a contiguous row, then horizontal; both loops are plain float
+      // multiply-adds over RGBA runs that the compiler vectorizes.
+      const Taps& ty = yTaps[y];
+      const float* r0 = &src[static_cast<size_t>(ty.index[0]) * sw * 4];
+      const float* r1 = &src[static_cast<size_t>(ty.index[1]) * sw * 4];
+      const float* r2 = &src[static_cast<size_t>(ty.index[2]) * sw * 4];
+      for (size_t i = 0; i < row.size(); ++i) {
+        row[i] = r0[i] * ty.weight[0] + r1[i] * ty.weight[1] + r2[i] * ty.weight[2];
+      }
+
+      float* out = &dst[y * dw * 4];
+      for (uint32_t x = 0; x < dw; ++x) {
+        const Taps& tx = xTaps[x];
+        const float* p0 = &row[static_cast<size_t>(tx.index[0]) * 4];
+        const float* p1 = &row[static_cast<size_t>(tx.index[1]) * 4];
+        const float* p2 = &row[static_cast<size_t>(tx.index[2]) * 4];
+        for (size_t c = 0; c < 4; ++c) {
+          out[x * 4 + c] = p0[c] * tx.weight[0] + p1[c] * tx.weight[1] + p2[c] * tx.weight[2];
+        }
+      }
+    }
+  });
+}
+
+void EncodeLevel(const std::vector<float>& level, MipFilter filter, uint8_t* dst) {
+  const size_t texels = level.size() / 4;
+  const std::vector<uint8_t>& srgb = SrgbEncodeLut();
+  ParallelFor(texels, 4096, [&](size_t begin, size_t end) {
+    for (size_t t = begin; t < end; ++t) {
+      const float* v = &level[t * 4];
+      uint8_t* o = &dst[t * 4];
+      if (filter == MipFilter::kNormal) {
+        float nx = v[0];
+        float ny = v[1];
+        float nz = v[2];
+        const float len = std::sqrt(nx * nx + ny * ny + nz * nz);
+        if (len > 1e-6F) {
+          nx /= len;
+          ny /= len;
+          nz /= len;
+        } else {
+          nx = 0.0F;
+          ny = 0.0F;
+          nz = 1.0F;
+        }
+        o[0] = ToUnorm8(nx * 0.5F + 0.5F);
+        o[1] = ToUnorm8(ny * 0.5F + 0.5F);
+        o[2] = ToUnorm8(nz * 0.5F + 0.5F);
+      } else if (filter == MipFilter::kSrgb) {
+        for (size_t c = 0; c < 3; ++c) {
+          const float linear = std::clamp(v[c], 0.0F, 1.0F);
+          o[c] = srgb[static_cast<size_t>(linear * static_cast<float>(kLinearToSrgbLutSize - 1) + 0.5F)];
+        }
+      } else {
+        for (size_t c = 0; c < 3; ++c) {
+          o[c] = ToUnorm8(v[c]);
+        }
+      }
+      o[3] = ToUnorm8(v[3]);
+    }
+  });
+}
+
+}  // namespace
+
+uint32_t FullMipLevelCount(uint32_t width, uint32_t height) {
+  uint32_t levels = 1;
+  for (uint32_t size = std::max(width, height); size > 1; size >>= 1U) {
+    ++levels;
+  }
+  return levels;
+}
+
+uint32_t MipDimension(uint32_t size, uint32_t level) {
+  return std::max(1U, size >> level);
+}
+
+size_t MipLevelOffset(uint32_t width, uint32_t height, uint32_t level) {
+  size_t offset = 0;
+  for (uint32_t l = 0; l < level; ++l) {
+    offset += static_cast<size_t>(MipDimension(width, l)) * MipDimension(height, l) * 4;
+  }
+  return offset;
+}
+
+void GenerateMipChain(Texture& texture) {
+  const size_t level0Bytes = static_cast<size_t>(texture.width) * texture.height * 4;
+  if (texture.mipLevels > 1 || texture.width == 0 || texture.height == 0 || texture.pixels.size() < level0Bytes) {
+    return;
+  }
+  const uint32_t levels = FullMipLevelCount(texture.width, texture.height);
+  if (levels == 1) {
+    return;
+  }
+  texture.pixels.resize(MipLevelOffset(texture.width, texture.height, levels));
+  WriteMipLevels(texture, texture.pixels.data(), texture.pixels.data());
+  texture.mipLevels = levels;
+}
+
+void WriteMipLevels(const Texture& texture, const uint8_t* level0, uint8_t* chain) {
+  const uint32_t levels = FullMipLevelCount(texture.width, texture.height);
+  const MipFilter filter = texture.normalMap ? MipFilter::kNormal : (texture.srgb ? MipFilter::kSrgb : MipFilter::kLinear);
+  std::vector<float> current = DecodeLevel0(level0, texture.width, texture.height, filter);
+  std::vector<float> next;
+  uint32_t w = texture.width;
+  uint32_t h = texture.height;
+  for (uint32_t level = 1; level < levels; ++level) {
+    const uint32_t dw = MipDimension(texture.width, level);
+    const uint32_t dh = MipDimension(texture.height, level);
+    DownsampleLevel(current, w, h, next, dw, dh);
+    EncodeLevel(next, filter, chain + MipLevelOffset(texture.width, texture.height, level));
+    current.swap(next);
+    w = dw;
+    h = dh;
+  }
+}
+
+}  // namespace vv
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+uint32_t FullMipLevelCount(uint32_t width, uint32_t height);
+uint32_t MipDimension(uint32_t size, uint32_t level);
+size_t MipLevelOffset(uint32_t width, uint32_t height, uint32_t level);  // RGBA8 bytes before `level`
+
+// Appends the full RGBA8 mip chain behind level 0 of `texture.pixels`. Filtering is a box filter
+// (3-tap polyphase on odd sizes) in linear light for sRGB textures; normal maps are averaged as
+// vectors and renormalized. Rows of each level are filtered across worker threads.
+void GenerateMipChain(Texture& texture);
+
+// Filters levels 1 and up of the full chain of `texture` (size, sRGB and normal-map flags) from the
+// RGBA8 level 0 at `level0` into `chain` at their MipLevelOffset positions; level 0 itself is not
+// written and `chain` is never read, so it can be mapped staging memory.
+void WriteMipLevels(const Texture& texture, const uint8_t* level0, uint8_t* chain);
+
+}  // namespace vv
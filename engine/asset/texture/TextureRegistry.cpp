@@ -0,0 +1,254 @@
+#include "asset/texture/TextureRegistry.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace vv {
+namespace {
+
+constexpr uint64_t kGolden = 0x9E3779B97F4A7C15ULL;
+
+uint64_t Mix(uint64_t x) {
+  x ^= x >> 33U;
+  x *= 0xFF51AFD7ED558CCDULL;
+  x ^= x >> 33U;
+  x *= 0xC4CEB9FE1A85EC53ULL;
+  x ^= x >> 33U;
+  return x;
+}
+
+uint64_t Combine(uint64_t seed, uint64_t value) {
+  return Mix(seed ^ (value + kGolden + (seed << 6U) + (seed >> 2U)));
+}
+
+// Level 0 is the first image of the chain, so an uncompressed, resident texture still stores it.
+bool StoresLevel0(const Texture& texture) {
+  return (texture.format == PixelFormat::kR8G8B8A8 || texture.format == PixelFormat::kR8G8B8A8_SRGB) &&
+         !texture.pixelsReleased && texture.pixels.size() >= static_cast<size_t>(texture.width) * texture.height * 4;
+}
+
+}  // namespace
+
+uint64_t HashBytes(const uint8_t* data, size_t size) {
+  uint64_t h = Mix(static_cast<uint64_t>(size) * kGolden);
+  size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t word = 0;
+    std::memcpy(&word, data + i, 8);
+    h = (h ^ Mix(word)) * kGolden;
+    h ^= h >> 29U;
+  }
+  uint64_t tail = 0;
+  for (size_t k = 0; i + k < size; ++k) {
+    tail |= static_cast<uint64_t>(data[i + k]) << (8 * k);
+  }
+  return Mix(h ^ Mix(tail + size));
+}
+
+uint64_t TextureGpuKey(const Texture& texture) {
+  if (texture.contentHash == 0) {
+    return 0;
+  }
+  uint64_t key = texture.contentHash;
+  key = Combine(key, static_cast<uint64_t>(texture.format));
+  key = Combine(key, (texture.srgb ? 1U : 0U) | (texture.normalMap ? 2U : 0U));
+  key = Combine(key, (static_cast<uint64_t>(texture.width) << 32U) | texture.height);
+  key = Combine(key, texture.mipLevels);
+  return key == 0 ? 1 : key;
+}
+
+bool HasLazySource(const Texture& texture) {
+  return texture.pixels.empty() && (!texture.source.path.empty() || texture.source.bytes != nullptr);
+}
+
+std::optional<ImageRgba8> DecodeTextureSource(const TextureSource& source) {
+  if (source.bytes != nullptr) {
+    const std::vector<uint8_t>& bytes = *source.bytes;
+    if (source.rawWidth > 0) {
+      if (bytes.size() < static_cast<size_t>(source.rawWidth) * source.rawHeight * 4) {
+        return std::nullopt;
+      }
+      return ConvertBgra8(bytes.data(), source.rawWidth, source.rawHeight);
+    }
+    return LoadImageRgba8FromMemory(bytes.data(), bytes.size());
+  }
+  if (!source.path.empty() && source.rawWidth > 0) {
+    // Raw texels spilled to disk by a bounded-memory import.
+    const size_t size = static_cast<size_t>(source.rawWidth) * source.rawHeight * 4;
+    std::vector<uint8_t> texels(size);
+    std::ifstream file(source.path, std::ios::binary);
+    if (!file.read(reinterpret_cast<char*>(texels.data()), static_cast<std::streamsize>(size))) {
+      return std::nullopt;
+    }
+    return ConvertBgra8(texels.data(), source.rawWidth, source.rawHeight);
+  }
+  if (!source.path.empty()) {
+    return LoadImageRgba8(source.path);
+  }
+  return std::nullopt;
+}
+
+TextureRegistry& TextureRegistry::Global() {
+  static TextureRegistry registry;
+  return registry;
+}
+
+std::shared_ptr<const ImageRgba8> TextureRegistry::Find(uint64_t hash, size_t sourceBytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = images_.find(hash);
+  if (it == images_.end() || it->second.sourceBytes != sourceBytes || it->second.image == nullptr) {
+    return nullptr;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second.lru);
+  return it->second.image;
+}
+
+std::shared_ptr<const ImageRgba8> TextureRegistry::Insert(uint64_t hash, size_t sourceBytes, ImageRgba8 image) {
+  auto shared = std::make_shared<const ImageRgba8>(std::move(image));
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto [it, inserted] = images_.try_emplace(hash, Entry{sourceBytes, nullptr, {}, {}});
+  Entry& entry = it->second;
+  if (entry.sourceBytes != sourceBytes) {
+    return shared;  // hash collision: hand the image out uncached
+  }
+  if (entry.image != nullptr) {
+    lru_.splice(lru_.begin(), lru_, entry.lru);
+    return entry.image;
+  }
+  lru_.push_front(hash);
+  entry.image = shared;
+  entry.lru = lru_.begin();
+  stats_.cachedBytes += shared->pixels.size();
+  EvictLocked(hash);
+  return shared;
+}
+
+TextureRegistry::CachedImage TextureRegistry::FindDecoded(uint64_t hash, size_t sourceBytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  const auto it = images_.find(hash);
+  if (it == images_.end() || it->second.sourceBytes != sourceBytes) {
+    return {};
+  }
+  Entry& entry = it->second;
+  if (entry.image != nullptr) {
+    lru_.splice(lru_.begin(), lru_, entry.lru);
+    return {entry.image, entry.image->pixels.data(), entry.image->width, entry.image->height};
+  }
+  if (const std::shared_ptr<const Texture> texture = entry.published.lock(); texture != nullptr && StoresLevel0(*texture)) {
+    return {texture, texture->pixels.data(), texture->width, texture->height};
+  }
+  images_.erase(it);  // the published texture is gone, compressed or released
+  return {};
+}
+
+void TextureRegistry::Publish(const std::vector<SharedAsset<Texture>>& textures) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto it = images_.begin(); it != images_.end();) {
+    it = it->second.image == nullptr && it->second.published.expired() ? images_.erase(it) : std::next(it);
+  }
+  for (const SharedAsset<Texture>& texture : textures) {
+    if (texture->contentHash == 0 || texture->source.sizeBytes == 0 || !StoresLevel0(*texture)) {
+      continue;
+    }
+    const auto sourceBytes = static_cast<size_t>(texture->source.sizeBytes);
+    const auto [it, inserted] = images_.try_emplace(texture->contentHash, Entry{sourceBytes, nullptr, {}, {}});
+    if (it->second.sourceBytes == sourceBytes && it->second.published.expired()) {
+      it->second.published = texture.Handle();
+    }
+  }
+}
+
+std::shared_ptr<const ImageRgba8> TextureRegistry::AcquirePixels(const Texture& texture) {
+  if (!HasLazySource(texture)) {
+    return nullptr;
+  }
+  const auto sourceBytes = static_cast<size_t>(texture.source.sizeBytes);
+  if (auto cached = Find(texture.contentHash, sourceBytes); cached != nullptr) {
+    RecordRegistryHit(sourceBytes);
+    return cached;
+  }
+  auto decoded = DecodeTextureSource(texture.source);
+  if (!decoded.has_value()) {
+    return nullptr;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.decodedImages;
+  }
+  return Insert(texture.contentHash, sourceBytes, std::move(*decoded));
+}
+
+void TextureRegistry::SetBudgetBytes(size_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  budgetBytes_ = bytes;
+  EvictLocked(0);
+}
+
+size_t TextureRegistry::BudgetBytes() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return budgetBytes_;
+}
+
+void TextureRegistry::EvictLocked(uint64_t keep) {
+  while (stats_.cachedBytes > budgetBytes_ && !lru_.empty()) {
+    const uint64_t victim = lru_.back();
+    if (victim == keep) {
+      break;  // the newest image stays even when it alone exceeds the budget
+    }
+    const auto it = images_.find(victim);
+    stats_.cachedBytes -= it->second.image->pixels.size();
+    ++stats_.evictions;
+    lru_.pop_back();
+    it->second.image.reset();
+    if (it->second.published.expired()) {
+      images_.erase(it);
+    }
+  }
+}
+
+void TextureRegistry::RecordSourceImage(bool decoded) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++stats_.sourceImages;
+  if (decoded) {
+    ++stats_.decodedImages;
+  }
+}
+
+void TextureRegistry::RecordSceneDuplicate(uint64_t pixelBytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++stats_.sceneDuplicates;
+  stats_.sceneDuplicateBytes += pixelBytes;
+}
+
+void TextureRegistry::RecordRegistryHit(uint64_t sourceBytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ++stats_.registryHits;
+  stats_.registryHitBytes += sourceBytes;
+}
+
+TextureDedupStats TextureRegistry::Stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+size_t TextureRegistry::ImageCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t count = 0;
+  for (const auto& [hash, entry] : images_) {
+    const std::shared_ptr<const Texture> texture = entry.published.lock();
+    count += entry.image != nullptr || (texture != nullptr && StoresLevel0(*texture)) ? 1 : 0;
+  }
+  return count;
+}
+
+void TextureRegistry::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  images_.clear();
+  lru_.clear();
+  stats_ = {};
+}
+
+}  // namespace vv
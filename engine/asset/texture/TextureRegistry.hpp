@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include "asset/texture/ImageLoader.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+uint64_t HashBytes(const uint8_t* data, size_t size);
+
+// Key under which uploaded GPU images can be shared: equal content, color space, format and chain.
+// 0 when the texture carries no content hash.
+uint64_t TextureGpuKey(const Texture& texture);
+
+// True when the texture's pixels are not resident but can be decoded from `Texture::source`.
+bool HasLazySource(const Texture& texture);
+std::optional<ImageRgba8> DecodeTextureSource(const TextureSource& source);
+
+struct TextureDedupStats {
+  uint64_t sourceImages = 0;          // images resolved by importers (before dedup)
+  uint64_t decodedImages = 0;         // images actually decoded, at import or on demand
+  uint64_t sceneDuplicates = 0;       // references folded onto a texture of the same scene
+  uint64_t sceneDuplicateBytes = 0;   // RGBA8 bytes not stored/uploaded again
+  uint64_t registryHits = 0;          // decodes skipped because the cache had the content
+  uint64_t registryHitBytes = 0;      // encoded source bytes not decoded again
+  uint64_t evictions = 0;             // images dropped to stay inside the budget
+  uint64_t cachedBytes = 0;           // decoded bytes held by the cache itself (not published textures)
+};
+
+// Process-wide cache of decoded source images keyed by a hash of their encoded bytes, so the same
+// image reached through different paths, copied between folders or uploaded again decodes once.
+// Images decoded for the cache alone (lazy uploads, compressed imports) are LRU-bounded by decoded
+// bytes; images still referenced elsewhere stay valid after eviction because entries are shared
+// pointers. Imported RGBA8 textures are published instead: the cache only keeps a weak reference,
+// so their pixels are stored once, in the scene, and serve later imports while any scene holds them.
+class TextureRegistry {
+ public:
+  static constexpr size_t kDefaultBudgetBytes = size_t{256} << 20U;
+
+  // Decoded level 0 of a source image; `owner` keeps `pixels` alive.
+  struct CachedImage {
+    std::shared_ptr<const void> owner;
+    const uint8_t* pixels = nullptr;
+    uint32_t width = 0;
+    uint32_t height = 0;
+
+    explicit operator bool() const { return pixels != nullptr; }
+    size_t SizeBytes() const { return static_cast<size_t>(width) * height * 4; }
+  };
+
+  static TextureRegistry& Global();
+
+  // Images the cache holds itself.
+  std::shared_ptr<const ImageRgba8> Find(uint64_t hash, size_t sourceBytes);
+  std::shared_ptr<const ImageRgba8> Insert(uint64_t hash, size_t sourceBytes, ImageRgba8 image);
+  // A held image, or else level 0 of a published texture that still stores it.
+  CachedImage FindDecoded(uint64_t hash, size_t sourceBytes);
+
+  // Publishes every texture of a finished import that stores the RGBA8 decode of its source
+  // (contentHash and source.sizeBytes set). Published textures must not be edited in place while
+  // another thread imports.
+  void Publish(const std::vector<SharedAsset<Texture>>& textures);
+
+  // Level 0 of a lazily imported texture: cached, or decoded from its source and cached.
+  std::shared_ptr<const ImageRgba8> AcquirePixels(const Texture& texture);
+
+  void SetBudgetBytes(size_t bytes);
+  size_t BudgetBytes() const;
+
+  void RecordSourceImage(bool decoded);
+  void RecordSceneDuplicate(uint64_t pixelBytes);
+  void RecordRegistryHit(uint64_t sourceBytes);
+
+  TextureDedupStats Stats() const;
+  size_t ImageCount() const;  // held images and live published textures
+  void Clear();
+
+ private:
+  struct Entry {
+    size_t sourceBytes = 0;
+    std::shared_ptr<const ImageRgba8> image;  // held image, in `lru_`; may be null
+    std::list<uint64_t>::iterator lru;
+    std::weak_ptr<const Texture> published;
+  };
+
+  void EvictLocked(uint64_t keep);
+
+  mutable std::mutex mutex_;
+  std::unordered_map<uint64_t, Entry> images_;
+  std::list<uint64_t> lru_;  // most recently used first
+  size_t budgetBytes_ = kDefaultBudgetBytes;
+  TextureDedupStats stats_;
+};
+
+}  // namespace vv
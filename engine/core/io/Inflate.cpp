@@ -0,0 +1,480 @@
+#include "core/io/Inflate.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace vv {
+
+namespace {
+
+constexpr int kMaxCodeBits = 15;
+constexpr int kFastBits = 10;
+constexpr uint32_t kFastMask = (1U << kFastBits) - 1U;
+
+constexpr std::array<uint16_t, 29> kLengthBase = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                                  31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+constexpr std::array<uint8_t, 29> kLengthExtra = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                                  2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+constexpr std::array<uint16_t, 30> kDistBase = {1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+                                                33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+                                                1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+constexpr std::array<uint8_t, 30> kDistExtra = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                                6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+constexpr std::array<uint8_t, 19> kCodeLengthOrder = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+// LSB-first bit stream. Reading past the end yields zero bits and is caught by Overrun().
+class BitReader {
+ public:
+  BitReader(const uint8_t* data, size_t size) : p_(data), end_(data + size) {}
+
+  uint32_t Peek(int count) {
+    Refill();
+    return static_cast<uint32_t>(bits_ & ((uint64_t{1} << count) - 1U));
+  }
+  void Consume(int count) {
+    bits_ >>= count;
+    available_ -= count;
+  }
+  uint32_t Read(int count) {
+    if (count == 0) {
+      return 0;
+    }
+    const uint32_t value = Peek(count);
+    Consume(count);
+    return value;
+  }
+  void AlignToByte() { Consume(available_ & 7); }
+  [[nodiscard]] bool Overrun() const { return padding_ * 8 > available_; }
+
+ private:
+  void Refill() {
+    while (available_ <= 56) {
+      uint64_t byte = 0;
+      if (p_ < end_) {
+        byte = *p_++;
+      } else {
+        ++padding_;
+      }
+      bits_ |= byte << available_;
+      available_ += 8;
+    }
+  }
+
+  const uint8_t* p_;
+  const uint8_t* end_;
+  uint64_t bits_ = 0;
+  int available_ = 0;
+  int padding_ = 0;
+};
+
+// Canonical Huffman code: a direct table for codes up to kFastBits, counted decoding beyond.
+struct Huffman {
+  std::array<uint16_t, 1U << kFastBits> fast{};  // (symbol << 4) | length; 0 = longer code
+  std::array<uint16_t, kMaxCodeBits + 1> count{};
+  std::array<uint16_t, 320> symbols{};
+
+  // False for over-subscribed codes; incomplete ones are allowed (a lone distance code is legal).
+  bool Build(const uint8_t* lengths, int n) {
+    count.fill(0);
+    fast.fill(0);
+    for (int s = 0; s < n; ++s) {
+      ++count[lengths[s]];
+    }
+    count[0] = 0;
+    int left = 1;
+    for (int len = 1; len <= kMaxCodeBits; ++len) {
+      left = (left << 1) - count[len];
+      if (left < 0) {
+        return false;
+      }
+    }
+    std::array<uint16_t, kMaxCodeBits + 2> offsets{};
+    for (int len = 1; len <= kMaxCodeBits; ++len) {
+      offsets[len + 1] = static_cast<uint16_t>(offsets[len] + count[len]);
+    }
+    std::array<uint16_t, kMaxCodeBits + 1> nextCode{};
+    uint32_t code = 0;
+    for (int len = 1; len <= kMaxCodeBits; ++len) {
+      code = (code + count[len - 1]) << 1;
+      nextCode[len] = static_cast<uint16_t>(code);
+    }
+    for (int s = 0; s < n; ++s) {
+      const int len = lengths[s];
+      if (len == 0) {
+        continue;
+      }
+      symbols[offsets[len]++] = static_cast<uint16_t>(s);
+      if (len <= kFastBits) {
+        uint32_t reversed = 0;
+        for (uint32_t c = nextCode[len], i = 0; i < static_cast<uint32_t>(len); ++i, c >>= 1) {
+          reversed = (reversed << 1) | (c & 1U);
+        }
+        const auto entry = static_cast<uint16_t>((s << 4) | len);
+        for (uint32_t fill = reversed; fill < (1U << kFastBits); fill += 1U << len) {
+          fast[fill] = entry;
+        }
+      }
+      ++nextCode[len];
+    }
+    return true;
+  }
+
+  // -1 for a bit sequence that is not a code.
+  int Decode(BitReader& in) const {
+    const uint16_t entry = fast[in.Peek(kFastBits) & kFastMask];
+    if (entry != 0) {
+      in.Consume(entry & 15);
+      return entry >> 4;
+    }
+    int code = 0;
+    int first = 0;
+    int index = 0;
+    for (int len = 1; len <= kMaxCodeBits; ++len) {
+      code |= static_cast<int>(in.Read(1));
+      const int n = count[len];
+      if (code - n < first) {
+        return symbols[index + (code - first)];
+      }
+      index += n;
+      first = (first + n) << 1;
+      code <<= 1;
+    }
+    return -1;
+  }
+};
+
+bool BuildFixed(Huffman& lit, Huffman& dist) {
+  std::array<uint8_t, 320> lengths{};
+  for (int s = 0; s < 288; ++s) {
+    lengths[s] = s < 144 ? 8 : s < 256 ? 9 : s < 280 ? 7 : 8;
+  }
+  if (!lit.Build(lengths.data(), 288)) {
+    return false;
+  }
+  lengths.fill(5);
+  return dist.Build(lengths.data(), 30);
+}
+
+bool BuildDynamic(BitReader& in, Huffman& lit, Huffman& dist) {
+  const int nlen = static_cast<int>(in.Read(5)) + 257;
+  const int ndist = static_cast<int>(in.Read(5)) + 1;
+  const int ncode = static_cast<int>(in.Read(4)) + 4;
+  if (nlen > 286 || ndist > 30) {
+    return false;
+  }
+  std::array<uint8_t, 320> lengths{};
+  for (int i = 0; i < ncode; ++i) {
+    lengths[kCodeLengthOrder[i]] = static_cast<uint8_t>(in.Read(3));
+  }
+  Huffman lengthCode;
+  if (!lengthCode.Build(lengths.data(), 19)) {
+    return false;
+  }
+  lengths.fill(0);
+  int index = 0;
+  while (index < nlen + ndist) {
+    const int symbol = lengthCode.Decode(in);
+    if (symbol < 0) {
+      return false;
+    }
+    if (symbol < 16) {
+      lengths[index++] = static_cast<uint8_t>(symbol);
+      continue;
+    }
+    uint8_t value = 0;
+    int repeat = 0;
+    if (symbol == 16) {
+      if (index == 0) {
+        return false;
+      }
+      value = lengths[index - 1];
+      repeat = 3 + static_cast<int>(in.Read(2));
+    } else if (symbol == 17) {
+      repeat = 3 + static_cast<int>(in.Read(3));
+    } else {
+      repeat = 11 + static_cast<int>(in.Read(7));
+    }
+    if (index + repeat > nlen + ndist) {
+      return false;
+    }
+    while (repeat-- > 0) {
+      lengths[index++] = value;
+    }
+  }
+  if (lengths[256] == 0) {
+    return false;  // no end-of-block code
+  }
+  return lit.Build(lengths.data(), nlen) && dist.Build(lengths.data() + nlen, ndist);
+}
+
+bool InflateBlock(BitReader& in, const Huffman& lit, const Huffman& dist, uint8_t* dst, size_t dstSize, size_t& out) {
+  for (;;) {
+    int symbol = lit.Decode(in);
+    if (symbol < 0 || in.Overrun()) {
+      return false;
+    }
+    if (symbol < 256) {
+      if (out == dstSize) {
+        return false;
+      }
+      dst[out++] = static_cast<uint8_t>(symbol);
+      continue;
+    }
+    if (symbol == 256) {
+      return true;
+    }
+    symbol -= 257;
+    if (symbol >= 29) {
+      return false;
+    }
+    const size_t length = kLengthBase[symbol] + in.Read(kLengthExtra[symbol]);
+    const int distSymbol = dist.Decode(in);
+    if (distSymbol < 0 || distSymbol >= 30) {
+      return false;
+    }
+    const size_t distance = kDistBase[distSymbol] + in.Read(kDistExtra[distSymbol]);
+    if (distance > out || length > dstSize - out) {
+      return false;
+    }
+    // Byte by byte: overlapping copies (distance < length) repeat the last `distance` bytes.
+    const uint8_t* from = dst + out - distance;
+    uint8_t* to = dst + out;
+    for (size_t i = 0; i < length; ++i) {
+      to[i] = from[i];
+    }
+    out += length;
+  }
+}
+
+uint32_t Adler32(const uint8_t* data, size_t size) {
+  constexpr uint32_t kMod = 65521;
+  uint32_t a = 1;
+  uint32_t b = 0;
+  while (size > 0) {
+    const size_t chunk = size < 5552 ? size : 5552;  // largest run without overflowing b
+    for (size_t i = 0; i < chunk; ++i) {
+      a += data[i];
+      b += a;
+    }
+    a %= kMod;
+    b %= kMod;
+    data += chunk;
+    size -= chunk;
+  }
+  return (b << 16) | a;
+}
+
+constexpr size_t kWindowSize = 32768;
+constexpr size_t kMinMatch = 3;
+constexpr size_t kMaxMatch = 258;
+constexpr int kHashBits = 15;
+constexpr int kMaxChain = 64;  // candidates tried per position
+
+// LSB-first bit sink; Huffman codes are written most significant bit first, as DEFLATE wants.
+class BitWriter {
+ public:
+  explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+
+  void Write(uint32_t value, int count) {
+    bits_ |= uint64_t{value} << count_;
+    count_ += count;
+    while (count_ >= 8) {
+      out_.push_back(static_cast<uint8_t>(bits_));
+      bits_ >>= 8;
+      count_ -= 8;
+    }
+  }
+  void WriteCode(uint32_t code, int length) {
+    uint32_t reversed = 0;
+    for (int i = 0; i < length; ++i) {
+      reversed = (reversed << 1) | ((code >> i) & 1U);
+    }
+    Write(reversed, length);
+  }
+  void Flush() {
+    if (count_ > 0) {
+      out_.push_back(static_cast<uint8_t>(bits_));
+      bits_ = 0;
+      count_ = 0;
+    }
+  }
+
+ private:
+  std::vector<uint8_t>& out_;
+  uint64_t bits_ = 0;
+  int count_ = 0;
+};
+
+uint32_t Hash3(const uint8_t* p) {
+  const uint32_t v = (uint32_t{p[0]} << 16) | (uint32_t{p[1]} << 8) | p[2];
+  return (v * 2654435761U) >> (32 - kHashBits);
+}
+
+void WriteFixedSymbol(BitWriter& out, uint32_t symbol) {
+  if (symbol < 144) {
+    out.WriteCode(0x30U + symbol, 8);
+  } else if (symbol < 256) {
+    out.WriteCode(0x190U + symbol - 144, 9);
+  } else if (symbol < 280) {
+    out.WriteCode(symbol - 256, 7);
+  } else {
+    out.WriteCode(0xC0U + symbol - 280, 8);
+  }
+}
+
+void WriteMatch(BitWriter& out, size_t length, size_t distance) {
+  size_t l = kLengthBase.size() - 1;
+  while (kLengthBase[l] > length) {
+    --l;
+  }
+  WriteFixedSymbol(out, static_cast<uint32_t>(257 + l));
+  out.Write(static_cast<uint32_t>(length - kLengthBase[l]), kLengthExtra[l]);
+  size_t d = kDistBase.size() - 1;
+  while (kDistBase[d] > distance) {
+    --d;
+  }
+  out.WriteCode(static_cast<uint32_t>(d), 5);
+  out.Write(static_cast<uint32_t>(distance - kDistBase[d]), kDistExtra[d]);
+}
+
+// One final block with the fixed codes. Matches are taken greedily; chains are capped rather than
+// pruned when the window slides, so a stale link only costs a wasted comparison.
+void DeflateFixed(const uint8_t* src, size_t size, std::vector<uint8_t>& out) {
+  BitWriter bits(out);
+  bits.Write(1, 1);
+  bits.Write(1, 2);
+  std::vector<int32_t> head(size_t{1} << kHashBits, -1);
+  std::vector<int32_t> prev(kWindowSize, -1);
+  const auto insert = [&](size_t pos) {
+    if (pos + kMinMatch <= size) {
+      const uint32_t h = Hash3(src + pos);
+      prev[pos & (kWindowSize - 1)] = head[h];
+      head[h] = static_cast<int32_t>(pos);
+    }
+  };
+  size_t i = 0;
+  while (i < size) {
+    size_t bestLength = 0;
+    size_t bestDistance = 0;
+    if (i + kMinMatch <= size) {
+      const size_t limit = std::min(kMaxMatch, size - i);
+      int32_t candidate = head[Hash3(src + i)];
+      for (int chain = 0; candidate >= 0 && chain < kMaxChain; ++chain) {
+        const size_t from = static_cast<size_t>(candidate);
+        if (from >= i || i - from > kWindowSize) {
+          break;
+        }
+        size_t length = 0;
+        while (length < limit && src[from + length] == src[i + length]) {
+          ++length;
+        }
+        if (length > bestLength) {
+          bestLength = length;
+          bestDistance = i - from;
+          if (length == limit) {
+            break;
+          }
+        }
+        candidate = prev[from & (kWindowSize - 1)];
+      }
+    }
+    if (bestLength >= kMinMatch) {
+      WriteMatch(bits, bestLength, bestDistance);
+      for (size_t k = 0; k < bestLength; ++k) {
+        insert(i + k);
+      }
+      i += bestLength;
+    } else {
+      WriteFixedSymbol(bits, src[i]);
+      insert(i);
+      ++i;
+    }
+  }
+  WriteFixedSymbol(bits, 256);
+  bits.Flush();
+}
+
+void DeflateStored(const uint8_t* src, size_t size, std::vector<uint8_t>& out) {
+  size_t offset = 0;
+  do {
+    const size_t length = std::min<size_t>(0xFFFF, size - offset);
+    out.push_back(offset + length == size ? 1 : 0);
+    out.push_back(static_cast<uint8_t>(length));
+    out.push_back(static_cast<uint8_t>(length >> 8));
+    out.push_back(static_cast<uint8_t>(~length));
+    out.push_back(static_cast<uint8_t>(~length >> 8));
+    if (length > 0) {
+      out.insert(out.end(), src + offset, src + offset + length);
+    }
+    offset += length;
+  } while (offset < size);
+}
+
+}  // namespace
+
+bool InflateZlib(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+  if (srcSize < 6) {
+    return false;
+  }
+  const uint32_t cmf = src[0];
+  const uint32_t flg = src[1];
+  if ((cmf & 15U) != 8 || (cmf >> 4) > 7 || ((cmf << 8) | flg) % 31 != 0 || (flg & 0x20U) != 0) {
+    return false;  // not deflate, window over 32K, bad header check, or a preset dictionary
+  }
+  BitReader in(src + 2, srcSize - 6);
+  Huffman lit;
+  Huffman dist;
+  size_t out = 0;
+  bool last = false;
+  while (!last) {
+    last = in.Read(1) != 0;
+    const uint32_t type = in.Read(2);
+    if (type == 0) {
+      in.AlignToByte();
+      const uint32_t len = in.Read(16);
+      const uint32_t nlen = in.Read(16);
+      if (in.Overrun() || (len ^ 0xFFFFU) != nlen || len > dstSize - out) {
+        return false;
+      }
+      for (uint32_t i = 0; i < len; ++i) {
+        dst[out++] = static_cast<uint8_t>(in.Read(8));
+      }
+    } else if (type == 1) {
+      if (!BuildFixed(lit, dist) || !InflateBlock(in, lit, dist, dst, dstSize, out)) {
+        return false;
+      }
+    } else if (type == 2) {
+      if (!BuildDynamic(in, lit, dist) || !InflateBlock(in, lit, dist, dst, dstSize, out)) {
+        return false;
+      }
+    } else {
+      return false;
+    }
+    if (in.Overrun()) {
+      return false;
+    }
+  }
+  if (out != dstSize) {
+    return false;
+  }
+  const uint8_t* trailer = src + srcSize - 4;
+  const uint32_t expected = (uint32_t{trailer[0]} << 24) | (uint32_t{trailer[1]} << 16) | (uint32_t{trailer[2]} << 8) | trailer[3];
+  return Adler32(dst, dstSize) == expected;
+}
+
+std::vector<uint8_t> DeflateZlib(const uint8_t* src, size_t srcSize) {
+  std::vector<uint8_t> out = {0x78, 0x01};  // deflate, 32K window, fastest-level hint
+  DeflateFixed(src, srcSize, out);
+  const size_t storedSize = 2 + srcSize + 5 * std::max<size_t>(1, (srcSize + 0xFFFE) / 0xFFFF);
+  if (out.size() > storedSize) {
+    out.resize(2);
+    DeflateStored(src, srcSize, out);
+  }
+  const uint32_t adler = Adler32(src, srcSize);
+  for (int shift = 24; shift >= 0; shift -= 8) {
+    out.push_back(static_cast<uint8_t>(adler >> shift));
+  }
+  return out;
+}
+
+}  // namespace vv
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vv {
+
+// Decodes one zlib stream (RFC 1950 wrapper around RFC 1951 DEFLATE) into `dst`, which must be
+// exactly the decoded size: formats that embed zlib (FBX arrays) store it next to the stream.
+// False on malformed input, a checksum mismatch, or output that does not fill `dst` exactly.
+// Stateless and allocation-free, so separate streams can be inflated on separate threads.
+bool InflateZlib(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+// Encodes `src` as one zlib stream InflateZlib (or any zlib) can decode: greedy LZ77 over a 32K
+// window with hash chains, emitted with the fixed Huffman codes, or as stored blocks when that
+// comes out smaller. Meant for cook-time writers, where a dependency-free encoder matters more
+// than the last few percent of ratio.
+std::vector<uint8_t> DeflateZlib(const uint8_t* src, size_t srcSize);
+
+}  // namespace vv
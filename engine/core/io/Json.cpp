@@ -0,0 +1,313 @@
+#include "core/io/Json.hpp"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace vv {
+namespace {
+
+// Arrays and objects nest on the call stack; deeper documents are rejected, not overflowed.
+constexpr int kMaxDepth = 256;
+
+class JsonParser {
+ public:
+  explicit JsonParser(std::string_view text) : text_(text) {}
+
+  bool ParseDocument(JsonValue& out) {
+    SkipWhitespace();
+    if (!ParseValue(out, 0)) {
+      return false;
+    }
+    SkipWhitespace();
+    return pos_ == text_.size() || Fail("trailing characters");
+  }
+
+  [[nodiscard]] std::string Error() const { return error_ + " at offset " + std::to_string(pos_); }
+
+ private:
+  bool Fail(const char* message) {
+    if (error_.empty()) {
+      error_ = message;
+    }
+    return false;
+  }
+
+  void SkipWhitespace() {
+    while (pos_ < text_.size() &&
+           (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' || text_[pos_] == '\r')) {
+      ++pos_;
+    }
+  }
+
+  bool Consume(char c) {
+    SkipWhitespace();
+    if (pos_ < text_.size() && text_[pos_] == c) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+
+  bool ConsumeLiteral(std::string_view literal) {
+    if (text_.substr(pos_, literal.size()) != literal) {
+      return Fail("invalid literal");
+    }
+    pos_ += literal.size();
+    return true;
+  }
+
+  bool ParseValue(JsonValue& out, int depth) {
+    if (depth > kMaxDepth) {
+      return Fail("nesting too deep");
+    }
+    SkipWhitespace();
+    if (pos_ >= text_.size()) {
+      return Fail("unexpected end");
+    }
+    switch (text_[pos_]) {
+      case '{':
+        return ParseObject(out, depth);
+      case '[':
+        return ParseArray(out, depth);
+      case '"':
+        out.kind = JsonKind::kString;
+        return ParseString(out.string);
+      case 't':
+        out.kind = JsonKind::kBool;
+        out.boolean = true;
+        return ConsumeLiteral("true");
+      case 'f':
+        out.kind = JsonKind::kBool;
+        out.boolean = false;
+        return ConsumeLiteral("false");
+      case 'n':
+        out.kind = JsonKind::kNull;
+        return ConsumeLiteral("null");
+      default:
+        return ParseNumber(out);
+    }
+  }
+
+  bool ParseObject(JsonValue& out, int depth) {
+    out.kind = JsonKind::kObject;
+    ++pos_;
+    if (Consume('}')) {
+      return true;
+    }
+    do {
+      SkipWhitespace();
+      std::string key;
+      if (pos_ >= text_.size() || text_[pos_] != '"' || !ParseString(key)) {
+        return Fail("expected member name");
+      }
+      if (!Consume(':')) {
+        return Fail("expected ':'");
+      }
+      out.members.emplace_back(std::move(key), JsonValue{});
+      if (!ParseValue(out.members.back().second, depth + 1)) {
+        return false;
+      }
+    } while (Consume(','));
+    return Consume('}') || Fail("expected '}'");
+  }
+
+  bool ParseArray(JsonValue& out, int depth) {
+    out.kind = JsonKind::kArray;
+    ++pos_;
+    if (Consume(']')) {
+      return true;
+    }
+    do {
+      out.items.emplace_back();
+      if (!ParseValue(out.items.back(), depth + 1)) {
+        return false;
+      }
+    } while (Consume(','));
+    return Consume(']') || Fail("expected ']'");
+  }
+
+  bool ParseHex4(uint32_t& out) {
+    if (pos_ + 4 > text_.size()) {
+      return Fail("truncated escape");
+    }
+    out = 0;
+    for (int i = 0; i < 4; ++i) {
+      const char c = text_[pos_++];
+      out <<= 4U;
+      if (c >= '0' && c <= '9') {
+        out |= static_cast<uint32_t>(c - '0');
+      } else if (c >= 'a' && c <= 'f') {
+        out |= static_cast<uint32_t>(c - 'a' + 10);
+      } else if (c >= 'A' && c <= 'F') {
+        out |= static_cast<uint32_t>(c - 'A' + 10);
+      } else {
+        return Fail("invalid escape");
+      }
+    }
+    return true;
+  }
+
+  static void AppendUtf8(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+      out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+      out += static_cast<char>(0xC0 | (cp >> 6U));
+      out += static_cast<char>(0x80 | (cp & 0x3FU));
+    } else if (cp < 0x10000) {
+      out += static_cast<char>(0xE0 | (cp >> 12U));
+      out += static_cast<char>(0x80 | ((cp >> 6U) & 0x3FU));
+      out += static_cast<char>(0x80 | (cp & 0x3FU));
+    } else {
+      out += static_cast<char>(0xF0 | (cp >> 18U));
+      out += static_cast<char>(0x80 | ((cp >> 12U) & 0x3FU));
+      out += static_cast<char>(0x80 | ((cp >> 6U) & 0x3FU));
+      out += static_cast<char>(0x80 | (cp & 0x3FU));
+    }
+  }
+
+  bool ParseString(std::string& out) {
+    ++pos_;  // opening quote
+    while (pos_ < text_.size()) {
+      const char c = text_[pos_++];
+      if (c == '"') {
+        return true;
+      }
+      if (static_cast<unsigned char>(c) < 0x20) {
+        return Fail("control character in string");
+      }
+      if (c != '\\') {
+        out += c;
+        continue;
+      }
+      if (pos_ >= text_.size()) {
+        break;
+      }
+      const char e = text_[pos_++];
+      switch (e) {
+        case '"':
+        case '\\':
+        case '/':
+          out += e;
+          break;
+        case 'b':
+          out += '\b';
+          break;
+        case 'f':
+          out += '\f';
+          break;
+        case 'n':
+          out += '\n';
+          break;
+        case 'r':
+          out += '\r';
+          break;
+        case 't':
+          out += '\t';
+          break;
+        case 'u': {
+          uint32_t cp = 0;
+          if (!ParseHex4(cp)) {
+            return false;
+          }
+          if (cp >= 0xD800 && cp <= 0xDBFF && text_.substr(pos_, 2) == "\\u") {
+            pos_ += 2;
+            uint32_t low = 0;
+            if (!ParseHex4(low) || low < 0xDC00 || low > 0xDFFF) {
+              return Fail("invalid surrogate pair");
+            }
+            cp = 0x10000 + ((cp - 0xD800) << 10U) + (low - 0xDC00);
+          }
+          AppendUtf8(out, cp);
+          break;
+        }
+        default:
+          return Fail("invalid escape");
+      }
+    }
+    return Fail("unterminated string");
+  }
+
+  bool ParseNumber(JsonValue& out) {
+    const size_t start = pos_;
+    if (pos_ < text_.size() && text_[pos_] == '-') {
+      ++pos_;
+    }
+    const auto digits = [&]() {
+      const size_t first = pos_;
+      while (pos_ < text_.size() && text_[pos_] >= '0' && text_[pos_] <= '9') {
+        ++pos_;
+      }
+      return pos_ > first;
+    };
+    if (!digits()) {
+      return Fail("invalid value");
+    }
+    if (pos_ < text_.size() && text_[pos_] == '.') {
+      ++pos_;
+      if (!digits()) {
+        return Fail("invalid number");
+      }
+    }
+    if (pos_ < text_.size() && (text_[pos_] == 'e' || text_[pos_] == 'E')) {
+      ++pos_;
+      if (pos_ < text_.size() && (text_[pos_] == '+' || text_[pos_] == '-')) {
+        ++pos_;
+      }
+      if (!digits()) {
+        return Fail("invalid number");
+      }
+    }
+    // strtod needs a terminated string; numbers are short, so the copy is cheap.
+    const std::string token(text_.substr(start, pos_ - start));
+    out.kind = JsonKind::kNumber;
+    out.number = std::strtod(token.c_str(), nullptr);
+    return true;
+  }
+
+  std::string_view text_;
+  size_t pos_ = 0;
+  std::string error_;
+};
+
+const JsonValue& NullValue() {
+  static const JsonValue kNull;
+  return kNull;
+}
+
+}  // namespace
+
+const JsonValue& JsonValue::operator[](std::string_view key) const {
+  for (const auto& [name, value] : members) {
+    if (name == key) {
+      return value;
+    }
+  }
+  return NullValue();
+}
+
+const JsonValue& JsonValue::operator[](size_t index) const {
+  return index < items.size() ? items[index] : NullValue();
+}
+
+uint64_t JsonValue::Index(uint64_t fallback) const {
+  if (kind != JsonKind::kNumber || !(number >= 0.0) || number > 9007199254740992.0 || std::floor(number) != number) {
+    return fallback;
+  }
+  return static_cast<uint64_t>(number);
+}
+
+const std::string& JsonValue::String() const {
+  static const std::string kEmpty;
+  return kind == JsonKind::kString ? string : kEmpty;
+}
+
+LoadResult<JsonValue> ParseJson(std::string_view text) {
+  JsonParser parser(text);
+  JsonValue root;
+  if (!parser.ParseDocument(root)) {
+    return LoadResult<JsonValue>{.value = std::nullopt, .error = "invalid JSON: " + parser.Error()};
+  }
+  return LoadResult<JsonValue>{.value = std::move(root), .error = {}};
+}
+
+}  // namespace vv
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "core/types/CommonTypes.hpp"
+
+namespace vv {
+
+enum class JsonKind : uint8_t {
+  kNull,
+  kBool,
+  kNumber,
+  kString,
+  kArray,
+  kObject,
+};
+
+// A parsed JSON document node. Lookups never fail: a missing member, an index past the end or a
+// value of the wrong kind reads as null or as the given fallback, so readers of optional fields
+// need no checks.
+struct JsonValue {
+  JsonKind kind = JsonKind::kNull;
+  bool boolean = false;
+  double number = 0.0;
+  std::string string;
+  std::vector<JsonValue> items;                            // arrays
+  std::vector<std::pair<std::string, JsonValue>> members;  // objects, in document order
+
+  [[nodiscard]] bool IsNull() const { return kind == JsonKind::kNull; }
+  [[nodiscard]] bool IsArray() const { return kind == JsonKind::kArray; }
+  [[nodiscard]] bool IsObject() const { return kind == JsonKind::kObject; }
+  [[nodiscard]] bool Has(std::string_view key) const { return !(*this)[key].IsNull(); }
+  [[nodiscard]] size_t Size() const { return items.size(); }
+
+  const JsonValue& operator[](std::string_view key) const;
+  const JsonValue& operator[](size_t index) const;
+
+  [[nodiscard]] bool Bool(bool fallback) const { return kind == JsonKind::kBool ? boolean : fallback; }
+  [[nodiscard]] double Number(double fallback) const { return kind == JsonKind::kNumber ? number : fallback; }
+  [[nodiscard]] float Float(float fallback) const { return static_cast<float>(Number(fallback)); }
+  // Non-negative integral numbers only; anything else is `fallback`.
+  [[nodiscard]] uint64_t Index(uint64_t fallback) const;
+  [[nodiscard]] const std::string& String() const;
+};
+
+// RFC 8259 text to a document; \u escapes (surrogate pairs included) are decoded to UTF-8.
+LoadResult<JsonValue> ParseJson(std::string_view text);
+
+}  // namespace vv
@@ -0,0 +1,89 @@
+#include "core/io/MappedFile.hpp"
+
+#include <fstream>
+#include <utility>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vv {
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      mapped_(std::exchange(other.mapped_, false)),
+      fallback_(std::move(other.fallback_)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    Close();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    mapped_ = std::exchange(other.mapped_, false);
+    fallback_ = std::move(other.fallback_);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() {
+  Close();
+}
+
+bool MappedFile::Open(const std::string& path) {
+  Close();
+#if defined(__unix__) || defined(__APPLE__)
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  struct stat info {};
+  if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+    ::close(fd);
+    return false;
+  }
+  void* mapping = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);  // the mapping keeps the file referenced
+  if (mapping != MAP_FAILED) {
+    data_ = static_cast<const uint8_t*>(mapping);
+    size_ = static_cast<size_t>(info.st_size);
+    mapped_ = true;
+    return true;
+  }
+#endif
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    return false;
+  }
+  const std::streamsize size = file.tellg();
+  if (size <= 0) {
+    return false;
+  }
+  fallback_.resize(static_cast<size_t>(size));
+  file.seekg(0);
+  if (!file.read(reinterpret_cast<char*>(fallback_.data()), size)) {
+    fallback_.clear();
+    return false;
+  }
+  data_ = fallback_.data();
+  size_ = fallback_.size();
+  return true;
+}
+
+void MappedFile::Close() {
+#if defined(__unix__) || defined(__APPLE__)
+  if (mapped_) {
+    ::munmap(const_cast<uint8_t*>(data_), size_);
+  }
+#endif
+  data_ = nullptr;
+  size_ = 0;
+  mapped_ = false;
+  fallback_.clear();
+  fallback_.shrink_to_fit();
+}
+
+}  // namespace vv
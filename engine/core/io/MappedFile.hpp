@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vv {
+
+// Read-only view of a whole file. Mapped where the platform supports it, so parsers can point
+// into the file without copying it and untouched pages never become resident; elsewhere, or when
+// mapping fails, the file is read into memory behind the same interface.
+class MappedFile {
+ public:
+  MappedFile() = default;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  // False when the file cannot be opened or is empty.
+  bool Open(const std::string& path);
+  void Close();
+
+  [[nodiscard]] const uint8_t* Data() const { return data_; }
+  [[nodiscard]] size_t Size() const { return size_; }
+  [[nodiscard]] bool IsOpen() const { return data_ != nullptr; }
+  [[nodiscard]] bool IsMapped() const { return mapped_; }
+
+ private:
+  const uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  bool mapped_ = false;
+  std::vector<uint8_t> fallback_;
+};
+
+}  // namespace vv
@@ -0,0 +1,143 @@
+#include "core/memory/PixelBuffer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace vv {
+namespace {
+
+std::atomic<uint64_t> g_allocations{0};
+std::atomic<uint64_t> g_allocatedBytes{0};
+std::atomic<uint64_t> g_copies{0};
+std::atomic<uint64_t> g_copiedBytes{0};
+
+void CountAllocation(size_t bytes) {
+  g_allocations.fetch_add(1, std::memory_order_relaxed);
+  g_allocatedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void CountCopy(size_t bytes) {
+  g_copies.fetch_add(1, std::memory_order_relaxed);
+  g_copiedBytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+}  // namespace
+
+PixelBuffer::PixelBuffer(size_t size) {
+  resize(size);
+}
+
+PixelBuffer::PixelBuffer(std::initializer_list<uint8_t> bytes) {
+  Reallocate(bytes.size());
+  std::copy(bytes.begin(), bytes.end(), data_);
+  size_ = bytes.size();
+}
+
+PixelBuffer::PixelBuffer(const PixelBuffer& other) {
+  *this = Copy(other.data_, other.size_);
+}
+
+PixelBuffer::PixelBuffer(PixelBuffer&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      capacity_(std::exchange(other.capacity_, 0)) {}
+
+PixelBuffer& PixelBuffer::operator=(const PixelBuffer& other) {
+  if (this != &other) {
+    *this = Copy(other.data_, other.size_);
+  }
+  return *this;
+}
+
+PixelBuffer& PixelBuffer::operator=(PixelBuffer&& other) noexcept {
+  if (this != &other) {
+    std::free(data_);
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    capacity_ = std::exchange(other.capacity_, 0);
+  }
+  return *this;
+}
+
+PixelBuffer::~PixelBuffer() {
+  std::free(data_);
+}
+
+PixelBuffer PixelBuffer::Adopt(uint8_t* data, size_t size) {
+  PixelBuffer buffer;
+  buffer.data_ = data;
+  buffer.size_ = data != nullptr ? size : 0;
+  buffer.capacity_ = buffer.size_;
+  return buffer;
+}
+
+PixelBuffer PixelBuffer::Copy(const uint8_t* data, size_t size, size_t capacity) {
+  PixelBuffer buffer;
+  buffer.Reallocate(std::max(size, capacity));
+  if (size > 0) {
+    std::memcpy(buffer.data_, data, size);
+    CountCopy(size);
+  }
+  buffer.size_ = size;
+  return buffer;
+}
+
+void PixelBuffer::reserve(size_t capacity) {
+  if (capacity > capacity_) {
+    Reallocate(capacity);
+  }
+}
+
+void PixelBuffer::resize(size_t size) {
+  reserve(size);
+  if (size > size_) {
+    std::memset(data_ + size_, 0, size - size_);
+  }
+  size_ = size;
+}
+
+void PixelBuffer::clear() {
+  std::free(data_);
+  data_ = nullptr;
+  size_ = 0;
+  capacity_ = 0;
+}
+
+bool PixelBuffer::operator==(const PixelBuffer& other) const {
+  return size_ == other.size_ && (size_ == 0 || std::memcmp(data_, other.data_, size_) == 0);
+}
+
+void PixelBuffer::Reallocate(size_t capacity) {
+  if (capacity == 0) {
+    return;
+  }
+  auto* grown = static_cast<uint8_t*>(std::realloc(data_, capacity));
+  if (grown == nullptr) {
+    throw std::bad_alloc();
+  }
+  CountAllocation(capacity);
+  data_ = grown;
+  capacity_ = capacity;
+}
+
+PixelBufferCounters GetPixelBufferCounters() {
+  PixelBufferCounters counters;
+  counters.allocations = g_allocations.load(std::memory_order_relaxed);
+  counters.allocatedBytes = g_allocatedBytes.load(std::memory_order_relaxed);
+  counters.copies = g_copies.load(std::memory_order_relaxed);
+  counters.copiedBytes = g_copiedBytes.load(std::memory_order_relaxed);
+  return counters;
+}
+
+void ResetPixelBufferCounters() {
+  g_allocations.store(0, std::memory_order_relaxed);
+  g_allocatedBytes.store(0, std::memory_order_relaxed);
+  g_copies.store(0, std::memory_order_relaxed);
+  g_copiedBytes.store(0, std::memory_order_relaxed);
+}
+
+}  // namespace vv
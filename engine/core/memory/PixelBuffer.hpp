@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+namespace vv {
+
+struct PixelBufferCounters {
+  uint64_t allocations = 0;     // malloc/realloc calls made by PixelBuffer
+  uint64_t allocatedBytes = 0;  // bytes requested by those calls
+  uint64_t copies = 0;          // deep copies between buffers
+  uint64_t copiedBytes = 0;
+};
+
+// Byte storage for texture payloads. Unlike std::vector it can adopt a malloc'd buffer (stb_image
+// output) without copying, and it grows with realloc, which large allocations usually satisfy
+// by remapping pages instead of moving them. Copies are explicit in the counters so tests can
+// assert how much pixel traffic a load path costs. The container-style member names keep it a
+// drop-in for the std::vector<uint8_t> it replaces.
+class PixelBuffer {
+ public:
+  PixelBuffer() = default;
+  explicit PixelBuffer(size_t size);  // zero-filled
+  PixelBuffer(std::initializer_list<uint8_t> bytes);
+  PixelBuffer(const PixelBuffer& other);
+  PixelBuffer(PixelBuffer&& other) noexcept;
+  PixelBuffer& operator=(const PixelBuffer& other);
+  PixelBuffer& operator=(PixelBuffer&& other) noexcept;
+  ~PixelBuffer();
+
+  // Takes ownership of `data`, which must come from std::malloc/std::realloc.
+  static PixelBuffer Adopt(uint8_t* data, size_t size);
+  // One allocation of max(size, capacity) bytes holding a copy of `data`.
+  static PixelBuffer Copy(const uint8_t* data, size_t size, size_t capacity = 0);
+
+  uint8_t* data() { return data_; }
+  const uint8_t* data() const { return data_; }
+  size_t size() const { return size_; }
+  size_t capacity() const { return capacity_; }
+  bool empty() const { return size_ == 0; }
+
+  uint8_t& operator[](size_t index) { return data_[index]; }
+  const uint8_t& operator[](size_t index) const { return data_[index]; }
+  uint8_t* begin() { return data_; }
+  uint8_t* end() { return data_ + size_; }
+  const uint8_t* begin() const { return data_; }
+  const uint8_t* end() const { return data_ + size_; }
+
+  void reserve(size_t capacity);
+  void resize(size_t size);  // new bytes are zeroed
+  void clear();              // also releases the memory
+
+  bool operator==(const PixelBuffer& other) const;
+
+ private:
+  void Reallocate(size_t capacity);
+
+  uint8_t* data_ = nullptr;
+  size_t size_ = 0;
+  size_t capacity_ = 0;
+};
+
+PixelBufferCounters GetPixelBufferCounters();
+void ResetPixelBufferCounters();
+
+}  // namespace vv
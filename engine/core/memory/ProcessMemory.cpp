@@ -0,0 +1,66 @@
+#include "core/memory/ProcessMemory.hpp"
+
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#include <malloc/malloc.h>
+#include <sys/resource.h>
+#elif defined(__linux__)
+#include <cstdio>
+#include <malloc.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+namespace vv {
+
+ProcessMemoryStats QueryProcessMemory() {
+  ProcessMemoryStats stats;
+#if defined(__APPLE__)
+  mach_task_basic_info_data_t info{};
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) == KERN_SUCCESS) {
+    stats.residentBytes = info.resident_size;
+  }
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    stats.peakResidentBytes = static_cast<uint64_t>(usage.ru_maxrss);  // bytes on macOS
+  }
+#elif defined(__linux__)
+  if (FILE* statm = std::fopen("/proc/self/statm", "r")) {
+    unsigned long sizePages = 0;
+    unsigned long residentPages = 0;
+    if (std::fscanf(statm, "%lu %lu", &sizePages, &residentPages) == 2) {
+      stats.residentBytes = static_cast<uint64_t>(residentPages) * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    }
+    std::fclose(statm);
+  }
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) == 0) {
+    stats.peakResidentBytes = static_cast<uint64_t>(usage.ru_maxrss) * 1024;  // KiB on Linux
+  }
+#endif
+  return stats;
+}
+
+uint64_t QueryHeapInUseBytes() {
+#if defined(__APPLE__)
+  malloc_statistics_t stats{};
+  malloc_zone_statistics(nullptr, &stats);  // null zone: summed over every zone
+  return stats.size_in_use;
+#elif defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+  const struct mallinfo2 info = mallinfo2();
+  return static_cast<uint64_t>(info.uordblks) + static_cast<uint64_t>(info.hblkhd);
+#else
+  return 0;
+#endif
+}
+
+void ReturnFreeHeapMemory() {
+#if defined(__APPLE__)
+  malloc_zone_pressure_relief(nullptr, 0);
+#elif defined(__GLIBC__)
+  malloc_trim(0);
+#endif
+}
+
+}  // namespace vv
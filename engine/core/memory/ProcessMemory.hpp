@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vv {
+
+struct ProcessMemoryStats {
+  uint64_t residentBytes = 0;      // current RSS
+  uint64_t peakResidentBytes = 0;  // high-water mark since process start
+};
+
+// Zeros on platforms without a query.
+ProcessMemoryStats QueryProcessMemory();
+
+// Bytes currently allocated from the malloc heap, all threads and mmapped blocks included.
+// Cheap enough to sample around import stages; 0 when the allocator offers no statistics.
+uint64_t QueryHeapInUseBytes();
+
+// Hands free heap pages back to the system, so RSS reflects memory just released; no-op where the
+// allocator offers no way to do it.
+void ReturnFreeHeapMemory();
+
+}  // namespace vv
@@ -0,0 +1,39 @@
+#include "core/thread/ParallelFor.hpp"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+namespace vv {
+
+size_t WorkerThreadCount() {
+  return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+void ParallelFor(size_t count, size_t minChunk, const std::function<void(size_t begin, size_t end)>& fn) {
+  if (count == 0) {
+    return;
+  }
+  const size_t chunkCount = std::clamp<size_t>(count / std::max<size_t>(minChunk, 1), 1, WorkerThreadCount());
+  if (chunkCount == 1) {
+    fn(0, count);
+    return;
+  }
+
+  const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+  std::vector<std::thread> workers;
+  workers.reserve(chunkCount - 1);
+  for (size_t chunk = 1; chunk < chunkCount; ++chunk) {
+    const size_t begin = chunk * chunkSize;
+    const size_t end = std::min(count, begin + chunkSize);
+    if (begin < end) {
+      workers.emplace_back([&fn, begin, end] { fn(begin, end); });
+    }
+  }
+  fn(0, std::min(count, chunkSize));
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+}  // namespace vv
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace vv {
+
+// Splits [0, count) into contiguous chunks of at least `minChunk` items and runs `fn(begin, end)`
+// on up to hardware_concurrency threads, the caller included. Returns once every chunk is done.
+void ParallelFor(size_t count, size_t minChunk, const std::function<void(size_t begin, size_t end)>& fn);
+
+size_t WorkerThreadCount();
+
+}  // namespace vv
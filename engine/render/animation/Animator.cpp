@@ -79,11 +79,52 @@ void Animator::Bind(const Scene* scene, SkeletonId skeletonId) {
   scene_ = scene;
   skeletonId_ = skeletonId;
   palette_.clear();
-  if (scene_ != nullptr && skeletonId_ < scene_->skeletons.size()) {
-    palette_.resize(scene_->skeletons[skeletonId_].bones.size(), Mat4(1.0F));
+  usedBones_.clear();
+  if (scene_ == nullptr || skeletonId_ >= scene_->skeletons.size()) {
+    return;
+  }
+  const size_t boneCount = scene_->skeletons[skeletonId_]->bones.size();
+  palette_.resize(boneCount, Mat4(1.0F));
+  usedBones_.resize(boneCount, 0);
+  bool anySkin = false;
+  for (const Skin& skin : scene_->skins) {
+    if (skin.skeleton != skeletonId_) {
+      continue;
+    }
+    anySkin = true;
+    if (skin.joints.empty()) {
+      std::fill(usedBones_.begin(), usedBones_.end(), 1);
+      break;
+    }
+    for (const uint32_t bone : skin.joints) {
+      if (bone < boneCount) {
+        usedBones_[bone] = 1;
+      }
+    }
+  }
+  // A skeleton nothing skins with still gets its full palette, for callers reading it directly.
+  if (!anySkin) {
+    std::fill(usedBones_.begin(), usedBones_.end(), 1);
+  }
+}
+
+void Animator::AppendSkinPalette(const Skin& skin, std::vector<Mat4>& out) const {
+  if (skin.joints.empty()) {
+    out.insert(out.end(), palette_.begin(), palette_.end());
+    return;
+  }
+  for (const uint32_t bone : skin.joints) {
+    out.push_back(bone < palette_.size() ? palette_[bone] : Mat4(1.0F));
   }
 }
 
+float Animator::ClipTime() const {
+  if (scene_ == nullptr || state_.clip >= scene_->clips.size()) {
+    return 0.0F;
+  }
+  return WrapTime(state_.timeSec, scene_->clips[state_.clip]->durationSec, state_.loop);
+}
+
 void Animator::SetClip(ClipId id, bool loop) {
   state_.clip = id;
   state_.loop = loop;
@@ -178,7 +219,9 @@ void Animator::Update(float dtSec) {
     } else {
       global[i] = global[static_cast<size_t>(parent)] * local[i];
     }
-    palette_[i] = global[i] * skeleton.bones[i].inverseBind;
+    if (usedBones_[i] != 0) {
+      palette_[i] = global[i] * skeleton.bones[i].inverseBind;
+    }
   }
 }
 
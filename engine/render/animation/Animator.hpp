@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 
 #include "render/scene/SceneTypes.hpp"
@@ -25,8 +26,15 @@ class Animator {
   void Update(float dtSec);
 
   [[nodiscard]] const AnimatorState& State() const { return state_; }
+  // Where the current clip is sampled: State().timeSec wrapped (or clamped) to the clip.
+  [[nodiscard]] float ClipTime() const;
+  // Indexed by skeleton bone; only bones some skin of this skeleton uses are computed, the rest
+  // stay identity.
   [[nodiscard]] const std::vector<Mat4>& Palette() const { return palette_; }
 
+  // Appends the matrices `skin` (of this skeleton) is drawn with, in its local joint order.
+  void AppendSkinPalette(const Skin& skin, std::vector<Mat4>& out) const;
+
  private:
   [[nodiscard]] Transform SampleNodeTransform(const AnimationClip& clip, NodeId nodeId, float timeSec) const;
 
@@ -34,6 +42,7 @@ class Animator {
   SkeletonId skeletonId_ = 0;
   AnimatorState state_{};
   std::vector<Mat4> palette_;
+  std::vector<uint8_t> usedBones_;
 };
 
 }  // namespace vv
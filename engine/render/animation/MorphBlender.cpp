@@ -0,0 +1,181 @@
+#include "render/animation/MorphBlender.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/geometric.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define VV_MORPH_SSE2 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define VV_MORPH_NEON 1
+#endif
+
+namespace vv {
+namespace {
+
+constexpr float kSnorm16Max = 32767.0F;
+constexpr float kMinWeight = 1e-4F;  // weights below this leave a target inactive
+
+// acc[vertices[i]] += q[i] * scale. The dequantization runs four entries at a time; the adds stay
+// scalar because the vertices scatter. int16 to float is exact, so every path rounds the same.
+void AccumulateDeltas(const uint32_t* vertices, const int16_t* q, size_t count, float scale, float* acc) {
+  size_t i = 0;
+#if defined(VV_MORPH_SSE2) || defined(VV_MORPH_NEON)
+  alignas(16) float lanes[4];
+#if defined(VV_MORPH_SSE2)
+  const __m128 s = _mm_set1_ps(scale);
+#else
+  const float32x4_t s = vdupq_n_f32(scale);
+#endif
+  for (; i + 4 <= count; i += 4) {
+#if defined(VV_MORPH_SSE2)
+    const __m128i packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(q + i));
+    const __m128i wide = _mm_srai_epi32(_mm_unpacklo_epi16(packed, packed), 16);
+    _mm_store_ps(lanes, _mm_mul_ps(_mm_cvtepi32_ps(wide), s));
+#else
+    vst1q_f32(lanes, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vld1_s16(q + i))), s));
+#endif
+    acc[vertices[i]] += lanes[0];
+    acc[vertices[i + 1]] += lanes[1];
+    acc[vertices[i + 2]] += lanes[2];
+    acc[vertices[i + 3]] += lanes[3];
+  }
+#endif
+  for (; i < count; ++i) {
+    acc[vertices[i]] += static_cast<float>(q[i]) * scale;
+  }
+}
+
+bool UsableTarget(const MorphTarget& target, size_t vertexCount) {
+  const size_t count = target.vertices.size();
+  for (int c = 0; c < 3; ++c) {
+    if (target.positionDeltas[c].size() != count ||
+        (!target.normalDeltas[0].empty() && target.normalDeltas[c].size() != count)) {
+      return false;
+    }
+  }
+  return std::all_of(target.vertices.begin(), target.vertices.end(), [&](uint32_t v) { return v < vertexCount; });
+}
+
+}  // namespace
+
+const MorphWeightTrack* FindMorphTrack(const AnimationClip& clip, NodeId node) {
+  for (const MorphWeightTrack& track : clip.morphTracks) {
+    if (track.node == node) {
+      return &track;
+    }
+  }
+  return nullptr;
+}
+
+void SampleMorphWeights(const MorphWeightTrack& track, float timeSec, std::vector<float>& weights) {
+  weights.assign(track.targets, 0.0F);
+  const size_t keyCount = track.targets > 0 ? std::min(track.times.size(), track.weights.size() / track.targets) : 0;
+  if (keyCount == 0) {
+    return;
+  }
+  const auto key = [&](size_t k) { return track.weights.begin() + static_cast<std::ptrdiff_t>(k * track.targets); };
+  if (keyCount == 1 || timeSec <= track.times[0]) {
+    std::copy(key(0), key(1), weights.begin());
+    return;
+  }
+  if (timeSec >= track.times[keyCount - 1]) {
+    std::copy(key(keyCount - 1), key(keyCount), weights.begin());
+    return;
+  }
+  const auto next = std::upper_bound(track.times.begin(), track.times.begin() + static_cast<std::ptrdiff_t>(keyCount), timeSec);
+  const size_t k = static_cast<size_t>(next - track.times.begin()) - 1;
+  const float interval = track.times[k + 1] - track.times[k];
+  const float alpha = interval > 0.0F ? (timeSec - track.times[k]) / interval : 0.0F;
+  for (uint32_t t = 0; t < track.targets; ++t) {
+    const float a = track.weights[k * track.targets + t];
+    const float b = track.weights[(k + 1) * track.targets + t];
+    weights[t] = a + (b - a) * alpha;
+  }
+}
+
+void MorphBlender::Bind(const Mesh* mesh) {
+  mesh_ = mesh;
+  moved_.clear();
+  previous_.clear();
+  usable_.clear();
+  if (mesh_ == nullptr) {
+    vertices_.clear();
+    return;
+  }
+  const size_t vertexCount = mesh_->vertices.size();
+  vertices_ = mesh_->vertices;
+  stamp_.assign(vertexCount, 0);
+  for (int c = 0; c < 3; ++c) {
+    position_[c].assign(vertexCount, 0.0F);
+    normal_[c].assign(vertexCount, 0.0F);
+  }
+  for (const MorphTarget& target : mesh_->morphTargets) {
+    usable_.push_back(UsableTarget(target, vertexCount) ? 1 : 0);
+  }
+}
+
+void MorphBlender::Apply(const std::vector<float>& weights) {
+  if (mesh_ == nullptr) {
+    return;
+  }
+  previous_.swap(moved_);
+  moved_.clear();
+
+  bool turnsNormals = false;
+  const size_t targetCount = std::min(weights.size(), mesh_->morphTargets.size());
+  for (size_t t = 0; t < targetCount; ++t) {
+    const float weight = weights[t];
+    if (std::fabs(weight) <= kMinWeight || usable_[t] == 0) {
+      continue;
+    }
+    const MorphTarget& target = mesh_->morphTargets[t];
+    for (const uint32_t v : target.vertices) {
+      if (stamp_[v] == 0) {
+        stamp_[v] = 1;
+        moved_.push_back(v);
+      }
+    }
+    const size_t count = target.vertices.size();
+    for (int c = 0; c < 3; ++c) {
+      AccumulateDeltas(target.vertices.data(), target.positionDeltas[c].data(), count,
+                       weight * target.positionScale[c] / kSnorm16Max, position_[c].data());
+    }
+    if (!target.normalDeltas[0].empty()) {
+      turnsNormals = true;
+      for (int c = 0; c < 3; ++c) {
+        AccumulateDeltas(target.vertices.data(), target.normalDeltas[c].data(), count,
+                         weight * target.normalScale[c] / kSnorm16Max, normal_[c].data());
+      }
+    }
+  }
+
+  // Vertices only the previous weights moved go back to rest; the rest get base + sum of deltas.
+  for (const uint32_t v : previous_) {
+    if (stamp_[v] == 0) {
+      vertices_[v] = mesh_->vertices[v];
+    }
+  }
+  for (const uint32_t v : moved_) {
+    const VertexSkinned& base = mesh_->vertices[v];
+    VertexSkinned& out = vertices_[v];
+    out.position = base.position + Vec3(position_[0][v], position_[1][v], position_[2][v]);
+    if (turnsNormals) {
+      const Vec3 n = base.normal + Vec3(normal_[0][v], normal_[1][v], normal_[2][v]);
+      const float lengthSq = glm::dot(n, n);
+      out.normal = lengthSq > 1e-12F ? n / std::sqrt(lengthSq) : base.normal;
+    } else {
+      out.normal = base.normal;
+    }
+    for (int c = 0; c < 3; ++c) {
+      position_[c][v] = 0.0F;
+      normal_[c][v] = 0.0F;
+    }
+    stamp_[v] = 0;
+  }
+}
+
+}  // namespace vv
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+// Track of `node` in `clip`, or null.
+const MorphWeightTrack* FindMorphTrack(const AnimationClip& clip, NodeId node);
+
+// Weights of `track` at `timeSec`, interpolated linearly and held past either end. `weights` is
+// resized to track.targets.
+void SampleMorphWeights(const MorphWeightTrack& track, float timeSec, std::vector<float>& weights);
+
+// Applies a mesh's morph targets to its vertices on the CPU, before skinning. Each Apply touches
+// only vertices of targets with a non-zero weight, plus those the previous Apply moved, so a frame
+// costs active targets x moved vertices however large the mesh is. Deltas are dequantized four at
+// a time with SSE2 or NEON.
+class MorphBlender {
+ public:
+  void Bind(const Mesh* mesh);
+
+  // One weight per Mesh::morphTargets entry; missing weights count as zero.
+  void Apply(const std::vector<float>& weights);
+
+  // Mesh::vertices with the last weights applied.
+  [[nodiscard]] const std::vector<VertexSkinned>& Vertices() const { return vertices_; }
+  // Vertices that differ from Mesh::vertices now, in no particular order.
+  [[nodiscard]] const std::vector<uint32_t>& Moved() const { return moved_; }
+
+ private:
+  const Mesh* mesh_ = nullptr;
+  std::vector<VertexSkinned> vertices_;
+  std::vector<uint32_t> moved_;
+  std::vector<uint32_t> previous_;
+  std::vector<uint8_t> usable_;                 // per target: entries in range and complete
+  std::vector<uint8_t> stamp_;                  // 1 while a vertex is in moved_ during Apply
+  std::array<std::vector<float>, 3> position_;  // accumulated deltas per axis, zero outside Apply
+  std::array<std::vector<float>, 3> normal_;
+};
+
+}  // namespace vv
@@ -8,6 +8,7 @@
 #include <cstring>
 #include <cmath>
 #include <fstream>
+#include <optional>
 #include <stdexcept>
 #include <unordered_map>
 #include <vector>
@@ -17,6 +18,13 @@
 #include <glm/gtc/packing.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include "asset/import/MaterialPacking.hpp"
+#include "asset/mesh/VertexQuantization.hpp"
+#include "asset/residency/CpuResidency.hpp"
+#include "asset/texture/BlockCompression.hpp"
+#include "asset/texture/Ktx2.hpp"
+#include "asset/texture/MipGenerator.hpp"
+#include "asset/texture/TextureRegistry.hpp"
 #include "rhi/vulkan/VulkanCheck.hpp"
 
 namespace vv {
@@ -38,13 +46,33 @@ bool SupportsSampledTransferDst(VkPhysicalDevice physicalDevice, VkFormat format
          (features & VK_FORMAT_FEATURE_TRANSFER_DST_BIT) != 0;
 }
 
-bool SupportsLinearBlit(VkPhysicalDevice physicalDevice, VkFormat format) {
-  VkFormatProperties props{};
-  vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &props);
-  const VkFormatFeatureFlags features = props.optimalTilingFeatures;
-  return (features & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) != 0 &&
-         (features & VK_FORMAT_FEATURE_BLIT_SRC_BIT) != 0 &&
-         (features & VK_FORMAT_FEATURE_BLIT_DST_BIT) != 0;
+// Everything but the payload; upload fallbacks fill in their own pixels.
+Texture CopyTextureHeader(const Texture& texture) {
+  Texture out;
+  out.width = texture.width;
+  out.height = texture.height;
+  out.format = texture.format;
+  out.srgb = texture.srgb;
+  out.normalMap = texture.normalMap;
+  out.contentHash = texture.contentHash;
+  return out;
+}
+
+VkFormat TextureVkFormat(const Texture& texture) {
+  switch (texture.format) {
+    case PixelFormat::kBC1:
+      return texture.srgb ? VK_FORMAT_BC1_RGBA_SRGB_BLOCK : VK_FORMAT_BC1_RGBA_UNORM_BLOCK;
+    case PixelFormat::kBC3:
+      return texture.srgb ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+    case PixelFormat::kBC4:
+      return VK_FORMAT_BC4_UNORM_BLOCK;
+    case PixelFormat::kBC5:
+      return VK_FORMAT_BC5_UNORM_BLOCK;
+    case PixelFormat::kBC7:
+      return texture.srgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+    default:
+      return texture.srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+  }
 }
 
 float OutputColorLevelsForFormat(VkFormat format) {
@@ -96,69 +124,112 @@ std::vector<float> BuildProceduralIblPixels(uint32_t width, uint32_t height) {
   return pixels;
 }
 
-VkVertexInputBindingDescription MakeVertexBinding() {
-  VkVertexInputBindingDescription binding{};
-  binding.binding = 0;
-  binding.stride = sizeof(VertexSkinned);
-  binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-  return binding;
-}
-
-std::array<VkVertexInputAttributeDescription, 6> MakeVertexAttributes() {
-  std::array<VkVertexInputAttributeDescription, 6> attrs{};
-
-  attrs[0].binding = 0;
-  attrs[0].location = 0;
-  attrs[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-  attrs[0].offset = static_cast<uint32_t>(offsetof(VertexSkinned, position));
-
-  attrs[1].binding = 0;
-  attrs[1].location = 1;
-  attrs[1].format = VK_FORMAT_R32G32B32_SFLOAT;
-  attrs[1].offset = static_cast<uint32_t>(offsetof(VertexSkinned, normal));
+constexpr VkDeviceSize kPackedBoundsAlignment = 16;
 
-  attrs[2].binding = 0;
-  attrs[2].location = 2;
-  attrs[2].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-  attrs[2].offset = static_cast<uint32_t>(offsetof(VertexSkinned, tangent));
+struct PackedBoundsGpu {
+  Vec4 min{0.0F};
+  Vec4 extent{0.0F};
+};
 
-  attrs[3].binding = 0;
-  attrs[3].location = 3;
-  attrs[3].format = VK_FORMAT_R32G32_SFLOAT;
-  attrs[3].offset = static_cast<uint32_t>(offsetof(VertexSkinned, uv0));
+std::vector<VkVertexInputBindingDescription> MakeVertexBindings(VertexLayout layout) {
+  std::vector<VkVertexInputBindingDescription> bindings(1);
+  bindings[0].binding = 0;
+  bindings[0].stride = VertexStride(layout);
+  bindings[0].inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
 
-  attrs[4].binding = 0;
-  attrs[4].location = 4;
-  attrs[4].format = VK_FORMAT_R16G16B16A16_UINT;
-  attrs[4].offset = static_cast<uint32_t>(offsetof(VertexSkinned, joints));
+  if (layout != VertexLayout::kFull) {
+    // Per-mesh dequantization block; DrawPush is already at the 128-byte push constant limit.
+    VkVertexInputBindingDescription bounds{};
+    bounds.binding = 1;
+    bounds.stride = static_cast<uint32_t>(sizeof(PackedBoundsGpu));
+    bounds.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+    bindings.push_back(bounds);
+  }
+  return bindings;
+}
 
-  attrs[5].binding = 0;
-  attrs[5].location = 5;
-  attrs[5].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-  attrs[5].offset = static_cast<uint32_t>(offsetof(VertexSkinned, weights));
+VkVertexInputAttributeDescription MakeAttribute(uint32_t location, uint32_t binding, VkFormat format, size_t offset) {
+  VkVertexInputAttributeDescription attr{};
+  attr.location = location;
+  attr.binding = binding;
+  attr.format = format;
+  attr.offset = static_cast<uint32_t>(offset);
+  return attr;
+}
 
+template <typename JointT>
+std::vector<VkVertexInputAttributeDescription> MakePackedVertexAttributes(bool shadowOnly) {
+  using Packed = PackedVertexSkinned<JointT>;
+  const VkFormat jointFormat = sizeof(JointT) == 1 ? VK_FORMAT_R8G8B8A8_UINT : VK_FORMAT_R16G16B16A16_UINT;
+
+  std::vector<VkVertexInputAttributeDescription> attrs;
+  uint32_t location = 0;
+  attrs.push_back(MakeAttribute(location++, 0, VK_FORMAT_R16G16B16A16_UNORM, offsetof(Packed, position)));
+  if (!shadowOnly) {
+    attrs.push_back(MakeAttribute(location++, 0, VK_FORMAT_R16G16B16A16_SNORM, offsetof(Packed, normalTangent)));
+    attrs.push_back(MakeAttribute(location++, 0, VK_FORMAT_R16G16_SFLOAT, offsetof(Packed, uv0)));
+  }
+  attrs.push_back(MakeAttribute(location++, 0, jointFormat, offsetof(Packed, joints)));
+  attrs.push_back(MakeAttribute(location++, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(Packed, weights)));
+  attrs.push_back(MakeAttribute(location++, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(PackedBoundsGpu, min)));
+  attrs.push_back(MakeAttribute(location++, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(PackedBoundsGpu, extent)));
   return attrs;
 }
 
-std::array<VkVertexInputAttributeDescription, 3> MakeShadowVertexAttributes() {
-  std::array<VkVertexInputAttributeDescription, 3> attrs{};
+std::vector<VkVertexInputAttributeDescription> MakeVertexAttributes(VertexLayout layout) {
+  switch (layout) {
+    case VertexLayout::kPackedJoints8:
+      return MakePackedVertexAttributes<uint8_t>(false);
+    case VertexLayout::kPackedJoints16:
+      return MakePackedVertexAttributes<uint16_t>(false);
+    case VertexLayout::kFull:
+    default:
+      break;
+  }
 
-  attrs[0].binding = 0;
-  attrs[0].location = 0;
-  attrs[0].format = VK_FORMAT_R32G32B32_SFLOAT;
-  attrs[0].offset = static_cast<uint32_t>(offsetof(VertexSkinned, position));
+  return {
+      MakeAttribute(0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(VertexSkinned, position)),
+      MakeAttribute(1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(VertexSkinned, normal)),
+      MakeAttribute(2, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(VertexSkinned, tangent)),
+      MakeAttribute(3, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(VertexSkinned, uv0)),
+      MakeAttribute(4, 0, VK_FORMAT_R16G16B16A16_UINT, offsetof(VertexSkinned, joints)),
+      MakeAttribute(5, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(VertexSkinned, weights)),
+  };
+}
 
-  attrs[1].binding = 0;
-  attrs[1].location = 1;
-  attrs[1].format = VK_FORMAT_R16G16B16A16_UINT;
-  attrs[1].offset = static_cast<uint32_t>(offsetof(VertexSkinned, joints));
+std::vector<VkVertexInputAttributeDescription> MakeShadowVertexAttributes(VertexLayout layout) {
+  switch (layout) {
+    case VertexLayout::kPackedJoints8:
+      return MakePackedVertexAttributes<uint8_t>(true);
+    case VertexLayout::kPackedJoints16:
+      return MakePackedVertexAttributes<uint16_t>(true);
+    case VertexLayout::kFull:
+    default:
+      break;
+  }
 
-  attrs[2].binding = 0;
-  attrs[2].location = 2;
-  attrs[2].format = VK_FORMAT_R32G32B32A32_SFLOAT;
-  attrs[2].offset = static_cast<uint32_t>(offsetof(VertexSkinned, weights));
+  return {
+      MakeAttribute(0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(VertexSkinned, position)),
+      MakeAttribute(1, 0, VK_FORMAT_R16G16B16A16_UINT, offsetof(VertexSkinned, joints)),
+      MakeAttribute(2, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(VertexSkinned, weights)),
+  };
+}
 
-  return attrs;
+// What material set `index` is written from: past the scene's materials, every map on its default.
+Material SetMaterial(size_t index, const Scene& scene) {
+  if (index < scene.materials.size()) {
+    return scene.materials[index];
+  }
+  Material material;
+  material.baseColorTex = 0;
+  material.metallicRoughnessTex = 4;
+  material.metallicTex = 1;
+  material.roughnessTex = 4;
+  material.normalTex = 2;
+  material.occlusionTex = 4;
+  material.emissiveTex = 1;
+  material.specularTex = 3;
+  return material;
 }
 
 }  // namespace
@@ -296,7 +367,8 @@ void SkinPbrPass::EndOneShot(VkCommandBuffer cmd) const {
 void SkinPbrPass::TransitionImageLayout(VkCommandBuffer cmd,
                                         VkImage image,
                                         VkImageLayout oldLayout,
-                                        VkImageLayout newLayout) const {
+                                        VkImageLayout newLayout,
+                                        uint32_t levelCount) const {
   VkImageMemoryBarrier barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
   barrier.oldLayout = oldLayout;
   barrier.newLayout = newLayout;
@@ -305,7 +377,7 @@ void SkinPbrPass::TransitionImageLayout(VkCommandBuffer cmd,
   barrier.image = image;
   barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
   barrier.subresourceRange.baseMipLevel = 0;
-  barrier.subresourceRange.levelCount = 1;
+  barrier.subresourceRange.levelCount = levelCount;
   barrier.subresourceRange.baseArrayLayer = 0;
   barrier.subresourceRange.layerCount = 1;
 
@@ -391,6 +463,11 @@ void SkinPbrPass::CreateDescriptorLayouts() {
   materialInfo.pBindings = materialBindings.data();
   VkCheck(vkCreateDescriptorSetLayout(device_, &materialInfo, nullptr, &materialSetLayout_),
           "SkinPbrPass: vkCreateDescriptorSetLayout(material) failed");
+
+  // Base color, packed ORM, normal, emissive, specular: the first five bindings of the full set.
+  materialInfo.bindingCount = 5;
+  VkCheck(vkCreateDescriptorSetLayout(device_, &materialInfo, nullptr, &ormMaterialSetLayout_),
+          "SkinPbrPass: vkCreateDescriptorSetLayout(orm material) failed");
 }
 
 void SkinPbrPass::DestroyDescriptorLayouts() {
@@ -406,6 +483,10 @@ void SkinPbrPass::DestroyDescriptorLayouts() {
     vkDestroyDescriptorSetLayout(device_, materialSetLayout_, nullptr);
     materialSetLayout_ = VK_NULL_HANDLE;
   }
+  if (ormMaterialSetLayout_ != VK_NULL_HANDLE) {
+    vkDestroyDescriptorSetLayout(device_, ormMaterialSetLayout_, nullptr);
+    ormMaterialSetLayout_ = VK_NULL_HANDLE;
+  }
 }
 
 void SkinPbrPass::CreateFrameDescriptorPool() {
@@ -573,9 +654,13 @@ void SkinPbrPass::AllocateAndWriteFrameDescriptorSets() {
 
 void SkinPbrPass::CreatePipeline(VkRenderPass renderPass) {
   const auto vertWords = ReadSpv(vertSpvPath_);
+  const auto packedVertWords = ReadSpv(packedVertSpvPath_);
   const auto fragWords = ReadSpv(fragSpvPath_);
+  const auto ormFragWords = ReadSpv(ormFragSpvPath_);
   VkShaderModule vertModule = CreateShaderModule(vertWords);
+  VkShaderModule packedVertModule = CreateShaderModule(packedVertWords);
   VkShaderModule fragModule = CreateShaderModule(fragWords);
+  VkShaderModule ormFragModule = CreateShaderModule(ormFragWords);
 
   VkPipelineShaderStageCreateInfo vertStage{VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO};
   vertStage.stage = VK_SHADER_STAGE_VERTEX_BIT;
@@ -589,15 +674,6 @@ void SkinPbrPass::CreatePipeline(VkRenderPass renderPass) {
 
   std::array<VkPipelineShaderStageCreateInfo, 2> stages{vertStage, fragStage};
 
-  const auto binding = MakeVertexBinding();
-  const auto attrs = MakeVertexAttributes();
-
-  VkPipelineVertexInputStateCreateInfo vertexInput{VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
-  vertexInput.vertexBindingDescriptionCount = 1;
-  vertexInput.pVertexBindingDescriptions = &binding;
-  vertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(attrs.size());
-  vertexInput.pVertexAttributeDescriptions = attrs.data();
-
   VkPipelineInputAssemblyStateCreateInfo inputAssembly{VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO};
   inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
 
@@ -647,26 +723,53 @@ void SkinPbrPass::CreatePipeline(VkRenderPass renderPass) {
   VkCheck(vkCreatePipelineLayout(device_, &layoutInfo, nullptr, &pipelineLayout_),
           "SkinPbrPass: vkCreatePipelineLayout failed");
 
-  VkGraphicsPipelineCreateInfo pipeInfo{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
-  pipeInfo.stageCount = static_cast<uint32_t>(stages.size());
-  pipeInfo.pStages = stages.data();
-  pipeInfo.pVertexInputState = &vertexInput;
-  pipeInfo.pInputAssemblyState = &inputAssembly;
-  pipeInfo.pViewportState = &viewportState;
-  pipeInfo.pRasterizationState = &raster;
-  pipeInfo.pMultisampleState = &msaa;
-  pipeInfo.pDepthStencilState = &depth;
-  pipeInfo.pColorBlendState = &blend;
-  pipeInfo.pDynamicState = &dynamic;
-  pipeInfo.layout = pipelineLayout_;
-  pipeInfo.renderPass = renderPass;
-  pipeInfo.subpass = 0;
-
-  VkCheck(vkCreateGraphicsPipelines(device_, VK_NULL_HANDLE, 1, &pipeInfo, nullptr, &pipeline_),
-          "SkinPbrPass: vkCreateGraphicsPipelines failed");
+  // Sets 0 and 1 and the push range match, so frame and bone sets stay bound across both layouts.
+  setLayouts[2] = ormMaterialSetLayout_;
+  VkCheck(vkCreatePipelineLayout(device_, &layoutInfo, nullptr, &ormPipelineLayout_),
+          "SkinPbrPass: vkCreatePipelineLayout(orm) failed");
+
+  for (size_t i = 0; i < kVertexLayoutCount; ++i) {
+    const VertexLayout layout = static_cast<VertexLayout>(i);
+    stages[0].module = layout == VertexLayout::kFull ? vertModule : packedVertModule;
+
+    const auto bindings = MakeVertexBindings(layout);
+    const auto attrs = MakeVertexAttributes(layout);
+
+    VkPipelineVertexInputStateCreateInfo vertexInput{VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
+    vertexInput.vertexBindingDescriptionCount = static_cast<uint32_t>(bindings.size());
+    vertexInput.pVertexBindingDescriptions = bindings.data();
+    vertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(attrs.size());
+    vertexInput.pVertexAttributeDescriptions = attrs.data();
+
+    VkGraphicsPipelineCreateInfo pipeInfo{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+    pipeInfo.stageCount = static_cast<uint32_t>(stages.size());
+    pipeInfo.pStages = stages.data();
+    pipeInfo.pVertexInputState = &vertexInput;
+    pipeInfo.pInputAssemblyState = &inputAssembly;
+    pipeInfo.pViewportState = &viewportState;
+    pipeInfo.pRasterizationState = &raster;
+    pipeInfo.pMultisampleState = &msaa;
+    pipeInfo.pDepthStencilState = &depth;
+    pipeInfo.pColorBlendState = &blend;
+    pipeInfo.pDynamicState = &dynamic;
+    pipeInfo.layout = pipelineLayout_;
+    pipeInfo.renderPass = renderPass;
+    pipeInfo.subpass = 0;
+
+    VkCheck(vkCreateGraphicsPipelines(device_, VK_NULL_HANDLE, 1, &pipeInfo, nullptr, &pipelines_[i]),
+            "SkinPbrPass: vkCreateGraphicsPipelines failed");
+
+    stages[1].module = ormFragModule;
+    pipeInfo.layout = ormPipelineLayout_;
+    VkCheck(vkCreateGraphicsPipelines(device_, VK_NULL_HANDLE, 1, &pipeInfo, nullptr, &ormPipelines_[i]),
+            "SkinPbrPass: vkCreateGraphicsPipelines(orm) failed");
+    stages[1].module = fragModule;
+  }
 
   vkDestroyShaderModule(device_, vertModule, nullptr);
+  vkDestroyShaderModule(device_, packedVertModule, nullptr);
   vkDestroyShaderModule(device_, fragModule, nullptr);
+  vkDestroyShaderModule(device_, ormFragModule, nullptr);
 }
 
 void SkinPbrPass::CreateShadowResources() {
@@ -786,22 +889,15 @@ void SkinPbrPass::DestroyShadowResources() {
 
 void SkinPbrPass::CreateShadowPipeline() {
   const auto vertWords = ReadSpv(shadowVertSpvPath_);
+  const auto packedVertWords = ReadSpv(packedShadowVertSpvPath_);
   VkShaderModule vertModule = CreateShaderModule(vertWords);
+  VkShaderModule packedVertModule = CreateShaderModule(packedVertWords);
 
   VkPipelineShaderStageCreateInfo vertStage{VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO};
   vertStage.stage = VK_SHADER_STAGE_VERTEX_BIT;
   vertStage.module = vertModule;
   vertStage.pName = "main";
 
-  const auto binding = MakeVertexBinding();
-  const auto attrs = MakeShadowVertexAttributes();
-
-  VkPipelineVertexInputStateCreateInfo vertexInput{VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
-  vertexInput.vertexBindingDescriptionCount = 1;
-  vertexInput.pVertexBindingDescriptions = &binding;
-  vertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(attrs.size());
-  vertexInput.pVertexAttributeDescriptions = attrs.data();
-
   VkPipelineInputAssemblyStateCreateInfo inputAssembly{VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO};
   inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
 
@@ -847,31 +943,48 @@ void SkinPbrPass::CreateShadowPipeline() {
   VkCheck(vkCreatePipelineLayout(device_, &layoutInfo, nullptr, &shadowPipelineLayout_),
           "SkinPbrPass: vkCreatePipelineLayout(shadow) failed");
 
-  VkGraphicsPipelineCreateInfo pipeInfo{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
-  pipeInfo.stageCount = 1;
-  pipeInfo.pStages = &vertStage;
-  pipeInfo.pVertexInputState = &vertexInput;
-  pipeInfo.pInputAssemblyState = &inputAssembly;
-  pipeInfo.pViewportState = &viewportState;
-  pipeInfo.pRasterizationState = &raster;
-  pipeInfo.pMultisampleState = &msaa;
-  pipeInfo.pDepthStencilState = &depth;
-  pipeInfo.pColorBlendState = &blend;
-  pipeInfo.pDynamicState = &dynamic;
-  pipeInfo.layout = shadowPipelineLayout_;
-  pipeInfo.renderPass = shadowRenderPass_;
-  pipeInfo.subpass = 0;
-
-  VkCheck(vkCreateGraphicsPipelines(device_, VK_NULL_HANDLE, 1, &pipeInfo, nullptr, &shadowPipeline_),
-          "SkinPbrPass: vkCreateGraphicsPipelines(shadow) failed");
+  for (size_t i = 0; i < kVertexLayoutCount; ++i) {
+    const VertexLayout layout = static_cast<VertexLayout>(i);
+    vertStage.module = layout == VertexLayout::kFull ? vertModule : packedVertModule;
+
+    const auto bindings = MakeVertexBindings(layout);
+    const auto attrs = MakeShadowVertexAttributes(layout);
+
+    VkPipelineVertexInputStateCreateInfo vertexInput{VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
+    vertexInput.vertexBindingDescriptionCount = static_cast<uint32_t>(bindings.size());
+    vertexInput.pVertexBindingDescriptions = bindings.data();
+    vertexInput.vertexAttributeDescriptionCount = static_cast<uint32_t>(attrs.size());
+    vertexInput.pVertexAttributeDescriptions = attrs.data();
+
+    VkGraphicsPipelineCreateInfo pipeInfo{VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+    pipeInfo.stageCount = 1;
+    pipeInfo.pStages = &vertStage;
+    pipeInfo.pVertexInputState = &vertexInput;
+    pipeInfo.pInputAssemblyState = &inputAssembly;
+    pipeInfo.pViewportState = &viewportState;
+    pipeInfo.pRasterizationState = &raster;
+    pipeInfo.pMultisampleState = &msaa;
+    pipeInfo.pDepthStencilState = &depth;
+    pipeInfo.pColorBlendState = &blend;
+    pipeInfo.pDynamicState = &dynamic;
+    pipeInfo.layout = shadowPipelineLayout_;
+    pipeInfo.renderPass = shadowRenderPass_;
+    pipeInfo.subpass = 0;
+
+    VkCheck(vkCreateGraphicsPipelines(device_, VK_NULL_HANDLE, 1, &pipeInfo, nullptr, &shadowPipelines_[i]),
+            "SkinPbrPass: vkCreateGraphicsPipelines(shadow) failed");
+  }
 
   vkDestroyShaderModule(device_, vertModule, nullptr);
+  vkDestroyShaderModule(device_, packedVertModule, nullptr);
 }
 
 void SkinPbrPass::DestroyShadowPipeline() {
-  if (shadowPipeline_ != VK_NULL_HANDLE) {
-    vkDestroyPipeline(device_, shadowPipeline_, nullptr);
-    shadowPipeline_ = VK_NULL_HANDLE;
+  for (VkPipeline& pipeline : shadowPipelines_) {
+    if (pipeline != VK_NULL_HANDLE) {
+      vkDestroyPipeline(device_, pipeline, nullptr);
+      pipeline = VK_NULL_HANDLE;
+    }
   }
   if (shadowPipelineLayout_ != VK_NULL_HANDLE) {
     vkDestroyPipelineLayout(device_, shadowPipelineLayout_, nullptr);
@@ -880,43 +993,63 @@ void SkinPbrPass::DestroyShadowPipeline() {
 }
 
 void SkinPbrPass::DestroyPipeline() {
-  if (pipeline_ != VK_NULL_HANDLE) {
-    vkDestroyPipeline(device_, pipeline_, nullptr);
-    pipeline_ = VK_NULL_HANDLE;
+  for (auto* variant : {&pipelines_, &ormPipelines_}) {
+    for (VkPipeline& pipeline : *variant) {
+      if (pipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(device_, pipeline, nullptr);
+        pipeline = VK_NULL_HANDLE;
+      }
+    }
   }
-  if (pipelineLayout_ != VK_NULL_HANDLE) {
-    vkDestroyPipelineLayout(device_, pipelineLayout_, nullptr);
-    pipelineLayout_ = VK_NULL_HANDLE;
+  for (VkPipelineLayout* layout : {&pipelineLayout_, &ormPipelineLayout_}) {
+    if (*layout != VK_NULL_HANDLE) {
+      vkDestroyPipelineLayout(device_, *layout, nullptr);
+      *layout = VK_NULL_HANDLE;
+    }
+  }
+}
+
+void SkinPbrPass::DestroyMeshGpu(MeshGpu& mesh) {
+  DestroyBuffer(mesh.vertex);
+  DestroyBuffer(mesh.index);
+  for (Buffer& buffer : mesh.morphVertex) {
+    DestroyBuffer(buffer);
   }
 }
 
 void SkinPbrPass::DestroySceneBuffers() {
   for (auto& mesh : meshBuffers_) {
-    DestroyBuffer(mesh.vertex);
-    DestroyBuffer(mesh.index);
+    DestroyMeshGpu(mesh);
   }
   meshBuffers_.clear();
+  meshSlots_.clear();
   uploadedScene_ = nullptr;
   boneOverflowWarned_ = false;
 }
 
+void SkinPbrPass::DestroyTextureGpu(TextureGpu& texture) {
+  if (texture.view != VK_NULL_HANDLE) {
+    vkDestroyImageView(device_, texture.view, nullptr);
+    texture.view = VK_NULL_HANDLE;
+  }
+  if (texture.image != VK_NULL_HANDLE) {
+    vkDestroyImage(device_, texture.image, nullptr);
+    texture.image = VK_NULL_HANDLE;
+  }
+  if (texture.memory != VK_NULL_HANDLE) {
+    vkFreeMemory(device_, texture.memory, nullptr);
+    texture.memory = VK_NULL_HANDLE;
+  }
+}
+
 void SkinPbrPass::DestroyTextures() {
   for (auto& tex : textureGpus_) {
-    if (tex.view != VK_NULL_HANDLE) {
-      vkDestroyImageView(device_, tex.view, nullptr);
-      tex.view = VK_NULL_HANDLE;
-    }
-    if (tex.image != VK_NULL_HANDLE) {
-      vkDestroyImage(device_, tex.image, nullptr);
-      tex.image = VK_NULL_HANDLE;
-    }
-    if (tex.memory != VK_NULL_HANDLE) {
-      vkFreeMemory(device_, tex.memory, nullptr);
-      tex.memory = VK_NULL_HANDLE;
-    }
+    DestroyTextureGpu(tex);
   }
   textureGpus_.clear();
+  textureSlots_.clear();
   materialSets_.clear();
+  materialOrm_.clear();
 }
 
 void SkinPbrPass::CreateIblEnvironmentTexture() {
@@ -1040,53 +1173,206 @@ void SkinPbrPass::DestroyIblEnvironmentTexture() {
 }
 
 void SkinPbrPass::UploadTextures(const Scene& scene) {
+  // Images of the previous scene survive when the new one references the same content, or the
+  // same texture asset when the content has no key.
+  std::unordered_map<uint64_t, TextureGpu> previous;
+  std::unordered_map<const Texture*, TextureGpu> previousByAsset;
+  for (TextureGpu& gpu : textureGpus_) {
+    if (gpu.contentKey != 0) {
+      if (previous.try_emplace(gpu.contentKey, gpu).second) {
+        gpu = TextureGpu{};
+      }
+    } else if (const std::shared_ptr<const Texture> asset = gpu.asset.lock();
+               asset != nullptr && previousByAsset.try_emplace(asset.get(), gpu).second) {
+      gpu = TextureGpu{};
+    }
+  }
   DestroyTextures();
 
-  textureGpus_.resize(std::max<size_t>(scene.textures.size(), 1));
-
-  for (size_t i = 0; i < textureGpus_.size(); ++i) {
-    std::vector<uint8_t> pixels;
-    uint32_t width = 1;
-    uint32_t height = 1;
-    bool srgb = true;
-
-    if (i < scene.textures.size()) {
-      const Texture& src = scene.textures[i];
-      if (!src.pixels.empty() && src.width > 0 && src.height > 0) {
-        pixels = src.pixels;
-        width = src.width;
-        height = src.height;
-        srgb = src.srgb;
+  // Textures with equal content keys (or one asset) share one image, so each TextureId maps to a slot.
+  const size_t textureCount = std::max<size_t>(scene.textures.size(), 1);
+  textureSlots_.assign(textureCount, 0);
+  textureStats_ = {};
+  textureStats_.textures = static_cast<uint32_t>(textureCount);
+  std::unordered_map<uint64_t, uint32_t> slotByKey;
+  std::unordered_map<const Texture*, uint32_t> slotByAsset;
+  std::vector<size_t> uploads;  // scene texture index per new slot
+  for (size_t i = 0; i < textureCount; ++i) {
+    if (i < scene.textures.size() && scene.textures[i]->streaming) {
+      // No image until UpdateTextures; materials sample their defaults meanwhile.
+      textureSlots_[i] = static_cast<uint32_t>(textureGpus_.size());
+      textureGpus_.push_back(TextureGpu{});
+      ++textureStats_.streaming;
+      continue;
+    }
+    const std::shared_ptr<const Texture> asset = i < scene.textures.size() ? scene.textures[i].Handle() : nullptr;
+    const uint64_t key = asset != nullptr ? TextureGpuKey(*asset) : 0;
+    if (key != 0) {
+      if (const auto shared = slotByKey.find(key); shared != slotByKey.end()) {
+        textureSlots_[i] = shared->second;
+        ++textureStats_.shared;
+        continue;
+      }
+    } else if (asset != nullptr) {
+      if (const auto shared = slotByAsset.find(asset.get()); shared != slotByAsset.end()) {
+        textureSlots_[i] = shared->second;
+        ++textureStats_.shared;
+        continue;
       }
     }
-
-    if (pixels.empty()) {
-      pixels = {255, 255, 255, 255};
-      width = 1;
-      height = 1;
-      srgb = true;
+    textureSlots_[i] = static_cast<uint32_t>(textureGpus_.size());
+    if (key != 0) {
+      slotByKey[key] = textureSlots_[i];
+      if (const auto kept = previous.find(key); kept != previous.end()) {
+        textureGpus_.push_back(kept->second);
+        previous.erase(kept);
+        ++textureStats_.reused;
+        continue;
+      }
+    } else if (asset != nullptr) {
+      slotByAsset[asset.get()] = textureSlots_[i];
+      if (const auto kept = previousByAsset.find(asset.get()); kept != previousByAsset.end()) {
+        textureGpus_.push_back(kept->second);
+        previousByAsset.erase(kept);
+        ++textureStats_.reused;
+        continue;
+      }
     }
+    TextureGpu pending{};
+    pending.contentKey = key;
+    pending.asset = asset;
+    textureGpus_.push_back(pending);
+    uploads.push_back(i);
+  }
+  for (auto& [key, gpu] : previous) {
+    DestroyTextureGpu(gpu);
+  }
+  for (auto& [asset, gpu] : previousByAsset) {
+    DestroyTextureGpu(gpu);
+  }
+  textureStats_.uploaded = static_cast<uint32_t>(uploads.size());
+  UploadTextureImages(scene, uploads);
+}
+
+void SkinPbrPass::UploadTextureImages(const Scene& scene, const std::vector<size_t>& uploads) {
+  if (uploads.empty()) {
+    return;
+  }
 
-    TextureGpu gpu{};
-    gpu.format = srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
-    const uint32_t maxDim = std::max(width, height);
-    gpu.mipLevels = (maxDim > 0) ? (static_cast<uint32_t>(std::floor(std::log2(static_cast<float>(maxDim)))) + 1U) : 1U;
-    const bool canLinearBlit = SupportsLinearBlit(physicalDevice_, gpu.format);
-    if (!canLinearBlit) {
-      gpu.mipLevels = 1;
+  VkPhysicalDeviceFeatures features{};
+  vkGetPhysicalDeviceFeatures(physicalDevice_, &features);
+  const bool bcSupported = features.textureCompressionBC == VK_TRUE;
+
+  // Mip chains and block compression normally come from import; textures without a chain get
+  // one here on the CPU, BC data the device cannot sample is expanded back to RGBA8, and lazily
+  // imported textures are decoded now through the registry's bounded cache. Decoded pixels only
+  // live until the staging copy. A level 0 that still needs its chain (decoded, or resident
+  // without mips) is copied once, straight into staging, and the chain is filtered from it into
+  // staging. Lazy KTX2 textures are not decoded at all: their file is mapped and each level is
+  // copied (or inflated) from it straight into staging. The GPU side is one buffer-to-image copy
+  // per texture and every texture shares one submission.
+  TextureRegistry& registry = TextureRegistry::Global();
+  std::vector<Texture> local(uploads.size());
+  std::vector<const Texture*> sources(uploads.size(), nullptr);
+  std::vector<Ktx2Source> mapped(uploads.size());
+  std::vector<uint8_t> fromFile(uploads.size(), 0);
+  std::vector<std::shared_ptr<const ImageRgba8>> decoded(uploads.size());
+  std::vector<const uint8_t*> level0(uploads.size(), nullptr);  // set: staged as level 0 plus filtered chain
+  VkDeviceSize stagingSize = 0;
+  std::vector<std::optional<SharedAsset<Texture>>> reloaded(uploads.size());
+  for (size_t i = 0; i < uploads.size(); ++i) {
+    const Texture* src = uploads[i] < scene.textures.size() ? &*scene.textures[uploads[i]] : nullptr;
+    if (src != nullptr && src->pixelsReleased) {
+      // Released after an earlier upload: read back from the cooked file, else drawn as the default.
+      reloaded[i] = AcquireTexturePixels(scene.textures[uploads[i]]).value;
+      src = reloaded[i].has_value() ? &**reloaded[i] : nullptr;
+    } else if (src != nullptr && HasLazySource(*src) && IsKtx2Source(src->source)) {
+      const bool opened = mapped[i].Open(src->source) && mapped[i].Info().width == src->width &&
+                          mapped[i].Info().height == src->height && mapped[i].Info().levels.size() == std::max(src->mipLevels, 1U);
+      if (opened && (!IsBlockCompressed(src->format) ||
+                     (bcSupported && SupportsSampledTransferDst(physicalDevice_, TextureVkFormat(*src))))) {
+        fromFile[i] = 1;
+        sources[i] = src;
+        stagingSize = (stagingSize + 15) & ~VkDeviceSize{15};
+        stagingSize += Ktx2ChainBytes(mapped[i].Info());
+        continue;
+      }
+      local[i] = CopyTextureHeader(*src);
+      if (opened) {
+        local[i].mipLevels = static_cast<uint32_t>(mapped[i].Info().levels.size());
+        local[i].pixels = PixelBuffer(Ktx2ChainBytes(mapped[i].Info()));
+        if (!mapped[i].ReadLevels(local[i].pixels.data())) {
+          local[i].pixels.clear();
+        }
+      }
+      src = &local[i];
+    } else if (src != nullptr && HasLazySource(*src)) {
+      decoded[i] = registry.AcquirePixels(*src);
+      if (decoded[i] != nullptr && decoded[i]->width == src->width && decoded[i]->height == src->height) {
+        local[i] = CopyTextureHeader(*src);
+        local[i].mipLevels = FullMipLevelCount(src->width, src->height);
+        level0[i] = decoded[i]->pixels.data();
+        sources[i] = &local[i];
+        stagingSize = (stagingSize + 15) & ~VkDeviceSize{15};
+        stagingSize += MipLevelOffset(src->width, src->height, local[i].mipLevels);
+        continue;
+      }
+      src = &local[i];
     }
+    bool valid = src != nullptr && src->width > 0 && src->height > 0 &&
+                 src->pixels.size() >= TextureLevelOffset(src->format, src->width, src->height, std::max(src->mipLevels, 1U));
+    if (valid && IsBlockCompressed(src->format) &&
+        (!bcSupported || !SupportsSampledTransferDst(physicalDevice_, TextureVkFormat(*src)))) {
+      valid = DecompressTexture(*src, local[i]);
+      src = &local[i];
+    }
+    if (!valid) {
+      local[i] = Texture{};
+      local[i].width = 1;
+      local[i].height = 1;
+      local[i].srgb = true;
+      local[i].pixels = {255, 255, 255, 255};
+      src = &local[i];
+    } else if (!IsBlockCompressed(src->format) && src->mipLevels <= 1 && FullMipLevelCount(src->width, src->height) > 1) {
+      if (src != &local[i]) {
+        local[i] = CopyTextureHeader(*src);
+        local[i].mipLevels = FullMipLevelCount(src->width, src->height);
+        level0[i] = src->pixels.data();
+      } else {
+        GenerateMipChain(local[i]);
+      }
+      src = &local[i];
+    }
+    sources[i] = src;
+    // BC copies need block-aligned buffer offsets; 16 covers every format used here.
+    stagingSize = (stagingSize + 15) & ~VkDeviceSize{15};
+    stagingSize += TextureLevelOffset(src->format, src->width, src->height, std::max(src->mipLevels, 1U));
+  }
+
+  Buffer staging = CreateBuffer(stagingSize,
+                                VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                true);
+  VkCommandBuffer cmd = BeginOneShot();
+  VkDeviceSize stagingOffset = 0;
+
+  for (size_t i = 0; i < uploads.size(); ++i) {
+    const Texture& src = *sources[i];
+    TextureGpu& gpu = textureGpus_[textureSlots_[uploads[i]]];
+    gpu.format = TextureVkFormat(src);
+    gpu.mipLevels = std::max(src.mipLevels, 1U);
 
     VkImageCreateInfo imageInfo{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
     imageInfo.imageType = VK_IMAGE_TYPE_2D;
-    imageInfo.extent.width = width;
-    imageInfo.extent.height = height;
+    imageInfo.extent.width = src.width;
+    imageInfo.extent.height = src.height;
     imageInfo.extent.depth = 1;
     imageInfo.mipLevels = gpu.mipLevels;
     imageInfo.arrayLayers = 1;
     imageInfo.format = gpu.format;
     imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
     imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
     imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
     imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     VkCheck(vkCreateImage(device_, &imageInfo, nullptr, &gpu.image), "SkinPbrPass: vkCreateImage(texture) failed");
@@ -1100,149 +1386,114 @@ void SkinPbrPass::UploadTextures(const Scene& scene) {
     VkCheck(vkAllocateMemory(device_, &imageAlloc, nullptr, &gpu.memory), "SkinPbrPass: vkAllocateMemory(texture) failed");
     VkCheck(vkBindImageMemory(device_, gpu.image, gpu.memory, 0), "SkinPbrPass: vkBindImageMemory(texture) failed");
 
-    Buffer staging = CreateBuffer(pixels.size(),
-                                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                  true);
-    std::memcpy(staging.mapped, pixels.data(), pixels.size());
-
-    VkCommandBuffer cmd = BeginOneShot();
+    stagingOffset = (stagingOffset + 15) & ~VkDeviceSize{15};
+    const size_t chainBytes = TextureLevelOffset(src.format, src.width, src.height, gpu.mipLevels);
+    uint8_t* const dst = static_cast<uint8_t*>(staging.mapped) + stagingOffset;
+    if (level0[i] != nullptr) {
+      std::memcpy(dst, level0[i], MipLevelOffset(src.width, src.height, 1));
+      WriteMipLevels(src, level0[i], dst);
+    } else if (fromFile[i] == 0) {
+      std::memcpy(dst, src.pixels.data(), chainBytes);
+    } else if (!mapped[i].ReadLevels(dst)) {
+      std::memset(dst, 0, chainBytes);  // a corrupt level: black rather than stale staging memory
+    }
 
-    TransitionImageLayout(cmd, gpu.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    std::vector<VkBufferImageCopy> copies(gpu.mipLevels);
+    for (uint32_t level = 0; level < gpu.mipLevels; ++level) {
+      VkBufferImageCopy& copy = copies[level];
+      copy.bufferOffset = stagingOffset + TextureLevelOffset(src.format, src.width, src.height, level);
+      copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+      copy.imageSubresource.mipLevel = level;
+      copy.imageSubresource.baseArrayLayer = 0;
+      copy.imageSubresource.layerCount = 1;
+      copy.imageExtent = {MipDimension(src.width, level), MipDimension(src.height, level), 1};
+    }
+    stagingOffset += chainBytes;
 
-    VkBufferImageCopy copy{};
-    copy.bufferOffset = 0;
-    copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    copy.imageSubresource.mipLevel = 0;
-    copy.imageSubresource.baseArrayLayer = 0;
-    copy.imageSubresource.layerCount = 1;
-    copy.imageExtent = {width, height, 1};
+    TransitionImageLayout(cmd, gpu.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, gpu.mipLevels);
     vkCmdCopyBufferToImage(cmd,
                            staging.handle,
                            gpu.image,
                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                           1,
-                           &copy);
-
-    if (gpu.mipLevels == 1) {
-      TransitionImageLayout(cmd,
-                            gpu.image,
-                            VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                            VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-    } else {
-      int32_t mipWidth = static_cast<int32_t>(width);
-      int32_t mipHeight = static_cast<int32_t>(height);
-
-      auto transitionLevel = [&](uint32_t level,
-                                 VkImageLayout oldLayout,
-                                 VkImageLayout newLayout,
-                                 VkAccessFlags srcAccess,
-                                 VkAccessFlags dstAccess,
-                                 VkPipelineStageFlags srcStage,
-                                 VkPipelineStageFlags dstStage) {
-        VkImageMemoryBarrier barrier{VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
-        barrier.oldLayout = oldLayout;
-        barrier.newLayout = newLayout;
-        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-        barrier.image = gpu.image;
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        barrier.subresourceRange.baseMipLevel = level;
-        barrier.subresourceRange.levelCount = 1;
-        barrier.subresourceRange.baseArrayLayer = 0;
-        barrier.subresourceRange.layerCount = 1;
-        barrier.srcAccessMask = srcAccess;
-        barrier.dstAccessMask = dstAccess;
-        vkCmdPipelineBarrier(cmd, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-      };
-
-      transitionLevel(0,
-                      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                      VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                      VK_ACCESS_TRANSFER_WRITE_BIT,
-                      VK_ACCESS_TRANSFER_READ_BIT,
-                      VK_PIPELINE_STAGE_TRANSFER_BIT,
-                      VK_PIPELINE_STAGE_TRANSFER_BIT);
-
-      for (uint32_t level = 1; level < gpu.mipLevels; ++level) {
-        transitionLevel(level,
-                        VK_IMAGE_LAYOUT_UNDEFINED,
-                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                        0,
-                        VK_ACCESS_TRANSFER_WRITE_BIT,
-                        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                        VK_PIPELINE_STAGE_TRANSFER_BIT);
-
-        VkImageBlit blit{};
-        blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        blit.srcSubresource.mipLevel = level - 1;
-        blit.srcSubresource.baseArrayLayer = 0;
-        blit.srcSubresource.layerCount = 1;
-        blit.srcOffsets[0] = {0, 0, 0};
-        blit.srcOffsets[1] = {mipWidth, mipHeight, 1};
-
-        const int32_t dstWidth = std::max(1, mipWidth / 2);
-        const int32_t dstHeight = std::max(1, mipHeight / 2);
-        blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        blit.dstSubresource.mipLevel = level;
-        blit.dstSubresource.baseArrayLayer = 0;
-        blit.dstSubresource.layerCount = 1;
-        blit.dstOffsets[0] = {0, 0, 0};
-        blit.dstOffsets[1] = {dstWidth, dstHeight, 1};
-
-        vkCmdBlitImage(cmd,
-                       gpu.image,
-                       VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                       gpu.image,
-                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                       1,
-                       &blit,
-                       VK_FILTER_LINEAR);
-
-        transitionLevel(level - 1,
-                        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                        VK_ACCESS_TRANSFER_READ_BIT,
-                        VK_ACCESS_SHADER_READ_BIT,
-                        VK_PIPELINE_STAGE_TRANSFER_BIT,
-                        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
-
-        transitionLevel(level,
-                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                        VK_ACCESS_TRANSFER_WRITE_BIT,
-                        VK_ACCESS_TRANSFER_READ_BIT,
-                        VK_PIPELINE_STAGE_TRANSFER_BIT,
-                        VK_PIPELINE_STAGE_TRANSFER_BIT);
-
-        mipWidth = dstWidth;
-        mipHeight = dstHeight;
-      }
-
-      transitionLevel(gpu.mipLevels - 1,
-                      VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
-                      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-                      VK_ACCESS_TRANSFER_READ_BIT,
-                      VK_ACCESS_SHADER_READ_BIT,
-                      VK_PIPELINE_STAGE_TRANSFER_BIT,
-                      VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
-    }
-
-    EndOneShot(cmd);
-    DestroyBuffer(staging);
+                           static_cast<uint32_t>(copies.size()),
+                           copies.data());
+    TransitionImageLayout(cmd,
+                          gpu.image,
+                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                          gpu.mipLevels);
 
     VkImageViewCreateInfo viewInfo{VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
     viewInfo.image = gpu.image;
     viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
     viewInfo.format = gpu.format;
+    if (src.format == PixelFormat::kBC4) {
+      // Single-channel masks are sampled as .r, but keep them gray for any other channel read.
+      viewInfo.components = {VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_ONE};
+    }
     viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     viewInfo.subresourceRange.baseMipLevel = 0;
     viewInfo.subresourceRange.levelCount = gpu.mipLevels;
     viewInfo.subresourceRange.baseArrayLayer = 0;
     viewInfo.subresourceRange.layerCount = 1;
     VkCheck(vkCreateImageView(device_, &viewInfo, nullptr, &gpu.view), "SkinPbrPass: vkCreateImageView(texture) failed");
+  }
+
+  EndOneShot(cmd);
+  DestroyBuffer(staging);
+}
 
-    textureGpus_[i] = gpu;
+void SkinPbrPass::UpdateTextures(const Scene& scene, const std::vector<TextureId>& ids) {
+  if (!initialized_ || uploadedScene_ != &scene) {
+    return;  // the next full upload reads the new pixels anyway
+  }
+  std::vector<TextureId> changed = ids;
+  std::sort(changed.begin(), changed.end());
+  changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+
+  // Each changed texture gets an image of its own; the previous one is released after the copy,
+  // once no other TextureId still shares it.
+  std::vector<TextureGpu> retired;
+  std::vector<size_t> uploads;
+  for (const TextureId id : changed) {
+    if (id >= textureSlots_.size() || id >= scene.textures.size() || scene.textures[id]->streaming) {
+      continue;
+    }
+    const uint32_t slot = textureSlots_[id];
+    if (textureGpus_[slot].view == VK_NULL_HANDLE && textureStats_.streaming > 0) {
+      --textureStats_.streaming;
+    }
+    if (std::count(textureSlots_.begin(), textureSlots_.end(), slot) > 1) {
+      textureSlots_[id] = static_cast<uint32_t>(textureGpus_.size());
+      textureGpus_.push_back(TextureGpu{});
+    } else {
+      retired.push_back(textureGpus_[slot]);
+      textureGpus_[slot] = TextureGpu{};
+    }
+    textureGpus_[textureSlots_[id]].contentKey = TextureGpuKey(scene.textures[id]);
+    textureGpus_[textureSlots_[id]].asset = scene.textures[id].Handle();
+    uploads.push_back(id);
+  }
+  if (uploads.empty()) {
+    return;
+  }
+
+  // The one-shot submission waits for the queue, so frames still in flight are finished before
+  // their images are destroyed and their material sets rewritten.
+  UploadTextureImages(scene, uploads);
+  for (TextureGpu& gpu : retired) {
+    DestroyTextureGpu(gpu);
+  }
+  textureStats_.uploaded = static_cast<uint32_t>(uploads.size());
+
+  const auto samples = [&](TextureId id) { return std::binary_search(changed.begin(), changed.end(), id); };
+  for (size_t i = 0; i < scene.materials.size() && i < materialSets_.size(); ++i) {
+    const Material& m = scene.materials[i];
+    if (samples(m.baseColorTex) || samples(m.metallicRoughnessTex) || samples(m.metallicTex) ||
+        samples(m.roughnessTex) || samples(m.normalTex) || samples(m.occlusionTex) || samples(m.emissiveTex) ||
+        samples(m.specularTex)) {
+      WriteMaterialDescriptorSet(i, scene);
+    }
   }
 }
 
@@ -1255,8 +1506,13 @@ void SkinPbrPass::RebuildMaterialDescriptorSets(const Scene& scene) {
 
   const size_t setCount = std::max<size_t>(scene.materials.size(), 1);
   materialSets_.resize(setCount);
+  materialOrm_.resize(setCount);
 
-  std::vector<VkDescriptorSetLayout> layouts(setCount, materialSetLayout_);
+  std::vector<VkDescriptorSetLayout> layouts(setCount);
+  for (size_t i = 0; i < setCount; ++i) {
+    materialOrm_[i] = UsesPackedOrm(SetMaterial(i, scene)) ? 1 : 0;
+    layouts[i] = materialOrm_[i] != 0 ? ormMaterialSetLayout_ : materialSetLayout_;
+  }
   VkDescriptorSetAllocateInfo alloc{VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
   alloc.descriptorPool = materialDescriptorPool_;
   alloc.descriptorSetCount = static_cast<uint32_t>(setCount);
@@ -1264,113 +1520,286 @@ void SkinPbrPass::RebuildMaterialDescriptorSets(const Scene& scene) {
   VkCheck(vkAllocateDescriptorSets(device_, &alloc, materialSets_.data()),
           "SkinPbrPass: vkAllocateDescriptorSets(material) failed");
 
-  auto pickView = [&](TextureId id, TextureId fallback) -> VkImageView {
-    if (id < textureGpus_.size() && textureGpus_[id].view != VK_NULL_HANDLE) {
-      return textureGpus_[id].view;
-    }
-    if (fallback < textureGpus_.size() && textureGpus_[fallback].view != VK_NULL_HANDLE) {
-      return textureGpus_[fallback].view;
-    }
-    return textureGpus_[0].view;
-  };
-
   for (size_t i = 0; i < setCount; ++i) {
-    Material material;
-    material.baseColorTex = 0;
-    material.metallicRoughnessTex = 4;
-    material.metallicTex = 1;
-    material.roughnessTex = 4;
-    material.normalTex = 2;
-    material.occlusionTex = 4;
-    material.emissiveTex = 1;
-    material.specularTex = 3;
-    if (i < scene.materials.size()) {
-      material = scene.materials[i];
-    }
+    WriteMaterialDescriptorSet(i, scene);
+  }
+}
 
-    std::array<VkDescriptorImageInfo, 8> imageInfos{};
-    imageInfos[0].sampler = sampler_;
-    imageInfos[0].imageView = pickView(material.baseColorTex, 0);
-    imageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-    imageInfos[1].sampler = sampler_;
-    imageInfos[1].imageView = pickView(material.metallicRoughnessTex, 0);
-    imageInfos[1].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-    imageInfos[2].sampler = sampler_;
-    imageInfos[2].imageView = pickView(material.normalTex, 2);
-    imageInfos[2].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-    imageInfos[3].sampler = sampler_;
-    imageInfos[3].imageView = pickView(material.emissiveTex, 1);
-    imageInfos[3].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-    imageInfos[4].sampler = sampler_;
-    imageInfos[4].imageView = pickView(material.specularTex, 3);
-    imageInfos[4].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-    imageInfos[5].sampler = sampler_;
-    imageInfos[5].imageView = pickView(material.metallicTex, 1);
-    imageInfos[5].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-    imageInfos[6].sampler = sampler_;
-    imageInfos[6].imageView = pickView(material.roughnessTex, 4);
-    imageInfos[6].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-    imageInfos[7].sampler = sampler_;
-    imageInfos[7].imageView = pickView(material.occlusionTex, 4);
-    imageInfos[7].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-    std::array<VkWriteDescriptorSet, 8> writes{};
-    for (uint32_t b = 0; b < writes.size(); ++b) {
-      writes[b].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-      writes[b].dstSet = materialSets_[i];
-      writes[b].dstBinding = b;
-      writes[b].descriptorCount = 1;
-      writes[b].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-      writes[b].pImageInfo = &imageInfos[b];
-    }
+VkImageView SkinPbrPass::MaterialTextureView(TextureId id, TextureId fallback) const {
+  if (id < textureSlots_.size() && textureGpus_[textureSlots_[id]].view != VK_NULL_HANDLE) {
+    return textureGpus_[textureSlots_[id]].view;
+  }
+  if (fallback < textureSlots_.size() && textureGpus_[textureSlots_[fallback]].view != VK_NULL_HANDLE) {
+    return textureGpus_[textureSlots_[fallback]].view;
+  }
+  return textureGpus_[textureSlots_[0]].view;
+}
 
-    vkUpdateDescriptorSets(device_, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+void SkinPbrPass::WriteMaterialDescriptorSet(size_t index, const Scene& scene) {
+  const Material material = SetMaterial(index, scene);
+
+  std::array<VkDescriptorImageInfo, 8> imageInfos{};
+  imageInfos[0].sampler = sampler_;
+  imageInfos[0].imageView = MaterialTextureView(material.baseColorTex, 0);
+  imageInfos[0].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+  imageInfos[1].sampler = sampler_;
+  imageInfos[1].imageView = MaterialTextureView(material.metallicRoughnessTex, 0);
+  imageInfos[1].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+  imageInfos[2].sampler = sampler_;
+  imageInfos[2].imageView = MaterialTextureView(material.normalTex, 2);
+  imageInfos[2].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+  imageInfos[3].sampler = sampler_;
+  imageInfos[3].imageView = MaterialTextureView(material.emissiveTex, 1);
+  imageInfos[3].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+  imageInfos[4].sampler = sampler_;
+  imageInfos[4].imageView = MaterialTextureView(material.specularTex, 3);
+  imageInfos[4].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+  imageInfos[5].sampler = sampler_;
+  imageInfos[5].imageView = MaterialTextureView(material.metallicTex, 1);
+  imageInfos[5].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+  imageInfos[6].sampler = sampler_;
+  imageInfos[6].imageView = MaterialTextureView(material.roughnessTex, 4);
+  imageInfos[6].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+  imageInfos[7].sampler = sampler_;
+  imageInfos[7].imageView = MaterialTextureView(material.occlusionTex, 4);
+  imageInfos[7].imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+  // Packed sets stop after the specular map; binding 1 then holds the ORM texture.
+  std::array<VkWriteDescriptorSet, 8> writes{};
+  const uint32_t writeCount = materialOrm_[index] != 0 ? 5 : static_cast<uint32_t>(writes.size());
+  for (uint32_t b = 0; b < writeCount; ++b) {
+    writes[b].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    writes[b].dstSet = materialSets_[index];
+    writes[b].dstBinding = b;
+    writes[b].descriptorCount = 1;
+    writes[b].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    writes[b].pImageInfo = &imageInfos[b];
   }
+
+  vkUpdateDescriptorSets(device_, writeCount, writes.data(), 0, nullptr);
 }
 
 void SkinPbrPass::UploadScene(const Scene& scene) {
-  DestroySceneBuffers();
-
   UploadTextures(scene);
   RebuildMaterialDescriptorSets(scene);
+  UploadMeshes(scene);
+
+  nodeLods_.assign(scene.nodes.size(), 0);
+  uploadedScene_ = &scene;
+}
 
-  meshBuffers_.resize(scene.meshes.size());
+void SkinPbrPass::UploadMeshes(const Scene& scene) {
+  // Buffers belong to mesh assets rather than scenes: MeshIds holding the same asset draw from one
+  // copy, and assets the previous scene held as well keep theirs.
+  std::unordered_map<const Mesh*, MeshGpu> previous;
+  for (MeshGpu& gpu : meshBuffers_) {
+    const std::shared_ptr<const Mesh> asset = gpu.asset.lock();
+    if (asset != nullptr && previous.try_emplace(asset.get(), gpu).second) {
+      gpu = MeshGpu{};
+    }
+  }
+  DestroySceneBuffers();
+
+  meshSlots_.assign(scene.meshes.size(), 0);
+  meshStats_ = {};
+  meshStats_.meshes = static_cast<uint32_t>(scene.meshes.size());
+  std::unordered_map<const Mesh*, uint32_t> slotByAsset;
   for (size_t i = 0; i < scene.meshes.size(); ++i) {
-    const Mesh& src = scene.meshes[i];
-    MeshGpu& dst = meshBuffers_[i];
-
-    const VkDeviceSize vertexBytes = sizeof(VertexSkinned) * src.vertices.size();
-    const VkDeviceSize indexBytes = sizeof(uint32_t) * src.indices.size();
-    const VkDeviceSize safeVertexBytes = std::max<VkDeviceSize>(vertexBytes, sizeof(uint32_t));
-    const VkDeviceSize safeIndexBytes = std::max<VkDeviceSize>(indexBytes, sizeof(uint32_t));
-
-    dst.vertex = CreateBuffer(safeVertexBytes,
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-                              VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                              true);
-    dst.index = CreateBuffer(safeIndexBytes,
-                             VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-                             VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                             true);
-
-    if (vertexBytes > 0) {
-      std::memcpy(dst.vertex.mapped, src.vertices.data(), static_cast<size_t>(vertexBytes));
+    const std::shared_ptr<const Mesh>& asset = scene.meshes[i].Handle();
+    // Morphed meshes are blended per MeshId into vertex copies of their own.
+    const bool shareable = asset->morphTargets.empty();
+    if (shareable) {
+      if (const auto shared = slotByAsset.find(asset.get()); shared != slotByAsset.end()) {
+        meshSlots_[i] = shared->second;
+        ++meshStats_.shared;
+        continue;
+      }
     }
-    if (indexBytes > 0) {
-      std::memcpy(dst.index.mapped, src.indices.data(), static_cast<size_t>(indexBytes));
+    meshSlots_[i] = static_cast<uint32_t>(meshBuffers_.size());
+    if (shareable) {
+      slotByAsset[asset.get()] = meshSlots_[i];
     }
+    if (const auto kept = previous.find(asset.get()); kept != previous.end()) {
+      meshBuffers_.push_back(kept->second);
+      previous.erase(kept);
+      ++meshStats_.reused;
+      continue;
+    }
+    // Arrays released after an earlier upload are read back from the cooked file for the copy.
+    const LoadResult<SharedAsset<Mesh>> arrays = AcquireMeshArrays(scene.meshes[i]);
+    if (!arrays.Ok()) {
+      ++meshStats_.unavailable;
+    }
+    meshBuffers_.push_back(CreateMeshGpu(arrays.Ok() ? **arrays.value : *asset));
+    meshBuffers_.back().asset = asset;
+    ++meshStats_.uploaded;
+  }
+  for (auto& [asset, gpu] : previous) {
+    DestroyMeshGpu(gpu);
+  }
+}
 
-    dst.indexCount = static_cast<uint32_t>(src.indices.size());
+SkinPbrPass::MeshGpu SkinPbrPass::CreateMeshGpu(const Mesh& src) {
+  MeshGpu dst;
+  const bool packed = src.vertexLayout != VertexLayout::kFull &&
+                      src.packedVertices.size() == src.vertices.size() * VertexStride(src.vertexLayout);
+  dst.layout = packed ? src.vertexLayout : VertexLayout::kFull;
+  dst.indexType = UsesShortIndices(src) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+
+  const VkDeviceSize vertexBytes = packed ? src.packedVertices.size() : sizeof(VertexSkinned) * src.vertices.size();
+  const VkDeviceSize indexBytes = GpuIndexBytes(src);
+  dst.boundsOffset = packed ? (vertexBytes + kPackedBoundsAlignment - 1) / kPackedBoundsAlignment * kPackedBoundsAlignment : 0;
+  const VkDeviceSize bufferBytes = packed ? dst.boundsOffset + sizeof(PackedBoundsGpu) : vertexBytes;
+  const VkDeviceSize safeVertexBytes = std::max<VkDeviceSize>(bufferBytes, sizeof(uint32_t));
+  const VkDeviceSize safeIndexBytes = std::max<VkDeviceSize>(indexBytes, sizeof(uint32_t));
+
+  dst.vertex = CreateBuffer(safeVertexBytes,
+                            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                            true);
+  dst.index = CreateBuffer(safeIndexBytes,
+                           VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                           true);
+
+  if (packed) {
+    std::memcpy(dst.vertex.mapped, src.packedVertices.data(), static_cast<size_t>(vertexBytes));
+    PackedBoundsGpu bounds;
+    bounds.min = Vec4(src.localBounds.min, 0.0F);
+    bounds.extent = Vec4(src.localBounds.max - src.localBounds.min, 0.0F);
+    std::memcpy(static_cast<uint8_t*>(dst.vertex.mapped) + dst.boundsOffset, &bounds, sizeof(bounds));
+  } else if (vertexBytes > 0) {
+    std::memcpy(dst.vertex.mapped, src.vertices.data(), static_cast<size_t>(vertexBytes));
+  }
+  if (indexBytes > 0 && dst.indexType == VK_INDEX_TYPE_UINT16) {
+    auto* out = static_cast<uint16_t*>(dst.index.mapped);
+    for (size_t k = 0; k < src.indices.size(); ++k) {
+      out[k] = static_cast<uint16_t>(src.indices[k]);
+    }
+  } else if (indexBytes > 0) {
+    std::memcpy(dst.index.mapped, src.indices.data(), static_cast<size_t>(indexBytes));
   }
 
-  uploadedScene_ = &scene;
+  if (!src.morphTargets.empty() && vertexBytes > 0) {
+    for (size_t f = 0; f < kFramesInFlight; ++f) {
+      dst.morphVertex[f] = CreateBuffer(safeVertexBytes,
+                                        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                        true);
+      std::memcpy(dst.morphVertex[f].mapped, dst.vertex.mapped, static_cast<size_t>(bufferBytes));
+    }
+  }
+
+  dst.indexCount = static_cast<uint32_t>(src.indices.size());
+  return dst;
+}
+
+void SkinPbrPass::UpdateMorphedVertices(uint32_t frameIndex, const RenderScene& scene) {
+  if (scene.morphedMeshes == nullptr) {
+    return;
+  }
+  const Scene& src = *scene.scene;
+  for (const MorphedMesh& morphed : *scene.morphedMeshes) {
+    if (morphed.mesh >= meshSlots_.size() || morphed.mesh >= src.meshes.size() || morphed.vertices == nullptr ||
+        morphed.moved == nullptr) {
+      continue;
+    }
+    MeshGpu& gpu = meshBuffers_[meshSlots_[morphed.mesh]];
+    const Mesh& mesh = src.meshes[morphed.mesh];
+    Buffer& buffer = gpu.morphVertex[frameIndex];
+    if (buffer.mapped == nullptr || morphed.vertices->size() != mesh.vertices.size()) {
+      continue;
+    }
+    // This copy last held `displaced` moved; those get whatever the blender has now, at rest or not.
+    const size_t stride = VertexStride(gpu.layout);
+    auto* out = static_cast<uint8_t*>(buffer.mapped);
+    std::vector<uint32_t>& displaced = gpu.morphDisplaced[frameIndex];
+    const std::vector<uint32_t>& previous = displaced;
+    for (const std::vector<uint32_t>* list : {&previous, morphed.moved}) {
+      for (const uint32_t v : *list) {
+        if (v >= morphed.vertices->size()) {
+          continue;
+        }
+        if (gpu.layout == VertexLayout::kFull) {
+          std::memcpy(out + v * stride, &(*morphed.vertices)[v], sizeof(VertexSkinned));
+        } else {
+          PackVertex(mesh, (*morphed.vertices)[v], out + v * stride);
+        }
+      }
+    }
+    displaced = *morphed.moved;
+  }
+}
+
+void SkinPbrPass::BindMeshGeometry(VkCommandBuffer cmd, const MeshGpu& mesh, uint32_t frameIndex) const {
+  const VkBuffer vertex =
+      mesh.morphVertex[frameIndex].handle != VK_NULL_HANDLE ? mesh.morphVertex[frameIndex].handle : mesh.vertex.handle;
+  if (mesh.layout == VertexLayout::kFull) {
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(cmd, 0, 1, &vertex, &offset);
+  } else {
+    const std::array<VkBuffer, 2> buffers = {vertex, vertex};
+    const std::array<VkDeviceSize, 2> offsets = {0, mesh.boundsOffset};
+    vkCmdBindVertexBuffers(cmd, 0, static_cast<uint32_t>(buffers.size()), buffers.data(), offsets.data());
+  }
+  vkCmdBindIndexBuffer(cmd, mesh.index.handle, 0, mesh.indexType);
+}
+
+void SkinPbrPass::CullClusters(const Mesh& mesh,
+                               const Mat4& world,
+                               const RenderScene& scene,
+                               uint32_t boneOffset,
+                               const Frustum& frustum,
+                               const Vec3* towardLight) {
+  const std::vector<Mat4>* palette = boneOffset < kMaxBoneMatrices - 1 ? scene.skinPalette : nullptr;
+  clusterVisible_.assign(mesh.clusters.size(), 0);
+  for (size_t c = 0; c < mesh.clusters.size(); ++c) {
+    BoundingSphere sphere;
+    NormalCone cone;
+    ComputeClusterPoseBounds(mesh, mesh.clusters[c], palette, boneOffset, sphere, cone);
+    if (!SphereInFrustum(frustum, TransformSphere(world, sphere))) {
+      continue;
+    }
+    // The shadow pipeline keeps only light-facing-away triangles (no Y flip in the light projection).
+    if (towardLight != nullptr && ConeFacesAlong(TransformCone(world, cone), *towardLight)) {
+      continue;
+    }
+    clusterVisible_[c] = 1;
+  }
+}
+
+uint32_t SkinPbrPass::DrawVisibleClusters(VkCommandBuffer cmd, const Mesh& mesh, uint32_t submeshIndex) const {
+  uint32_t draws = 0;
+  uint32_t rangeFirst = 0;
+  uint32_t rangeCount = 0;
+  for (size_t c = 0; c < mesh.clusters.size(); ++c) {
+    const MeshCluster& cluster = mesh.clusters[c];
+    if (cluster.submesh != submeshIndex || clusterVisible_[c] == 0) {
+      continue;
+    }
+    if (rangeCount > 0 && rangeFirst + rangeCount == cluster.firstIndex) {
+      rangeCount += cluster.indexCount;
+      continue;
+    }
+    if (rangeCount > 0) {
+      vkCmdDrawIndexed(cmd, rangeCount, 1, rangeFirst, 0, 0);
+      ++draws;
+    }
+    rangeFirst = cluster.firstIndex;
+    rangeCount = cluster.indexCount;
+  }
+  if (rangeCount > 0) {
+    vkCmdDrawIndexed(cmd, rangeCount, 1, rangeFirst, 0, 0);
+    ++draws;
+  }
+  return draws;
 }
 
 void SkinPbrPass::EnsureSceneUploaded(const Scene* scene) {
@@ -1382,12 +1811,7 @@ void SkinPbrPass::EnsureSceneUploaded(const Scene* scene) {
   }
 }
 
-Mat4 SkinPbrPass::ComputeDirectionalShadowMatrix(const RenderScene& scene) const {
-  if (scene.scene == nullptr || scene.scene->nodes.empty()) {
-    return Mat4(1.0F);
-  }
-
-  const Scene& src = *scene.scene;
+Vec3 SkinPbrPass::ComputeShadowLightDirection(const Scene& src) const {
   Vec3 lightDir = glm::normalize(Vec3(0.3F, -1.0F, 0.4F));
 
   std::vector<NodeId> lightNodes(src.lights.size(), kInvalidNodeId);
@@ -1419,6 +1843,16 @@ Mat4 SkinPbrPass::ComputeDirectionalShadowMatrix(const RenderScene& scene) const
     lightDir = glm::normalize(dir);
     break;
   }
+  return lightDir;
+}
+
+Mat4 SkinPbrPass::ComputeDirectionalShadowMatrix(const RenderScene& scene) const {
+  if (scene.scene == nullptr || scene.scene->nodes.empty()) {
+    return Mat4(1.0F);
+  }
+
+  const Scene& src = *scene.scene;
+  const Vec3 lightDir = ComputeShadowLightDirection(src);
 
   Vec3 bmin(FLT_MAX);
   Vec3 bmax(-FLT_MAX);
@@ -1487,6 +1921,11 @@ void SkinPbrPass::UpdateFrameUbo(uint32_t frameIndex,
   ubo.view = frameContext.view;
   ubo.proj = frameContext.proj;
   ubo.lightViewProj = ComputeDirectionalShadowMatrix(scene);
+  cameraViewProj_ = frameContext.proj * frameContext.view;
+  lightViewProj_ = ubo.lightViewProj;
+  if (scene.scene != nullptr) {
+    shadowLightDir_ = ComputeShadowLightDirection(*scene.scene);
+  }
   ubo.cameraPos = Vec4(frameContext.cameraPos, 1.0F);
   ubo.lightMeta = Vec4(static_cast<float>(lightCount), 0.12F, 1.18F, 1.22F);
   ubo.debugFlags = Vec4(frameContext.enableNormalMap, frameContext.enableSpecularIbl, elapsedSec_, outputColorLevels_);
@@ -1568,22 +2007,20 @@ uint32_t SkinPbrPass::UpdateLightBuffer(uint32_t frameIndex, const RenderScene&
 
 void SkinPbrPass::UpdateBoneBuffer(uint32_t frameIndex, const RenderScene& scene) {
   const std::vector<Mat4>* palette = scene.skinPalette;
-  const Mat4 identity(1.0F);
   auto* dstMats = static_cast<Mat4*>(boneSsboBuffers_[frameIndex].mapped);
 
-  for (size_t i = 0; i < kMaxBoneMatrices; ++i) {
-    dstMats[i] = identity;
-  }
-
+  // Only the per-skin palettes in use are written; the last slot is the identity that unskinned
+  // draws point at, and no draw reads the slots in between.
+  dstMats[kMaxBoneMatrices - 1] = Mat4(1.0F);
   if (palette == nullptr || palette->empty()) {
     return;
   }
 
   const size_t srcCount = palette->size();
-  const size_t count = std::min<size_t>(srcCount, kMaxBoneMatrices);
+  const size_t count = std::min<size_t>(srcCount, kMaxBoneMatrices - 1);
   std::memcpy(dstMats, palette->data(), sizeof(Mat4) * count);
 
-  if (srcCount > kMaxBoneMatrices && !boneOverflowWarned_) {
+  if (srcCount > kMaxBoneMatrices - 1 && !boneOverflowWarned_) {
     boneOverflowWarned_ = true;
   }
 }
@@ -1609,8 +2046,11 @@ void SkinPbrPass::Initialize(VkPhysicalDevice physicalDevice,
   elapsedSec_ = 0.0F;
 
   vertSpvPath_ = shaderDir + "/skin_pbr.vert.spv";
+  packedVertSpvPath_ = shaderDir + "/skin_pbr_packed.vert.spv";
   fragSpvPath_ = shaderDir + "/skin_pbr.frag.spv";
+  ormFragSpvPath_ = shaderDir + "/skin_pbr_orm.frag.spv";
   shadowVertSpvPath_ = shaderDir + "/skin_shadow.vert.spv";
+  packedShadowVertSpvPath_ = shaderDir + "/skin_shadow_packed.vert.spv";
 
   transientCommandPool_ = CreateTransientCommandPool();
 
@@ -1725,13 +2165,29 @@ void SkinPbrPass::PrepareFrame(uint32_t frameIndex, const RenderScene& scene, co
   const uint32_t lightCount = UpdateLightBuffer(frameIndex, scene);
   UpdateFrameUbo(frameIndex, scene, frameContext, lightCount);
   UpdateBoneBuffer(frameIndex, scene);
+  UpdateMorphedVertices(frameIndex, scene);
+  SelectNodeLods(scene, frameContext);
+}
+
+void SkinPbrPass::SelectNodeLods(const RenderScene& scene, const FrameContext& frameContext) {
+  const Scene& src = *scene.scene;
+  nodeLods_.resize(src.nodes.size(), 0);
+  for (NodeId nodeId = 0; nodeId < src.nodes.size(); ++nodeId) {
+    const Node& node = src.nodes[nodeId];
+    if (!node.mesh.has_value() || *node.mesh >= src.meshes.size()) {
+      continue;
+    }
+    const Mesh& mesh = src.meshes[*node.mesh];
+    const float screenSize = ProjectedScreenSize(mesh.localBounds, node.worldCurrent, frameContext.view, frameContext.proj);
+    nodeLods_[nodeId] = SelectLod(mesh, screenSize, nodeLods_[nodeId], lodSettings_);
+  }
 }
 
 void SkinPbrPass::RenderShadow(VkCommandBuffer cmd, uint32_t frameIndex, const RenderScene& scene) {
   if (!initialized_ || scene.scene == nullptr || scene.scene->meshes.empty()) {
     return;
   }
-  if (shadowRenderPass_ == VK_NULL_HANDLE || shadowFramebuffer_ == VK_NULL_HANDLE || shadowPipeline_ == VK_NULL_HANDLE) {
+  if (shadowRenderPass_ == VK_NULL_HANDLE || shadowFramebuffer_ == VK_NULL_HANDLE || shadowPipelines_[0] == VK_NULL_HANDLE) {
     return;
   }
 
@@ -1762,7 +2218,11 @@ void SkinPbrPass::RenderShadow(VkCommandBuffer cmd, uint32_t frameIndex, const R
   vkCmdSetViewport(cmd, 0, 1, &viewport);
   vkCmdSetScissor(cmd, 0, 1, &scissor);
   vkCmdSetDepthBias(cmd, 1.75F, 0.0F, 3.5F);
-  vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, shadowPipeline_);
+  vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, shadowPipelines_[0]);
+  VertexLayout boundLayout = VertexLayout::kFull;
+  const Frustum lightFrustum = ExtractFrustum(lightViewProj_);
+  clusterStats_.shadowVisible = 0;
+  clusterStats_.draws = 0;
 
   std::array<VkDescriptorSet, 2> globalSets = {frameSets_[frameIndex], boneSets_[frameIndex]};
   vkCmdBindDescriptorSets(cmd,
@@ -1774,28 +2234,30 @@ void SkinPbrPass::RenderShadow(VkCommandBuffer cmd, uint32_t frameIndex, const R
                           0,
                           nullptr);
 
-  for (const Node& node : scene.scene->nodes) {
+  for (NodeId nodeId = 0; nodeId < scene.scene->nodes.size(); ++nodeId) {
+    const Node& node = scene.scene->nodes[nodeId];
     if (!node.mesh.has_value()) {
       continue;
     }
 
     const MeshId meshId = *node.mesh;
-    if (meshId >= meshBuffers_.size() || meshId >= scene.scene->meshes.size()) {
+    if (meshId >= meshSlots_.size() || meshId >= scene.scene->meshes.size() ||
+        meshBuffers_[meshSlots_[meshId]].indexCount == 0) {
       continue;
     }
 
-    const MeshGpu& gpuMesh = meshBuffers_[meshId];
+    const MeshGpu& gpuMesh = meshBuffers_[meshSlots_[meshId]];
     const Mesh& mesh = scene.scene->meshes[meshId];
-    VkDeviceSize offset = 0;
-    vkCmdBindVertexBuffers(cmd, 0, 1, &gpuMesh.vertex.handle, &offset);
-    vkCmdBindIndexBuffer(cmd, gpuMesh.index.handle, 0, VK_INDEX_TYPE_UINT32);
+    const uint32_t lod = nodeId < nodeLods_.size() ? nodeLods_[nodeId] : 0;
+    if (gpuMesh.layout != boundLayout) {
+      boundLayout = gpuMesh.layout;
+      vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, shadowPipelines_[static_cast<size_t>(boundLayout)]);
+    }
+    BindMeshGeometry(cmd, gpuMesh, frameIndex);
 
     float boneOffset = static_cast<float>(kMaxBoneMatrices - 1);
-    if (node.skin.has_value() && *node.skin < scene.scene->skins.size()) {
-      const Skin& skin = scene.scene->skins[*node.skin];
-      if (scene.skeletonPaletteOffsets != nullptr && skin.skeleton < scene.skeletonPaletteOffsets->size()) {
-        boneOffset = static_cast<float>((*scene.skeletonPaletteOffsets)[skin.skeleton]);
-      }
+    if (node.skin.has_value() && scene.skinPaletteOffsets != nullptr && *node.skin < scene.skinPaletteOffsets->size()) {
+      boneOffset = static_cast<float>((*scene.skinPaletteOffsets)[*node.skin]);
     }
 
     ShadowPush push{};
@@ -1809,7 +2271,17 @@ void SkinPbrPass::RenderShadow(VkCommandBuffer cmd, uint32_t frameIndex, const R
                        sizeof(ShadowPush),
                        &push);
 
-    for (const Submesh& submesh : mesh.submeshes) {
+    if (clusterCulling_ && lod == 0 && !mesh.clusters.empty()) {
+      const Vec3 towardLight = -shadowLightDir_;
+      CullClusters(mesh, node.worldCurrent, scene, static_cast<uint32_t>(boneOffset), lightFrustum, &towardLight);
+      for (uint32_t submeshIndex = 0; submeshIndex < mesh.submeshes.size(); ++submeshIndex) {
+        clusterStats_.draws += DrawVisibleClusters(cmd, mesh, submeshIndex);
+      }
+      clusterStats_.shadowVisible += static_cast<uint32_t>(std::count(clusterVisible_.begin(), clusterVisible_.end(), 1));
+      continue;
+    }
+
+    for (const Submesh& submesh : LodSubmeshes(mesh, lod)) {
       vkCmdDrawIndexed(cmd, submesh.indexCount, 1, submesh.firstIndex, 0, 0);
     }
   }
@@ -1842,7 +2314,11 @@ void SkinPbrPass::Render(VkCommandBuffer cmd,
   vkCmdSetViewport(cmd, 0, 1, &viewport);
   vkCmdSetScissor(cmd, 0, 1, &scissor);
 
-  vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_);
+  // Pipelines follow each mesh's vertex layout and each material's set layout (UsesPackedOrm).
+  VkPipeline boundPipeline = VK_NULL_HANDLE;
+  const Frustum cameraFrustum = ExtractFrustum(cameraViewProj_);
+  clusterStats_.clusters = 0;
+  clusterStats_.visible = 0;
 
   std::array<VkDescriptorSet, 2> globalSets = {frameSets_[frameIndex], boneSets_[frameIndex]};
   vkCmdBindDescriptorSets(cmd,
@@ -1854,37 +2330,50 @@ void SkinPbrPass::Render(VkCommandBuffer cmd,
                           0,
                           nullptr);
 
-  for (const Node& node : scene.scene->nodes) {
+  for (NodeId nodeId = 0; nodeId < scene.scene->nodes.size(); ++nodeId) {
+    const Node& node = scene.scene->nodes[nodeId];
     if (!node.mesh.has_value()) {
       continue;
     }
 
     const MeshId meshId = *node.mesh;
-    if (meshId >= meshBuffers_.size() || meshId >= scene.scene->meshes.size()) {
+    if (meshId >= meshSlots_.size() || meshId >= scene.scene->meshes.size() ||
+        meshBuffers_[meshSlots_[meshId]].indexCount == 0) {
       continue;
     }
 
-    const MeshGpu& gpuMesh = meshBuffers_[meshId];
+    const MeshGpu& gpuMesh = meshBuffers_[meshSlots_[meshId]];
     const Mesh& mesh = scene.scene->meshes[meshId];
+    const uint32_t lod = nodeId < nodeLods_.size() ? nodeLods_[nodeId] : 0;
 
-    VkDeviceSize offset = 0;
-    vkCmdBindVertexBuffers(cmd, 0, 1, &gpuMesh.vertex.handle, &offset);
-    vkCmdBindIndexBuffer(cmd, gpuMesh.index.handle, 0, VK_INDEX_TYPE_UINT32);
+    BindMeshGeometry(cmd, gpuMesh, frameIndex);
+
+    uint32_t boneOffset = kMaxBoneMatrices - 1;
+    if (node.skin.has_value() && scene.skinPaletteOffsets != nullptr && *node.skin < scene.skinPaletteOffsets->size()) {
+      boneOffset = (*scene.skinPaletteOffsets)[*node.skin];
+    }
+
+    // Main pipeline is double-sided, so only the frustum test applies here.
+    const bool clustered = clusterCulling_ && lod == 0 && !mesh.clusters.empty();
+    if (clustered) {
+      CullClusters(mesh, node.worldCurrent, scene, boneOffset, cameraFrustum, nullptr);
+      const auto visible = static_cast<uint32_t>(std::count(clusterVisible_.begin(), clusterVisible_.end(), 1));
+      clusterStats_.clusters += static_cast<uint32_t>(mesh.clusters.size());
+      clusterStats_.visible += visible;
+      if (visible == 0) {
+        continue;
+      }
+    }
 
-    for (const Submesh& submesh : mesh.submeshes) {
+    const std::vector<Submesh>& submeshes = LodSubmeshes(mesh, lod);
+    for (uint32_t submeshIndex = 0; submeshIndex < submeshes.size(); ++submeshIndex) {
+      const Submesh& submesh = submeshes[submeshIndex];
       DrawPush push;
       push.model = node.worldCurrent;
-      push.mrAlpha.w = static_cast<float>(kMaxBoneMatrices - 1);
+      push.mrAlpha.w = static_cast<float>(boneOffset);
       push.flags = Vec4(0.0F);
 
-      if (node.skin.has_value() && *node.skin < scene.scene->skins.size()) {
-        const Skin& skin = scene.scene->skins[*node.skin];
-        if (scene.skeletonPaletteOffsets != nullptr && skin.skeleton < scene.skeletonPaletteOffsets->size()) {
-          push.mrAlpha.w = static_cast<float>((*scene.skeletonPaletteOffsets)[skin.skeleton]);
-        }
-      }
-
-      VkDescriptorSet materialSet = materialSets_.empty() ? VK_NULL_HANDLE : materialSets_[0];
+      size_t setIndex = 0;
 
       if (submesh.material < scene.scene->materials.size()) {
         const Material& material = scene.scene->materials[submesh.material];
@@ -1902,28 +2391,40 @@ void SkinPbrPass::Render(VkCommandBuffer cmd,
                             push.mrAlpha.w);
 
         if (submesh.material < materialSets_.size()) {
-          materialSet = materialSets_[submesh.material];
+          setIndex = submesh.material;
         }
       }
 
-      if (materialSet != VK_NULL_HANDLE) {
+      const bool packedOrm = setIndex < materialOrm_.size() && materialOrm_[setIndex] != 0;
+      const VkPipelineLayout layout = packedOrm ? ormPipelineLayout_ : pipelineLayout_;
+      const VkPipeline pipeline = (packedOrm ? ormPipelines_ : pipelines_)[static_cast<size_t>(gpuMesh.layout)];
+      if (pipeline != boundPipeline) {
+        boundPipeline = pipeline;
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+      }
+      if (setIndex < materialSets_.size()) {
         vkCmdBindDescriptorSets(cmd,
                                 VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                pipelineLayout_,
+                                layout,
                                 2,
                                 1,
-                                &materialSet,
+                                &materialSets_[setIndex],
                                 0,
                                 nullptr);
       }
 
       vkCmdPushConstants(cmd,
-                         pipelineLayout_,
+                         layout,
                          VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
                          0,
                          sizeof(DrawPush),
                          &push);
 
+      if (clustered) {
+        clusterStats_.draws += DrawVisibleClusters(cmd, mesh, submeshIndex);
+        continue;
+      }
+
       vkCmdDrawIndexed(cmd,
                        submesh.indexCount,
                        1,
@@ -3,11 +3,14 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 #include <vulkan/vulkan.h>
 
+#include "render/scene/ClusterCulling.hpp"
+#include "render/scene/LodSelection.hpp"
 #include "render/scene/RenderScene.hpp"
 
 namespace vv {
@@ -16,6 +19,29 @@ class SkinPbrPass {
  public:
   static constexpr uint32_t kFramesInFlight = 2;
 
+  struct ClusterCullStats {
+    uint32_t clusters = 0;
+    uint32_t visible = 0;        // main pass, frustum
+    uint32_t shadowVisible = 0;  // shadow pass, light frustum + normal cone
+    uint32_t draws = 0;          // indexed draws issued for clustered meshes, both passes
+  };
+
+  struct MeshUploadStats {
+    uint32_t meshes = 0;       // scene meshes (MeshId count)
+    uint32_t uploaded = 0;     // meshes copied to the GPU by the last upload
+    uint32_t shared = 0;       // MeshIds drawing from the buffers of another MeshId holding the same asset
+    uint32_t reused = 0;       // buffers kept from the previously uploaded scene
+    uint32_t unavailable = 0;  // released arrays that could not be read back; those meshes draw nothing
+  };
+
+  struct TextureUploadStats {
+    uint32_t textures = 0;   // scene textures (TextureId count)
+    uint32_t uploaded = 0;   // images copied to the GPU by the last upload
+    uint32_t shared = 0;     // textures folded onto an image with the same content in this scene
+    uint32_t reused = 0;     // images kept from the previously uploaded scene
+    uint32_t streaming = 0;  // Texture::streaming entries still drawn with their defaults
+  };
+
   void Initialize(VkPhysicalDevice physicalDevice,
                   VkDevice device,
                   VkQueue graphicsQueue,
@@ -35,6 +61,23 @@ class SkinPbrPass {
               const RenderScene& scene,
               const FrameContext& frameContext);
 
+  // Meshes with clusters are drawn per visible cluster range instead of per submesh.
+  void SetClusterCulling(bool enabled) { clusterCulling_ = enabled; }
+  bool ClusterCullingEnabled() const { return clusterCulling_; }
+  const ClusterCullStats& LastClusterStats() const { return clusterStats_; }
+
+  void SetLodSettings(const LodSelectionSettings& settings) { lodSettings_ = settings; }
+  const LodSelectionSettings& LodSettings() const { return lodSettings_; }
+  const std::vector<uint32_t>& NodeLods() const { return nodeLods_; }  // index by NodeId
+
+  const MeshUploadStats& LastMeshUploadStats() const { return meshStats_; }
+  const TextureUploadStats& LastTextureUploadStats() const { return textureStats_; }
+
+  // Uploads the listed textures of the scene already on the GPU (streamed in after it was
+  // published) and rewrites only the material sets that sample them; geometry stays as it is.
+  void UpdateTextures(const Scene& scene, const std::vector<TextureId>& ids);
+  bool SceneUploaded(const Scene& scene) const { return uploadedScene_ == &scene; }
+
  private:
   struct Buffer {
     VkBuffer handle = VK_NULL_HANDLE;
@@ -47,14 +90,25 @@ class SkinPbrPass {
     Buffer vertex;
     Buffer index;
     uint32_t indexCount = 0;
+    VkIndexType indexType = VK_INDEX_TYPE_UINT32;
+    VertexLayout layout = VertexLayout::kFull;
+    VkDeviceSize boundsOffset = 0;  // packed layouts: dequantization block behind the vertices
+    // Meshes with morph targets draw from one copy of `vertex` per frame in flight; each copy
+    // remembers the vertices it holds displaced, so an update rewrites only those and the moved ones.
+    std::array<Buffer, kFramesInFlight> morphVertex{};
+    std::array<std::vector<uint32_t>, kFramesInFlight> morphDisplaced;
+    std::weak_ptr<const Mesh> asset;  // buffers are shared by asset identity (SharedAsset)
   };
 
+
   struct TextureGpu {
     VkImage image = VK_NULL_HANDLE;
     VkDeviceMemory memory = VK_NULL_HANDLE;
     VkImageView view = VK_NULL_HANDLE;
     VkFormat format = VK_FORMAT_R8G8B8A8_UNORM;
     uint32_t mipLevels = 1;
+    uint64_t contentKey = 0;  // TextureGpuKey of the source; 0 = shared by asset identity only
+    std::weak_ptr<const Texture> asset;
   };
 
   struct FrameUbo {
@@ -104,6 +158,8 @@ class SkinPbrPass {
   void DestroyPerFrameBuffers();
   void AllocateAndWriteFrameDescriptorSets();
   void RebuildMaterialDescriptorSets(const Scene& scene);
+  void WriteMaterialDescriptorSet(size_t index, const Scene& scene);
+  VkImageView MaterialTextureView(TextureId id, TextureId fallback) const;
 
   void CreatePipeline(VkRenderPass renderPass);
   void DestroyPipeline();
@@ -117,9 +173,23 @@ class SkinPbrPass {
 
   void EnsureSceneUploaded(const Scene* scene);
   void UploadScene(const Scene& scene);
+  void UploadMeshes(const Scene& scene);
+  MeshGpu CreateMeshGpu(const Mesh& src);
+  void DestroyMeshGpu(MeshGpu& mesh);
   void DestroySceneBuffers();
+  void UpdateMorphedVertices(uint32_t frameIndex, const RenderScene& scene);
+  void BindMeshGeometry(VkCommandBuffer cmd, const MeshGpu& mesh, uint32_t frameIndex) const;
+  void CullClusters(const Mesh& mesh,
+                    const Mat4& world,
+                    const RenderScene& scene,
+                    uint32_t boneOffset,
+                    const Frustum& frustum,
+                    const Vec3* towardLight);
+  uint32_t DrawVisibleClusters(VkCommandBuffer cmd, const Mesh& mesh, uint32_t submeshIndex) const;
   void UploadTextures(const Scene& scene);
+  void UploadTextureImages(const Scene& scene, const std::vector<size_t>& uploads);  // scene texture indices
   void DestroyTextures();
+  void DestroyTextureGpu(TextureGpu& texture);
   void CreateIblEnvironmentTexture();
   void DestroyIblEnvironmentTexture();
 
@@ -127,8 +197,10 @@ class SkinPbrPass {
                       const RenderScene& scene,
                       const FrameContext& frameContext,
                       uint32_t lightCount);
+  Vec3 ComputeShadowLightDirection(const Scene& scene) const;
   Mat4 ComputeDirectionalShadowMatrix(const RenderScene& scene) const;
   void UpdateBoneBuffer(uint32_t frameIndex, const RenderScene& scene);
+  void SelectNodeLods(const RenderScene& scene, const FrameContext& frameContext);
   uint32_t UpdateLightBuffer(uint32_t frameIndex, const RenderScene& scene);
 
   VkCommandPool CreateTransientCommandPool() const;
@@ -138,7 +210,8 @@ class SkinPbrPass {
   void TransitionImageLayout(VkCommandBuffer cmd,
                              VkImage image,
                              VkImageLayout oldLayout,
-                             VkImageLayout newLayout) const;
+                             VkImageLayout newLayout,
+                             uint32_t levelCount = 1) const;
 
   VkPhysicalDevice physicalDevice_ = VK_NULL_HANDLE;
   VkDevice device_ = VK_NULL_HANDLE;
@@ -150,11 +223,14 @@ class SkinPbrPass {
   VkDescriptorSetLayout frameSetLayout_ = VK_NULL_HANDLE;
   VkDescriptorSetLayout boneSetLayout_ = VK_NULL_HANDLE;
   VkDescriptorSetLayout materialSetLayout_ = VK_NULL_HANDLE;
+  VkDescriptorSetLayout ormMaterialSetLayout_ = VK_NULL_HANDLE;  // UsesPackedOrm materials: 5 maps
   VkPipelineLayout pipelineLayout_ = VK_NULL_HANDLE;
-  VkPipeline pipeline_ = VK_NULL_HANDLE;
+  VkPipelineLayout ormPipelineLayout_ = VK_NULL_HANDLE;
+  std::array<VkPipeline, kVertexLayoutCount> pipelines_{};
+  std::array<VkPipeline, kVertexLayoutCount> ormPipelines_{};
   VkRenderPass shadowRenderPass_ = VK_NULL_HANDLE;
   VkPipelineLayout shadowPipelineLayout_ = VK_NULL_HANDLE;
-  VkPipeline shadowPipeline_ = VK_NULL_HANDLE;
+  std::array<VkPipeline, kVertexLayoutCount> shadowPipelines_{};
   VkFramebuffer shadowFramebuffer_ = VK_NULL_HANDLE;
   VkImage shadowDepthImage_ = VK_NULL_HANDLE;
   VkDeviceMemory shadowDepthMemory_ = VK_NULL_HANDLE;
@@ -168,20 +244,38 @@ class SkinPbrPass {
   std::array<VkDescriptorSet, kFramesInFlight> frameSets_{};
   std::array<VkDescriptorSet, kFramesInFlight> boneSets_{};
   std::vector<VkDescriptorSet> materialSets_;
+  std::vector<uint8_t> materialOrm_;  // per set: allocated with ormMaterialSetLayout_
 
   std::array<Buffer, kFramesInFlight> frameUboBuffers_{};
   std::array<Buffer, kFramesInFlight> boneSsboBuffers_{};
   std::array<Buffer, kFramesInFlight> lightSsboBuffers_{};
 
-  std::vector<MeshGpu> meshBuffers_;
-  std::vector<TextureGpu> textureGpus_;
+  std::vector<MeshGpu> meshBuffers_;     // unique mesh assets
+  std::vector<uint32_t> meshSlots_;      // MeshId -> meshBuffers_ index
+  MeshUploadStats meshStats_{};
+  std::vector<TextureGpu> textureGpus_;  // unique images
+  std::vector<uint32_t> textureSlots_;   // TextureId -> textureGpus_ index
+  TextureUploadStats textureStats_{};
   TextureGpu iblEnvironment_{};
   const Scene* uploadedScene_ = nullptr;
   bool boneOverflowWarned_ = false;
 
+  bool clusterCulling_ = true;
+  ClusterCullStats clusterStats_{};
+  std::vector<uint8_t> clusterVisible_;
+  Mat4 cameraViewProj_{1.0F};
+  Mat4 lightViewProj_{1.0F};
+  Vec3 shadowLightDir_{0.0F, -1.0F, 0.0F};
+
+  LodSelectionSettings lodSettings_{};
+  std::vector<uint32_t> nodeLods_;
+
   std::string vertSpvPath_;
+  std::string packedVertSpvPath_;
   std::string fragSpvPath_;
+  std::string ormFragSpvPath_;
   std::string shadowVertSpvPath_;
+  std::string packedShadowVertSpvPath_;
 
   float outputColorLevels_ = 255.0F;
   float elapsedSec_ = 0.0F;
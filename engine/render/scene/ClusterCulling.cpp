@@ -0,0 +1,136 @@
+#include "render/scene/ClusterCulling.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/geometric.hpp>
+
+namespace vv {
+namespace {
+
+constexpr float kHalfPi = 1.57079632679F;
+constexpr float kPi = 3.14159265359F;
+
+float MaxAxisScale(const Mat4& m) {
+  const float sx = glm::dot(Vec3(m[0]), Vec3(m[0]));
+  const float sy = glm::dot(Vec3(m[1]), Vec3(m[1]));
+  const float sz = glm::dot(Vec3(m[2]), Vec3(m[2]));
+  return std::sqrt(std::max({sx, sy, sz}));
+}
+
+Vec4 NormalizePlane(const Vec4& p) {
+  const float len = glm::length(Vec3(p));
+  return len > 0.0F ? p / len : p;
+}
+
+}  // namespace
+
+Frustum ExtractFrustum(const Mat4& viewProj) {
+  // Rows of the column-major matrix.
+  const Vec4 r0(viewProj[0][0], viewProj[1][0], viewProj[2][0], viewProj[3][0]);
+  const Vec4 r1(viewProj[0][1], viewProj[1][1], viewProj[2][1], viewProj[3][1]);
+  const Vec4 r2(viewProj[0][2], viewProj[1][2], viewProj[2][2], viewProj[3][2]);
+  const Vec4 r3(viewProj[0][3], viewProj[1][3], viewProj[2][3], viewProj[3][3]);
+
+  Frustum f;
+  f.planes[0] = NormalizePlane(r3 + r0);
+  f.planes[1] = NormalizePlane(r3 - r0);
+  f.planes[2] = NormalizePlane(r3 + r1);
+  f.planes[3] = NormalizePlane(r3 - r1);
+  f.planes[4] = NormalizePlane(r2);
+  f.planes[5] = NormalizePlane(r3 - r2);
+  return f;
+}
+
+bool SphereInFrustum(const Frustum& frustum, const BoundingSphere& sphere) {
+  for (const Vec4& plane : frustum.planes) {
+    if (glm::dot(Vec3(plane), sphere.center) + plane.w < -sphere.radius) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ConeFacesAlong(const NormalCone& cone, const Vec3& dir) {
+  if (cone.spread >= kHalfPi) {
+    return false;
+  }
+  return glm::dot(cone.axis, dir) >= std::sin(cone.spread);
+}
+
+BoundingSphere MergeSpheres(const BoundingSphere& a, const BoundingSphere& b) {
+  const Vec3 d = b.center - a.center;
+  const float dist = glm::length(d);
+  if (dist + b.radius <= a.radius) {
+    return a;
+  }
+  if (dist + a.radius <= b.radius) {
+    return b;
+  }
+  BoundingSphere out;
+  out.radius = 0.5F * (dist + a.radius + b.radius);
+  out.center = a.center + d * ((out.radius - a.radius) / dist);
+  return out;
+}
+
+BoundingSphere TransformSphere(const Mat4& m, const BoundingSphere& sphere) {
+  BoundingSphere out;
+  out.center = Vec3(m * Vec4(sphere.center, 1.0F));
+  out.radius = sphere.radius * MaxAxisScale(m);
+  return out;
+}
+
+NormalCone TransformCone(const Mat4& m, const NormalCone& cone) {
+  NormalCone out = cone;
+  const Vec3 axis = glm::mat3(m) * cone.axis;
+  const float len = glm::length(axis);
+  if (len <= 1e-12F) {
+    out.spread = kPi;
+    return out;
+  }
+  out.axis = axis / len;
+  return out;
+}
+
+void ComputeClusterPoseBounds(const Mesh& mesh,
+                              const MeshCluster& cluster,
+                              const std::vector<Mat4>* palette,
+                              uint32_t paletteOffset,
+                              BoundingSphere& sphere,
+                              NormalCone& cone) {
+  sphere = BoundingSphere{cluster.center, cluster.radius};
+  cone = NormalCone{cluster.coneAxis, cluster.coneSpread};
+  if (palette == nullptr || cluster.boneCount == 0) {
+    return;
+  }
+
+  bool first = true;
+  Vec3 axisSum(0.0F);
+  for (uint32_t b = cluster.firstBone; b < cluster.firstBone + cluster.boneCount; ++b) {
+    const ClusterBoneBounds& bone = mesh.clusterBones[b];
+    const size_t paletteIndex = static_cast<size_t>(paletteOffset) + bone.joint;
+    const Mat4 m = paletteIndex < palette->size() ? (*palette)[paletteIndex] : Mat4(1.0F);
+
+    const BoundingSphere moved = TransformSphere(m, BoundingSphere{bone.center, bone.radius});
+    sphere = first ? moved : MergeSpheres(sphere, moved);
+    first = false;
+    axisSum += TransformCone(m, NormalCone{cluster.coneAxis, cluster.coneSpread}).axis;
+  }
+
+  const float axisLen = glm::length(axisSum);
+  if (cluster.coneSpread >= kHalfPi || axisLen <= 1e-6F) {
+    cone = NormalCone{cluster.coneAxis, kPi};
+    return;
+  }
+  cone.axis = axisSum / axisLen;
+  float widest = 0.0F;
+  for (uint32_t b = cluster.firstBone; b < cluster.firstBone + cluster.boneCount; ++b) {
+    const size_t paletteIndex = static_cast<size_t>(paletteOffset) + mesh.clusterBones[b].joint;
+    const Mat4 m = paletteIndex < palette->size() ? (*palette)[paletteIndex] : Mat4(1.0F);
+    const Vec3 boneAxis = TransformCone(m, NormalCone{cluster.coneAxis, cluster.coneSpread}).axis;
+    widest = std::max(widest, std::acos(std::clamp(glm::dot(boneAxis, cone.axis), -1.0F, 1.0F)));
+  }
+  cone.spread = std::min(kPi, widest + cluster.coneSpread);
+}
+
+}  // namespace vv
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "core/math/MathTypes.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+struct BoundingSphere {
+  Vec3 center{0.0F};
+  float radius = 0.0F;
+};
+
+struct NormalCone {
+  Vec3 axis{0.0F, 0.0F, 1.0F};
+  float spread = 3.14159265F;  // half-angle in radians
+};
+
+struct Frustum {
+  std::array<Vec4, 6> planes{};  // xyz = inward normal, w = distance; normalized
+};
+
+// Plane extraction for Vulkan clip space (0 <= z <= w).
+Frustum ExtractFrustum(const Mat4& viewProj);
+bool SphereInFrustum(const Frustum& frustum, const BoundingSphere& sphere);
+
+// True when every normal in the cone has a non-negative dot product with dir.
+bool ConeFacesAlong(const NormalCone& cone, const Vec3& dir);
+
+BoundingSphere MergeSpheres(const BoundingSphere& a, const BoundingSphere& b);
+
+// Bounds of a cluster in model space for the current pose. Each skinned vertex is a convex
+// combination of palette[j] * p over its joints, so the union of every joint's bind-pose
+// sphere moved by that joint's matrix encloses the cluster; normals are handled the same way
+// with the cone (rotation + uniform scale assumed). palette == nullptr means bind pose.
+void ComputeClusterPoseBounds(const Mesh& mesh,
+                              const MeshCluster& cluster,
+                              const std::vector<Mat4>* palette,
+                              uint32_t paletteOffset,
+                              BoundingSphere& sphere,
+                              NormalCone& cone);
+
+BoundingSphere TransformSphere(const Mat4& m, const BoundingSphere& sphere);
+NormalCone TransformCone(const Mat4& m, const NormalCone& cone);
+
+}  // namespace vv
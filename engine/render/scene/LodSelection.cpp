@@ -0,0 +1,66 @@
+#include "render/scene/LodSelection.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/geometric.hpp>
+
+namespace vv {
+namespace {
+
+float LodError(const Mesh& mesh, uint32_t lod) {
+  return lod == 0 ? 0.0F : mesh.lods[lod - 1].error;
+}
+
+}  // namespace
+
+float ProjectedScreenSize(const AABB& bounds, const Mat4& world, const Mat4& view, const Mat4& proj) {
+  const Vec3 center = 0.5F * (bounds.min + bounds.max);
+  const float localRadius = 0.5F * glm::length(bounds.max - bounds.min);
+  const float scale = std::sqrt(std::max({glm::dot(Vec3(world[0]), Vec3(world[0])),
+                                          glm::dot(Vec3(world[1]), Vec3(world[1])),
+                                          glm::dot(Vec3(world[2]), Vec3(world[2]))}));
+  const float radius = localRadius * scale;
+
+  const Vec3 viewCenter = Vec3(view * world * Vec4(center, 1.0F));
+  const float distance = glm::length(viewCenter);
+  if (distance <= radius) {
+    return 1.0F;
+  }
+  // proj[1][1] = cot(fovY / 2); the sign flips for Vulkan's inverted Y.
+  return radius * std::fabs(proj[1][1]) / distance;
+}
+
+uint32_t SelectLod(const Mesh& mesh, float screenSize, uint32_t currentLod, const LodSelectionSettings& settings) {
+  const auto levelCount = static_cast<uint32_t>(mesh.lods.size() + 1);
+  if (!settings.enabled || levelCount == 1) {
+    return 0;
+  }
+
+  // Errors are relative to the bounding radius, i.e. half the projected diameter.
+  const auto fits = [&](uint32_t lod, float margin) {
+    return LodError(mesh, lod) * 0.5F * screenSize * margin <= settings.maxScreenError;
+  };
+  const float band = 1.0F + std::max(settings.hysteresis, 0.0F);
+
+  uint32_t lod = std::min(currentLod, levelCount - 1);
+  if (!fits(lod, 1.0F / band)) {
+    while (lod > 0 && !fits(lod, 1.0F)) {
+      --lod;
+    }
+    return lod;
+  }
+  while (lod + 1 < levelCount && fits(lod + 1, band)) {
+    ++lod;
+  }
+  return lod;
+}
+
+const std::vector<Submesh>& LodSubmeshes(const Mesh& mesh, uint32_t lod) {
+  if (lod == 0 || lod > mesh.lods.size()) {
+    return mesh.submeshes;
+  }
+  return mesh.lods[lod - 1].submeshes;
+}
+
+}  // namespace vv
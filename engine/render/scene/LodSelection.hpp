@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+
+#include "core/math/MathTypes.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace vv {
+
+struct LodSelectionSettings {
+  float maxScreenError = 0.0015F;  // allowed deviation as a fraction of viewport height (~1.5 px at 1080p)
+  float hysteresis = 0.25F;        // relative band around each switch point
+  bool enabled = true;
+};
+
+// Diameter of the world-space bounding sphere of `bounds` projected onto the viewport, as a
+// fraction of its height. `proj` is a perspective projection.
+float ProjectedScreenSize(const AABB& bounds, const Mat4& world, const Mat4& view, const Mat4& proj);
+
+// Coarsest LOD whose error stays under the budget at `screenSize`. Moving to a coarser level
+// needs (1 + hysteresis) headroom, and the current level is kept until it exceeds the budget
+// by the same factor, so objects sitting on a threshold do not flicker between levels.
+uint32_t SelectLod(const Mesh& mesh, float screenSize, uint32_t currentLod, const LodSelectionSettings& settings);
+
+// Submesh ranges for a level; LOD 0 is Mesh::submeshes.
+const std::vector<Submesh>& LodSubmeshes(const Mesh& mesh, uint32_t lod);
+
+}  // namespace vv
@@ -16,10 +16,19 @@ struct FrameContext {
   float enableSpecularIbl = 1.0F;
 };
 
+// A mesh drawn with its morph targets applied (MorphBlender): `vertices` replaces Mesh::vertices
+// and `moved` lists the ones that differ from it.
+struct MorphedMesh {
+  MeshId mesh = 0;
+  const std::vector<VertexSkinned>* vertices = nullptr;
+  const std::vector<uint32_t>* moved = nullptr;
+};
+
 struct RenderScene {
   const Scene* scene = nullptr;
   const std::vector<Mat4>* skinPalette = nullptr;
-  const std::vector<uint32_t>* skeletonPaletteOffsets = nullptr;  // index by SkeletonId
+  const std::vector<uint32_t>* skinPaletteOffsets = nullptr;  // index by SkinId; see Skin::joints
+  const std::vector<MorphedMesh>* morphedMeshes = nullptr;
 };
 
 }  // namespace vv
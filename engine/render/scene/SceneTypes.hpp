@@ -1,13 +1,18 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "core/math/MathTypes.hpp"
+#include "core/memory/PixelBuffer.hpp"
 #include "core/types/CommonTypes.hpp"
+#include "render/scene/SharedAsset.hpp"
 
 namespace vv {
 
@@ -15,6 +20,11 @@ enum class PixelFormat {
   kUnknown,
   kR8G8B8A8,
   kR8G8B8A8_SRGB,
+  kBC1,  // block formats: sRGB-ness follows Texture::srgb
+  kBC3,
+  kBC4,
+  kBC5,
+  kBC7,
 };
 
 struct AABB {
@@ -31,20 +41,127 @@ struct VertexSkinned {
   std::array<float, kMaxBoneInfluence> weights{1.0F, 0.0F, 0.0F, 0.0F};
 };
 
+enum class VertexLayout : uint8_t {
+  kFull,
+  kPackedJoints8,
+  kPackedJoints16,
+};
+
+constexpr size_t kVertexLayoutCount = 3;
+
+// Quantized skinned vertex: position is unorm16 inside Mesh::localBounds (w = tangent sign),
+// normal/tangent are octahedral snorm16, uv is half2, weights are unorm8 summing to 255.
+template <typename JointT>
+struct PackedVertexSkinned {
+  std::array<uint16_t, 4> position{0, 0, 0, 0};
+  std::array<int16_t, 4> normalTangent{0, 0, 0, 0};
+  std::array<uint16_t, 2> uv0{0, 0};
+  std::array<JointT, kMaxBoneInfluence> joints{0, 0, 0, 0};
+  std::array<uint8_t, kMaxBoneInfluence> weights{255, 0, 0, 0};
+};
+
+using PackedVertexSkinned8 = PackedVertexSkinned<uint8_t>;
+using PackedVertexSkinned16 = PackedVertexSkinned<uint16_t>;
+static_assert(sizeof(PackedVertexSkinned8) == 28);
+static_assert(sizeof(PackedVertexSkinned16) == 32);
+
+inline uint32_t VertexStride(VertexLayout layout) {
+  switch (layout) {
+    case VertexLayout::kPackedJoints8:
+      return static_cast<uint32_t>(sizeof(PackedVertexSkinned8));
+    case VertexLayout::kPackedJoints16:
+      return static_cast<uint32_t>(sizeof(PackedVertexSkinned16));
+    case VertexLayout::kFull:
+    default:
+      return static_cast<uint32_t>(sizeof(VertexSkinned));
+  }
+}
+
 struct Submesh {
   uint32_t firstIndex = 0;
   uint32_t indexCount = 0;
   MaterialId material = 0;
 };
 
+constexpr uint32_t kMaxClusterVertices = 64;
+constexpr uint32_t kMaxClusterTriangles = 124;
+
+struct ClusterBoneBounds {
+  uint32_t joint = 0;  // as stored in VertexSkinned::joints
+  Vec3 center{0.0F};   // bind-pose sphere of the cluster vertices this joint influences
+  float radius = 0.0F;
+};
+
+struct MeshCluster {
+  uint32_t firstIndex = 0;  // contiguous range inside its submesh's range of Mesh::indices
+  uint32_t indexCount = 0;
+  uint32_t vertexCount = 0;
+  uint32_t submesh = 0;
+  Vec3 center{0.0F};
+  float radius = 0.0F;
+  Vec3 coneAxis{0.0F, 0.0F, 1.0F};
+  float coneSpread = 3.14159265F;  // half-angle in radians; >= pi/2 never culls
+  uint32_t firstBone = 0;          // into Mesh::clusterBones
+  uint32_t boneCount = 0;
+};
+
+struct MeshLod {
+  std::vector<Submesh> submeshes;  // parallel to Mesh::submeshes; ranges live in Mesh::indices
+  float error = 0.0F;              // max surface deviation relative to the localBounds radius
+};
+
+// Sparse blend shape: only the vertices it moves, with their deltas quantized to snorm16 of the
+// largest delta per axis (delta = q / 32767 * scale). Tangents are not morphed.
+struct MorphTarget {
+  std::string name;
+  std::vector<uint32_t> vertices;                      // ascending
+  std::array<std::vector<int16_t>, 3> positionDeltas;  // per axis, parallel to `vertices`
+  std::array<std::vector<int16_t>, 3> normalDeltas;    // empty when the target keeps the normals
+  Vec3 positionScale{0.0F};
+  Vec3 normalScale{0.0F};
+};
+
+// Where an asset whose CPU arrays were released (ApplyCpuResidency) is read back from.
+struct CookedLocation {
+  std::string path;    // .vvscene the asset was read from or written to; empty when there is none
+  uint32_t index = 0;  // MeshId or TextureId in that file
+};
+
 struct Mesh {
   std::string name;
   std::vector<VertexSkinned> vertices;
   std::vector<uint32_t> indices;
   std::vector<Submesh> submeshes;
   AABB localBounds;
+  VertexLayout vertexLayout = VertexLayout::kFull;
+  std::vector<uint8_t> packedVertices;  // GPU stream when vertexLayout != kFull
+  std::vector<MeshCluster> clusters;
+  std::vector<ClusterBoneBounds> clusterBones;
+  std::vector<MeshLod> lods;  // coarser levels; Mesh::submeshes is LOD 0
+  std::vector<MorphTarget> morphTargets;
+  std::vector<float> morphWeights;  // rest weights, one per target
+  CookedLocation cooked;
+  bool arraysReleased = false;  // vertices, indices and packedVertices dropped; see AcquireMeshArrays
 };
 
+// Index 0xFFFF is left unused so it stays free as the 16-bit primitive restart value.
+constexpr size_t kMaxShortIndexVertices = 65535;
+
+inline bool UsesShortIndices(const Mesh& mesh) {
+  return mesh.vertices.size() <= kMaxShortIndexVertices;
+}
+
+inline uint64_t GpuVertexBytes(const Mesh& mesh) {
+  if (mesh.vertexLayout != VertexLayout::kFull) {
+    return mesh.packedVertices.size();
+  }
+  return static_cast<uint64_t>(mesh.vertices.size()) * sizeof(VertexSkinned);
+}
+
+inline uint64_t GpuIndexBytes(const Mesh& mesh) {
+  return static_cast<uint64_t>(mesh.indices.size()) * (UsesShortIndices(mesh) ? sizeof(uint16_t) : sizeof(uint32_t));
+}
+
 struct Bone {
   std::string name;
   NodeId node = kInvalidNodeId;
@@ -60,9 +177,12 @@ struct Skeleton {
   std::unordered_map<std::string, uint32_t> boneMap;
 };
 
+// Vertex joint indices of the skinned mesh are local to its skin: joint j is skeleton bone
+// joints[j], so each skin uploads only the bones it uses. An empty map means the identity.
 struct Skin {
   SkeletonId skeleton = 0;
   MeshId mesh = 0;
+  std::vector<uint32_t> joints;
   std::vector<Mat4> palette;
 };
 
@@ -83,11 +203,29 @@ struct NodeTrack {
   std::vector<KeyVec3> sclKeys;
 };
 
+// Weights of the morph targets of the node's mesh, `targets` per key, key after key.
+struct MorphWeightTrack {
+  NodeId node = kInvalidNodeId;
+  uint32_t targets = 0;
+  std::vector<float> times;
+  std::vector<float> weights;
+};
+
 struct AnimationClip {
   std::string name;
   float durationSec = 0.0F;
   float ticksPerSec = 30.0F;
   std::vector<NodeTrack> tracks;
+  std::vector<MorphWeightTrack> morphTracks;
+};
+
+// Where the pixels of a lazily imported texture come from; decoded on demand (TextureRegistry).
+struct TextureSource {
+  std::string path;                                   // encoded image file
+  std::shared_ptr<const std::vector<uint8_t>> bytes;  // embedded encoded image, or raw texels
+  uint32_t rawWidth = 0;                              // > 0: `bytes` (or `path`) holds BGRA8 texels of this size
+  uint32_t rawHeight = 0;
+  uint64_t sizeBytes = 0;                             // encoded size; with contentHash the cache key (decoded textures too)
 };
 
 struct Texture {
@@ -96,7 +234,14 @@ struct Texture {
   uint32_t height = 0;
   PixelFormat format = PixelFormat::kUnknown;
   bool srgb = false;
-  std::vector<uint8_t> pixels;
+  bool normalMap = false;   // tangent-space normals; mips are renormalized
+  uint32_t mipLevels = 1;   // pixels holds every level back to back, level 0 first
+  uint64_t contentHash = 0; // hash of the source bytes; equal hashes share storage and GPU images
+  PixelBuffer pixels;       // empty until decoded when `source` is set
+  TextureSource source;
+  bool streaming = false;   // still decoding (AsyncImport); materials sample the defaults meanwhile
+  CookedLocation cooked;
+  bool pixelsReleased = false;  // pixels dropped with no source to decode; see AcquireTexturePixels
 };
 
 struct Material {
@@ -153,15 +298,17 @@ struct Node {
   std::optional<LightId> light;
 };
 
+// Meshes, skeletons, clips and textures are shared assets: copying a scene, or interning it in
+// AssetRegistry, shares them instead of duplicating vertices, keys and pixels.
 struct Scene {
   std::vector<NodeId> roots;
   std::vector<Node> nodes;
-  std::vector<Mesh> meshes;
-  std::vector<Skeleton> skeletons;
+  std::vector<SharedAsset<Mesh>> meshes;
+  std::vector<SharedAsset<Skeleton>> skeletons;
   std::vector<Skin> skins;
-  std::vector<AnimationClip> clips;
+  std::vector<SharedAsset<AnimationClip>> clips;
   std::vector<Material> materials;
-  std::vector<Texture> textures;
+  std::vector<SharedAsset<Texture>> textures;
   std::vector<Light> lights;
 };
 
@@ -174,6 +321,8 @@ struct SceneStats {
   size_t clipCount = 0;
   size_t lightCount = 0;
   uint64_t triangleCount = 0;
+  uint64_t sourceGeometryBytes = 0;  // float vertices + 32-bit indices
+  uint64_t gpuGeometryBytes = 0;     // layout actually uploaded
 };
 
 inline SceneStats ComputeSceneStats(const Scene& scene) {
@@ -185,11 +334,15 @@ inline SceneStats ComputeSceneStats(const Scene& scene) {
   stats.clipCount = scene.clips.size();
   stats.lightCount = scene.lights.size();
 
-  for (const auto& mesh : scene.meshes) {
-    stats.triangleCount += mesh.indices.size() / 3;
+  for (const Mesh& mesh : scene.meshes) {
+    for (const auto& submesh : mesh.submeshes) {
+      stats.triangleCount += submesh.indexCount / 3;
+    }
+    stats.sourceGeometryBytes += mesh.vertices.size() * sizeof(VertexSkinned) + mesh.indices.size() * sizeof(uint32_t);
+    stats.gpuGeometryBytes += GpuVertexBytes(mesh) + GpuIndexBytes(mesh);
   }
 
-  for (const auto& skeleton : scene.skeletons) {
+  for (const Skeleton& skeleton : scene.skeletons) {
     stats.boneCount += skeleton.bones.size();
   }
 
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <memory>
+#include <utility>
+
+namespace vv {
+
+// A reference-counted asset that scenes hold by value but never copy: copying a SharedAsset copies
+// the reference, so scenes and instances built from the same content (see AssetRegistry) share one
+// mesh, skeleton, clip or texture. Reads go through `->`/`*`; Edit() copies the asset first when
+// anyone else still holds it, so a change never shows through another holder. Holders of one asset
+// must not be edited from different threads at once.
+template <typename T>
+class SharedAsset {
+ public:
+  SharedAsset() : asset_(std::make_shared<T>()) {}
+  SharedAsset(T asset) : asset_(std::make_shared<T>(std::move(asset))) {}
+  // `asset` must be another SharedAsset's Handle().
+  explicit SharedAsset(std::shared_ptr<const T> asset) : asset_(std::move(asset)) {}
+
+  const T& operator*() const { return *asset_; }
+  const T* operator->() const { return asset_.get(); }
+  operator const T&() const { return *asset_; }
+
+  T& Edit() {
+    if (asset_.use_count() > 1) {
+      asset_ = std::make_shared<T>(*asset_);
+    }
+    // Every asset is created non-const by this class, so writing through it is well defined.
+    return const_cast<T&>(*asset_);
+  }
+
+  [[nodiscard]] const std::shared_ptr<const T>& Handle() const { return asset_; }
+  [[nodiscard]] bool SharedWith(const SharedAsset& other) const { return asset_ == other.asset_; }
+
+ private:
+  std::shared_ptr<const T> asset_;
+};
+
+}  // namespace vv
@@ -151,6 +151,7 @@ VulkanDevice VulkanDevice::Create(VkInstance instance, VkSurfaceKHR surface) {
 
   VkPhysicalDeviceFeatures features{};
   features.samplerAnisotropy = supportedFeatures.samplerAnisotropy;
+  features.textureCompressionBC = supportedFeatures.textureCompressionBC;
 
   VkDeviceCreateInfo createInfo{VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
   createInfo.queueCreateInfoCount = 1;
@@ -336,6 +336,13 @@ void VulkanRenderer::RecordCommandBuffer(VkCommandBuffer cmd, uint32_t imageInde
   VkCheck(vkEndCommandBuffer(cmd), "vkEndCommandBuffer failed");
 }
 
+void VulkanRenderer::UpdateTextures(const Scene& scene, const std::vector<TextureId>& ids) {
+  if (!initialized_ || ids.empty()) {
+    return;
+  }
+  skinPbrPass_.UpdateTextures(scene, ids);
+}
+
 void VulkanRenderer::RenderFrame(const RenderScene& scene, const FrameContext& frame) {
   if (!initialized_) {
     return;
@@ -22,6 +22,10 @@ class VulkanRenderer {
 
   void Initialize(IWindow& window, bool enableValidation = false);
   void RenderFrame(const RenderScene& scene, const FrameContext& frame);
+  // Call between frames with textures of the rendered scene whose pixels arrived (AsyncImport).
+  void UpdateTextures(const Scene& scene, const std::vector<TextureId>& ids);
+  // True once RenderFrame has copied `scene` to the GPU; its CPU arrays may be released from then on.
+  bool SceneUploaded(const Scene& scene) const { return skinPbrPass_.SceneUploaded(scene); }
   void Shutdown();
 
  private:
@@ -37,13 +37,18 @@ layout(set = 0, binding = 2) uniform sampler2D uIblEnvTex;
 layout(set = 0, binding = 3) uniform sampler2D uShadowMap;
 
 layout(set = 2, binding = 0) uniform sampler2D uBaseColorTex;
-layout(set = 2, binding = 1) uniform sampler2D uMetalRoughTex;
 layout(set = 2, binding = 2) uniform sampler2D uNormalTex;
 layout(set = 2, binding = 3) uniform sampler2D uEmissiveTex;
 layout(set = 2, binding = 4) uniform sampler2D uSpecularTex;
+#if defined(VV_PACKED_ORM)
+// Built as skin_pbr_orm.frag.spv: occlusion, roughness and metallic share one texture (R, G, B).
+layout(set = 2, binding = 1) uniform sampler2D uOrmTex;
+#else
+layout(set = 2, binding = 1) uniform sampler2D uMetalRoughTex;
 layout(set = 2, binding = 5) uniform sampler2D uMetallicTex;
 layout(set = 2, binding = 6) uniform sampler2D uRoughnessTex;
 layout(set = 2, binding = 7) uniform sampler2D uOcclusionTex;
+#endif
 
 const float kPi = 3.14159265359;
 
@@ -118,7 +123,9 @@ vec2 EnvBrdfApprox(float roughness, float NdotV) {
 }
 
 vec3 NormalFromMap(float signedNormalScale) {
-  vec3 tangentNormal = texture(uNormalTex, vUV).xyz * 2.0 - 1.0;
+  // z is rebuilt from xy so BC5 (two-channel) normal maps decode the same as RGBA8 ones.
+  vec2 nXY = texture(uNormalTex, vUV).xy * 2.0 - 1.0;
+  vec3 tangentNormal = vec3(nXY, sqrt(max(1.0 - dot(nXY, nXY), 0.0)));
   if (signedNormalScale < 0.0) {
     tangentNormal.y = -tangentNormal.y;
   }
@@ -205,9 +212,17 @@ void main() {
   vec3 albedo = baseColorTexel.rgb * vBaseColor.rgb;
   float alpha = baseColorTexel.a * vBaseColor.a;
 
+#if defined(VV_PACKED_ORM)
+  vec3 orm = texture(uOrmTex, vUV).rgb;
+  float occlusionSample = orm.r;
+  float roughnessSample = orm.g;
+  float metallicSample = orm.b;
+#else
   vec3 mrPacked = texture(uMetalRoughTex, vUV).rgb;
+  float occlusionSample = texture(uOcclusionTex, vUV).r;
   float metallicSample = mix(mrPacked.b, texture(uMetallicTex, vUV).r, step(0.5, useSeparateMR));
   float roughnessSample = mix(mrPacked.g, texture(uRoughnessTex, vUV).r, step(0.5, useSeparateMR));
+#endif
   float metallic = saturate(vMrAlpha.x * metallicSample);
   float roughness = clamp(vMrAlpha.y * roughnessSample, 0.04, 1.0);
 
@@ -272,7 +287,7 @@ void main() {
     litAccum += brdf * lightColor * attenuation;
   }
 
-  float ao = mix(1.0, texture(uOcclusionTex, vUV).r, clamp(occlusionStrength, 0.0, 1.0));
+  float ao = mix(1.0, occlusionSample, clamp(occlusionStrength, 0.0, 1.0));
   vec3 emissive = texture(uEmissiveTex, vUV).rgb * vEmissive.rgb * max(vEmissive.w, 0.0);
   vec3 Fv = F0 + (1.0 - F0) * pow(1.0 - NdotV, 5.0);
   vec3 kd = (1.0 - Fv) * (1.0 - metallic);
@@ -1,5 +1,6 @@
 #include <cassert>
 #include <cmath>
+#include <vector>
 
 #include "render/animation/Animator.hpp"
 
@@ -45,5 +46,21 @@ int main() {
   const float x = palette[0][3][0];
   assert(std::fabs(x - 0.5F) < 1e-3F);
 
+  // A skin's palette holds only its joints, in local order; bones no skin uses are not posed.
+  vv::Bone extra = bone;
+  extra.name = "Unused";
+  extra.inverseBind = glm::translate(vv::Mat4(1.0F), vv::Vec3(0.0F, 2.0F, 0.0F));
+  scene.skeletons[0].Edit().bones.push_back(extra);
+  scene.skeletons[0].Edit().bones.push_back(bone);
+  scene.skins.push_back(vv::Skin{.skeleton = 0, .mesh = 0, .joints = {2, 0}, .palette = {}});
+  animator.Bind(&scene, 0);
+  animator.SetClip(0, true);
+  animator.Update(0.25F);
+  std::vector<vv::Mat4> skinPalette;
+  animator.AppendSkinPalette(scene.skins[0], skinPalette);
+  assert(skinPalette.size() == 2);
+  assert(std::fabs(skinPalette[0][3][0] - 0.25F) < 1e-3F && std::fabs(skinPalette[1][3][0] - 0.25F) < 1e-3F);
+  assert(animator.Palette()[1] == vv::Mat4(1.0F));
+
   return 0;
 }
@@ -0,0 +1,89 @@
+#include <cassert>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "asset/index/AssetDirectoryIndex.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+void Touch(const fs::path& file) {
+  fs::create_directories(file.parent_path());
+  std::ofstream(file) << "x";
+}
+
+// Backdates a directory so its mtime is settled and a later change is visible.
+void Age(const fs::path& directory, std::chrono::minutes age) {
+  fs::last_write_time(directory, fs::file_time_type::clock::now() - age);
+}
+
+}  // namespace
+
+int main() {
+  const fs::path base = fs::temp_directory_path() / "vv_unit_asset_index";
+  fs::remove_all(base);
+  const fs::path root = base / "assets";
+  const fs::path cache = base / "cache";
+  Touch(root / "a" / "b" / "tex.png");
+  Touch(root / "c" / "Other.PNG");
+  Touch(root / "top.png");
+  Touch(root / "c" / "top.png");
+  for (const fs::path& dir : {root, root / "a", root / "a" / "b", root / "c"}) {
+    Age(dir, std::chrono::minutes(60));
+  }
+
+  {
+    vv::AssetDirectoryIndex index;
+    index.SetCacheDirectory(cache);
+    index.SetRevalidateInterval(std::chrono::milliseconds(0));
+    const auto tex = index.Find(root, "TEX.png");
+    assert(tex.has_value() && fs::equivalent(*tex, root / "a" / "b" / "tex.png"));
+    assert(index.Stats().directoryScans == 4 && index.Stats().cacheSaves == 1);
+
+    // Searches below a root reuse it and only see files under the search directory.
+    assert(index.Find(root / "a", "tex.png").has_value());
+    assert(!index.Find(root / "c", "tex.png").has_value());
+    assert(fs::equivalent(*index.Find(root / "c", "other.png"), root / "c" / "Other.PNG"));
+    assert(fs::equivalent(*index.Find(root, "top.png"), root / "top.png"));  // shallowest first
+    const vv::AssetIndexStats stats = index.Stats();
+    assert(stats.roots == 1 && stats.directories == 4 && stats.files == 4);
+    assert(stats.directoryScans == 4);  // the miss swept mtimes but listed nothing again
+  }
+
+  // A new process restores the index from disk and lists only directories that changed.
+  Touch(root / "c" / "new.png");
+  Age(root / "c", std::chrono::minutes(30));
+  {
+    vv::AssetDirectoryIndex index;
+    index.SetCacheDirectory(cache);
+    index.SetRevalidateInterval(std::chrono::milliseconds(0));
+    assert(index.Find(root, "new.png").has_value());
+    assert(index.Stats().cacheLoads == 1 && index.Stats().directoryScans == 1);
+
+    // A removed directory drops its files; the stale hit is rechecked instead of returned.
+    fs::remove_all(root / "a" / "b");
+    Age(root / "a", std::chrono::minutes(20));
+    assert(!index.Find(root, "tex.png").has_value());
+    assert(index.Stats().directories == 3);
+  }
+
+  {
+    vv::AssetDirectoryIndex index;
+    index.SetCacheDirectory(cache);
+    index.SetRevalidateInterval(std::chrono::hours(1));
+    index.AddRoot(root);
+    if (index.SetWatching(true)) {
+      // Without sweeps, new directories are picked up from change notifications.
+      Touch(root / "d" / "e" / "watched.png");
+      const auto watched = index.Find(root, "watched.png");
+      assert(watched.has_value() && fs::equivalent(*watched, root / "d" / "e" / "watched.png"));
+      assert(index.Stats().watchEvents > 0 && index.Stats().validations == 1);
+    }
+  }
+
+  fs::remove_all(base);
+  return 0;
+}
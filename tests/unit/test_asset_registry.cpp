@@ -0,0 +1,161 @@
+#include <cassert>
+#include <cstdint>
+#include <string>
+
+#include "asset/import/SceneImporter.hpp"
+#include "asset/registry/AssetRegistry.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+vv::Mesh MakeMesh(const std::string& name, float offset) {
+  vv::Mesh mesh;
+  mesh.name = name;
+  for (int i = 0; i < 3; ++i) {
+    vv::VertexSkinned vertex{};
+    vertex.position = {offset + static_cast<float>(i), 0.0F, 0.0F};
+    mesh.vertices.push_back(vertex);
+  }
+  mesh.indices = {0, 1, 2};
+  mesh.submeshes.push_back({0, 3, 0});
+  return mesh;
+}
+
+vv::AnimationClip MakeClip(const std::string& name) {
+  vv::AnimationClip clip;
+  clip.name = name;
+  clip.durationSec = 1.0F;
+  vv::NodeTrack track;
+  track.node = 0;
+  track.posKeys.push_back({0.0F, {0.0F, 1.0F, 0.0F}});
+  clip.tracks.push_back(track);
+  return clip;
+}
+
+vv::Texture MakeTexture(const std::string& uri, uint8_t value) {
+  vv::Texture texture;
+  texture.uri = uri;
+  texture.width = 2;
+  texture.height = 2;
+  texture.pixels = vv::PixelBuffer(16);
+  for (size_t i = 0; i < texture.pixels.size(); ++i) {
+    texture.pixels[i] = value;
+  }
+  return texture;
+}
+
+vv::Scene MakeScene() {
+  vv::Scene scene;
+  scene.meshes.push_back(MakeMesh("body", 0.0F));
+  scene.meshes.push_back(MakeMesh("prop", 10.0F));
+  scene.clips.push_back(MakeClip("idle"));
+  scene.textures.push_back(MakeTexture("a/albedo.png", 128));
+  return scene;
+}
+
+}  // namespace
+
+int main() {
+  // Copies share; Edit() detaches only when someone else holds the asset.
+  {
+    vv::SharedAsset<vv::Mesh> a = MakeMesh("a", 0.0F);
+    vv::SharedAsset<vv::Mesh> b = a;
+    assert(a.SharedWith(b));
+    const vv::Mesh* before = &*a;
+    b.Edit().name = "b";
+    assert(!a.SharedWith(b) && a->name == "a" && b->name == "b");
+    assert(&*a == before);
+    a.Edit().name = "a2";
+    assert(&*a == before);
+  }
+
+  vv::AssetRegistry registry;
+  {
+    vv::Scene first = MakeScene();
+    vv::Scene second = MakeScene();
+    // The same image under another path is the same texture.
+    second.textures[0] = MakeTexture("b/copy_of_albedo.png", 128);
+    registry.Intern(first);
+    assert(registry.Stats().shared == 0);
+    registry.Intern(second);
+    for (size_t i = 0; i < first.meshes.size(); ++i) {
+      assert(first.meshes[i].SharedWith(second.meshes[i]));
+    }
+    assert(first.clips[0].SharedWith(second.clips[0]));
+    assert(first.textures[0].SharedWith(second.textures[0]));
+    assert(!first.meshes[0].SharedWith(first.meshes[1]));
+
+    const vv::AssetRegistryStats stats = registry.Stats();
+    assert(stats.interned == 8);
+    assert(stats.shared == 4);
+    const uint64_t meshBytes = 2 * (3 * sizeof(vv::VertexSkinned) + 3 * sizeof(uint32_t) + sizeof(vv::Submesh));
+    assert(stats.sharedBytes == meshBytes + sizeof(vv::KeyVec3) + 16);
+    assert(stats.live == 4);
+
+    // Editing one scene's asset leaves the other scene's untouched.
+    second.meshes[0].Edit().indices[0] = 2;
+    assert(!first.meshes[0].SharedWith(second.meshes[0]));
+    assert(first.meshes[0]->indices[0] == 0 && second.meshes[0]->indices[0] == 2);
+
+    // Different content is not folded.
+    vv::Scene third = MakeScene();
+    third.textures[0] = MakeTexture("a/albedo.png", 7);
+    registry.Intern(third);
+    assert(!third.textures[0].SharedWith(first.textures[0]));
+    assert(third.meshes[1].SharedWith(first.meshes[1]));
+  }
+
+  // Entries are weak: once no scene holds an asset, the next import registers it again.
+  assert(registry.Stats().live == 0);
+  {
+    vv::Scene scene = MakeScene();
+    registry.Intern(scene);
+    vv::SharedAsset<vv::Mesh> loose = MakeMesh("body", 0.0F);
+    const vv::SharedAsset<vv::Mesh> interned = registry.Intern(loose);
+    assert(interned.SharedWith(scene.meshes[0]) && !interned.SharedWith(loose));
+    assert(registry.Stats().live == 4);
+  }
+  registry.Clear();
+  assert(registry.Stats().interned == 0);
+
+  // An asset edited in place by its only holder no longer matches its key, so a later scene with
+  // the original content gets a fresh copy instead of the edited one.
+  {
+    vv::Scene scene = MakeScene();
+    registry.Intern(scene);
+    const vv::Mesh* registered = &*scene.meshes[0];
+    scene.meshes[0].Edit().indices[0] = 2;
+    assert(&*scene.meshes[0] == registered);
+    scene.textures[0].Edit().pixelsReleased = true;
+    vv::Scene again = MakeScene();
+    registry.Intern(again);
+    assert(!again.meshes[0].SharedWith(scene.meshes[0]) && again.meshes[0]->indices[0] == 0);
+    assert(!again.textures[0].SharedWith(scene.textures[0]) && !again.textures[0]->pixelsReleased);
+    assert(again.meshes[1].SharedWith(scene.meshes[1]));
+    // The fresh copies are what the registry hands out from now on.
+    vv::Scene third = MakeScene();
+    registry.Intern(third);
+    assert(third.meshes[0].SharedWith(again.meshes[0]) && third.textures[0].SharedWith(again.textures[0]));
+  }
+
+  // The same through the importer: releasing a mesh of an imported scene, then importing the file
+  // again, gives an intact scene.
+  {
+    vv::ImportOptions options;
+    options.nativeFbx = true;
+    options.lodCount = 0;
+    auto first = vv::ImportSceneFile("assets/fbx/spider.fbx", options);
+    assert(first.Ok() && !first.value->meshes.empty());
+    const size_t vertexCount = first.value->meshes[0]->vertices.size();
+    vv::Mesh& released = first.value->meshes[0].Edit();
+    released.vertices.clear();
+    released.indices.clear();
+    released.arraysReleased = true;
+    const auto second = vv::ImportSceneFile("assets/fbx/spider.fbx", options);
+    assert(second.Ok());
+    const vv::Mesh& mesh = *second.value->meshes[0];
+    assert(!mesh.arraysReleased && mesh.vertices.size() == vertexCount && !mesh.indices.empty());
+    assert(second.value->meshes[1].SharedWith(first.value->meshes[1]));
+  }
+  return 0;
+}
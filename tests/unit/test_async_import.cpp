@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "asset/import/AsyncImport.hpp"
+#include "asset/import/SceneImporter.hpp"
+#include "asset/texture/BlockCompression.hpp"
+#include "asset/texture/MipGenerator.hpp"
+#include "asset/texture/TextureRegistry.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// spider.fbx refers to four .jpg images that are not bundled. Written next to a copy of it as PPM
+// (decoders go by content, not extension), they give it file textures.
+std::string MakeTexturedSpider(const fs::path& dir) {
+  fs::create_directories(dir);
+  fs::copy_file("assets/fbx/spider.fbx", dir / "spider.fbx", fs::copy_options::overwrite_existing);
+  uint8_t seed = 0;
+  for (const char* name : {"SpiderTex.jpg", "drkwood2.jpg", "engineflare1.jpg", "wal67ar_small.jpg"}) {
+    std::ofstream file(dir / name, std::ios::binary);
+    file << "P6\n64 32\n255\n";
+    for (uint32_t i = 0; i < 64 * 32 * 3; ++i) {
+      file.put(static_cast<char>(i * 7 + seed));
+    }
+    seed = static_cast<uint8_t>(seed + 50);
+  }
+  return (dir / "spider.fbx").string();
+}
+
+}  // namespace
+
+int main() {
+  vv::TextureRegistry::Global().Clear();
+  const fs::path base = fs::temp_directory_path() / "vv_unit_async_import";
+  fs::remove_all(base);
+  const std::string spider = MakeTexturedSpider(base);
+
+  std::mutex progressMutex;
+  std::vector<vv::AsyncImportProgress> progress;
+  vv::ImportOptions options;
+  options.lodCount = 1;
+
+  // Without file textures the scene is all there is: skeletons and clips arrive with it.
+  {
+    auto taunt = vv::AsyncImport::Start("assets/fbx/Taunt.fbx", options);
+    auto loaded = taunt->TakeScene();
+    assert(loaded.Ok() && !loaded.value->skeletons.empty() && !loaded.value->clips.empty());
+    taunt->Wait();
+    assert(taunt->Progress().texturesTotal == 0 && taunt->ApplyTextureUpdates(*loaded.value).empty());
+  }
+
+  auto import = vv::AsyncImport::Start(spider, options, [&](const vv::AsyncImportProgress& p) {
+    std::lock_guard<std::mutex> lock(progressMutex);
+    progress.push_back(p);
+  });
+
+  // The scene arrives with its geometry; its file textures are still streaming and hold no
+  // pixels, while the defaults every material falls back to are ready.
+  auto loaded = import->TakeScene();
+  assert(loaded.Ok());
+  vv::Scene scene = std::move(*loaded.value);
+  assert(!import->TakeScene().Ok());
+  assert(!scene.meshes.empty());
+  std::vector<vv::TextureId> streaming;
+  for (vv::TextureId id = 0; id < scene.textures.size(); ++id) {
+    const vv::Texture& texture = scene.textures[id];
+    if (id < 5) {
+      assert(!texture.streaming && !texture.pixels.empty());
+    }
+    if (texture.streaming) {
+      assert(texture.pixels.empty() && vv::HasLazySource(texture));
+      streaming.push_back(id);
+    }
+  }
+  assert(!streaming.empty());
+  assert(import->Progress().texturesTotal == streaming.size());
+
+  // Marking textures as streaming never shows through to other scenes: a lazy import of the same
+  // file while the textures stream gets them unmarked.
+  {
+    vv::ImportOptions lazy = options;
+    lazy.lazyTextureDecode = true;
+    const auto during = vv::ImportSceneFile(spider, lazy);
+    assert(during.Ok() && during.value->textures.size() == scene.textures.size());
+    for (const vv::TextureId id : streaming) {
+      assert(!during.value->textures[id]->streaming && vv::HasLazySource(during.value->textures[id]));
+    }
+  }
+
+  // Every streamed texture arrives once, decoded with its mip chain.
+  import->Wait();
+  assert(import->Done());
+  std::vector<vv::TextureId> updated = import->ApplyTextureUpdates(scene);
+  std::sort(updated.begin(), updated.end());
+  assert(updated == streaming);
+  assert(import->ApplyTextureUpdates(scene).empty());
+  for (const vv::TextureId id : streaming) {
+    const vv::Texture& texture = scene.textures[id];
+    assert(!texture.streaming && !vv::HasLazySource(texture));
+    assert(texture.mipLevels == vv::FullMipLevelCount(texture.width, texture.height));
+    assert(texture.pixels.size() == vv::MipLevelOffset(texture.width, texture.height, texture.mipLevels));
+  }
+
+  // Streamed textures go through the AssetRegistry: a synchronous import of the file shares them.
+  {
+    const auto sync = vv::ImportSceneFile(spider, options);
+    assert(sync.Ok());
+    for (const vv::TextureId id : streaming) {
+      assert(sync.value->textures[id].SharedWith(scene.textures[id]) && !sync.value->textures[id]->streaming);
+    }
+  }
+
+  const vv::AsyncImportProgress done = import->Progress();
+  assert(done.phase == vv::AsyncImportPhase::kDone);
+  assert(done.texturesReady == done.texturesTotal && done.texturesFailed == 0);
+  {
+    std::lock_guard<std::mutex> lock(progressMutex);
+    assert(!progress.empty());
+    bool sawImportStage = false;
+    for (size_t i = 0; i < progress.size(); ++i) {
+      sawImportStage |= progress[i].phase == vv::AsyncImportPhase::kImporting && progress[i].stage == "read_file";
+      if (i > 0) {
+        assert(progress[i].texturesReady >= progress[i - 1].texturesReady);
+        assert(progress[i].phase >= progress[i - 1].phase);
+      }
+    }
+    assert(sawImportStage);
+  }
+
+  const vv::ImportReport report = import->Report();
+  assert(report.ok);
+  const vv::ImportStageReport* stream = report.FindStage("texture_stream");
+  assert(stream != nullptr && stream->items == streaming.size());
+  assert(report.counts.texturesDecoded > 0 && report.counts.texturesDecoded <= streaming.size());
+
+  // Pixels can be dropped once uploaded; the texture goes back to its lazy form.
+  vv::Texture released = scene.textures[streaming[0]];
+  vv::ReleaseDecodedPixels(released);
+  assert(vv::HasLazySource(released) && released.mipLevels == 1);
+  assert(released.format == (released.srgb ? vv::PixelFormat::kR8G8B8A8_SRGB : vv::PixelFormat::kR8G8B8A8));
+
+  // Compression, which makes a synchronous import decode eagerly, is applied while streaming.
+  vv::ImportOptions compressed = options;
+  compressed.compressTextures = true;
+  auto compressedImport = vv::AsyncImport::Start(spider, compressed);
+  vv::Scene compressedScene = std::move(*compressedImport->TakeScene().value);
+  compressedImport->Wait();
+  const std::vector<vv::TextureId> compressedIds = compressedImport->ApplyTextureUpdates(compressedScene);
+  assert(compressedIds.size() == streaming.size());
+  for (const vv::TextureId id : compressedIds) {
+    assert(vv::IsBlockCompressed(compressedScene.textures[id]->format));
+  }
+
+  // A failed import still publishes, with the error, and finishes.
+  auto missing = vv::AsyncImport::Start("assets/fbx/does_not_exist.fbx", options);
+  const auto failed = missing->TakeScene();
+  assert(!failed.Ok() && !failed.error.empty());
+  assert(missing->Done() && missing->Progress().phase == vv::AsyncImportPhase::kFailed);
+
+  // Dropping the handle mid-import cancels the remaining decodes and joins.
+  vv::AsyncImport::Start(spider, options).reset();
+  fs::remove_all(base);
+  return 0;
+}
@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "asset/texture/BlockCompression.hpp"
+#include "asset/texture/MipGenerator.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+vv::Texture MakeTexture(uint32_t width, uint32_t height, bool srgb) {
+  vv::Texture texture;
+  texture.width = width;
+  texture.height = height;
+  texture.srgb = srgb;
+  texture.format = srgb ? vv::PixelFormat::kR8G8B8A8_SRGB : vv::PixelFormat::kR8G8B8A8;
+  texture.pixels.resize(static_cast<size_t>(width) * height * 4);
+  return texture;
+}
+
+vv::Texture ColorGradient(uint32_t width, uint32_t height, bool withAlpha) {
+  vv::Texture texture = MakeTexture(width, height, true);
+  uint32_t seed = 12345;
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      seed = seed * 1664525U + 1013904223U;
+      const auto noise = static_cast<int>((seed >> 24U) % 9U) - 4;
+      uint8_t* p = &texture.pixels[(static_cast<size_t>(y) * width + x) * 4];
+      p[0] = static_cast<uint8_t>(std::clamp(static_cast<int>(x * 255 / width) + noise, 0, 255));
+      p[1] = static_cast<uint8_t>(std::clamp(static_cast<int>(y * 255 / height) + noise, 0, 255));
+      p[2] = static_cast<uint8_t>(128 + 100 * std::sin(static_cast<float>(x + y) * 0.05F));
+      p[3] = withAlpha ? static_cast<uint8_t>((x * 7 + y * 3) & 0xFFU) : 255;
+    }
+  }
+  return texture;
+}
+
+vv::Texture GrayMask(uint32_t width, uint32_t height) {
+  vv::Texture texture = MakeTexture(width, height, false);
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      uint8_t* p = &texture.pixels[(static_cast<size_t>(y) * width + x) * 4];
+      const auto v = static_cast<uint8_t>(128 + 120 * std::cos(static_cast<float>(x) * 0.11F) * std::sin(static_cast<float>(y) * 0.07F));
+      p[0] = p[1] = p[2] = v;
+      p[3] = 255;
+    }
+  }
+  return texture;
+}
+
+vv::Texture NormalMap(uint32_t width, uint32_t height) {
+  vv::Texture texture = MakeTexture(width, height, false);
+  texture.normalMap = true;
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      const float nx = 0.4F * std::sin(static_cast<float>(x) * 0.2F);
+      const float ny = 0.4F * std::cos(static_cast<float>(y) * 0.15F);
+      const float nz = std::sqrt(1.0F - nx * nx - ny * ny);
+      uint8_t* p = &texture.pixels[(static_cast<size_t>(y) * width + x) * 4];
+      p[0] = static_cast<uint8_t>(std::lround(nx * 127.5F + 127.5F));
+      p[1] = static_cast<uint8_t>(std::lround(ny * 127.5F + 127.5F));
+      p[2] = static_cast<uint8_t>(std::lround(nz * 127.5F + 127.5F));
+      p[3] = 255;
+    }
+  }
+  return texture;
+}
+
+vv::TextureCompressionReport Compress(vv::Texture& texture, const vv::TextureCompressionOptions& options) {
+  vv::GenerateMipChain(texture);
+  const uint32_t levels = texture.mipLevels;
+  vv::TextureCompressionReport report;
+  assert(vv::CompressTexture(texture, options, &report));
+  assert(texture.format == report.format);
+  assert(texture.mipLevels == levels);
+  assert(texture.pixels.size() == vv::TextureLevelOffset(texture.format, texture.width, texture.height, levels));
+  assert(report.compressedBytes == texture.pixels.size());
+  assert(report.compressedBytes < report.sourceBytes);
+  return report;
+}
+
+}  // namespace
+
+int main() {
+  // Block layout: 4x4 blocks, partial blocks padded, 8 or 16 bytes per block.
+  assert(vv::BlockBytes(vv::PixelFormat::kBC1) == 8);
+  assert(vv::BlockBytes(vv::PixelFormat::kBC7) == 16);
+  assert(vv::BlockBytes(vv::PixelFormat::kR8G8B8A8) == 0);
+  assert(vv::TextureLevelOffset(vv::PixelFormat::kBC1, 64, 32, 1) == 16 * 8 * 8);
+  assert(vv::TextureLevelOffset(vv::PixelFormat::kBC5, 6, 6, 1) == 4 * 16);
+  assert(vv::TextureLevelOffset(vv::PixelFormat::kBC5, 6, 6, 2) == 5 * 16);
+  assert(vv::TextureLevelOffset(vv::PixelFormat::kR8G8B8A8, 6, 6, 1) == vv::MipLevelOffset(6, 6, 1));
+
+  vv::TextureCompressionOptions options;
+
+  vv::Texture color = ColorGradient(70, 38, false);
+  const vv::TextureCompressionReport bc7 = Compress(color, options);
+  assert(bc7.format == vv::PixelFormat::kBC7);
+  assert(bc7.psnrDb > 38.0F);
+
+  vv::Texture alpha = ColorGradient(64, 64, true);
+  options.allowBc7 = false;
+  const vv::TextureCompressionReport bc3 = Compress(alpha, options);
+  assert(bc3.format == vv::PixelFormat::kBC3);
+  assert(bc3.psnrDb > 34.0F);
+
+  vv::Texture opaque = ColorGradient(64, 64, false);
+  const vv::TextureCompressionReport bc1 = Compress(opaque, options);
+  assert(bc1.format == vv::PixelFormat::kBC1);
+  assert(bc1.psnrDb > 34.0F);
+  options.allowBc7 = true;
+
+  vv::Texture mask = GrayMask(64, 48);
+  const vv::TextureCompressionReport bc4 = Compress(mask, options);
+  assert(bc4.format == vv::PixelFormat::kBC4);
+  assert(bc4.psnrDb > 44.0F);
+
+  vv::Texture normals = NormalMap(64, 64);
+  const vv::Texture normalSource = normals;
+  const vv::TextureCompressionReport bc5 = Compress(normals, options);
+  assert(bc5.format == vv::PixelFormat::kBC5);
+  assert(bc5.psnrDb > 45.0F);
+
+  // Higher quality never loses to the fast path.
+  vv::Texture fastColor = ColorGradient(70, 38, false);
+  vv::Texture highColor = fastColor;
+  options.quality = vv::CompressionQuality::kFast;
+  const float fastPsnr = Compress(fastColor, options).psnrDb;
+  options.quality = vv::CompressionQuality::kHigh;
+  const float highPsnr = Compress(highColor, options).psnrDb;
+  assert(highPsnr >= fastPsnr - 0.05F);
+
+  // Decompression restores the RGBA8 chain; BC5 rebuilds z so decoded normals stay unit length.
+  assert(vv::DecompressTexture(normals));
+  assert(normals.format == vv::PixelFormat::kR8G8B8A8);
+  assert(normals.pixels.size() == vv::MipLevelOffset(64, 64, normals.mipLevels));
+  for (size_t i = 0; i < static_cast<size_t>(64) * 64; ++i) {
+    for (size_t c = 0; c < 3; ++c) {
+      assert(std::abs(static_cast<int>(normals.pixels[i * 4 + c]) - static_cast<int>(normalSource.pixels[i * 4 + c])) <= 8);
+    }
+  }
+  assert(vv::DecompressTexture(color));
+  assert(color.format == vv::PixelFormat::kR8G8B8A8_SRGB);
+  assert(!vv::DecompressTexture(color));
+  assert(!vv::CompressTexture(opaque, options));
+  return 0;
+}
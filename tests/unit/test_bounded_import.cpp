@@ -0,0 +1,112 @@
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "asset/import/AssimpFbxImporter.hpp"
+#include "asset/import/ImportReport.hpp"
+#include "asset/texture/TextureRegistry.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+// spider.fbx refers to four .jpg images that are not bundled. Written next to a copy of it as PPM
+// (decoders go by content, not extension), they give it file textures.
+std::string MakeTexturedSpider(const std::filesystem::path& dir) {
+  std::filesystem::create_directories(dir);
+  std::filesystem::copy_file("assets/fbx/spider.fbx", dir / "spider.fbx", std::filesystem::copy_options::overwrite_existing);
+  uint8_t seed = 0;
+  for (const char* name : {"SpiderTex.jpg", "drkwood2.jpg", "engineflare1.jpg", "wal67ar_small.jpg"}) {
+    std::ofstream file(dir / name, std::ios::binary);
+    file << "P6\n64 32\n255\n";
+    for (uint32_t i = 0; i < 64 * 32 * 3; ++i) {
+      file.put(static_cast<char>(i * 7 + seed));
+    }
+    seed = static_cast<uint8_t>(seed + 50);
+  }
+  return (dir / "spider.fbx").string();
+}
+
+}  // namespace
+
+int main() {
+  const std::filesystem::path spillDir = std::filesystem::temp_directory_path() / "vv_unit_bounded_import";
+  std::filesystem::remove_all(spillDir);
+
+  vv::TextureRegistry::Global().Clear();
+  vv::ImportOptions options;
+  options.lodCount = 1;
+  vv::ImportReport fullReport;
+  const auto full = vv::AssimpFbxImporter().Import("assets/fbx/Taunt.fbx", options, &fullReport);
+  assert(full.Ok());
+  assert(fullReport.memoryBudgetBytes == 0);
+
+  vv::TextureRegistry::Global().Clear();
+  vv::ImportOptions bounded = options;
+  bounded.memoryBudgetBytes = 64ULL << 20U;
+  bounded.textureSpillDir = spillDir.string();
+  vv::ImportReport boundedReport;
+  const auto loaded = vv::AssimpFbxImporter().Import("assets/fbx/Taunt.fbx", bounded, &boundedReport);
+  assert(loaded.Ok());
+
+  // Freeing the Assimp parts as they are converted leaves the converted scene unchanged.
+  const vv::Scene& a = *full.value;
+  const vv::Scene& b = *loaded.value;
+  assert(a.meshes.size() == b.meshes.size() && a.clips.size() == b.clips.size());
+  assert(a.skeletons.size() == b.skeletons.size() && a.materials.size() == b.materials.size());
+  for (size_t i = 0; i < a.meshes.size(); ++i) {
+    assert(a.meshes[i]->indices == b.meshes[i]->indices);
+    assert(a.meshes[i]->vertices.size() == b.meshes[i]->vertices.size());
+  }
+  for (size_t i = 0; i < a.clips.size(); ++i) {
+    assert(a.clips[i]->name == b.clips[i]->name);
+  }
+
+  assert(a.textures.size() == b.textures.size());
+
+  // No decoded or embedded image is held: every file texture is lazy and backed by a file. Taunt
+  // has no textures, so this runs on spider.fbx with the images it refers to.
+  {
+    vv::TextureRegistry::Global().Clear();
+    const auto textured = vv::AssimpFbxImporter().Import(MakeTexturedSpider(spillDir / "model"), bounded);
+    assert(textured.Ok() && textured.value->textures.size() == 5 + 4);
+    assert(vv::TextureRegistry::Global().Stats().decodedImages == 0);
+    for (size_t i = 5; i < textured.value->textures.size(); ++i) {
+      const vv::Texture& texture = textured.value->textures[i];
+      assert(texture.pixels.empty() && vv::HasLazySource(texture));
+      assert(texture.source.bytes == nullptr && !texture.source.path.empty());
+      const std::optional<vv::ImageRgba8> decoded = vv::DecodeTextureSource(texture.source);
+      assert(decoded.has_value() && decoded->width == texture.width && decoded->height == texture.height);
+    }
+  }
+
+  assert(boundedReport.memoryBudgetBytes == bounded.memoryBudgetBytes);
+  if (fullReport.peakHeapBytes > 0) {
+    assert(boundedReport.peakHeapBytes > 0 && boundedReport.peakHeapBytes < fullReport.peakHeapBytes);
+  }
+  const std::string json = vv::ImportReportToJson(boundedReport);
+  assert(json.find("\"peakHeapBytes\"") != std::string::npos);
+  assert(json.find("\"memoryBudgetBytes\": " + std::to_string(bounded.memoryBudgetBytes)) != std::string::npos);
+
+  // Raw texels spilled to a file decode like the in-memory form.
+  std::filesystem::create_directories(spillDir);
+  const std::vector<uint8_t> bgra = {10, 20, 30, 255, 40, 50, 60, 128};
+  const std::filesystem::path rawPath = spillDir / "raw.bgra";
+  std::ofstream(rawPath, std::ios::binary).write(reinterpret_cast<const char*>(bgra.data()), bgra.size());
+  vv::TextureSource raw;
+  raw.path = rawPath.string();
+  raw.rawWidth = 2;
+  raw.rawHeight = 1;
+  raw.sizeBytes = bgra.size();
+  const std::optional<vv::ImageRgba8> texels = vv::DecodeTextureSource(raw);
+  assert(texels.has_value() && texels->width == 2 && texels->height == 1);
+  assert(texels->pixels[0] == 30 && texels->pixels[1] == 20 && texels->pixels[2] == 10 && texels->pixels[7] == 128);
+  raw.rawWidth = 3;
+  assert(!vv::DecodeTextureSource(raw).has_value());
+
+  std::filesystem::remove_all(spillDir);
+  return 0;
+}
@@ -0,0 +1,125 @@
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "asset/import/ConversionKernels.hpp"
+#include "core/math/MathTypes.hpp"
+
+namespace {
+
+// The scalar conversions the importer ran per vertex and per key before the batched kernels.
+vv::Vec3 ScalarPoint(const vv::Mat4& c, const vv::Vec3& v) {
+  return vv::Vec3(c * vv::Vec4(v, 1.0F));
+}
+
+vv::Vec3 ScalarDirection(const glm::mat3& m, const vv::Vec3& v, const vv::Vec3& fallback) {
+  const vv::Vec3 r = m * v;
+  return glm::dot(r, r) <= 1e-12F ? fallback : glm::normalize(r);
+}
+
+vv::Quat ScalarRotation(const glm::mat3& r, const vv::Quat& q) {
+  const vv::Mat4 m = vv::Mat4(r) * glm::mat4_cast(q) * vv::Mat4(glm::inverse(r));
+  return glm::normalize(glm::quat_cast(m));
+}
+
+float Random(uint32_t& state) {
+  state = state * 1664525U + 1013904223U;
+  return static_cast<float>(state >> 8U) / static_cast<float>(1U << 24U) * 2.0F - 1.0F;
+}
+
+bool Near(const vv::Vec3& a, const vv::Vec3& b, float tolerance) {
+  return std::fabs(a.x - b.x) <= tolerance && std::fabs(a.y - b.y) <= tolerance && std::fabs(a.z - b.z) <= tolerance;
+}
+
+void CheckBasis(const glm::mat3& r, float unitScale) {
+  const vv::Mat4 c = glm::scale(vv::Mat4(1.0F), vv::Vec3(unitScale)) * vv::Mat4(r);
+  const glm::mat3 normalXform = glm::transpose(glm::inverse(glm::mat3(c)));
+  const vv::RotationBasisChange change = vv::MakeRotationBasisChange(r);
+
+  // 37 is not a multiple of the lane count, so the tail path runs too.
+  constexpr size_t kCount = 37;
+  uint32_t state = 12345;
+  vv::Vec3Soa vectors;
+  vv::QuatSoa quats;
+  vectors.Resize(kCount);
+  quats.Resize(kCount);
+  for (size_t i = 0; i < kCount; ++i) {
+    vectors.x[i] = Random(state) * 50.0F;
+    vectors.y[i] = Random(state) * 50.0F;
+    vectors.z[i] = Random(state) * 50.0F;
+    // Keys are unit quaternions up to the rounding of the file they came from.
+    const vv::Quat q = glm::normalize(vv::Quat(Random(state), Random(state), Random(state), Random(state)));
+    quats.x[i] = q.x;
+    quats.y[i] = q.y;
+    quats.z[i] = q.z;
+    quats.w[i] = q.w;
+  }
+  vectors.x[3] = vectors.y[3] = vectors.z[3] = 0.0F;        // degenerate direction
+  quats.x[5] = quats.y[5] = quats.z[5] = quats.w[5] = 0.0F;  // degenerate rotation
+  quats.x[6] = quats.y[6] = quats.z[6] = 0.0F;               // identity
+  quats.w[6] = 1.0F;
+
+  vv::Vec3Soa points;
+  vv::TransformPoints(c, vectors, points);
+  vv::Vec3Soa directions;
+  const vv::Vec3 fallback(0.0F, 0.0F, 1.0F);
+  vv::TransformDirections(normalXform, vectors, fallback, directions);
+  vv::QuatSoa rotations;
+  vv::ConvertRotations(change, quats, rotations);
+  assert(points.Size() == kCount && directions.Size() == kCount && rotations.Size() == kCount);
+
+  for (size_t i = 0; i < kCount; ++i) {
+    const vv::Vec3 v = vectors.Get(i);
+    assert(Near(points.Get(i), ScalarPoint(c, v), 1e-4F));
+    assert(Near(directions.Get(i), ScalarDirection(normalXform, v, fallback), 1e-6F));
+
+    const vv::Quat q = quats.Get(i);
+    const vv::Quat converted = rotations.Get(i);
+    if (i == 5) {
+      assert(converted.w == 1.0F && converted.x == 0.0F && converted.y == 0.0F && converted.z == 0.0F);
+      continue;
+    }
+    // q and -q are the same rotation; the matrix round trip may return either.
+    const vv::Quat expected = ScalarRotation(r, q);
+    assert(std::fabs(std::fabs(glm::dot(converted, expected)) - 1.0F) <= 1e-5F);
+    const vv::Vec3 probe(0.3F, -0.7F, 0.2F);
+    assert(Near(converted * probe, expected * probe, 1e-5F));
+  }
+
+  // In place gives the same results.
+  vv::Vec3Soa inPlace = vectors;
+  vv::TransformPoints(c, inPlace, inPlace);
+  assert(inPlace.x == points.x && inPlace.y == points.y && inPlace.z == points.z);
+  vv::QuatSoa quatsInPlace = quats;
+  vv::ConvertRotations(change, quatsInPlace, quatsInPlace);
+  assert(quatsInPlace.x == rotations.x && quatsInPlace.w == rotations.w);
+}
+
+}  // namespace
+
+int main() {
+  CheckBasis(glm::mat3(1.0F), 1.0F);
+
+  // Z-up to Y-up, a proper rotation, with centimeters to meters.
+  glm::mat3 zUp(0.0F);
+  zUp[0][0] = 1.0F;
+  zUp[2][1] = 1.0F;
+  zUp[1][2] = -1.0F;
+  CheckBasis(zUp, 0.01F);
+
+  // A handedness flip: conjugating by a reflection reverses the rotation angle.
+  glm::mat3 mirror(1.0F);
+  mirror[2][2] = -1.0F;
+  CheckBasis(mirror, 1.0F);
+  glm::mat3 swapped(0.0F);
+  swapped[1][0] = 1.0F;
+  swapped[0][1] = 1.0F;
+  swapped[2][2] = 1.0F;
+  CheckBasis(swapped, 2.54F);
+
+  vv::Vec3Soa empty;
+  vv::TransformPoints(vv::Mat4(1.0F), empty, empty);
+  assert(empty.Size() == 0);
+  return 0;
+}
@@ -0,0 +1,109 @@
+#include <cassert>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "asset/cook/BatchCook.hpp"
+#include "asset/cook/CookedScene.hpp"
+#include "asset/import/AssimpFbxImporter.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+void WriteText(const fs::path& file, const std::string& text) {
+  fs::create_directories(file.parent_path());
+  std::ofstream(file) << text;
+}
+
+}  // namespace
+
+int main() {
+  const fs::path base = fs::temp_directory_path() / "vv_unit_cook";
+  fs::remove_all(base);
+
+  // Job collection: directories recurse for .fbx, manifests resolve relative to themselves, a
+  // source listed twice cooks once, and two sources may not share an output.
+  WriteText(base / "in" / "a.fbx", "not an fbx");
+  WriteText(base / "in" / "sub" / "B.FBX", "not an fbx");
+  WriteText(base / "in" / "sub" / "notes.obj", "ignored");
+  WriteText(base / "list.txt", "# cook these\nin/a.fbx\n  in/sub  # whole directory\n");
+  {
+    const auto jobs = vv::CollectCookJobs({(base / "in").string(), (base / "list.txt").string()}, base / "out");
+    assert(jobs.Ok());
+    assert(jobs.value->size() == 2);
+    assert((*jobs.value)[0].output == base / "out" / "a.vvscene");
+    assert((*jobs.value)[1].output == base / "out" / "sub" / "B.vvscene");
+    assert((*jobs.value)[1].report == base / "out" / "sub" / "B.report.json");
+    WriteText(base / "in" / "x" / "a.fbx", "not an fbx");
+    assert(!vv::CollectCookJobs({(base / "in" / "a.fbx").string(), (base / "in" / "x" / "a.fbx").string()}, base / "out").Ok());
+    assert(!vv::CollectCookJobs({(base / "missing").string()}, base / "out").Ok());
+  }
+
+  // Bundled assets plus one broken file: the broken file fails alone, reports are written for
+  // every file, and a second run skips everything that cooked.
+  vv::CookSettings settings;
+  settings.outputDir = base / "cooked";
+  settings.import.generateMips = false;
+  settings.jobs = 2;
+  const auto jobs = vv::CollectCookJobs(
+      {"assets/fbx/Taunt.fbx", "assets/fbx/spider.fbx", (base / "in" / "sub" / "B.FBX").string()}, settings.outputDir);
+  assert(jobs.Ok() && jobs.value->size() == 3);
+
+  std::vector<std::string> reported;
+  const vv::CookSummary first = vv::RunCook(*jobs.value, settings, [&](const vv::CookFileResult& result) {
+    reported.push_back(result.source.string());
+  });
+  assert(first.cooked == 2 && first.failed == 1 && first.upToDate == 0);
+  assert(reported.size() == 3);
+  assert(first.files[2].status == vv::CookStatus::kFailed && !first.files[2].error.empty());
+  for (const vv::CookJob& job : *jobs.value) {
+    assert(fs::is_regular_file(job.report));
+  }
+
+  const vv::CookSummary second = vv::RunCook(*jobs.value, settings);
+  assert(second.upToDate == 2 && second.failed == 1 && second.cooked == 0);
+
+  // Options are part of the key; in-process threads produce the same files as isolated workers.
+  vv::CookSettings changed = settings;
+  changed.import.lodCount = 1;
+  changed.isolate = false;
+  const std::vector<vv::CookJob> assets(jobs.value->begin(), jobs.value->begin() + 2);
+  const vv::CookSummary third = vv::RunCook(assets, changed);
+  assert(third.cooked == 2);
+
+  // Cooked scenes load without Assimp and match the import.
+  const auto cooked = vv::ReadCookedScene((settings.outputDir / "Taunt.vvscene").string());
+  assert(cooked.Ok());
+  const auto imported = vv::AssimpFbxImporter().Import("assets/fbx/Taunt.fbx", changed.import);
+  assert(imported.Ok());
+  assert(cooked.value->nodes.size() == imported.value->nodes.size());
+  assert(cooked.value->meshes.size() == imported.value->meshes.size());
+  for (size_t m = 0; m < cooked.value->meshes.size(); ++m) {
+    const vv::Mesh& a = cooked.value->meshes[m];
+    const vv::Mesh& b = imported.value->meshes[m];
+    assert(a.indices == b.indices && a.vertices.size() == b.vertices.size() && a.lods.size() == b.lods.size());
+    assert(a.clusters.size() == b.clusters.size());
+  }
+  assert(cooked.value->skeletons.size() == imported.value->skeletons.size());
+  for (size_t s = 0; s < cooked.value->skeletons.size(); ++s) {
+    assert(cooked.value->skeletons[s]->boneMap == imported.value->skeletons[s]->boneMap);
+  }
+  assert(cooked.value->clips.size() == imported.value->clips.size());
+  assert(cooked.value->textures.size() == imported.value->textures.size());
+  for (size_t t = 0; t < cooked.value->textures.size(); ++t) {
+    assert(cooked.value->textures[t]->pixels == imported.value->textures[t]->pixels);
+  }
+
+  // Damaged files are rejected instead of half-loaded.
+  const fs::path damaged = settings.outputDir / "spider.vvscene";
+  fs::resize_file(damaged, fs::file_size(damaged) / 2);
+  assert(!vv::ReadCookedScene(damaged.string()).Ok());
+  assert(vv::ReadCookedSceneHeader(damaged.string()).Ok());
+  WriteText(damaged, "garbage");
+  assert(!vv::ReadCookedSceneHeader(damaged.string()).Ok());
+
+  fs::remove_all(base);
+  return 0;
+}
@@ -0,0 +1,200 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "asset/cook/CookedScene.hpp"
+#include "asset/import/SceneImporter.hpp"
+#include "asset/registry/AssetRegistry.hpp"
+#include "asset/residency/CpuResidency.hpp"
+#include "core/memory/ProcessMemory.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+vv::Mesh MakeMesh(const std::string& name, size_t vertexCount) {
+  vv::Mesh mesh;
+  mesh.name = name;
+  mesh.vertices.resize(vertexCount);
+  for (size_t i = 0; i < vertexCount; ++i) {
+    mesh.vertices[i].uv0.x = static_cast<float>(i);
+  }
+  for (uint32_t i = 0; i + 2 < vertexCount; i += 3) {
+    mesh.indices.insert(mesh.indices.end(), {i, i + 1, i + 2});
+  }
+  mesh.submeshes.push_back({0, static_cast<uint32_t>(mesh.indices.size()), 0});
+  return mesh;
+}
+
+vv::Texture MakeTexture(const std::string& uri, uint32_t size, uint8_t seed) {
+  vv::Texture texture;
+  texture.uri = uri;
+  texture.width = size;
+  texture.height = size;
+  texture.format = vv::PixelFormat::kR8G8B8A8;
+  texture.pixels = vv::PixelBuffer(static_cast<size_t>(size) * size * 4);
+  for (size_t i = 0; i < texture.pixels.size(); ++i) {
+    texture.pixels[i] = static_cast<uint8_t>(i * 7 + seed);
+  }
+  return texture;
+}
+
+bool SameArrays(const vv::Mesh& a, const vv::Mesh& b) {
+  return a.vertices.size() == b.vertices.size() && a.indices == b.indices &&
+         std::memcmp(a.vertices.data(), b.vertices.data(), a.vertices.size() * sizeof(vv::VertexSkinned)) == 0;
+}
+
+bool SamePixels(const vv::Texture& a, const vv::Texture& b) {
+  return a.pixels.size() == b.pixels.size() && std::memcmp(a.pixels.data(), b.pixels.data(), a.pixels.size()) == 0;
+}
+
+}  // namespace
+
+int main() {
+  const fs::path base = fs::temp_directory_path() / "vv_unit_cpu_residency";
+  fs::remove_all(base);
+  const std::string cookedPath = (base / "scene.vvscene").string();
+
+  vv::Scene source;
+  source.meshes.push_back(MakeMesh("body", 300));
+  {
+    vv::Mesh morphed = MakeMesh("face", 30);
+    vv::MorphTarget target;
+    target.vertices = {0};
+    for (auto& axis : target.positionDeltas) {
+      axis = {100};
+    }
+    morphed.morphTargets.push_back(target);
+    morphed.morphWeights = {0.0F};
+    source.meshes.push_back(morphed);
+  }
+  source.meshes.push_back(MakeMesh("prop", 60));
+  source.textures.push_back(MakeTexture("albedo", 8, 1));
+  {
+    vv::Texture embedded = MakeTexture("embedded", 4, 2);
+    embedded.source.bytes = std::make_shared<const std::vector<uint8_t>>(16, uint8_t{0});
+    embedded.source.rawWidth = 2;
+    embedded.source.rawHeight = 2;
+    source.textures.push_back(embedded);
+  }
+  std::string error;
+  assert(vv::WriteCookedScene(cookedPath, source, {}, error));
+
+  // One mesh or texture can be read on its own; the ones before it are stepped over.
+  {
+    const auto prop = vv::ReadCookedMesh(cookedPath, 2);
+    assert(prop.Ok() && prop.value->name == "prop" && SameArrays(*prop.value, source.meshes[2]));
+    assert(prop.value->cooked.path == cookedPath && prop.value->cooked.index == 2);
+    const auto albedo = vv::ReadCookedTexture(cookedPath, 0);
+    assert(albedo.Ok() && SamePixels(*albedo.value, source.textures[0]));
+    assert(!vv::ReadCookedMesh(cookedPath, 3).Ok());
+    assert(!vv::ReadCookedTexture((base / "missing.vvscene").string(), 0).Ok());
+  }
+
+  // Reload from cooked: static meshes and every decoded texture go; the morphed mesh stays, and so
+  // does an asset another scene holds.
+  auto loaded = vv::ReadCookedScene(cookedPath);
+  assert(loaded.Ok());
+  vv::Scene scene = std::move(*loaded.value);
+  assert(scene.meshes[0]->cooked.path == cookedPath && scene.textures[1]->cooked.index == 1);
+  const vv::Scene other = [&] {
+    vv::Scene s;
+    s.meshes.push_back(scene.meshes[2]);
+    return s;
+  }();
+  const vv::Mesh* bodyBefore = &*scene.meshes[0];
+  const vv::CpuResidencyStats stats = vv::ApplyCpuResidency(scene, vv::CpuResidency::kReloadFromCooked);
+  assert(stats.meshesReleased == 1 && stats.texturesReleased == 2 && stats.kept == 2);
+  assert(stats.releasedBytes == 300 * sizeof(vv::VertexSkinned) + 300 * sizeof(uint32_t) + 8 * 8 * 4 + 4 * 4 * 4);
+  assert(&*scene.meshes[0] == bodyBefore);  // released in place, so GPU copies keyed by identity stay
+  assert(scene.meshes[0]->arraysReleased && scene.meshes[0]->vertices.empty() && scene.meshes[0]->indices.empty());
+  assert(!scene.meshes[0]->submeshes.empty());
+  assert(!scene.meshes[1]->arraysReleased && !scene.meshes[1]->vertices.empty());
+  assert(!scene.meshes[2]->arraysReleased && scene.meshes[2].SharedWith(other.meshes[0]));
+  // With a cooked copy, even a texture with a source keeps its format and reloads from the file.
+  assert(scene.textures[1]->pixelsReleased && scene.textures[1]->pixels.empty());
+
+  {
+    const auto body = vv::AcquireMeshArrays(scene.meshes[0]);
+    assert(body.Ok() && SameArrays(**body.value, source.meshes[0]));
+    assert(scene.meshes[0]->vertices.empty());  // the scene is not changed
+    const auto face = vv::AcquireMeshArrays(scene.meshes[1]);
+    assert(face.Ok() && face.value->SharedWith(scene.meshes[1]));
+    const auto albedo = vv::AcquireTexturePixels(scene.textures[0]);
+    assert(albedo.Ok() && SamePixels(**albedo.value, source.textures[0]));
+  }
+
+  // Released scenes are not written back; rehydrating restores them in place.
+  assert(!vv::WriteCookedScene((base / "copy.vvscene").string(), scene, {}, error));
+  assert(vv::RehydrateScene(scene, error));
+  assert(&*scene.meshes[0] == bodyBefore && !scene.meshes[0]->arraysReleased);
+  assert(SameArrays(scene.meshes[0], source.meshes[0]));
+  assert(!scene.textures[0]->pixelsReleased && SamePixels(scene.textures[0], source.textures[0]));
+  assert(vv::WriteCookedScene((base / "copy.vvscene").string(), scene, {}, error));
+
+  // Without a cooked file: reload keeps what cannot come back, release drops it for good.
+  {
+    vv::Scene plain = source;
+    plain.meshes[0] = vv::Mesh(*source.meshes[0]);
+    plain.meshes[2] = vv::Mesh(*source.meshes[2]);
+    plain.textures[0] = vv::Texture(*source.textures[0]);
+    plain.textures[1] = vv::Texture(*source.textures[1]);
+    const vv::CpuResidencyStats kept = vv::ApplyCpuResidency(plain, vv::CpuResidency::kReloadFromCooked);
+    assert(kept.meshesReleased == 0 && kept.texturesReleased == 1 && kept.kept == 4);
+    assert(plain.textures[1]->pixels.empty() && !plain.textures[1]->pixelsReleased);  // back to lazy
+
+    const vv::CpuResidencyStats dropped = vv::ApplyCpuResidency(plain, vv::CpuResidency::kReleaseAfterUpload);
+    assert(dropped.meshesReleased == 2 && dropped.texturesReleased == 1);
+    assert(!vv::AcquireMeshArrays(plain.meshes[0]).Ok() && !vv::AcquireTexturePixels(plain.textures[0]).Ok());
+    assert(!vv::RehydrateScene(plain, error) && !error.empty());
+    assert(vv::ApplyCpuResidency(plain, vv::CpuResidency::kKeep).releasedBytes == 0);
+  }
+
+  // A large mesh shows up in the heap and in RSS once released.
+  {
+    vv::Scene big;
+    big.meshes.push_back(MakeMesh("crowd", 1U << 20U));
+    const uint64_t heapBefore = vv::QueryHeapInUseBytes();
+    const vv::ProcessMemoryStats before = vv::QueryProcessMemory();
+    const vv::CpuResidencyStats released = vv::ApplyCpuResidency(big, vv::CpuResidency::kReleaseAfterUpload);
+    vv::ReturnFreeHeapMemory();
+    const uint64_t heapAfter = vv::QueryHeapInUseBytes();
+    const vv::ProcessMemoryStats after = vv::QueryProcessMemory();
+    assert(released.releasedBytes >= (1U << 20U) * sizeof(vv::VertexSkinned));
+    if (heapBefore > 0) {
+      assert(heapBefore - heapAfter >= released.releasedBytes * 9 / 10);
+    }
+    if (before.residentBytes > 0) {
+      assert(after.residentBytes + released.releasedBytes / 2 <= before.residentBytes);
+    }
+  }
+
+  // Released assets leave the AssetRegistry: importing the file again gives intact meshes rather
+  // than the released ones the first scene still holds.
+  {
+    vv::ImportOptions options;
+    options.nativeFbx = true;
+    options.lodCount = 0;
+    auto first = vv::ImportSceneFile("assets/fbx/spider.fbx", options);
+    assert(first.Ok());
+    const uint64_t liveBefore = vv::AssetRegistry::Global().Stats().live;
+    const vv::CpuResidencyStats released = vv::ApplyCpuResidency(*first.value, vv::CpuResidency::kReleaseAfterUpload);
+    assert(released.meshesReleased > 0);
+    assert(vv::AssetRegistry::Global().Stats().live <= liveBefore - released.meshesReleased);
+    const auto second = vv::ImportSceneFile("assets/fbx/spider.fbx", options);
+    assert(second.Ok() && second.value->meshes.size() == first.value->meshes.size());
+    for (size_t i = 0; i < second.value->meshes.size(); ++i) {
+      const vv::Mesh& mesh = *second.value->meshes[i];
+      assert(!mesh.arraysReleased && !mesh.vertices.empty() && !mesh.indices.empty());
+      assert(!second.value->meshes[i].SharedWith(first.value->meshes[i]));
+    }
+  }
+
+  fs::remove_all(base);
+  return 0;
+}
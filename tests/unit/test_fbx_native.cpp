@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "asset/import/AssimpFbxImporter.hpp"
+#include "asset/import/FbxImporter.hpp"
+#include "asset/import/SceneImporter.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+bool Near(const vv::Vec3& a, const vv::Vec3& b, float tolerance) {
+  return std::fabs(a.x - b.x) <= tolerance && std::fabs(a.y - b.y) <= tolerance && std::fabs(a.z - b.z) <= tolerance;
+}
+
+bool Near(const vv::Mat4& a, const vv::Mat4& b, float tolerance) {
+  for (int c = 0; c < 4; ++c) {
+    for (int r = 0; r < 4; ++r) {
+      if (std::fabs(a[c][r] - b[c][r]) > tolerance) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Influences as (joint, weight) pairs sorted by joint, zero weights left out, so slot order does
+// not matter.
+std::vector<std::pair<uint32_t, float>> Influences(const vv::VertexSkinned& v) {
+  std::vector<std::pair<uint32_t, float>> influences;
+  for (size_t i = 0; i < v.weights.size(); ++i) {
+    if (v.weights[i] > 0.0F) {
+      influences.emplace_back(v.joints[i], v.weights[i]);
+    }
+  }
+  std::sort(influences.begin(), influences.end());
+  return influences;
+}
+
+bool SameVertex(const vv::VertexSkinned& a, const vv::VertexSkinned& b) {
+  if (!Near(a.position, b.position, 1e-3F) || !Near(a.normal, b.normal, 1e-2F) ||
+      std::fabs(a.uv0.x - b.uv0.x) > 1e-3F || std::fabs(a.uv0.y - b.uv0.y) > 1e-3F) {
+    return false;
+  }
+  const auto ia = Influences(a);
+  const auto ib = Influences(b);
+  if (ia.size() != ib.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < ia.size(); ++i) {
+    if (ia[i].first != ib[i].first || std::fabs(ia[i].second - ib[i].second) > 1e-2F) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Every vertex of `a` pairs with its own vertex of `b`: the two readers may number vertices
+// differently, so they are matched by content through a grid of 1 cm cells.
+bool SameVertices(const vv::Mesh& a, const vv::Mesh& b) {
+  if (a.vertices.size() != b.vertices.size()) {
+    return false;
+  }
+  auto cellOf = [](const vv::Vec3& p) {
+    return std::array<int64_t, 3>{static_cast<int64_t>(std::floor(p.x * 100.0F)),
+                                  static_cast<int64_t>(std::floor(p.y * 100.0F)),
+                                  static_cast<int64_t>(std::floor(p.z * 100.0F))};
+  };
+  std::map<std::array<int64_t, 3>, std::vector<uint32_t>> cells;
+  for (uint32_t v = 0; v < b.vertices.size(); ++v) {
+    cells[cellOf(b.vertices[v].position)].push_back(v);
+  }
+  std::vector<bool> taken(b.vertices.size(), false);
+  for (const vv::VertexSkinned& vertex : a.vertices) {
+    const auto cell = cellOf(vertex.position);
+    bool matched = false;
+    for (int64_t dx = -1; dx <= 1 && !matched; ++dx) {
+      for (int64_t dy = -1; dy <= 1 && !matched; ++dy) {
+        for (int64_t dz = -1; dz <= 1 && !matched; ++dz) {
+          const auto found = cells.find({cell[0] + dx, cell[1] + dy, cell[2] + dz});
+          if (found == cells.end()) {
+            continue;
+          }
+          for (const uint32_t candidate : found->second) {
+            if (!taken[candidate] && SameVertex(vertex, b.vertices[candidate])) {
+              taken[candidate] = true;
+              matched = true;
+              break;
+            }
+          }
+        }
+      }
+    }
+    if (!matched) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// The native reader builds what the Assimp path builds from the same file.
+void CheckParity(const vv::Scene& a, const vv::Scene& b) {
+  const vv::SceneStats sa = vv::ComputeSceneStats(a);
+  const vv::SceneStats sb = vv::ComputeSceneStats(b);
+  assert(sa.meshCount == sb.meshCount && sa.materialCount == sb.materialCount && sa.textureCount == sb.textureCount);
+  assert(sa.skeletonCount == sb.skeletonCount && sa.boneCount == sb.boneCount);
+  assert(sa.clipCount == sb.clipCount && sa.lightCount == sb.lightCount);
+  assert(sa.triangleCount == sb.triangleCount);
+  assert(sa.sourceGeometryBytes == sb.sourceGeometryBytes && sa.gpuGeometryBytes == sb.gpuGeometryBytes);
+
+  assert(a.nodes.size() == b.nodes.size());
+  for (size_t i = 0; i < a.nodes.size(); ++i) {
+    assert(a.nodes[i].name == b.nodes[i].name && a.nodes[i].parent == b.nodes[i].parent);
+    assert(Near(a.nodes[i].localBind.translation, b.nodes[i].localBind.translation, 1e-3F));
+  }
+  assert(a.meshes.size() == b.meshes.size());
+  for (size_t i = 0; i < a.meshes.size(); ++i) {
+    assert(a.meshes[i]->name == b.meshes[i]->name);
+    assert(a.meshes[i]->indices.size() == b.meshes[i]->indices.size());
+    assert(a.meshes[i]->vertices.size() == b.meshes[i]->vertices.size());
+    assert(SameVertices(a.meshes[i], b.meshes[i]));
+    assert(Near(a.meshes[i]->localBounds.min, b.meshes[i]->localBounds.min, 1e-3F));
+    assert(Near(a.meshes[i]->localBounds.max, b.meshes[i]->localBounds.max, 1e-3F));
+  }
+  assert(a.materials.size() == b.materials.size());
+  for (size_t i = 0; i < a.materials.size(); ++i) {
+    assert(a.materials[i].name == b.materials[i].name);
+  }
+  assert(a.skins.size() == b.skins.size() && a.skeletons.size() == b.skeletons.size());
+  for (size_t i = 0; i < a.skins.size(); ++i) {
+    assert(a.skins[i].skeleton == b.skins[i].skeleton && a.skins[i].mesh == b.skins[i].mesh);
+    assert(a.skins[i].joints == b.skins[i].joints);
+    assert(a.skins[i].palette.size() == b.skins[i].palette.size());
+    for (size_t j = 0; j < a.skins[i].palette.size(); ++j) {
+      assert(Near(a.skins[i].palette[j], b.skins[i].palette[j], 1e-3F));
+    }
+  }
+  for (size_t s = 0; s < a.skeletons.size(); ++s) {
+    assert(a.skeletons[s]->bones.size() == b.skeletons[s]->bones.size());
+    for (size_t i = 0; i < a.skeletons[s]->bones.size(); ++i) {
+      assert(a.skeletons[s]->bones[i].name == b.skeletons[s]->bones[i].name);
+      assert(a.skeletons[s]->bones[i].parentBone == b.skeletons[s]->bones[i].parentBone);
+    }
+  }
+  assert(a.clips.size() == b.clips.size());
+  for (size_t i = 0; i < a.clips.size(); ++i) {
+    assert(a.clips[i]->name == b.clips[i]->name && a.clips[i]->tracks.size() == b.clips[i]->tracks.size());
+    assert(std::fabs(a.clips[i]->durationSec - b.clips[i]->durationSec) < 1e-3F);
+  }
+  assert(a.lights.size() == b.lights.size());
+  for (size_t i = 0; i < a.lights.size(); ++i) {
+    assert(a.lights[i].type == b.lights[i].type);
+  }
+}
+
+// A one-triangle ASCII FBX: Assimp reads it, the native reader declines it.
+constexpr const char* kAsciiFbx =
+    "; FBX 7.4.0 project file\n"
+    "FBXHeaderExtension:  {\n\tFBXHeaderVersion: 1003\n\tFBXVersion: 7400\n}\n"
+    "Objects:  {\n"
+    "\tGeometry: 1000, \"Geometry::Tri\", \"Mesh\" {\n"
+    "\t\tVertices: *9 {\n\t\t\ta: 0,0,0,1,0,0,0,1,0\n\t\t}\n"
+    "\t\tPolygonVertexIndex: *3 {\n\t\t\ta: 0,1,-3\n\t\t}\n"
+    "\t}\n"
+    "\tModel: 2000, \"Model::Tri\", \"Mesh\" {\n\t\tVersion: 232\n\t}\n"
+    "}\n"
+    "Connections:  {\n\tC: \"OO\",1000,2000\n\tC: \"OO\",2000,0\n}\n";
+
+}  // namespace
+
+int main() {
+  vv::ImportOptions options;
+  options.lodCount = 1;
+  options.generateMips = false;
+  for (const char* path : {"assets/fbx/Taunt.fbx", "assets/fbx/spider.fbx"}) {
+    vv::ImportReport report;
+    const auto native = vv::FbxImporter().Import(path, options, &report);
+    const auto assimp = vv::AssimpFbxImporter().Import(path, options);
+    assert(native.Ok() && assimp.Ok() && report.ok);
+    assert(report.FindStage("inflate_arrays") != nullptr && report.FindStage("geometry") != nullptr);
+    CheckParity(*native.value, *assimp.value);
+  }
+  const auto taunt = vv::FbxImporter().Import("assets/fbx/Taunt.fbx", options);
+  assert(taunt.value->meshes.size() == 2 && taunt.value->skeletons[0]->bones.size() == 65 && !taunt.value->clips.empty());
+  const auto spider = vv::FbxImporter().Import("assets/fbx/spider.fbx", options);
+  assert(spider.value->meshes.size() == 19 && spider.value->materials.size() == 4 && spider.value->lights.size() == 1);
+
+  // ImportSceneFile uses the native reader when asked and hands what it declines to Assimp.
+  options.nativeFbx = true;
+  vv::ImportReport nativeReport;
+  assert(vv::ImportSceneFile("assets/fbx/Taunt.fbx", options, &nativeReport).Ok());
+  assert(nativeReport.fallback.empty() && nativeReport.FindStage("inflate_arrays") != nullptr);
+
+  const fs::path base = fs::temp_directory_path() / "vv_fbx_native_test";
+  fs::create_directories(base);
+  const std::string ascii = (base / "tri.fbx").string();
+  std::ofstream(ascii, std::ios::binary) << kAsciiFbx;
+  assert(!vv::FbxImporter().Import(ascii, options).Ok());
+  vv::ImportReport fallbackReport;
+  const auto fallback = vv::ImportSceneFile(ascii, options, &fallbackReport);
+  assert(fallback.Ok() && fallback.value->meshes.size() == 1);
+  assert(!fallbackReport.fallback.empty() && fallbackReport.FindStage("inflate_arrays") == nullptr);
+
+  // Truncated and corrupt binaries fail cleanly instead of reading past the data.
+  std::ifstream source("assets/fbx/spider.fbx", std::ios::binary);
+  std::string bytes((std::istreambuf_iterator<char>(source)), std::istreambuf_iterator<char>());
+  const std::string truncated = (base / "truncated.fbx").string();
+  std::ofstream(truncated, std::ios::binary) << bytes.substr(0, bytes.size() / 2);
+  assert(!vv::FbxImporter().Import(truncated, options).Ok());
+  for (size_t i = 2000; i < bytes.size(); i += 997) {
+    bytes[i] = static_cast<char>(bytes[i] ^ 0x5A);
+  }
+  const std::string corrupt = (base / "corrupt.fbx").string();
+  std::ofstream(corrupt, std::ios::binary) << bytes;
+  vv::FbxImporter().Import(corrupt, options);
+
+  fs::remove_all(base);
+  return 0;
+}
@@ -0,0 +1,254 @@
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <assimp/Exporter.hpp>
+#include <assimp/Importer.hpp>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+
+#include "asset/import/AssimpFbxImporter.hpp"
+#include "asset/import/GltfImporter.hpp"
+#include "asset/import/SceneImporter.hpp"
+#include "core/io/Json.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+template <typename T>
+void Append(std::vector<uint8_t>& bytes, std::initializer_list<T> values) {
+  for (const T value : values) {
+    const size_t at = bytes.size();
+    bytes.resize(at + sizeof(T));
+    std::memcpy(bytes.data() + at, &value, sizeof(T));
+  }
+}
+
+std::string Base64(const std::vector<uint8_t>& bytes) {
+  static const char* kAlphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (size_t i = 0; i < bytes.size(); i += 3) {
+    const uint32_t n = (static_cast<uint32_t>(bytes[i]) << 16U) |
+                       (i + 1 < bytes.size() ? static_cast<uint32_t>(bytes[i + 1]) << 8U : 0U) |
+                       (i + 2 < bytes.size() ? bytes[i + 2] : 0U);
+    out += kAlphabet[(n >> 18U) & 63U];
+    out += kAlphabet[(n >> 12U) & 63U];
+    out += i + 1 < bytes.size() ? kAlphabet[(n >> 6U) & 63U] : '=';
+    out += i + 2 < bytes.size() ? kAlphabet[n & 63U] : '=';
+  }
+  return out;
+}
+
+void WriteFile(const fs::path& path, const std::string& text) {
+  std::ofstream(path, std::ios::binary) << text;
+}
+
+// A skinned quad drawn as a triangle strip, with a sparse position fix-up, a STEP clip, a spot
+// light and a metal/roughness material.
+std::vector<uint8_t> TestBuffer() {
+  std::vector<uint8_t> b;
+  Append<float>(b, {0, 0, 0, 9, 9, 9, 0, 1, 0, 1, 1, 0});       //   0 POSITION (vertex 1 is sparse)
+  Append<uint16_t>(b, {0, 1, 2, 3});                            //  48 strip indices
+  Append<uint8_t>(b, {0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 1, 0, 0, 0});  //  56 JOINTS_0
+  Append<float>(b, {0.6F, 0.2F, 0, 0, 0.6F, 0.2F, 0, 0, 0.6F, 0.2F, 0, 0, 1, 0, 0, 0});  //  72 WEIGHTS_0
+  Append<float>(b, {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, -2, 0, 1});   // 136 inverse binds
+  Append<float>(b, {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, -1, 0, 1});
+  Append<float>(b, {0, 1});                                     // 264 key times
+  Append<float>(b, {0, 1, 0, 0, 3, 0});                         // 272 translations
+  Append<uint16_t>(b, {1, 0});                                  // 296 sparse index (+ padding)
+  Append<float>(b, {1, 0, 0});                                  // 300 sparse value
+  return b;                                                     // 312
+}
+
+// An empty `bufferUri` leaves buffer 0 to the GLB binary chunk.
+std::string TestJson(const std::string& bufferUri, const std::string& requiredExtension = {}) {
+  const std::string uri = bufferUri.empty() ? "" : "\"uri\": \"" + bufferUri + "\", ";
+  const std::string required = requiredExtension.empty() ? "" : "\"extensionsRequired\": [\"" + requiredExtension + "\"], ";
+  return "{\"asset\": {\"version\": \"2.0\"}, " + required +
+         "\"extensionsUsed\": [\"KHR_lights_punctual\", \"KHR_materials_emissive_strength\"],"
+         "\"scene\": 0, \"scenes\": [{\"nodes\": [0]}],"
+         "\"nodes\": ["
+         "  {\"name\": \"Root\", \"children\": [1, 3]},"
+         "  {\"name\": \"Hip\", \"translation\": [0, 1, 0], \"children\": [2]},"
+         "  {\"name\": \"Knee\", \"translation\": [0, 1, 0]},"
+         "  {\"name\": \"Body\", \"mesh\": 0, \"skin\": 0, \"extensions\": {\"KHR_lights_punctual\": {\"light\": 0}}}],"
+         "\"meshes\": [{\"name\": \"Quad\", \"primitives\": [{\"attributes\": {\"POSITION\": 0, \"JOINTS_0\": 2, "
+         "  \"WEIGHTS_0\": 3}, \"indices\": 1, \"mode\": 5, \"material\": 0}]}],"
+         "\"materials\": [{\"name\": \"Mat\", \"pbrMetallicRoughness\": {\"baseColorFactor\": [0.5, 0.5, 0.5, 1], "
+         "  \"roughnessFactor\": 0.25}, \"alphaMode\": \"MASK\", \"alphaCutoff\": 0.3, \"emissiveFactor\": [1, 0, 0],"
+         "  \"extensions\": {\"KHR_materials_emissive_strength\": {\"emissiveStrength\": 2}}}],"
+         "\"skins\": [{\"joints\": [2, 1], \"inverseBindMatrices\": 4}],"
+         "\"animations\": [{\"name\": \"Kick\", \"channels\": [{\"sampler\": 0, \"target\": {\"node\": 1, "
+         "  \"path\": \"translation\"}}], \"samplers\": [{\"input\": 5, \"output\": 6, \"interpolation\": \"STEP\"}]}],"
+         "\"extensions\": {\"KHR_lights_punctual\": {\"lights\": [{\"type\": \"spot\", \"intensity\": 5, "
+         "  \"spot\": {\"innerConeAngle\": 0.1}}]}},"
+         "\"accessors\": ["
+         "  {\"bufferView\": 0, \"componentType\": 5126, \"count\": 4, \"type\": \"VEC3\", \"sparse\": {\"count\": 1, "
+         "    \"indices\": {\"bufferView\": 6, \"componentType\": 5123}, \"values\": {\"bufferView\": 7}}},"
+         "  {\"bufferView\": 1, \"componentType\": 5123, \"count\": 4, \"type\": \"SCALAR\"},"
+         "  {\"bufferView\": 2, \"componentType\": 5121, \"count\": 4, \"type\": \"VEC4\"},"
+         "  {\"bufferView\": 3, \"componentType\": 5126, \"count\": 4, \"type\": \"VEC4\"},"
+         "  {\"bufferView\": 4, \"componentType\": 5126, \"count\": 2, \"type\": \"MAT4\"},"
+         "  {\"bufferView\": 5, \"componentType\": 5126, \"count\": 2, \"type\": \"SCALAR\"},"
+         "  {\"bufferView\": 5, \"byteOffset\": 8, \"componentType\": 5126, \"count\": 2, \"type\": \"VEC3\"}],"
+         "\"bufferViews\": ["
+         "  {\"buffer\": 0, \"byteOffset\": 0, \"byteLength\": 48},"
+         "  {\"buffer\": 0, \"byteOffset\": 48, \"byteLength\": 8},"
+         "  {\"buffer\": 0, \"byteOffset\": 56, \"byteLength\": 16},"
+         "  {\"buffer\": 0, \"byteOffset\": 72, \"byteLength\": 64},"
+         "  {\"buffer\": 0, \"byteOffset\": 136, \"byteLength\": 128},"
+         "  {\"buffer\": 0, \"byteOffset\": 264, \"byteLength\": 32},"
+         "  {\"buffer\": 0, \"byteOffset\": 296, \"byteLength\": 2},"
+         "  {\"buffer\": 0, \"byteOffset\": 300, \"byteLength\": 12}],"
+         "\"buffers\": [{" + uri + "\"byteLength\": 312}]}";
+}
+
+std::string Glb(std::string json, const std::vector<uint8_t>& bin) {
+  json.append((4 - json.size() % 4) % 4, ' ');
+  std::vector<uint8_t> out;
+  Append<uint32_t>(out, {0x46546C67U, 2, static_cast<uint32_t>(12 + 8 + json.size() + 8 + bin.size())});
+  Append<uint32_t>(out, {static_cast<uint32_t>(json.size()), 0x4E4F534AU});
+  out.insert(out.end(), json.begin(), json.end());
+  Append<uint32_t>(out, {static_cast<uint32_t>(bin.size()), 0x004E4942U});
+  out.insert(out.end(), bin.begin(), bin.end());
+  return std::string(out.begin(), out.end());
+}
+
+void CheckTestScene(const vv::Scene& scene) {
+  assert(scene.nodes.size() == 4 && scene.roots.size() == 1);
+  assert(scene.nodes[1].name == "Hip" && scene.nodes[2].parent == 1);
+
+  // The strip becomes two triangles; the sparse substitution moved vertex 1.
+  assert(scene.meshes.size() == 1);
+  const vv::Mesh& mesh = scene.meshes[0];
+  assert(mesh.indices.size() == 6 && mesh.submeshes.size() == 1);
+  assert(mesh.localBounds.max == vv::Vec3(1.0F, 1.0F, 0.0F));
+  assert(scene.nodes[3].mesh == 0U);
+
+  // Skin joints were listed child first; bones are parents first and vertices still reach Knee.
+  assert(scene.skeletons.size() == 1 && scene.skins.size() == 1);
+  const vv::Skeleton& skeleton = scene.skeletons[0];
+  assert(skeleton.bones.size() == 2 && skeleton.bones[0].name == "Hip" && skeleton.bones[1].name == "Knee");
+  assert(skeleton.bones[0].parentBone == -1 && skeleton.bones[1].parentBone == 0 && skeleton.rootNode == 1);
+  assert(skeleton.bones[0].inverseBind[3][1] == -1.0F && skeleton.bones[1].inverseBind[3][1] == -2.0F);
+  const vv::Skin& skin = scene.skins[0];
+  assert(scene.nodes[3].skin == 0U && skin.palette.size() == skin.joints.size());
+  for (size_t v = 0; v < mesh.vertices.size(); ++v) {
+    const vv::VertexSkinned& vertex = mesh.vertices[v];
+    assert(std::fabs(vertex.weights[0] + vertex.weights[1] + vertex.weights[2] + vertex.weights[3] - 1.0F) < 1e-5F);
+  }
+  assert(skin.joints[mesh.vertices[0].joints[0]] == 1 && skin.joints[mesh.vertices[0].joints[1]] == 0);
+
+  const vv::Material& material = scene.materials[0];
+  assert(material.name == "Mat" && material.metallicFactor == 1.0F && material.roughnessFactor == 0.25F);
+  assert(material.alphaMask && std::fabs(material.alphaCutoff - 0.3F) < 1e-6F && material.emissiveStrength == 2.0F);
+  assert(material.baseColorFactor.x == 0.5F && material.emissiveFactor == vv::Vec3(1.0F, 0.0F, 0.0F));
+
+  // STEP holds the first key until just before the second.
+  assert(scene.clips.size() == 1 && scene.clips[0]->name == "Kick" && scene.clips[0]->durationSec == 1.0F);
+  assert(scene.clips[0]->tracks.size() == 1 && scene.clips[0]->tracks[0].node == 1);
+  const auto& keys = scene.clips[0]->tracks[0].posKeys;
+  assert(keys.size() == 3 && keys[1].value.y == 1.0F && keys[1].time < 1.0F && keys[2].value.y == 3.0F);
+
+  assert(scene.lights.size() == 1 && scene.lights[0].type == vv::LightType::kSpot && scene.lights[0].intensity == 5.0F);
+  assert(std::fabs(scene.lights[0].innerCone - 0.1F) < 1e-6F && scene.nodes[3].light == 0U);
+}
+
+uint64_t Triangles(const vv::Scene& scene) {
+  uint64_t triangles = 0;
+  for (const vv::Mesh& mesh : scene.meshes) {
+    triangles += mesh.indices.size() / 3;
+  }
+  return triangles;
+}
+
+}  // namespace
+
+int main() {
+  const fs::path base = fs::temp_directory_path() / "vv_unit_gltf_import";
+  fs::remove_all(base);
+  fs::create_directories(base);
+
+  // JSON reader.
+  {
+    const auto parsed = vv::ParseJson(R"({"a": [1, -2.5e1, true, null], "s": "x\n\u00e9\ud83d\ude00"})");
+    assert(parsed.Ok());
+    assert(parsed.value->operator[]("a").Size() == 4 && parsed.value->operator[]("a")[1].Number(0) == -25.0);
+    assert(parsed.value->operator[]("s").String() == "x\n\xC3\xA9\xF0\x9F\x98\x80");
+    assert(parsed.value->operator[]("missing")["deeper"][3].Index(7) == 7);
+    assert(!vv::ParseJson("{\"a\": }").Ok() && !vv::ParseJson("[1, 2").Ok() && !vv::ParseJson("{} x").Ok());
+    assert(!vv::ParseJson(std::string(1000, '[') + std::string(1000, ']')).Ok());
+  }
+
+  // The same content as .gltf with a data URI, as .gltf with an external buffer and as .glb.
+  const std::vector<uint8_t> bin = TestBuffer();
+  const vv::ImportOptions options;
+  const vv::GltfImporter importer;
+  WriteFile(base / "quad.gltf", TestJson("data:application/octet-stream;base64," + Base64(bin)));
+  WriteFile(base / "quad external.bin", std::string(bin.begin(), bin.end()));
+  WriteFile(base / "external.gltf", TestJson("quad%20external.bin"));
+  WriteFile(base / "quad.glb", Glb(TestJson({}), bin));
+  for (const char* name : {"quad.gltf", "external.gltf", "quad.glb"}) {
+    vv::ImportReport report;
+    const auto loaded = importer.Import((base / name).string(), options, &report);
+    assert(loaded.Ok() && report.ok);
+    CheckTestScene(*loaded.value);
+  }
+  vv::ImportReport externalReport;
+  assert(importer.Import((base / "external.gltf").string(), options, &externalReport).Ok());
+  assert(externalReport.externalFiles.size() == 1);
+
+  // Broken or unsupported files fail with an error instead of a partial scene.
+  WriteFile(base / "required.gltf", TestJson("quad%20external.bin", "KHR_draco_mesh_compression"));
+  WriteFile(base / "short.glb", Glb(TestJson({}), std::vector<uint8_t>(bin.begin(), bin.begin() + 200)));
+  WriteFile(base / "missing.gltf", TestJson("nothing.bin"));
+  WriteFile(base / "garbage.glb", "glTF but not really");
+  for (const char* name : {"required.gltf", "short.glb", "missing.gltf", "garbage.glb", "absent.gltf"}) {
+    const auto failed = importer.Import((base / name).string(), options);
+    assert(!failed.Ok() && !failed.error.empty());
+  }
+
+  // The bundled FBX re-exported as glTF: the native reader matches Assimp's glTF reader on the
+  // same files, and the external-buffer variant matches the GLB exactly.
+  Assimp::Importer source;
+  const aiScene* fbx = source.ReadFile("assets/fbx/Taunt.fbx", aiProcess_Triangulate);
+  assert(fbx != nullptr);
+  Assimp::Exporter exporter;
+  assert(exporter.Export(fbx, "glb2", (base / "Taunt.glb").string()) == aiReturn_SUCCESS);
+  assert(exporter.Export(fbx, "gltf2", (base / "Taunt.gltf").string()) == aiReturn_SUCCESS);
+
+  vv::ImportOptions compare;
+  compare.convertToMeters = false;
+  compare.lodCount = 1;
+  const auto native = vv::ImportSceneFile((base / "Taunt.glb").string(), compare);
+  const auto nativeText = importer.Import((base / "Taunt.gltf").string(), compare);
+  const auto assimp = vv::AssimpFbxImporter().Import((base / "Taunt.glb").string(), compare);
+  assert(native.Ok() && nativeText.Ok() && assimp.Ok());
+  const vv::Scene& a = *native.value;
+  const vv::Scene& b = *assimp.value;
+  assert(a.meshes.size() == b.meshes.size() && Triangles(a) == Triangles(b) && Triangles(a) > 0);
+  assert(a.skins.size() == b.skins.size() && !a.skins.empty());
+  assert(a.clips.size() == b.clips.size() && !a.clips.empty());
+  for (size_t i = 0; i < a.clips.size(); ++i) {
+    assert(std::fabs(a.clips[i]->durationSec - b.clips[i]->durationSec) < 1e-3F);
+  }
+  for (const vv::Skin& skin : a.skins) {
+    for (const uint32_t bone : skin.joints) {
+      assert(bone < a.skeletons[skin.skeleton]->bones.size());
+    }
+  }
+  assert(nativeText.value->meshes.size() == a.meshes.size());
+  for (size_t m = 0; m < a.meshes.size(); ++m) {
+    assert(nativeText.value->meshes[m]->indices == a.meshes[m]->indices);
+  }
+
+  fs::remove_all(base);
+  return 0;
+}
@@ -0,0 +1,120 @@
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "asset/import/AssimpFbxImporter.hpp"
+#include "asset/import/ImportReport.hpp"
+#include "core/memory/ProcessMemory.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+// Times an outer stage around a nested one that keeps `bytes` of heap.
+vv::ImportReport NestedStages(bool nestedHeapSamples, std::vector<uint8_t>& held, size_t bytes) {
+  vv::ImportReport report;
+  report.nestedHeapSamples = nestedHeapSamples;
+  {
+    vv::ScopedImportStage outer(&report, "outer");
+    vv::ScopedImportStage inner(&report, "inner", "outer");
+    held.assign(bytes, 1);
+  }
+  return report;
+}
+
+}  // namespace
+
+int main() {
+  // Heap use is sampled around top-level stages; nested ones only when asked for.
+  {
+    const size_t bytes = size_t{8} << 20U;
+    std::vector<uint8_t> held;
+    const vv::ImportReport coarse = NestedStages(false, held, bytes);
+    held = std::vector<uint8_t>{};
+    assert(coarse.FindStage("inner") != nullptr && coarse.FindStage("inner")->heapDeltaBytes == 0);
+    assert(coarse.FindStage("inner")->calls == 1);
+    const vv::ImportReport fine = NestedStages(true, held, bytes);
+    if (vv::QueryHeapInUseBytes() > 0) {
+      assert(coarse.FindStage("outer")->heapDeltaBytes >= static_cast<int64_t>(bytes * 9 / 10));
+      assert(fine.FindStage("inner")->heapDeltaBytes >= static_cast<int64_t>(bytes * 9 / 10));
+    }
+  }
+
+  vv::AssimpFbxImporter importer;
+  vv::ImportOptions options;
+  options.lodCount = 1;
+  vv::ImportReport report;
+  const auto loaded = importer.Import("assets/fbx/Taunt.fbx", options, &report);
+  assert(loaded.Ok());
+  const vv::Scene& scene = *loaded.value;
+
+  assert(report.ok && report.error.empty());
+  assert(report.source == "assets/fbx/Taunt.fbx");
+  for (const char* name : {"read_file",
+                           "pp_triangulate",
+                           "pp_limit_bone_weights",
+                           "nodes",
+                           "materials",
+                           "texture_mips",
+                           "meshes",
+                           "mesh_weld",
+                           "mesh_tangents",
+                           "mesh_clusters",
+                           "mesh_lods",
+                           "mesh_cache_order",
+                           "skeleton",
+                           "animations",
+                           "lights",
+                           "world_transforms"}) {
+    const vv::ImportStageReport* stage = report.FindStage(name);
+    assert(stage != nullptr && stage->calls > 0 && stage->wallMs >= 0.0);
+  }
+  assert(report.FindStage("mesh_lods")->parent == "meshes");
+  assert(report.FindStage("mesh_weld")->parent == "meshes");
+  assert(report.FindStage("mesh_cache_order")->parent == "meshes");
+  assert(report.FindStage("mesh_tangents")->parent == "meshes");
+  // Welding, normals and tangents are native by default; Assimp's steps only run when asked for.
+  assert(report.FindStage("pp_join_identical_vertices") == nullptr);
+  assert(report.FindStage("pp_calc_tangent_space") == nullptr);
+  assert(report.FindStage("texture_compress") == nullptr);  // compression is off
+
+  // Top-level stages do not overlap, so they fit inside the total.
+  double topLevelMs = 0.0;
+  for (const vv::ImportStageReport& stage : report.stages) {
+    if (stage.parent.empty()) {
+      topLevelMs += stage.wallMs;
+    }
+  }
+  assert(topLevelMs <= report.wallMs + 0.5);
+  assert(report.FindStage("read_file")->wallMs > 0.0);
+
+  assert(report.counts.meshes == scene.meshes.size());
+  assert(report.counts.nodes == scene.nodes.size());
+  assert(report.counts.textures == scene.textures.size());
+  assert(report.counts.clips == scene.clips.size() && report.counts.keys > 0);
+  assert(report.FindStage("nodes")->items == report.counts.nodes);
+  assert(report.FindStage("meshes")->items == report.counts.meshes);
+
+  const std::string json = vv::ImportReportToJson(report);
+  assert(json.front() == '{' && json.find("\"stages\": [") != std::string::npos);
+  assert(json.find("\"name\": \"mesh_weld\"") != std::string::npos);
+  assert(json.find("\"parent\": \"materials\"") != std::string::npos || report.FindStage("texture_decode") == nullptr);
+
+  // Assimp's tangent space step only runs when asked for.
+  {
+    vv::ImportOptions assimpOptions = options;
+    assimpOptions.assimpTangentSpace = true;
+    vv::ImportReport assimpReport;
+    assert(importer.Import("assets/fbx/Taunt.fbx", assimpOptions, &assimpReport).Ok());
+    const vv::ImportStageReport* stage = assimpReport.FindStage("pp_calc_tangent_space");
+    assert(stage != nullptr && stage->calls > 0);
+  }
+
+  // Failures still produce a report, with the error escaped in JSON.
+  vv::ImportReport failed;
+  assert(!importer.Import("assets/fbx/does_not_exist.fbx", options, &failed).Ok());
+  assert(!failed.ok && !failed.error.empty());
+  failed.error = "bad \"path\"\n";
+  assert(vv::ImportReportToJson(failed).find("\"error\": \"bad \\\"path\\\"\\n\"") != std::string::npos);
+  return 0;
+}
@@ -0,0 +1,244 @@
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "asset/cook/BatchCook.hpp"
+#include "asset/import/GltfImporter.hpp"
+#include "asset/import/ImportCommon.hpp"
+#include "asset/texture/BlockCompression.hpp"
+#include "asset/texture/Ktx2.hpp"
+#include "asset/texture/MipGenerator.hpp"
+#include "asset/texture/TextureRegistry.hpp"
+#include "core/io/Inflate.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+void WriteFile(const fs::path& path, const std::vector<uint8_t>& bytes) {
+  std::ofstream(path, std::ios::binary).write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+std::vector<uint8_t> ReadFile(const fs::path& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::vector<uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// Smooth gradients with a noisy alpha, so both the encoder's matches and its literals get used.
+vv::Texture TestTexture(uint32_t width, uint32_t height, bool srgb) {
+  vv::Texture texture;
+  texture.uri = "test";
+  texture.width = width;
+  texture.height = height;
+  texture.srgb = srgb;
+  texture.format = srgb ? vv::PixelFormat::kR8G8B8A8_SRGB : vv::PixelFormat::kR8G8B8A8;
+  texture.pixels = vv::PixelBuffer(static_cast<size_t>(width) * height * 4);
+  uint32_t noise = 12345;
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      uint8_t* p = texture.pixels.data() + (static_cast<size_t>(y) * width + x) * 4;
+      noise = noise * 1664525U + 1013904223U;
+      p[0] = static_cast<uint8_t>(x * 255 / width);
+      p[1] = static_cast<uint8_t>(y * 255 / height);
+      p[2] = 64;
+      p[3] = static_cast<uint8_t>(192 + (noise >> 28));
+    }
+  }
+  vv::GenerateMipChain(texture);
+  return texture;
+}
+
+bool SamePixels(const vv::PixelBuffer& a, const vv::PixelBuffer& b, size_t bytes) {
+  return a.size() >= bytes && b.size() >= bytes && std::memcmp(a.data(), b.data(), bytes) == 0;
+}
+
+// One triangle whose material samples "albedo.png" as base color.
+std::string TriangleGltf() {
+  return "{\"asset\": {\"version\": \"2.0\"}, \"scene\": 0, \"scenes\": [{\"nodes\": [0]}],"
+         "\"nodes\": [{\"mesh\": 0}],"
+         "\"meshes\": [{\"primitives\": [{\"attributes\": {\"POSITION\": 0}, \"material\": 0}]}],"
+         "\"materials\": [{\"pbrMetallicRoughness\": {\"baseColorTexture\": {\"index\": 0}}}],"
+         "\"textures\": [{\"source\": 0}], \"images\": [{\"uri\": \"albedo.png\"}],"
+         "\"accessors\": [{\"bufferView\": 0, \"componentType\": 5126, \"count\": 3, \"type\": \"VEC3\", "
+         "  \"min\": [0, 0, 0], \"max\": [1, 1, 0]}],"
+         "\"bufferViews\": [{\"buffer\": 0, \"byteLength\": 36}],"
+         "\"buffers\": [{\"byteLength\": 36, \"uri\": \"data:application/octet-stream;base64,"
+         "AAAAAAAAAAAAAAAAAACAPwAAAAAAAAAAAAAAAAAAgD8AAAAA\"}]}";
+}
+
+}  // namespace
+
+int main() {
+  const fs::path base = fs::temp_directory_path() / "vv_unit_ktx2";
+  fs::remove_all(base);
+  fs::create_directories(base);
+
+  // The deflate encoder round-trips through the inflater, falls back to stored blocks for data it
+  // cannot shrink, and handles empty input.
+  {
+    std::vector<uint8_t> text;
+    for (int i = 0; i < 20000; ++i) {
+      text.push_back(static_cast<uint8_t>("the quick brown fox "[i % 20] + (i / 1000)));
+    }
+    std::vector<uint8_t> noise(70000);
+    uint32_t state = 1;
+    for (uint8_t& byte : noise) {
+      state = state * 1664525U + 1013904223U;
+      byte = static_cast<uint8_t>(state >> 24);
+    }
+    for (const std::vector<uint8_t>* input : {&text, &noise}) {
+      const std::vector<uint8_t> packed = vv::DeflateZlib(input->data(), input->size());
+      std::vector<uint8_t> back(input->size());
+      assert(vv::InflateZlib(packed.data(), packed.size(), back.data(), back.size()) && back == *input);
+    }
+    assert(vv::DeflateZlib(text.data(), text.size()).size() < text.size() / 4);
+    assert(vv::DeflateZlib(noise.data(), noise.size()).size() <= noise.size() + 2 * 5 + 6);
+    const std::vector<uint8_t> empty = vv::DeflateZlib(nullptr, 0);
+    assert(vv::InflateZlib(empty.data(), empty.size(), nullptr, 0));
+  }
+
+  // RGBA8 chains round-trip with and without supercompression; levels are stored smallest first
+  // and uncompressed ones start 4-byte aligned.
+  const vv::Texture color = TestTexture(37, 20, true);
+  const size_t colorBytes = vv::MipLevelOffset(37, 20, color.mipLevels);
+  assert(color.mipLevels == 6);
+  {
+    const std::vector<uint8_t> plain = vv::EncodeKtx2(color, vv::Ktx2Supercompression::kNone);
+    const std::vector<uint8_t> zlib = vv::EncodeKtx2(color, vv::Ktx2Supercompression::kZlib);
+    assert(vv::IsKtx2(plain.data(), plain.size()) && zlib.size() < plain.size());
+    for (const std::vector<uint8_t>* file : {&plain, &zlib}) {
+      const auto info = vv::ReadKtx2Info(file->data(), file->size());
+      assert(info.has_value() && info->width == 37 && info->height == 20 && info->srgb);
+      assert(info->format == vv::PixelFormat::kR8G8B8A8_SRGB && info->levels.size() == 6);
+      assert(info->levels[5].offset < info->levels[0].offset && vv::Ktx2ChainBytes(*info) == colorBytes);
+      const auto loaded = vv::LoadKtx2Texture(file->data(), file->size());
+      assert(loaded.has_value() && loaded->mipLevels == 6 && loaded->srgb);
+      assert(loaded->pixels.size() == colorBytes && SamePixels(loaded->pixels, color.pixels, colorBytes));
+    }
+    const auto info = vv::ReadKtx2Info(plain.data(), plain.size());
+    for (const vv::Ktx2Level& level : info->levels) {
+      assert(level.offset % 4 == 0 && level.length == level.uncompressedLength);
+    }
+    assert(info->supercompression == vv::Ktx2Supercompression::kNone);
+
+    // Truncated files, unsupported supercompression and a corrupt deflate stream are rejected.
+    assert(!vv::ReadKtx2Info(plain.data(), plain.size() - 1).has_value());
+    std::vector<uint8_t> zstd = plain;
+    zstd[44] = 2;
+    assert(!vv::ReadKtx2Info(zstd.data(), zstd.size()).has_value());
+    std::vector<uint8_t> corrupt = zlib;
+    const auto zlibInfo = vv::ReadKtx2Info(zlib.data(), zlib.size());
+    corrupt[zlibInfo->levels[0].offset + zlibInfo->levels[0].length / 2] ^= 0x55U;
+    std::vector<uint8_t> out(colorBytes);
+    assert(!vv::ReadKtx2Levels(corrupt.data(), corrupt.size(), *zlibInfo, out.data()));
+  }
+
+  // Block-compressed chains keep their blocks and the sRGB flag; levels are block aligned.
+  {
+    vv::Texture blocks = TestTexture(32, 16, true);
+    assert(vv::CompressTexture(blocks, {vv::CompressionQuality::kFast, true}));
+    const size_t bytes = vv::TextureLevelOffset(blocks.format, 32, 16, blocks.mipLevels);
+    const std::vector<uint8_t> file = vv::EncodeKtx2(blocks, vv::Ktx2Supercompression::kNone);
+    const auto info = vv::ReadKtx2Info(file.data(), file.size());
+    assert(info.has_value() && info->format == blocks.format && info->srgb);
+    for (const vv::Ktx2Level& level : info->levels) {
+      assert(level.offset % vv::BlockBytes(blocks.format) == 0);
+    }
+    const auto loaded = vv::LoadKtx2Texture(file.data(), file.size());
+    assert(loaded.has_value() && loaded->format == blocks.format && loaded->mipLevels == blocks.mipLevels);
+    assert(SamePixels(loaded->pixels, blocks.pixels, bytes));
+
+    // Used as data, the same file loads linear.
+    assert(!vv::MakeKtx2Texture(*info, false).srgb && vv::MakeKtx2Texture(*info, false).format == blocks.format);
+  }
+
+  // The cook writes siblings next to external images; a texture without resident pixels or one
+  // that already is KTX2 gets none.
+  const fs::path png = base / "albedo.png";
+  WriteFile(png, {0x89, 'P', 'N', 'G', 0, 0, 0, 0});  // never decoded: the sibling wins
+  {
+    vv::Scene scene;
+    vv::Texture texture = color;
+    texture.uri = png.string();
+    scene.textures.push_back(texture);
+    vv::Texture lazy;
+    lazy.uri = png.string();
+    scene.textures.push_back(lazy);
+    const auto written = vv::WriteKtx2Siblings(scene, vv::Ktx2Supercompression::kZlib);
+    assert(written.Ok() && *written.value == 1);
+    assert(fs::exists(base / "albedo.ktx2"));
+
+    // Concurrent writers of one sibling (parallel cooks of scenes sharing the image) each use
+    // their own temp file, so every write succeeds and none is left behind.
+    std::vector<std::thread> writers;
+    std::atomic<int> failures{0};
+    for (int t = 0; t < 4; ++t) {
+      writers.emplace_back([&] {
+        for (int k = 0; k < 50; ++k) {
+          const auto again = vv::WriteKtx2Siblings(scene, vv::Ktx2Supercompression::kZlib);
+          failures += again.Ok() && *again.value == 1 ? 0 : 1;
+        }
+      });
+    }
+    for (std::thread& writer : writers) {
+      writer.join();
+    }
+    assert(failures == 0);
+    for (const fs::directory_entry& entry : fs::directory_iterator(base)) {
+      assert(entry.path().filename().string().find(".tmp") == std::string::npos);
+    }
+  }
+
+  // Resolution prefers the sibling unless it is older than the image.
+  const vv::GltfImporter importer;
+  const std::string gltf = TriangleGltf();
+  WriteFile(base / "triangle.gltf", std::vector<uint8_t>(gltf.begin(), gltf.end()));
+  {
+    const auto resolved = vv::ResolveTexturePath(base, "albedo.png");
+    assert(resolved.has_value() && resolved->filename() == "albedo.ktx2");
+    fs::last_write_time(png, fs::last_write_time(base / "albedo.ktx2") + std::chrono::hours(1));
+    assert(vv::ResolveTexturePath(base, "albedo.png")->filename() == "albedo.png");
+    fs::last_write_time(png, fs::last_write_time(base / "albedo.ktx2") - std::chrono::hours(1));
+  }
+
+  // An eager import copies the chain as stored, without decoding anything.
+  {
+    const uint64_t decodedBefore = vv::TextureRegistry::Global().Stats().decodedImages;
+    const auto loaded = importer.Import((base / "triangle.gltf").string(), vv::ImportOptions{});
+    assert(loaded.Ok());
+    const vv::Texture& texture = loaded.value->textures[loaded.value->materials[0].baseColorTex];
+    assert(fs::path(texture.uri).filename() == "albedo.ktx2" && texture.srgb);
+    assert(texture.format == vv::PixelFormat::kR8G8B8A8_SRGB && texture.mipLevels == 6);
+    assert(SamePixels(texture.pixels, color.pixels, colorBytes));
+    assert(vv::TextureRegistry::Global().Stats().decodedImages == decodedBefore);
+  }
+
+  // A lazy import keeps only the header; the levels are read from the mapped file on upload.
+  {
+    vv::ImportOptions lazyOptions;
+    lazyOptions.lazyTextureDecode = true;
+    const auto loaded = importer.Import((base / "triangle.gltf").string(), lazyOptions);
+    assert(loaded.Ok());
+    const vv::Texture& texture = loaded.value->textures[loaded.value->materials[0].baseColorTex];
+    assert(vv::HasLazySource(texture) && vv::IsKtx2Source(texture.source));
+    assert(texture.width == 37 && texture.height == 20 && texture.mipLevels == 6);
+    vv::Ktx2Source source;
+    assert(source.Open(texture.source));
+    std::vector<uint8_t> staging(vv::Ktx2ChainBytes(source.Info()));
+    assert(source.ReadLevels(staging.data()) && std::memcmp(staging.data(), color.pixels.data(), colorBytes) == 0);
+  }
+
+  // Files written by the cook are the bytes EncodeKtx2 produces.
+  assert(ReadFile(base / "albedo.ktx2") == vv::EncodeKtx2(color, vv::Ktx2Supercompression::kZlib));
+
+  fs::remove_all(base);
+  return 0;
+}
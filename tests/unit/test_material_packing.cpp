@@ -0,0 +1,171 @@
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "asset/import/ImportCommon.hpp"
+#include "asset/import/ImportReport.hpp"
+#include "asset/import/MaterialPacking.hpp"
+#include "asset/texture/BlockCompression.hpp"
+#include "asset/texture/Ktx2.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+constexpr uint8_t kOcclusion[4] = {0, 100, 200, 255};
+
+vv::Texture MakeTexture(const std::string& uri, uint32_t width, uint32_t height, bool srgb,
+                        uint8_t (*texel)(uint32_t x, uint32_t y, uint32_t c)) {
+  vv::Texture texture;
+  texture.uri = uri;
+  texture.width = width;
+  texture.height = height;
+  texture.srgb = srgb;
+  texture.format = srgb ? vv::PixelFormat::kR8G8B8A8_SRGB : vv::PixelFormat::kR8G8B8A8;
+  texture.pixels = vv::PixelBuffer(static_cast<size_t>(width) * height * 4);
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      for (uint32_t c = 0; c < 4; ++c) {
+        texture.pixels[(static_cast<size_t>(y) * width + x) * 4 + c] = c == 3 ? 255 : texel(x, y, c);
+      }
+    }
+  }
+  return texture;
+}
+
+uint8_t Texel(const vv::Texture& texture, uint32_t x, uint32_t y, uint32_t c) {
+  return texture.pixels[(static_cast<size_t>(y) * texture.width + x) * 4 + c];
+}
+
+vv::Material BaseMaterial() {
+  vv::Material material = vv::MakeDefaultMaterial("m");
+  material.baseColorTex = 5;
+  return material;
+}
+
+}  // namespace
+
+int main() {
+  vv::Scene scene;
+  vv::AddDefaultTextures(scene);
+  // 5: base color; 6: glTF metallicRoughness with junk in red; 7: occlusion, lazy KTX2 bytes;
+  // 8: block-compressed metallic; 9: roughness at twice the metallic size; 10: specular color;
+  // 11: a texture already laid out as ORM.
+  scene.textures.push_back(MakeTexture("albedo", 2, 2, true, [](uint32_t x, uint32_t, uint32_t) { return static_cast<uint8_t>(x * 90); }));
+  scene.textures.push_back(MakeTexture("mr", 4, 4, false, [](uint32_t x, uint32_t y, uint32_t c) {
+    const uint32_t i = y * 4 + x;
+    return static_cast<uint8_t>(c == 0 ? 7 : (c == 1 ? 10 * i : 200 - 5 * i));
+  }));
+  {
+    const vv::Texture resident = MakeTexture("occlusion.ktx2", 2, 2, false, [](uint32_t x, uint32_t y, uint32_t) { return kOcclusion[y * 2 + x]; });
+    vv::Texture lazy;
+    lazy.uri = resident.uri;
+    lazy.width = 2;
+    lazy.height = 2;
+    lazy.source.bytes = std::make_shared<const std::vector<uint8_t>>(vv::EncodeKtx2(resident, vv::Ktx2Supercompression::kZlib));
+    lazy.source.sizeBytes = lazy.source.bytes->size();
+    scene.textures.push_back(lazy);
+  }
+  vv::Texture metal = MakeTexture("metal", 4, 4, false, [](uint32_t x, uint32_t y, uint32_t) { return static_cast<uint8_t>(x * 60 + y * 5); });
+  assert(vv::CompressTexture(metal, {vv::CompressionQuality::kFast, true}) && vv::IsBlockCompressed(metal.format));
+  scene.textures.push_back(metal);
+  scene.textures.push_back(MakeTexture("rough", 8, 8, false, [](uint32_t x, uint32_t y, uint32_t) { return static_cast<uint8_t>(x * 30 + y); }));
+  scene.textures.push_back(MakeTexture("specular", 2, 2, true, [](uint32_t, uint32_t, uint32_t) { return uint8_t{90}; }));
+  scene.textures.push_back(MakeTexture("gltf_orm", 2, 2, false, [](uint32_t, uint32_t, uint32_t c) { return static_cast<uint8_t>(c * 50); }));
+  const vv::Texture mr = scene.textures[6];
+  vv::Texture metalDecoded;
+  assert(vv::DecompressTexture(metal, metalDecoded));
+  uint64_t sourceBytes = 0;
+  for (vv::TextureId id = 6; id <= 9; ++id) {
+    sourceBytes += scene.textures[id]->pixels.size();
+  }
+
+  vv::Material gltf = BaseMaterial();
+  gltf.metallicRoughnessTex = 6;
+  gltf.occlusionTex = 7;
+  scene.materials.push_back(gltf);
+  scene.materials.push_back(gltf);  // same sources: shares the packed texture
+  vv::Material packed = BaseMaterial();
+  packed.metallicRoughnessTex = 11;
+  packed.occlusionTex = 11;
+  scene.materials.push_back(packed);
+  vv::Material separate = BaseMaterial();
+  separate.useSeparateMetalRoughness = true;
+  separate.metallicTex = 8;
+  separate.roughnessTex = 9;
+  scene.materials.push_back(separate);
+  scene.materials.push_back(BaseMaterial());
+  vv::Material specGloss = BaseMaterial();
+  specGloss.useSpecularGlossiness = true;
+  specGloss.specularTex = 10;
+  specGloss.occlusionTex = 7;
+  scene.materials.push_back(specGloss);
+  vv::Material constant = BaseMaterial();
+  constant.useSeparateMetalRoughness = true;
+  scene.materials.push_back(constant);  // black metallic default: a 1x1 texture
+  constant.metallicTex = vv::kDefaultWhiteLinear;
+  scene.materials.push_back(constant);  // all white: the default itself
+
+  assert(!vv::UsesPackedOrm(scene.materials[0]) && vv::UsesPackedOrm(scene.materials[2]) && vv::UsesPackedOrm(scene.materials[4]));
+  const vv::ImportPackStats stats = vv::PackMaterialTextures(scene);
+  assert(stats.materials == 6 && stats.built == 4 && stats.textures == 4 && stats.bytes == sourceBytes);
+  assert(stats.builtBytes == (4 * 4 + 8 * 8 + 2 * 2 + 1) * 4);
+  for (const vv::Material& material : scene.materials) {
+    assert(vv::UsesPackedOrm(material) && material.baseColorTex == 5);
+  }
+
+  // The four sources are gone and everything after them moved down.
+  assert(scene.textures.size() == 12);
+  assert(scene.textures[5]->uri == "albedo" && scene.textures[6]->uri == "specular" && scene.textures[7]->uri == "gltf_orm");
+  assert(scene.materials[2].metallicRoughnessTex == 7 && scene.materials[4].metallicRoughnessTex == vv::kDefaultWhiteLinear);
+  assert(scene.materials[5].specularTex == 6 && scene.materials[5].useSpecularGlossiness);
+
+  // glTF: green and blue copied, occlusion upsampled into red, shared by both materials.
+  {
+    const vv::Material& m = scene.materials[0];
+    assert(m.metallicRoughnessTex == scene.materials[1].metallicRoughnessTex && m.metallicRoughnessTex == 8);
+    const vv::Texture& orm = scene.textures[m.metallicRoughnessTex];
+    assert(orm.uri == "orm:occlusion.ktx2|mr|mr" && orm.width == 4 && orm.height == 4);
+    assert(orm.format == vv::PixelFormat::kR8G8B8A8 && !orm.srgb && orm.mipLevels == 1 && orm.contentHash != 0);
+    for (uint32_t y = 0; y < 4; ++y) {
+      for (uint32_t x = 0; x < 4; ++x) {
+        assert(Texel(orm, x, y, 1) == Texel(mr, x, y, 1) && Texel(orm, x, y, 2) == Texel(mr, x, y, 2));
+        assert(Texel(orm, x, y, 3) == 255);
+      }
+    }
+    assert(Texel(orm, 0, 0, 0) == kOcclusion[0] && Texel(orm, 3, 0, 0) == kOcclusion[1]);
+    assert(Texel(orm, 0, 3, 0) == kOcclusion[2] && Texel(orm, 3, 3, 0) == kOcclusion[3]);
+    assert(Texel(orm, 1, 0, 0) == 25);  // a quarter of the way from 0 to 100
+  }
+
+  // Separate maps: the packed texture takes the larger size; occlusion is the white default.
+  {
+    const vv::Material& m = scene.materials[3];
+    assert(m.metallicTex == vv::kDefaultBlackLinear && m.roughnessTex == vv::kDefaultWhiteLinear);
+    const vv::Texture& orm = scene.textures[m.metallicRoughnessTex];
+    assert(orm.width == 8 && orm.height == 8);
+    for (uint32_t y = 0; y < 8; ++y) {
+      for (uint32_t x = 0; x < 8; ++x) {
+        assert(Texel(orm, x, y, 0) == 255 && Texel(orm, x, y, 1) == static_cast<uint8_t>(x * 30 + y));
+      }
+    }
+    assert(Texel(orm, 0, 0, 2) == Texel(metalDecoded, 0, 0, 0) && Texel(orm, 7, 7, 2) == Texel(metalDecoded, 3, 3, 0));
+  }
+
+  // Specular-glossiness keeps its specular map and packs occlusion with white roughness/metallic.
+  {
+    const vv::Texture& orm = scene.textures[scene.materials[5].occlusionTex];
+    assert(orm.width == 2 && Texel(orm, 1, 1, 0) == kOcclusion[3] && Texel(orm, 1, 1, 1) == 255 && Texel(orm, 1, 1, 2) == 255);
+    const vv::Texture& black = scene.textures[scene.materials[6].occlusionTex];
+    assert(black.width == 1 && Texel(black, 0, 0, 0) == 255 && Texel(black, 0, 0, 1) == 255 && Texel(black, 0, 0, 2) == 0);
+    assert(scene.materials[7].occlusionTex == vv::kDefaultWhiteLinear);
+  }
+
+  // A second pass finds nothing to do; the report carries the counts.
+  assert(vv::PackMaterialTextures(scene).materials == 0 && scene.textures.size() == 12);
+  vv::ImportReport report;
+  report.packed = stats;
+  assert(vv::ImportReportToJson(report).find("\"packed\": {\"materials\": 6, \"textures\": 4, \"built\": 4") != std::string::npos);
+  return 0;
+}
@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <set>
+#include <vector>
+
+#include <glm/geometric.hpp>
+
+#include "asset/mesh/MeshSimplifier.hpp"
+#include "render/scene/LodSelection.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+// Unit UV sphere. Every ring repeats its first vertex at u = 1, so the u = 0/1 seam is split.
+vv::Mesh MakeSphere(uint32_t segments, uint32_t rings) {
+  vv::Mesh mesh;
+  for (uint32_t r = 0; r <= rings; ++r) {
+    const float theta = glm::pi<float>() * static_cast<float>(r) / static_cast<float>(rings);
+    for (uint32_t s = 0; s <= segments; ++s) {
+      const float u = static_cast<float>(s) / static_cast<float>(segments);
+      const float phi = 2.0F * glm::pi<float>() * static_cast<float>(s % segments) / static_cast<float>(segments);
+      vv::VertexSkinned v;
+      // Poles are exact so every pole corner shares one position.
+      const float ringRadius = r == 0 || r == rings ? 0.0F : std::sin(theta);
+      v.position = vv::Vec3(ringRadius * std::cos(phi), r == 0 ? 1.0F : (r == rings ? -1.0F : std::cos(theta)), ringRadius * std::sin(phi));
+      v.normal = v.position;
+      v.uv0 = vv::Vec2(u, static_cast<float>(r) / static_cast<float>(rings));
+      mesh.vertices.push_back(v);
+    }
+  }
+  for (uint32_t r = 0; r < rings; ++r) {
+    for (uint32_t s = 0; s < segments; ++s) {
+      const uint32_t a = r * (segments + 1) + s;
+      const uint32_t b = a + 1;
+      const uint32_t c = a + segments + 1;
+      const uint32_t d = c + 1;
+      if (r != 0) {
+        mesh.indices.insert(mesh.indices.end(), {a, b, c});
+      }
+      if (r + 1 != rings) {
+        mesh.indices.insert(mesh.indices.end(), {b, d, c});
+      }
+    }
+  }
+  mesh.submeshes.push_back({0, static_cast<uint32_t>(mesh.indices.size()), 0});
+  mesh.localBounds.min = vv::Vec3(-1.0F);
+  mesh.localBounds.max = vv::Vec3(1.0F);
+  return mesh;
+}
+
+// Flat open grid in the xz plane, `size` quads on a side.
+vv::Mesh MakePlane(uint32_t size) {
+  vv::Mesh mesh;
+  for (uint32_t z = 0; z <= size; ++z) {
+    for (uint32_t x = 0; x <= size; ++x) {
+      vv::VertexSkinned v;
+      v.position = vv::Vec3(static_cast<float>(x), 0.0F, static_cast<float>(z));
+      v.uv0 = vv::Vec2(static_cast<float>(x), static_cast<float>(z)) / static_cast<float>(size);
+      mesh.vertices.push_back(v);
+    }
+  }
+  for (uint32_t z = 0; z < size; ++z) {
+    for (uint32_t x = 0; x < size; ++x) {
+      const uint32_t a = z * (size + 1) + x;
+      const uint32_t b = a + 1;
+      const uint32_t c = a + size + 1;
+      const uint32_t d = c + 1;
+      mesh.indices.insert(mesh.indices.end(), {a, c, b, b, c, d});
+    }
+  }
+  mesh.submeshes.push_back({0, static_cast<uint32_t>(mesh.indices.size()), 0});
+  mesh.localBounds.min = vv::Vec3(0.0F);
+  mesh.localBounds.max = vv::Vec3(static_cast<float>(size), 0.0F, static_cast<float>(size));
+  return mesh;
+}
+
+vv::SimplifyResult Simplify(const vv::Mesh& mesh, const vv::SimplifyOptions& options) {
+  const std::vector<uint32_t> tags(mesh.indices.size() / 3, 0);
+  return vv::SimplifyMeshIndices(mesh, mesh.indices, tags, options);
+}
+
+double Area(const vv::Mesh& mesh, const std::vector<uint32_t>& indices) {
+  double area = 0.0;
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    const vv::Vec3& p0 = mesh.vertices[indices[i]].position;
+    const vv::Vec3& p1 = mesh.vertices[indices[i + 1]].position;
+    const vv::Vec3& p2 = mesh.vertices[indices[i + 2]].position;
+    area += 0.5 * glm::length(glm::cross(p1 - p0, p2 - p0));
+  }
+  return area;
+}
+
+vv::Mesh MakeLodMesh(const std::vector<float>& errors) {
+  vv::Mesh mesh = MakePlane(1);
+  for (const float error : errors) {
+    mesh.lods.push_back({mesh.submeshes, error});
+  }
+  return mesh;
+}
+
+}  // namespace
+
+int main() {
+  // Halving a closed sphere stays within the error budget and never stretches a triangle across the
+  // u = 0/1 seam: seam vertices only slide along the seam, onto a wedge with matching UVs.
+  {
+    const vv::Mesh sphere = MakeSphere(32, 16);
+    vv::SimplifyOptions options;
+    options.targetRatio = 0.5F;
+    options.maxError = 0.05F;
+    const vv::SimplifyResult result = Simplify(sphere, options);
+    const size_t before = sphere.indices.size() / 3;
+    const size_t after = result.indices.size() / 3;
+    assert(after > 0 && after <= before / 2 + 8);
+    assert(result.triangleSubmesh.size() == after);
+    assert(result.error > 0.0F && result.error <= options.maxError);
+    for (size_t i = 0; i < result.indices.size(); i += 3) {
+      float minU = 1.0F;
+      float maxU = 0.0F;
+      for (size_t k = 0; k < 3; ++k) {
+        const float u = sphere.vertices[result.indices[i + k]].uv0.x;
+        minU = std::min(minU, u);
+        maxU = std::max(maxU, u);
+      }
+      assert(maxU - minU < 0.5F);
+    }
+
+    // A tight budget stops early instead of exceeding it.
+    options.targetRatio = 0.1F;
+    options.maxError = 0.01F;
+    const vv::SimplifyResult tight = Simplify(sphere, options);
+    assert(tight.error <= options.maxError);
+    assert(tight.indices.size() > result.indices.size() / 5);
+  }
+
+  // Open borders stay put: every border vertex survives and the flat outline keeps its exact area.
+  {
+    const uint32_t size = 16;
+    const vv::Mesh plane = MakePlane(size);
+    vv::SimplifyOptions options;
+    options.targetRatio = 0.25F;
+    const vv::SimplifyResult result = Simplify(plane, options);
+    assert(result.indices.size() < plane.indices.size() / 2);
+    assert(result.error < 1e-3F);
+    assert(std::fabs(Area(plane, result.indices) - static_cast<double>(size * size)) < 1e-3);
+    const std::set<uint32_t> used(result.indices.begin(), result.indices.end());
+    for (uint32_t v = 0; v < plane.vertices.size(); ++v) {
+      const vv::Vec3& p = plane.vertices[v].position;
+      const bool border = p.x == 0.0F || p.z == 0.0F || p.x == static_cast<float>(size) || p.z == static_cast<float>(size);
+      assert(!border || used.count(v) == 1);
+    }
+  }
+
+  // Each level keeps at most 85% of its parent's triangles with a growing error, in ranges appended
+  // to the shared index buffer.
+  {
+    vv::Mesh sphere = MakeSphere(32, 16);
+    const size_t baseIndices = sphere.indices.size();
+    vv::BuildMeshLods(sphere, 3);
+    assert(!sphere.lods.empty() && sphere.lods.size() <= 3);
+    uint32_t parentCount = sphere.submeshes[0].indexCount;
+    float parentError = 0.0F;
+    for (const vv::MeshLod& lod : sphere.lods) {
+      assert(lod.submeshes.size() == 1);
+      const vv::Submesh& range = lod.submeshes[0];
+      assert(range.firstIndex >= baseIndices && range.firstIndex + range.indexCount <= sphere.indices.size());
+      assert(static_cast<float>(range.indexCount) <= 0.85F * static_cast<float>(parentCount));
+      assert(lod.error >= parentError);
+      parentCount = range.indexCount;
+      parentError = lod.error;
+    }
+    assert(&vv::LodSubmeshes(sphere, 0) == &sphere.submeshes);
+    assert(&vv::LodSubmeshes(sphere, 1) == &sphere.lods[0].submeshes);
+  }
+
+  // Selection: with errors 0.01/0.02/0.04 and a 0.0015 budget, LOD 1 fits below a screen size of
+  // 0.3. Switching to it needs 25% headroom (0.24) and leaving it needs 25% overshoot (0.375).
+  {
+    const vv::Mesh mesh = MakeLodMesh({0.01F, 0.02F, 0.04F});
+    vv::LodSelectionSettings settings;
+    settings.maxScreenError = 0.0015F;
+    settings.hysteresis = 0.25F;
+
+    assert(vv::SelectLod(mesh, 0.27F, 0, settings) == 0);  // fits LOD 1, but not with headroom
+    assert(vv::SelectLod(mesh, 0.2F, 0, settings) == 1);
+    assert(vv::SelectLod(mesh, 0.27F, 1, settings) == 1);  // inside the band: no flicker
+    assert(vv::SelectLod(mesh, 0.33F, 1, settings) == 1);  // over budget, but within the overshoot
+    assert(vv::SelectLod(mesh, 0.4F, 1, settings) == 0);
+    // Far away, every level fits; close up, the current level drops as far as needed.
+    assert(vv::SelectLod(mesh, 0.01F, 0, settings) == 3);
+    assert(vv::SelectLod(mesh, 1.0F, 3, settings) == 0);
+    assert(vv::SelectLod(mesh, 0.1F, 3, settings) == 2);
+
+    // Stepping the size up and down across the switch point changes level once each way.
+    uint32_t lod = 0;
+    uint32_t switches = 0;
+    for (int step = 0; step < 40; ++step) {
+      const float size = 0.25F + 0.02F * std::sin(static_cast<float>(step));
+      const uint32_t next = vv::SelectLod(mesh, size, lod, settings);
+      switches += next != lod ? 1U : 0U;
+      lod = next;
+    }
+    assert(switches <= 1);
+
+    settings.enabled = false;
+    assert(vv::SelectLod(mesh, 0.01F, 2, settings) == 0);
+    settings.enabled = true;
+    assert(vv::SelectLod(MakeLodMesh({}), 0.01F, 0, settings) == 0);
+  }
+  return 0;
+}
@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <glm/geometric.hpp>
+
+#include "asset/import/AssimpFbxImporter.hpp"
+#include "render/animation/Animator.hpp"
+#include "render/scene/ClusterCulling.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+// Triangles by corner positions rather than indices: the vertex cache pass renumbers vertices per
+// cluster when there are clusters and per submesh otherwise, so two imports differ in numbering.
+std::vector<std::array<float, 9>> SortedTriangles(const vv::Mesh& mesh, uint32_t first, uint32_t count) {
+  std::vector<std::array<float, 9>> tris;
+  for (uint32_t i = first; i + 2 < first + count; i += 3) {
+    std::array<float, 9> tri{};
+    for (uint32_t k = 0; k < 9; ++k) {
+      tri[k] = mesh.vertices[mesh.indices[i + k / 3]].position[static_cast<int>(k % 3)];
+    }
+    tris.push_back(tri);
+  }
+  std::sort(tris.begin(), tris.end());
+  return tris;
+}
+
+bool InsideSphere(const vv::Vec3& p, const vv::Vec3& center, float radius) {
+  return glm::length(p - center) <= radius * 1.0001F + 1e-4F;
+}
+
+void CheckClusters(const std::string& path) {
+  vv::AssimpFbxImporter importer;
+  vv::ImportOptions options;
+  options.buildClusters = false;
+  const auto reference = importer.Import(path, options);
+  options.buildClusters = true;
+  const auto loaded = importer.Import(path, options);
+  assert(reference.Ok() && loaded.Ok());
+
+  const vv::Scene& scene = *loaded.value;
+  assert(!scene.meshes.empty());
+  for (size_t m = 0; m < scene.meshes.size(); ++m) {
+    const vv::Mesh& mesh = scene.meshes[m];
+    const vv::Mesh& original = reference.value->meshes[m];
+    assert(!mesh.clusters.empty());
+
+    for (uint32_t s = 0; s < mesh.submeshes.size(); ++s) {
+      const vv::Submesh& submesh = mesh.submeshes[s];
+      assert(SortedTriangles(mesh, submesh.firstIndex, submesh.indexCount) ==
+             SortedTriangles(original, submesh.firstIndex, submesh.indexCount));
+
+      uint32_t cursor = submesh.firstIndex;
+      for (const vv::MeshCluster& cluster : mesh.clusters) {
+        if (cluster.submesh != s) {
+          continue;
+        }
+        assert(cluster.firstIndex == cursor);
+        cursor += cluster.indexCount;
+      }
+      assert(cursor == submesh.firstIndex + submesh.indexCount / 3 * 3);
+    }
+
+    for (const vv::MeshCluster& cluster : mesh.clusters) {
+      assert(cluster.indexCount > 0 && cluster.indexCount % 3 == 0);
+      assert(cluster.indexCount / 3 <= vv::kMaxClusterTriangles);
+      std::unordered_set<uint32_t> unique(mesh.indices.begin() + cluster.firstIndex,
+                                          mesh.indices.begin() + cluster.firstIndex + cluster.indexCount);
+      assert(unique.size() == cluster.vertexCount);
+      assert(cluster.vertexCount <= vv::kMaxClusterVertices);
+
+      for (const uint32_t v : unique) {
+        const vv::VertexSkinned& vertex = mesh.vertices[v];
+        assert(InsideSphere(vertex.position, cluster.center, cluster.radius));
+        for (size_t k = 0; k < vv::kMaxBoneInfluence; ++k) {
+          if (vertex.weights[k] <= 0.0F) {
+            continue;
+          }
+          bool covered = false;
+          for (uint32_t b = cluster.firstBone; b < cluster.firstBone + cluster.boneCount; ++b) {
+            const vv::ClusterBoneBounds& bone = mesh.clusterBones[b];
+            covered = covered || (bone.joint == vertex.joints[k] && InsideSphere(vertex.position, bone.center, bone.radius));
+          }
+          assert(covered);
+        }
+      }
+
+      if (cluster.coneSpread < 1.5F) {
+        for (uint32_t i = cluster.firstIndex; i < cluster.firstIndex + cluster.indexCount; i += 3) {
+          const vv::Vec3 a = mesh.vertices[mesh.indices[i]].position;
+          const vv::Vec3 n = glm::cross(mesh.vertices[mesh.indices[i + 1]].position - a,
+                                        mesh.vertices[mesh.indices[i + 2]].position - a);
+          if (glm::length(n) > 1e-12F) {
+            assert(glm::dot(glm::normalize(n), cluster.coneAxis) >= std::cos(cluster.coneSpread) - 1e-4F);
+          }
+        }
+      }
+    }
+  }
+
+  // Pose-expanded bounds must still enclose the CPU-skinned cluster.
+  if (scene.skeletons.empty() || scene.clips.empty()) {
+    return;
+  }
+  vv::Animator animator;
+  animator.Bind(&scene, 0);
+  animator.SetClip(0, true);
+  animator.Update(0.7F);
+
+  for (const vv::Skin& skin : scene.skins) {
+    if (skin.skeleton != 0 || skin.mesh >= scene.meshes.size()) {
+      continue;
+    }
+    std::vector<vv::Mat4> palette;
+    animator.AppendSkinPalette(skin, palette);
+    const vv::Mesh& mesh = scene.meshes[skin.mesh];
+    for (const vv::MeshCluster& cluster : mesh.clusters) {
+      vv::BoundingSphere sphere;
+      vv::NormalCone cone;
+      vv::ComputeClusterPoseBounds(mesh, cluster, &palette, 0, sphere, cone);
+      for (uint32_t i = cluster.firstIndex; i < cluster.firstIndex + cluster.indexCount; ++i) {
+        const vv::VertexSkinned& vertex = mesh.vertices[mesh.indices[i]];
+        vv::Vec4 skinned(0.0F);
+        for (size_t k = 0; k < vv::kMaxBoneInfluence; ++k) {
+          if (vertex.weights[k] > 0.0F && vertex.joints[k] < palette.size()) {
+            skinned += vertex.weights[k] * (palette[vertex.joints[k]] * vv::Vec4(vertex.position, 1.0F));
+          }
+        }
+        assert(InsideSphere(vv::Vec3(skinned), sphere.center, sphere.radius));
+      }
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  const vv::Frustum frustum = vv::ExtractFrustum(vv::Mat4(1.0F));
+  assert(vv::SphereInFrustum(frustum, {vv::Vec3(0.0F, 0.0F, 0.5F), 0.1F}));
+  assert(!vv::SphereInFrustum(frustum, {vv::Vec3(3.0F, 0.0F, 0.5F), 0.5F}));
+  assert(!vv::SphereInFrustum(frustum, {vv::Vec3(0.0F, 0.0F, -1.0F), 0.5F}));
+  assert(vv::ConeFacesAlong({vv::Vec3(0.0F, 1.0F, 0.0F), 0.3F}, vv::Vec3(0.0F, 1.0F, 0.0F)));
+  assert(!vv::ConeFacesAlong({vv::Vec3(0.0F, 1.0F, 0.0F), 1.6F}, vv::Vec3(0.0F, 1.0F, 0.0F)));
+
+  CheckClusters("assets/fbx/Taunt.fbx");
+  CheckClusters("assets/fbx/spider.fbx");
+  return 0;
+}
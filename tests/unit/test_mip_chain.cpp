@@ -0,0 +1,158 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "asset/texture/MipGenerator.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+vv::Texture MakeTexture(uint32_t width, uint32_t height, const std::vector<uint8_t>& rgba) {
+  vv::Texture texture;
+  texture.width = width;
+  texture.height = height;
+  texture.format = vv::PixelFormat::kR8G8B8A8;
+  texture.srgb = false;
+  texture.pixels = vv::PixelBuffer(rgba.size());
+  for (size_t i = 0; i < rgba.size(); ++i) {
+    texture.pixels[i] = rgba[i];
+  }
+  return texture;
+}
+
+// Grey texels with opaque alpha.
+vv::Texture MakeGrey(uint32_t width, uint32_t height, const std::vector<uint8_t>& values) {
+  std::vector<uint8_t> rgba;
+  for (const uint8_t v : values) {
+    rgba.insert(rgba.end(), {v, v, v, 255});
+  }
+  return MakeTexture(width, height, rgba);
+}
+
+const uint8_t* Texel(const vv::Texture& texture, uint32_t level, uint32_t x, uint32_t y) {
+  const size_t offset = vv::MipLevelOffset(texture.width, texture.height, level);
+  return texture.pixels.data() + offset + (static_cast<size_t>(y) * vv::MipDimension(texture.width, level) + x) * 4;
+}
+
+bool Near(uint8_t value, int expected, int tolerance = 1) {
+  return std::abs(static_cast<int>(value) - expected) <= tolerance;
+}
+
+}  // namespace
+
+int main() {
+  // Level counts and sizes follow floor(size / 2^level), clamped to 1, down to 1x1.
+  assert(vv::FullMipLevelCount(1, 1) == 1);
+  assert(vv::FullMipLevelCount(256, 256) == 9);
+  assert(vv::FullMipLevelCount(37, 19) == 6);
+  assert(vv::FullMipLevelCount(1, 300) == 9);
+  assert(vv::MipDimension(37, 1) == 18 && vv::MipDimension(37, 3) == 4 && vv::MipDimension(19, 5) == 1);
+  assert(vv::MipDimension(19, 8) == 1);
+  assert(vv::MipLevelOffset(37, 19, 0) == 0);
+  assert(vv::MipLevelOffset(37, 19, 1) == 37 * 19 * 4);
+  assert(vv::MipLevelOffset(37, 19, 2) == (37 * 19 + 18 * 9) * 4);
+
+  // Non-power-of-two: every level is stored, and a flat image stays flat through the 3-tap levels.
+  {
+    vv::Texture texture = MakeGrey(37, 19, std::vector<uint8_t>(37 * 19, 77));
+    vv::GenerateMipChain(texture);
+    assert(texture.mipLevels == 6);
+    assert(texture.pixels.size() == vv::MipLevelOffset(37, 19, 6));
+    for (uint32_t level = 1; level < texture.mipLevels; ++level) {
+      const uint32_t w = vv::MipDimension(37, level);
+      const uint32_t h = vv::MipDimension(19, level);
+      for (uint32_t y = 0; y < h; ++y) {
+        for (uint32_t x = 0; x < w; ++x) {
+          const uint8_t* t = Texel(texture, level, x, y);
+          assert(t[0] == 77 && t[1] == 77 && t[2] == 77 && t[3] == 255);
+        }
+      }
+    }
+    // A chain that is already there is left alone.
+    const size_t size = texture.pixels.size();
+    vv::GenerateMipChain(texture);
+    assert(texture.pixels.size() == size && texture.mipLevels == 6);
+  }
+
+  // Filtering into a separate chain (upload staging) matches the in-place chain and leaves level 0
+  // of the destination alone.
+  {
+    std::vector<uint8_t> values(13 * 6);
+    for (size_t i = 0; i < values.size(); ++i) {
+      values[i] = static_cast<uint8_t>(i * 37);
+    }
+    vv::Texture texture = MakeGrey(13, 6, values);
+    texture.srgb = true;
+    const vv::Texture level0 = texture;
+    vv::GenerateMipChain(texture);
+    std::vector<uint8_t> chain(texture.pixels.size(), 7);
+    vv::WriteMipLevels(level0, level0.pixels.data(), chain.data());
+    const size_t level0Bytes = vv::MipLevelOffset(13, 6, 1);
+    for (size_t i = 0; i < chain.size(); ++i) {
+      assert(i < level0Bytes ? chain[i] == 7 : chain[i] == texture.pixels[i]);
+    }
+  }
+
+  // Even sizes: a plain 2x2 box. Each 2x2 block of a 4x4 image becomes one texel.
+  {
+    // clang-format off
+    vv::Texture texture = MakeGrey(4, 4, {  0,  20,  100, 100,
+                                           40,  60,  100, 100,
+                                          200, 200,   10,  30,
+                                          200, 200,   50,  70});
+    // clang-format on
+    vv::GenerateMipChain(texture);
+    assert(texture.mipLevels == 3);
+    assert(Texel(texture, 1, 0, 0)[0] == 30);
+    assert(Texel(texture, 1, 1, 0)[0] == 100);
+    assert(Texel(texture, 1, 0, 1)[0] == 200);
+    assert(Texel(texture, 1, 1, 1)[0] == 40);
+    assert(Near(Texel(texture, 2, 0, 0)[0], (30 + 100 + 200 + 40) / 4));
+
+    // A one-texel checkerboard averages to mid grey at every level.
+    std::vector<uint8_t> checker(8 * 8);
+    for (uint32_t i = 0; i < checker.size(); ++i) {
+      checker[i] = ((i % 8) + (i / 8)) % 2 == 0 ? 0 : 255;
+    }
+    vv::Texture board = MakeGrey(8, 8, checker);
+    vv::GenerateMipChain(board);
+    for (uint32_t level = 1; level < board.mipLevels; ++level) {
+      assert(Near(Texel(board, level, 0, 0)[0], 128));
+    }
+  }
+
+  // Odd sizes: three taps weighted by their overlap with the destination texel. 3 -> 1 is the plain
+  // mean; 5 -> 2 weights the middle texel by 2/5 towards both outputs.
+  {
+    vv::Texture three = MakeGrey(3, 1, {0, 90, 180});
+    vv::GenerateMipChain(three);
+    assert(three.mipLevels == 2 && Near(Texel(three, 1, 0, 0)[0], 90));
+
+    vv::Texture five = MakeGrey(5, 1, {0, 50, 100, 150, 200});
+    vv::GenerateMipChain(five);
+    assert(five.mipLevels == 3);
+    // (2*0 + 2*50 + 1*100) / 5 and (1*100 + 2*150 + 2*200) / 5
+    assert(Near(Texel(five, 1, 0, 0)[0], 40));
+    assert(Near(Texel(five, 1, 1, 0)[0], 160));
+  }
+
+  // sRGB colour is averaged in linear light: black and white give 188, not 128. Alpha stays linear.
+  {
+    vv::Texture texture = MakeTexture(2, 1, {0, 0, 0, 0, 255, 255, 255, 255});
+    texture.srgb = true;
+    vv::GenerateMipChain(texture);
+    const uint8_t* t = Texel(texture, 1, 0, 0);
+    assert(Near(t[0], 188) && Near(t[2], 188) && Near(t[3], 128));
+  }
+
+  // Normal maps average as vectors and renormalize: +x and +z give (0.707, 0, 0.707).
+  {
+    vv::Texture texture = MakeTexture(2, 1, {255, 128, 128, 255, 128, 128, 255, 255});
+    texture.normalMap = true;
+    vv::GenerateMipChain(texture);
+    const uint8_t* t = Texel(texture, 1, 0, 0);
+    assert(Near(t[0], 218) && Near(t[1], 128) && Near(t[2], 218));
+  }
+  return 0;
+}
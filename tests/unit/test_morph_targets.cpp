@@ -0,0 +1,227 @@
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <glm/geometric.hpp>
+
+#include "asset/cook/CookedScene.hpp"
+#include "asset/import/GltfImporter.hpp"
+#include "asset/import/ScenePruning.hpp"
+#include "asset/mesh/MorphTargets.hpp"
+#include "render/animation/MorphBlender.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+namespace fs = std::filesystem;
+
+constexpr int kGrid = 8;  // kGrid x kGrid vertices on the z = 0 plane, normals +z
+
+template <typename T>
+void Append(std::vector<uint8_t>& bytes, std::initializer_list<T> values) {
+  for (const T value : values) {
+    const size_t at = bytes.size();
+    bytes.resize(at + sizeof(T));
+    std::memcpy(bytes.data() + at, &value, sizeof(T));
+  }
+}
+
+std::string Base64(const std::vector<uint8_t>& bytes) {
+  static const char* kAlphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (size_t i = 0; i < bytes.size(); i += 3) {
+    const uint32_t n = (static_cast<uint32_t>(bytes[i]) << 16U) |
+                       (i + 1 < bytes.size() ? static_cast<uint32_t>(bytes[i + 1]) << 8U : 0U) |
+                       (i + 2 < bytes.size() ? bytes[i + 2] : 0U);
+    out += kAlphabet[(n >> 18U) & 63U];
+    out += kAlphabet[(n >> 12U) & 63U];
+    out += i + 1 < bytes.size() ? kAlphabet[(n >> 6U) & 63U] : '=';
+    out += i + 2 < bytes.size() ? kAlphabet[n & 63U] : '=';
+  }
+  return out;
+}
+
+// "Bulge" lifts the four vertices around (1.5, 1.5) grid units through a sparse accessor; "Lean"
+// moves and turns the x = 0 column through dense accessors.
+vv::Vec3 BulgeDelta(const vv::Vec3& p) {
+  const bool inside = std::fabs(p.x * 7.0F - 1.5F) < 1.0F && std::fabs(p.y * 7.0F - 1.5F) < 1.0F;
+  return inside ? vv::Vec3(0.0F, 0.0F, 0.5F) : vv::Vec3(0.0F);
+}
+
+vv::Vec3 LeanDelta(const vv::Vec3& p) {
+  return p.x < 0.01F ? vv::Vec3(-0.1F, 0.0F, 0.02F * p.y * 7.0F) : vv::Vec3(0.0F);
+}
+
+vv::Vec3 LeanNormalDelta(const vv::Vec3& p) {
+  return p.x < 0.01F ? vv::Vec3(-0.3F, 0.0F, 0.0F) : vv::Vec3(0.0F);
+}
+
+vv::Vec3 GridPosition(int v) {
+  return vv::Vec3(static_cast<float>(v % kGrid) / 7.0F, static_cast<float>(v / kGrid) / 7.0F, 0.0F);
+}
+
+std::string FixtureJson() {
+  std::vector<uint8_t> b;
+  for (int v = 0; v < kGrid * kGrid; ++v) {  // 0 POSITION
+    const vv::Vec3 p = GridPosition(v);
+    Append<float>(b, {p.x, p.y, p.z});
+  }
+  for (int v = 0; v < kGrid * kGrid; ++v) {  // 768 NORMAL
+    Append<float>(b, {0.0F, 0.0F, 1.0F});
+  }
+  for (int y = 0; y + 1 < kGrid; ++y) {  // 1536 indices
+    for (int x = 0; x + 1 < kGrid; ++x) {
+      const auto v = static_cast<uint16_t>(y * kGrid + x);
+      Append<uint16_t>(b, {v, static_cast<uint16_t>(v + 1), static_cast<uint16_t>(v + kGrid)});
+      Append<uint16_t>(b, {static_cast<uint16_t>(v + 1), static_cast<uint16_t>(v + kGrid + 1),
+                           static_cast<uint16_t>(v + kGrid)});
+    }
+  }
+  Append<uint16_t>(b, {9, 10, 17, 18});  // 2124 Bulge sparse indices
+  for (int i = 0; i < 4; ++i) {          // 2132 Bulge sparse values
+    Append<float>(b, {0.0F, 0.0F, 0.5F});
+  }
+  for (int v = 0; v < kGrid * kGrid; ++v) {  // 2180 Lean POSITION
+    const vv::Vec3 d = LeanDelta(GridPosition(v));
+    Append<float>(b, {d.x, d.y, d.z});
+  }
+  for (int v = 0; v < kGrid * kGrid; ++v) {  // 2948 Lean NORMAL
+    const vv::Vec3 d = LeanNormalDelta(GridPosition(v));
+    Append<float>(b, {d.x, d.y, d.z});
+  }
+  Append<float>(b, {0.0F, 1.0F});              // 3716 key times
+  Append<float>(b, {0.0F, 0.0F, 1.0F, 0.5F});  // 3724 weights, target-major per key
+  assert(b.size() == 3740);
+
+  return "{\"asset\": {\"version\": \"2.0\"}, \"scene\": 0, \"scenes\": [{\"nodes\": [0]}],"
+         "\"nodes\": [{\"name\": \"Root\", \"children\": [1]}, {\"name\": \"Face\", \"mesh\": 0}],"
+         "\"meshes\": [{\"name\": \"Grid\", \"weights\": [0.25, 0], \"extras\": {\"targetNames\": [\"Bulge\", \"Lean\"]},"
+         "  \"primitives\": [{\"attributes\": {\"POSITION\": 0, \"NORMAL\": 1}, \"indices\": 2,"
+         "  \"targets\": [{\"POSITION\": 3}, {\"POSITION\": 4, \"NORMAL\": 5}]}]}],"
+         "\"animations\": [{\"name\": \"Talk\", \"channels\": [{\"sampler\": 0, \"target\": {\"node\": 1, "
+         "  \"path\": \"weights\"}}], \"samplers\": [{\"input\": 6, \"output\": 7}]}],"
+         "\"accessors\": ["
+         "  {\"bufferView\": 0, \"componentType\": 5126, \"count\": 64, \"type\": \"VEC3\"},"
+         "  {\"bufferView\": 1, \"componentType\": 5126, \"count\": 64, \"type\": \"VEC3\"},"
+         "  {\"bufferView\": 2, \"componentType\": 5123, \"count\": 294, \"type\": \"SCALAR\"},"
+         "  {\"componentType\": 5126, \"count\": 64, \"type\": \"VEC3\", \"sparse\": {\"count\": 4, "
+         "    \"indices\": {\"bufferView\": 3, \"componentType\": 5123}, \"values\": {\"bufferView\": 4}}},"
+         "  {\"bufferView\": 5, \"componentType\": 5126, \"count\": 64, \"type\": \"VEC3\"},"
+         "  {\"bufferView\": 6, \"componentType\": 5126, \"count\": 64, \"type\": \"VEC3\"},"
+         "  {\"bufferView\": 7, \"componentType\": 5126, \"count\": 2, \"type\": \"SCALAR\"},"
+         "  {\"bufferView\": 8, \"componentType\": 5126, \"count\": 4, \"type\": \"SCALAR\"}],"
+         "\"bufferViews\": ["
+         "  {\"buffer\": 0, \"byteOffset\": 0, \"byteLength\": 768},"
+         "  {\"buffer\": 0, \"byteOffset\": 768, \"byteLength\": 768},"
+         "  {\"buffer\": 0, \"byteOffset\": 1536, \"byteLength\": 588},"
+         "  {\"buffer\": 0, \"byteOffset\": 2124, \"byteLength\": 8},"
+         "  {\"buffer\": 0, \"byteOffset\": 2132, \"byteLength\": 48},"
+         "  {\"buffer\": 0, \"byteOffset\": 2180, \"byteLength\": 768},"
+         "  {\"buffer\": 0, \"byteOffset\": 2948, \"byteLength\": 768},"
+         "  {\"buffer\": 0, \"byteOffset\": 3716, \"byteLength\": 8},"
+         "  {\"buffer\": 0, \"byteOffset\": 3724, \"byteLength\": 16}],"
+         "\"buffers\": [{\"uri\": \"data:application/octet-stream;base64," + Base64(b) + "\", \"byteLength\": 3740}]}";
+}
+
+bool Near(const vv::Vec3& a, const vv::Vec3& b, float tolerance) {
+  const vv::Vec3 d = glm::abs(a - b);
+  return d.x <= tolerance && d.y <= tolerance && d.z <= tolerance;
+}
+
+// Every vertex against base + sum of weight * source delta, with normals renormalized.
+void CheckBlend(const vv::Mesh& mesh, const vv::MorphBlender& blender, float bulge, float lean) {
+  const std::vector<vv::VertexSkinned>& out = blender.Vertices();
+  assert(out.size() == mesh.vertices.size());
+  size_t moved = 0;
+  for (size_t v = 0; v < out.size(); ++v) {
+    const vv::VertexSkinned& base = mesh.vertices[v];
+    const vv::Vec3 delta = bulge * BulgeDelta(base.position) + lean * LeanDelta(base.position);
+    assert(Near(out[v].position, base.position + delta, 1e-4F));
+    const vv::Vec3 normal = glm::normalize(base.normal + lean * LeanNormalDelta(base.position));
+    assert(Near(out[v].normal, normal, 1e-4F));
+    moved += glm::length(delta) > 0.0F ? 1 : 0;
+  }
+  assert(blender.Moved().size() == moved);
+}
+
+}  // namespace
+
+int main() {
+  const fs::path dir = fs::temp_directory_path() / "vv_unit_morph_targets";
+  fs::create_directories(dir);
+  const fs::path path = dir / "grid.gltf";
+  std::ofstream(path, std::ios::binary) << FixtureJson();
+
+  vv::ImportOptions options;
+  options.lodCount = 1;
+  options.generateMips = false;
+  options.quantizeVertices = true;
+  auto imported = vv::GltfImporter().Import(path.string(), options);
+  assert(imported.Ok());
+  vv::Scene& scene = *imported.value;
+
+  // Only the vertices a target moves are stored, whatever the weld did to the vertex order.
+  assert(scene.meshes.size() == 1);
+  const vv::Mesh& mesh = scene.meshes[0];
+  assert(mesh.vertices.size() == kGrid * kGrid);
+  assert(mesh.morphTargets.size() == 2 && mesh.morphTargets[0].name == "Bulge" && mesh.morphTargets[1].name == "Lean");
+  assert(mesh.morphWeights == std::vector<float>({0.25F, 0.0F}));
+  const vv::MorphTarget& bulge = mesh.morphTargets[0];
+  const vv::MorphTarget& lean = mesh.morphTargets[1];
+  assert(bulge.vertices.size() == 4 && bulge.normalDeltas[0].empty());
+  assert(lean.vertices.size() == kGrid && lean.normalDeltas[0].size() == kGrid);
+  for (size_t e = 0; e < lean.vertices.size(); ++e) {
+    const vv::Vec3& p = mesh.vertices[lean.vertices[e]].position;
+    assert(Near(vv::MorphPositionDelta(lean, e), LeanDelta(p), 0.1F / 32767.0F + 1e-7F));
+    assert(Near(vv::MorphNormalDelta(lean, e), LeanNormalDelta(p), 0.3F / 32767.0F + 1e-7F));
+  }
+  assert(vv::MorphTargetBytes(mesh) * 4 < vv::DenseMorphTargetBytes(mesh));
+
+  // Bounds hold the mesh under any weights in [0, 1]; clusters grew with them.
+  assert(mesh.localBounds.max.z >= 0.5F - 1e-5F && mesh.localBounds.min.x <= -0.1F + 1e-5F);
+  for (const vv::MeshCluster& cluster : mesh.clusters) {
+    assert(cluster.coneSpread >= 3.0F);
+  }
+
+  // The weights channel becomes one dense track on the node drawing the mesh.
+  assert(scene.clips.size() == 1 && scene.clips[0]->morphTracks.size() == 1);
+  const vv::MorphWeightTrack* track = vv::FindMorphTrack(scene.clips[0], 1);
+  assert(track != nullptr && track->targets == 2 && scene.nodes[track->node].mesh == 0U);
+  std::vector<float> weights;
+  vv::SampleMorphWeights(*track, 0.5F, weights);
+  assert(weights.size() == 2 && std::fabs(weights[0] - 0.5F) < 1e-6F && std::fabs(weights[1] - 0.25F) < 1e-6F);
+  vv::SampleMorphWeights(*track, 3.0F, weights);
+  assert(weights == std::vector<float>({1.0F, 0.5F}));
+
+  // Blending matches the dense reference, and vertices go back to rest once their weight is gone.
+  vv::MorphBlender blender;
+  blender.Bind(&mesh);
+  blender.Apply({0.5F, 0.25F});
+  CheckBlend(mesh, blender, 0.5F, 0.25F);
+  blender.Apply({1.0F, 0.0F});
+  CheckBlend(mesh, blender, 1.0F, 0.0F);
+  blender.Apply({});
+  CheckBlend(mesh, blender, 0.0F, 0.0F);
+  assert(blender.Moved().empty());
+
+  // Tracks follow their node through pruning, and targets survive a cook round trip.
+  vv::PruneScene(scene);
+  assert(scene.clips[0]->morphTracks.size() == 1 && scene.nodes[scene.clips[0]->morphTracks[0].node].mesh == 0U);
+  const fs::path cookedPath = dir / "grid.vvscene";
+  std::string error;
+  assert(vv::WriteCookedScene(cookedPath.string(), scene, vv::CookedSceneHeader{}, error));
+  const auto cooked = vv::ReadCookedScene(cookedPath.string());
+  assert(cooked.Ok());
+  const vv::Mesh& reread = cooked.value->meshes[0];
+  assert(reread.morphTargets.size() == 2 && reread.morphTargets[1].vertices == lean.vertices);
+  assert(reread.morphTargets[1].normalDeltas[2] == lean.normalDeltas[2] && reread.morphWeights == mesh.morphWeights);
+  assert(cooked.value->clips[0]->morphTracks[0].weights == scene.clips[0]->morphTracks[0].weights);
+
+  fs::remove_all(dir);
+  return 0;
+}
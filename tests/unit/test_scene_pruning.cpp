@@ -0,0 +1,149 @@
+#include <cassert>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "asset/import/FbxImporter.hpp"
+#include "asset/import/ScenePruning.hpp"
+#include "render/animation/Animator.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+vv::NodeId AddNode(vv::Scene& scene, const std::string& name, vv::NodeId parent, const vv::Vec3& translation) {
+  const auto id = static_cast<vv::NodeId>(scene.nodes.size());
+  vv::Node node;
+  node.name = name;
+  node.parent = parent;
+  node.localBind.translation = translation;
+  node.localCurrent = node.localBind;
+  scene.nodes.push_back(node);
+  if (parent == vv::kInvalidNodeId) {
+    scene.roots.push_back(id);
+  } else {
+    scene.nodes[parent].children.push_back(id);
+  }
+  return id;
+}
+
+void AddBone(vv::Skeleton& skeleton, const vv::Scene& scene, vv::NodeId node, int32_t parentBone) {
+  vv::Bone bone;
+  bone.name = scene.nodes[node].name;
+  bone.node = node;
+  bone.parentBone = parentBone;
+  skeleton.boneMap[bone.name] = static_cast<uint32_t>(skeleton.bones.size());
+  skeleton.bones.push_back(bone);
+}
+
+vv::NodeTrack Track(vv::NodeId node, const vv::Vec3& from, const vv::Vec3& to) {
+  vv::NodeTrack track;
+  track.node = node;
+  track.posKeys = {{.time = 0.0F, .value = from}, {.time = 1.0F, .value = to}};
+  return track;
+}
+
+std::vector<vv::Mat4> SkinPalettes(const vv::Scene& scene, float timeSec) {
+  std::vector<vv::Mat4> out;
+  for (size_t s = 0; s < scene.skeletons.size(); ++s) {
+    vv::Animator animator;
+    animator.Bind(&scene, static_cast<vv::SkeletonId>(s));
+    animator.SetClip(0, true);
+    animator.Update(timeSec);
+    for (const vv::Skin& skin : scene.skins) {
+      if (skin.skeleton == s) {
+        animator.AppendSkinPalette(skin, out);
+      }
+    }
+  }
+  return out;
+}
+
+bool Near(const std::vector<vv::Mat4>& a, const std::vector<vv::Mat4>& b, float tolerance) {
+  if (a.size() != b.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < a.size(); ++i) {
+    for (int c = 0; c < 4; ++c) {
+      for (int r = 0; r < 4; ++r) {
+        if (std::fabs(a[i][c][r] - b[i][c][r]) > tolerance) {
+          return false;
+        }
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  // Root -> Armature -> Offset -> Hips -> Spine -> Head -> HeadEnd, Hips -> IKTarget, Root -> Body.
+  vv::Scene scene;
+  const vv::NodeId root = AddNode(scene, "Root", vv::kInvalidNodeId, vv::Vec3(0.0F));
+  const vv::NodeId armature = AddNode(scene, "Armature", root, vv::Vec3(0.0F, 0.0F, 1.0F));
+  scene.nodes[armature].localBind.rotation = glm::angleAxis(0.5F, vv::Vec3(1.0F, 0.0F, 0.0F));
+  const vv::NodeId offset = AddNode(scene, "Offset", armature, vv::Vec3(2.0F, 0.0F, 0.0F));
+  const vv::NodeId hips = AddNode(scene, "Hips", offset, vv::Vec3(0.0F, 1.0F, 0.0F));
+  const vv::NodeId spine = AddNode(scene, "Spine", hips, vv::Vec3(0.0F, 0.5F, 0.0F));
+  const vv::NodeId head = AddNode(scene, "Head", spine, vv::Vec3(0.0F, 0.5F, 0.0F));
+  const vv::NodeId headEnd = AddNode(scene, "HeadEnd", head, vv::Vec3(0.0F, 0.2F, 0.0F));
+  const vv::NodeId ikTarget = AddNode(scene, "IKTarget", hips, vv::Vec3(1.0F, 0.0F, 0.0F));
+  const vv::NodeId body = AddNode(scene, "Body", root, vv::Vec3(0.0F));
+  scene.nodes[body].mesh = 0;
+  scene.nodes[body].skin = 0;
+
+  vv::Skeleton skeleton;
+  AddBone(skeleton, scene, hips, -1);
+  AddBone(skeleton, scene, spine, 0);
+  AddBone(skeleton, scene, head, 1);
+  AddBone(skeleton, scene, headEnd, 2);
+  skeleton.rootNode = hips;
+  scene.skeletons.push_back(skeleton);
+  scene.skins.push_back(vv::Skin{.skeleton = 0, .mesh = 0, .joints = {1, 0}, .palette = {}});
+
+  vv::AnimationClip clip;
+  clip.durationSec = 1.0F;
+  clip.tracks.push_back(Track(hips, vv::Vec3(0.0F, 1.0F, 0.0F), vv::Vec3(0.0F, 2.0F, 0.0F)));
+  clip.tracks.push_back(Track(spine, vv::Vec3(0.0F, 0.5F, 0.0F), vv::Vec3(0.0F, 0.5F, 0.0F)));  // the bind pose
+  clip.tracks.push_back(Track(head, vv::Vec3(0.0F), vv::Vec3(1.0F)));
+  clip.tracks.push_back(Track(ikTarget, vv::Vec3(0.0F), vv::Vec3(1.0F)));
+  scene.clips.push_back(clip);
+
+  const std::vector<vv::Mat4> before = SkinPalettes(scene, 0.4F);
+  const vv::ImportPruneStats stats = vv::PruneScene(scene);
+  assert(Near(SkinPalettes(scene, 0.4F), before, 1e-5F));
+
+  // Head and HeadEnd weigh nothing; IKTarget and the Head track move nothing drawn; the Spine
+  // track repeats the bind pose; Armature folds into Offset.
+  assert(stats.bones == 2 && stats.nodes == 4 && stats.tracks == 3 && stats.channels == 1 && stats.bytes > 0);
+  assert(scene.nodes.size() == 5 && scene.roots.size() == 1);
+  assert(scene.nodes[1].name == "Offset" && scene.nodes[1].parent == 0 && scene.nodes[2].name == "Hips");
+  assert(scene.nodes[2].parent == 1 && scene.nodes[4].name == "Body" && scene.nodes[4].mesh == 0u);
+  assert(scene.nodes[0].children.size() == 2);
+  const vv::Skeleton& pruned = scene.skeletons[0];
+  assert(pruned.bones.size() == 2 && pruned.bones[1].parentBone == 0 && pruned.rootNode == 2);
+  assert(pruned.boneMap.size() == 2 && pruned.boneMap.at("Spine") == 1);
+  assert(scene.skins[0].joints == std::vector<uint32_t>({1, 0}));
+  assert(scene.clips[0]->tracks.size() == 1 && scene.clips[0]->tracks[0].node == 2);
+
+  // A second pass has nothing left to remove.
+  const vv::ImportPruneStats again = vv::PruneScene(scene);
+  assert(again.bones == 0 && again.nodes == 0 && again.tracks == 0 && again.channels == 0);
+
+  // On a real rig: the skins pose exactly as before, with fewer bones and tracks.
+  vv::ImportOptions options;
+  options.lodCount = 1;
+  options.generateMips = false;
+  const auto full = vv::FbxImporter().Import("assets/fbx/Taunt.fbx", options);
+  options.pruneScene = true;
+  vv::ImportReport report;
+  const auto lean = vv::FbxImporter().Import("assets/fbx/Taunt.fbx", options, &report);
+  assert(full.Ok() && lean.Ok() && report.FindStage("prune") != nullptr);
+  assert(report.pruned.bones > 0 && report.counts.bones + report.pruned.bones == full.value->skeletons[0]->bones.size());
+  for (const float t : {0.0F, 0.7F, 1.9F}) {
+    assert(Near(SkinPalettes(*lean.value, t), SkinPalettes(*full.value, t), 1e-3F));
+  }
+  return 0;
+}
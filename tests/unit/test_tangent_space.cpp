@@ -0,0 +1,205 @@
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <glm/geometric.hpp>
+
+#include "asset/import/AssimpFbxImporter.hpp"
+#include "asset/mesh/TangentSpace.hpp"
+#include "asset/mesh/VertexQuantization.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+// Grid in the xz plane facing +y, `cols` quads wide. Columns at x >= mirrorX get mirrored u.
+vv::Mesh MakeGrid(uint32_t cols, uint32_t rows, float mirrorX) {
+  vv::Mesh mesh;
+  for (uint32_t z = 0; z <= rows; ++z) {
+    for (uint32_t x = 0; x <= cols; ++x) {
+      vv::VertexSkinned v;
+      v.position = vv::Vec3(static_cast<float>(x), 0.0F, static_cast<float>(z));
+      const float u = static_cast<float>(x) <= mirrorX ? static_cast<float>(x) : 2.0F * mirrorX - static_cast<float>(x);
+      v.uv0 = vv::Vec2(u, static_cast<float>(z));
+      mesh.vertices.push_back(v);
+    }
+  }
+  for (uint32_t z = 0; z < rows; ++z) {
+    for (uint32_t x = 0; x < cols; ++x) {
+      const uint32_t a = z * (cols + 1) + x;
+      const uint32_t b = a + 1;
+      const uint32_t c = a + cols + 1;
+      const uint32_t d = c + 1;
+      mesh.indices.insert(mesh.indices.end(), {a, c, b, b, c, d});  // counter-clockwise seen from +y
+    }
+  }
+  mesh.submeshes.push_back({0, static_cast<uint32_t>(mesh.indices.size()), 0});
+  mesh.localBounds.min = vv::Vec3(0.0F);
+  mesh.localBounds.max = vv::Vec3(static_cast<float>(cols), 0.0F, static_cast<float>(rows));
+  return mesh;
+}
+
+bool Near(const vv::Vec3& a, const vv::Vec3& b) {
+  return glm::length(a - b) < 1e-4F;
+}
+
+// Unit cube on 8 shared corners, counter-clockwise seen from outside, as an exporter that drops
+// normals writes it.
+vv::Mesh MakeCube() {
+  vv::Mesh mesh;
+  for (uint32_t i = 0; i < 8; ++i) {
+    vv::VertexSkinned v;
+    v.position = vv::Vec3((i & 1U) != 0 ? 1.0F : 0.0F, (i & 2U) != 0 ? 1.0F : 0.0F, (i & 4U) != 0 ? 1.0F : 0.0F);
+    mesh.vertices.push_back(v);
+  }
+  // clang-format off
+  mesh.indices = {0, 2, 3, 0, 3, 1,   // -z
+                  4, 5, 7, 4, 7, 6,   // +z
+                  0, 4, 6, 0, 6, 2,   // -x
+                  1, 3, 7, 1, 7, 5,   // +x
+                  0, 1, 5, 0, 5, 4,   // -y
+                  2, 6, 7, 2, 7, 3};  // +y
+  // clang-format on
+  mesh.submeshes.push_back({0, static_cast<uint32_t>(mesh.indices.size()), 0});
+  mesh.localBounds.min = vv::Vec3(0.0F);
+  mesh.localBounds.max = vv::Vec3(1.0F);
+  return mesh;
+}
+
+vv::Vec3 FaceNormal(const vv::Mesh& mesh, size_t first) {
+  const vv::Vec3& p0 = mesh.vertices[mesh.indices[first]].position;
+  const vv::Vec3& p1 = mesh.vertices[mesh.indices[first + 1]].position;
+  const vv::Vec3& p2 = mesh.vertices[mesh.indices[first + 2]].position;
+  return glm::normalize(glm::cross(p1 - p0, p2 - p0));
+}
+
+// Fraction of corners whose stored frame agrees with the triangle's UV bitangent direction.
+double BitangentAgreement(const vv::Mesh& mesh) {
+  size_t agree = 0;
+  size_t total = 0;
+  for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+    const vv::VertexSkinned* v[3] = {
+        &mesh.vertices[mesh.indices[i]], &mesh.vertices[mesh.indices[i + 1]], &mesh.vertices[mesh.indices[i + 2]]};
+    const vv::Vec3 e1 = v[1]->position - v[0]->position;
+    const vv::Vec3 e2 = v[2]->position - v[0]->position;
+    const vv::Vec2 d1 = v[1]->uv0 - v[0]->uv0;
+    const vv::Vec2 d2 = v[2]->uv0 - v[0]->uv0;
+    const float area = d1.x * d2.y - d2.x * d1.y;
+    if (std::fabs(area) < 1e-10F) {
+      continue;
+    }
+    const vv::Vec3 bitangent = (e2 * d1.x - e1 * d2.x) / area;
+    for (const vv::VertexSkinned* corner : v) {
+      const vv::Vec3 t(corner->tangent.x, corner->tangent.y, corner->tangent.z);
+      agree += glm::dot(glm::cross(corner->normal, t) * corner->tangent.w, bitangent) > 0.0F ? 1 : 0;
+      ++total;
+    }
+  }
+  return total > 0 ? static_cast<double>(agree) / static_cast<double>(total) : 1.0;
+}
+
+}  // namespace
+
+int main() {
+  // Plain grid: T follows +u, B = w * cross(N, T) follows +v, nothing splits.
+  vv::Mesh grid = MakeGrid(4, 3, 100.0F);
+  for (vv::VertexSkinned& v : grid.vertices) {
+    v.normal = vv::Vec3(0.3F, -0.2F, 0.9F);  // garbage, regenerated below
+  }
+  vv::TangentSpaceOptions options;
+  options.generateNormals = true;
+  const vv::TangentSpaceResult plain = vv::GenerateTangentSpace(grid, options);
+  assert(plain.splitVertices == 0 && plain.degenerateCorners == 0);
+  for (const vv::VertexSkinned& v : grid.vertices) {
+    assert(Near(v.normal, vv::Vec3(0.0F, 1.0F, 0.0F)));
+    assert(Near(vv::Vec3(v.tangent), vv::Vec3(1.0F, 0.0F, 0.0F)));
+    assert(Near(glm::cross(v.normal, vv::Vec3(v.tangent)) * v.tangent.w, vv::Vec3(0.0F, 0.0F, 1.0F)));
+  }
+
+  // Mirrored UVs: the seam column is shared by both sides and splits; each side keeps its own sign.
+  vv::Mesh mirrored = MakeGrid(4, 2, 2.0F);
+  mirrored.lods.push_back({{{static_cast<uint32_t>(mirrored.indices.size()), static_cast<uint32_t>(mirrored.indices.size()), 0}}, 0.0F});
+  const std::vector<uint32_t> lod0 = mirrored.indices;
+  mirrored.indices.insert(mirrored.indices.end(), lod0.begin(), lod0.end());  // a "coarser" LOD reusing LOD0
+  vv::PackMeshVertices(mirrored);
+  const size_t vertexCount = mirrored.vertices.size();
+  const vv::TangentSpaceResult split = vv::GenerateTangentSpace(mirrored);
+  assert(split.splitVertices == 3);  // x == 2 for z = 0..2
+  assert(mirrored.vertices.size() == vertexCount + 3);
+  assert(BitangentAgreement(mirrored) == 1.0);
+  for (size_t i = 0; i < lod0.size(); ++i) {
+    assert(mirrored.indices[lod0.size() + i] == mirrored.indices[i]);  // LOD ranges follow the split
+  }
+  for (size_t i = 0; i < lod0.size(); i += 3) {
+    const vv::VertexSkinned* corners[3] = {&mirrored.vertices[mirrored.indices[i]],
+                                           &mirrored.vertices[mirrored.indices[i + 1]],
+                                           &mirrored.vertices[mirrored.indices[i + 2]]};
+    const float centroidX = (corners[0]->position.x + corners[1]->position.x + corners[2]->position.x) / 3.0F;
+    const vv::Vec3 expected(centroidX < 2.0F ? 1.0F : -1.0F, 0.0F, 0.0F);  // +u runs towards -x past the seam
+    for (const vv::VertexSkinned* corner : corners) {
+      assert(Near(vv::Vec3(corner->tangent), expected));
+    }
+  }
+  assert(mirrored.packedVertices.size() == mirrored.vertices.size() * vv::VertexStride(mirrored.vertexLayout));
+
+  // Cube: faces meet at 90 degrees, past the default crease, so every corner splits into one vertex
+  // per face carrying the face normal. A coarser LOD reusing the corners picks the matching copies.
+  {
+    vv::Mesh cube = MakeCube();
+    const size_t faceIndices = cube.indices.size();
+    cube.lods.push_back({{{static_cast<uint32_t>(faceIndices), static_cast<uint32_t>(faceIndices), 0}}, 0.0F});
+    const std::vector<uint32_t> lod0 = cube.indices;
+    cube.indices.insert(cube.indices.end(), lod0.begin(), lod0.end());
+    vv::TangentSpaceOptions creased;
+    creased.generateNormals = true;
+    creased.generateTangents = false;
+    const vv::TangentSpaceResult result = vv::GenerateTangentSpace(cube, creased);
+    assert(result.creaseSplitVertices == 16 && cube.vertices.size() == 24);
+    for (size_t i = 0; i < cube.indices.size(); i += 3) {
+      const vv::Vec3 face = FaceNormal(cube, i);
+      for (size_t k = 0; k < 3; ++k) {
+        assert(Near(cube.vertices[cube.indices[i + k]].normal, face));
+      }
+    }
+    for (size_t i = 0; i < faceIndices; ++i) {
+      assert(cube.indices[faceIndices + i] == cube.indices[i]);
+    }
+
+    // 180 degrees smooths everything: 8 corners, each normal along its diagonal.
+    vv::Mesh smooth = MakeCube();
+    creased.creaseAngleDegrees = 180.0F;
+    assert(vv::GenerateTangentSpace(smooth, creased).creaseSplitVertices == 0 && smooth.vertices.size() == 8);
+    for (const vv::VertexSkinned& v : smooth.vertices) {
+      assert(Near(v.normal, glm::normalize(v.position - vv::Vec3(0.5F))));
+    }
+  }
+
+  // Bundled assets: native frames are at least as consistent as Assimp's, and orthonormal.
+  for (const char* path : {"assets/fbx/Taunt.fbx", "assets/fbx/spider.fbx"}) {
+    vv::AssimpFbxImporter importer;
+    vv::ImportOptions importOptions;
+    importOptions.buildClusters = false;
+    importOptions.lodCount = 0;
+    importOptions.generateMips = false;
+    vv::ImportReport nativeReport;
+    const auto native = importer.Import(path, importOptions, &nativeReport);
+    importOptions.assimpTangentSpace = true;
+    vv::ImportReport assimpReport;
+    const auto reference = importer.Import(path, importOptions, &assimpReport);
+    assert(native.Ok() && reference.Ok());
+    assert(nativeReport.FindStage("pp_calc_tangent_space") == nullptr);
+    assert(assimpReport.FindStage("pp_calc_tangent_space") != nullptr);
+    assert(native.value->meshes.size() == reference.value->meshes.size());
+    for (size_t m = 0; m < native.value->meshes.size(); ++m) {
+      const vv::Mesh& mesh = native.value->meshes[m];
+      for (const vv::VertexSkinned& v : mesh.vertices) {
+        const vv::Vec3 t(v.tangent);
+        assert(std::fabs(glm::length(t) - 1.0F) < 1e-3F);
+        assert(std::fabs(glm::dot(t, v.normal)) < 1e-3F);
+        assert(v.tangent.w == 1.0F || v.tangent.w == -1.0F);
+      }
+      assert(BitangentAgreement(mesh) >= BitangentAgreement(reference.value->meshes[m]) - 1e-3);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,154 @@
+#include <cassert>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "asset/import/AssimpFbxImporter.hpp"
+#include "asset/texture/TextureRegistry.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+// A lazily sourced 8x8 texture backed by raw BGRA8 texels.
+vv::Texture MakeRawTexture(uint8_t seed) {
+  auto bytes = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(8) * 8 * 4);
+  for (size_t i = 0; i < bytes->size(); ++i) {
+    (*bytes)[i] = static_cast<uint8_t>(seed + i);
+  }
+  vv::Texture texture;
+  texture.width = 8;
+  texture.height = 8;
+  texture.source.rawWidth = 8;
+  texture.source.rawHeight = 8;
+  texture.source.sizeBytes = bytes->size();
+  texture.contentHash = vv::HashBytes(bytes->data(), bytes->size());
+  texture.source.bytes = std::move(bytes);
+  return texture;
+}
+
+// spider.fbx refers to four .jpg images that are not bundled. Written next to a copy of it as PPM
+// (decoders go by content, not extension), they give it file textures.
+std::string MakeTexturedSpider(const std::filesystem::path& dir) {
+  std::filesystem::create_directories(dir);
+  std::filesystem::copy_file("assets/fbx/spider.fbx", dir / "spider.fbx", std::filesystem::copy_options::overwrite_existing);
+  uint8_t seed = 0;
+  for (const char* name : {"SpiderTex.jpg", "drkwood2.jpg", "engineflare1.jpg", "wal67ar_small.jpg"}) {
+    std::ofstream file(dir / name, std::ios::binary);
+    file << "P6\n64 32\n255\n";
+    for (uint32_t i = 0; i < 64 * 32 * 3; ++i) {
+      file.put(static_cast<char>(i * 7 + seed));
+    }
+    seed = static_cast<uint8_t>(seed + 50);
+  }
+  return (dir / "spider.fbx").string();
+}
+
+}  // namespace
+
+int main() {
+  vv::TextureRegistry& registry = vv::TextureRegistry::Global();
+  registry.Clear();
+  const size_t imageBytes = static_cast<size_t>(8) * 8 * 4;
+  registry.SetBudgetBytes(imageBytes * 2);
+
+  const vv::Texture a = MakeRawTexture(1);
+  const vv::Texture b = MakeRawTexture(2);
+  const vv::Texture c = MakeRawTexture(3);
+  assert(vv::HasLazySource(a));
+
+  // BGRA source decodes to RGBA; a second acquire is a cache hit.
+  const auto pixelsA = registry.AcquirePixels(a);
+  assert(pixelsA != nullptr && pixelsA->width == 8 && pixelsA->pixels.size() == imageBytes);
+  assert(pixelsA->pixels[0] == (*a.source.bytes)[2] && pixelsA->pixels[2] == (*a.source.bytes)[0]);
+  assert(registry.AcquirePixels(a) == pixelsA);
+  assert(registry.Stats().decodedImages == 1 && registry.Stats().registryHits == 1);
+
+  // The budget holds two images: touching `a` keeps it, so `b` is the least recently used victim.
+  registry.AcquirePixels(b);
+  registry.AcquirePixels(a);
+  registry.AcquirePixels(c);
+  vv::TextureDedupStats stats = registry.Stats();
+  assert(stats.evictions == 1);
+  assert(stats.cachedBytes == imageBytes * 2);
+  assert(registry.ImageCount() == 2);
+  assert(registry.AcquirePixels(a) == pixelsA);
+  const uint64_t decodedBefore = registry.Stats().decodedImages;
+  registry.AcquirePixels(b);
+  assert(registry.Stats().decodedImages == decodedBefore + 1);
+
+  // Evicted images stay valid for holders; shrinking the budget drops everything unreferenced.
+  registry.SetBudgetBytes(0);
+  assert(registry.ImageCount() == 0 && registry.Stats().cachedBytes == 0);
+  assert(pixelsA->pixels.size() == imageBytes);
+  registry.SetBudgetBytes(vv::TextureRegistry::kDefaultBudgetBytes);
+
+  // A published texture serves its level 0 from the scene's own pixels, outside the budget, for as
+  // long as some scene holds it. Compressed or released textures no longer qualify.
+  {
+    registry.Clear();
+    vv::Texture decoded = MakeRawTexture(4);
+    decoded.format = vv::PixelFormat::kR8G8B8A8;
+    decoded.pixels = vv::PixelBuffer(imageBytes);
+    decoded.pixels[5] = 42;
+    const uint64_t hash = decoded.contentHash;
+    decoded.source.bytes.reset();
+    std::vector<vv::SharedAsset<vv::Texture>> textures{decoded};
+    registry.Publish(textures);
+    assert(registry.ImageCount() == 1 && registry.Stats().cachedBytes == 0);
+    assert(registry.Find(hash, imageBytes) == nullptr);
+    vv::TextureRegistry::CachedImage cached = registry.FindDecoded(hash, imageBytes);
+    assert(cached && cached.pixels == textures[0]->pixels.data() && cached.pixels[5] == 42);
+    assert(cached.width == 8 && cached.SizeBytes() == imageBytes);
+    assert(!registry.FindDecoded(hash, imageBytes + 1));
+
+    std::vector<vv::SharedAsset<vv::Texture>> compressed{vv::Texture(*textures[0])};
+    compressed[0].Edit().contentHash = hash + 1;
+    compressed[0].Edit().format = vv::PixelFormat::kBC7;
+    registry.Publish(compressed);
+    assert(!registry.FindDecoded(hash + 1, imageBytes));
+
+    textures.clear();
+    assert(cached.pixels[5] == 42);  // the holder keeps the pixels alive
+    cached = {};
+    assert(!registry.FindDecoded(hash, imageBytes) && registry.ImageCount() == 0);
+  }
+
+  // A lazy import keeps only source handles for file/embedded images; nothing is decoded.
+  registry.Clear();
+  const std::filesystem::path base = std::filesystem::temp_directory_path() / "vv_unit_texture_cache";
+  std::filesystem::remove_all(base);
+  vv::AssimpFbxImporter importer;
+  vv::ImportOptions options;
+  options.buildClusters = false;
+  options.lodCount = 0;
+  options.lazyTextureDecode = true;
+  const auto loaded = importer.Import(MakeTexturedSpider(base), options);
+  assert(loaded.Ok());
+  size_t lazyCount = 0;
+  for (const vv::Texture& texture : loaded.value->textures) {
+    if (!vv::HasLazySource(texture)) {
+      continue;
+    }
+    ++lazyCount;
+    assert(texture.pixels.empty());
+    assert(texture.width > 0 && texture.height > 0 && texture.contentHash != 0);
+  }
+  assert(lazyCount == 4);
+  assert(registry.Stats().decodedImages == 0);
+
+  for (const vv::Texture& texture : loaded.value->textures) {
+    if (!vv::HasLazySource(texture)) {
+      continue;
+    }
+    const auto pixels = registry.AcquirePixels(texture);
+    assert(pixels != nullptr);
+    assert(pixels->width == texture.width && pixels->height == texture.height);
+    assert(pixels->pixels.size() == static_cast<size_t>(texture.width) * texture.height * 4);
+  }
+  assert(registry.Stats().decodedImages == lazyCount);
+  std::filesystem::remove_all(base);
+  return 0;
+}
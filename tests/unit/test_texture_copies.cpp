@@ -0,0 +1,118 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "asset/import/AssimpFbxImporter.hpp"
+#include "asset/texture/ImageLoader.hpp"
+#include "asset/texture/MipGenerator.hpp"
+#include "asset/texture/TextureRegistry.hpp"
+#include "core/memory/PixelBuffer.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+uint8_t Channel(uint32_t x, uint32_t y, uint32_t c) {
+  return static_cast<uint8_t>((x * 7 + y * 13 + c * 71) & 0xFFU);
+}
+
+std::vector<uint8_t> EncodePpm(uint32_t width, uint32_t height) {
+  const std::string header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+  std::vector<uint8_t> bytes(header.begin(), header.end());
+  for (uint32_t y = 0; y < height; ++y) {
+    for (uint32_t x = 0; x < width; ++x) {
+      for (uint32_t c = 0; c < 3; ++c) {
+        bytes.push_back(Channel(x, y, c));
+      }
+    }
+  }
+  return bytes;
+}
+
+bool IsDefaultTexture(const vv::Texture& texture) {
+  return texture.uri.rfind("__default", 0) == 0;
+}
+
+}  // namespace
+
+int main() {
+  // Adopting and moving never copy; deep copies and growth are counted.
+  vv::ResetPixelBufferCounters();
+  auto* raw = static_cast<uint8_t*>(std::malloc(64));
+  vv::PixelBuffer adopted = vv::PixelBuffer::Adopt(raw, 64);
+  assert(adopted.size() == 64 && adopted.data() == raw);
+  assert(vv::GetPixelBufferCounters().allocations == 0);
+  vv::PixelBuffer copy = adopted;
+  vv::PixelBuffer moved = std::move(copy);
+  assert(copy.empty() && moved == adopted);
+  assert(vv::GetPixelBufferCounters().copies == 1);
+  assert(vv::GetPixelBufferCounters().copiedBytes == 64);
+  moved.reserve(256);
+  moved.resize(128);
+  assert(moved[100] == 0 && moved.capacity() == 256);
+  assert(vv::GetPixelBufferCounters().allocations == 2);
+
+  // Decoding hands stb's buffer over as is, and the mip chain grows it in place.
+  const std::vector<uint8_t> ppm = EncodePpm(37, 19);
+  vv::ResetPixelBufferCounters();
+  auto image = vv::LoadImageRgba8FromMemory(ppm.data(), ppm.size());
+  assert(image.has_value() && image->width == 37 && image->height == 19);
+  assert(image->pixels.size() == static_cast<size_t>(37) * 19 * 4);
+  assert(image->pixels[(5 * 37 + 3) * 4 + 1] == Channel(3, 5, 1));
+  assert(image->pixels[(5 * 37 + 3) * 4 + 3] == 255);
+  assert(vv::GetPixelBufferCounters().allocations == 0);
+  assert(vv::GetPixelBufferCounters().copies == 0);
+
+  vv::Texture texture;
+  texture.width = image->width;
+  texture.height = image->height;
+  texture.format = vv::PixelFormat::kR8G8B8A8;
+  texture.pixels = std::move(image->pixels);
+  vv::GenerateMipChain(texture);
+  assert(texture.mipLevels == vv::FullMipLevelCount(37, 19));
+  assert(vv::GetPixelBufferCounters().allocations == 1);
+  assert(vv::GetPixelBufferCounters().copies == 0);
+
+  // Per imported texture: at most one allocation (sized for the mip chain) and, without the
+  // shared decode cache, no copies at all.
+  vv::AssimpFbxImporter importer;
+  vv::ImportOptions options;
+  options.buildClusters = false;
+  options.lodCount = 0;
+  options.shareDecodedTextures = false;
+  vv::TextureRegistry::Global().Clear();
+  vv::ResetPixelBufferCounters();
+  const auto isolated = importer.Import("assets/fbx/Taunt.fbx", options);
+  assert(isolated.Ok());
+  assert(vv::GetPixelBufferCounters().copies == 0);
+  assert(vv::GetPixelBufferCounters().allocations <= isolated.value->textures.size());
+
+  // With the cache, a first import still moves its decodes into the scene and the registry keeps no
+  // second copy: it only refers to the scene's textures.
+  options.shareDecodedTextures = true;
+  vv::ResetPixelBufferCounters();
+  const auto first = importer.Import("assets/fbx/Taunt.fbx", options);
+  assert(first.Ok());
+  assert(vv::GetPixelBufferCounters().copies == 0);
+  assert(vv::TextureRegistry::Global().Stats().cachedBytes == 0);
+
+  // A second import copies each level 0 exactly once, out of the first scene.
+  vv::ResetPixelBufferCounters();
+  const auto shared = importer.Import("assets/fbx/Taunt.fbx", options);
+  assert(shared.Ok());
+  uint64_t level0Bytes = 0;
+  uint64_t loaded = 0;
+  for (const vv::Texture& loadedTexture : shared.value->textures) {
+    if (!IsDefaultTexture(loadedTexture)) {
+      level0Bytes += static_cast<uint64_t>(loadedTexture.width) * loadedTexture.height * 4;
+      ++loaded;
+    }
+  }
+  const vv::PixelBufferCounters counters = vv::GetPixelBufferCounters();
+  assert(counters.copies == loaded);
+  assert(counters.copiedBytes == level0Bytes);
+  assert(counters.allocations <= shared.value->textures.size());
+  return 0;
+}
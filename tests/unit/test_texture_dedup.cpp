@@ -0,0 +1,69 @@
+#include <cassert>
+#include <cstdint>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "asset/import/AssimpFbxImporter.hpp"
+#include "asset/texture/TextureRegistry.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+void CheckUniqueContent(const vv::Scene& scene) {
+  std::set<std::pair<uint64_t, bool>> seen;
+  for (const vv::Texture& texture : scene.textures) {
+    assert(texture.contentHash != 0);
+    assert(seen.emplace(texture.contentHash, texture.srgb).second);
+  }
+}
+
+}  // namespace
+
+int main() {
+  const std::vector<uint8_t> a = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  std::vector<uint8_t> b = a;
+  assert(vv::HashBytes(a.data(), a.size()) == vv::HashBytes(b.data(), b.size()));
+  b[10] = 12;
+  assert(vv::HashBytes(a.data(), a.size()) != vv::HashBytes(b.data(), b.size()));
+  assert(vv::HashBytes(a.data(), a.size()) != vv::HashBytes(a.data(), a.size() - 1));
+
+  vv::TextureRegistry& registry = vv::TextureRegistry::Global();
+  registry.Clear();
+
+  vv::AssimpFbxImporter importer;
+  vv::ImportOptions options;
+  options.buildClusters = false;
+  options.lodCount = 0;
+  const auto first = importer.Import("assets/fbx/Taunt.fbx", options);
+  assert(first.Ok());
+  CheckUniqueContent(*first.value);
+  const vv::TextureDedupStats afterFirst = registry.Stats();
+  assert(afterFirst.registryHits == 0);
+  assert(registry.ImageCount() == afterFirst.decodedImages);
+
+  // A second import of the same content decodes nothing and keeps the same hashes/GPU keys.
+  const auto second = importer.Import("assets/fbx/Taunt.fbx", options);
+  assert(second.Ok());
+  const vv::TextureDedupStats afterSecond = registry.Stats();
+  assert(afterSecond.decodedImages == afterFirst.decodedImages);
+  assert(afterSecond.registryHits == afterFirst.decodedImages);
+  assert(first.value->textures.size() == second.value->textures.size());
+  for (size_t i = 0; i < first.value->textures.size(); ++i) {
+    const vv::Texture& lhs = first.value->textures[i];
+    const vv::Texture& rhs = second.value->textures[i];
+    assert(lhs.contentHash == rhs.contentHash);
+    assert(vv::TextureGpuKey(lhs) == vv::TextureGpuKey(rhs));
+    assert(lhs.pixels == rhs.pixels);
+  }
+
+  // Opting out still dedups inside the scene but never touches the registry cache.
+  registry.Clear();
+  options.shareDecodedTextures = false;
+  const auto isolated = importer.Import("assets/fbx/Taunt.fbx", options);
+  assert(isolated.Ok());
+  CheckUniqueContent(*isolated.value);
+  assert(registry.ImageCount() == 0);
+  assert(registry.Stats().registryHits == 0);
+  return 0;
+}
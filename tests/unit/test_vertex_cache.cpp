@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "asset/import/ImportCommon.hpp"
+#include "asset/import/ImportReport.hpp"
+#include "asset/mesh/MeshletBuilder.hpp"
+#include "asset/mesh/VertexCache.hpp"
+#include "asset/mesh/VertexQuantization.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+using Triangle = std::array<float, 9>;
+
+// Flat grid in the xz plane, `size` quads on a side, with its triangles in shuffled order as an
+// unordered exporter might write them.
+vv::Mesh MakeShuffledGrid(uint32_t size, uint32_t seed) {
+  vv::Mesh mesh;
+  for (uint32_t z = 0; z <= size; ++z) {
+    for (uint32_t x = 0; x <= size; ++x) {
+      vv::VertexSkinned v;
+      v.position = vv::Vec3(static_cast<float>(x), 0.0F, static_cast<float>(z));
+      v.normal = vv::Vec3(0.0F, 1.0F, 0.0F);
+      v.uv0 = vv::Vec2(static_cast<float>(x), static_cast<float>(z)) / static_cast<float>(size);
+      mesh.vertices.push_back(v);
+    }
+  }
+  std::vector<std::array<uint32_t, 3>> triangles;
+  for (uint32_t z = 0; z < size; ++z) {
+    for (uint32_t x = 0; x < size; ++x) {
+      const uint32_t a = z * (size + 1) + x;
+      const uint32_t c = a + size + 1;
+      triangles.push_back({a, c, a + 1});
+      triangles.push_back({a + 1, c, c + 1});
+    }
+  }
+  uint32_t state = seed;
+  for (size_t i = triangles.size() - 1; i > 0; --i) {
+    state = state * 1664525U + 1013904223U;
+    std::swap(triangles[i], triangles[(state >> 8) % (i + 1)]);
+  }
+  for (const auto& t : triangles) {
+    mesh.indices.insert(mesh.indices.end(), t.begin(), t.end());
+  }
+  mesh.submeshes.push_back({0, static_cast<uint32_t>(mesh.indices.size()), 0});
+  mesh.localBounds.min = vv::Vec3(0.0F);
+  mesh.localBounds.max = vv::Vec3(static_cast<float>(size), 0.0F, static_cast<float>(size));
+  return mesh;
+}
+
+// Triangles of a range by corner positions, rotated so the smallest corner leads (winding kept),
+// then sorted: equal for two orderings of the same triangles.
+std::vector<Triangle> Triangles(const vv::Mesh& mesh, uint32_t firstIndex, uint32_t indexCount) {
+  std::vector<Triangle> triangles;
+  for (uint32_t i = firstIndex; i + 2 < firstIndex + indexCount; i += 3) {
+    std::array<std::array<float, 3>, 3> corners{};
+    for (uint32_t k = 0; k < 3; ++k) {
+      const vv::Vec3& p = mesh.vertices[mesh.indices[i + k]].position;
+      corners[k] = {p.x, p.y, p.z};
+    }
+    std::rotate(corners.begin(), std::min_element(corners.begin(), corners.end()), corners.end());
+    Triangle t{};
+    for (uint32_t k = 0; k < 9; ++k) {
+      t[k] = corners[k / 3][k % 3];
+    }
+    triangles.push_back(t);
+  }
+  std::sort(triangles.begin(), triangles.end());
+  return triangles;
+}
+
+float MeshAcmr(const vv::Mesh& mesh) {
+  return vv::AverageCacheMissRatio(mesh.indices, 0, static_cast<uint32_t>(mesh.indices.size()));
+}
+
+float ClusterAcmr(const vv::Mesh& mesh) {
+  float misses = 0.0F;
+  uint32_t triangles = 0;
+  for (const vv::MeshCluster& cluster : mesh.clusters) {
+    misses += vv::AverageCacheMissRatio(mesh.indices, cluster.firstIndex, cluster.indexCount) * static_cast<float>(cluster.indexCount / 3);
+    triangles += cluster.indexCount / 3;
+  }
+  return misses / static_cast<float>(triangles);
+}
+
+// Every new index is at most one past the largest seen so far.
+bool NumberedByFirstUse(const vv::Mesh& mesh) {
+  uint32_t next = 0;
+  for (const uint32_t index : mesh.indices) {
+    if (index > next) {
+      return false;
+    }
+    next = index == next ? next + 1 : next;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  // ACMR of the FIFO model: a strip of quads reuses two corners per triangle after the first.
+  {
+    const std::vector<uint32_t> unshared = {0, 1, 2, 3, 4, 5};
+    assert(vv::AverageCacheMissRatio(unshared, 0, 6) == 3.0F);
+    const std::vector<uint32_t> strip = {0, 1, 2, 2, 1, 3, 2, 3, 4, 4, 3, 5};
+    assert(vv::AverageCacheMissRatio(strip, 0, 12) == 1.5F);
+    // A one-entry cache only keeps the last vertex.
+    assert(vv::AverageCacheMissRatio(strip, 0, 12, 1) == 10.0F / 4.0F);
+  }
+
+  // A shuffled grid misses on nearly every corner; the reorder gets it well under one miss per
+  // triangle, keeps every triangle with its winding, and renumbers vertices by first use.
+  {
+    vv::Mesh mesh = MakeShuffledGrid(48, 7);
+    const std::vector<Triangle> before = Triangles(mesh, 0, static_cast<uint32_t>(mesh.indices.size()));
+    const float shuffled = MeshAcmr(mesh);
+    assert(shuffled > 2.0F);
+    const vv::VertexCacheResult result = vv::OptimizeVertexCache(mesh);
+    assert(result.triangles == 48 * 48 * 2);
+    assert(result.acmrBefore == shuffled && result.acmrAfter == MeshAcmr(mesh));
+    assert(result.acmrAfter < 0.85F);
+    assert(Triangles(mesh, 0, static_cast<uint32_t>(mesh.indices.size())) == before);
+    assert(NumberedByFirstUse(mesh));
+    assert(mesh.vertices.size() == 49 * 49);
+  }
+
+  // Triangles never leave their range: two submeshes, an appended LOD range, and the clusters.
+  {
+    vv::Mesh mesh = MakeShuffledGrid(32, 11);
+    const uint32_t half = static_cast<uint32_t>(mesh.indices.size()) / 6 * 3;
+    mesh.submeshes = {{0, half, 0}, {half, static_cast<uint32_t>(mesh.indices.size()) - half, 1}};
+    const uint32_t lodFirst = static_cast<uint32_t>(mesh.indices.size());
+    mesh.indices.insert(mesh.indices.end(), mesh.indices.begin(), mesh.indices.begin() + half);
+    mesh.lods.push_back({{{lodFirst, half, 0}, {lodFirst + half, 0, 1}}, 0.1F});
+    vv::BuildMeshClusters(mesh);
+    assert(mesh.clusters.size() > 4);
+    const float clustered = ClusterAcmr(mesh);
+
+    std::vector<std::vector<Triangle>> before;
+    for (const vv::MeshCluster& cluster : mesh.clusters) {
+      before.push_back(Triangles(mesh, cluster.firstIndex, cluster.indexCount));
+    }
+    const std::vector<Triangle> lodBefore = Triangles(mesh, lodFirst, half);
+    const std::vector<vv::MeshCluster> clusters = mesh.clusters;
+
+    vv::OptimizeVertexCache(mesh);
+    for (size_t c = 0; c < clusters.size(); ++c) {
+      const vv::MeshCluster& cluster = mesh.clusters[c];
+      assert(cluster.firstIndex == clusters[c].firstIndex && cluster.indexCount == clusters[c].indexCount);
+      assert(Triangles(mesh, cluster.firstIndex, cluster.indexCount) == before[c]);
+    }
+    assert(Triangles(mesh, lodFirst, half) == lodBefore);
+    assert(ClusterAcmr(mesh) < clustered);
+  }
+
+  // Morph deltas and the packed stream follow their vertices.
+  {
+    vv::Mesh mesh = MakeShuffledGrid(8, 3);
+    vv::MorphTarget target;
+    target.vertices = {0, 40};
+    for (auto& axis : target.positionDeltas) {
+      axis = {5, 9};
+    }
+    mesh.morphTargets.push_back(target);
+    mesh.morphWeights = {0.0F};
+    assert(vv::PackMeshVertices(mesh));
+    vv::OptimizeVertexCache(mesh);
+    const vv::MorphTarget& moved = mesh.morphTargets[0];
+    assert(moved.vertices.size() == 2);
+    for (size_t i = 0; i < moved.vertices.size(); ++i) {
+      const vv::Vec3& p = mesh.vertices[moved.vertices[i]].position;
+      const bool origin = p.x == 0.0F && p.z == 0.0F;
+      assert(moved.positionDeltas[0][i] == (origin ? 5 : 9));
+      assert(origin || (p.x == 4.0F && p.z == 4.0F));  // vertex 40 of a 9-wide grid
+    }
+    vv::Mesh repacked = mesh;
+    vv::PackMeshVertices(repacked);
+    assert(mesh.packedVertices == repacked.packedVertices);
+  }
+
+  // The import pipeline applies it last, after clusters and LODs, unless Assimp's join is asked for.
+  {
+    vv::ImportOptions options;
+    vv::Mesh native = MakeShuffledGrid(40, 5);
+    vv::ImportReport report;
+    vv::FinishImportedMesh(native, options, true, true, &report);
+    const vv::ImportStageReport* stage = report.FindStage("mesh_cache_order");
+    assert(stage != nullptr && stage->parent == "meshes" && stage->items > 0);
+    assert(!native.clusters.empty() && !native.lods.empty());
+
+    options.assimpJoinVertices = true;
+    vv::Mesh joined = MakeShuffledGrid(40, 5);
+    vv::ImportReport joinedReport;
+    vv::FinishImportedMesh(joined, options, true, true, &joinedReport);
+    assert(joinedReport.FindStage("mesh_cache_order") == nullptr);
+    assert(ClusterAcmr(native) < ClusterAcmr(joined));
+    assert(NumberedByFirstUse(native));
+  }
+  return 0;
+}
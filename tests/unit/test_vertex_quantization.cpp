@@ -0,0 +1,61 @@
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+
+#include <glm/geometric.hpp>
+
+#include "asset/mesh/VertexQuantization.hpp"
+
+int main() {
+  const std::array<float, 4> awkward = {0.333F, 0.333F, 0.334F, 0.0F};
+  const auto q = vv::QuantizeWeightsUnorm8(awkward);
+  assert(q[0] + q[1] + q[2] + q[3] == 255);
+  assert(q[3] == 0);
+
+  const auto unset = vv::QuantizeWeightsUnorm8({0.0F, 0.0F, 0.0F, 0.0F});
+  assert(unset[0] == 255);
+
+  for (int i = 0; i < 64; ++i) {
+    const float a = static_cast<float>(i) * 0.37F;
+    const float b = static_cast<float>(i) * 0.91F - 2.0F;
+    const vv::Vec3 n = glm::normalize(vv::Vec3(std::cos(a) * std::cos(b), std::sin(b), std::sin(a) * std::cos(b)));
+    const vv::Vec3 decoded = vv::OctDecodeSnorm16(vv::OctEncodeSnorm16(n));
+    assert(glm::dot(n, decoded) > 0.99999F);
+  }
+
+  vv::Mesh mesh;
+  mesh.vertices.resize(3);
+  mesh.vertices[0].position = vv::Vec3(-1.0F, 0.0F, 2.0F);
+  mesh.vertices[1].position = vv::Vec3(1.0F, 1.8F, -2.0F);
+  mesh.vertices[2].position = vv::Vec3(0.25F, 0.9F, 0.5F);
+  mesh.vertices[2].uv0 = vv::Vec2(0.5F, 0.75F);
+  mesh.vertices[2].tangent = vv::Vec4(0.0F, 0.0F, 1.0F, -1.0F);
+  mesh.vertices[2].joints = {3, 200, 0, 0};
+  mesh.vertices[2].weights = {0.6F, 0.4F, 0.0F, 0.0F};
+  mesh.localBounds = {vv::Vec3(-1.0F, 0.0F, -2.0F), vv::Vec3(1.0F, 1.8F, 2.0F)};
+
+  assert(vv::PackMeshVertices(mesh));
+  assert(mesh.vertexLayout == vv::VertexLayout::kPackedJoints8);
+  assert(mesh.packedVertices.size() == 3 * sizeof(vv::PackedVertexSkinned8));
+
+  const vv::VertexSkinned v = vv::UnpackVertex(mesh, 2);
+  assert(glm::length(v.position - mesh.vertices[2].position) < 1e-4F);
+  assert(std::fabs(v.uv0.y - 0.75F) < 1e-3F);
+  assert(v.tangent.w < 0.0F);
+  assert(v.joints[1] == 200);
+  assert(std::fabs(v.weights[0] + v.weights[1] - 1.0F) < 1e-6F);
+
+  mesh.vertices[0].joints = {300, 0, 0, 0};
+  assert(vv::PackMeshVertices(mesh));
+  assert(mesh.vertexLayout == vv::VertexLayout::kPackedJoints16);
+  assert(vv::UnpackVertex(mesh, 0).joints[0] == 300);
+
+  assert(vv::UsesShortIndices(mesh));
+  // 0xFFFF is never a 16-bit vertex index; it is the primitive restart value.
+  vv::Mesh large;
+  large.vertices.resize(65535);
+  assert(vv::UsesShortIndices(large));
+  large.vertices.resize(65536);
+  assert(!vv::UsesShortIndices(large));
+  return 0;
+}
@@ -0,0 +1,174 @@
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "asset/import/AssimpFbxImporter.hpp"
+#include "asset/mesh/VertexWeld.hpp"
+#include "render/scene/SceneTypes.hpp"
+
+namespace {
+
+vv::VertexSkinned MakeVertex(float x, float y, float u) {
+  vv::VertexSkinned v;
+  v.position = vv::Vec3(x, y, 0.0F);
+  v.uv0 = vv::Vec2(u, y);
+  return v;
+}
+
+// Unindexed triangles, one vertex per corner, as Assimp delivers FBX polygons before joining.
+vv::Mesh MakeUnindexed(const std::vector<vv::VertexSkinned>& corners) {
+  vv::Mesh mesh;
+  mesh.vertices = corners;
+  for (uint32_t i = 0; i < corners.size(); ++i) {
+    mesh.indices.push_back(i);
+  }
+  mesh.submeshes.push_back({0, static_cast<uint32_t>(mesh.indices.size()), 0});
+  return mesh;
+}
+
+// Every new index is at most one past the largest seen so far.
+bool NumberedByFirstUse(const vv::Mesh& mesh) {
+  uint32_t next = 0;
+  for (const uint32_t index : mesh.indices) {
+    if (index > next) {
+      return false;
+    }
+    next = index == next ? next + 1 : next;
+  }
+  return next == mesh.vertices.size();
+}
+
+}  // namespace
+
+int main() {
+  // Quad as two unindexed triangles: the shared diagonal welds, corners stay in first-use order.
+  {
+    const vv::VertexSkinned a = MakeVertex(0.0F, 0.0F, 0.0F);
+    const vv::VertexSkinned b = MakeVertex(1.0F, 0.0F, 1.0F);
+    const vv::VertexSkinned c = MakeVertex(1.0F, 1.0F, 1.0F);
+    const vv::VertexSkinned d = MakeVertex(0.0F, 1.0F, 0.0F);
+    vv::Mesh mesh = MakeUnindexed({a, b, c, a, c, d});
+    const vv::VertexWeldResult result = vv::WeldVertices(mesh);
+    assert(result.inputVertices == 6 && result.outputVertices == 4);
+    assert(mesh.vertices.size() == 4);
+    assert((mesh.indices == std::vector<uint32_t>{0, 1, 2, 0, 2, 3}));
+    assert(mesh.vertices[3].position == d.position);
+  }
+
+  // Per-attribute epsilons; joints, tangent signs and anything past epsilon keep vertices apart.
+  {
+    vv::VertexSkinned base = MakeVertex(0.5F, 0.25F, 0.5F);
+    base.joints = {3, 1, 0, 0};
+    base.weights = {0.75F, 0.25F, 0.0F, 0.0F};
+    vv::VertexSkinned nearPosition = base;
+    nearPosition.position.x += 1e-7F;
+    vv::VertexSkinned farPosition = base;
+    farPosition.position.x += 1e-3F;
+    vv::VertexSkinned otherJoint = base;
+    otherJoint.joints[1] = 2;
+    vv::VertexSkinned nearWeight = base;
+    nearWeight.weights = {0.7501F, 0.2499F, 0.0F, 0.0F};
+    vv::VertexSkinned mirrored = base;
+    mirrored.tangent.w = -1.0F;
+    vv::VertexSkinned otherUv = base;
+    otherUv.uv0.x += 0.01F;
+    vv::Mesh mesh = MakeUnindexed({base, nearPosition, farPosition, otherJoint, nearWeight, mirrored, otherUv, base, base});
+    vv::WeldVertices(mesh);
+    assert(mesh.vertices.size() == 5);
+    assert(mesh.indices[1] == 0 && mesh.indices[4] == 0);
+    assert(mesh.indices[2] == 1 && mesh.indices[3] == 2 && mesh.indices[5] == 3 && mesh.indices[6] == 4);
+
+    vv::VertexWeldOptions loose;
+    loose.positionEpsilon = 1e-2F;
+    loose.uvEpsilon = 0.1F;
+    vv::Mesh looseMesh = MakeUnindexed({base, farPosition, otherUv});
+    vv::WeldVertices(looseMesh, loose);
+    assert(looseMesh.vertices.size() == 1);
+
+    vv::VertexWeldOptions exact;
+    exact.positionEpsilon = 0.0F;
+    vv::VertexSkinned negativeZero = MakeVertex(-0.0F, 0.0F, 0.0F);
+    vv::Mesh exactMesh = MakeUnindexed({MakeVertex(0.0F, 0.0F, 0.0F), negativeZero, nearPosition, base});
+    vv::WeldVertices(exactMesh, exact);
+    assert(exactMesh.vertices.size() == 3);
+  }
+
+  // Grid snapping: with an epsilon of 0.25, x = 0.124 and 0.126 straddle the 0.125 rounding boundary
+  // and stay apart although they are 0.002 apart; 0.13 and 0.37 share the cell around 0.25 and weld.
+  {
+    vv::VertexWeldOptions coarse;
+    coarse.positionEpsilon = 0.25F;
+    vv::Mesh mesh = MakeUnindexed({MakeVertex(0.124F, 0.0F, 0.0F),
+                                   MakeVertex(0.126F, 0.0F, 0.0F),
+                                   MakeVertex(0.13F, 0.0F, 0.0F),
+                                   MakeVertex(0.37F, 0.0F, 0.0F),
+                                   MakeVertex(-0.124F, 0.0F, 0.0F),
+                                   MakeVertex(0.124F, 0.0F, 0.0F)});
+    vv::WeldVertices(mesh, coarse);
+    assert((mesh.indices == std::vector<uint32_t>{0, 1, 1, 1, 0, 0}));
+    assert(mesh.vertices.size() == 2);
+  }
+
+  // Large shuffled mesh with exact duplicates: every partition and worker chunk takes part, and
+  // the result must match the single-threaded definition (first occurrence wins, first-use order).
+  {
+    constexpr uint32_t kUnique = 40000;
+    constexpr uint32_t kCorners = 3 * 60000;
+    std::vector<vv::VertexSkinned> unique(kUnique);
+    for (uint32_t i = 0; i < kUnique; ++i) {
+      unique[i] = MakeVertex(static_cast<float>(i % 200), static_cast<float>(i / 200), static_cast<float>(i) * 0.001F);
+      unique[i].joints = {static_cast<uint16_t>(i % 7), 0, 0, 0};
+    }
+    std::vector<uint32_t> source(kCorners);
+    uint32_t state = 12345;
+    for (uint32_t i = 0; i < kCorners; ++i) {
+      state = state * 1664525U + 1013904223U;
+      source[i] = i < kUnique ? i : (state >> 8) % kUnique;
+    }
+    for (uint32_t i = kCorners - 1; i > 0; --i) {
+      state = state * 1664525U + 1013904223U;
+      std::swap(source[i], source[(state >> 8) % (i + 1)]);
+    }
+    std::vector<vv::VertexSkinned> corners(kCorners);
+    for (uint32_t i = 0; i < kCorners; ++i) {
+      corners[i] = unique[source[i]];
+    }
+    vv::Mesh mesh = MakeUnindexed(corners);
+    const vv::VertexWeldResult result = vv::WeldVertices(mesh);
+    assert(result.outputVertices == kUnique);
+    assert(NumberedByFirstUse(mesh));
+    for (uint32_t i = 0; i < kCorners; ++i) {
+      assert(mesh.vertices[mesh.indices[i]].position == unique[source[i]].position);
+      assert(mesh.vertices[mesh.indices[i]].joints == unique[source[i]].joints);
+    }
+    vv::Mesh again = MakeUnindexed(corners);
+    vv::WeldVertices(again);
+    assert(again.indices == mesh.indices);
+  }
+
+  // Bundled asset: the native weld replaces Assimp's join and reaches at least its reduction.
+  {
+    vv::AssimpFbxImporter importer;
+    vv::ImportOptions options;
+    options.buildClusters = false;
+    options.lodCount = 0;
+    options.generateMips = false;
+    vv::ImportReport nativeReport;
+    const auto native = importer.Import("assets/fbx/Taunt.fbx", options, &nativeReport);
+    options.assimpJoinVertices = true;
+    vv::ImportReport assimpReport;
+    const auto reference = importer.Import("assets/fbx/Taunt.fbx", options, &assimpReport);
+    assert(native.Ok() && reference.Ok());
+    const vv::ImportStageReport* weld = nativeReport.FindStage("mesh_weld");
+    assert(weld != nullptr && weld->items > 0);
+    assert(nativeReport.FindStage("pp_join_identical_vertices") == nullptr);
+    assert(assimpReport.FindStage("pp_join_identical_vertices") != nullptr);
+    assert(assimpReport.FindStage("mesh_weld") == nullptr);
+    assert(nativeReport.counts.triangles == assimpReport.counts.triangles);
+    assert(nativeReport.counts.vertices <= assimpReport.counts.vertices + assimpReport.counts.vertices / 100);
+    for (const vv::Mesh& mesh : native.value->meshes) {
+      assert(NumberedByFirstUse(mesh));
+    }
+  }
+  return 0;
+}
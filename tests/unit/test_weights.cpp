@@ -1,5 +1,7 @@
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <utility>
 #include <vector>
 
@@ -19,5 +21,24 @@ int main() {
   assert(packed.joints[2] == 3);
   assert(packed.joints[3] == 6);
 
+  // Joints a mesh references with weight become a dense local range in bone order.
+  std::vector<vv::VertexSkinned> vertices(3);
+  vertices[0].joints = {40, 7, 0, 0};
+  vertices[0].weights = {0.75F, 0.25F, 0.0F, 0.0F};
+  vertices[1].joints = {7, 12, 3, 0};
+  vertices[1].weights = {0.5F, 0.5F, 0.0F, 0.0F};
+  vertices[2].joints = {12, 0, 0, 0};
+  vertices[2].weights = {1.0F, 0.0F, 0.0F, 0.0F};
+  const std::vector<uint32_t> joints = vv::CompactJoints(vertices);
+  assert((joints == std::vector<uint32_t>{7, 12, 40}));
+  assert((vertices[0].joints == std::array<uint16_t, 4>{2, 0, 0, 0}));
+  assert((vertices[1].joints == std::array<uint16_t, 4>{0, 1, 0, 0}));
+  assert((vertices[2].joints == std::array<uint16_t, 4>{1, 0, 0, 0}));
+  for (const vv::VertexSkinned& v : vertices) {
+    for (size_t k = 0; k < vv::kMaxBoneInfluence; ++k) {
+      assert(v.weights[k] == 0.0F || v.joints[k] < joints.size());
+    }
+  }
+
   return 0;
 }
@@ -10,8 +10,14 @@ if(NOT DEFINED GLSLANG_VALIDATOR)
   message(FATAL_ERROR "GLSLANG_VALIDATOR is required")
 endif()
 
+# Optional list of macros (NAME or NAME=VALUE) for building a variant of the same source.
+set(define_args)
+foreach(define IN LISTS SHADER_DEFINES)
+  list(APPEND define_args -D${define})
+endforeach()
+
 execute_process(
-  COMMAND ${GLSLANG_VALIDATOR} -V ${SHADER_INPUT} -o ${SHADER_OUTPUT}
+  COMMAND ${GLSLANG_VALIDATOR} -V ${define_args} ${SHADER_INPUT} -o ${SHADER_OUTPUT}
   RESULT_VARIABLE rc
   OUTPUT_VARIABLE out
   ERROR_VARIABLE err